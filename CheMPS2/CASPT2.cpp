@@ -29,14 +29,16 @@
 #include "Options.h"
 #include "ConjugateGradient.h"
 #include "Davidson.h"
+#include "MultiShiftSolver.h"
 #include "Special.h"
+#include "MmapVector.h"
 
 using std::cout;
 using std::endl;
 using std::min;
 using std::max;
 
-CheMPS2::CASPT2::CASPT2( DMRGSCFindices * idx, DMRGSCFintegrals * ints, DMRGSCFmatrix * oei, DMRGSCFmatrix * fock_in, double * one_dm, double * two_dm, double * three_dm, double * contract_4dm, const double IPEA ){
+CheMPS2::CASPT2::CASPT2( DMRGSCFindices * idx, DMRGSCFintegrals * ints, DMRGSCFmatrix * oei, DMRGSCFmatrix * fock_in, double * one_dm, double * two_dm, SixIndex * three_dm, SixIndex * contract_4dm, const double IPEA, const string scratch_in ){
 
    indices    = idx;
    fock       = fock_in;
@@ -45,6 +47,7 @@ CheMPS2::CASPT2::CASPT2( DMRGSCFindices * idx, DMRGSCFintegrals * ints, DMRGSCFm
    three_rdm  = three_dm;
    f_dot_4dm  = contract_4dm;
    num_irreps = indices->getNirreps();
+   scratch    = scratch_in;
 
    struct timeval start, end;
    gettimeofday( &start, NULL );
@@ -198,8 +201,8 @@ CheMPS2::CASPT2::~CASPT2(){
    delete [] size_B_triplet;
    delete [] size_F_singlet;
    delete [] size_F_triplet;
+   MmapVector::release( vector_rhs, jump[ CHEMPS2_CASPT2_NUM_CASES * num_irreps ], scratch );
    delete [] jump;
-   delete [] vector_rhs;
 
 }
 
@@ -212,16 +215,21 @@ double CheMPS2::CASPT2::solve( const double imag_shift, const bool CONJUGATE_GRA
    const int normalizations[] = { 1, 2, 2, 1, 1, 2, 6, 2, 2, 2, 6, 4, 12 };
    const bool apply_shift = (( fabs( imag_shift ) > 0.0 ) ? true : false );
 
-   int total_size = jump[ CHEMPS2_CASPT2_NUM_CASES * num_irreps ];
-   double * diag_fock = new double[ total_size ];
+   // The Davidson algorithm keeps DAVIDSON_NUM_VEC vectors: out-of-core, the conjugate gradient algorithm is used
+   const bool out_of_core = ( scratch.length() > 0 );
+   const bool use_cg = (( CONJUGATE_GRADIENT ) || ( out_of_core ));
+
+   const long long total_size = jump[ CHEMPS2_CASPT2_NUM_CASES * num_irreps ];
+   double * diag_fock = MmapVector::allocate( total_size, scratch );
    diagonal( diag_fock );
    double min_eig = diag_fock[ 0 ];
-   for ( int elem = 1; elem < total_size; elem++ ){ min_eig = min( min_eig, diag_fock[ elem ] ); }
-   cout << "CASPT2 : Solution algorithm   = " << (( CONJUGATE_GRADIENT ) ? "Conjugate Gradient" : "Davidson" ) << endl;
+   for ( long long elem = 1; elem < total_size; elem++ ){ min_eig = min( min_eig, diag_fock[ elem ] ); }
+   cout << "CASPT2 : Solution algorithm   = " << (( use_cg ) ? "Conjugate Gradient" : "Davidson" ) << endl;
+   cout << "CASPT2 : Vector storage       = " << (( out_of_core ) ? "out-of-core in " + scratch : "in memory" ) << endl;
    cout << "CASPT2 : Minimum(diagonal)    = " << min_eig << endl;
 
-   ConjugateGradient * CG = (( CONJUGATE_GRADIENT ) ? new ConjugateGradient( total_size, CheMPS2::CONJ_GRADIENT_RTOL, CheMPS2::CONJ_GRADIENT_PRECOND_CUTOFF, false ) : NULL );
-   Davidson * DAVID = (( CONJUGATE_GRADIENT ) ? NULL : new Davidson( total_size,
+   ConjugateGradient * CG = (( use_cg ) ? new ConjugateGradient( total_size, CheMPS2::CONJ_GRADIENT_RTOL, CheMPS2::CONJ_GRADIENT_PRECOND_CUTOFF, false, scratch ) : NULL );
+   Davidson * DAVID = (( use_cg ) ? NULL : new Davidson( total_size,
                                                                      CheMPS2::DAVIDSON_NUM_VEC,
                                                                      CheMPS2::DAVIDSON_NUM_VEC_KEEP,
                                                                      CheMPS2::CONJ_GRADIENT_RTOL,
@@ -229,33 +237,31 @@ double CheMPS2::CASPT2::solve( const double imag_shift, const bool CONJUGATE_GRA
                                                                      true, // debug_print
                                                                      'L' )); // Linear problem
    double ** pointers = new double*[ 3 ];
-   char instruction = (( CONJUGATE_GRADIENT ) ? CG->step( pointers ) : DAVID->FetchInstruction( pointers ));
+   char instruction = (( use_cg ) ? CG->step( pointers ) : DAVID->FetchInstruction( pointers ));
    assert( instruction == 'A' );
-   for ( int elem = 0; elem < total_size; elem++ ){ pointers[ 0 ][ elem ] = vector_rhs[ elem ] / diag_fock[ elem ]; } // Initial guess of F * x = V
-   for ( int elem = 0; elem < total_size; elem++ ){ pointers[ 1 ][ elem ] =  diag_fock[ elem ]; } // Diagonal of the operator F
-   for ( int elem = 0; elem < total_size; elem++ ){ pointers[ 2 ][ elem ] = vector_rhs[ elem ]; } // RHS of the linear problem F * x = V
-   int inc1 = 1;
-   const double E2_DIAGONAL = - ddot_( &total_size, pointers[ 0 ], &inc1, pointers[ 2 ], &inc1 );
-   instruction = (( CONJUGATE_GRADIENT ) ? CG->step( pointers ) : DAVID->FetchInstruction( pointers ));
+   for ( long long elem = 0; elem < total_size; elem++ ){ pointers[ 0 ][ elem ] = vector_rhs[ elem ] / diag_fock[ elem ]; } // Initial guess of F * x = V
+   for ( long long elem = 0; elem < total_size; elem++ ){ pointers[ 1 ][ elem ] =  diag_fock[ elem ]; } // Diagonal of the operator F
+   for ( long long elem = 0; elem < total_size; elem++ ){ pointers[ 2 ][ elem ] = vector_rhs[ elem ]; } // RHS of the linear problem F * x = V
+   const double E2_DIAGONAL = - Special::ddot64( total_size, pointers[ 0 ], pointers[ 2 ] );
+   instruction = (( use_cg ) ? CG->step( pointers ) : DAVID->FetchInstruction( pointers ));
    assert( instruction == 'B' );
    while ( instruction == 'B' ){
       matvec( pointers[ 0 ], pointers[ 1 ], diag_fock );
       if ( apply_shift ){ add_shift( pointers[ 0 ], pointers[ 1 ], diag_fock, imag_shift, normalizations ); }
-      instruction = (( CONJUGATE_GRADIENT ) ? CG->step( pointers ) : DAVID->FetchInstruction( pointers ));
+      instruction = (( use_cg ) ? CG->step( pointers ) : DAVID->FetchInstruction( pointers ));
    }
    assert( instruction == 'C' );
-   const double E2_NONVARIATIONAL = - ddot_( &total_size, pointers[ 0 ], &inc1, vector_rhs, &inc1 );
+   const double E2_NONVARIATIONAL = - Special::ddot64( total_size, pointers[ 0 ], vector_rhs );
    const double rnorm = pointers[ 1 ][ 0 ];
-   cout << "CASPT2 : Number of iterations = " << (( CONJUGATE_GRADIENT ) ? CG->get_num_matvec() : DAVID->GetNumMultiplications() ) << endl;
+   cout << "CASPT2 : Number of iterations = " << (( use_cg ) ? CG->get_num_matvec() : DAVID->GetNumMultiplications() ) << endl;
    cout << "CASPT2 : Residual norm        = " << rnorm << endl;
    matvec( pointers[ 0 ], pointers[ 1 ], diag_fock ); // pointers[ 1 ] is a WORK array when instruction == 'C'
-   const double E2_VARIATIONAL = 2 * E2_NONVARIATIONAL + ddot_( &total_size, pointers[ 0 ], &inc1, pointers[ 1 ], &inc1 );
-   delete [] diag_fock;
+   const double E2_VARIATIONAL = 2 * E2_NONVARIATIONAL + Special::ddot64( total_size, pointers[ 0 ], pointers[ 1 ] );
+   MmapVector::release( diag_fock, total_size, scratch );
 
    const double inproduct = inproduct_vectors( pointers[ 0 ], pointers[ 0 ], normalizations );
    const double reference_weight = 1.0 / ( 1.0 + inproduct );
    cout << "CASPT2 : Reference weight     = " << reference_weight << endl;
-   //energy_per_sector( pointers[ 0 ] );
    delete [] pointers;
    if ( CG    != NULL ){ delete CG;    }
    if ( DAVID != NULL ){ delete DAVID; }
@@ -271,13 +277,92 @@ double CheMPS2::CASPT2::solve( const double imag_shift, const bool CONJUGATE_GRA
 
 }
 
+void CheMPS2::CASPT2::solve_shifts( const int num_shifts, const double * imag_shifts, const double * real_shifts, double * energies, double * sector_energies ) const{
+
+   struct timeval start, end;
+   gettimeofday( &start, NULL );
+
+   // Normalizations of sectors   A  Bs Bt C  D  Es Et Fs Ft Gs Gt Hs Ht
+   const int normalizations[] = { 1, 2, 2, 1, 1, 2, 6, 2, 2, 2, 6, 4, 12 };
+
+   // Shift s adds real_shifts[ s ] * diag1 + imag_shifts[ s ]^2 * diag2 to the Fock operator
+   double * shift1 = new double[ num_shifts ];
+   double * shift2 = new double[ num_shifts ];
+   for ( int shift = 0; shift < num_shifts; shift++ ){
+      shift1[ shift ] = real_shifts[ shift ];
+      shift2[ shift ] = imag_shifts[ shift ] * imag_shifts[ shift ];
+   }
+
+   const long long total_size = jump[ CHEMPS2_CASPT2_NUM_CASES * num_irreps ];
+   double * diag_fock = MmapVector::allocate( total_size, scratch );
+   diagonal( diag_fock );
+   cout << "CASPT2 : Solution algorithm   = Multi-shift subspace for " << num_shifts << " shifts" << endl;
+   cout << "CASPT2 : Vector storage       = " << (( scratch.length() > 0 ) ? "out-of-core in " + scratch : "in memory" ) << endl;
+
+   const int max_num_vec = max( CheMPS2::DAVIDSON_NUM_VEC, 2 * num_shifts + 2 );
+   MultiShiftSolver * solver = new MultiShiftSolver( total_size, num_shifts, shift1, shift2, max_num_vec, CheMPS2::CONJ_GRADIENT_RTOL, CheMPS2::CONJ_GRADIENT_PRECOND_CUTOFF, false, scratch );
+   double ** pointers = new double*[ 4 ];
+   char instruction = solver->step( pointers );
+   assert( instruction == 'A' );
+   for ( long long elem = 0; elem < total_size; elem++ ){ pointers[ 0 ][ elem ] = diag_fock[ elem ]; } // Diagonal of the operator F
+   for ( long long elem = 0; elem < total_size; elem++ ){ pointers[ 1 ][ elem ] = vector_rhs[ elem ]; } // RHS of the linear problems
+   for ( int sector = 0; sector < CHEMPS2_CASPT2_NUM_CASES; sector++ ){
+      const long long first = jump[ num_irreps * sector         ];
+      const long long last  = jump[ num_irreps * ( sector + 1 ) ];
+      const double norm = normalizations[ sector ];
+      for ( long long elem = first; elem < last; elem++ ){
+         pointers[ 2 ][ elem ] = norm;                         // Real shift
+         pointers[ 3 ][ elem ] = norm * norm / diag_fock[ elem ]; // Imaginary shift
+      }
+   }
+   instruction = solver->step( pointers );
+   while ( instruction == 'B' ){
+      matvec( pointers[ 0 ], pointers[ 1 ], diag_fock );
+      instruction = solver->step( pointers );
+   }
+   assert( instruction == 'C' );
+   cout << "CASPT2 : Number of iterations = " << solver->get_num_matvec() << endl;
+   MmapVector::release( diag_fock, total_size, scratch );
+
+   double * solution    = MmapVector::allocate( total_size, scratch );
+   double * op_solution = MmapVector::allocate( total_size, scratch );
+   double sectors[ CHEMPS2_CASPT2_NUM_CASES ];
+   for ( int shift = 0; shift < num_shifts; shift++ ){
+      solver->get_solution( shift, solution, op_solution );
+      const double E2_NONVARIATIONAL = - Special::ddot64( total_size, solution, vector_rhs );
+      const double E2_VARIATIONAL = 2 * E2_NONVARIATIONAL + Special::ddot64( total_size, solution, op_solution );
+      const double reference_weight = 1.0 / ( 1.0 + inproduct_vectors( solution, solution, normalizations ) );
+      energies[ shift ] = E2_VARIATIONAL;
+      energy_per_sector( solution, sectors );
+      if ( sector_energies != NULL ){
+         for ( int sector = 0; sector < CHEMPS2_CASPT2_NUM_CASES; sector++ ){ sector_energies[ sector + CHEMPS2_CASPT2_NUM_CASES * shift ] = sectors[ sector ]; }
+      }
+      cout << "CASPT2 : Imaginary shift = " << imag_shifts[ shift ] << " ; Real shift = " << real_shifts[ shift ]
+           << " ; Residual norm = " << solver->get_residual_norm( shift ) << " ; Reference weight = " << reference_weight << endl;
+      cout << "CASPT2 : E2 [NON-VARIATIONAL] = " << E2_NONVARIATIONAL << endl;
+      cout << "CASPT2 : E2 [VARIATIONAL]     = " << E2_VARIATIONAL << endl;
+      print_energy_per_sector( sectors );
+   }
+   MmapVector::release( solution,    total_size, scratch );
+   MmapVector::release( op_solution, total_size, scratch );
+   delete [] pointers;
+   delete solver;
+   delete [] shift1;
+   delete [] shift2;
+
+   gettimeofday( &end, NULL );
+   double elapsed = ( end.tv_sec - start.tv_sec ) + 1e-6 * ( end.tv_usec - start.tv_usec );
+   cout << "CASPT2 : Wall time solution   = " << elapsed << " seconds" << endl;
+
+}
+
 void CheMPS2::CASPT2::add_shift( double * vector, double * result, double * diag_fock, const double imag_shift, const int * normalizations ) const{
 
    for ( int sector = 0; sector < CHEMPS2_CASPT2_NUM_CASES; sector++ ){
-      const int start = jump[ num_irreps * sector         ];
-      const int stop  = jump[ num_irreps * ( sector + 1 ) ];
+      const long long start = jump[ num_irreps * sector         ];
+      const long long stop  = jump[ num_irreps * ( sector + 1 ) ];
       const double factor = imag_shift * imag_shift * normalizations[ sector ] * normalizations[ sector ];
-      for ( int elem = start; elem < stop; elem ++ ){
+      for ( long long elem = start; elem < stop; elem ++ ){
          result[ elem ] += factor * vector[ elem ] / diag_fock[ elem ];
       }
    }
@@ -286,26 +371,28 @@ void CheMPS2::CASPT2::add_shift( double * vector, double * result, double * diag
 
 double CheMPS2::CASPT2::inproduct_vectors( double * first, double * second, const int * normalizations ) const{
 
-   int inc1 = 1;
    double value = 0.0;
    for ( int sector = 0; sector < CHEMPS2_CASPT2_NUM_CASES; sector++ ){
-      int pointer = jump[ num_irreps * sector         ];
-      int size    = jump[ num_irreps * ( sector + 1 ) ] - pointer;
-      value += normalizations[ sector ] * ddot_( &size, first + pointer, &inc1, second + pointer, &inc1 );
+      const long long pointer = jump[ num_irreps * sector         ];
+      const long long size    = jump[ num_irreps * ( sector + 1 ) ] - pointer;
+      value += normalizations[ sector ] * Special::ddot64( size, first + pointer, second + pointer );
    }
    return value;
 
 }
 
-void CheMPS2::CASPT2::energy_per_sector( double * solution ) const{
+void CheMPS2::CASPT2::energy_per_sector( double * solution, double * energies ) const{
 
-   int inc1 = 1;
-   double energies[ CHEMPS2_CASPT2_NUM_CASES ];
    for ( int sector = 0; sector < CHEMPS2_CASPT2_NUM_CASES; sector++ ){
-      int pointer = jump[ num_irreps * sector         ];
-      int size    = jump[ num_irreps * ( sector + 1 ) ] - pointer;
-      energies[ sector ] = - ddot_( &size, solution + pointer, &inc1, vector_rhs + pointer, &inc1 );
+      const long long pointer = jump[ num_irreps * sector         ];
+      const long long size    = jump[ num_irreps * ( sector + 1 ) ] - pointer;
+      energies[ sector ] = - Special::ddot64( size, solution + pointer, vector_rhs + pointer );
    }
+
+}
+
+void CheMPS2::CASPT2::print_energy_per_sector( const double * energies ){
+
    cout << "************************************************" << endl;
    cout << "*   CASPT2 non-variational energy per sector   *" << endl;
    cout << "************************************************" << endl;
@@ -321,6 +408,17 @@ void CheMPS2::CASPT2::energy_per_sector( double * solution ) const{
 
 }
 
+void CheMPS2::CASPT2::prefetch_block( const double * vector, const double * result, const int irrep, const int sector ) const{
+
+   if (( scratch.length() > 0 ) && ( irrep < num_irreps )){
+      const long long start = jump[ irrep + num_irreps * sector ];
+      const long long size  = jump[ irrep + num_irreps * sector + 1 ] - start;
+      MmapVector::prefetch( vector + start, size );
+      MmapVector::prefetch( result + start, size );
+   }
+
+}
+
 void CheMPS2::CASPT2::create_f_dots(){
 
    const int LAS = indices->getDMRGcumulative( num_irreps );
@@ -389,7 +487,7 @@ void CheMPS2::CASPT2::create_f_dots(){
 
                            for ( int orbx = 0; orbx < NDMRGx; orbx++ ){
                               value += ( fock->get( irrepx, NOCCx + orbx, NOCCx + orbx )
-                                       * three_rdm[ i1 + LAS*( i2 + LAS*( jumpx + orbx + LAS*( i3 + LAS*( i4 + LAS*( jumpx + orbx ))))) ] );
+                                       * three_rdm->get( i1, i2, jumpx + orbx, i3, i4, jumpx + orbx ) );
                            }
                         }
                         f_dot_3dm[ i1 + LAS * ( i2 + LAS * ( i3 + LAS * i4 )) ] = value;
@@ -416,9 +514,9 @@ void CheMPS2::CASPT2::create_f_dots(){
 
 }
 
-int CheMPS2::CASPT2::vector_helper(){
+long long CheMPS2::CASPT2::vector_helper(){
 
-   int * helper = new int[ CHEMPS2_CASPT2_NUM_CASES * num_irreps ];
+   long long * helper = new long long[ CHEMPS2_CASPT2_NUM_CASES * num_irreps ];
 
    /*** Type A : c_tiuv E_ti E_uv | 0 >
                  c_tiuv = vector[ jump[ irrep + num_irreps * CHEMPS2_CASPT2_A ] + count_tuv + size_A[ irrep ] * count_i ]
@@ -572,10 +670,10 @@ int CheMPS2::CASPT2::vector_helper(){
       size_F_singlet[ irrep ] = jump_tu_singlet;
       size_F_triplet[ irrep ] = jump_tu_triplet;
 
-      int linsize_B_singlet = 0;
-      int linsize_B_triplet = 0;
-      int linsize_F_singlet = 0;
-      int linsize_F_triplet = 0;
+      long long linsize_B_singlet = 0;
+      long long linsize_B_triplet = 0;
+      long long linsize_F_singlet = 0;
+      long long linsize_F_triplet = 0;
       if ( irrep == 0 ){ // irrep_i == irrep_j    or    irrep_a == irrep_b
          for ( int irrep_ijab = 0; irrep_ijab < num_irreps; irrep_ijab++ ){
             const int nocc_ij = indices->getNOCC( irrep_ijab );
@@ -632,8 +730,8 @@ int CheMPS2::CASPT2::vector_helper(){
    size_E = new int[ num_irreps ];
    for ( int irrep = 0; irrep < num_irreps; irrep++ ){
       size_E[ irrep ] = indices->getNDMRG( irrep );
-      int linsize_E_singlet = 0;
-      int linsize_E_triplet = 0;
+      long long linsize_E_singlet = 0;
+      long long linsize_E_triplet = 0;
       for ( int irrep_a = 0; irrep_a < num_irreps; irrep_a++ ){
          const int nvirt_a = indices->getNVIRT( irrep_a );
          const int irrep_occ = Irreps::directProd( irrep, irrep_a );
@@ -685,8 +783,8 @@ int CheMPS2::CASPT2::vector_helper(){
    size_G = new int[ num_irreps ];
    for ( int irrep = 0; irrep < num_irreps; irrep++ ){
       size_G[ irrep ] = indices->getNDMRG( irrep );
-      int linsize_G_singlet = 0;
-      int linsize_G_triplet = 0;
+      long long linsize_G_singlet = 0;
+      long long linsize_G_triplet = 0;
       for ( int irrep_i = 0; irrep_i < num_irreps; irrep_i++ ){
          const int nocc_i = indices->getNOCC( irrep_i );
          const int irrep_virt = Irreps::directProd( irrep, irrep_i );
@@ -742,18 +840,18 @@ int CheMPS2::CASPT2::vector_helper(){
    */
 
    for ( int irrep = 0; irrep < num_irreps; irrep++ ){
-      int linsize_H_singlet = 0;
-      int linsize_H_triplet = 0;
+      long long linsize_H_singlet = 0;
+      long long linsize_H_triplet = 0;
       if ( irrep == 0 ){ // irrep_i == irrep_j  and  irrep_a == irrep_b
-         int linsize_ij_singlet = 0;
-         int linsize_ij_triplet = 0;
+         long long linsize_ij_singlet = 0;
+         long long linsize_ij_triplet = 0;
          for ( int irrep_ij = 0; irrep_ij < num_irreps; irrep_ij++ ){
             const int nocc_ij = indices->getNOCC( irrep_ij );
             linsize_ij_singlet += ( nocc_ij * ( nocc_ij + 1 )) / 2;
             linsize_ij_triplet += ( nocc_ij * ( nocc_ij - 1 )) / 2;
          }
-         int linsize_ab_singlet = 0;
-         int linsize_ab_triplet = 0;
+         long long linsize_ab_singlet = 0;
+         long long linsize_ab_triplet = 0;
          for ( int irrep_ab = 0; irrep_ab < num_irreps; irrep_ab++ ){
             const int nvirt_ab = indices->getNVIRT( irrep_ab );
             linsize_ab_singlet += ( nvirt_ab * ( nvirt_ab + 1 )) / 2;
@@ -762,12 +860,12 @@ int CheMPS2::CASPT2::vector_helper(){
          linsize_H_singlet = linsize_ij_singlet * linsize_ab_singlet;
          linsize_H_triplet = linsize_ij_triplet * linsize_ab_triplet;
       } else { // irrep_i < irrep_j = irrep_i x irrep   and   irrep_a < irrep_b = irrep_a x irrep
-         int linsize_ij = 0;
+         long long linsize_ij = 0;
          for ( int irrep_i = 0; irrep_i < num_irreps; irrep_i++ ){
             const int irrep_j = Irreps::directProd( irrep, irrep_i );
             if ( irrep_i < irrep_j ){ linsize_ij += indices->getNOCC( irrep_i ) * indices->getNOCC( irrep_j ); }
          }
-         int linsize_ab = 0;
+         long long linsize_ab = 0;
          for ( int irrep_a = 0; irrep_a < num_irreps; irrep_a++ ){
             const int irrep_b = Irreps::directProd( irrep, irrep_a );
             if ( irrep_a < irrep_b ){ linsize_ab += indices->getNVIRT( irrep_a ) * indices->getNVIRT( irrep_b ); }
@@ -779,11 +877,11 @@ int CheMPS2::CASPT2::vector_helper(){
       helper[ irrep + num_irreps * CHEMPS2_CASPT2_H_TRIPLET ] = linsize_H_triplet;
    }
 
-   jump = new int[ CHEMPS2_CASPT2_NUM_CASES * num_irreps + 1 ];
+   jump = new long long[ CHEMPS2_CASPT2_NUM_CASES * num_irreps + 1 ];
    jump[ 0 ] = 0;
    for ( int cnt = 0; cnt < CHEMPS2_CASPT2_NUM_CASES * num_irreps; cnt++ ){ jump[ cnt+1 ] = jump[ cnt ] + helper[ cnt ]; }
    delete [] helper;
-   const int total_size = jump[ CHEMPS2_CASPT2_NUM_CASES * num_irreps ];
+   const long long total_size = jump[ CHEMPS2_CASPT2_NUM_CASES * num_irreps ];
    assert( total_size == vector_length( indices ) );
    cout << "CASPT2 : Old size V_SD space  = " << total_size << endl;
    return total_size;
@@ -1023,8 +1121,8 @@ void CheMPS2::CASPT2::recreate(){
    delete [] work;
    delete [] eigs;
 
-   double * tempvector_rhs = new double[ jump[ num_irreps * CHEMPS2_CASPT2_NUM_CASES ] ];
-   int * helper = new int[ num_irreps * CHEMPS2_CASPT2_NUM_CASES ];
+   double * tempvector_rhs = MmapVector::allocate( jump[ num_irreps * CHEMPS2_CASPT2_NUM_CASES ], scratch );
+   long long * helper = new long long[ num_irreps * CHEMPS2_CASPT2_NUM_CASES ];
    for ( int ptr = 0; ptr < num_irreps * CHEMPS2_CASPT2_NUM_CASES; ptr++ ){ helper[ ptr ] = 0; }
 
    for ( int irrep = 0; irrep < num_irreps; irrep++ ){
@@ -1113,15 +1211,14 @@ void CheMPS2::CASPT2::recreate(){
 
       const int ptr1 = irrep + num_irreps * CHEMPS2_CASPT2_H_SINGLET;
       helper[ ptr1 ] = jump[ ptr1 + 1 ] - jump[ ptr1 ];
-      int inc1 = 1;
-      dcopy_( helper + ptr1, vector_rhs + jump[ ptr1 ], &inc1, tempvector_rhs + jump[ ptr1 ], &inc1 );
+      Special::dcopy64( helper[ ptr1 ], vector_rhs + jump[ ptr1 ], tempvector_rhs + jump[ ptr1 ] );
       const int ptr2 = irrep + num_irreps * CHEMPS2_CASPT2_H_TRIPLET;
       helper[ ptr2 ] = jump[ ptr2 + 1 ] - jump[ ptr2 ];
-      dcopy_( helper + ptr2, vector_rhs + jump[ ptr2 ], &inc1, tempvector_rhs + jump[ ptr2 ], &inc1 );
+      Special::dcopy64( helper[ ptr2 ], vector_rhs + jump[ ptr2 ], tempvector_rhs + jump[ ptr2 ] );
 
    }
 
-   delete [] vector_rhs;
+   MmapVector::release( vector_rhs, jump[ num_irreps * CHEMPS2_CASPT2_NUM_CASES ], scratch );
    delete [] size_A;         size_A = newsize_A;
    delete [] size_C;         size_C = newsize_C;
    delete [] size_D;         size_D = newsize_D;
@@ -1132,17 +1229,16 @@ void CheMPS2::CASPT2::recreate(){
    delete [] size_F_singlet; size_F_singlet = newsize_F_singlet;
    delete [] size_F_triplet; size_F_triplet = newsize_F_triplet;
 
-   int * newjump = new int[ num_irreps * CHEMPS2_CASPT2_NUM_CASES + 1 ];
+   long long * newjump = new long long[ num_irreps * CHEMPS2_CASPT2_NUM_CASES + 1 ];
    newjump[ 0 ] = 0;
    for ( int cnt = 0; cnt < num_irreps * CHEMPS2_CASPT2_NUM_CASES; cnt++ ){
       newjump[ cnt + 1 ] = newjump[ cnt ] + helper[ cnt ];
    }
-   vector_rhs = new double[ newjump[ num_irreps * CHEMPS2_CASPT2_NUM_CASES ] ];
-   int inc1 = 1;
+   vector_rhs = MmapVector::allocate( newjump[ num_irreps * CHEMPS2_CASPT2_NUM_CASES ], scratch );
    for ( int cnt = 0; cnt < num_irreps * CHEMPS2_CASPT2_NUM_CASES; cnt++ ){
-      dcopy_( helper + cnt, tempvector_rhs + jump[ cnt ], &inc1, vector_rhs + newjump[ cnt ], &inc1 );
+      Special::dcopy64( helper[ cnt ], tempvector_rhs + jump[ cnt ], vector_rhs + newjump[ cnt ] );
    }
-   delete [] tempvector_rhs;
+   MmapVector::release( tempvector_rhs, jump[ num_irreps * CHEMPS2_CASPT2_NUM_CASES ], scratch );
    delete [] helper;
    delete [] jump;
    jump = newjump;
@@ -1169,6 +1265,7 @@ void CheMPS2::CASPT2::recreate(){
    delete [] SFF_triplet;
 
    double * temp = NULL;
+   int inc1 = 1;
    for ( int irrep = 0; irrep < num_irreps; irrep++ ){
        temp = new double[ size_A[ irrep ] ]; dcopy_( size_A + irrep, FAA[ irrep ], &inc1, temp, &inc1 ); delete [] FAA[ irrep ]; FAA[ irrep ] = temp;
        temp = new double[ size_C[ irrep ] ]; dcopy_( size_C + irrep, FCC[ irrep ], &inc1, temp, &inc1 ); delete [] FCC[ irrep ]; FCC[ irrep ] = temp;
@@ -1181,7 +1278,7 @@ void CheMPS2::CASPT2::recreate(){
        temp = new double[ size_F_triplet[ irrep ] ]; dcopy_( size_F_triplet + irrep, FFF_triplet[ irrep ], &inc1, temp, &inc1 ); delete [] FFF_triplet[ irrep ]; FFF_triplet[ irrep ] = temp;
    }
 
-   const int total_size = jump[ num_irreps * CHEMPS2_CASPT2_NUM_CASES ];
+   const long long total_size = jump[ num_irreps * CHEMPS2_CASPT2_NUM_CASES ];
    cout << "CASPT2 : New size V_SD space  = " << total_size << endl;
 
 }
@@ -1237,9 +1334,16 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
       
    */
 
-   const int vectorlength = jump[ CHEMPS2_CASPT2_NUM_CASES * num_irreps ];
-   #pragma omp simd
-   for ( int elem = 0; elem < vectorlength; elem++ ){ result[ elem ] = diag_fock[ elem ] * vector[ elem ]; }
+   // Stream over the blocks ( irrep, case ), so that out-of-core the next block is read while the current one is processed
+   for ( int block = 0; block < CHEMPS2_CASPT2_NUM_CASES * num_irreps; block++ ){
+      if ( block + 1 < CHEMPS2_CASPT2_NUM_CASES * num_irreps ){
+         prefetch_block( vector, diag_fock, ( block + 1 ) % num_irreps, ( block + 1 ) / num_irreps );
+      }
+      const long long start = jump[ block     ];
+      const long long stop  = jump[ block + 1 ];
+      #pragma omp simd
+      for ( long long elem = start; elem < stop; elem++ ){ result[ elem ] = diag_fock[ elem ] * vector[ elem ]; }
+   }
    const int maxlinsize = get_maxsize();
    double * workspace = new double[ maxlinsize * maxlinsize ];
    const double SQRT2 = sqrt( 2.0 );
@@ -1251,7 +1355,7 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
       for ( int IR = 0; IR < num_irreps; IR++ ){ // IR == It x Iu == Ii x Ia
          const int SIZE_R = size_D[ IR ];
          const int Iw = Irreps::directProd( IL, IR ); // Ia == Ic == Iw == IL x IR
-         const int shift = shift_D_nonactive( indices, IL, Iw );
+         const long long shift = shift_D_nonactive( indices, IL, Iw );
          const int nocc_w = indices->getNOCC( Iw );
          const int nact_w = indices->getNDMRG( Iw );
          const int n_oa_w = nocc_w + nact_w;
@@ -1265,8 +1369,8 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
                   int inc1 = 1;
                   daxpy_( &total_size, &f_wc, FAD[ IL ][ IR ][ w ], &inc1, workspace, &inc1 );
                }
-               const int ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_A ];
-               const int ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_D ] + SIZE_R * ( shift + nocc_ij * ac );
+               const long long ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_A ];
+               const long long ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_D ] + SIZE_R * ( shift + nocc_ij * ac );
                matmat( 'N', SIZE_L, nocc_ij, SIZE_R, 1.0, workspace, SIZE_L, vector + ptr_R, SIZE_R, result + ptr_L, SIZE_L );
                matmat( 'T', SIZE_R, nocc_ij, SIZE_L, 1.0, workspace, SIZE_L, vector + ptr_L, SIZE_L, result + ptr_R, SIZE_R );
             }
@@ -1281,7 +1385,7 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
       for ( int IR = 0; IR < num_irreps; IR++ ){ // IR == It x Iu == Ii x Ia
          const int SIZE_R = size_D[ IR ];
          const int Iw = Irreps::directProd( IL, IR ); // Ii == Ik == Iw == IL x IR
-         const int shift = shift_D_nonactive( indices, Iw, IL );
+         const long long shift = shift_D_nonactive( indices, Iw, IL );
          const int nocc_w = indices->getNOCC( Iw );
          const int nact_w = indices->getNDMRG( Iw );
          int total_size = SIZE_L * SIZE_R;
@@ -1293,8 +1397,8 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
                   int inc1 = 1;
                   daxpy_( &total_size, &f_kw, FCD[ IL ][ IR ][ w ], &inc1, workspace, &inc1 );
                }
-               const int ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_C ];
-               const int ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_D ] + SIZE_R * ( shift + ik );
+               const long long ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_C ];
+               const long long ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_D ] + SIZE_R * ( shift + ik );
                const int LDA_R = SIZE_R * nocc_w;
                matmat( 'N', SIZE_L, nvir_ab, SIZE_R, 1.0, workspace, SIZE_L, vector + ptr_R, LDA_R,  result + ptr_L, SIZE_L );
                matmat( 'T', SIZE_R, nvir_ab, SIZE_L, 1.0, workspace, SIZE_L, vector + ptr_L, SIZE_L, result + ptr_R, LDA_R  );
@@ -1310,7 +1414,7 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
       for ( int IR = 0; IR < num_irreps; IR++ ){ // IR == It x Iu == Ii x Ij
          const int SIZE_R = size_B_singlet[ IR ];
          const int Iw = Irreps::directProd( IL, IR ); // Iw == Ik
-         const int shift = (( Iw < IL ) ? shift_B_nonactive( indices, Iw, IL, +1 ) : shift_B_nonactive( indices, IL, Iw, +1 ));
+         const long long shift = (( Iw < IL ) ? shift_B_nonactive( indices, Iw, IL, +1 ) : shift_B_nonactive( indices, IL, Iw, +1 ));
          const int nocc_w = indices->getNOCC( Iw );
          const int nact_w = indices->getNDMRG( Iw );
          int total_size = SIZE_L * SIZE_R;
@@ -1324,22 +1428,22 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
                }
                if ( IR == 0 ){ // Ii == Ij  and  Ik == Il
                   if ( k > 0 ){
-                     const int ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_A         ];
-                     const int ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_B_SINGLET ] + SIZE_R * ( shift + ( k * ( k + 1 ) ) / 2 );
+                     const long long ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_A         ];
+                     const long long ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_B_SINGLET ] + SIZE_R * ( shift + ( k * ( k + 1 ) ) / 2 );
                      matmat( 'N', SIZE_L, k, SIZE_R, 1.0, workspace, SIZE_L, vector + ptr_R, SIZE_R, result + ptr_L, SIZE_L );
                      matmat( 'T', SIZE_R, k, SIZE_L, 1.0, workspace, SIZE_L, vector + ptr_L, SIZE_L, result + ptr_R, SIZE_R );
                   }
                   #pragma omp parallel for schedule(static)
                   for ( int l = k; l < nocc_l; l++ ){
-                     const int ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_A         ] + SIZE_L * l;
-                     const int ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_B_SINGLET ] + SIZE_R * ( shift + k + ( l * ( l + 1 ) ) / 2 );
+                     const long long ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_A         ] + SIZE_L * l;
+                     const long long ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_B_SINGLET ] + SIZE_R * ( shift + k + ( l * ( l + 1 ) ) / 2 );
                      const double factor = (( k == l ) ? SQRT2 : 1.0 );
                      matmat( 'N', SIZE_L, 1, SIZE_R, factor, workspace, SIZE_L, vector + ptr_R, SIZE_R, result + ptr_L, SIZE_L );
                      matmat( 'T', SIZE_R, 1, SIZE_L, factor, workspace, SIZE_L, vector + ptr_L, SIZE_L, result + ptr_R, SIZE_R );
                   }
                } else {
-                  const int ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_A         ];
-                  const int ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_B_SINGLET ] + SIZE_R * ( shift + (( Iw < IL ) ? k : nocc_l * k ));
+                  const long long ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_A         ];
+                  const long long ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_B_SINGLET ] + SIZE_R * ( shift + (( Iw < IL ) ? k : nocc_l * k ));
                   const int LDA_R = (( Iw < IL ) ? SIZE_R * nocc_w : SIZE_R );
                   matmat( 'N', SIZE_L, nocc_l, SIZE_R, 1.0, workspace, SIZE_L, vector + ptr_R, LDA_R,  result + ptr_L, SIZE_L );
                   matmat( 'T', SIZE_R, nocc_l, SIZE_L, 1.0, workspace, SIZE_L, vector + ptr_L, SIZE_L, result + ptr_R, LDA_R  );
@@ -1356,7 +1460,7 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
       for ( int IR = 0; IR < num_irreps; IR++ ){ // IR == It x Iu == Ii x Ij
          const int SIZE_R = size_B_triplet[ IR ];
          const int Iw = Irreps::directProd( IL, IR ); // Iw == Ik
-         const int shift = (( Iw < IL ) ? shift_B_nonactive( indices, Iw, IL, -1 ) : shift_B_nonactive( indices, IL, Iw, -1 ));
+         const long long shift = (( Iw < IL ) ? shift_B_nonactive( indices, Iw, IL, -1 ) : shift_B_nonactive( indices, IL, Iw, -1 ));
          const int nocc_w = indices->getNOCC( Iw );
          const int nact_w = indices->getNDMRG( Iw );
          int total_size = SIZE_L * SIZE_R;
@@ -1370,21 +1474,21 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
                }
                if ( IR == 0 ){ // Ii == Ij  and  Ik == Il
                   if ( k > 0 ){ // ( k > l  --->  - delta_jk delta_il )
-                     const int ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_A         ];
-                     const int ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_B_TRIPLET ] + SIZE_R * ( shift + ( k * ( k - 1 ) ) / 2 );
+                     const long long ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_A         ];
+                     const long long ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_B_TRIPLET ] + SIZE_R * ( shift + ( k * ( k - 1 ) ) / 2 );
                      matmat( 'N', SIZE_L, k, SIZE_R, -1.0, workspace, SIZE_L, vector + ptr_R, SIZE_R, result + ptr_L, SIZE_L );
                      matmat( 'T', SIZE_R, k, SIZE_L, -1.0, workspace, SIZE_L, vector + ptr_L, SIZE_L, result + ptr_R, SIZE_R );
                   }
                   #pragma omp parallel for schedule(static)
                   for ( int l = k+1; l < nocc_l; l++ ){
-                     const int ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_A         ] + SIZE_L * l;
-                     const int ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_B_TRIPLET ] + SIZE_R * ( shift + k + ( l * ( l - 1 ) ) / 2 );
+                     const long long ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_A         ] + SIZE_L * l;
+                     const long long ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_B_TRIPLET ] + SIZE_R * ( shift + k + ( l * ( l - 1 ) ) / 2 );
                      matmat( 'N', SIZE_L, 1, SIZE_R, 1.0, workspace, SIZE_L, vector + ptr_R, SIZE_R, result + ptr_L, SIZE_L ); // ( k < l  --->  + delta_ik delta_jl )
                      matmat( 'T', SIZE_R, 1, SIZE_L, 1.0, workspace, SIZE_L, vector + ptr_L, SIZE_L, result + ptr_R, SIZE_R );
                   }
                } else {
-                  const int ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_A         ];
-                  const int ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_B_TRIPLET ] + SIZE_R * ( shift + (( Iw < IL ) ? k : nocc_l * k ));
+                  const long long ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_A         ];
+                  const long long ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_B_TRIPLET ] + SIZE_R * ( shift + (( Iw < IL ) ? k : nocc_l * k ));
                   const int LDA_R = (( Iw < IL ) ? SIZE_R * nocc_w : SIZE_R );
                   const double factor = (( Iw < IL ) ? 1.0 : -1.0 ); // ( k < l  --->  + delta_ik delta_jl ) and ( k > l  --->  - delta_jk delta_il )
                   matmat( 'N', SIZE_L, nocc_l, SIZE_R, factor, workspace, SIZE_L, vector + ptr_R, LDA_R,  result + ptr_L, SIZE_L );
@@ -1402,7 +1506,7 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
       for ( int IR = 0; IR < num_irreps; IR++ ){ // IR == It x Iu == Ia x Ib
          const int SIZE_R = size_F_singlet[ IR ];
          const int Iw = Irreps::directProd( IL, IR ); // Iw == Ic
-         const int shift = (( Iw < IL ) ? shift_F_nonactive( indices, Iw, IL, +1 ) : shift_F_nonactive( indices, IL, Iw, +1 ));
+         const long long shift = (( Iw < IL ) ? shift_F_nonactive( indices, Iw, IL, +1 ) : shift_F_nonactive( indices, IL, Iw, +1 ));
          const int nocc_w = indices->getNOCC( Iw );
          const int nact_w = indices->getNDMRG( Iw );
          const int n_oa_w = nocc_w + nact_w;
@@ -1418,22 +1522,22 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
                }
                if ( IR == 0 ){ // Ia == Ib  and  Ic == Id
                   if ( c > 0 ){
-                     const int ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_C         ];
-                     const int ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_F_SINGLET ] + SIZE_R * ( shift + ( c * ( c + 1 ) ) / 2 );
+                     const long long ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_C         ];
+                     const long long ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_F_SINGLET ] + SIZE_R * ( shift + ( c * ( c + 1 ) ) / 2 );
                      matmat( 'N', SIZE_L, c, SIZE_R, 1.0, workspace, SIZE_L, vector + ptr_R, SIZE_R, result + ptr_L, SIZE_L );
                      matmat( 'T', SIZE_R, c, SIZE_L, 1.0, workspace, SIZE_L, vector + ptr_L, SIZE_L, result + ptr_R, SIZE_R );
                   }
                   #pragma omp parallel for schedule(static)
                   for ( int d = c; d < nvir_d; d++ ){
-                     const int ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_C         ] + SIZE_L * d;
-                     const int ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_F_SINGLET ] + SIZE_R * ( shift + c + ( d * ( d + 1 ) ) / 2 );
+                     const long long ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_C         ] + SIZE_L * d;
+                     const long long ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_F_SINGLET ] + SIZE_R * ( shift + c + ( d * ( d + 1 ) ) / 2 );
                      const double factor = (( c == d ) ? SQRT2 : 1.0 );
                      matmat( 'N', SIZE_L, 1, SIZE_R, factor, workspace, SIZE_L, vector + ptr_R, SIZE_R, result + ptr_L, SIZE_L );
                      matmat( 'T', SIZE_R, 1, SIZE_L, factor, workspace, SIZE_L, vector + ptr_L, SIZE_L, result + ptr_R, SIZE_R );
                   }
                } else {
-                  const int ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_C         ];
-                  const int ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_F_SINGLET ] + SIZE_R * ( shift + (( Iw < IL ) ? c : nvir_d * c ));
+                  const long long ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_C         ];
+                  const long long ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_F_SINGLET ] + SIZE_R * ( shift + (( Iw < IL ) ? c : nvir_d * c ));
                   const int LDA_R = (( Iw < IL ) ? SIZE_R * nvir_w : SIZE_R );
                   matmat( 'N', SIZE_L, nvir_d, SIZE_R, 1.0, workspace, SIZE_L, vector + ptr_R, LDA_R,  result + ptr_L, SIZE_L );
                   matmat( 'T', SIZE_R, nvir_d, SIZE_L, 1.0, workspace, SIZE_L, vector + ptr_L, SIZE_L, result + ptr_R, LDA_R  );
@@ -1450,7 +1554,7 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
       for ( int IR = 0; IR < num_irreps; IR++ ){ // IR == It x Iu == Ia x Ib
          const int SIZE_R = size_F_triplet[ IR ];
          const int Iw = Irreps::directProd( IL, IR ); // Iw == Ic
-         const int shift = (( Iw < IL ) ? shift_F_nonactive( indices, Iw, IL, -1 ) : shift_F_nonactive( indices, IL, Iw, -1 ));
+         const long long shift = (( Iw < IL ) ? shift_F_nonactive( indices, Iw, IL, -1 ) : shift_F_nonactive( indices, IL, Iw, -1 ));
          const int nocc_w = indices->getNOCC( Iw );
          const int nact_w = indices->getNDMRG( Iw );
          const int n_oa_w = nocc_w + nact_w;
@@ -1466,22 +1570,22 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
                }
                if ( IR == 0 ){ // Ia == Ib  and  Ic == Id
                   if ( c > 0 ){ // ( c > d  --->  - delta_ad delta_bc )
-                     const int ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_C         ];
-                     const int ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_F_TRIPLET ] + SIZE_R * ( shift + ( c * ( c - 1 ) ) / 2 );
+                     const long long ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_C         ];
+                     const long long ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_F_TRIPLET ] + SIZE_R * ( shift + ( c * ( c - 1 ) ) / 2 );
                      matmat( 'N', SIZE_L, c, SIZE_R, -1.0, workspace, SIZE_L, vector + ptr_R, SIZE_R, result + ptr_L, SIZE_L );
                      matmat( 'T', SIZE_R, c, SIZE_L, -1.0, workspace, SIZE_L, vector + ptr_L, SIZE_L, result + ptr_R, SIZE_R );
                   }
                   #pragma omp parallel for schedule(static)
                   for ( int d = c+1; d < nvir_d; d++ ){
-                     const int ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_C         ] + SIZE_L * d;
-                     const int ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_F_TRIPLET ] + SIZE_R * ( shift + c + ( d * ( d - 1 ) ) / 2 );
+                     const long long ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_C         ] + SIZE_L * d;
+                     const long long ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_F_TRIPLET ] + SIZE_R * ( shift + c + ( d * ( d - 1 ) ) / 2 );
                      matmat( 'N', SIZE_L, 1, SIZE_R, 1.0, workspace, SIZE_L, vector + ptr_R, SIZE_R, result + ptr_L, SIZE_L ); // ( c < d  --->  + delta_ac delta_bd )
                      matmat( 'T', SIZE_R, 1, SIZE_L, 1.0, workspace, SIZE_L, vector + ptr_L, SIZE_L, result + ptr_R, SIZE_R );
                   }
                } else {
                   const double factor = (( Iw < IL ) ? 1.0 : -1.0 ); // ( c < d  --->  + delta_ac delta_bd ) and ( c > d  --->  - delta_ad delta_bc )
-                  const int ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_C         ];
-                  const int ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_F_TRIPLET ] + SIZE_R * ( shift + (( Iw < IL ) ? c : nvir_d * c ));
+                  const long long ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_C         ];
+                  const long long ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_F_TRIPLET ] + SIZE_R * ( shift + (( Iw < IL ) ? c : nvir_d * c ));
                   const int LDA_R = (( Iw < IL ) ? SIZE_R * nvir_w : SIZE_R );
                   matmat( 'N', SIZE_L, nvir_d, SIZE_R, factor, workspace, SIZE_L, vector + ptr_R, LDA_R,  result + ptr_L, SIZE_L );
                   matmat( 'T', SIZE_R, nvir_d, SIZE_L, factor, workspace, SIZE_L, vector + ptr_L, SIZE_L, result + ptr_R, LDA_R  );
@@ -1495,6 +1599,7 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
    for ( int IL = 0; IL < num_irreps; IL++ ){ // IL == Iik x Ijl == Ix x Iy
       const int SIZE_L = size_B_singlet[ IL ];
       for ( int IR = 0; IR < num_irreps; IR++ ){ // IR == It == Iik x Ijl x Iac
+         prefetch_block( vector, result, IR + 1, CHEMPS2_CASPT2_E_SINGLET );
          const int SIZE_R = size_E[ IR ];
          const int Iw = Irreps::directProd( IL, IR ); // Iw == Iac
          const int nocc_w = indices->getNOCC( Iw );
@@ -1512,7 +1617,7 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
          const int size_ij = linsize;
          int total_size = SIZE_L * SIZE_R;
          if ( total_size * nact_w * nvir_w * size_ij > 0 ){
-            const int shift_E = shift_E_nonactive( indices, Iw, 0, IL, +1 );
+            const long long shift_E = shift_E_nonactive( indices, Iw, 0, IL, +1 );
             for ( int ac = 0; ac < nvir_w; ac++ ){
                for ( int cnt = 0; cnt < total_size; cnt++ ){ workspace[ cnt ] = 0.0; }
                for ( int w = 0; w < nact_w; w++ ){
@@ -1520,8 +1625,8 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
                   int inc1 = 1;
                   daxpy_( &total_size, &f_wc, FBE_singlet[ IL ][ IR ][ w ], &inc1, workspace, &inc1 );
                }
-               const int ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_B_SINGLET ];
-               const int ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_E_SINGLET ] + SIZE_R * ( shift_E + ac );
+               const long long ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_B_SINGLET ];
+               const long long ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_E_SINGLET ] + SIZE_R * ( shift_E + ac );
                const int LDA_R = SIZE_R * nvir_w;
                matmat( 'N', SIZE_L, size_ij, SIZE_R, 2.0, workspace, SIZE_L, vector + ptr_R, LDA_R,  result + ptr_L, SIZE_L );
                matmat( 'T', SIZE_R, size_ij, SIZE_L, 2.0, workspace, SIZE_L, vector + ptr_L, SIZE_L, result + ptr_R, LDA_R  );
@@ -1534,6 +1639,7 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
    for ( int IL = 0; IL < num_irreps; IL++ ){ // IL == Iik x Ijl == Ix x Iy
       const int SIZE_L = size_B_triplet[ IL ];
       for ( int IR = 0; IR < num_irreps; IR++ ){ // IR == It == Iik x Ijl x Iac
+         prefetch_block( vector, result, IR + 1, CHEMPS2_CASPT2_E_TRIPLET );
          const int SIZE_R = size_E[ IR ];
          const int Iw = Irreps::directProd( IL, IR ); // Iw == Iac
          const int nocc_w = indices->getNOCC( Iw );
@@ -1551,7 +1657,7 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
          const int size_ij = linsize;
          int total_size = SIZE_L * SIZE_R;
          if ( total_size * nact_w * nvir_w * size_ij > 0 ){
-            const int shift_E = shift_E_nonactive( indices, Iw, 0, IL, -1 );
+            const long long shift_E = shift_E_nonactive( indices, Iw, 0, IL, -1 );
             for ( int ac = 0; ac < nvir_w; ac++ ){
                for ( int cnt = 0; cnt < total_size; cnt++ ){ workspace[ cnt ] = 0.0; }
                for ( int w = 0; w < nact_w; w++ ){
@@ -1559,8 +1665,8 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
                   int inc1 = 1;
                   daxpy_( &total_size, &f_wc, FBE_triplet[ IL ][ IR ][ w ], &inc1, workspace, &inc1 );
                }
-               const int ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_B_TRIPLET ];
-               const int ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_E_TRIPLET ] + SIZE_R * ( shift_E + ac );
+               const long long ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_B_TRIPLET ];
+               const long long ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_E_TRIPLET ] + SIZE_R * ( shift_E + ac );
                const int LDA_R = SIZE_R * nvir_w;
                matmat( 'N', SIZE_L, size_ij, SIZE_R, 2.0, workspace, SIZE_L, vector + ptr_R, LDA_R,  result + ptr_L, SIZE_L );
                matmat( 'T', SIZE_R, size_ij, SIZE_L, 2.0, workspace, SIZE_L, vector + ptr_L, SIZE_L, result + ptr_R, LDA_R  );
@@ -1573,6 +1679,7 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
    for ( int IL = 0; IL < num_irreps; IL++ ){ // IL == Iac x Ibd == Ix x Iy
       const int SIZE_L = size_F_singlet[ IL ];
       for ( int IR = 0; IR < num_irreps; IR++ ){ // IR == It == Iac x Ibd x Iik
+         prefetch_block( vector, result, IR + 1, CHEMPS2_CASPT2_G_SINGLET );
          const int SIZE_R = size_G[ IR ];
          const int Iw = Irreps::directProd( IL, IR ); // Iw == Iik
          const int nocc_w = indices->getNOCC( Iw );
@@ -1588,7 +1695,7 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
          const int size_ab = linsize;
          int total_size = SIZE_L * SIZE_R;
          if ( total_size * nact_w * nocc_w * size_ab > 0 ){
-            const int shift_G = shift_G_nonactive( indices, Iw, 0, IL, +1 );
+            const long long shift_G = shift_G_nonactive( indices, Iw, 0, IL, +1 );
             for ( int ik = 0; ik < nocc_w; ik++ ){
                for ( int cnt = 0; cnt < total_size; cnt++ ){ workspace[ cnt ] = 0.0; }
                for ( int w = 0; w < nact_w; w++ ){
@@ -1596,8 +1703,8 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
                   int inc1 = 1;
                   daxpy_( &total_size, &f_kw, FFG_singlet[ IL ][ IR ][ w ], &inc1, workspace, &inc1 );
                }
-               const int ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_F_SINGLET ];
-               const int ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_G_SINGLET ] + SIZE_R * ( shift_G + ik );
+               const long long ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_F_SINGLET ];
+               const long long ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_G_SINGLET ] + SIZE_R * ( shift_G + ik );
                const int LDA_R = SIZE_R * nocc_w;
                matmat( 'N', SIZE_L, size_ab, SIZE_R, 2.0, workspace, SIZE_L, vector + ptr_R, LDA_R,  result + ptr_L, SIZE_L );
                matmat( 'T', SIZE_R, size_ab, SIZE_L, 2.0, workspace, SIZE_L, vector + ptr_L, SIZE_L, result + ptr_R, LDA_R  );
@@ -1610,6 +1717,7 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
    for ( int IL = 0; IL < num_irreps; IL++ ){ // IL == Iac x Ibd == Ix x Iy
       const int SIZE_L = size_F_triplet[ IL ];
       for ( int IR = 0; IR < num_irreps; IR++ ){ // IR == It == Iac x Ibd x Iik
+         prefetch_block( vector, result, IR + 1, CHEMPS2_CASPT2_G_TRIPLET );
          const int SIZE_R = size_G[ IR ];
          const int Iw = Irreps::directProd( IL, IR ); // Iw == Iik
          const int nocc_w = indices->getNOCC( Iw );
@@ -1625,7 +1733,7 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
          const int size_ab = linsize;
          int total_size = SIZE_L * SIZE_R;
          if ( total_size * nact_w * nocc_w * size_ab > 0 ){
-            const int shift_G = shift_G_nonactive( indices, Iw, 0, IL, -1 );
+            const long long shift_G = shift_G_nonactive( indices, Iw, 0, IL, -1 );
             for ( int ik = 0; ik < nocc_w; ik++ ){
                for ( int cnt = 0; cnt < total_size; cnt++ ){ workspace[ cnt ] = 0.0; }
                for ( int w = 0; w < nact_w; w++ ){
@@ -1633,8 +1741,8 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
                   int inc1 = 1;
                   daxpy_( &total_size, &f_kw, FFG_triplet[ IL ][ IR ][ w ], &inc1, workspace, &inc1 );
                }
-               const int ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_F_TRIPLET ];
-               const int ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_G_TRIPLET ] + SIZE_R * ( shift_G + ik );
+               const long long ptr_L = jump[ IL + num_irreps * CHEMPS2_CASPT2_F_TRIPLET ];
+               const long long ptr_R = jump[ IR + num_irreps * CHEMPS2_CASPT2_G_TRIPLET ] + SIZE_R * ( shift_G + ik );
                const int LDA_R = SIZE_R * nocc_w;
                matmat( 'N', SIZE_L, size_ab, SIZE_R, 2.0, workspace, SIZE_L, vector + ptr_R, LDA_R,  result + ptr_L, SIZE_L );
                matmat( 'T', SIZE_R, size_ab, SIZE_L, 2.0, workspace, SIZE_L, vector + ptr_L, SIZE_L, result + ptr_R, LDA_R  );
@@ -1645,6 +1753,7 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
 
    // FEH singlet: < SE_xkdl E_wc SH_aibj > = 2 delta_ik delta_jl ( delta_ac delta_bd + delta_ad delta_bc ) / sqrt( 1 + delta_ab ) FEH[ Ix ][ w ][ x ]
    for ( int IL = 0; IL < num_irreps; IL++ ){ // IL == Ixw == Ic == Iik x Ijl x Id
+      prefetch_block( vector, result, IL + 1, CHEMPS2_CASPT2_E_SINGLET );
       int SIZE = size_E[ IL ];
       const int nocc_w = indices->getNOCC( IL );
       const int nact_w = indices->getNDMRG( IL );
@@ -1671,13 +1780,13 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
                   for ( int Ii = 0; Ii < num_irreps; Ii++ ){
                      const int Ij = Irreps::directProd( Ii, Icenter );
                      if ( Ii < Ij ){
-                        const int jump_E = jump[ IL + num_irreps * CHEMPS2_CASPT2_E_SINGLET ] + SIZE * shift_E_nonactive( indices, Id, Ii, Ij, +1 );
-                        const int jump_H = jump[ Icenter + num_irreps * CHEMPS2_CASPT2_H_SINGLET ] + shift_H_nonactive( indices, Ii, Ij, IL, Id, +1 );
+                        const long long jump_E = jump[ IL + num_irreps * CHEMPS2_CASPT2_E_SINGLET ] + SIZE * shift_E_nonactive( indices, Id, Ii, Ij, +1 );
+                        const long long jump_H = jump[ Icenter + num_irreps * CHEMPS2_CASPT2_H_SINGLET ] + shift_H_nonactive( indices, Ii, Ij, IL, Id, +1 );
                         const int size_ij = indices->getNOCC( Ii ) * indices->getNOCC( Ij );
                         #pragma omp parallel for schedule(static)
                         for ( int d = 0; d < nvir_d; d++ ){
-                           const int ptr_H = jump_H + size_ij * ( c + nvir_w * d );
-                           const int ptr_E = jump_E + SIZE * d;
+                           const long long ptr_H = jump_H + size_ij * ( c + nvir_w * d );
+                           const long long ptr_E = jump_E + SIZE * d;
                            matmat( 'N', SIZE, size_ij, 1,    2.0, workspace, SIZE, vector + ptr_H, 1,     result + ptr_E, LDA_E );
                            matmat( 'T', 1,    size_ij, SIZE, 2.0, workspace, SIZE, vector + ptr_E, LDA_E, result + ptr_H, 1     );
                         }
@@ -1687,20 +1796,20 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
 
                if ( IL == Id ){ // Ic == Id == Ia == Ib --> Iik == Ijl
                   for ( int Iij = 0; Iij < num_irreps; Iij++ ){
-                     const int jump_E = jump[ IL + num_irreps * CHEMPS2_CASPT2_E_SINGLET ] + SIZE * shift_E_nonactive( indices, Id,  Iij, Iij, +1 );
-                     const int jump_H = jump[ Icenter + num_irreps * CHEMPS2_CASPT2_H_SINGLET ] + shift_H_nonactive( indices, Iij, Iij, IL,  Id, +1 );
+                     const long long jump_E = jump[ IL + num_irreps * CHEMPS2_CASPT2_E_SINGLET ] + SIZE * shift_E_nonactive( indices, Id,  Iij, Iij, +1 );
+                     const long long jump_H = jump[ Icenter + num_irreps * CHEMPS2_CASPT2_H_SINGLET ] + shift_H_nonactive( indices, Iij, Iij, IL,  Id, +1 );
                      const int size_ij = ( indices->getNOCC( Iij ) * ( indices->getNOCC( Iij ) + 1 ) ) / 2;
                      #pragma omp parallel for schedule(static)
                      for ( int d = 0; d < c; d++ ){
-                        const int ptr_H = jump_H + size_ij * ( d + ( c * ( c + 1 ) ) / 2 );
-                        const int ptr_E = jump_E + SIZE * d;
+                        const long long ptr_H = jump_H + size_ij * ( d + ( c * ( c + 1 ) ) / 2 );
+                        const long long ptr_E = jump_E + SIZE * d;
                         matmat( 'N', SIZE, size_ij, 1,    2.0, workspace, SIZE, vector + ptr_H, 1,     result + ptr_E, LDA_E );
                         matmat( 'T', 1,    size_ij, SIZE, 2.0, workspace, SIZE, vector + ptr_E, LDA_E, result + ptr_H, 1     );
                      }
                      #pragma omp parallel for schedule(static)
                      for ( int d = c; d < nvir_d; d++ ){
-                        const int ptr_H = jump_H + size_ij * ( c + ( d * ( d + 1 ) ) / 2 );
-                        const int ptr_E = jump_E + SIZE * d;
+                        const long long ptr_H = jump_H + size_ij * ( c + ( d * ( d + 1 ) ) / 2 );
+                        const long long ptr_E = jump_E + SIZE * d;
                         const double factor = 2 * (( c == d ) ? SQRT2 : 1.0 );
                         matmat( 'N', SIZE, size_ij, 1,    factor, workspace, SIZE, vector + ptr_H, 1,     result + ptr_E, LDA_E );
                         matmat( 'T', 1,    size_ij, SIZE, factor, workspace, SIZE, vector + ptr_E, LDA_E, result + ptr_H, 1     );
@@ -1712,13 +1821,13 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
                   for ( int Ii = 0; Ii < num_irreps; Ii++ ){
                      const int Ij = Irreps::directProd( Ii, Icenter );
                      if ( Ii < Ij ){
-                        const int jump_E = jump[ IL + num_irreps * CHEMPS2_CASPT2_E_SINGLET ] + SIZE * shift_E_nonactive( indices, Id, Ii, Ij, +1 );
-                        const int jump_H = jump[ Icenter + num_irreps * CHEMPS2_CASPT2_H_SINGLET ] + shift_H_nonactive( indices, Ii, Ij, Id, IL, +1 );
+                        const long long jump_E = jump[ IL + num_irreps * CHEMPS2_CASPT2_E_SINGLET ] + SIZE * shift_E_nonactive( indices, Id, Ii, Ij, +1 );
+                        const long long jump_H = jump[ Icenter + num_irreps * CHEMPS2_CASPT2_H_SINGLET ] + shift_H_nonactive( indices, Ii, Ij, Id, IL, +1 );
                         const int size_ij = indices->getNOCC( Ii ) * indices->getNOCC( Ij );
                         #pragma omp parallel for schedule(static)
                         for ( int d = 0; d < nvir_d; d++ ){
-                           const int ptr_H = jump_H + size_ij * ( d + nvir_d * c );
-                           const int ptr_E = jump_E + SIZE * d;
+                           const long long ptr_H = jump_H + size_ij * ( d + nvir_d * c );
+                           const long long ptr_E = jump_E + SIZE * d;
                            matmat( 'N', SIZE, size_ij, 1,    2.0, workspace, SIZE, vector + ptr_H, 1,     result + ptr_E, LDA_E );
                            matmat( 'T', 1,    size_ij, SIZE, 2.0, workspace, SIZE, vector + ptr_E, LDA_E, result + ptr_H, 1     );
                         }
@@ -1732,6 +1841,7 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
 
    // FEH triplet: < TE_xkdl E_wc TH_aibj > = 6 delta_ik delta_jl ( delta_ac delta_bd - delta_ad delta_bc ) / sqrt( 1 + delta_ab ) FEH[ Ix ][ w ][ x ]
    for ( int IL = 0; IL < num_irreps; IL++ ){ // IL == Ixw == Ic == Iik x Ijl x Id
+      prefetch_block( vector, result, IL + 1, CHEMPS2_CASPT2_E_TRIPLET );
       int SIZE = size_E[ IL ];
       const int nocc_w = indices->getNOCC( IL );
       const int nact_w = indices->getNDMRG( IL );
@@ -1758,13 +1868,13 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
                   for ( int Ii = 0; Ii < num_irreps; Ii++ ){
                      const int Ij = Irreps::directProd( Ii, Icenter );
                      if ( Ii < Ij ){
-                        const int jump_E = jump[ IL + num_irreps * CHEMPS2_CASPT2_E_TRIPLET ] + SIZE * shift_E_nonactive( indices, Id, Ii, Ij, -1 );
-                        const int jump_H = jump[ Icenter + num_irreps * CHEMPS2_CASPT2_H_TRIPLET ] + shift_H_nonactive( indices, Ii, Ij, IL, Id, -1 );
+                        const long long jump_E = jump[ IL + num_irreps * CHEMPS2_CASPT2_E_TRIPLET ] + SIZE * shift_E_nonactive( indices, Id, Ii, Ij, -1 );
+                        const long long jump_H = jump[ Icenter + num_irreps * CHEMPS2_CASPT2_H_TRIPLET ] + shift_H_nonactive( indices, Ii, Ij, IL, Id, -1 );
                         const int size_ij = indices->getNOCC( Ii ) * indices->getNOCC( Ij );
                         #pragma omp parallel for schedule(static)
                         for ( int d = 0; d < nvir_d; d++ ){
-                           const int ptr_H = jump_H + size_ij * ( c + nvir_w * d );
-                           const int ptr_E = jump_E + SIZE * d;
+                           const long long ptr_H = jump_H + size_ij * ( c + nvir_w * d );
+                           const long long ptr_E = jump_E + SIZE * d;
                            matmat( 'N', SIZE, size_ij, 1,    6.0, workspace, SIZE, vector + ptr_H, 1,     result + ptr_E, LDA_E );
                            matmat( 'T', 1,    size_ij, SIZE, 6.0, workspace, SIZE, vector + ptr_E, LDA_E, result + ptr_H, 1     );
                         }
@@ -1774,20 +1884,20 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
 
                if ( IL == Id ){ // Ic == Id == Ia == Ib --> Iik == Ijl
                   for ( int Iij = 0; Iij < num_irreps; Iij++ ){
-                     const int jump_E = jump[ IL + num_irreps * CHEMPS2_CASPT2_E_TRIPLET ] + SIZE * shift_E_nonactive( indices, Id,  Iij, Iij, -1 );
-                     const int jump_H = jump[ Icenter + num_irreps * CHEMPS2_CASPT2_H_TRIPLET ] + shift_H_nonactive( indices, Iij, Iij, IL,  Id, -1 );
+                     const long long jump_E = jump[ IL + num_irreps * CHEMPS2_CASPT2_E_TRIPLET ] + SIZE * shift_E_nonactive( indices, Id,  Iij, Iij, -1 );
+                     const long long jump_H = jump[ Icenter + num_irreps * CHEMPS2_CASPT2_H_TRIPLET ] + shift_H_nonactive( indices, Iij, Iij, IL,  Id, -1 );
                      const int size_ij = ( indices->getNOCC( Iij ) * ( indices->getNOCC( Iij ) - 1 ) ) / 2;
                      #pragma omp parallel for schedule(static)
                      for ( int d = 0; d < c; d++ ){
-                        const int ptr_H = jump_H + size_ij * ( d + ( c * ( c - 1 ) ) / 2 );
-                        const int ptr_E = jump_E + SIZE * d;
+                        const long long ptr_H = jump_H + size_ij * ( d + ( c * ( c - 1 ) ) / 2 );
+                        const long long ptr_E = jump_E + SIZE * d;
                         matmat( 'N', SIZE, size_ij, 1,    -6.0, workspace, SIZE, vector + ptr_H, 1,     result + ptr_E, LDA_E );
                         matmat( 'T', 1,    size_ij, SIZE, -6.0, workspace, SIZE, vector + ptr_E, LDA_E, result + ptr_H, 1     );
                      }
                      #pragma omp parallel for schedule(static)
                      for ( int d = c+1; d < nvir_d; d++ ){
-                        const int ptr_H = jump_H + size_ij * ( c + ( d * ( d - 1 ) ) / 2 );
-                        const int ptr_E = jump_E + SIZE * d;
+                        const long long ptr_H = jump_H + size_ij * ( c + ( d * ( d - 1 ) ) / 2 );
+                        const long long ptr_E = jump_E + SIZE * d;
                         matmat( 'N', SIZE, size_ij, 1,    6.0, workspace, SIZE, vector + ptr_H, 1,     result + ptr_E, LDA_E );
                         matmat( 'T', 1,    size_ij, SIZE, 6.0, workspace, SIZE, vector + ptr_E, LDA_E, result + ptr_H, 1     );
                      }
@@ -1798,13 +1908,13 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
                   for ( int Ii = 0; Ii < num_irreps; Ii++ ){
                      const int Ij = Irreps::directProd( Ii, Icenter );
                      if ( Ii < Ij ){
-                        const int jump_E = jump[ IL + num_irreps * CHEMPS2_CASPT2_E_TRIPLET ] + SIZE * shift_E_nonactive( indices, Id, Ii, Ij, -1 );
-                        const int jump_H = jump[ Icenter + num_irreps * CHEMPS2_CASPT2_H_TRIPLET ] + shift_H_nonactive( indices, Ii, Ij, Id, IL, -1 );
+                        const long long jump_E = jump[ IL + num_irreps * CHEMPS2_CASPT2_E_TRIPLET ] + SIZE * shift_E_nonactive( indices, Id, Ii, Ij, -1 );
+                        const long long jump_H = jump[ Icenter + num_irreps * CHEMPS2_CASPT2_H_TRIPLET ] + shift_H_nonactive( indices, Ii, Ij, Id, IL, -1 );
                         const int size_ij = indices->getNOCC( Ii ) * indices->getNOCC( Ij );
                         #pragma omp parallel for schedule(static)
                         for ( int d = 0; d < nvir_d; d++ ){
-                           const int ptr_H = jump_H + size_ij * ( d + nvir_d * c );
-                           const int ptr_E = jump_E + SIZE * d;
+                           const long long ptr_H = jump_H + size_ij * ( d + nvir_d * c );
+                           const long long ptr_E = jump_E + SIZE * d;
                            matmat( 'N', SIZE, size_ij, 1,    -6.0, workspace, SIZE, vector + ptr_H, 1,     result + ptr_E, LDA_E );
                            matmat( 'T', 1,    size_ij, SIZE, -6.0, workspace, SIZE, vector + ptr_E, LDA_E, result + ptr_H, 1     );
                         }
@@ -1818,6 +1928,7 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
 
    // FGH singlet: < SG_cldx E_kw SH_aibj > = 2 delta_ac delta_bd ( delta_il delta_jk + delta_ik delta_jl ) / sqrt( 1 + delta_ij ) FGH[ Ix ][ w ][ x ]
    for ( int IL = 0; IL < num_irreps; IL++ ){ // IL == Ixw == Ik == Iac x Ibd x Il
+      prefetch_block( vector, result, IL + 1, CHEMPS2_CASPT2_G_SINGLET );
       int SIZE = size_G[ IL ];
       const int nocc_w = indices->getNOCC( IL );
       const int nact_w = indices->getNDMRG( IL );
@@ -1843,8 +1954,8 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
                      if ( Ia < Ib ){
                         const int colsize = nocc_l * indices->getNVIRT( Ia ) * indices->getNVIRT( Ib );
                         if ( colsize > 0 ){
-                           const int jump_G = jump[ IL + num_irreps * CHEMPS2_CASPT2_G_SINGLET ] + SIZE * shift_G_nonactive( indices, Il, Ia, Ib, +1 );
-                           const int jump_H = jump[ Icenter + num_irreps * CHEMPS2_CASPT2_H_SINGLET ] + shift_H_nonactive( indices, IL, Il, Ia, Ib, +1 ) + k;
+                           const long long jump_G = jump[ IL + num_irreps * CHEMPS2_CASPT2_G_SINGLET ] + SIZE * shift_G_nonactive( indices, Il, Ia, Ib, +1 );
+                           const long long jump_H = jump[ Icenter + num_irreps * CHEMPS2_CASPT2_H_SINGLET ] + shift_H_nonactive( indices, IL, Il, Ia, Ib, +1 ) + k;
                            matmat( 'N', SIZE, colsize, 1,    2.0, workspace, SIZE, vector + jump_H, nocc_w, result + jump_G, SIZE   );
                            matmat( 'T', 1,    colsize, SIZE, 2.0, workspace, SIZE, vector + jump_G, SIZE,   result + jump_H, nocc_w );
                         }
@@ -1854,22 +1965,22 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
 
                if ( IL == Il ){ // Ik == Il == Ii == Ij --> Iac == Ibd   and   nocc_l == nocc_w
                   for ( int Iab = 0; Iab < num_irreps; Iab++ ){
-                     const int jump_G = jump[ IL + num_irreps * CHEMPS2_CASPT2_G_SINGLET ] + SIZE * shift_G_nonactive( indices, Il, Iab, Iab, +1 );
-                     const int jump_H = jump[ Icenter + num_irreps * CHEMPS2_CASPT2_H_SINGLET ] + shift_H_nonactive( indices, IL, Il, Iab, Iab, +1 );
+                     const long long jump_G = jump[ IL + num_irreps * CHEMPS2_CASPT2_G_SINGLET ] + SIZE * shift_G_nonactive( indices, Il, Iab, Iab, +1 );
+                     const long long jump_H = jump[ Icenter + num_irreps * CHEMPS2_CASPT2_H_SINGLET ] + shift_H_nonactive( indices, IL, Il, Iab, Iab, +1 );
                      const int size_ij = ( nocc_w * ( nocc_w + 1 ) ) / 2;
                      const int size_ab = ( indices->getNVIRT( Iab ) * ( indices->getNVIRT( Iab ) + 1 ) ) / 2;
                      const int LDA_G = SIZE * nocc_l;
                      #pragma omp parallel for schedule(static)
                      for ( int l = 0; l < k; l++ ){
-                        const int ptr_H = jump_H + ( l + ( k * ( k + 1 ) ) / 2 );
-                        const int ptr_G = jump_G + SIZE * l;
+                        const long long ptr_H = jump_H + ( l + ( k * ( k + 1 ) ) / 2 );
+                        const long long ptr_G = jump_G + SIZE * l;
                         matmat( 'N', SIZE, size_ab, 1,    2.0, workspace, SIZE, vector + ptr_H, size_ij, result + ptr_G, LDA_G   );
                         matmat( 'T', 1,    size_ab, SIZE, 2.0, workspace, SIZE, vector + ptr_G, LDA_G,   result + ptr_H, size_ij );
                      }
                      #pragma omp parallel for schedule(static)
                      for ( int l = k; l < nocc_l; l++ ){
-                        const int ptr_H = jump_H + ( k + ( l * ( l + 1 ) ) / 2 );
-                        const int ptr_G = jump_G + SIZE * l;
+                        const long long ptr_H = jump_H + ( k + ( l * ( l + 1 ) ) / 2 );
+                        const long long ptr_G = jump_G + SIZE * l;
                         const double factor = 2 * (( k == l ) ? SQRT2 : 1.0 );
                         matmat( 'N', SIZE, size_ab, 1,    factor, workspace, SIZE, vector + ptr_H, size_ij, result + ptr_G, LDA_G   );
                         matmat( 'T', 1,    size_ab, SIZE, factor, workspace, SIZE, vector + ptr_G, LDA_G,   result + ptr_H, size_ij );
@@ -1881,13 +1992,13 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
                   for ( int Ia = 0; Ia < num_irreps; Ia++ ){
                      const int Ib = Irreps::directProd( Ia, Icenter );
                      if ( Ia < Ib ){
-                        const int jump_G = jump[ IL + num_irreps * CHEMPS2_CASPT2_G_SINGLET ] + SIZE * shift_G_nonactive( indices, Il, Ia, Ib, +1 );
-                        const int jump_H = jump[ Icenter + num_irreps * CHEMPS2_CASPT2_H_SINGLET ] + shift_H_nonactive( indices, Il, IL, Ia, Ib, +1 );
+                        const long long jump_G = jump[ IL + num_irreps * CHEMPS2_CASPT2_G_SINGLET ] + SIZE * shift_G_nonactive( indices, Il, Ia, Ib, +1 );
+                        const long long jump_H = jump[ Icenter + num_irreps * CHEMPS2_CASPT2_H_SINGLET ] + shift_H_nonactive( indices, Il, IL, Ia, Ib, +1 );
                         const int size_ab = indices->getNVIRT( Ia ) * indices->getNVIRT( Ib );
                         #pragma omp parallel for schedule(static)
                         for ( int ab = 0; ab < size_ab; ab++ ){
-                           const int ptr_H = jump_H + nocc_l * ( k + nocc_w * ab );
-                           const int ptr_G = jump_G + SIZE * nocc_l * ab;
+                           const long long ptr_H = jump_H + nocc_l * ( k + nocc_w * ab );
+                           const long long ptr_G = jump_G + SIZE * nocc_l * ab;
                            matmat( 'N', SIZE, nocc_l, 1,    2.0, workspace, SIZE, vector + ptr_H, 1,    result + ptr_G, SIZE );
                            matmat( 'T', 1,    nocc_l, SIZE, 2.0, workspace, SIZE, vector + ptr_G, SIZE, result + ptr_H, 1    );
                         }
@@ -1901,6 +2012,7 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
 
    // FGH triplet: < TG_cldx E_kw TH_aibj > = 6 delta_ac delta_bd ( delta_il delta_jk - delta_ik delta_jl ) / sqrt( 1 + delta_ij ) FGH[ Ix ][ w ][ x ]
    for ( int IL = 0; IL < num_irreps; IL++ ){ // IL == Ixw == Ik == Iac x Ibd x Il
+      prefetch_block( vector, result, IL + 1, CHEMPS2_CASPT2_G_TRIPLET );
       int SIZE = size_G[ IL ];
       const int nocc_w = indices->getNOCC( IL );
       const int nact_w = indices->getNDMRG( IL );
@@ -1926,8 +2038,8 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
                      if ( Ia < Ib ){
                         const int colsize = nocc_l * indices->getNVIRT( Ia ) * indices->getNVIRT( Ib );
                         if ( colsize > 0 ){
-                           const int jump_G = jump[ IL + num_irreps * CHEMPS2_CASPT2_G_TRIPLET ] + SIZE * shift_G_nonactive( indices, Il, Ia, Ib, -1 );
-                           const int jump_H = jump[ Icenter + num_irreps * CHEMPS2_CASPT2_H_TRIPLET ] + shift_H_nonactive( indices, IL, Il, Ia, Ib, -1 ) + k;
+                           const long long jump_G = jump[ IL + num_irreps * CHEMPS2_CASPT2_G_TRIPLET ] + SIZE * shift_G_nonactive( indices, Il, Ia, Ib, -1 );
+                           const long long jump_H = jump[ Icenter + num_irreps * CHEMPS2_CASPT2_H_TRIPLET ] + shift_H_nonactive( indices, IL, Il, Ia, Ib, -1 ) + k;
                            matmat( 'N', SIZE, colsize, 1,    -6.0, workspace, SIZE, vector + jump_H, nocc_w, result + jump_G, SIZE   );
                            matmat( 'T', 1,    colsize, SIZE, -6.0, workspace, SIZE, vector + jump_G, SIZE,   result + jump_H, nocc_w );
                         }
@@ -1937,22 +2049,22 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
 
                if ( IL == Il ){ // Ik == Il == Ii == Ij --> Iac == Ibd   and   nocc_l == nocc_w
                   for ( int Iab = 0; Iab < num_irreps; Iab++ ){
-                     const int jump_G = jump[ IL + num_irreps * CHEMPS2_CASPT2_G_TRIPLET ] + SIZE * shift_G_nonactive( indices, Il, Iab, Iab, -1 );
-                     const int jump_H = jump[ Icenter + num_irreps * CHEMPS2_CASPT2_H_TRIPLET ] + shift_H_nonactive( indices, IL, Il, Iab, Iab, -1 );
+                     const long long jump_G = jump[ IL + num_irreps * CHEMPS2_CASPT2_G_TRIPLET ] + SIZE * shift_G_nonactive( indices, Il, Iab, Iab, -1 );
+                     const long long jump_H = jump[ Icenter + num_irreps * CHEMPS2_CASPT2_H_TRIPLET ] + shift_H_nonactive( indices, IL, Il, Iab, Iab, -1 );
                      const int size_ij = ( nocc_w * ( nocc_w - 1 ) ) / 2;
                      const int size_ab = ( indices->getNVIRT( Iab ) * ( indices->getNVIRT( Iab ) - 1 ) ) / 2;
                      const int LDA_G = SIZE * nocc_l;
                      #pragma omp parallel for schedule(static)
                      for ( int l = 0; l < k; l++ ){
-                        const int ptr_H = jump_H + ( l + ( k * ( k - 1 ) ) / 2 );
-                        const int ptr_G = jump_G + SIZE * l;
+                        const long long ptr_H = jump_H + ( l + ( k * ( k - 1 ) ) / 2 );
+                        const long long ptr_G = jump_G + SIZE * l;
                         matmat( 'N', SIZE, size_ab, 1,    6.0, workspace, SIZE, vector + ptr_H, size_ij, result + ptr_G, LDA_G   );
                         matmat( 'T', 1,    size_ab, SIZE, 6.0, workspace, SIZE, vector + ptr_G, LDA_G,   result + ptr_H, size_ij );
                      }
                      #pragma omp parallel for schedule(static)
                      for ( int l = k+1; l < nocc_l; l++ ){
-                        const int ptr_H = jump_H + ( k + ( l * ( l - 1 ) ) / 2 );
-                        const int ptr_G = jump_G + SIZE * l;
+                        const long long ptr_H = jump_H + ( k + ( l * ( l - 1 ) ) / 2 );
+                        const long long ptr_G = jump_G + SIZE * l;
                         matmat( 'N', SIZE, size_ab, 1,    -6.0, workspace, SIZE, vector + ptr_H, size_ij, result + ptr_G, LDA_G   );
                         matmat( 'T', 1,    size_ab, SIZE, -6.0, workspace, SIZE, vector + ptr_G, LDA_G,   result + ptr_H, size_ij );
                      }
@@ -1963,13 +2075,13 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
                   for ( int Ia = 0; Ia < num_irreps; Ia++ ){
                      const int Ib = Irreps::directProd( Ia, Icenter );
                      if ( Ia < Ib ){
-                        const int jump_G = jump[ IL + num_irreps * CHEMPS2_CASPT2_G_TRIPLET ] + SIZE * shift_G_nonactive( indices, Il, Ia, Ib, -1 );
-                        const int jump_H = jump[ Icenter + num_irreps * CHEMPS2_CASPT2_H_TRIPLET ] + shift_H_nonactive( indices, Il, IL, Ia, Ib, -1 );
+                        const long long jump_G = jump[ IL + num_irreps * CHEMPS2_CASPT2_G_TRIPLET ] + SIZE * shift_G_nonactive( indices, Il, Ia, Ib, -1 );
+                        const long long jump_H = jump[ Icenter + num_irreps * CHEMPS2_CASPT2_H_TRIPLET ] + shift_H_nonactive( indices, Il, IL, Ia, Ib, -1 );
                         const int size_ab = indices->getNVIRT( Ia ) * indices->getNVIRT( Ib );
                         #pragma omp parallel for schedule(static)
                         for ( int ab = 0; ab < size_ab; ab++ ){
-                           const int ptr_H = jump_H + nocc_l * ( k + nocc_w * ab );
-                           const int ptr_G = jump_G + SIZE * nocc_l * ab;
+                           const long long ptr_H = jump_H + nocc_l * ( k + nocc_w * ab );
+                           const long long ptr_G = jump_G + SIZE * nocc_l * ab;
                            matmat( 'N', SIZE, nocc_l, 1,    6.0, workspace, SIZE, vector + ptr_H, 1,    result + ptr_G, SIZE );
                            matmat( 'T', 1,    nocc_l, SIZE, 6.0, workspace, SIZE, vector + ptr_G, SIZE, result + ptr_H, 1    );
                         }
@@ -1985,6 +2097,7 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
    for ( int IL = 0; IL < num_irreps; IL++ ){ // IL == Ix x Iy == Ib x Il
       const int SIZE_L = size_D[ IL ];
       for ( int IR = 0; IR < num_irreps; IR++ ){ // IR = It = Ia x Ii x Ij
+         prefetch_block( vector, result, IR + 1, CHEMPS2_CASPT2_E_SINGLET );
          const int SIZE_R = size_E[ IR ];
          const int Ikw = Irreps::directProd( IL, IR ); // Ikw == Ik == Iw
          const int nocc_kw = indices->getNOCC( Ikw );
@@ -2003,15 +2116,15 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
                   const int Il = Irreps::directProd( Iab, IL );
                   const int nocc_l = indices->getNOCC( Il );
                   if ( nvir_ab * nocc_l > 0 ){
-                     const int jump_D = jump[ IL + num_irreps * CHEMPS2_CASPT2_D         ] + SIZE_L * shift_D_nonactive( indices, Il, Iab );
-                     const int jump_E = jump[ IR + num_irreps * CHEMPS2_CASPT2_E_SINGLET ] + SIZE_R * (( Ikw <= Il ) ? shift_E_nonactive( indices, Iab, Ikw, Il,  +1 )
+                     const long long jump_D = jump[ IL + num_irreps * CHEMPS2_CASPT2_D         ] + SIZE_L * shift_D_nonactive( indices, Il, Iab );
+                     const long long jump_E = jump[ IR + num_irreps * CHEMPS2_CASPT2_E_SINGLET ] + SIZE_R * (( Ikw <= Il ) ? shift_E_nonactive( indices, Iab, Ikw, Il,  +1 )
                                                                                                                      : shift_E_nonactive( indices, Iab, Il,  Ikw, +1 ));
                      if ( Ikw == Il ){ // irrep_k == irrep_l
                         #pragma omp parallel for schedule(static)
                         for ( int l = 0; l < nocc_l; l++ ){
                            const double factor = (( k == l ) ? SQRT2 : 1.0 );
-                           const int ptr_L = jump_D + SIZE_L * l;
-                           const int ptr_R = jump_E + SIZE_R * nvir_ab * (( k < l ) ? ( k + ( l * ( l + 1 ) ) / 2 ) : ( l + ( k * ( k + 1 ) ) / 2 ));
+                           const long long ptr_L = jump_D + SIZE_L * l;
+                           const long long ptr_R = jump_E + SIZE_R * nvir_ab * (( k < l ) ? ( k + ( l * ( l + 1 ) ) / 2 ) : ( l + ( k * ( k + 1 ) ) / 2 ));
                            const int LDA_L = SIZE_L * nocc_l;
                            matmat( 'N', SIZE_L, nvir_ab, SIZE_R, factor, workspace, SIZE_L, vector + ptr_R, SIZE_R, result + ptr_L, LDA_L  );
                            matmat( 'T', SIZE_R, nvir_ab, SIZE_L, factor, workspace, SIZE_L, vector + ptr_L, LDA_L,  result + ptr_R, SIZE_R );
@@ -2019,8 +2132,8 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
                      } else { // irrep_k != irrep_l
                         #pragma omp parallel for schedule(static)
                         for ( int l = 0; l < nocc_l; l++ ){
-                           const int ptr_L = jump_D + SIZE_L * l;
-                           const int ptr_R = jump_E + SIZE_R * nvir_ab * (( Ikw < Il ) ? ( k + nocc_kw * l ) : ( l + nocc_l * k ));
+                           const long long ptr_L = jump_D + SIZE_L * l;
+                           const long long ptr_R = jump_E + SIZE_R * nvir_ab * (( Ikw < Il ) ? ( k + nocc_kw * l ) : ( l + nocc_l * k ));
                            const int LDA_L = SIZE_L * nocc_l;
                            matmat( 'N', SIZE_L, nvir_ab, SIZE_R, 1.0, workspace, SIZE_L, vector + ptr_R, SIZE_R, result + ptr_L, LDA_L  );
                            matmat( 'T', SIZE_R, nvir_ab, SIZE_L, 1.0, workspace, SIZE_L, vector + ptr_L, LDA_L,  result + ptr_R, SIZE_R );
@@ -2037,6 +2150,7 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
    for ( int IL = 0; IL < num_irreps; IL++ ){ // IL == Ix x Iy == Ib x Il
       const int SIZE_L = size_D[ IL ];
       for ( int IR = 0; IR < num_irreps; IR++ ){ // IR = It = Ia x Ii x Ij
+         prefetch_block( vector, result, IR + 1, CHEMPS2_CASPT2_E_TRIPLET );
          const int SIZE_R = size_E[ IR ];
          const int Ikw = Irreps::directProd( IL, IR ); // Ikw == Ik == Iw
          const int nocc_kw = indices->getNOCC( Ikw );
@@ -2055,22 +2169,22 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
                   const int Il = Irreps::directProd( Iab, IL );
                   const int nocc_l = indices->getNOCC( Il );
                   if ( nvir_ab * nocc_l > 0 ){
-                     const int jump_D = jump[ IL + num_irreps * CHEMPS2_CASPT2_D         ] + SIZE_L * shift_D_nonactive( indices, Il, Iab );
-                     const int jump_E = jump[ IR + num_irreps * CHEMPS2_CASPT2_E_TRIPLET ] + SIZE_R * (( Ikw <= Il ) ? shift_E_nonactive( indices, Iab, Ikw, Il,  -1 )
+                     const long long jump_D = jump[ IL + num_irreps * CHEMPS2_CASPT2_D         ] + SIZE_L * shift_D_nonactive( indices, Il, Iab );
+                     const long long jump_E = jump[ IR + num_irreps * CHEMPS2_CASPT2_E_TRIPLET ] + SIZE_R * (( Ikw <= Il ) ? shift_E_nonactive( indices, Iab, Ikw, Il,  -1 )
                                                                                                                      : shift_E_nonactive( indices, Iab, Il,  Ikw, -1 ));
                      if ( Ikw == Il ){ // irrep_k == irrep_l
                         #pragma omp parallel for schedule(static)
                         for ( int l = 0; l < k; l++ ){
-                           const int ptr_L = jump_D + SIZE_L * l;
-                           const int ptr_R = jump_E + SIZE_R * nvir_ab * ( l + ( k * ( k - 1 ) ) / 2 );
+                           const long long ptr_L = jump_D + SIZE_L * l;
+                           const long long ptr_R = jump_E + SIZE_R * nvir_ab * ( l + ( k * ( k - 1 ) ) / 2 );
                            const int LDA_L = SIZE_L * nocc_l;
                            matmat( 'N', SIZE_L, nvir_ab, SIZE_R, -3.0, workspace, SIZE_L, vector + ptr_R, SIZE_R, result + ptr_L, LDA_L  );
                            matmat( 'T', SIZE_R, nvir_ab, SIZE_L, -3.0, workspace, SIZE_L, vector + ptr_L, LDA_L,  result + ptr_R, SIZE_R );
                         }
                         #pragma omp parallel for schedule(static)
                         for ( int l = k+1; l < nocc_l; l++ ){
-                           const int ptr_L = jump_D + SIZE_L * l;
-                           const int ptr_R = jump_E + SIZE_R * nvir_ab * ( k + ( l * ( l - 1 ) ) / 2 );
+                           const long long ptr_L = jump_D + SIZE_L * l;
+                           const long long ptr_R = jump_E + SIZE_R * nvir_ab * ( k + ( l * ( l - 1 ) ) / 2 );
                            const int LDA_L = SIZE_L * nocc_l;
                            matmat( 'N', SIZE_L, nvir_ab, SIZE_R, 3.0, workspace, SIZE_L, vector + ptr_R, SIZE_R, result + ptr_L, LDA_L  );
                            matmat( 'T', SIZE_R, nvir_ab, SIZE_L, 3.0, workspace, SIZE_L, vector + ptr_L, LDA_L,  result + ptr_R, SIZE_R );
@@ -2079,8 +2193,8 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
                         #pragma omp parallel for schedule(static)
                         for ( int l = 0; l < nocc_l; l++ ){
                            const double factor = (( Ikw < Il ) ? 3.0 : -3.0 );
-                           const int ptr_L = jump_D + SIZE_L * l;
-                           const int ptr_R = jump_E + SIZE_R * nvir_ab * (( Ikw < Il ) ? ( k + nocc_kw * l ) : ( l + nocc_l * k ));
+                           const long long ptr_L = jump_D + SIZE_L * l;
+                           const long long ptr_R = jump_E + SIZE_R * nvir_ab * (( Ikw < Il ) ? ( k + nocc_kw * l ) : ( l + nocc_l * k ));
                            const int LDA_L = SIZE_L * nocc_l;
                            matmat( 'N', SIZE_L, nvir_ab, SIZE_R, factor, workspace, SIZE_L, vector + ptr_R, SIZE_R, result + ptr_L, LDA_L  );
                            matmat( 'T', SIZE_R, nvir_ab, SIZE_L, factor, workspace, SIZE_L, vector + ptr_L, LDA_L,  result + ptr_R, SIZE_R );
@@ -2097,6 +2211,7 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
    for ( int IL = 0; IL < num_irreps; IL++ ){ // IL == Ix x Iy == Id x Ij
       const int SIZE_L = size_D[ IL ];
       for ( int IR = 0; IR < num_irreps; IR++ ){ // IR = It = Ia x Ib x Ii
+         prefetch_block( vector, result, IR + 1, CHEMPS2_CASPT2_G_SINGLET );
          const int SIZE_R = size_E[ IR ];
          const int Iwc = Irreps::directProd( IL, IR ); // Iwc == Ic == Iw
          const int nocc_wc = indices->getNOCC( Iwc );
@@ -2117,21 +2232,21 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
                   const int Id = Irreps::directProd( Iij, IL );
                   const int nvir_d = indices->getNVIRT( Id );
                   if ( nvir_d * nocc_ij > 0 ){
-                     const int jump_D = jump[ IL + num_irreps * CHEMPS2_CASPT2_D ] + SIZE_L * shift_D_nonactive( indices, Iij, Id );
-                     const int jump_G = jump[ IR + num_irreps * CHEMPS2_CASPT2_G_SINGLET ] + SIZE_R * (( Iwc <= Id ) ? shift_G_nonactive( indices, Iij, Iwc, Id,  +1 )
+                     const long long jump_D = jump[ IL + num_irreps * CHEMPS2_CASPT2_D ] + SIZE_L * shift_D_nonactive( indices, Iij, Id );
+                     const long long jump_G = jump[ IR + num_irreps * CHEMPS2_CASPT2_G_SINGLET ] + SIZE_R * (( Iwc <= Id ) ? shift_G_nonactive( indices, Iij, Iwc, Id,  +1 )
                                                                                                                      : shift_G_nonactive( indices, Iij, Id,  Iwc, +1 ));
                      if ( Iwc == Id ){ // irrep_c == irrep_d
                         if ( c > 0 ){
-                           const int ptr_L = jump_D;
-                           const int ptr_R = jump_G + SIZE_R * nocc_ij * ( c * ( c + 1 ) ) / 2;
+                           const long long ptr_L = jump_D;
+                           const long long ptr_R = jump_G + SIZE_R * nocc_ij * ( c * ( c + 1 ) ) / 2;
                            matmat( 'N', SIZE_L, c * nocc_ij, SIZE_R, 1.0, workspace, SIZE_L, vector + ptr_R, SIZE_R, result + ptr_L, SIZE_L );
                            matmat( 'T', SIZE_R, c * nocc_ij, SIZE_L, 1.0, workspace, SIZE_L, vector + ptr_L, SIZE_L, result + ptr_R, SIZE_R );
                         }
                         #pragma omp parallel for schedule(static)
                         for ( int d = c; d < nvir_d; d++ ){
                            const double factor = (( c == d ) ? SQRT2 : 1.0 );
-                           const int ptr_L = jump_D + SIZE_L * nocc_ij * d;
-                           const int ptr_R = jump_G + SIZE_R * nocc_ij * ( c + ( d * ( d + 1 ) ) / 2 );
+                           const long long ptr_L = jump_D + SIZE_L * nocc_ij * d;
+                           const long long ptr_R = jump_G + SIZE_R * nocc_ij * ( c + ( d * ( d + 1 ) ) / 2 );
                            matmat( 'N', SIZE_L, nocc_ij, SIZE_R, factor, workspace, SIZE_L, vector + ptr_R, SIZE_R, result + ptr_L, SIZE_L );
                            matmat( 'T', SIZE_R, nocc_ij, SIZE_L, factor, workspace, SIZE_L, vector + ptr_L, SIZE_L, result + ptr_R, SIZE_R );
                         }
@@ -2139,14 +2254,14 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
                         if ( Iwc < Id ){
                            #pragma omp parallel for schedule(static)
                            for ( int d = 0; d < nvir_d; d++ ){
-                              const int ptr_L = jump_D + SIZE_L * nocc_ij * d;
-                              const int ptr_R = jump_G + SIZE_R * nocc_ij * ( c + nvir_wc * d );
+                              const long long ptr_L = jump_D + SIZE_L * nocc_ij * d;
+                              const long long ptr_R = jump_G + SIZE_R * nocc_ij * ( c + nvir_wc * d );
                               matmat( 'N', SIZE_L, nocc_ij, SIZE_R, 1.0, workspace, SIZE_L, vector + ptr_R, SIZE_R, result + ptr_L, SIZE_L );
                               matmat( 'T', SIZE_R, nocc_ij, SIZE_L, 1.0, workspace, SIZE_L, vector + ptr_L, SIZE_L, result + ptr_R, SIZE_R );
                            }
                         } else {
-                           const int ptr_L = jump_D;
-                           const int ptr_R = jump_G + SIZE_R * nocc_ij * nvir_d * c;
+                           const long long ptr_L = jump_D;
+                           const long long ptr_R = jump_G + SIZE_R * nocc_ij * nvir_d * c;
                            matmat( 'N', SIZE_L, nvir_d * nocc_ij, SIZE_R, 1.0, workspace, SIZE_L, vector + ptr_R, SIZE_R, result + ptr_L, SIZE_L );
                            matmat( 'T', SIZE_R, nvir_d * nocc_ij, SIZE_L, 1.0, workspace, SIZE_L, vector + ptr_L, SIZE_L, result + ptr_R, SIZE_R );
                         }
@@ -2162,6 +2277,7 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
    for ( int IL = 0; IL < num_irreps; IL++ ){ // IL == Ix x Iy == Id x Ij
       const int SIZE_L = size_D[ IL ];
       for ( int IR = 0; IR < num_irreps; IR++ ){ // IR = It = Ia x Ib x Ii
+         prefetch_block( vector, result, IR + 1, CHEMPS2_CASPT2_G_TRIPLET );
          const int SIZE_R = size_E[ IR ];
          const int Iwc = Irreps::directProd( IL, IR ); // Iwc == Ic == Iw
          const int nocc_wc = indices->getNOCC( Iwc );
@@ -2182,20 +2298,20 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
                   const int Id = Irreps::directProd( Iij, IL );
                   const int nvir_d = indices->getNVIRT( Id );
                   if ( nvir_d * nocc_ij > 0 ){
-                     const int jump_D = jump[ IL + num_irreps * CHEMPS2_CASPT2_D ] + SIZE_L * shift_D_nonactive( indices, Iij, Id );
-                     const int jump_G = jump[ IR + num_irreps * CHEMPS2_CASPT2_G_TRIPLET ] + SIZE_R * (( Iwc <= Id ) ? shift_G_nonactive( indices, Iij, Iwc, Id,  -1 )
+                     const long long jump_D = jump[ IL + num_irreps * CHEMPS2_CASPT2_D ] + SIZE_L * shift_D_nonactive( indices, Iij, Id );
+                     const long long jump_G = jump[ IR + num_irreps * CHEMPS2_CASPT2_G_TRIPLET ] + SIZE_R * (( Iwc <= Id ) ? shift_G_nonactive( indices, Iij, Iwc, Id,  -1 )
                                                                                                                      : shift_G_nonactive( indices, Iij, Id,  Iwc, -1 ));
                      if ( Iwc == Id ){ // irrep_c == irrep_d
                         if ( c > 0 ){
-                           const int ptr_L = jump_D;
-                           const int ptr_R = jump_G + SIZE_R * nocc_ij * ( c * ( c - 1 ) ) / 2;
+                           const long long ptr_L = jump_D;
+                           const long long ptr_R = jump_G + SIZE_R * nocc_ij * ( c * ( c - 1 ) ) / 2;
                            matmat( 'N', SIZE_L, c * nocc_ij, SIZE_R, -3.0, workspace, SIZE_L, vector + ptr_R, SIZE_R, result + ptr_L, SIZE_L );
                            matmat( 'T', SIZE_R, c * nocc_ij, SIZE_L, -3.0, workspace, SIZE_L, vector + ptr_L, SIZE_L, result + ptr_R, SIZE_R );
                         }
                         #pragma omp parallel for schedule(static)
                         for ( int d = c+1; d < nvir_d; d++ ){
-                           const int ptr_L = jump_D + SIZE_L * nocc_ij * d;
-                           const int ptr_R = jump_G + SIZE_R * nocc_ij * ( c + ( d * ( d - 1 ) ) / 2 );
+                           const long long ptr_L = jump_D + SIZE_L * nocc_ij * d;
+                           const long long ptr_R = jump_G + SIZE_R * nocc_ij * ( c + ( d * ( d - 1 ) ) / 2 );
                            matmat( 'N', SIZE_L, nocc_ij, SIZE_R, 3.0, workspace, SIZE_L, vector + ptr_R, SIZE_R, result + ptr_L, SIZE_L );
                            matmat( 'T', SIZE_R, nocc_ij, SIZE_L, 3.0, workspace, SIZE_L, vector + ptr_L, SIZE_L, result + ptr_R, SIZE_R );
                         }
@@ -2203,14 +2319,14 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
                         if ( Iwc < Id ){
                            #pragma omp parallel for schedule(static)
                            for ( int d = 0; d < nvir_d; d++ ){
-                              const int ptr_L = jump_D + SIZE_L * nocc_ij * d;
-                              const int ptr_R = jump_G + SIZE_R * nocc_ij * ( c + nvir_wc * d );
+                              const long long ptr_L = jump_D + SIZE_L * nocc_ij * d;
+                              const long long ptr_R = jump_G + SIZE_R * nocc_ij * ( c + nvir_wc * d );
                               matmat( 'N', SIZE_L, nocc_ij, SIZE_R, 3.0, workspace, SIZE_L, vector + ptr_R, SIZE_R, result + ptr_L, SIZE_L );
                               matmat( 'T', SIZE_R, nocc_ij, SIZE_L, 3.0, workspace, SIZE_L, vector + ptr_L, SIZE_L, result + ptr_R, SIZE_R );
                            }
                         } else {
-                           const int ptr_L = jump_D;
-                           const int ptr_R = jump_G + SIZE_R * nocc_ij * nvir_d * c;
+                           const long long ptr_L = jump_D;
+                           const long long ptr_R = jump_G + SIZE_R * nocc_ij * nvir_d * c;
                            matmat( 'N', SIZE_L, nvir_d * nocc_ij, SIZE_R, -3.0, workspace, SIZE_L, vector + ptr_R, SIZE_R, result + ptr_L, SIZE_L );
                            matmat( 'T', SIZE_R, nvir_d * nocc_ij, SIZE_L, -3.0, workspace, SIZE_L, vector + ptr_L, SIZE_L, result + ptr_R, SIZE_R );
                         }
@@ -2226,7 +2342,7 @@ void CheMPS2::CASPT2::matvec( double * vector, double * result, double * diag_fo
 
 }
 
-int CheMPS2::CASPT2::shift_H_nonactive( const DMRGSCFindices * idx, const int irrep_i, const int irrep_j, const int irrep_a, const int irrep_b, const int ST ){
+long long CheMPS2::CASPT2::shift_H_nonactive( const DMRGSCFindices * idx, const int irrep_i, const int irrep_j, const int irrep_a, const int irrep_b, const int ST ){
 
    assert( irrep_i <= irrep_j );
    assert( irrep_a <= irrep_b );
@@ -2235,7 +2351,7 @@ int CheMPS2::CASPT2::shift_H_nonactive( const DMRGSCFindices * idx, const int ir
    assert( irrep_prod == irrep_virt );
    const int n_irreps = idx->getNirreps();
 
-   int shift = 0;
+   long long shift = 0;
    if ( irrep_prod == 0 ){
       for ( int Iij = 0; Iij < n_irreps; Iij++ ){
          for ( int Iab = 0; Iab < n_irreps; Iab++ ){
@@ -2243,7 +2359,7 @@ int CheMPS2::CASPT2::shift_H_nonactive( const DMRGSCFindices * idx, const int ir
                Iij = n_irreps;
                Iab = n_irreps;
             } else {
-               shift += ( idx->getNOCC( Iij ) * ( idx->getNOCC( Iij ) + ST ) * idx->getNVIRT( Iab ) * ( idx->getNVIRT( Iab ) + ST ) ) / 4;
+               shift += ( (( long long ) idx->getNOCC( Iij )) * ( idx->getNOCC( Iij ) + ST ) * idx->getNVIRT( Iab ) * ( idx->getNVIRT( Iab ) + ST ) ) / 4;
             }
          }
       }
@@ -2258,7 +2374,7 @@ int CheMPS2::CASPT2::shift_H_nonactive( const DMRGSCFindices * idx, const int ir
                      Ii = n_irreps;
                      Ia = n_irreps;
                   } else {
-                     shift += idx->getNOCC( Ii ) * idx->getNOCC( Ij ) * idx->getNVIRT( Ia ) * idx->getNVIRT( Ib );
+                     shift += (( long long ) idx->getNOCC( Ii )) * idx->getNOCC( Ij ) * idx->getNVIRT( Ia ) * idx->getNVIRT( Ib );
                   }
                }
             }
@@ -2269,14 +2385,14 @@ int CheMPS2::CASPT2::shift_H_nonactive( const DMRGSCFindices * idx, const int ir
 
 }
 
-int CheMPS2::CASPT2::shift_G_nonactive( const DMRGSCFindices * idx, const int irrep_i, const int irrep_a, const int irrep_b, const int ST ){
+long long CheMPS2::CASPT2::shift_G_nonactive( const DMRGSCFindices * idx, const int irrep_i, const int irrep_a, const int irrep_b, const int ST ){
 
    assert( irrep_a <= irrep_b );
    const int irrep_virt = Irreps::directProd( irrep_a,    irrep_b );
    const int irrep_prod = Irreps::directProd( irrep_virt, irrep_i );
    const int n_irreps = idx->getNirreps();
 
-   int shift = 0;
+   long long shift = 0;
    for ( int Ii = 0; Ii < n_irreps; Ii++ ){
       const int Ivirt = Irreps::directProd( Ii, irrep_prod );
       if ( Ivirt == 0 ){
@@ -2285,7 +2401,7 @@ int CheMPS2::CASPT2::shift_G_nonactive( const DMRGSCFindices * idx, const int ir
                Ii  = n_irreps;
                Iab = n_irreps;
             } else {
-               shift += ( idx->getNOCC( Ii ) * idx->getNVIRT( Iab ) * ( idx->getNVIRT( Iab ) + ST ) ) / 2;
+               shift += ( (( long long ) idx->getNOCC( Ii )) * idx->getNVIRT( Iab ) * ( idx->getNVIRT( Iab ) + ST ) ) / 2;
             }
          }
       } else {
@@ -2296,7 +2412,7 @@ int CheMPS2::CASPT2::shift_G_nonactive( const DMRGSCFindices * idx, const int ir
                   Ii = n_irreps;
                   Ia = n_irreps;
                } else {
-                  shift += idx->getNOCC( Ii ) * idx->getNVIRT( Ia ) * idx->getNVIRT( Ib );
+                  shift += (( long long ) idx->getNOCC( Ii )) * idx->getNVIRT( Ia ) * idx->getNVIRT( Ib );
                }
             }
          }
@@ -2306,14 +2422,14 @@ int CheMPS2::CASPT2::shift_G_nonactive( const DMRGSCFindices * idx, const int ir
 
 }
 
-int CheMPS2::CASPT2::shift_E_nonactive( const DMRGSCFindices * idx, const int irrep_a, const int irrep_i, const int irrep_j, const int ST ){
+long long CheMPS2::CASPT2::shift_E_nonactive( const DMRGSCFindices * idx, const int irrep_a, const int irrep_i, const int irrep_j, const int ST ){
 
    assert( irrep_i <= irrep_j );
    const int irrep_occ  = Irreps::directProd( irrep_i,   irrep_j );
    const int irrep_prod = Irreps::directProd( irrep_occ, irrep_a );
    const int n_irreps = idx->getNirreps();
 
-   int shift = 0;
+   long long shift = 0;
    for ( int Ia = 0; Ia < n_irreps; Ia++ ){
       const int Iocc = Irreps::directProd( Ia, irrep_prod );
       if ( Iocc == 0 ){
@@ -2322,7 +2438,7 @@ int CheMPS2::CASPT2::shift_E_nonactive( const DMRGSCFindices * idx, const int ir
                Ia  = n_irreps;
                Iij = n_irreps;
             } else {
-               shift += ( idx->getNVIRT( Ia ) * idx->getNOCC( Iij ) * ( idx->getNOCC( Iij ) + ST ) ) / 2;
+               shift += ( (( long long ) idx->getNVIRT( Ia )) * idx->getNOCC( Iij ) * ( idx->getNOCC( Iij ) + ST ) ) / 2;
             }
          }
       } else {
@@ -2333,7 +2449,7 @@ int CheMPS2::CASPT2::shift_E_nonactive( const DMRGSCFindices * idx, const int ir
                   Ia = n_irreps;
                   Ii = n_irreps;
                } else {
-                  shift += idx->getNVIRT( Ia ) * idx->getNOCC( Ii ) * idx->getNOCC( Ij );
+                  shift += (( long long ) idx->getNVIRT( Ia )) * idx->getNOCC( Ii ) * idx->getNOCC( Ij );
                }
             }
          }
@@ -2343,13 +2459,13 @@ int CheMPS2::CASPT2::shift_E_nonactive( const DMRGSCFindices * idx, const int ir
 
 }
 
-int CheMPS2::CASPT2::shift_F_nonactive( const DMRGSCFindices * idx, const int irrep_a, const int irrep_b, const int ST ){
+long long CheMPS2::CASPT2::shift_F_nonactive( const DMRGSCFindices * idx, const int irrep_a, const int irrep_b, const int ST ){
 
    assert( irrep_a <= irrep_b );
    const int irr_prod = Irreps::directProd( irrep_a, irrep_b );
    const int n_irreps = idx->getNirreps();
 
-   int shift = 0;
+   long long shift = 0;
    if ( irr_prod == 0 ){
       for ( int Iab = 0; Iab < n_irreps; Iab++ ){
          if (( irrep_a == Iab ) && ( irrep_b == Iab )){
@@ -2374,13 +2490,13 @@ int CheMPS2::CASPT2::shift_F_nonactive( const DMRGSCFindices * idx, const int ir
 
 }
 
-int CheMPS2::CASPT2::shift_B_nonactive( const DMRGSCFindices * idx, const int irrep_i, const int irrep_j, const int ST ){
+long long CheMPS2::CASPT2::shift_B_nonactive( const DMRGSCFindices * idx, const int irrep_i, const int irrep_j, const int ST ){
 
    assert( irrep_i <= irrep_j );
    const int irr_prod = Irreps::directProd( irrep_i, irrep_j );
    const int n_irreps = idx->getNirreps();
 
-   int shift = 0;
+   long long shift = 0;
    if ( irr_prod == 0 ){
       for ( int Iij = 0; Iij < n_irreps; Iij++ ){
          if (( Iij == irrep_i ) && ( Iij == irrep_j )){
@@ -2405,12 +2521,12 @@ int CheMPS2::CASPT2::shift_B_nonactive( const DMRGSCFindices * idx, const int ir
 
 }
 
-int CheMPS2::CASPT2::shift_D_nonactive( const DMRGSCFindices * idx, const int irrep_i, const int irrep_a ){
+long long CheMPS2::CASPT2::shift_D_nonactive( const DMRGSCFindices * idx, const int irrep_i, const int irrep_a ){
 
    const int irrep_ia = Irreps::directProd( irrep_i, irrep_a );
    const int n_irreps = idx->getNirreps();
    
-   int shift = 0;
+   long long shift = 0;
    for ( int Ii = 0; Ii < n_irreps; Ii++ ){
       const int Ia = Irreps::directProd( irrep_ia, Ii );
       if (( Ii == irrep_i ) && ( Ia == irrep_a )){
@@ -2463,7 +2579,7 @@ void CheMPS2::CASPT2::diagonal( double * result ) const{
       for ( int irrep = 0; irrep < num_irreps; irrep++ ){
          const int SIZE = size_D[ irrep ];
          if ( SIZE > 0 ){
-            int shift = 0;
+            long long shift = 0;
             for ( int irrep_i = 0; irrep_i < num_irreps; irrep_i++ ){
                const int irrep_a = Irreps::directProd( irrep_i, irrep );
                const int NOCC_i  = indices->getNOCC( irrep_i );
@@ -2491,7 +2607,7 @@ void CheMPS2::CASPT2::diagonal( double * result ) const{
       {
          const int SIZE = size_B_singlet[ 0 ];
          if ( SIZE > 0 ){
-            int shift = 0;
+            long long shift = 0;
             for ( int irrep_ij = 0; irrep_ij < num_irreps; irrep_ij++ ){
                const int nocc_ij = indices->getNOCC( irrep_ij );
                const int size_ij = ( nocc_ij * ( nocc_ij + 1 ) ) / 2;
@@ -2514,7 +2630,7 @@ void CheMPS2::CASPT2::diagonal( double * result ) const{
       for ( int irrep = 1; irrep < num_irreps; irrep++ ){
          const int SIZE = size_B_singlet[ irrep ];
          if ( SIZE > 0 ){
-            int shift = 0;
+            long long shift = 0;
             for ( int irrep_i = 0; irrep_i < num_irreps; irrep_i++ ){
                const int irrep_j = Irreps::directProd( irrep, irrep_i );
                if ( irrep_i < irrep_j ){
@@ -2541,7 +2657,7 @@ void CheMPS2::CASPT2::diagonal( double * result ) const{
       {
          const int SIZE = size_B_triplet[ 0 ];
          if ( SIZE > 0 ){
-            int shift = 0;
+            long long shift = 0;
             for ( int irrep_ij = 0; irrep_ij < num_irreps; irrep_ij++ ){
                const int nocc_ij = indices->getNOCC( irrep_ij );
                const int size_ij = ( nocc_ij * ( nocc_ij - 1 ) ) / 2;
@@ -2564,7 +2680,7 @@ void CheMPS2::CASPT2::diagonal( double * result ) const{
       for ( int irrep = 1; irrep < num_irreps; irrep++ ){
          const int SIZE = size_B_triplet[ irrep ];
          if ( SIZE > 0 ){
-            int shift = 0;
+            long long shift = 0;
             for ( int irrep_i = 0; irrep_i < num_irreps; irrep_i++ ){
                const int irrep_j = Irreps::directProd( irrep, irrep_i );
                if ( irrep_i < irrep_j ){
@@ -2591,7 +2707,7 @@ void CheMPS2::CASPT2::diagonal( double * result ) const{
       {
          const int SIZE = size_F_singlet[ 0 ];
          if ( SIZE > 0 ){
-            int shift = 0;
+            long long shift = 0;
             for ( int irrep_ab = 0; irrep_ab < num_irreps; irrep_ab++ ){
                const int NVIR_ab = indices->getNVIRT( irrep_ab );
                const int N_OA_ab = indices->getNOCC( irrep_ab ) + indices->getNDMRG( irrep_ab );
@@ -2615,7 +2731,7 @@ void CheMPS2::CASPT2::diagonal( double * result ) const{
       for ( int irrep = 1; irrep < num_irreps; irrep++ ){
          const int SIZE = size_F_singlet[ irrep ];
          if ( SIZE > 0 ){
-            int shift = 0;
+            long long shift = 0;
             for ( int irrep_a = 0; irrep_a < num_irreps; irrep_a++ ){
                const int irrep_b = Irreps::directProd( irrep, irrep_a );
                if ( irrep_a < irrep_b ){
@@ -2644,7 +2760,7 @@ void CheMPS2::CASPT2::diagonal( double * result ) const{
       {
          const int SIZE = size_F_triplet[ 0 ];
          if ( SIZE > 0 ){
-            int shift = 0;
+            long long shift = 0;
             for ( int irrep_ab = 0; irrep_ab < num_irreps; irrep_ab++ ){
                const int NVIR_ab = indices->getNVIRT( irrep_ab );
                const int N_OA_ab = indices->getNOCC( irrep_ab ) + indices->getNDMRG( irrep_ab );
@@ -2668,7 +2784,7 @@ void CheMPS2::CASPT2::diagonal( double * result ) const{
       for ( int irrep = 1; irrep < num_irreps; irrep++ ){
          const int SIZE = size_F_triplet[ irrep ];
          if ( SIZE > 0 ){
-            int shift = 0;
+            long long shift = 0;
             for ( int irrep_a = 0; irrep_a < num_irreps; irrep_a++ ){
                const int irrep_b = Irreps::directProd( irrep, irrep_a );
                if ( irrep_a < irrep_b ){
@@ -2697,7 +2813,7 @@ void CheMPS2::CASPT2::diagonal( double * result ) const{
       for ( int irrep = 0; irrep < num_irreps; irrep++ ){
          const int SIZE = size_E[ irrep ];
          if ( SIZE > 0 ){
-            int shift = 0;
+            long long shift = 0;
             for ( int irrep_a = 0; irrep_a < num_irreps; irrep_a++ ){
                const int NVIR_a = indices->getNVIRT( irrep_a );
                const int N_OA_a = indices->getNOCC( irrep_a ) + indices->getNDMRG( irrep_a );
@@ -2750,7 +2866,7 @@ void CheMPS2::CASPT2::diagonal( double * result ) const{
       for ( int irrep = 0; irrep < num_irreps; irrep++ ){
          const int SIZE = size_E[ irrep ];
          if ( SIZE > 0 ){
-            int shift = 0;
+            long long shift = 0;
             for ( int irrep_a = 0; irrep_a < num_irreps; irrep_a++ ){
                const int NVIR_a = indices->getNVIRT( irrep_a );
                const int N_OA_a = indices->getNOCC( irrep_a ) + indices->getNDMRG( irrep_a );
@@ -2803,7 +2919,7 @@ void CheMPS2::CASPT2::diagonal( double * result ) const{
       for ( int irrep = 0; irrep < num_irreps; irrep++ ){
          const int SIZE = size_G[ irrep ];
          if ( SIZE > 0 ){
-            int shift = 0;
+            long long shift = 0;
             for ( int irrep_i = 0; irrep_i < num_irreps; irrep_i++ ){
                const int NOCC_i = indices->getNOCC( irrep_i );
                const int irrep_vir = Irreps::directProd( irrep_i, irrep );
@@ -2857,7 +2973,7 @@ void CheMPS2::CASPT2::diagonal( double * result ) const{
       for ( int irrep = 0; irrep < num_irreps; irrep++ ){
          const int SIZE = size_G[ irrep ];
          if ( SIZE > 0 ){
-            int shift = 0;
+            long long shift = 0;
             for ( int irrep_i = 0; irrep_i < num_irreps; irrep_i++ ){
                const int NOCC_i = indices->getNOCC( irrep_i );
                const int irrep_vir = Irreps::directProd( irrep_i, irrep );
@@ -2909,7 +3025,7 @@ void CheMPS2::CASPT2::diagonal( double * result ) const{
 
       // FHH singlet and triplet
       {
-         int shift = 0;
+         long long shift = 0;
          for ( int irrep_ij = 0; irrep_ij < num_irreps; irrep_ij++ ){
             const int NOCC_ij = indices->getNOCC( irrep_ij );
             const int size_ij = ( NOCC_ij * ( NOCC_ij + 1 ) ) / 2;
@@ -2938,7 +3054,7 @@ void CheMPS2::CASPT2::diagonal( double * result ) const{
          }
       }
       {
-         int shift = 0;
+         long long shift = 0;
          for ( int irrep_ij = 0; irrep_ij < num_irreps; irrep_ij++ ){
             const int NOCC_ij = indices->getNOCC( irrep_ij );
             const int size_ij = ( NOCC_ij * ( NOCC_ij - 1 ) ) / 2;
@@ -2967,7 +3083,7 @@ void CheMPS2::CASPT2::diagonal( double * result ) const{
          }
       }
       for ( int irrep = 1; irrep < num_irreps; irrep++ ){
-         int shift = 0;
+         long long shift = 0;
          for ( int irrep_i = 0; irrep_i < num_irreps; irrep_i++ ){
             const int irrep_j = Irreps::directProd( irrep, irrep_i );
             if ( irrep_i < irrep_j ){
@@ -3101,7 +3217,7 @@ void CheMPS2::CASPT2::construct_rhs( const DMRGSCFmatrix * oei, const DMRGSCFint
       }
    }
 
-   vector_rhs = new double[ jump[ num_irreps * CHEMPS2_CASPT2_NUM_CASES ] ];
+   vector_rhs = MmapVector::allocate( jump[ num_irreps * CHEMPS2_CASPT2_NUM_CASES ], scratch );
 
    #pragma omp parallel
    {
@@ -3283,7 +3399,7 @@ void CheMPS2::CASPT2::construct_rhs( const DMRGSCFmatrix * oei, const DMRGSCFint
       // VD1 and VD2
       for ( int irrep = 0; irrep < num_irreps; irrep++ ){
          if ( size_D[ irrep ] > 0 ){
-            int shift = 0;
+            long long shift = 0;
             const int D2JUMP = size_D[ irrep ] / 2;
             for ( int irrep_i = 0; irrep_i < num_irreps; irrep_i++ ){
                const int irrep_a = Irreps::directProd( irrep_i, irrep );
@@ -3376,7 +3492,7 @@ void CheMPS2::CASPT2::construct_rhs( const DMRGSCFmatrix * oei, const DMRGSCFint
 
       // VB singlet and triplet
       if ( size_B_singlet[ 0 ] > 0 ){ // First do irrep == Ii x Ij == Ix x Iy == It x Iu == 0
-         int shift = 0; // First do SINGLET
+         long long shift = 0; // First do SINGLET
          for ( int irrep_ij = 0; irrep_ij < num_irreps; irrep_ij++ ){
             assert( shift == shift_B_nonactive( indices, irrep_ij, irrep_ij, +1 ) );
             const int NOCC_ij = indices->getNOCC( irrep_ij );
@@ -3419,7 +3535,7 @@ void CheMPS2::CASPT2::construct_rhs( const DMRGSCFmatrix * oei, const DMRGSCFint
          assert( shift * size_B_singlet[ 0 ] == jump[ 1 + num_irreps * CHEMPS2_CASPT2_B_SINGLET ] - jump[ num_irreps * CHEMPS2_CASPT2_B_SINGLET ] );
       }
       if ( size_B_triplet[ 0 ] > 0 ){ // Then do TRIPLET
-         int shift = 0;
+         long long shift = 0;
          for ( int irrep_ij = 0; irrep_ij < num_irreps; irrep_ij++ ){
             assert( shift == shift_B_nonactive( indices, irrep_ij, irrep_ij, -1 ) );
             const int NOCC_ij = indices->getNOCC( irrep_ij );
@@ -3464,7 +3580,7 @@ void CheMPS2::CASPT2::construct_rhs( const DMRGSCFmatrix * oei, const DMRGSCFint
       for ( int irrep = 1; irrep < num_irreps; irrep++ ){
          assert( size_B_singlet[ irrep ] == size_B_triplet[ irrep ] );
          if ( size_B_singlet[ irrep ] > 0 ){
-            int shift = 0;
+            long long shift = 0;
             for ( int irrep_i = 0; irrep_i < num_irreps; irrep_i++ ){
                const int irrep_j = Irreps::directProd( irrep, irrep_i );
                if ( irrep_i < irrep_j ){
@@ -3544,7 +3660,7 @@ void CheMPS2::CASPT2::construct_rhs( const DMRGSCFmatrix * oei, const DMRGSCFint
 
       // VF singlet and triplet
       if ( size_F_singlet[ 0 ] > 0 ){ // First do irrep == Ii x Ij == Ix x Iy == It x Iu == 0
-         int shift = 0; // First do SINGLET
+         long long shift = 0; // First do SINGLET
          for ( int irrep_ab = 0; irrep_ab < num_irreps; irrep_ab++ ){
             assert( shift == shift_F_nonactive( indices, irrep_ab, irrep_ab, +1 ) );
             const int N_OA_ab = indices->getNOCC( irrep_ab ) + indices->getNDMRG( irrep_ab );
@@ -3588,7 +3704,7 @@ void CheMPS2::CASPT2::construct_rhs( const DMRGSCFmatrix * oei, const DMRGSCFint
          assert( shift * size_F_singlet[ 0 ] == jump[ 1 + num_irreps * CHEMPS2_CASPT2_F_SINGLET ] - jump[ num_irreps * CHEMPS2_CASPT2_F_SINGLET ] );
       }
       if ( size_F_triplet[ 0 ] > 0 ){ // Then do TRIPLET
-         int shift = 0;
+         long long shift = 0;
          for ( int irrep_ab = 0; irrep_ab < num_irreps; irrep_ab++ ){
             assert( shift == shift_F_nonactive( indices, irrep_ab, irrep_ab, -1 ) );
             const int N_OA_ab = indices->getNOCC( irrep_ab ) + indices->getNDMRG( irrep_ab );
@@ -3634,7 +3750,7 @@ void CheMPS2::CASPT2::construct_rhs( const DMRGSCFmatrix * oei, const DMRGSCFint
       for ( int irrep = 1; irrep < num_irreps; irrep++ ){
          assert( size_F_singlet[ irrep ] == size_F_triplet[ irrep ] );
          if ( size_F_singlet[ irrep ] > 0 ){
-            int shift = 0;
+            long long shift = 0;
             for ( int irrep_a = 0; irrep_a < num_irreps; irrep_a++ ){
                const int irrep_b = Irreps::directProd( irrep, irrep_a );
                if ( irrep_a < irrep_b ){
@@ -5462,7 +5578,7 @@ void CheMPS2::CASPT2::make_AA_CC( const bool OVLP, const double IPEA ){
                                  for ( int y = 0; y < num_y; y++ ){
                                     for ( int x = 0; x < num_x; x++ ){
                                        const int ptr = jump_row + x + num_x * ( y + num_y * z ) + SIZE * ( jump_col + t + num_t * ( u + num_u * v ) );
-                                       SAA[ irrep ][ ptr ] = - three_rdm[ d_z + z + LAS * ( d_t + t + LAS * ( d_u + u + LAS * ( d_y + y + LAS * ( d_x + x + LAS * ( d_v + v ))))) ];
+                                       SAA[ irrep ][ ptr ] = - three_rdm->get( d_z + z, d_t + t, d_u + u, d_y + y, d_x + x, d_v + v );
                                     }
                                  }
                               }
@@ -5482,7 +5598,7 @@ void CheMPS2::CASPT2::make_AA_CC( const bool OVLP, const double IPEA ){
                                     for ( int x = 0; x < num_x; x++ ){
                                        const double f_xx = fock->get( irrep_x, nocc_x + x, nocc_x + x );
                                        const int ptr = jump_row + x + num_x * ( y + num_y * z ) + SIZE * ( jump_col + t + num_t * ( u + num_u * v ) );
-                                       FAA[ irrep ][ ptr ] = - f_dot_4dm[ d_z + z + LAS * ( d_t + t + LAS * ( d_u + u + LAS * ( d_y + y + LAS * ( d_x + x + LAS * ( d_v + v ))))) ]
+                                       FAA[ irrep ][ ptr ] = - f_dot_4dm->get( d_z + z, d_t + t, d_u + u, d_y + y, d_x + x, d_v + v )
                                                              + ( f_tt + f_uu + f_xx + f_yy ) * SAA[ irrep ][ ptr ];
                                     }
                                  }
@@ -5503,7 +5619,7 @@ void CheMPS2::CASPT2::make_AA_CC( const bool OVLP, const double IPEA ){
                                  for ( int y = 0; y < num_y; y++ ){
                                     for ( int x = 0; x < num_x; x++ ){
                                        const int ptr = jump_row + x + num_x * ( y + num_y * z ) + SIZE * ( jump_col + t + num_t * ( u + num_u * v ) );
-                                       SCC[ irrep ][ ptr ] = three_rdm[ d_z + z + LAS * ( d_x + x + LAS * ( d_u + u + LAS * ( d_y + y + LAS * ( d_t + t + LAS * ( d_v + v ))))) ];
+                                       SCC[ irrep ][ ptr ] = three_rdm->get( d_z + z, d_x + x, d_u + u, d_y + y, d_t + t, d_v + v );
                                     }
                                  }
                               }
@@ -5521,7 +5637,7 @@ void CheMPS2::CASPT2::make_AA_CC( const bool OVLP, const double IPEA ){
                                     const double f_yy = fock->get( irrep_y, nocc_y + y, nocc_y + y );
                                     for ( int x = 0; x < num_x; x++ ){
                                        const int ptr = jump_row + x + num_x * ( y + num_y * z ) + SIZE * ( jump_col + t + num_t * ( u + num_u * v ) );
-                                       FCC[ irrep ][ ptr ] = f_dot_4dm[ d_z + z + LAS * ( d_x + x + LAS * ( d_u + u + LAS * ( d_y + y + LAS * ( d_t + t + LAS * ( d_v + v ))))) ]
+                                       FCC[ irrep ][ ptr ] = f_dot_4dm->get( d_z + z, d_x + x, d_u + u, d_y + y, d_t + t, d_v + v )
                                                            + ( f_yy + f_uu ) * SCC[ irrep ][ ptr ];
                                     }
                                  }
@@ -6149,7 +6265,7 @@ void CheMPS2::CASPT2::make_BB_FF_singlet( const bool OVLP, const double IPEA ){
                         for ( int y = x; y < num_xy; y++ ){ // 0 <= x <= y < num_xy
                            const double value = ( two_rdm[ d_xy + x + LAS * ( d_xy + y + LAS * ( d_ut + t + LAS * ( d_ut + u ))) ]
                                                 + two_rdm[ d_xy + x + LAS * ( d_xy + y + LAS * ( d_ut + u + LAS * ( d_ut + t ))) ] );
-                           const int ptr = shift + x + ( y * ( y + 1 ) ) / 2 + SIZE * ( t + ( u * ( u + 1 ) ) / 2 );
+                           const long long ptr = shift + x + ( y * ( y + 1 ) ) / 2 + SIZE * ( t + ( u * ( u + 1 ) ) / 2 );
                            SBB_singlet[ 0 ][ ptr ] = value;
                            SFF_singlet[ 0 ][ ptr ] = value;
                         }
@@ -6165,7 +6281,7 @@ void CheMPS2::CASPT2::make_BB_FF_singlet( const bool OVLP, const double IPEA ){
                         const double f_xx = fock->get( irrep_xy, nocc_xy + x, nocc_xy + x );
                         for ( int y = x; y < num_xy; y++ ){ // 0 <= x <= y < num_xy
                            const double f_yy = fock->get( irrep_xy, nocc_xy + y, nocc_xy + y );
-                           const int ptr = shift + x + ( y * ( y + 1 ) ) / 2 + SIZE * ( t + ( u * ( u + 1 ) ) / 2 );
+                           const long long ptr = shift + x + ( y * ( y + 1 ) ) / 2 + SIZE * ( t + ( u * ( u + 1 ) ) / 2 );
                            const double fdotsum = ( f_dot_3dm[ d_xy + x + LAS * ( d_xy + y + LAS * ( d_ut + t + LAS * ( d_ut + u ))) ]
                                                   + f_dot_3dm[ d_xy + x + LAS * ( d_xy + y + LAS * ( d_ut + u + LAS * ( d_ut + t ))) ] );
                            FBB_singlet[ 0 ][ ptr ] = fdotsum + ( f_tt + f_uu + f_xx + f_yy ) * SBB_singlet[ 0 ][ ptr ];
@@ -6357,7 +6473,7 @@ void CheMPS2::CASPT2::make_BB_FF_singlet( const bool OVLP, const double IPEA ){
                               for ( int y = 0; y < num_y; y++ ){
                                  const double value = ( two_rdm[ d_x + x + LAS * ( d_y + y + LAS * ( d_t + t + LAS * ( d_u + u ))) ]
                                                       + two_rdm[ d_x + x + LAS * ( d_y + y + LAS * ( d_u + u + LAS * ( d_t + t ))) ] );
-                                 const int ptr = shift + x + num_x * y + SIZE * ( t + num_t * u );
+                                 const long long ptr = shift + x + num_x * y + SIZE * ( t + num_t * u );
                                  SBB_singlet[ irrep ][ ptr ] = value;
                                  SFF_singlet[ irrep ][ ptr ] = value;
                               }
@@ -6373,7 +6489,7 @@ void CheMPS2::CASPT2::make_BB_FF_singlet( const bool OVLP, const double IPEA ){
                               const double f_xx = fock->get( irrep_x, nocc_x + x, nocc_x + x );
                               for ( int y = 0; y < num_y; y++ ){
                                  const double f_yy = fock->get( irrep_y, nocc_y + y, nocc_y + y );
-                                 const int ptr = shift + x + num_x * y + SIZE * ( t + num_t * u );
+                                 const long long ptr = shift + x + num_x * y + SIZE * ( t + num_t * u );
                                  const double fdotsum = ( f_dot_3dm[ d_x + x + LAS * ( d_y + y + LAS * ( d_t + t + LAS * ( d_u + u ))) ]
                                                         + f_dot_3dm[ d_x + x + LAS * ( d_y + y + LAS * ( d_u + u + LAS * ( d_t + t ))) ] );
                                  FBB_singlet[ irrep ][ ptr ] = fdotsum + ( f_xx + f_yy + f_tt + f_uu ) * SBB_singlet[ irrep ][ ptr ];
@@ -6556,7 +6672,7 @@ void CheMPS2::CASPT2::make_BB_FF_triplet( const bool OVLP, const double IPEA ){
                   for ( int u = t+1; u < num_ut; u++ ){ // 0 <= t < u < num_ut
                      for ( int x = 0; x < num_xy; x++ ){
                         for ( int y = x+1; y < num_xy; y++ ){ // 0 <= x < y < num_xy
-                           const int ptr = shift + x + ( y * ( y - 1 ) ) / 2 + SIZE * ( t + ( u * ( u - 1 ) ) / 2 );
+                           const long long ptr = shift + x + ( y * ( y - 1 ) ) / 2 + SIZE * ( t + ( u * ( u - 1 ) ) / 2 );
                            const double value = ( two_rdm[ d_xy + x + LAS * ( d_xy + y + LAS * ( d_ut + t + LAS * ( d_ut + u ))) ]
                                                 - two_rdm[ d_xy + x + LAS * ( d_xy + y + LAS * ( d_ut + u + LAS * ( d_ut + t ))) ] );
                            SBB_triplet[ 0 ][ ptr ] = value;
@@ -6574,7 +6690,7 @@ void CheMPS2::CASPT2::make_BB_FF_triplet( const bool OVLP, const double IPEA ){
                         const double f_xx = fock->get( irrep_xy, nocc_xy + x, nocc_xy + x );
                         for ( int y = x+1; y < num_xy; y++ ){ // 0 <= x < y < num_xy
                            const double f_yy = fock->get( irrep_xy, nocc_xy + y, nocc_xy + y );
-                           const int ptr = shift + x + ( y * ( y - 1 ) ) / 2 + SIZE * ( t + ( u * ( u - 1 ) ) / 2 );
+                           const long long ptr = shift + x + ( y * ( y - 1 ) ) / 2 + SIZE * ( t + ( u * ( u - 1 ) ) / 2 );
                            const double fdotdiff = ( f_dot_3dm[ d_xy + x + LAS * ( d_xy + y + LAS * ( d_ut + t + LAS * ( d_ut + u ))) ]
                                                    - f_dot_3dm[ d_xy + x + LAS * ( d_xy + y + LAS * ( d_ut + u + LAS * ( d_ut + t ))) ] );
                            FBB_triplet[ 0 ][ ptr ] = fdotdiff + ( f_tt + f_uu + f_xx + f_yy ) * SBB_triplet[ 0 ][ ptr ];
@@ -6762,7 +6878,7 @@ void CheMPS2::CASPT2::make_BB_FF_triplet( const bool OVLP, const double IPEA ){
                         for ( int u = 0; u < num_u; u++ ){
                            for ( int x = 0; x < num_x; x++ ){
                               for ( int y = 0; y < num_y; y++ ){
-                                 const int ptr = shift + x + num_x * y + SIZE * ( t + num_t * u );
+                                 const long long ptr = shift + x + num_x * y + SIZE * ( t + num_t * u );
                                  const double value = ( two_rdm[ d_x + x + LAS * ( d_y + y + LAS * ( d_t + t + LAS * ( d_u + u ))) ]
                                                       - two_rdm[ d_x + x + LAS * ( d_y + y + LAS * ( d_u + u + LAS * ( d_t + t ))) ] );
                                  SBB_triplet[ irrep ][ ptr ] = value;
@@ -6780,7 +6896,7 @@ void CheMPS2::CASPT2::make_BB_FF_triplet( const bool OVLP, const double IPEA ){
                               const double f_xx = fock->get( irrep_x, nocc_x + x, nocc_x + x );
                               for ( int y = 0; y < num_y; y++ ){
                                  const double f_yy = fock->get( irrep_y, nocc_y + y, nocc_y + y );
-                                 const int ptr = shift + x + num_x * y + SIZE * ( t + num_t * u );
+                                 const long long ptr = shift + x + num_x * y + SIZE * ( t + num_t * u );
                                  const double fdotdiff = ( f_dot_3dm[ d_x + x + LAS * ( d_y + y + LAS * ( d_t + t + LAS * ( d_u + u ))) ]
                                                          - f_dot_3dm[ d_x + x + LAS * ( d_y + y + LAS * ( d_u + u + LAS * ( d_t + t ))) ] );
                                  FBB_triplet[ irrep ][ ptr ] = fdotdiff + ( f_tt + f_uu + f_xx + f_yy ) * SBB_triplet[ irrep ][ ptr ];
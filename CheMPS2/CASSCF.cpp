@@ -24,6 +24,7 @@
 #include <math.h>
 #include <algorithm>
 #include <assert.h>
+#include <limits.h>
 
 #include "CASSCF.h"
 #include "Lapack.h"
@@ -35,8 +36,9 @@ using std::ifstream;
 using std::cout;
 using std::endl;
 using std::max;
+using std::min;
 
-CheMPS2::CASSCF::CASSCF( Hamiltonian * ham_in, int * docc, int * socc, int * nocc, int * ndmrg, int * nvirt, const string new_tmp_folder ){
+CheMPS2::CASSCF::CASSCF( Hamiltonian * ham_in, int * docc, int * socc, int * nocc, int * ndmrg, int * nvirt, const string new_tmp_folder, const double new_mem_budget, const char new_storage, const int new_deflate_level, const int new_lossy_digits ){
 
    #ifdef CHEMPS2_MPI_COMPILATION
       const bool am_i_master = ( MPIchemps2::mpi_rank() == MPI_CHEMPS2_MASTER );
@@ -94,6 +96,10 @@ CheMPS2::CASSCF::CASSCF( Hamiltonian * ham_in, int * docc, int * socc, int * noc
    }
 
    this->tmp_folder = new_tmp_folder;
+   this->mem_budget = new_mem_budget;
+   this->storage    = new_storage;
+   this->deflate_level = new_deflate_level;
+   this->lossy_digits  = new_lossy_digits;
 
 }
 
@@ -430,7 +436,7 @@ void CheMPS2::CASSCF::copy_active( const DMRGSCFmatrix * origin, double * result
 
 }
 
-void CheMPS2::CASSCF::block_diagonalize( const char space, const DMRGSCFmatrix * Mat, DMRGSCFunitary * Umat, double * work1, double * work2, const DMRGSCFindices * idx, const bool invert, double * two_dm, double * three_dm, double * contract ){
+void CheMPS2::CASSCF::block_diagonalize( const char space, const DMRGSCFmatrix * Mat, DMRGSCFunitary * Umat, double * work1, double * work2, const DMRGSCFindices * idx, const bool invert, double * two_dm, SixIndex * three_dm, SixIndex * contract ){
 
    #ifdef CHEMPS2_MPI_COMPILATION
       const bool am_i_master = ( MPIchemps2::mpi_rank() == MPI_CHEMPS2_MASTER );
@@ -443,6 +449,14 @@ void CheMPS2::CASSCF::block_diagonalize( const char space, const DMRGSCFmatrix *
 
    if ( am_i_master ){
 
+      // The 6-index objects are rotated per dense slice with fixed last index, into a packed copy
+      const bool rotate_six = (( space == 'A' ) && (( three_dm != NULL ) || ( contract != NULL )));
+      const long long dmrg_pow5 = (( long long ) tot_dmrg ) * tot_dmrg * tot_dmrg * tot_dmrg * tot_dmrg;
+      const long long size_six = max( (( three_dm != NULL ) ? three_dm->get_array_size() : 0 ), (( contract != NULL ) ? contract->get_array_size() : 0 ) );
+      double * packed = (( rotate_six ) ? new double[ size_six  ] : NULL );
+      double * slice  = (( rotate_six ) ? new double[ dmrg_pow5 ] : NULL );
+      double * work3  = (( rotate_six ) ? new double[ dmrg_pow5 ] : NULL );
+
       for ( int irrep = 0; irrep < n_irreps; irrep++ ){
 
          int NTOTAL  = idx->getNORB( irrep );
@@ -491,49 +505,91 @@ void CheMPS2::CASSCF::block_diagonalize( const char space, const DMRGSCFmatrix *
 
             // Adjust the two_dm, three_dm, and contract objects accordingly
             if ( space == 'A' ){
-               if (   two_dm != NULL ){ rotate_active_space_object( 4,   two_dm, work2, work1, tot_dmrg, NJUMP, NROTATE ); }
-               if ( three_dm != NULL ){ rotate_active_space_object( 6, three_dm, work2, work1, tot_dmrg, NJUMP, NROTATE ); }
-               if ( contract != NULL ){ rotate_active_space_object( 6, contract, work2, work1, tot_dmrg, NJUMP, NROTATE ); }
+               if ( two_dm != NULL ){ rotate_active_space_object( 4, two_dm, work2, tot_dmrg * tot_dmrg * tot_dmrg * tot_dmrg, work1, tot_dmrg, NJUMP, NROTATE ); }
+               SixIndex * six_dm[] = { three_dm, contract };
+               for ( int obj = 0; obj < 2; obj++ ){
+                  if ( six_dm[ obj ] != NULL ){ rotate_six_index_object( six_dm[ obj ], packed, slice, work3, work1, NJUMP, NROTATE ); }
+               }
             }
          }
       }
+
+      if ( rotate_six ){
+         delete [] packed;
+         delete [] slice;
+         delete [] work3;
+      }
    }
 
    #ifdef CHEMPS2_MPI_COMPILATION
    Umat->broadcast( MPI_CHEMPS2_MASTER );
    if ( space == 'A' ){
-      if (   two_dm != NULL ){ MPIchemps2::broadcast_array_double(   two_dm, tot_dmrg * tot_dmrg * tot_dmrg * tot_dmrg,                       MPI_CHEMPS2_MASTER ); }
-      if ( three_dm != NULL ){ MPIchemps2::broadcast_array_double( three_dm, tot_dmrg * tot_dmrg * tot_dmrg * tot_dmrg * tot_dmrg * tot_dmrg, MPI_CHEMPS2_MASTER ); }
-      if ( contract != NULL ){ MPIchemps2::broadcast_array_double( contract, tot_dmrg * tot_dmrg * tot_dmrg * tot_dmrg * tot_dmrg * tot_dmrg, MPI_CHEMPS2_MASTER ); }
+      if (   two_dm != NULL ){ MPIchemps2::broadcast_array_double( two_dm, tot_dmrg * tot_dmrg * tot_dmrg * tot_dmrg, MPI_CHEMPS2_MASTER ); }
+      if ( three_dm != NULL ){ three_dm->broadcast( MPI_CHEMPS2_MASTER ); }
+      if ( contract != NULL ){ contract->broadcast( MPI_CHEMPS2_MASTER ); }
    }
    #endif
 
 }
 
-void CheMPS2::CASSCF::rotate_active_space_object( const int num_indices, double * object, double * work, double * rotation, const int LAS, const int NJUMP, const int NROTATE ){
+void CheMPS2::CASSCF::rotate_six_index_object( SixIndex * object, double * packed, double * slice, double * work, double * rotation, const int NJUMP, const int NROTATE ){
+
+   const int LAS = object->get_L();
+   const long long size  = object->get_array_size();
+   const long long size5 = (( long long ) LAS ) * LAS * LAS * LAS * LAS;
+   for ( long long cnt = 0; cnt < size; cnt++ ){ packed[ cnt ] = 0.0; }
+
+   // The slices with last index outside the rotated block: only the first five indices are rotated
+   for ( int last_orb = 0; last_orb < LAS; last_orb++ ){
+      if (( last_orb < NJUMP ) || ( last_orb >= NJUMP + NROTATE )){
+         object->fill_dense_slice( slice, last_orb );
+         rotate_active_space_object( 5, slice, work, size5, rotation, LAS, NJUMP, NROTATE );
+         object->add_dense_slice( slice, last_orb, 1.0, packed );
+      }
+   }
+
+   // The slices with last index inside the rotated block: new slice[ col ] = sum_row rotation[ row + NROTATE * col ] * old slice[ row ]
+   for ( int row = 0; row < NROTATE; row++ ){
+      object->fill_dense_slice( slice, NJUMP + row );
+      rotate_active_space_object( 5, slice, work, size5, rotation, LAS, NJUMP, NROTATE );
+      for ( int col = 0; col < NROTATE; col++ ){
+         object->add_dense_slice( slice, NJUMP + col, rotation[ row + NROTATE * col ], packed );
+      }
+   }
+
+   double * storage = object->get_storage();
+   for ( long long cnt = 0; cnt < size; cnt++ ){ storage[ cnt ] = packed[ cnt ]; }
+
+}
+
+void CheMPS2::CASSCF::rotate_active_space_object( const int num_indices, double * object, double * work, const long long work_size, double * rotation, const int LAS, const int NJUMP, const int NROTATE ){
 
    assert( num_indices >= 2 );
    assert( num_indices <= 6 );
 
-   int power[] = { 1,
-                   LAS,
-                   LAS * LAS,
-                   LAS * LAS * LAS,
-                   LAS * LAS * LAS * LAS,
-                   LAS * LAS * LAS * LAS * LAS,
-                   LAS * LAS * LAS * LAS * LAS * LAS };
+   long long power[ 7 ];
+   power[ 0 ] = 1;
+   for ( int cnt = 1; cnt <= 6; cnt++ ){ power[ cnt ] = power[ cnt - 1 ] * LAS; }
+   assert( power[ num_indices - 1 ] <= INT_MAX );
 
    for ( int rot_index = num_indices - 1; rot_index >= 0; rot_index-- ){
-      for ( int block = 0; block < power[ num_indices - 1 - rot_index ]; block++ ){
+      int ld_mat     = power[ rot_index ];
+      int chunk_rows = min( power[ rot_index ], work_size / NROTATE ); // The rows of mat are rotated in chunks which fit in work
+      assert( chunk_rows >= 1 );
+      for ( long long block = 0; block < power[ num_indices - 1 - rot_index ]; block++ ){
          double * mat = object + power[ rot_index ] * NJUMP + power[ rot_index + 1 ] * block;
-         int ROTDIM = NROTATE;
-         char notrans = 'N';
-         double one = 1.0;
-         double set = 0.0;
-         dgemm_( &notrans, &notrans, power + rot_index, &ROTDIM, &ROTDIM, &one, mat, power + rot_index, rotation, &ROTDIM, &set, work, power + rot_index );
-         int size = power[ rot_index ] * NROTATE;
-         int inc1 = 1;
-         dcopy_( &size, work, &inc1, mat, &inc1 );
+         for ( int start = 0; start < ld_mat; start += chunk_rows ){
+            int ROWS   = min( chunk_rows, ld_mat - start );
+            int ROTDIM = NROTATE;
+            char notrans = 'N';
+            double one = 1.0;
+            double set = 0.0;
+            dgemm_( &notrans, &notrans, &ROWS, &ROTDIM, &ROTDIM, &one, mat + start, &ld_mat, rotation, &ROTDIM, &set, work, &ROWS );
+            int inc1 = 1;
+            for ( int col = 0; col < NROTATE; col++ ){
+               dcopy_( &ROWS, work + ROWS * col, &inc1, mat + start + power[ rot_index ] * col, &inc1 );
+            }
+         }
       }
    }
 
@@ -123,6 +123,22 @@ double CheMPS2::CASSCF::solve( const int Nelectrons, const int TwoS, const int I
       }
    }
 
+   // The DMRG object is kept between the iterations, to continue from its MPS with the last instruction of OptScheme
+   DMRG * theDMRG = NULL;
+   ConvergenceScheme * WarmScheme = NULL;
+   int * dmrg2ham_prev = NULL;
+   const bool warm_start_allowed = (( OptScheme != NULL ) && (( scf_options->getStateAveraging() ) || ( rootNum == 1 )) && ( scf_options->getWarmStartBranch() >= 0.0 ));
+   if ( warm_start_allowed ){
+      const int last = OptScheme->get_number() - 1;
+      WarmScheme = new ConvergenceScheme( 1 );
+      WarmScheme->set_instruction( 0, OptScheme->get_D( last ), OptScheme->get_energy_conv( last ), OptScheme->get_max_sweeps( last ), OptScheme->get_noise_prefactor( last ), OptScheme->get_dvdson_rtol( last ) );
+      WarmScheme->set_one_site( 0, OptScheme->get_one_site( last ), OptScheme->get_expansion_prefactor( last ) );
+      WarmScheme->set_truncation( 0, OptScheme->get_max_discarded_weight( last ), OptScheme->get_D_min( last ) );
+      dmrg2ham_prev = new int[ nOrbDMRG ];
+      for ( int orb = 0; orb < nOrbDMRG; orb++ ){ dmrg2ham_prev[ orb ] = -1; }
+   }
+   bool warm_start = false; // Whether the MPS of theDMRG belongs to the current active space and orbital ordering
+
    int nIterations = 0;
 
    /*******************************
@@ -180,6 +196,7 @@ double CheMPS2::CASSCF::solve( const int Nelectrons, const int TwoS, const int I
 
       // Localize the active space and reorder the orbitals within each irrep based on the exchange matrix
       if (( scf_options->getWhichActiveSpace() == 2 ) && ( master_diis == 0 )){ // When the DIIS has started: stop
+         warm_start = false;
          if ( am_i_master ){
             theLocalizer->Optimize(mem1, mem2, scf_options->getStartLocRandom());
             theLocalizer->FiedlerExchange(maxlinsize, mem1, mem2);
@@ -211,6 +228,12 @@ double CheMPS2::CASSCF::solve( const int Nelectrons, const int TwoS, const int I
          MPIchemps2::broadcast_array_int( dmrg2ham, nOrbDMRG, MPI_CHEMPS2_MASTER );
          #endif
          Prob->setup_reorder_custom( dmrg2ham );
+         if ( warm_start_allowed ){
+            for ( int orb = 0; orb < nOrbDMRG; orb++ ){
+               if ( dmrg2ham[ orb ] != dmrg2ham_prev[ orb ] ){ warm_start = false; }
+               dmrg2ham_prev[ orb ] = dmrg2ham[ orb ];
+            }
+         }
          delete [] dmrg2ham;
       }
 
@@ -239,24 +262,45 @@ double CheMPS2::CASSCF::solve( const int Nelectrons, const int TwoS, const int I
 
          assert( OptScheme != NULL );
          for ( int cnt = 0; cnt < dmrgsize_power4; cnt++ ){ DMRG2DM[ cnt ] = 0.0; } // Clear the 2-RDM ( to allow for state-averaged calculations )
-         DMRG * theDMRG = new DMRG( Prob, OptScheme, CheMPS2::DMRG_storeMpsOnDisk, tmp_folder );
-         for ( int state = 0; state < rootNum; state++ ){
-            if ( state > 0 ){ theDMRG->newExcitation( fabs( Energy ) ); }
-            Energy = theDMRG->Solve();
-            if ( scf_options->getStateAveraging() ){ // When SA-DMRGSCF: 2DM += current 2DM
+         if (( warm_start ) && ( updateNorm <= scf_options->getWarmStartBranch() )){
+            if ( am_i_master ){ cout << "DMRGSCF::solve : Continue from the MPS of the previous iteration." << endl; }
+            theDMRG->warmStart( WarmScheme );
+         } else {
+            if ( theDMRG != NULL ){
+               if (CheMPS2::DMRG_storeMpsOnDisk){        theDMRG->deleteStoredMPS();       }
+               theDMRG->deleteStoredOperators();
+               delete theDMRG;
+            }
+            theDMRG = new DMRG( Prob, OptScheme, CheMPS2::DMRG_storeMpsOnDisk, tmp_folder, mem_budget, storage, deflate_level, lossy_digits );
+            if (( scf_options->getStateAveraging() ) && ( rootNum > 1 )){ theDMRG->activateStateAveraging( rootNum ); }
+         }
+         if (( scf_options->getStateAveraging() ) && ( rootNum > 1 )){ // When SA-DMRGSCF: all roots in one set of sweeps, and 2DM += 2DM of each root
+            theDMRG->Solve();
+            for ( int state = 0; state < rootNum; state++ ){
+               theDMRG->selectRoot( state );
                theDMRG->calc2DMandCorrelations();
                copy2DMover( theDMRG->get2DM(), nOrbDMRG, DMRG2DM );
             }
-            if (( state == 0 ) && ( rootNum > 1 )){ theDMRG->activateExcitations( rootNum - 1 ); }
+            Energy = theDMRG->getRootEnergy( rootNum - 1 );
+         } else {
+            for ( int state = 0; state < rootNum; state++ ){
+               if ( state > 0 ){ theDMRG->newExcitation( fabs( Energy ) ); }
+               Energy = theDMRG->Solve();
+               if (( state == 0 ) && ( rootNum > 1 )){ theDMRG->activateExcitations( rootNum - 1 ); }
+            }
          }
-         if ( !( scf_options->getStateAveraging() )){ // When SS-DMRGSCF: 2DM += last 2DM
+         if ( !(( scf_options->getStateAveraging() ) && ( rootNum > 1 ))){ // When SS-DMRGSCF or a single root: 2DM += last 2DM
             theDMRG->calc2DMandCorrelations();
             copy2DMover( theDMRG->get2DM(), nOrbDMRG, DMRG2DM );
          }
          if (( scf_options->getDumpCorrelations() ) && ( am_i_master )){ theDMRG->getCorrelations()->Print(); }
-         if (CheMPS2::DMRG_storeMpsOnDisk){        theDMRG->deleteStoredMPS();       }
-         if (CheMPS2::DMRG_storeRenormOptrOnDisk){ theDMRG->deleteStoredOperators(); }
-         delete theDMRG;
+         warm_start = warm_start_allowed;
+         if ( !warm_start ){
+            if (CheMPS2::DMRG_storeMpsOnDisk){        theDMRG->deleteStoredMPS();       }
+            theDMRG->deleteStoredOperators();
+            delete theDMRG;
+            theDMRG = NULL;
+         }
          if (( scf_options->getStateAveraging() ) && ( rootNum > 1 )){
             const double averagingfactor = 1.0 / rootNum;
             for ( int cnt = 0; cnt < dmrgsize_power4; cnt++ ){ DMRG2DM[ cnt ] *= averagingfactor; }
@@ -267,6 +311,7 @@ double CheMPS2::CASSCF::solve( const int Nelectrons, const int TwoS, const int I
 
       // Possibly rotate the active space to the natural orbitals
       if (( scf_options->getWhichActiveSpace() == 1 ) && ( master_diis == 0 )){ // When the DIIS has started: stop
+         warm_start = false;
          copy_active( DMRG1DM, theQmatWORK, iHandler, true );
          block_diagonalize( 'A', theQmatWORK, unitary, mem1, mem2, iHandler, true, DMRG2DM, NULL, NULL ); // Unitary is updated and DMRG2DM rotated
          setDMRG1DM( num_elec, nOrbDMRG, DMRG1DM, DMRG2DM );
@@ -295,6 +340,14 @@ double CheMPS2::CASSCF::solve( const int Nelectrons, const int TwoS, const int I
 
    }
 
+   if ( theDMRG != NULL ){
+      if (CheMPS2::DMRG_storeMpsOnDisk){        theDMRG->deleteStoredMPS();       }
+      theDMRG->deleteStoredOperators();
+      delete theDMRG;
+   }
+   if ( WarmScheme    != NULL ){ delete WarmScheme; }
+   if ( dmrg2ham_prev != NULL ){ delete [] dmrg2ham_prev; }
+
    delete [] mem1;
    delete [] mem2;
    delete theRotatedTEI;
@@ -24,6 +24,7 @@
 #include <algorithm>
 #include <sys/stat.h>
 #include <assert.h>
+#include <vector>
 
 #include "CASSCF.h"
 #include "DMRG.h"
@@ -34,6 +35,7 @@
 #include "CASPT2.h"
 #include "MPIchemps2.h"
 #include "EdmistonRuedenberg.h"
+#include "Special.h"
 
 using std::string;
 using std::ifstream;
@@ -41,7 +43,7 @@ using std::cout;
 using std::endl;
 using std::max;
 
-void CheMPS2::CASSCF::write_f4rdm_checkpoint( const string f4rdm_file, int * hamorb1, int * hamorb2, const int tot_dmrg_power6, double * contract ){
+void CheMPS2::CASSCF::write_f4rdm_checkpoint( const string f4rdm_file, const int LAS, int * done, SixIndex * contract ){
 
    #ifdef CHEMPS2_MPI_COMPILATION
       const bool am_i_master = ( MPIchemps2::mpi_rank() == MPI_CHEMPS2_MASTER );
@@ -54,37 +56,32 @@ void CheMPS2::CASSCF::write_f4rdm_checkpoint( const string f4rdm_file, int * ham
       hid_t file_id  = H5Fcreate( f4rdm_file.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT );
       hid_t group_id = H5Gcreate( file_id, "/F4RDM", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
 
-      hsize_t dimarray1   = 1;
+      hsize_t dimarray1   = LAS * LAS;
       hid_t dataspace1_id = H5Screate_simple( 1, &dimarray1, NULL );
-      hid_t dataset1_id   = H5Dcreate( group_id, "hamorb1", H5T_NATIVE_INT, dataspace1_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
-      H5Dwrite( dataset1_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, hamorb1 );
+      hid_t dataset1_id   = H5Dcreate( group_id, "done", H5T_NATIVE_INT, dataspace1_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
+      H5Dwrite( dataset1_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, done );
       H5Dclose( dataset1_id );
       H5Sclose( dataspace1_id );
 
-      hsize_t dimarray2   = 1;
-      hid_t dataspace2_id = H5Screate_simple( 1, &dimarray2, NULL );
-      hid_t dataset2_id   = H5Dcreate( group_id, "hamorb2", H5T_NATIVE_INT, dataspace2_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
-      H5Dwrite( dataset2_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, hamorb2 );
-      H5Dclose( dataset2_id );
-      H5Sclose( dataspace2_id );
-
-      hsize_t dimarray3   = tot_dmrg_power6;
+      hsize_t dimarray3   = contract->get_array_size(); // Symmetry-packed
       hid_t dataspace3_id = H5Screate_simple( 1, &dimarray3, NULL );
       hid_t dataset3_id   = H5Dcreate( group_id, "contract", H5T_NATIVE_DOUBLE, dataspace3_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
-      H5Dwrite( dataset3_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, contract );
+      H5Dwrite( dataset3_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, contract->get_storage() );
       H5Dclose( dataset3_id );
       H5Sclose( dataspace3_id );
 
       H5Gclose( group_id );
       H5Fclose( file_id );
 
-      cout << "Created F.4-RDM checkpoint file " << f4rdm_file << " at next orbitals ( " << hamorb1[ 0 ] << " , " << hamorb2[ 0 ] << " )." << endl;
+      int num_done = 0;
+      for ( int cnt = 0; cnt < LAS * LAS; cnt++ ){ num_done += done[ cnt ]; }
+      cout << "Created F.4-RDM checkpoint file " << f4rdm_file << " with " << num_done << " orbital pairs done." << endl;
 
    }
 
 }
 
-bool CheMPS2::CASSCF::read_f4rdm_checkpoint( const string f4rdm_file, int * hamorb1, int * hamorb2, const int tot_dmrg_power6, double * contract ){
+bool CheMPS2::CASSCF::read_f4rdm_checkpoint( const string f4rdm_file, const int LAS, int * done, SixIndex * contract ){
 
    #ifdef CHEMPS2_MPI_COMPILATION
       const bool am_i_master = ( MPIchemps2::mpi_rank() == MPI_CHEMPS2_MASTER );
@@ -111,16 +108,43 @@ bool CheMPS2::CASSCF::read_f4rdm_checkpoint( const string f4rdm_file, int * hamo
       hid_t file_id  = H5Fopen( f4rdm_file.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT );
       hid_t group_id = H5Gopen( file_id, "/F4RDM", H5P_DEFAULT );
 
-      hid_t dataset1_id = H5Dopen( group_id, "hamorb1", H5P_DEFAULT );
-      H5Dread( dataset1_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, hamorb1 );
-      H5Dclose( dataset1_id );
-
-      hid_t dataset2_id = H5Dopen( group_id, "hamorb2", H5P_DEFAULT );
-      H5Dread( dataset2_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, hamorb2 );
-      H5Dclose( dataset2_id );
+      if ( H5Lexists( group_id, "done", H5P_DEFAULT ) > 0 ){
+         hid_t dataset1_id = H5Dopen( group_id, "done", H5P_DEFAULT );
+         H5Dread( dataset1_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, done );
+         H5Dclose( dataset1_id );
+      } else { // Checkpoint with the next orbital pair: the pairs before it are done
+         int hamorb1, hamorb2;
+         hid_t dataset1_id = H5Dopen( group_id, "hamorb1", H5P_DEFAULT );
+         H5Dread( dataset1_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &hamorb1 );
+         H5Dclose( dataset1_id );
+         hid_t dataset2_id = H5Dopen( group_id, "hamorb2", H5P_DEFAULT );
+         H5Dread( dataset2_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &hamorb2 );
+         H5Dclose( dataset2_id );
+         for ( int orb2 = 0; orb2 < LAS; orb2++ ){
+            for ( int orb1 = 0; orb1 < LAS; orb1++ ){
+               bool pair_done = false;
+               if ( orb1 == orb2 ){ pair_done = (( hamorb1 != hamorb2 ) || ( orb1 < hamorb1 )); }
+               if ( orb1 <  orb2 ){ pair_done = (( hamorb1 != hamorb2 ) && (( orb1 < hamorb1 ) || (( orb1 == hamorb1 ) && ( orb2 < hamorb2 )))); }
+               done[ orb1 + LAS * orb2 ] = (( pair_done ) ? 1 : 0 );
+            }
+         }
+      }
 
-      hid_t dataset3_id = H5Dopen( group_id, "contract", H5P_DEFAULT );
-      H5Dread( dataset3_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, contract );
+      hid_t dataset3_id   = H5Dopen( group_id, "contract", H5P_DEFAULT );
+      hid_t dataspace3_id = H5Dget_space( dataset3_id );
+      hsize_t dimarray3;
+      H5Sget_simple_extent_dims( dataspace3_id, &dimarray3, NULL );
+      if ( dimarray3 == ( hsize_t ) contract->get_array_size() ){
+         H5Dread( dataset3_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, contract->get_storage() );
+      } else { // Checkpoint with the dense contraction of size LAS^6
+         const long long LAS_pow6 = (( long long ) LAS ) * LAS * LAS * LAS * LAS * LAS;
+         assert( dimarray3 == ( hsize_t ) LAS_pow6 );
+         double * dense = new double[ LAS_pow6 ];
+         H5Dread( dataset3_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, dense );
+         contract->read_dense( dense );
+         delete [] dense;
+      }
+      H5Sclose( dataspace3_id );
       H5Dclose( dataset3_id );
 
       H5Gclose( group_id );
@@ -128,65 +152,98 @@ bool CheMPS2::CASSCF::read_f4rdm_checkpoint( const string f4rdm_file, int * hamo
 
    }
    #ifdef CHEMPS2_MPI_COMPILATION
-   MPIchemps2::broadcast_array_int( hamorb1, 1, MPI_CHEMPS2_MASTER );
-   MPIchemps2::broadcast_array_int( hamorb2, 1, MPI_CHEMPS2_MASTER );
-   MPIchemps2::broadcast_array_double( contract, tot_dmrg_power6, MPI_CHEMPS2_MASTER );
+   MPIchemps2::broadcast_array_int( done, LAS * LAS, MPI_CHEMPS2_MASTER );
+   contract->broadcast( MPI_CHEMPS2_MASTER );
    #endif
 
    return true; // Loaded
 
 }
 
-void CheMPS2::CASSCF::fock_dot_4rdm( double * fockmx, CheMPS2::DMRG * dmrgsolver, CheMPS2::Hamiltonian * ham, int next_orb1, int next_orb2, double * work, double * result, const bool CHECKPOINT, const bool PSEUDOCANONICAL ){
+void CheMPS2::CASSCF::fock_dot_4rdm( double * fockmx, CheMPS2::DMRG * dmrgsolver, CheMPS2::Hamiltonian * ham, const int * done, SixIndex * work, SixIndex * result, const bool CHECKPOINT, const bool PSEUDOCANONICAL ){
 
-   const int LAS = ham->getL();
-   int size      = LAS * LAS * LAS * LAS * LAS * LAS;
-   int inc1      = 1;
+   const int LAS        = ham->getL();
+   const long long size = result->get_array_size();
+   assert( work->get_array_size() == size );
 
-   for ( int diag = 0; diag < LAS; diag++ ){
-      if (( next_orb1 == diag ) && ( next_orb2 == diag )){
-         double prefactor = 0.5 * fockmx[ diag + LAS * diag ];
-         if ( fabs( prefactor ) > 0.0 ){
-            dmrgsolver->Symm4RDM( work, diag, diag, false );
-            daxpy_( &size, &prefactor, work, &inc1, result, &inc1 );
-         }
-         if ( diag == LAS - 1 ){
-            next_orb1 = 0;
-            next_orb2 = 1;
-         } else {
-            next_orb1 = diag + 1;
-            next_orb2 = diag + 1;
-         }
-         if ( CHECKPOINT ){ write_f4rdm_checkpoint( CheMPS2::DMRGSCF_f4rdm_name, &next_orb1, &next_orb2, size, result ); }
-      }
-   }
+   #ifdef CHEMPS2_MPI_COMPILATION
+      const int num_procs = MPIchemps2::mpi_size();
+      const int MPIRANK   = MPIchemps2::mpi_rank();
+   #else
+      const int num_procs = 1;
+      const int MPIRANK   = 0;
+   #endif
 
+   // The orbital pairs ( orb1 <= orb2 ) which remain: first the diagonal ones, then the others in row-major order
+   int * pair_done = new int[ LAS * LAS ];
+   for ( int cnt = 0; cnt < LAS * LAS; cnt++ ){ pair_done[ cnt ] = (( done == NULL ) ? 0 : done[ cnt ] ); }
+   std::vector< int > todo;
+   for ( int orb = 0; orb < LAS; orb++ ){
+      const int pair = orb + LAS * orb;
+      if (( pair_done[ pair ] == 0 ) && ( fabs( fockmx[ pair ] ) > 0.0 )){ todo.push_back( pair ); } else { pair_done[ pair ] = 1; }
+   }
    if ( PSEUDOCANONICAL == false ){
       for ( int orb1 = 0; orb1 < LAS; orb1++ ){
          for ( int orb2 = orb1 + 1; orb2 < LAS; orb2++ ){
-            if (( next_orb1 == orb1 ) && ( next_orb2 == orb2 )){
-               double prefactor = 0.5 * ( fockmx[ orb1 + LAS * orb2 ] + fockmx[ orb2 + LAS * orb1 ] );
-               if (( ham->getOrbitalIrrep( orb1 ) == ham->getOrbitalIrrep( orb2 ) ) && ( fabs( prefactor ) > 0.0 )){
-                  dmrgsolver->Symm4RDM( work, orb1, orb2, false );
-                  daxpy_( &size, &prefactor, work, &inc1, result, &inc1 );
-               }
-               if ( orb2 == LAS - 1 ){
-                  next_orb1 = next_orb1 + 1;
-                  next_orb2 = next_orb1 + 1;
-               } else {
-                  next_orb2 = next_orb2 + 1;
-               }
-               if (( ham->getOrbitalIrrep( orb1 ) == ham->getOrbitalIrrep( orb2 ) ) && ( CHECKPOINT )){
-                  write_f4rdm_checkpoint( CheMPS2::DMRGSCF_f4rdm_name, &next_orb1, &next_orb2, size, result );
-               }
+            const int pair = orb1 + LAS * orb2;
+            if (( pair_done[ pair ] == 0 ) && ( ham->getOrbitalIrrep( orb1 ) == ham->getOrbitalIrrep( orb2 ) ) && ( fabs( fockmx[ orb1 + LAS * orb2 ] + fockmx[ orb2 + LAS * orb1 ] ) > 0.0 )){
+               todo.push_back( pair );
+            } else {
+               pair_done[ pair ] = 1;
             }
          }
       }
    }
 
+   /* With MPI, each process takes one orbital pair per round on its own copy of the MPS, and the contractions
+      are added after the last round, or after each round when a checkpoint is made. The checkpoint records which
+      pairs are done, so that the remaining pairs can be distributed again over any number of processes. */
+   const int num_todo   = todo.size();
+   const int num_rounds = ( num_todo + num_procs - 1 ) / num_procs;
+   #ifdef CHEMPS2_MPI_COMPILATION
+   const bool local = (( num_procs > 1 ) && ( num_rounds > 0 ));
+   if ( local ){
+      dmrgsolver->setProcessLocal( true );
+      if ( MPIRANK != MPI_CHEMPS2_MASTER ){ result->clear(); } // The master keeps the partial contraction on entry
+   }
+   #endif
+
+   for ( int round = 0; round < num_rounds; round++ ){
+
+      const int index = round * num_procs + MPIRANK;
+      if ( index < num_todo ){
+         const int orb1 = todo[ index ] % LAS;
+         const int orb2 = todo[ index ] / LAS;
+         const double prefactor = 0.5 * (( orb1 == orb2 ) ? fockmx[ orb1 + LAS * orb1 ] : ( fockmx[ orb1 + LAS * orb2 ] + fockmx[ orb2 + LAS * orb1 ] ));
+         dmrgsolver->Symm4RDM( work, orb1, orb2, false );
+         Special::daxpy64( size, prefactor, work->get_storage(), result->get_storage() );
+      }
+
+      const bool last_round = ( round == num_rounds - 1 );
+      if (( CHECKPOINT ) || ( last_round )){
+         #ifdef CHEMPS2_MPI_COMPILATION
+         if ( local ){
+            dmrgsolver->setProcessLocal( false );
+            Special::dcopy64( size, result->get_storage(), work->get_storage() );
+            MPIchemps2::allreduce_array_double( work->get_storage(), result->get_storage(), size );
+         }
+         #endif
+         for ( int cnt = 0; cnt < ( round + 1 ) * num_procs && cnt < num_todo; cnt++ ){ pair_done[ todo[ cnt ] ] = 1; }
+         if ( CHECKPOINT ){ write_f4rdm_checkpoint( CheMPS2::DMRGSCF_f4rdm_name, LAS, pair_done, result ); }
+         #ifdef CHEMPS2_MPI_COMPILATION
+         if (( local ) && ( last_round == false )){
+            dmrgsolver->setProcessLocal( true );
+            if ( MPIRANK != MPI_CHEMPS2_MASTER ){ result->clear(); }
+         }
+         #endif
+      }
+   }
+
+   delete [] pair_done;
+
 }
 
-double CheMPS2::CASSCF::caspt2( const int Nelectrons, const int TwoS, const int Irrep, ConvergenceScheme * OptScheme, const int rootNum, DMRGSCFoptions * scf_options, const double IPEA, const double IMAG, const bool PSEUDOCANONICAL, const bool CHECKPOINT, const bool CUMULANT ){
+double CheMPS2::CASSCF::caspt2( const int Nelectrons, const int TwoS, const int Irrep, ConvergenceScheme * OptScheme, const int rootNum, DMRGSCFoptions * scf_options, const double IPEA, const double IMAG, const bool PSEUDOCANONICAL, const bool CHECKPOINT, const bool CUMULANT, const int NUM_SCAN, const double * SCAN_IMAG, const double * SCAN_REAL, double * SCAN_E2 ){
 
    #ifdef CHEMPS2_MPI_COMPILATION
       const bool am_i_master = ( MPIchemps2::mpi_rank() == MPI_CHEMPS2_MASTER );
@@ -201,6 +258,7 @@ double CheMPS2::CASSCF::caspt2( const int Nelectrons, const int TwoS, const int
       if ( am_i_master ){
          cout << "CheMPS2::CASSCF::caspt2 : There are no CASPT2 excitations between the CORE, ACTIVE, and VIRTUAL orbital spaces." << endl;
       }
+      for ( int scan = 0; scan < NUM_SCAN; scan++ ){ SCAN_E2[ scan ] = 0.0; }
       return 0.0;
    }
 
@@ -213,9 +271,8 @@ double CheMPS2::CASSCF::caspt2( const int Nelectrons, const int TwoS, const int
    DMRGSCFintegrals * theRotatedTEI = new DMRGSCFintegrals( iHandler );
    const int temp_work_size = (( fullsize > CheMPS2::DMRGSCF_max_mem_eri_tfo ) ? CheMPS2::DMRGSCF_max_mem_eri_tfo : fullsize );
    const int work_mem_size  = max( max( temp_work_size , maxlinsize * maxlinsize * 4 ) , dmrgsize_power4 );
-   const int tot_dmrg_power6 = dmrgsize_power4 * nOrbDMRG * nOrbDMRG;
    double * mem1 = new double[ work_mem_size ];
-   double * mem2 = new double[ ( PSEUDOCANONICAL ) ? work_mem_size : max( work_mem_size, tot_dmrg_power6 ) ];
+   double * mem2 = new double[ work_mem_size ];
 
    // If you did not run CheMPS2::CASSCF::solve, you NEED to load the unitary from disk
    if ( successful_solve == false ){
@@ -273,55 +330,67 @@ double CheMPS2::CASSCF::caspt2( const int Nelectrons, const int TwoS, const int
    }
 
    double E_CASSCF = 0.0;
-   double * three_dm = new double[ tot_dmrg_power6 ];
-   double * contract = new double[ tot_dmrg_power6 ];
-   for ( int cnt = 0; cnt < tot_dmrg_power6; cnt++ ){ contract[ cnt ] = 0.0; }
+   SixIndex * three_dm = new SixIndex( nOrbDMRG, iHandler->getIrrepOfEachDMRGorbital() );
+   SixIndex * contract = new SixIndex( nOrbDMRG, iHandler->getIrrepOfEachDMRGorbital() );
 
-   int next_hamorb1 = 0;
-   int next_hamorb2 = 0;
+   int * f4rdm_done = new int[ nOrbDMRG * nOrbDMRG ];
+   for ( int cnt = 0; cnt < nOrbDMRG * nOrbDMRG; cnt++ ){ f4rdm_done[ cnt ] = 0; }
    const bool make_checkpt = (( CUMULANT == false ) && ( CHECKPOINT ));
    bool checkpt_loaded = false;
    if ( make_checkpt ){
       assert(( OptScheme != NULL ) || ( rootNum > 1 ));
-      checkpt_loaded = read_f4rdm_checkpoint( CheMPS2::DMRGSCF_f4rdm_name, &next_hamorb1, &next_hamorb2, tot_dmrg_power6, contract );
+      checkpt_loaded = read_f4rdm_checkpoint( CheMPS2::DMRGSCF_f4rdm_name, nOrbDMRG, f4rdm_done, contract );
    }
 
    // Solve the active space problem
    if (( OptScheme == NULL ) && ( rootNum == 1 )){ // Do FCI
 
+      CheMPS2::FCI * theFCI = NULL;
+      double * inoutput = NULL;
+      double * dense_3dm = NULL; // The FCI solver works with the dense LAS^6 arrays
+      const long long tot_dmrg_power6 = (( long long ) dmrgsize_power4 ) * nOrbDMRG * nOrbDMRG;
       if ( am_i_master ){
          const int nalpha = ( num_elec + TwoS ) / 2;
          const int nbeta  = ( num_elec - TwoS ) / 2;
          const double workmem = 1000.0; // 1GB
          const int verbose = 2;
-         CheMPS2::FCI * theFCI = new CheMPS2::FCI( HamAS, nalpha, nbeta, Irrep, workmem, verbose );
-         double * inoutput = new double[ theFCI->getVecLength(0) ];
+         theFCI = new CheMPS2::FCI( HamAS, nalpha, nbeta, Irrep, workmem, verbose );
+         inoutput = new double[ theFCI->getVecLength(0) ];
          theFCI->ClearVector( theFCI->getVecLength(0), inoutput );
          inoutput[ theFCI->LowestEnergyDeterminant() ] = 1.0;
          E_CASSCF = theFCI->GSDavidson( inoutput );
          theFCI->Fill2RDM( inoutput, DMRG2DM );                     // 2-RDM
-         theFCI->Fill3RDM( inoutput, three_dm );                    // 3-RDM
-         setDMRG1DM( num_elec, nOrbDMRG, DMRG1DM, DMRG2DM );        // 1-RDM
-         buildQmatACT();
-         construct_fock( theFmatrix, theTmatrix, theQmatOCC, theQmatACT, iHandler );
-         copy_active( theFmatrix, mem2, iHandler );                 // Fock
-         theFCI->Fock4RDM( inoutput, three_dm, mem2, contract );    // trace( Fock * 4-RDM )
-         delete theFCI;
-         delete [] inoutput;
+         dense_3dm = new double[ tot_dmrg_power6 ];
+         theFCI->Fill3RDM( inoutput, dense_3dm );                   // 3-RDM
       }
       #ifdef CHEMPS2_MPI_COMPILATION
       MPIchemps2::broadcast_array_double( &E_CASSCF, 1, MPI_CHEMPS2_MASTER );
       MPIchemps2::broadcast_array_double(  DMRG2DM, dmrgsize_power4, MPI_CHEMPS2_MASTER );
-      MPIchemps2::broadcast_array_double( three_dm, tot_dmrg_power6, MPI_CHEMPS2_MASTER );
-      MPIchemps2::broadcast_array_double( contract, tot_dmrg_power6, MPI_CHEMPS2_MASTER );
-      setDMRG1DM( num_elec, nOrbDMRG, DMRG1DM, DMRG2DM );
+      #endif
+      setDMRG1DM( num_elec, nOrbDMRG, DMRG1DM, DMRG2DM );           // 1-RDM; broadcasts, hence on all processes
+      buildQmatACT();
+      construct_fock( theFmatrix, theTmatrix, theQmatOCC, theQmatACT, iHandler );
+      copy_active( theFmatrix, mem2, iHandler );                    // Fock
+      if ( am_i_master ){
+         double * dense_contract = new double[ tot_dmrg_power6 ];
+         theFCI->Fock4RDM( inoutput, dense_3dm, mem2, dense_contract ); // trace( Fock * 4-RDM )
+         three_dm->read_dense( dense_3dm );
+         contract->read_dense( dense_contract );
+         delete [] dense_contract;
+         delete [] dense_3dm;
+         delete theFCI;
+         delete [] inoutput;
+      }
+      #ifdef CHEMPS2_MPI_COMPILATION
+      three_dm->broadcast( MPI_CHEMPS2_MASTER );
+      contract->broadcast( MPI_CHEMPS2_MASTER );
       #endif
 
    } else { // Do the DMRG sweeps
 
       assert( OptScheme != NULL );
       for ( int cnt = 0; cnt < dmrgsize_power4; cnt++ ){ DMRG2DM[ cnt ] = 0.0; } // Clear the 2-RDM
-      CheMPS2::DMRG * theDMRG = new DMRG( Prob, OptScheme, make_checkpt, tmp_folder );
+      CheMPS2::DMRG * theDMRG = new DMRG( Prob, OptScheme, make_checkpt, tmp_folder, mem_budget, storage, deflate_level, lossy_digits );
       for ( int state = 0; state < rootNum; state++ ){
          if ( state > 0 ){ theDMRG->newExcitation( fabs( E_CASSCF ) ); }
          if ( checkpt_loaded == false ){ E_CASSCF = theDMRG->Solve(); }
@@ -336,17 +405,18 @@ double CheMPS2::CASSCF::caspt2( const int Nelectrons, const int TwoS, const int
       if ( CUMULANT ){
          CheMPS2::Cumulant::gamma4_fock_contract_ham( Prob, theDMRG->get3DM(), theDMRG->get2DM(), mem2, contract );
       } else {
-         fock_dot_4rdm( mem2, theDMRG, HamAS, next_hamorb1, next_hamorb2, three_dm, contract, make_checkpt, PSEUDOCANONICAL );
+         fock_dot_4rdm( mem2, theDMRG, HamAS, f4rdm_done, three_dm, contract, make_checkpt, PSEUDOCANONICAL ); // three_dm as workspace
       }
-      theDMRG->get3DM()->fill_ham_index( 1.0, false, three_dm, 0, nOrbDMRG );
+      theDMRG->get3DM()->fill_ham_index( 1.0, false, three_dm );
       if (( CheMPS2::DMRG_storeMpsOnDisk ) && ( make_checkpt == false )){ theDMRG->deleteStoredMPS(); }
-      if ( CheMPS2::DMRG_storeRenormOptrOnDisk ){ theDMRG->deleteStoredOperators(); }
+      theDMRG->deleteStoredOperators();
       delete theDMRG;
 
    }
 
    delete Prob;
    delete HamAS;
+   delete [] f4rdm_done;
 
    if ( PSEUDOCANONICAL == false ){
       if ( am_i_master ){ cout << "CASPT2 : Deviation from pseudocanonical = " << deviation_from_blockdiag( theFmatrix, iHandler ) << endl; }
@@ -373,19 +443,39 @@ double CheMPS2::CASSCF::caspt2( const int Nelectrons, const int TwoS, const int
    double E_CASPT2 = 0.0;
    if ( am_i_master ){
       cout << "CASPT2 : Deviation from pseudocanonical = " << deviation_from_blockdiag( theFmatrix, iHandler ) << endl;
-      CheMPS2::CASPT2 * myCASPT2 = new CheMPS2::CASPT2( iHandler, theRotatedTEI, theTmatrix, theFmatrix, DMRG1DM, DMRG2DM, three_dm, contract, IPEA );
+      CheMPS2::CASPT2 * myCASPT2 = new CheMPS2::CASPT2( iHandler, theRotatedTEI, theTmatrix, theFmatrix, DMRG1DM, DMRG2DM, three_dm, contract, IPEA, (( scf_options->getCASPT2OutOfCore() ) ? tmp_folder : "" ));
       delete theRotatedTEI;
-      delete [] three_dm;
-      delete [] contract;
-      E_CASPT2 = myCASPT2->solve( IMAG );
+      delete three_dm;
+      delete contract;
+      if ( NUM_SCAN > 0 ){
+         // Shift 0 is the requested imaginary shift; the scanned shifts share its subspace
+         double * imag_shifts = new double[ NUM_SCAN + 1 ];
+         double * real_shifts = new double[ NUM_SCAN + 1 ];
+         double * energies    = new double[ NUM_SCAN + 1 ];
+         imag_shifts[ 0 ] = IMAG;
+         real_shifts[ 0 ] = 0.0;
+         for ( int scan = 0; scan < NUM_SCAN; scan++ ){
+            imag_shifts[ 1 + scan ] = SCAN_IMAG[ scan ];
+            real_shifts[ 1 + scan ] = SCAN_REAL[ scan ];
+         }
+         myCASPT2->solve_shifts( NUM_SCAN + 1, imag_shifts, real_shifts, energies );
+         E_CASPT2 = energies[ 0 ];
+         for ( int scan = 0; scan < NUM_SCAN; scan++ ){ SCAN_E2[ scan ] = energies[ 1 + scan ]; }
+         delete [] imag_shifts;
+         delete [] real_shifts;
+         delete [] energies;
+      } else {
+         E_CASPT2 = myCASPT2->solve( IMAG );
+      }
       delete myCASPT2;
    } else {
       delete theRotatedTEI;
-      delete [] three_dm;
-      delete [] contract;
+      delete three_dm;
+      delete contract;
    }
    #ifdef CHEMPS2_MPI_COMPILATION
    MPIchemps2::broadcast_array_double( &E_CASPT2, 1, MPI_CHEMPS2_MASTER );
+   if ( NUM_SCAN > 0 ){ MPIchemps2::broadcast_array_double( SCAN_E2, NUM_SCAN, MPI_CHEMPS2_MASTER ); }
    #endif
 
    return E_CASPT2;
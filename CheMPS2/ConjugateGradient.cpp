@@ -22,13 +22,15 @@
 #include <iostream>
 
 #include "ConjugateGradient.h"
+#include "MmapVector.h"
 
 using std::cout;
 using std::endl;
 
-CheMPS2::ConjugateGradient::ConjugateGradient( const int veclength_in, const double RTOL_in, const double DIAG_CUTOFF_in, const bool print_in ){
+CheMPS2::ConjugateGradient::ConjugateGradient( const long long veclength_in, const double RTOL_in, const double DIAG_CUTOFF_in, const bool print_in, const std::string scratch_in ){
 
    veclength = veclength_in;
+   scratch = scratch_in;
    RTOL = RTOL_in;
    DIAG_CUTOFF = DIAG_CUTOFF_in;
    print = print_in;
@@ -36,25 +38,25 @@ CheMPS2::ConjugateGradient::ConjugateGradient( const int veclength_in, const dou
    state = 'I';
    num_matvec = 0;
 
-   XVEC   = new double[ veclength ];
-   PRECON = new double[ veclength ];
-   RHS    = new double[ veclength ];
-   WORK   = new double[ veclength ];
-   RESID  = new double[ veclength ];
-   PVEC   = new double[ veclength ];
-   OPVEC  = new double[ veclength ];
+   XVEC   = MmapVector::allocate( veclength, scratch );
+   PRECON = MmapVector::allocate( veclength, scratch );
+   RHS    = MmapVector::allocate( veclength, scratch );
+   WORK   = MmapVector::allocate( veclength, scratch );
+   RESID  = MmapVector::allocate( veclength, scratch );
+   PVEC   = MmapVector::allocate( veclength, scratch );
+   OPVEC  = MmapVector::allocate( veclength, scratch );
 
 }
 
 CheMPS2::ConjugateGradient::~ConjugateGradient(){
 
-   delete [] XVEC;
-   delete [] PRECON;
-   delete [] RHS;
-   delete [] WORK;
-   delete [] RESID;
-   delete [] PVEC;
-   delete [] OPVEC;
+   MmapVector::release( XVEC,   veclength, scratch );
+   MmapVector::release( PRECON, veclength, scratch );
+   MmapVector::release( RHS,    veclength, scratch );
+   MmapVector::release( WORK,   veclength, scratch );
+   MmapVector::release( RESID,  veclength, scratch );
+   MmapVector::release( PVEC,   veclength, scratch );
+   MmapVector::release( OPVEC,  veclength, scratch );
 
 }
 
@@ -145,15 +147,15 @@ void CheMPS2::ConjugateGradient::stepL2K(){
 
    apply_precon( OPVEC );                                    // OPVEC_old = ( PRECON * operator * PRECON ) * PVEC_old
    const double alpha = rdotr / inprod( PVEC, OPVEC );       // alpha = RESID_old^T * RESID_old / ( PVEC_old^T * ( PRECON * operator * PRECON ) * PVEC_old )
-   for ( int elem = 0; elem < veclength; elem++ ){
+   for ( long long elem = 0; elem < veclength; elem++ ){
       XVEC[ elem ] = XVEC[ elem ] + alpha * PVEC[ elem ];    // XVEC_new <-- XVEC_old + alpha * PVEC_old
    }
-   for ( int elem = 0; elem < veclength; elem++ ){
+   for ( long long elem = 0; elem < veclength; elem++ ){
       RESID[ elem ] = RESID[ elem ] - alpha * OPVEC[ elem ]; // RESID_new <-- RESID_old - alpha * ( PRECON * operator * PRECON ) * PVEC_old
    }
    const double new_rdotr = inprod( RESID );
    const double beta = new_rdotr / rdotr;                    // beta = RESID_new^T * RESID_new / ( RESID_old^T * RESID_old )
-   for ( int elem = 0; elem < veclength; elem++ ){
+   for ( long long elem = 0; elem < veclength; elem++ ){
       PVEC[ elem ] = RESID[ elem ] + beta * PVEC[ elem ];    // PVEC_new = RESID_new + beta * PVEC_old
    }
    rdotr = new_rdotr;
@@ -165,7 +167,7 @@ void CheMPS2::ConjugateGradient::stepL2K(){
 void CheMPS2::ConjugateGradient::stepY2Z(){
 
    rnorm = 0.0;
-   for ( int elem = 0; elem < veclength; elem++ ){
+   for ( long long elem = 0; elem < veclength; elem++ ){
       const double diff = OPVEC[ elem ] - RHS[ elem ];
       rnorm += diff * diff;
    }
@@ -177,10 +179,10 @@ void CheMPS2::ConjugateGradient::stepY2Z(){
 void CheMPS2::ConjugateGradient::stepJ2K(){
 
    apply_precon( OPVEC );                            // OPVEC = ( PRECON * operator * PRECON ) * XVEC
-   for ( int elem = 0; elem < veclength; elem++ ){
+   for ( long long elem = 0; elem < veclength; elem++ ){
       RESID[ elem ] = RESID[ elem ] - OPVEC[ elem ]; // RESID = ( precon * RHS ) - ( precon * operator * precon ) * XVEC
    }
-   for ( int elem = 0; elem < veclength; elem++ ){
+   for ( long long elem = 0; elem < veclength; elem++ ){
       PVEC[ elem ] = RESID[ elem ];                  // PVEC = RESID
    }
    rdotr = inprod( RESID );
@@ -191,7 +193,7 @@ void CheMPS2::ConjugateGradient::stepJ2K(){
 void CheMPS2::ConjugateGradient::stepG2H(){
 
    // PRECON = 1 / sqrt( diag ( operator ) )
-   for ( int elem = 0; elem < veclength; elem++ ){
+   for ( long long elem = 0; elem < veclength; elem++ ){
       if ( PRECON[ elem ] < DIAG_CUTOFF ){ PRECON[ elem ] = DIAG_CUTOFF; }
       PRECON[ elem ] = 1.0 / sqrt( PRECON[ elem ] );
    }
@@ -200,7 +202,7 @@ void CheMPS2::ConjugateGradient::stepG2H(){
    apply_precon( RHS, RESID );
 
    // XVEC = guess / PRECON
-   for ( int elem = 0; elem < veclength; elem++ ){
+   for ( long long elem = 0; elem < veclength; elem++ ){
       XVEC[ elem ] = XVEC[ elem ] / PRECON[ elem ];
    }
 
@@ -209,7 +211,7 @@ void CheMPS2::ConjugateGradient::stepG2H(){
 double CheMPS2::ConjugateGradient::inprod( double * vector ){
 
    double inproduct = 0.0;
-   for ( int elem = 0; elem < veclength; elem++ ){
+   for ( long long elem = 0; elem < veclength; elem++ ){
       inproduct += vector[ elem ] * vector[ elem ];
    }
    return inproduct;
@@ -219,7 +221,7 @@ double CheMPS2::ConjugateGradient::inprod( double * vector ){
 double CheMPS2::ConjugateGradient::inprod( double * vector, double * othervector ){
 
    double inproduct = 0.0;
-   for ( int elem = 0; elem < veclength; elem++ ){
+   for ( long long elem = 0; elem < veclength; elem++ ){
       inproduct += vector[ elem ] * othervector[ elem ];
    }
    return inproduct;
@@ -228,7 +230,7 @@ double CheMPS2::ConjugateGradient::inprod( double * vector, double * othervector
 
 void CheMPS2::ConjugateGradient::apply_precon( double * vector ){
 
-   for ( int elem = 0; elem < veclength; elem++ ){
+   for ( long long elem = 0; elem < veclength; elem++ ){
       vector[ elem ] = PRECON[ elem ] * vector[ elem ];
    }
 
@@ -236,7 +238,7 @@ void CheMPS2::ConjugateGradient::apply_precon( double * vector ){
 
 void CheMPS2::ConjugateGradient::apply_precon( double * vector, double * result ){
 
-   for ( int elem = 0; elem < veclength; elem++ ){
+   for ( long long elem = 0; elem < veclength; elem++ ){
       result[ elem ] = PRECON[ elem ] * vector[ elem ];
    }
 
@@ -32,6 +32,16 @@ CheMPS2::ConvergenceScheme::ConvergenceScheme( const int num_instructions ){
    num_max_sweeps     = new    int[ num_instructions ];
    noise_prefac       = new double[ num_instructions ];
    dvdson_rtol        = new double[ num_instructions ];
+   one_site_sweeps    = new   bool[ num_instructions ];
+   expansion_prefac   = new double[ num_instructions ];
+   max_disc_weight    = new double[ num_instructions ];
+   num_D_min          = new    int[ num_instructions ];
+   for ( int instruction = 0; instruction < num_instructions; instruction++ ){
+      one_site_sweeps [ instruction ] = false;
+      expansion_prefac[ instruction ] = CheMPS2::DMRG_expansion_prefactor;
+      max_disc_weight [ instruction ] = 0.0;
+      num_D_min       [ instruction ] = 1;
+   }
 
 }
 
@@ -42,6 +52,10 @@ CheMPS2::ConvergenceScheme::~ConvergenceScheme(){
    delete [] num_max_sweeps;
    delete [] noise_prefac;
    delete [] dvdson_rtol;
+   delete [] one_site_sweeps;
+   delete [] expansion_prefac;
+   delete [] max_disc_weight;
+   delete [] num_D_min;
 
 }
 
@@ -64,6 +78,29 @@ void CheMPS2::ConvergenceScheme::set_instruction( const int instruction, const i
 
 }
 
+void CheMPS2::ConvergenceScheme::set_one_site( const int instruction, const bool one_site, const double expansion_prefactor ){
+
+   assert( instruction >= 0 );
+   assert( instruction < num_instructions );
+   assert( expansion_prefactor >= 0.0 );
+
+    one_site_sweeps[ instruction ] = one_site;
+   expansion_prefac[ instruction ] = expansion_prefactor;
+
+}
+
+void CheMPS2::ConvergenceScheme::set_truncation( const int instruction, const double max_discarded_weight, const int D_min ){
+
+   assert( instruction >= 0 );
+   assert( instruction < num_instructions );
+   assert( max_discarded_weight >= 0.0 );
+   assert( D_min > 0 );
+
+   max_disc_weight[ instruction ] = max_discarded_weight;
+         num_D_min[ instruction ] = D_min;
+
+}
+
 int CheMPS2::ConvergenceScheme::get_D( const int instruction ) const{ return num_D[ instruction ]; }
 
 double CheMPS2::ConvergenceScheme::get_energy_conv( const int instruction ) const{ return energy_convergence[ instruction ]; }
@@ -74,4 +111,12 @@ double CheMPS2::ConvergenceScheme::get_noise_prefactor( const int instruction )
 
 double CheMPS2::ConvergenceScheme::get_dvdson_rtol( const int instruction ) const{ return dvdson_rtol[ instruction ]; }
 
+bool CheMPS2::ConvergenceScheme::get_one_site( const int instruction ) const{ return one_site_sweeps[ instruction ]; }
+
+double CheMPS2::ConvergenceScheme::get_expansion_prefactor( const int instruction ) const{ return expansion_prefac[ instruction ]; }
+
+double CheMPS2::ConvergenceScheme::get_max_discarded_weight( const int instruction ) const{ return max_disc_weight[ instruction ]; }
+
+int CheMPS2::ConvergenceScheme::get_D_min( const int instruction ) const{ return num_D_min[ instruction ]; }
+
 
@@ -18,6 +18,7 @@
 */
 
 #include <stdlib.h>
+#include <assert.h>
 #include <sys/time.h>
 #include <unistd.h>
 #include <iostream>
@@ -81,14 +82,15 @@
 
 }*/
 
-void CheMPS2::Cumulant::gamma4_fock_contract_ham(const Problem * prob, const ThreeDM * the3DM, const TwoDM * the2DM, double * fock, double * result){
+void CheMPS2::Cumulant::gamma4_fock_contract_ham(const Problem * prob, const ThreeDM * the3DM, const TwoDM * the2DM, double * fock, SixIndex * result){
 
    struct timeval start, end;
    gettimeofday(&start, NULL);
    const int L = prob->gL();
+   assert( result->get_L() == L );
    
    /* Clear result */
-   for ( int cnt = 0; cnt < L*L*L*L*L*L; cnt++ ){ result[ cnt ] = 0.0; }
+   result->clear();
    
    /* Construct an array with the orbital irreps in Hamiltonian indices */
    int * irreps = new int[ L ];
@@ -333,18 +335,8 @@ void CheMPS2::Cumulant::gamma4_fock_contract_ham(const Problem * prob, const Thr
                                                   - lambda2_part1
                                                   + lambda2_part2 / 1.5 );
                               
-                        result[ i + L * ( j + L * ( k + L * ( p + L * ( q + L * r )))) ] = contracted_value;
-                        result[ i + L * ( k + L * ( j + L * ( p + L * ( r + L * q )))) ] = contracted_value;
-                        result[ j + L * ( i + L * ( k + L * ( q + L * ( p + L * r )))) ] = contracted_value;
-                        result[ k + L * ( i + L * ( j + L * ( r + L * ( p + L * q )))) ] = contracted_value;
-                        result[ j + L * ( k + L * ( i + L * ( q + L * ( r + L * p )))) ] = contracted_value;
-                        result[ k + L * ( j + L * ( i + L * ( r + L * ( q + L * p )))) ] = contracted_value;
-                        result[ p + L * ( q + L * ( r + L * ( i + L * ( j + L * k )))) ] = contracted_value;
-                        result[ p + L * ( r + L * ( q + L * ( i + L * ( k + L * j )))) ] = contracted_value;
-                        result[ q + L * ( p + L * ( r + L * ( j + L * ( i + L * k )))) ] = contracted_value;
-                        result[ r + L * ( p + L * ( q + L * ( k + L * ( i + L * j )))) ] = contracted_value;
-                        result[ q + L * ( r + L * ( p + L * ( j + L * ( k + L * i )))) ] = contracted_value;
-                        result[ r + L * ( q + L * ( p + L * ( k + L * ( j + L * i )))) ] = contracted_value;
+                        result->set( i, j, k, p, q, r, contracted_value ); // And the permutations of the orbital pairs
+                        result->set( p, q, r, i, j, k, contracted_value ); // And the permutations of the orbital pairs of the transpose
                      }
                   }
                }
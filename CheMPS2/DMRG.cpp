@@ -22,18 +22,23 @@
 #include <iostream>
 #include <string.h>
 #include <sstream>
+#include <algorithm>
 #include <sys/stat.h>
 #include <sys/time.h>
 #include <assert.h>
 #include <unistd.h>
 
 #include "DMRG.h"
+#include "Lapack.h"
+#include "OperatorStorageHDF5.h"
+#include "OperatorStorageMmap.h"
 #include "MPIchemps2.h"
+#include "Special.h"
 
 using std::cout;
 using std::endl;
 
-CheMPS2::DMRG::DMRG( Problem * ProbIn, ConvergenceScheme * OptSchemeIn, const bool makechkpt, const string tmpfolder ){
+CheMPS2::DMRG::DMRG( Problem * ProbIn, ConvergenceScheme * OptSchemeIn, const bool makechkpt, const string tmpfolder, const double mem_budget, const char storage, const int deflate_level, const int lossy_digits ){
 
    #ifdef CHEMPS2_MPI_COMPILATION
       if ( MPIchemps2::mpi_rank() == MPI_CHEMPS2_MASTER ){ PrintLicense(); }
@@ -85,16 +90,57 @@ CheMPS2::DMRG::DMRG( Problem * ProbIn, ConvergenceScheme * OptSchemeIn, const bo
    for ( int timecnt = 0; timecnt < CHEMPS2_TIME_VECLENGTH; timecnt++ ){ timings[ timecnt ] = 0.0; }
    num_double_write_disk = 0;
    num_double_read_disk  = 0;
+   num_byte_write_file   = 0;
+   io_busy       = false;
+   io_threaded   = false;
+   io_store      = new int[ L - 1 ];
+   workspace     = new Workspace();
+   io_num_store  = 0;
+   io_load_index = -1;
+   op_budget     = ( mem_budget < 0.0 ) ? -1 : (( long long )( mem_budget * 1048576 / sizeof(double) ));
+   op_resident   = 0;
+   op_size       = new long long[ L - 1 ];
+   op_on_disk    = new int[ L - 1 ];
+   op_last_use   = new int[ L - 1 ];
+   op_clock      = 0;
+   op_files      = false;
+   assert(( storage == 'H' ) || ( storage == 'M' ));
+   if ( storage == 'M' ){ op_storage = new OperatorStorageMmap(); }
+   else {                 op_storage = new OperatorStorageHDF5( deflate_level, lossy_digits ); }
+   for ( int cnt = 0; cnt < L - 1; cnt++ ){
+      op_size[ cnt ]     = 0;
+      op_on_disk[ cnt ]  = 0;
+      op_last_use[ cnt ] = 0;
+   }
+   DiscWeightBonds   = new double[ L + 1 ];
+   SiteEnergies      = new double[ L ];
+   SiteEnergyChanges = new double[ L ];
    
    the2DM  = NULL;
    the3DM  = NULL;
    theCorr = NULL;
    Exc_activated = false;
+   SA_num_roots   = 1;
+   SA_center_site = L - 1;
+   SA_energies    = NULL;
+   SA_centers     = NULL;
+   SA_backup      = NULL;
    makecheckpoints = makechkpt;
    tempfolder = tmpfolder;
+   pos_instruction = -1;
+   resume_pending  = false;
+   ckpt_interval   = CheMPS2::DMRG_RESTART_interval;
+   dvdson_distribute = CheMPS2::DAVIDSON_MPI_DISTRIBUTE_size;
+   ckpt_generation = 0;
+   ckpt_files      = false;
+   ckpt_last       = 0.0;
+   balance            = new MPIbalance( L, MPIchemps2::mpi_size() );
+   ImbalanceLastSweep = 1.0;
+   MPIbalance::activate( balance ); // Round-robin until PreSolve() or the checkpoint assigns the operators
    
    setupBookkeeperAndMPS();
-   PreSolve();
+   ham_fingerprint = hamiltonian_fingerprint();
+   if ( resume_checkpoint() == false ){ PreSolve(); }
 
 }
 
@@ -145,7 +191,9 @@ CheMPS2::DMRG::~DMRG(){
    if ( the3DM  != NULL ){ delete the3DM;  }
    if ( theCorr != NULL ){ delete theCorr; }
 
+   MPIbalance::activate( balance );
    deleteAllBoundaryOperators();
+   delete balance;
 
    delete [] Ltensors;
    delete [] F0tensors;
@@ -159,6 +207,15 @@ CheMPS2::DMRG::~DMRG(){
    delete [] Qtensors;
    delete [] Xtensors;
    delete [] isAllocated;
+   delete [] io_store;
+   delete workspace;
+   delete [] op_size;
+   delete [] op_on_disk;
+   delete [] op_last_use;
+   delete op_storage;
+   delete [] DiscWeightBonds;
+   delete [] SiteEnergies;
+   delete [] SiteEnergyChanges;
 
    for ( int site = 0; site < L; site++ ){ delete MPS[ site ]; }
    delete [] MPS;
@@ -181,23 +238,67 @@ CheMPS2::DMRG::~DMRG(){
       delete [] Exc_Overlaps;
    }
 
+   if ( SA_num_roots > 1 ){
+      delete_sa_backup();
+      for ( int root = 1; root < SA_num_roots; root++ ){ delete SA_centers[ root ]; }
+      delete [] SA_centers;
+      delete [] SA_energies;
+   }
+
    delete denBK;
 
 }
 
 void CheMPS2::DMRG::PreSolve(){
 
+   MPIbalance::activate( balance );
+   discard_checkpoint();
    deleteAllBoundaryOperators();
+   balance->assign( denBK ); // No renormalized operators exist
+   ham_fingerprint = hamiltonian_fingerprint();
 
    for ( int cnt = 0; cnt < L - 2; cnt++ ){ updateMovingRightSafeFirstTime( cnt ); }
+   io_sync();
 
    TotalMinEnergy = 1e8;
    MaxDiscWeightLastSweep = 0.0;
+   for ( int bound = 0; bound <= L; bound++ ){ DiscWeightBonds[ bound ] = 0.0; }
+   for ( int site = 0; site < L; site++ ){
+      SiteEnergies[ site ]      = 0.0;
+      SiteEnergyChanges[ site ] = 1.0; // Not optimized yet: loosest adaptive Davidson tolerance
+   }
+   NumMatvecLastSweep   = 0;
+   NumMatvecInstruction = 0;
+
+}
+
+void CheMPS2::DMRG::warmStart( ConvergenceScheme * OptSchemeIn ){
+
+   assert( Exc_activated == false );
+   assert( OptSchemeIn != NULL );
+   MPIbalance::activate( balance );
+
+   if ( SA_backup != NULL ){ // Put root 0 back in the MPS after selectRoot()
+      for ( int site = 0; site < L; site++ ){
+         Special::dcopy64( MPS[ site ]->gKappa2index( MPS[ site ]->gNKappa() ), SA_backup[ site ]->gStorage(), MPS[ site ]->gStorage() );
+      }
+      delete_sa_backup();
+   }
+
+   if ( the2DM  != NULL ){ delete the2DM;  the2DM  = NULL; }
+   if ( the3DM  != NULL ){ delete the3DM;  the3DM  = NULL; }
+   if ( theCorr != NULL ){ delete theCorr; theCorr = NULL; }
+
+   OptScheme = OptSchemeIn;
+   Prob->construct_mxelem();
+   PreSolve(); // The MPS is left-normalized up to site L - 2 after Solve(), calc_rdms_and_correlations(), and the restore of root 0
 
 }
 
 double CheMPS2::DMRG::Solve(){
 
+   if (( resume_pending ) && (( SA_num_roots > 1 ) || ( Exc_activated ) || ( pos_instruction >= OptScheme->get_number() ))){ PreSolve(); } // The checkpoint does not belong to this calculation
+
    bool change = ( TotalMinEnergy < 1e8 ) ? true : false; // 1 sweep from right to left: fixed virtual dimensions
 
    double Energy = 0.0;
@@ -208,44 +309,85 @@ double CheMPS2::DMRG::Solve(){
       const bool am_i_master = true;
    #endif
 
-   for ( int instruction = 0; instruction < OptScheme->get_number(); instruction++ ){
+   MPIbalance::activate( balance );
+   if ( SA_backup != NULL ){ // Restore root 0 and the renormalized operators after selectRoot()
+      selectRoot( 0 );
+      delete_sa_backup();
+   }
+
+   struct timeval start, end;
+   gettimeofday( &start, NULL );
+   ckpt_last = start.tv_sec + 1e-6 * start.tv_usec;
+
+   for ( int instruction = (( resume_pending ) ? pos_instruction : 0 ); instruction < OptScheme->get_number(); instruction++ ){
 
       int nIterations = 0;
+      if ( resume_pending == false ){ NumMatvecInstruction = 0; }
       double EnergyPrevious = Energy + 10 * OptScheme->get_energy_conv( instruction ); // Guarantees that there's always at least 1 left-right sweep
+      if ( resume_pending ){
+         nIterations    = pos_sweep;
+         Energy         = pos_energy;
+         EnergyPrevious = pos_energy_prev;
+         change         = pos_change;
+         if ( pos_started == false ){ resume_pending = false; } // The position is the start of a left-right sweep
+      }
 
-      while (( fabs( Energy - EnergyPrevious ) > OptScheme->get_energy_conv( instruction ) ) && ( nIterations < OptScheme->get_max_sweeps( instruction ) )){
-
-         for ( int timecnt = 0; timecnt < CHEMPS2_TIME_VECLENGTH; timecnt++ ){ timings[ timecnt ] = 0.0; }
-         num_double_write_disk = 0;
-         num_double_read_disk  = 0;
-         struct timeval start, end;
-         EnergyPrevious = Energy;
-         gettimeofday( &start, NULL );
-         Energy = sweepleft( change, instruction, am_i_master ); // Only relevant call in this block of code
-         gettimeofday( &end, NULL );
-         double elapsed = ( end.tv_sec - start.tv_sec ) + 1e-6 * ( end.tv_usec - start.tv_usec );
-         if ( am_i_master ){
-            cout << "******************************************************************" << endl;
-            cout << "***  Information on left sweep " << nIterations << " of instruction " << instruction << ":" << endl;
-            cout << "***     Elapsed wall time        = " << elapsed << " seconds" << endl;
-            cout << "***       |--> S.join            = " << timings[ CHEMPS2_TIME_S_JOIN  ] << " seconds" << endl;
-            cout << "***       |--> S.solve           = " << timings[ CHEMPS2_TIME_S_SOLVE ] << " seconds" << endl;
-            cout << "***       |--> S.split           = " << timings[ CHEMPS2_TIME_S_SPLIT ] << " seconds" << endl;
-            print_tensor_update_performance();
-            cout << "***     Minimum energy           = " << LastMinEnergy << endl;
-            cout << "***     Maximum discarded weight = " << MaxDiscWeightLastSweep << endl;
-         }
-         if ( Exc_activated ){ calc_overlaps( false ); }
-         if ( am_i_master ){
-            cout << "******************************************************************" << endl;
+      while (( resume_pending ) || (( fabs( Energy - EnergyPrevious ) > OptScheme->get_energy_conv( instruction ) ) && ( nIterations < OptScheme->get_max_sweeps( instruction ) ))){
+
+         pos_instruction = instruction;
+         pos_sweep       = nIterations;
+         double elapsed  = 0.0;
+         if (( resume_pending == false ) || ( pos_right == false )){
+            for ( int timecnt = 0; timecnt < CHEMPS2_TIME_VECLENGTH; timecnt++ ){ timings[ timecnt ] = 0.0; }
+            num_double_write_disk = 0;
+            num_double_read_disk  = 0;
+            num_byte_write_file   = 0;
+            EnergyPrevious  = Energy;
+            pos_right       = false;
+            pos_change      = change;
+            pos_energy      = Energy;
+            pos_energy_prev = EnergyPrevious;
+            if (( resume_pending == false ) && ( balance->changed( denBK ) )){ rebalance_operators( am_i_master ); }
+            gettimeofday( &start, NULL );
+            Energy = sweepleft( change, instruction, am_i_master ); // Only relevant call in this block of code
+            gettimeofday( &end, NULL );
+            NumMatvecInstruction += NumMatvecLastSweep;
+            measure_imbalance();
+            elapsed = ( end.tv_sec - start.tv_sec ) + 1e-6 * ( end.tv_usec - start.tv_usec );
+            if ( am_i_master ){
+               cout << "******************************************************************" << endl;
+               cout << "***  Information on left sweep " << nIterations << " of instruction " << instruction << ":" << endl;
+               cout << "***     Elapsed wall time        = " << elapsed << " seconds" << endl;
+               cout << "***       |--> S.join            = " << timings[ CHEMPS2_TIME_S_JOIN  ] << " seconds" << endl;
+               cout << "***       |--> S.solve           = " << timings[ CHEMPS2_TIME_S_SOLVE ] << " seconds" << endl;
+               cout << "***       |--> S.split           = " << timings[ CHEMPS2_TIME_S_SPLIT ] << " seconds" << endl;
+               print_tensor_update_performance();
+               cout << "***     Minimum energy           = " << LastMinEnergy << endl;
+               cout << "***     Maximum discarded weight = " << MaxDiscWeightLastSweep << endl;
+               print_sweep_summary();
+               if ( SA_num_roots > 1 ){
+                  cout << "***     Root energies            = [ " << SA_energies[ 0 ]; for ( int root = 1; root < SA_num_roots; root++ ){ cout << " ; " << SA_energies[ root ]; } cout << " ]" << endl;
+               }
+            }
+            if ( Exc_activated ){ calc_overlaps( false ); }
+            if ( am_i_master ){
+               cout << "******************************************************************" << endl;
+            }
+            change = true; //rest of sweeps: variable virtual dimensions
          }
-         change = true; //rest of sweeps: variable virtual dimensions
          for ( int timecnt = 0; timecnt < CHEMPS2_TIME_VECLENGTH; timecnt++ ){ timings[ timecnt ] = 0.0; }
          num_double_write_disk = 0;
          num_double_read_disk  = 0;
+         num_byte_write_file   = 0;
+         pos_right       = true;
+         pos_change      = change;
+         pos_energy      = Energy;
+         pos_energy_prev = EnergyPrevious;
          gettimeofday( &start, NULL );
          Energy = sweepright( change, instruction, am_i_master ); // Only relevant call in this block of code
          gettimeofday( &end, NULL );
+         NumMatvecInstruction += NumMatvecLastSweep;
+         measure_imbalance();
          elapsed = ( end.tv_sec - start.tv_sec ) + 1e-6 * ( end.tv_usec - start.tv_usec );
          if ( am_i_master ){
             cout << "******************************************************************" << endl;
@@ -257,12 +399,23 @@ double CheMPS2::DMRG::Solve(){
             print_tensor_update_performance();
             cout << "***     Minimum energy           = " << LastMinEnergy << endl;
             cout << "***     Maximum discarded weight = " << MaxDiscWeightLastSweep << endl;
+            print_sweep_summary();
+            if ( SA_num_roots > 1 ){
+               cout << "***     Root energies            = [ " << SA_energies[ 0 ]; for ( int root = 1; root < SA_num_roots; root++ ){ cout << " ; " << SA_energies[ root ]; } cout << " ]" << endl;
+            }
             cout << "***     Energy difference with respect to previous leftright sweep = " << fabs(Energy-EnergyPrevious) << endl;
          }
          if ( Exc_activated ){ calc_overlaps( true ); }
          if ( am_i_master ){
             cout << "******************************************************************" << endl;
-            if ( makecheckpoints ){ saveMPS( MPSstoragename, MPS, denBK, false ); } // Only the master proc makes MPS checkpoints !!
+         }
+         if ( makecheckpoints ){ // The next left-right sweep is the restart position
+            pos_sweep       = nIterations + 1;
+            pos_started     = false;
+            pos_change      = change;
+            pos_energy      = Energy;
+            pos_energy_prev = EnergyPrevious;
+            write_checkpoint( false );
          }
 
          nIterations++;
@@ -272,32 +425,85 @@ double CheMPS2::DMRG::Solve(){
       if ( am_i_master ){
          cout << "***  Information on completed instruction " << instruction << ":" << endl;
          cout << "***     The reduced virtual dimension DSU(2)               = " << OptScheme->get_D(instruction) << endl;
+         if ( OptScheme->get_max_discarded_weight( instruction ) > 0.0 ){
+            cout << "***     The maximum discarded weight per bond              = " << OptScheme->get_max_discarded_weight( instruction ) << endl;
+            cout << "***     The minimum reduced virtual dimension per bond     = " << OptScheme->get_D_min( instruction ) << endl;
+         }
          cout << "***     Minimum energy encountered during all instructions = " << TotalMinEnergy << endl;
          cout << "***     Minimum energy encountered during the last sweep   = " << LastMinEnergy << endl;
          cout << "***     Maximum discarded weight during the last sweep     = " << MaxDiscWeightLastSweep << endl;
+         cout << "***     Davidson multiplications during the instruction    = " << NumMatvecInstruction << endl;
          cout << "******************************************************************" << endl;
       }
 
    }
 
+   if ( makecheckpoints ){ // The MPS checkpoint is a converged one from now on
+      pos_instruction = -1;
+      if ( am_i_master ){ save_restart_state( MPSstoragename, false ); }
+      delete_restart_operators();
+   }
+
+   workspace->release(); // The work arrays are not kept while the DMRG object is idle
    return TotalMinEnergy;
 
 }
 
+void CheMPS2::DMRG::start_sweep(){
+
+   MaxDiscWeightLastSweep = 0.0;
+   NumMatvecLastSweep     = 0;
+   MinRtolLastSweep       = 1.0;
+   MaxRtolLastSweep       = 0.0;
+
+}
+
+double CheMPS2::DMRG::adapt_rtol( const int site, const int bound, const double dvdson_rtol ){
+
+   /* The energy error of a Davidson solution is quadratic in its residual norm. The residual norm of a site therefore only needs to
+      be small compared to the square root of the energy change at that site during the last sweep, or of the discarded weight of the
+      bond which is truncated after the site, whichever is larger. The user tolerance dvdson_rtol is the lower bound. */
+   double rtol = dvdson_rtol;
+   if ( CheMPS2::DAVIDSON_DMRG_ADAPTIVE ){
+      const double change = std::max( SiteEnergyChanges[ site ], DiscWeightBonds[ bound ] );
+      rtol = std::max( dvdson_rtol, std::min( CheMPS2::DAVIDSON_DMRG_ADAPTIVE_MAX, CheMPS2::DAVIDSON_DMRG_ADAPTIVE_FACTOR * sqrt( change ) ) );
+   }
+   if ( rtol < MinRtolLastSweep ){ MinRtolLastSweep = rtol; }
+   if ( rtol > MaxRtolLastSweep ){ MaxRtolLastSweep = rtol; }
+   return rtol;
+
+}
+
+void CheMPS2::DMRG::track_site( const int site, const double energy ){
+
+   SiteEnergyChanges[ site ] = fabs( energy - SiteEnergies[ site ] );
+   SiteEnergies[ site ]      = energy;
+
+}
+
 double CheMPS2::DMRG::sweepleft( const bool change, const int instruction, const bool am_i_master ){
 
+   if (( OptScheme->get_one_site( instruction ) ) && ( Exc_activated == false ) && ( SA_num_roots == 1 )){ return sweepleft_onesite( change, instruction, am_i_master ); }
+
    double Energy = 0.0;
-   const double noise_level = fabs( OptScheme->get_noise_prefactor( instruction ) ) * MaxDiscWeightLastSweep;
+   const double noise_level = ( resume_pending ) ? pos_noise : fabs( OptScheme->get_noise_prefactor( instruction ) ) * MaxDiscWeightLastSweep;
    const double dvdson_rtol = OptScheme->get_dvdson_rtol( instruction );
    const int vir_dimension  = OptScheme->get_D( instruction );
-   MaxDiscWeightLastSweep = 0.0;
-   LastMinEnergy = 1e8;
+   const double max_disc_w  = OptScheme->get_max_discarded_weight( instruction );
+   const int min_dimension  = OptScheme->get_D_min( instruction );
+   const int first          = ( resume_pending ) ? pos_index : L - 2;
+   if ( resume_pending == false ){
+      start_sweep();
+      LastMinEnergy = 1e8;
+   }
+   resume_pending = false;
 
-   for ( int index = L - 2; index > 0; index-- ){
+   for ( int index = first; index > 0; index-- ){
 
-      Energy = solve_site( index, dvdson_rtol, noise_level, vir_dimension, am_i_master, false, change );
+      Energy = solve_site( index, adapt_rtol( index, index + 1, dvdson_rtol ), noise_level, vir_dimension, max_disc_w, min_dimension, am_i_master, false, change );
       if ( Energy < TotalMinEnergy ){ TotalMinEnergy = Energy; }
       if ( Energy < LastMinEnergy  ){  LastMinEnergy = Energy; }
+      track_site( index, Energy );
       if ( am_i_master ){
          cout << "Energy at sites (" << index << ", " << index + 1 << ") is " << Energy << endl;
       }
@@ -308,27 +514,39 @@ double CheMPS2::DMRG::sweepleft( const bool change, const int instruction, const
       updateMovingLeftSafe( index );
       gettimeofday( &end, NULL );
       timings[ CHEMPS2_TIME_TENS_TOTAL ] += ( end.tv_sec - start.tv_sec ) + 1e-6 * ( end.tv_usec - start.tv_usec );
+      if ( index - 1 > 0 ){ checkpoint_sweep( index - 1, false, noise_level ); }
 
    }
 
+   io_sync(); // No HDF5 calls in the background after a sweep
+
    return Energy;
 
 }
 
 double CheMPS2::DMRG::sweepright( const bool change, const int instruction, const bool am_i_master ){
 
+   if (( OptScheme->get_one_site( instruction ) ) && ( Exc_activated == false ) && ( SA_num_roots == 1 )){ return sweepright_onesite( change, instruction, am_i_master ); }
+
    double Energy = 0.0;
-   const double noise_level = fabs( OptScheme->get_noise_prefactor( instruction ) ) * MaxDiscWeightLastSweep;
+   const double noise_level = ( resume_pending ) ? pos_noise : fabs( OptScheme->get_noise_prefactor( instruction ) ) * MaxDiscWeightLastSweep;
    const double dvdson_rtol = OptScheme->get_dvdson_rtol( instruction );
    const int vir_dimension  = OptScheme->get_D( instruction );
-   MaxDiscWeightLastSweep = 0.0;
-   LastMinEnergy = 1e8;
+   const double max_disc_w  = OptScheme->get_max_discarded_weight( instruction );
+   const int min_dimension  = OptScheme->get_D_min( instruction );
+   const int first          = ( resume_pending ) ? pos_index : 0;
+   if ( resume_pending == false ){
+      start_sweep();
+      LastMinEnergy = 1e8;
+   }
+   resume_pending = false;
 
-   for ( int index = 0; index < L - 2; index++ ){
+   for ( int index = first; index < L - 2; index++ ){
 
-      Energy = solve_site( index, dvdson_rtol, noise_level, vir_dimension, am_i_master, true, change );
+      Energy = solve_site( index, adapt_rtol( index, index + 1, dvdson_rtol ), noise_level, vir_dimension, max_disc_w, min_dimension, am_i_master, true, change );
       if ( Energy < TotalMinEnergy ){ TotalMinEnergy = Energy; }
       if ( Energy < LastMinEnergy  ){  LastMinEnergy = Energy; }
+      track_site( index, Energy );
       if ( am_i_master ){
          cout << "Energy at sites (" << index << ", " << index + 1 << ") is " << Energy << endl;
       }
@@ -339,14 +557,19 @@ double CheMPS2::DMRG::sweepright( const bool change, const int instruction, cons
       updateMovingRightSafe( index );
       gettimeofday( &end, NULL );
       timings[ CHEMPS2_TIME_TENS_TOTAL ] += ( end.tv_sec - start.tv_sec ) + 1e-6 * ( end.tv_usec - start.tv_usec );
+      if ( index + 1 < L - 2 ){ checkpoint_sweep( index + 1, true, noise_level ); }
 
    }
 
+   io_sync(); // No HDF5 calls in the background after a sweep
+
    return Energy;
 
 }
 
-double CheMPS2::DMRG::solve_site( const int index, const double dvdson_rtol, const double noise_level, const int virtual_dimension, const bool am_i_master, const bool moving_right, const bool change ){
+double CheMPS2::DMRG::solve_site( const int index, const double dvdson_rtol, const double noise_level, const int virtual_dimension, const double max_disc_weight, const int min_dimension, const bool am_i_master, const bool moving_right, const bool change ){
+
+   if ( SA_num_roots > 1 ){ return solve_site_averaged( index, dvdson_rtol, noise_level, virtual_dimension, max_disc_weight, min_dimension, am_i_master, moving_right, change ); }
 
    struct timeval start, end;
 
@@ -359,10 +582,12 @@ double CheMPS2::DMRG::solve_site( const int index, const double dvdson_rtol, con
 
    // Feed everything to the solver. Each MPI process returns the correct energy. Only MPI_CHEMPS2_MASTER has the correct denS solution.
    gettimeofday( &start, NULL );
-   Heff Solver( denBK, Prob, dvdson_rtol );
+   Heff Solver( denBK, Prob, dvdson_rtol, workspace, dvdson_distribute );
    double ** VeffTilde = NULL;
    if ( Exc_activated ){ VeffTilde = prepare_excitations( denS ); }
    double Energy = Solver.SolveDAVIDSON( denS, Ltensors, Atensors, Btensors, Ctensors, Dtensors, S0tensors, S1tensors, F0tensors, F1tensors, Qtensors, Xtensors, nStates - 1, VeffTilde );
+   NumMatvecLastSweep += Solver.gNumMultiplications();
+   timings[ CHEMPS2_TIME_MPI_WORK ] += Solver.gMultiplicationTime();
    Energy += Prob->gEconst();
    if ( Exc_activated ){ cleanup_excitations( VeffTilde ); }
    gettimeofday( &end, NULL );
@@ -371,9 +596,195 @@ double CheMPS2::DMRG::solve_site( const int index, const double dvdson_rtol, con
    // Decompose the S-object. MPI_CHEMPS2_MASTER decomposes denS. Each MPI process returns the correct discWeight. Each MPI process has the new MPS tensors set.
    gettimeofday( &start, NULL );
    if (( noise_level > 0.0 ) && ( am_i_master )){ denS->addNoise( noise_level ); }
-   const double discWeight = denS->Split( MPS[ index ], MPS[ index + 1 ], virtual_dimension, moving_right, change );
+   const double discWeight = denS->Split( MPS[ index ], MPS[ index + 1 ], virtual_dimension, moving_right, change, 0, NULL, NULL, workspace, max_disc_weight, min_dimension );
    delete denS;
    if ( discWeight > MaxDiscWeightLastSweep ){ MaxDiscWeightLastSweep = discWeight; }
+   DiscWeightBonds[ index + 1 ] = discWeight;
+   gettimeofday( &end, NULL );
+   timings[ CHEMPS2_TIME_S_SPLIT ] += ( end.tv_sec - start.tv_sec ) + 1e-6 * ( end.tv_usec - start.tv_usec );
+
+   return Energy;
+
+}
+
+double CheMPS2::DMRG::solve_site_averaged( const int index, const double dvdson_rtol, const double noise_level, const int virtual_dimension, const double max_disc_weight, const int min_dimension, const bool am_i_master, const bool moving_right, const bool change ){
+
+   struct timeval start, end;
+   assert(( SA_center_site == index ) || ( SA_center_site == index + 1 ));
+
+   // Construct the two-site objects of all roots. They only differ in the center tensor.
+   gettimeofday( &start, NULL );
+   Sobject ** denS = new Sobject*[ SA_num_roots ];
+   for ( int root = 0; root < SA_num_roots; root++ ){
+      TensorT * Tleft  = ((( root > 0 ) && ( SA_center_site == index     )) ? SA_centers[ root ] : MPS[ index     ] );
+      TensorT * Tright = ((( root > 0 ) && ( SA_center_site == index + 1 )) ? SA_centers[ root ] : MPS[ index + 1 ] );
+      denS[ root ] = new Sobject( index, denBK );
+      denS[ root ]->Join( Tleft, Tright );
+   }
+   gettimeofday( &end, NULL );
+   timings[ CHEMPS2_TIME_S_JOIN ] += ( end.tv_sec - start.tv_sec ) + 1e-6 * ( end.tv_usec - start.tv_usec );
+
+   // The lowest roots of the effective Hamiltonian share the renormalized operators. Each MPI process returns the correct energies. Only MPI_CHEMPS2_MASTER has the correct denS solutions.
+   gettimeofday( &start, NULL );
+   Heff Solver( denBK, Prob, dvdson_rtol, workspace, dvdson_distribute );
+   Solver.SolveDAVIDSON( denS, SA_energies, SA_num_roots, Ltensors, Atensors, Btensors, Ctensors, Dtensors, S0tensors, S1tensors, F0tensors, F1tensors, Qtensors, Xtensors );
+   NumMatvecLastSweep += Solver.gNumMultiplications();
+   timings[ CHEMPS2_TIME_MPI_WORK ] += Solver.gMultiplicationTime();
+   double Energy = 0.0;
+   for ( int root = 0; root < SA_num_roots; root++ ){
+      SA_energies[ root ] += Prob->gEconst();
+      Energy += SA_energies[ root ] / SA_num_roots;
+   }
+   gettimeofday( &end, NULL );
+   timings[ CHEMPS2_TIME_S_SOLVE ] += ( end.tv_sec - start.tv_sec ) + 1e-6 * ( end.tv_usec - start.tv_usec );
+
+   // Decompose based on the state-averaged reduced density matrix. Root 0 ends up in the MPS, the other roots in SA_centers.
+   gettimeofday( &start, NULL );
+   SA_center_site = (( moving_right ) ? index + 1 : index );
+   for ( int root = 1; root < SA_num_roots; root++ ){
+      delete SA_centers[ root ];
+      SA_centers[ root ] = new TensorT( SA_center_site, denBK );
+   }
+   if (( noise_level > 0.0 ) && ( am_i_master )){
+      for ( int root = 0; root < SA_num_roots; root++ ){ denS[ root ]->addNoise( noise_level ); }
+   }
+   const double discWeight = denS[ 0 ]->Split( MPS[ index ], MPS[ index + 1 ], virtual_dimension, moving_right, change, SA_num_roots - 1, denS + 1, SA_centers + 1, workspace, max_disc_weight, min_dimension );
+   for ( int root = 0; root < SA_num_roots; root++ ){ delete denS[ root ]; }
+   delete [] denS;
+   if ( discWeight > MaxDiscWeightLastSweep ){ MaxDiscWeightLastSweep = discWeight; }
+   DiscWeightBonds[ index + 1 ] = discWeight;
+   gettimeofday( &end, NULL );
+   timings[ CHEMPS2_TIME_S_SPLIT ] += ( end.tv_sec - start.tv_sec ) + 1e-6 * ( end.tv_usec - start.tv_usec );
+
+   return Energy;
+
+}
+
+double CheMPS2::DMRG::sweepleft_onesite( const bool change, const int instruction, const bool am_i_master ){
+
+   double Energy = 0.0;
+   const double noise_level = ( resume_pending ) ? pos_noise : fabs( OptScheme->get_noise_prefactor( instruction ) ) * MaxDiscWeightLastSweep;
+   const double dvdson_rtol = OptScheme->get_dvdson_rtol( instruction );
+   const int vir_dimension  = OptScheme->get_D( instruction );
+   const double expansion   = OptScheme->get_expansion_prefactor( instruction );
+   const double max_disc_w  = OptScheme->get_max_discarded_weight( instruction );
+   const int min_dimension  = OptScheme->get_D_min( instruction );
+   const int first          = ( resume_pending ) ? pos_index : L - 1;
+   struct timeval start, end;
+   if ( resume_pending == false ){
+      start_sweep();
+      LastMinEnergy = 1e8;
+
+      // Move the center to the last site
+      gettimeofday( &start, NULL );
+      left_normalize( MPS[ L - 2 ], MPS[ L - 1 ] );
+      updateSafeOneSite( L - 2, true, false );
+      gettimeofday( &end, NULL );
+      timings[ CHEMPS2_TIME_TENS_TOTAL ] += ( end.tv_sec - start.tv_sec ) + 1e-6 * ( end.tv_usec - start.tv_usec );
+   }
+   resume_pending = false;
+
+   for ( int site = first; site > 0; site-- ){
+
+      Energy = solve_site_onesite( site, adapt_rtol( site, site, dvdson_rtol ), noise_level, vir_dimension, max_disc_w, min_dimension, expansion, am_i_master, false, change );
+      if ( Energy < TotalMinEnergy ){ TotalMinEnergy = Energy; }
+      if ( Energy < LastMinEnergy  ){  LastMinEnergy = Energy; }
+      track_site( site, Energy );
+      if ( am_i_master ){
+         cout << "Energy at site " << site << " is " << Energy << endl;
+      }
+
+      // Prepare for next step
+      gettimeofday( &start, NULL );
+      updateSafeOneSite( site - 1, false, false );
+      gettimeofday( &end, NULL );
+      timings[ CHEMPS2_TIME_TENS_TOTAL ] += ( end.tv_sec - start.tv_sec ) + 1e-6 * ( end.tv_usec - start.tv_usec );
+      if ( site - 1 > 0 ){ checkpoint_sweep( site - 1, false, noise_level ); }
+
+   }
+
+   io_sync(); // No HDF5 calls in the background after a sweep
+   if ( L > 2 ){ boundary_load( 1, false ); } // Required by a subsequent two-site sweep
+
+   return Energy;
+
+}
+
+double CheMPS2::DMRG::sweepright_onesite( const bool change, const int instruction, const bool am_i_master ){
+
+   double Energy = 0.0;
+   const double noise_level = ( resume_pending ) ? pos_noise : fabs( OptScheme->get_noise_prefactor( instruction ) ) * MaxDiscWeightLastSweep;
+   const double dvdson_rtol = OptScheme->get_dvdson_rtol( instruction );
+   const int vir_dimension  = OptScheme->get_D( instruction );
+   const double expansion   = OptScheme->get_expansion_prefactor( instruction );
+   const double max_disc_w  = OptScheme->get_max_discarded_weight( instruction );
+   const int min_dimension  = OptScheme->get_D_min( instruction );
+   const int first          = ( resume_pending ) ? pos_index : 0;
+   struct timeval start, end;
+   if ( resume_pending == false ){
+      start_sweep();
+      LastMinEnergy = 1e8;
+
+      // Move the center to the first site
+      gettimeofday( &start, NULL );
+      right_normalize( MPS[ 0 ], MPS[ 1 ] );
+      updateSafeOneSite( 0, false, true );
+      gettimeofday( &end, NULL );
+      timings[ CHEMPS2_TIME_TENS_TOTAL ] += ( end.tv_sec - start.tv_sec ) + 1e-6 * ( end.tv_usec - start.tv_usec );
+   }
+   resume_pending = false;
+
+   for ( int site = first; site < L - 1; site++ ){
+
+      Energy = solve_site_onesite( site, adapt_rtol( site, site + 1, dvdson_rtol ), noise_level, vir_dimension, max_disc_w, min_dimension, expansion, am_i_master, true, change );
+      if ( Energy < TotalMinEnergy ){ TotalMinEnergy = Energy; }
+      if ( Energy < LastMinEnergy  ){  LastMinEnergy = Energy; }
+      track_site( site, Energy );
+      if ( am_i_master ){
+         cout << "Energy at site " << site << " is " << Energy << endl;
+      }
+
+      // Prepare for next step
+      gettimeofday( &start, NULL );
+      updateSafeOneSite( site, true, true );
+      gettimeofday( &end, NULL );
+      timings[ CHEMPS2_TIME_TENS_TOTAL ] += ( end.tv_sec - start.tv_sec ) + 1e-6 * ( end.tv_usec - start.tv_usec );
+      if ( site + 1 < L - 1 ){ checkpoint_sweep( site + 1, true, noise_level ); }
+
+   }
+
+   io_sync(); // No HDF5 calls in the background after a sweep
+   if ( L > 2 ){ boundary_load( L - 3, true ); } // Required by a subsequent two-site sweep or calc_rdms_and_correlations
+
+   return Energy;
+
+}
+
+double CheMPS2::DMRG::solve_site_onesite( const int site, const double dvdson_rtol, const double noise_level, const int virtual_dimension, const double max_disc_weight, const int min_dimension, const double expansion_prefactor, const bool am_i_master, const bool moving_right, const bool change ){
+
+   struct timeval start, end;
+
+   // Optimize the center MPS tensor. Each MPI process returns the correct energy. Only MPI_CHEMPS2_MASTER has the correct solution.
+   gettimeofday( &start, NULL );
+   HeffOneSite Solver( denBK, Prob, dvdson_rtol, workspace );
+   double Energy = Solver.SolveDAVIDSON( MPS[ site ], Ltensors, Atensors, Btensors, Ctensors, Dtensors, S0tensors, S1tensors, F0tensors, F1tensors, Qtensors, Xtensors );
+   NumMatvecLastSweep += Solver.gNumMultiplications();
+   timings[ CHEMPS2_TIME_MPI_WORK ] += Solver.gMultiplicationTime();
+   Energy += Prob->gEconst();
+   gettimeofday( &end, NULL );
+   timings[ CHEMPS2_TIME_S_SOLVE ] += ( end.tv_sec - start.tv_sec ) + 1e-6 * ( end.tv_usec - start.tv_usec );
+
+   // Expand and truncate the bond in the sweep direction. The center moves along with the sweep direction, and the new MPS tensors are broadcasted.
+   gettimeofday( &start, NULL );
+   if (( noise_level > 0.0 ) && ( am_i_master )){
+      double * storage = MPS[ site ]->gStorage();
+      for ( long long cnt = 0; cnt < MPS[ site ]->gKappa2index( MPS[ site ]->gNKappa() ); cnt++ ){
+         storage[ cnt ] += ( ( (double) rand() ) / RAND_MAX - 0.5 ) * noise_level;
+      }
+   }
+   const double discWeight = Solver.Expand( MPS[ site ], MPS[ ( moving_right ) ? site + 1 : site - 1 ], expansion_prefactor, virtual_dimension, change, max_disc_weight, min_dimension, Ltensors );
+   if ( discWeight > MaxDiscWeightLastSweep ){ MaxDiscWeightLastSweep = discWeight; }
+   DiscWeightBonds[ ( moving_right ) ? site + 1 : site ] = discWeight;
    gettimeofday( &end, NULL );
    timings[ CHEMPS2_TIME_S_SPLIT ] += ( end.tv_sec - start.tv_sec ) + 1e-6 * ( end.tv_usec - start.tv_usec );
 
@@ -383,6 +794,7 @@ double CheMPS2::DMRG::solve_site( const int index, const double dvdson_rtol, con
 
 void CheMPS2::DMRG::activateExcitations( const int maxExcIn ){
 
+   assert( SA_num_roots == 1 );
    Exc_activated = true;
    maxExc = maxExcIn;
    Exc_Eshifts = new double[ maxExc ];
@@ -394,6 +806,7 @@ void CheMPS2::DMRG::activateExcitations( const int maxExcIn ){
 
 void CheMPS2::DMRG::newExcitation( const double EshiftIn ){
 
+   MPIbalance::activate( balance );
    assert( Exc_activated );
    assert( nStates - 1 < maxExc );
 
@@ -424,3 +837,71 @@ void CheMPS2::DMRG::newExcitation( const double EshiftIn ){
 
 }
 
+void CheMPS2::DMRG::activateStateAveraging( const int num_roots ){
+
+   assert( Exc_activated == false );
+   assert( SA_num_roots == 1 );
+   assert( num_roots >= 2 );
+
+   SA_num_roots = num_roots;
+   SA_energies  = new double[ SA_num_roots ];
+   SA_centers   = new TensorT*[ SA_num_roots ];
+   SA_centers[ 0 ] = NULL; // Root 0 lives in the MPS
+   for ( int root = 0; root < SA_num_roots; root++ ){ SA_energies[ root ] = 0.0; }
+   for ( int root = 1; root < SA_num_roots; root++ ){
+      SA_centers[ root ] = new TensorT( SA_center_site, denBK );
+      SA_centers[ root ]->random(); // Initial guess
+   }
+
+}
+
+double CheMPS2::DMRG::getRootEnergy( const int root ) const{
+
+   assert( SA_num_roots > 1 );
+   assert(( root >= 0 ) && ( root < SA_num_roots ));
+   return SA_energies[ root ];
+
+}
+
+void CheMPS2::DMRG::selectRoot( const int root ){
+
+   assert( SA_num_roots > 1 );
+   assert(( root >= 0 ) && ( root < SA_num_roots ));
+   assert( SA_center_site == L - 2 ); // Solve() ends with a right sweep
+   MPIbalance::activate( balance );
+
+   if ( SA_backup == NULL ){ // The MPS and the renormalized operators are still those of Solve(): store root 0
+      SA_backup = new TensorT*[ L ];
+      for ( int site = 0; site < L; site++ ){
+         SA_backup[ site ] = new TensorT( site, denBK );
+         Special::dcopy64( MPS[ site ]->gKappa2index( MPS[ site ]->gNKappa() ), MPS[ site ]->gStorage(), SA_backup[ site ]->gStorage() );
+      }
+   } else { // The MPS and the renormalized operators may have been changed by calc_rdms_and_correlations()
+      for ( int site = 0; site < L; site++ ){
+         Special::dcopy64( MPS[ site ]->gKappa2index( MPS[ site ]->gNKappa() ), SA_backup[ site ]->gStorage(), MPS[ site ]->gStorage() );
+      }
+      deleteAllBoundaryOperators();
+      for ( int cnt = 0; cnt < L - 2; cnt++ ){ updateMovingRightSafeFirstTime( cnt ); }
+      io_sync();
+   }
+
+   // The left-normalized site tensors are shared, only the center tensor differs
+   if ( root > 0 ){
+      Special::dcopy64( MPS[ SA_center_site ]->gKappa2index( MPS[ SA_center_site ]->gNKappa() ), SA_centers[ root ]->gStorage(), MPS[ SA_center_site ]->gStorage() );
+   }
+
+   if ( the2DM  != NULL ){ delete the2DM;  the2DM  = NULL; }
+   if ( the3DM  != NULL ){ delete the3DM;  the3DM  = NULL; }
+   if ( theCorr != NULL ){ delete theCorr; theCorr = NULL; }
+
+}
+
+void CheMPS2::DMRG::delete_sa_backup(){
+
+   if ( SA_backup != NULL ){
+      for ( int site = 0; site < L; site++ ){ delete SA_backup[ site ]; }
+      delete [] SA_backup;
+      SA_backup = NULL;
+   }
+
+}
@@ -36,6 +36,9 @@ CheMPS2::DMRGSCFoptions::DMRGSCFoptions(){
    WhichActiveSpace   = CheMPS2::DMRGSCF_whichActiveSpace;
    DumpCorrelations   = CheMPS2::DMRGSCF_dumpCorrelations;
    StartLocRandom     = CheMPS2::DMRGSCF_startLocRandom;
+   WarmStartBranch    = CheMPS2::DMRGSCF_warmStartBranch;
+
+   CASPT2OutOfCore    = CheMPS2::DMRGSCF_CASPT2outOfCore;
 
 }
 
@@ -54,6 +57,8 @@ bool   CheMPS2::DMRGSCFoptions::getStateAveraging() const{     return StateAvera
 int    CheMPS2::DMRGSCFoptions::getWhichActiveSpace() const{   return WhichActiveSpace;   }
 bool   CheMPS2::DMRGSCFoptions::getDumpCorrelations() const{   return DumpCorrelations;   }
 bool   CheMPS2::DMRGSCFoptions::getStartLocRandom() const{     return StartLocRandom;     }
+double CheMPS2::DMRGSCFoptions::getWarmStartBranch() const{    return WarmStartBranch;    }
+bool   CheMPS2::DMRGSCFoptions::getCASPT2OutOfCore() const{    return CASPT2OutOfCore;    }
 
 void CheMPS2::DMRGSCFoptions::setDoDIIS(const bool DoDIIS_in){                           DoDIIS             = DoDIIS_in;             }
 void CheMPS2::DMRGSCFoptions::setDIISGradientBranch(const double DIISGradientBranch_in){ DIISGradientBranch = DIISGradientBranch_in; }
@@ -68,6 +73,8 @@ void CheMPS2::DMRGSCFoptions::setStateAveraging(const bool StateAveraging_in){
 void CheMPS2::DMRGSCFoptions::setWhichActiveSpace(const int WhichActiveSpace_in){        WhichActiveSpace   = WhichActiveSpace_in;   }
 void CheMPS2::DMRGSCFoptions::setDumpCorrelations(const bool DumpCorrelations_in){       DumpCorrelations   = DumpCorrelations_in;   }
 void CheMPS2::DMRGSCFoptions::setStartLocRandom(const bool StartLocRandom_in){           StartLocRandom     = StartLocRandom_in;     }
+void CheMPS2::DMRGSCFoptions::setWarmStartBranch(const double WarmStartBranch_in){       WarmStartBranch    = WarmStartBranch_in;    }
+void CheMPS2::DMRGSCFoptions::setCASPT2OutOfCore(const bool CASPT2OutOfCore_in){         CASPT2OutOfCore    = CASPT2OutOfCore_in;    }
 
 
 
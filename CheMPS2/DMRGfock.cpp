@@ -31,7 +31,9 @@
 #include "Lapack.h"
 #include "Heff.h"
 #include "MPIchemps2.h"
+#include "Special.h"
 #include "Excitation.h"
+#include "Irreps.h"
 
 using std::cout;
 using std::endl;
@@ -40,36 +42,59 @@ using std::max;
 
 void CheMPS2::DMRG::Symm4RDM( double * output, const int Y, const int Z, const bool last_case ){
 
+   int * irreps = new int[ L ];
+   for ( int orb = 0; orb < L; orb++ ){ irreps[ orb ] = Prob->gIrrep(( Prob->gReorder() ) ? Prob->gf1( orb ) : orb ); }
+   SixIndex * packed = new SixIndex( L, irreps );
+   delete [] irreps;
+
+   Symm4RDM( packed, Y, Z, last_case );
+   packed->fill_dense( output );
+   delete packed;
+
+}
+
+void CheMPS2::DMRG::Symm4RDM( SixIndex * output, const int Y, const int Z, const bool last_case ){
+
+   MPIbalance::activate( balance );
    struct timeval start, end;
    gettimeofday( &start, NULL );
 
    assert( the3DM != NULL );
+   assert( output->get_L() == L );
 
    symm_4rdm_helper( output, Y, Z, 1.0, 1.0, false, 0.5 ); // output = 0.5 *   3rdm[ ( 1 + E_{YZ} + E_{ZY} ) | 0 > ]
    symm_4rdm_helper( output, Y, Z, 1.0, 0.0, true, -0.5 ); // output = 0.5 * ( 3rdm[ ( 1 + E_{YZ} + E_{ZY} ) | 0 > ] - 3rdm[ E_{YZ} + E_{ZY} | 0 > ] )
 
-   for ( int r = 0; r < L; r++ ){
-      for ( int q = 0; q < L; q++ ){
-         for ( int p = 0; p < L; p++ ){
-            for ( int k = 0; k < L; k++ ){
-               for ( int j = 0; j < L; j++ ){
-                  for ( int i = 0; i < L; i++ ){
-                     output[ i + L * ( j + L * ( k + L * ( p + L * ( q + L * r )))) ] -= 0.5 * the3DM->get_ham_index( i, j, k, p, q, r );
-                  }
-                  output[ Y + L * ( j + L * ( k + L * ( p + L * ( q + L * r )))) ] -= 0.5 * the3DM->get_ham_index( Z, j, k, p, q, r );
-                  output[ Z + L * ( j + L * ( k + L * ( p + L * ( q + L * r )))) ] -= 0.5 * the3DM->get_ham_index( Y, j, k, p, q, r );
-                  output[ j + L * ( Y + L * ( k + L * ( p + L * ( q + L * r )))) ] -= 0.5 * the3DM->get_ham_index( j, Z, k, p, q, r );
-                  output[ j + L * ( Z + L * ( k + L * ( p + L * ( q + L * r )))) ] -= 0.5 * the3DM->get_ham_index( j, Y, k, p, q, r );
-                  output[ j + L * ( k + L * ( Y + L * ( p + L * ( q + L * r )))) ] -= 0.5 * the3DM->get_ham_index( j, k, Z, p, q, r );
-                  output[ j + L * ( k + L * ( Z + L * ( p + L * ( q + L * r )))) ] -= 0.5 * the3DM->get_ham_index( j, k, Y, p, q, r );
-                  output[ j + L * ( k + L * ( p + L * ( Y + L * ( q + L * r )))) ] -= 0.5 * the3DM->get_ham_index( j, k, p, Z, q, r );
-                  output[ j + L * ( k + L * ( p + L * ( Z + L * ( q + L * r )))) ] -= 0.5 * the3DM->get_ham_index( j, k, p, Y, q, r );
-                  output[ j + L * ( k + L * ( p + L * ( q + L * ( Y + L * r )))) ] -= 0.5 * the3DM->get_ham_index( k, j, p, Z, q, r );
-                  output[ j + L * ( k + L * ( p + L * ( q + L * ( Z + L * r )))) ] -= 0.5 * the3DM->get_ham_index( k, j, p, Y, q, r );
-                  output[ j + L * ( k + L * ( p + L * ( q + L * ( r + L * Y )))) ] -= 0.5 * the3DM->get_ham_index( p, j, k, Z, q, r );
-                  output[ j + L * ( k + L * ( p + L * ( q + L * ( r + L * Z )))) ] -= 0.5 * the3DM->get_ham_index( p, j, k, Y, q, r );
-               }
-            }
+   /* output[ ijk;pqr ] -= 0.5 * ( 3rdm[ ijk;pqr ] + the 3rdm's with one orbital Y in ijk;pqr replaced by Z, or Z by Y )
+      This is invariant under the permutations of the orbital pairs ( i, p ), ( j, q ), and ( k, r ), hence only the stored elements are visited. */
+   const int num_pairs = output->get_num_pairs();
+   double * storage = output->get_storage();
+   #pragma omp parallel for schedule(dynamic)
+   for ( int key3 = 0; key3 < num_pairs; key3++ ){
+      const int k = output->get_pair_creator( key3 );
+      const int r = output->get_pair_annihilator( key3 );
+      for ( int key2 = 0; key2 <= key3; key2++ ){
+         const int j = output->get_pair_creator( key2 );
+         const int q = output->get_pair_annihilator( key2 );
+         const int irrep1 = Irreps::directProd( output->get_pair_irrep( key2 ), output->get_pair_irrep( key3 ) );
+         const int stop1  = min( key2 + 1, output->get_pair_end( irrep1 ) );
+         for ( int key1 = output->get_pair_begin( irrep1 ); key1 < stop1; key1++ ){
+            const int i = output->get_pair_creator( key1 );
+            const int p = output->get_pair_annihilator( key1 );
+            double value = the3DM->get_ham_index( i, j, k, p, q, r );
+            if ( i == Y ){ value += the3DM->get_ham_index( Z, j, k, p, q, r ); }
+            if ( i == Z ){ value += the3DM->get_ham_index( Y, j, k, p, q, r ); }
+            if ( j == Y ){ value += the3DM->get_ham_index( i, Z, k, p, q, r ); }
+            if ( j == Z ){ value += the3DM->get_ham_index( i, Y, k, p, q, r ); }
+            if ( k == Y ){ value += the3DM->get_ham_index( i, j, Z, p, q, r ); }
+            if ( k == Z ){ value += the3DM->get_ham_index( i, j, Y, p, q, r ); }
+            if ( p == Y ){ value += the3DM->get_ham_index( i, j, k, Z, q, r ); }
+            if ( p == Z ){ value += the3DM->get_ham_index( i, j, k, Y, q, r ); }
+            if ( q == Y ){ value += the3DM->get_ham_index( i, j, k, p, Z, r ); }
+            if ( q == Z ){ value += the3DM->get_ham_index( i, j, k, p, Y, r ); }
+            if ( r == Y ){ value += the3DM->get_ham_index( i, j, k, p, q, Z ); }
+            if ( r == Z ){ value += the3DM->get_ham_index( i, j, k, p, q, Y ); }
+            storage[ output->get_pointer_keys( key1, key2, key3 ) ] -= 0.5 * value;
          }
       }
    }
@@ -85,7 +110,17 @@ void CheMPS2::DMRG::Symm4RDM( double * output, const int Y, const int Z, const b
 
 }
 
-void CheMPS2::DMRG::symm_4rdm_helper( double * output, const int ham_orb1, const int ham_orb2, const double alpha, const double beta, const bool add, const double factor ){
+void CheMPS2::DMRG::setProcessLocal( const bool local ){
+
+   #ifdef CHEMPS2_MPI_COMPILATION
+   MPIbalance::activate( balance );
+   deleteAllBoundaryOperators(); // With the owners of the current mode
+   MPIchemps2::set_process_local( local );
+   #endif
+
+}
+
+void CheMPS2::DMRG::symm_4rdm_helper( SixIndex * output, const int ham_orb1, const int ham_orb2, const double alpha, const double beta, const bool add, const double factor ){
 
    // Figure out the DMRG orbitals, in order
    assert( ham_orb1 >= 0 );
@@ -104,9 +139,8 @@ void CheMPS2::DMRG::symm_4rdm_helper( double * output, const int ham_orb1, const
    for ( int orbital = 0; orbital < L; orbital++ ){
       backup_mps[ orbital ] = MPS[ orbital ];
       MPS[ orbital ] = new TensorT( orbital, denBK ); // denBK is now a DIFFERENT pointer than backup_mps[ orbital ]->gBK()
-      int totalsize = MPS[ orbital ]->gKappa2index( MPS[ orbital ]->gNKappa() );
-      int inc1 = 1;
-      dcopy_( &totalsize, backup_mps[ orbital ]->gStorage(), &inc1, MPS[ orbital ]->gStorage(), &inc1 );
+      const long long totalsize = MPS[ orbital ]->gKappa2index( MPS[ orbital ]->gNKappa() );
+      Special::dcopy64( totalsize, backup_mps[ orbital ]->gStorage(), MPS[ orbital ]->gStorage() );
    }
    deleteAllBoundaryOperators();
 
@@ -125,7 +159,7 @@ void CheMPS2::DMRG::symm_4rdm_helper( double * output, const int ham_orb1, const
       updateMovingLeftSafeFirstTime( siteindex - 1 );
    }
 
-   ThreeDM * helper3rdm = new ThreeDM( denBK, Prob, false );
+   ThreeDM * helper3rdm = new ThreeDM( denBK, Prob, false, workspace );
    tensor_3rdm_a_J0_doublet = new Tensor3RDM****[ L - 1 ];
    tensor_3rdm_a_J1_doublet = new Tensor3RDM****[ L - 1 ];
    tensor_3rdm_a_J1_quartet = new Tensor3RDM****[ L - 1 ];
@@ -181,7 +215,7 @@ void CheMPS2::DMRG::symm_4rdm_helper( double * output, const int ham_orb1, const
    delete [] tensor_3rdm_d_J0_doublet;
    delete [] tensor_3rdm_d_J1_doublet;
    delete [] tensor_3rdm_d_J1_quartet;
-   helper3rdm->fill_ham_index( factor, add, output, 0, L );
+   helper3rdm->fill_ham_index( factor, add, output );
 
    // Throw out the changed MPS and place back the original left-normalized MPS
    for ( int orbital = 0; orbital < L; orbital++ ){
@@ -222,7 +256,7 @@ void CheMPS2::DMRG::solve_fock( const int dmrg_orb1, const int dmrg_orb2, const
          delete oldS;
       }
       // MPI_CHEMPS2_MASTER decomposes newS. Each MPI process returns the correct discarded_weight. Each MPI process has the new MPS tensors set.
-      const double discarded_weight = newS->Split( MPS[ dmrg_orb1 ], MPS[ dmrg_orb2 ], OptScheme->get_D( OptScheme->get_number() - 1 ), true, true );
+      const double discarded_weight = newS->Split( MPS[ dmrg_orb1 ], MPS[ dmrg_orb2 ], OptScheme->get_D( OptScheme->get_number() - 1 ), true, true, 0, NULL, NULL, workspace );
       delete newS;
    }
 
@@ -276,7 +310,7 @@ void CheMPS2::DMRG::solve_fock( const int dmrg_orb1, const int dmrg_orb2, const
                      if ( noise_level > 0.0 ){ newS->addNoise( noise_level ); }
                   }
                   // MPI_CHEMPS2_MASTER decomposes newS. Each MPI process returns the correct discarded_weight. Each MPI process has the new MPS tensors set.
-                  const double discarded_weight = newS->Split( MPS[ index ], MPS[ index + 1 ], OptScheme->get_D( instruction ), false, change );
+                  const double discarded_weight = newS->Split( MPS[ index ], MPS[ index + 1 ], OptScheme->get_D( instruction ), false, change, 0, NULL, NULL, workspace, OptScheme->get_max_discarded_weight( instruction ), OptScheme->get_D_min( instruction ) );
                   if ( discarded_weight > MaxDiscWeightLastSweep ){ MaxDiscWeightLastSweep = discarded_weight; }
                   delete newS;
                   if ( am_i_master ){
@@ -298,7 +332,7 @@ void CheMPS2::DMRG::solve_fock( const int dmrg_orb1, const int dmrg_orb2, const
                      if ( noise_level > 0.0 ){ newS->addNoise( noise_level ); }
                   }
                   // MPI_CHEMPS2_MASTER decomposes newS. Each MPI process returns the correct discarded_weight. Each MPI process has the new MPS tensors set.
-                  const double discarded_weight = newS->Split( MPS[ index ], MPS[ index + 1 ], OptScheme->get_D( instruction ), true, change );
+                  const double discarded_weight = newS->Split( MPS[ index ], MPS[ index + 1 ], OptScheme->get_D( instruction ), true, change, 0, NULL, NULL, workspace, OptScheme->get_max_discarded_weight( instruction ), OptScheme->get_D_min( instruction ) );
                   if ( discarded_weight > MaxDiscWeightLastSweep ){ MaxDiscWeightLastSweep = discarded_weight; }
                   delete newS;
                   if ( am_i_master ){
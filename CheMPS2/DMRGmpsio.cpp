@@ -18,11 +18,38 @@
 */
 
 #include <iostream>
+#include <iomanip>
+#include <fstream>
 #include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+#include <math.h>
+#include <assert.h>
 #include <sstream>
 #include <string>
+#include <sys/stat.h>
+#include <sys/time.h>
 
 #include "DMRG.h"
+#include "MPIchemps2.h"
+
+using std::cout;
+using std::endl;
+
+void CheMPS2::DMRG::setCheckpointInterval( const double seconds ){
+
+   ckpt_interval = seconds;
+
+}
+
+void CheMPS2::DMRG::setDavidsonDistributeSize( const long long size ){
+
+   dvdson_distribute = size;
+
+}
 
 void CheMPS2::DMRG::saveMPS(const std::string name, TensorT ** MPSlocation, SyBookkeeper * BKlocation, bool isConverged) const{
  
@@ -167,6 +194,356 @@ void CheMPS2::DMRG::deleteStoredMPS(){
    thestream << "rm " << CheMPS2::DMRG_MPS_storage_prefix << "*.h5";
    int info = system(thestream.str().c_str());
    std::cout << "Info on DMRG::MPS rm call to system: " << info << std::endl;
+   delete_restart_operators();
+
+}
+
+std::string CheMPS2::DMRG::restart_prefix() const{
+
+   /* The restart files of a job are keyed on the absolute path of its MPS checkpoint and on its Hamiltonian, which both survive
+      a restart, so that jobs which share tempfolder do not overwrite, load, or delete each other's restart files */
+   unsigned long long key = ham_fingerprint;
+   char workdir[ PATH_MAX ];
+   const std::string mps_path = (( getcwd( workdir, PATH_MAX ) != NULL ) ? std::string( workdir ) + "/" : "" ) + MPSstoragename;
+   fnv1a( key, mps_path.c_str(), mps_path.length() );
+
+   std::stringstream theprefix;
+   theprefix << tempfolder << "/" << CheMPS2::DMRG_RESTART_storage_prefix << std::hex << std::setw( 16 ) << std::setfill( '0' ) << key << "_";
+   return theprefix.str();
+
+}
+
+std::string CheMPS2::DMRG::restart_filename( const int generation, const int index ) const{
+
+   std::stringstream thefilename;
+   thefilename << restart_prefix() << generation % 2 << "_index_" << index;
+   #ifdef CHEMPS2_MPI_COMPILATION
+   thefilename << "_rank_" << MPIchemps2::mpi_rank();
+   #endif
+   return thefilename.str();
+
+}
+
+void CheMPS2::DMRG::delete_restart_operators(){
+
+   if ( ckpt_files == false ){ return; }
+
+   std::stringstream temp;
+   temp << "rm -f " << restart_prefix() << "*_index_*";
+   #ifdef CHEMPS2_MPI_COMPILATION
+   temp << "_rank_" << MPIchemps2::mpi_rank();
+   #endif
+   temp << op_storage->extension();
+   int info = system( temp.str().c_str() );
+   std::cout << "Info on DMRG::restart rm call to system: " << info << std::endl;
+   ckpt_files = false;
+
+}
+
+unsigned long long CheMPS2::DMRG::hamiltonian_fingerprint() const{
+
+   // 64-bit FNV-1a hash of the raw bytes of the targeted state and the matrix elements, which changes when the Hamiltonian or the orbital ordering changes
+   unsigned long long fingerprint = 14695981039346656037ULL;
+   const int target[ 4 ] = { L, Prob->gN(), Prob->gTwoS(), Prob->gIrrep() };
+   const double econst = Prob->gEconst();
+   fnv1a( fingerprint, target, sizeof( target ) );
+   fnv1a( fingerprint, &econst, sizeof( econst ) );
+   const long long num_elements = ( ( long long ) L ) * L * L * L;
+   for ( long long idx = 0; idx < num_elements; idx++ ){
+      const int i1 = idx % L;
+      const int i2 = ( idx / L ) % L;
+      const int i3 = ( idx / ( L * L ) ) % L;
+      const int i4 = idx / ( L * L * L );
+      const double element = Prob->gMxElement( i1, i2, i3, i4 );
+      fnv1a( fingerprint, &element, sizeof( element ) );
+   }
+   return fingerprint;
+
+}
+
+void CheMPS2::DMRG::fnv1a( unsigned long long & hash, const void * data, const int num_bytes ){
+
+   const unsigned char * bytes = static_cast<const unsigned char *>( data );
+   for ( int cnt = 0; cnt < num_bytes; cnt++ ){
+      hash ^= bytes[ cnt ];
+      hash *= 1099511628211ULL;
+   }
+
+}
+
+void CheMPS2::DMRG::checkpoint_sweep( const int index, const bool moving_right, const double noise_level ){
+
+   if (( makecheckpoints == false ) || ( ckpt_interval < 0.0 ) || ( Exc_activated ) || ( SA_num_roots > 1 )){ return; }
+
+   struct timeval now;
+   gettimeofday( &now, NULL );
+   int due = (( now.tv_sec + 1e-6 * now.tv_usec - ckpt_last >= ckpt_interval ) ? 1 : 0 );
+   #ifdef CHEMPS2_MPI_COMPILATION
+   MPIchemps2::broadcast_array_int( &due, 1, MPI_CHEMPS2_MASTER ); // All processes should agree
+   #endif
+   if ( due == 0 ){ return; }
+
+   pos_right   = moving_right;
+   pos_started = true;
+   pos_index   = index;
+   pos_noise   = noise_level;
+   write_checkpoint( true );
+
+}
+
+void CheMPS2::DMRG::write_checkpoint( const bool operators ){
+
+   #ifdef CHEMPS2_MPI_COMPILATION
+      const bool am_i_master = ( MPIchemps2::mpi_rank() == MPI_CHEMPS2_MASTER );
+   #else
+      const bool am_i_master = true;
+   #endif
+
+   struct timeval start, end;
+   gettimeofday( &start, NULL );
+
+   /* The renormalized operators are written to the files of the next generation, and the MPS file, which refers to that generation,
+      is replaced afterwards. When the process is killed in between, the MPS file still refers to the intact previous generation. */
+   const int generation = ( operators ) ? ckpt_generation + 1 : ckpt_generation;
+   long long num_doubles = 0;
+   if ( operators ){
+      io_sync();
+      ckpt_files = true;
+      for ( int index = 0; index < L - 1; index++ ){
+         if ( isAllocated[ index ] != 0 ){
+            OperatorsOnDisk( index, ( isAllocated[ index ] == 1 ), true, restart_filename( generation, index ) );
+            num_doubles += op_size[ index ];
+         } else if ( op_on_disk[ index ] != 0 ){ // Spilled to tempfolder: copy the file
+            const std::string source_name = operator_filename( index ) + op_storage->extension();
+            const std::string target_name = restart_filename( generation, index ) + op_storage->extension();
+            std::ifstream source( source_name.c_str(), std::ios::binary );
+            if ( source.good() == false ){ checkpoint_fail( "Could not open the spilled operator file", source_name, errno ); }
+            std::ofstream target( target_name.c_str(), std::ios::binary | std::ios::trunc );
+            if ( target.good() == false ){ checkpoint_fail( "Could not create the restart file", target_name, errno ); }
+            target << source.rdbuf();
+            target.close();
+            if ( target.fail() ){ checkpoint_fail( "Could not write the restart file", target_name, errno ); }
+         }
+      }
+      #ifdef CHEMPS2_MPI_COMPILATION
+      MPIchemps2::all_booleans_equal( true ); // All processes have stored their renormalized operators
+      #endif
+   }
+
+   if ( am_i_master ){ // Only the master proc makes MPS checkpoints !!
+      const std::string tempname = MPSstoragename + ".tmp";
+      saveMPS( tempname, MPS, denBK, false );
+      save_restart_state( tempname, operators );
+      if ( rename( tempname.c_str(), MPSstoragename.c_str() ) != 0 ){ checkpoint_fail( "Could not rename the MPS checkpoint to", MPSstoragename, errno ); }
+   }
+
+   if ( operators ){
+      ckpt_generation = generation;
+      gettimeofday( &end, NULL );
+      ckpt_last = end.tv_sec + 1e-6 * end.tv_usec;
+      if ( am_i_master ){
+         const double elapsed = ( end.tv_sec - start.tv_sec ) + 1e-6 * ( end.tv_usec - start.tv_usec );
+         cout << "Checkpoint " << generation << " before site " << pos_index << " of the " << (( pos_right ) ? "right" : "left" ) << " sweep " << pos_sweep
+              << " of instruction " << pos_instruction << " written in " << elapsed << " seconds ( " << 8e-9 * num_doubles << " GB from memory )." << endl;
+      }
+   } else {
+      #ifdef CHEMPS2_MPI_COMPILATION
+      MPIchemps2::all_booleans_equal( true ); // The MPS file no longer refers to the renormalized operators
+      #endif
+      delete_restart_operators();
+   }
+
+}
+
+void CheMPS2::DMRG::checkpoint_fail( const std::string message, const std::string filename, const int error ){
+
+   std::cerr << "CheMPS2::DMRG : " << message << " " << filename;
+   if ( error != 0 ){ std::cerr << " : " << strerror( error ); }
+   std::cerr << std::endl;
+   exit( EXIT_FAILURE );
+
+}
+
+void CheMPS2::DMRG::save_restart_state( const std::string name, const bool operators ) const{
+
+   hid_t file_id = H5Fopen( name.c_str(), H5F_ACC_RDWR, H5P_DEFAULT );
+   if ( H5Lexists( file_id, "/Restart", H5P_DEFAULT ) > 0 ){ H5Ldelete( file_id, "/Restart", H5P_DEFAULT ); }
+   hid_t group_id = H5Gcreate( file_id, "/Restart", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
+
+      int position[ 8 ] = { pos_instruction, pos_sweep, (( pos_right ) ? 1 : 0 ), (( operators ) ? 1 : 0 ), pos_index, (( pos_change ) ? 1 : 0 ),
+                            ckpt_generation + (( operators ) ? 1 : 0 ), MPIchemps2::mpi_size() };
+      double energies[ 9 ] = { TotalMinEnergy, LastMinEnergy, MaxDiscWeightLastSweep, pos_noise, pos_energy, pos_energy_prev, 0.0, MinRtolLastSweep, MaxRtolLastSweep }; // energies[ 6 ] is unused
+      long long matvecs[ 2 ] = { NumMatvecLastSweep, NumMatvecInstruction };
+      int * types = new int[ L - 1 ];
+      for ( int index = 0; index < L - 1; index++ ){ types[ index ] = (( isAllocated[ index ] != 0 ) ? isAllocated[ index ] : op_on_disk[ index ] ); }
+
+      const int num_sets = 9;
+      const char * set_names[ num_sets ] = { "Position", "Energies", "Matvecs", "Operators", "DiscWeightBonds", "SiteEnergies", "SiteEnergyChanges", "Ownership", "Fingerprint" };
+      const hid_t file_types[ num_sets ] = { H5T_STD_I32LE, H5T_IEEE_F64LE, H5T_STD_I64LE, H5T_STD_I32LE, H5T_IEEE_F64LE, H5T_IEEE_F64LE, H5T_IEEE_F64LE, H5T_STD_I32LE, H5T_STD_U64LE };
+      const hid_t mem_types[ num_sets ] = { H5T_NATIVE_INT, H5T_NATIVE_DOUBLE, H5T_NATIVE_LLONG, H5T_NATIVE_INT, H5T_NATIVE_DOUBLE, H5T_NATIVE_DOUBLE, H5T_NATIVE_DOUBLE, H5T_NATIVE_INT, H5T_NATIVE_ULLONG };
+      const hsize_t lengths[ num_sets ] = { 8, 9, 2, ( hsize_t )( L - 1 ), ( hsize_t )( L + 1 ), ( hsize_t )( L ), ( hsize_t )( L ), ( hsize_t )( balance->gTableSize() ), 1 };
+      const void * data[ num_sets ] = { position, energies, matvecs, types, DiscWeightBonds, SiteEnergies, SiteEnergyChanges, balance->gTable(), &ham_fingerprint };
+
+      for ( int set = 0; set < num_sets; set++ ){
+         hid_t dataspace_id = H5Screate_simple( 1, lengths + set, NULL );
+         hid_t dataset_id   = H5Dcreate( group_id, set_names[ set ], file_types[ set ], dataspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
+         H5Dwrite( dataset_id, mem_types[ set ], H5S_ALL, H5S_ALL, H5P_DEFAULT, data[ set ] );
+         H5Dclose( dataset_id );
+         H5Sclose( dataspace_id );
+      }
+      delete [] types;
+
+   H5Gclose( group_id );
+   H5Fclose( file_id );
+
+}
+
+bool CheMPS2::DMRG::resume_checkpoint(){
+
+   if (( loadedMPS == false ) || ( nStates > 1 )){ return false; }
+
+   int position[ 8 ];
+   double energies[ 9 ];
+   long long matvecs[ 2 ];
+   int * types = new int[ L - 1 ];
+   double * disc_weights = new double[ L + 1 ];
+   double * site_energies = new double[ L ];
+   double * site_changes = new double[ L ];
+   int * owners = new int[ balance->gTableSize() ];
+   bool has_owners = false;
+   unsigned long long fingerprint = 0;
+   bool has_fingerprint = false;
+
+   hid_t file_id = H5Fopen( MPSstoragename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT );
+   bool found = ( H5Lexists( file_id, "/Restart", H5P_DEFAULT ) > 0 ); // Not present in the checkpoints of older versions
+   if ( found ){
+      hid_t group_id = H5Gopen( file_id, "/Restart", H5P_DEFAULT );
+         const int num_sets = 7;
+         const char * set_names[ num_sets ] = { "Position", "Energies", "Matvecs", "Operators", "DiscWeightBonds", "SiteEnergies", "SiteEnergyChanges" };
+         const hid_t mem_types[ num_sets ] = { H5T_NATIVE_INT, H5T_NATIVE_DOUBLE, H5T_NATIVE_LLONG, H5T_NATIVE_INT, H5T_NATIVE_DOUBLE, H5T_NATIVE_DOUBLE, H5T_NATIVE_DOUBLE };
+         void * data[ num_sets ] = { position, energies, matvecs, types, disc_weights, site_energies, site_changes };
+         for ( int set = 0; set < num_sets; set++ ){
+            hid_t dataset_id = H5Dopen( group_id, set_names[ set ], H5P_DEFAULT );
+            H5Dread( dataset_id, mem_types[ set ], H5S_ALL, H5S_ALL, H5P_DEFAULT, data[ set ] );
+            H5Dclose( dataset_id );
+         }
+         has_owners = ( H5Lexists( group_id, "Ownership", H5P_DEFAULT ) > 0 ); // Round-robin in the checkpoints of older versions
+         if ( has_owners ){
+            hid_t dataset_id = H5Dopen( group_id, "Ownership", H5P_DEFAULT );
+            H5Dread( dataset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, owners );
+            H5Dclose( dataset_id );
+         }
+         has_fingerprint = ( H5Lexists( group_id, "Fingerprint", H5P_DEFAULT ) > 0 ); // A weighted sum in the energies of older versions, which is not accepted
+         if ( has_fingerprint ){
+            hid_t dataset_id = H5Dopen( group_id, "Fingerprint", H5P_DEFAULT );
+            H5Dread( dataset_id, H5T_NATIVE_ULLONG, H5S_ALL, H5S_ALL, H5P_DEFAULT, &fingerprint );
+            H5Dclose( dataset_id );
+         }
+      H5Gclose( group_id );
+   }
+   H5Fclose( file_id );
+
+   bool valid = (( found ) && ( position[ 0 ] >= 0 )); // A negative instruction means that Solve() had finished
+   if ( valid ){
+      pos_instruction = position[ 0 ];
+      pos_sweep       = position[ 1 ];
+      pos_right       = ( position[ 2 ] == 1 );
+      pos_started     = ( position[ 3 ] == 1 );
+      pos_index       = position[ 4 ];
+      pos_change      = ( position[ 5 ] == 1 );
+      pos_noise       = energies[ 3 ];
+      pos_energy      = energies[ 4 ];
+      pos_energy_prev = energies[ 5 ];
+      resume_pending  = true;
+
+      // The checkpoint should belong to the same calculation
+      valid = (( pos_instruction < OptScheme->get_number() ) && ( has_fingerprint ) && ( fingerprint == ham_fingerprint ));
+      if ( pos_started ){
+         valid = (( valid ) && ( position[ 7 ] == MPIchemps2::mpi_size() ));
+         for ( int index = 0; index < L - 1; index++ ){ // Also fails when the storage format differs
+            struct stat file_info;
+            if (( types[ index ] != 0 ) && ( stat( ( restart_filename( position[ 6 ], index ) + op_storage->extension() ).c_str(), &file_info ) != 0 )){ valid = false; }
+         }
+      }
+   }
+   #ifdef CHEMPS2_MPI_COMPILATION
+   valid = (( MPIchemps2::all_booleans_equal( valid ) ) && ( valid ));
+   const bool am_i_master = ( MPIchemps2::mpi_rank() == MPI_CHEMPS2_MASTER );
+   #else
+   const bool am_i_master = true;
+   #endif
+
+   if (( resume_pending ) && ( valid == false )){
+      if ( am_i_master ){ cout << "The restart position in " << MPSstoragename << " does not match this calculation: only the MPS is used." << endl; }
+      discard_checkpoint();
+   }
+
+   if ( valid ){
+      if ( pos_started ){ // Load the renormalized operators of the checkpoint, with the MPI processes which own them
+         ckpt_generation = position[ 6 ];
+         ckpt_files      = true;
+         deleteAllBoundaryOperators();
+         if ( has_owners ){
+            for ( int item = 0; item < balance->gTableSize(); item++ ){ balance->gTable()[ item ] = owners[ item ]; }
+         }
+         balance->changed( denBK );
+         const bool one_site = (( OptScheme->get_one_site( pos_instruction ) ) && ( Exc_activated == false ) && ( SA_num_roots == 1 ));
+         const int keep1 = pos_index - 1;
+         const int keep2 = ( one_site ) ? pos_index     : pos_index + 1;
+         for ( int required = 0; required < 2; required++ ){ // The boundaries for the next site are loaded last, so that they remain in memory
+            for ( int index = 0; index < L - 1; index++ ){
+               const bool is_required = (( index == keep1 ) || ( index == keep2 ));
+               if (( types[ index ] != 0 ) && ( is_required == ( required == 1 ) )){
+                  boundary_allocate( index, ( types[ index ] == 1 ) );
+                  OperatorsOnDisk( index, ( types[ index ] == 1 ), false, restart_filename( ckpt_generation, index ) );
+                  boundary_updated( index );
+                  boundary_spill( keep1, keep2, -1 );
+                  io_launch( -1, true );
+                  io_sync();
+               }
+            }
+         }
+      } else {
+         resume_pending = false;
+         PreSolve(); // The position is the start of a left-right sweep
+         resume_pending = true;
+      }
+      TotalMinEnergy         = energies[ 0 ];
+      LastMinEnergy          = energies[ 1 ];
+      MaxDiscWeightLastSweep = energies[ 2 ];
+      MinRtolLastSweep       = energies[ 7 ];
+      MaxRtolLastSweep       = energies[ 8 ];
+      NumMatvecLastSweep     = matvecs[ 0 ];
+      NumMatvecInstruction   = matvecs[ 1 ];
+      for ( int bound = 0; bound <= L; bound++ ){ DiscWeightBonds[ bound ] = disc_weights[ bound ]; }
+      for ( int site = 0; site < L; site++ ){
+         SiteEnergies[ site ]      = site_energies[ site ];
+         SiteEnergyChanges[ site ] = site_changes[ site ];
+      }
+      if ( am_i_master ){
+         cout << "Resuming at ";
+         if ( pos_started ){ cout << "site " << pos_index << " of the " << (( pos_right ) ? "right" : "left" ) << " sweep "; }
+         else { cout << "the left-right sweep "; }
+         cout << pos_sweep << " of instruction " << pos_instruction << " from " << MPSstoragename << "." << endl;
+      }
+   }
+
+   delete [] types;
+   delete [] disc_weights;
+   delete [] site_energies;
+   delete [] site_changes;
+   delete [] owners;
+   return valid;
+
+}
+
+void CheMPS2::DMRG::discard_checkpoint(){
+
+   if ( resume_pending == false ){ return; }
+   resume_pending = false;
+   if ( pos_started ){ // The checkpointed MPS is in mixed-canonical form: bring it to the LLLLLLLC gauge
+      for ( int site = 0; site < L - 1; site++ ){ left_normalize( MPS[ site ], MPS[ site + 1 ] ); }
+   }
 
 }
 
@@ -32,210 +32,298 @@
 
 void CheMPS2::DMRG::updateMovingRightSafeFirstTime(const int cnt){
 
-   if (isAllocated[cnt]==2){
-      deleteTensors(cnt, false);
-      isAllocated[cnt]=0;
-   }
-   if (isAllocated[cnt]==0){
-      allocateTensors(cnt, true);
-      isAllocated[cnt]=1;
-   }
+   io_sync();
+   if (isAllocated[cnt]==2){ boundary_delete(cnt); }
+   if (isAllocated[cnt]==0){ boundary_allocate(cnt, true); }
    updateMovingRight(cnt);
+   boundary_updated(cnt);
    
-   if (CheMPS2::DMRG_storeRenormOptrOnDisk){
-      if (cnt>0){
-         if (isAllocated[cnt-1]==1){
-            OperatorsOnDisk(cnt-1, true, true);
-            deleteTensors(cnt-1, true);
-            isAllocated[cnt-1]=0;
-         }
-      }
-   }
+   boundary_spill(cnt, -1, -1);
+   io_launch(-1, true);
 
 }
 
 void CheMPS2::DMRG::updateMovingLeftSafeFirstTime(const int cnt){
 
-   if (isAllocated[cnt]==1){
-      deleteTensors(cnt, true);
-      isAllocated[cnt]=0;
-   }
-   if (isAllocated[cnt]==0){
-      allocateTensors(cnt, false);
-      isAllocated[cnt]=2;
-   }
+   io_sync();
+   if (isAllocated[cnt]==1){ boundary_delete(cnt); }
+   if (isAllocated[cnt]==0){ boundary_allocate(cnt, false); }
    updateMovingLeft(cnt);
+   boundary_updated(cnt);
 
-   if (CheMPS2::DMRG_storeRenormOptrOnDisk){
-      if (cnt+1<L-1){
-         if (isAllocated[cnt+1]==2){
-            OperatorsOnDisk(cnt+1, false, true);
-            deleteTensors(cnt+1, false);
-            isAllocated[cnt+1]=0;
-         }
-      }
-   }
+   boundary_spill(cnt, -1, -1);
+   io_launch(-1, false);
 
 }
 
 void CheMPS2::DMRG::updateMovingRightSafe(const int cnt){
 
-   if (isAllocated[cnt]==2){
-      deleteTensors(cnt, false);
-      isAllocated[cnt]=0;
-   }
-   if (isAllocated[cnt]==0){
-      allocateTensors(cnt, true);
-      isAllocated[cnt]=1;
-   }
+   io_sync();
+   if (isAllocated[cnt]==2){ boundary_delete(cnt); }
+   if (isAllocated[cnt]==0){ boundary_allocate(cnt, true); }
    updateMovingRight(cnt);
+   boundary_updated(cnt);
    
-   if (CheMPS2::DMRG_storeRenormOptrOnDisk){
-      if (cnt>0){
-         if (isAllocated[cnt-1]==1){
-            OperatorsOnDisk(cnt-1, true, true);
-            deleteTensors(cnt-1, true);
-            isAllocated[cnt-1]=0;
-         }
-      }
-      if (cnt+1<L-1){
-         if (isAllocated[cnt+1]==2){
-            deleteTensors(cnt+1, false);
-            isAllocated[cnt+1]=0;
-         }
-      }
-      if (cnt+2<L-1){
-         if (isAllocated[cnt+2]==1){
-            deleteTensors(cnt+2, true);
-            isAllocated[cnt+2]=0;
-         }
-         if (isAllocated[cnt+2]==0){
-            allocateTensors(cnt+2, false);
-            isAllocated[cnt+2]=2;
-         }
-         OperatorsOnDisk(cnt+2, false, false);
-      }
+   if (cnt+1<L-1){
+      if (isAllocated[cnt+1]==2){ boundary_delete(cnt+1); } // Is recomputed before it is needed again
+   }
+   if (cnt+2<L-1){ boundary_load(cnt+2, false); }
+   int load_index = -1;
+   if (cnt+3<L-1){ // Prefetch the operators for the next step
+      if (boundary_prefetch(cnt+3, false)){ load_index = cnt+3; }
    }
+   boundary_spill(cnt, cnt+2, cnt+3);
+   io_launch(load_index, false);
 
 }
 
 void CheMPS2::DMRG::updateMovingLeftSafe(const int cnt){
 
-   if (isAllocated[cnt]==1){
-      deleteTensors(cnt, true);
-      isAllocated[cnt]=0;
-   }
-   if (isAllocated[cnt]==0){
-      allocateTensors(cnt, false);
-      isAllocated[cnt]=2;
-   }
+   io_sync();
+   if (isAllocated[cnt]==1){ boundary_delete(cnt); }
+   if (isAllocated[cnt]==0){ boundary_allocate(cnt, false); }
    updateMovingLeft(cnt);
+   boundary_updated(cnt);
    
-   if (CheMPS2::DMRG_storeRenormOptrOnDisk){
-      if (cnt+1<L-1){
-         if (isAllocated[cnt+1]==2){
-            OperatorsOnDisk(cnt+1, false, true);
-            deleteTensors(cnt+1, false);
-            isAllocated[cnt+1]=0;
-         }
-      }
-      if (cnt-1>=0){
-         if (isAllocated[cnt-1]==1){
-            deleteTensors(cnt-1, true);
-            isAllocated[cnt-1]=0;
-         }
-      }
-      if (cnt-2>=0){
-         if (isAllocated[cnt-2]==2){
-            deleteTensors(cnt-2, false);
-            isAllocated[cnt-2]=0;
-         }
-         if (isAllocated[cnt-2]==0){
-            allocateTensors(cnt-2, true);
-            isAllocated[cnt-2]=1;
-         }
-         OperatorsOnDisk(cnt-2, true, false);
-      }
+   if (cnt-1>=0){
+      if (isAllocated[cnt-1]==1){ boundary_delete(cnt-1); } // Is recomputed before it is needed again
+   }
+   if (cnt-2>=0){ boundary_load(cnt-2, true); }
+   int load_index = -1;
+   if (cnt-3>=0){ // Prefetch the operators for the next step
+      if (boundary_prefetch(cnt-3, true)){ load_index = cnt-3; }
    }
+   boundary_spill(cnt, cnt-2, cnt-3);
+   io_launch(load_index, true);
 
 }
 
 void CheMPS2::DMRG::updateMovingRightSafe2DM(const int cnt){
 
-   if (isAllocated[cnt]==2){
-      deleteTensors(cnt, false);
-      isAllocated[cnt]=0;
-   }
-   if (isAllocated[cnt]==0){
-      allocateTensors(cnt, true);
-      isAllocated[cnt]=1;
-   }
+   io_sync();
+   if (isAllocated[cnt]==2){ boundary_delete(cnt); }
+   if (isAllocated[cnt]==0){ boundary_allocate(cnt, true); }
    updateMovingRight(cnt);
+   boundary_updated(cnt);
    
-   if (CheMPS2::DMRG_storeRenormOptrOnDisk){
-      if (cnt>0){
-         if (isAllocated[cnt-1]==1){
-            OperatorsOnDisk(cnt-1, true, true);
-            deleteTensors(cnt-1, true);
-            isAllocated[cnt-1]=0;
-         }
-      }
-      if (cnt+1<L-1){
-         if (isAllocated[cnt+1]==1){
-            deleteTensors(cnt+1, true);
-            isAllocated[cnt+1]=0;
-         }
-         if (isAllocated[cnt+1]==0){
-            allocateTensors(cnt+1, false);
-            isAllocated[cnt+1]=2;
-         }
-         OperatorsOnDisk(cnt+1, false, false);
-      }
-   }
+   if (cnt+1<L-1){ boundary_load(cnt+1, false); }
+   boundary_spill(cnt, cnt+1, -1);
+   io_launch(-1, false);
+   io_sync(); // The 3-RDM may use HDF5 in between
 
 }
 
 void CheMPS2::DMRG::updateMovingLeftSafe2DM(const int cnt){
 
-   if (isAllocated[cnt]==1){
-      deleteTensors(cnt, true);
-      isAllocated[cnt]=0;
-   }
-   if (isAllocated[cnt]==0){
-      allocateTensors(cnt, false);
-      isAllocated[cnt]=2;
-   }
+   io_sync();
+   if (isAllocated[cnt]==1){ boundary_delete(cnt); }
+   if (isAllocated[cnt]==0){ boundary_allocate(cnt, false); }
    updateMovingLeft(cnt);
+   boundary_updated(cnt);
    
-   if (CheMPS2::DMRG_storeRenormOptrOnDisk){
-      if (cnt+1<L-1){
-         if (isAllocated[cnt+1]==2){
-            OperatorsOnDisk(cnt+1, false, true);
-            deleteTensors(cnt+1, false);
-            isAllocated[cnt+1]=0;
-         }
+   if (cnt-1>=0){ boundary_load(cnt-1, true); }
+   boundary_spill(cnt, cnt-1, -1);
+   io_launch(-1, true);
+   io_sync(); // The 3-RDM may use HDF5 in between
+
+}
+
+void CheMPS2::DMRG::updateSafeOneSite(const int cnt, const bool movingRight, const bool sweepRight){
+
+   io_sync();
+   if (movingRight){
+      if (cnt-1>=0){ boundary_load(cnt-1, true); }
+      if (isAllocated[cnt]==2){ boundary_delete(cnt); }
+      if (isAllocated[cnt]==0){ boundary_allocate(cnt, true); }
+      updateMovingRight(cnt);
+   } else {
+      if (cnt+1<L-1){ boundary_load(cnt+1, false); }
+      if (isAllocated[cnt]==1){ boundary_delete(cnt); }
+      if (isAllocated[cnt]==0){ boundary_allocate(cnt, false); }
+      updateMovingLeft(cnt);
+   }
+   boundary_updated(cnt);
+
+   // The next site is solved with the boundaries site-1 (L) and site (R)
+   const int site = (movingRight) ? cnt+1 : cnt;
+   const int next = (sweepRight) ? site+1 : site-2;
+   if ((site-1>=0) && (site-1!=cnt)){ boundary_load(site-1, true); }
+   if ((site<L-1) && (site!=cnt)){ boundary_load(site, false); }
+   int load_index = -1;
+   if ((next>=0) && (next<L-1)){ // Prefetch the operators for the next step
+      if (boundary_prefetch(next, sweepRight==false)){ load_index = next; }
+   }
+   boundary_spill(cnt, (cnt==site-1) ? site : site-1, next);
+   io_launch(load_index, sweepRight==false);
+
+}
+
+void CheMPS2::DMRG::boundary_allocate( const int index, const bool movingRight ){
+
+   assert( isAllocated[ index ] == 0 );
+   allocateTensors( index, movingRight );
+   isAllocated[ index ] = (( movingRight ) ? 1 : 2 );
+   op_size[ index ]     = sizeTensors( index );
+   op_resident         += op_size[ index ];
+
+}
+
+void CheMPS2::DMRG::boundary_delete( const int index ){
+
+   if ( isAllocated[ index ] == 0 ){ return; }
+   deleteTensors( index, ( isAllocated[ index ] == 1 ) );
+   isAllocated[ index ] = 0;
+   op_resident         -= op_size[ index ];
+   op_size[ index ]     = 0;
+
+}
+
+void CheMPS2::DMRG::boundary_updated( const int index ){
+
+   op_on_disk[ index ] = 0; // The copy on disk is outdated
+   op_clock++;
+   op_last_use[ index ] = op_clock;
+
+}
+
+void CheMPS2::DMRG::boundary_load( const int index, const bool movingRight ){
+
+   const int type = (( movingRight ) ? 1 : 2 );
+   if ( isAllocated[ index ] == 3 - type ){ boundary_delete( index ); }
+   if ( isAllocated[ index ] == 0 ){ // Not in memory or prefetched by the I/O stage
+      assert( op_on_disk[ index ] == type );
+      boundary_allocate( index, movingRight );
+      OperatorsOnDisk( index, movingRight, false, operator_filename( index ) );
+   }
+   op_clock++;
+   op_last_use[ index ] = op_clock;
+
+}
+
+bool CheMPS2::DMRG::boundary_prefetch( const int index, const bool movingRight ){
+
+   const int type = (( movingRight ) ? 1 : 2 );
+   if ( isAllocated[ index ] == 3 - type ){ boundary_delete( index ); }
+   op_clock++;
+   op_last_use[ index ] = op_clock;
+   if ( isAllocated[ index ] == type ){ return false; }
+   assert( op_on_disk[ index ] == type );
+   boundary_allocate( index, movingRight );
+   return true; // The I/O stage should read it
+
+}
+
+void CheMPS2::DMRG::boundary_spill( const int keep1, const int keep2, const int keep3 ){
+
+   assert( io_num_store == 0 );
+   if ( op_budget < 0 ){ return; }
+
+   long long resident = op_resident;
+   while ( resident > op_budget ){
+
+      // Find the least recently used boundary which is not required for the next site
+      int victim = -1;
+      for ( int index = 0; index < L - 1; index++ ){
+         bool candidate = (( isAllocated[ index ] != 0 ) && ( index != keep1 ) && ( index != keep2 ) && ( index != keep3 ));
+         for ( int cnt = 0; cnt < io_num_store; cnt++ ){ if ( io_store[ cnt ] == index ){ candidate = false; } }
+         if (( candidate ) && (( victim == -1 ) || ( op_last_use[ index ] < op_last_use[ victim ] ))){ victim = index; }
       }
-      if (cnt-1>=0){
-         if (isAllocated[cnt-1]==2){
-            deleteTensors(cnt-1, false);
-            isAllocated[cnt-1]=0;
-         }
-         if (isAllocated[cnt-1]==0){
-            allocateTensors(cnt-1, true);
-            isAllocated[cnt-1]=1;
-         }
-         OperatorsOnDisk(cnt-1, true, false);
+      if ( victim == -1 ){ return; } // The boundaries for the next site do not fit in the budget
+
+      resident -= op_size[ victim ];
+      if ( op_on_disk[ victim ] == isAllocated[ victim ] ){
+         boundary_delete( victim ); // The copy on disk is up to date
+      } else {
+         io_store[ io_num_store ] = victim; // Written and deleted by the I/O stage
+         io_num_store++;
       }
    }
 
 }
 
+void CheMPS2::DMRG::io_launch( const int load_index, const bool load_right ){
+
+   assert( io_busy == false );
+   if (( io_num_store == 0 ) && ( load_index == -1 )){ return; }
+
+   io_load_index = load_index;
+   io_load_right = load_right;
+   io_busy       = true; // io_sync() deletes the stored tensors afterwards
+   if ( io_num_store > 0 ){ op_files = true; }
+
+   /* The I/O stage only touches the tensors of the boundaries in io_store and io_load_index, which are
+      not needed by the next solve_site, and HDF5 is not called from the main thread before io_sync().
+      With MPI, the owner_* functions would be called from a second thread, which MPI_Init does not allow. */
+   #ifndef CHEMPS2_MPI_COMPILATION
+   if ( CheMPS2::DMRG_asyncOperatorIO ){
+      io_threaded = ( pthread_create( &io_thread, NULL, io_thread_entry, this ) == 0 );
+      if ( io_threaded ){ return; }
+   }
+   #endif
+
+   io_run();
+
+}
+
+void * CheMPS2::DMRG::io_thread_entry( void * dmrg ){
+
+   static_cast< DMRG * >( dmrg )->io_run();
+   return NULL;
+
+}
+
+void CheMPS2::DMRG::io_run(){
+
+   for ( int cnt = 0; cnt < io_num_store; cnt++ ){ OperatorsOnDisk( io_store[ cnt ], ( isAllocated[ io_store[ cnt ] ] == 1 ), true, operator_filename( io_store[ cnt ] ) ); }
+   if ( io_load_index != -1 ){ OperatorsOnDisk( io_load_index, io_load_right, false, operator_filename( io_load_index ) ); }
+
+}
+
+void CheMPS2::DMRG::io_sync(){
+
+   if ( io_busy == false ){ return; }
+
+   if ( io_threaded ){
+      struct timeval start, end;
+      gettimeofday(&start, NULL);
+      pthread_join( io_thread, NULL );
+      gettimeofday(&end, NULL);
+      timings[ CHEMPS2_TIME_DISK_WAIT ] += (end.tv_sec - start.tv_sec) + 1e-6 * (end.tv_usec - start.tv_usec);
+      io_threaded = false;
+   }
+   io_busy = false;
+
+   for ( int cnt = 0; cnt < io_num_store; cnt++ ){
+      op_on_disk[ io_store[ cnt ] ] = isAllocated[ io_store[ cnt ] ];
+      boundary_delete( io_store[ cnt ] );
+   }
+   io_num_store  = 0;
+   io_load_index = -1;
+
+}
+
 void CheMPS2::DMRG::deleteAllBoundaryOperators(){
 
+   io_sync();
    for (int cnt=0; cnt<L-1; cnt++){
-      if (isAllocated[cnt]==1){ deleteTensors(cnt, true); }
-      if (isAllocated[cnt]==2){ deleteTensors(cnt, false); }
-      isAllocated[cnt] = 0;
+      boundary_delete(cnt);
+      op_on_disk[cnt] = 0; // The MPS or the Hamiltonian changes afterwards
+   }
+
+}
+
+void CheMPS2::DMRG::rebalance_operators( const bool am_i_master ){
+
+   const double before = balance->imbalance( denBK );
+   if ( before <= CheMPS2::DMRG_MPI_REBALANCE_threshold ){ return; }
+
+   deleteAllBoundaryOperators();
+   balance->assign( denBK ); // No renormalized operators exist
+   for ( int cnt = 0; cnt < L - 2; cnt++ ){ updateMovingRightSafeFirstTime( cnt ); }
+   io_sync();
+
+   if ( am_i_master ){
+      std::cout << "DMRG::rebalance_operators : Estimated MPI load imbalance from " << before << " to " << balance->imbalance( denBK ) << "." << std::endl;
    }
 
 }
@@ -249,12 +337,52 @@ void CheMPS2::DMRG::updateMovingRight( const int index ){
    const int dimR = denBK->gMaxDimAtBound( index + 1 );
    #ifdef CHEMPS2_MPI_COMPILATION
    const int MPIRANK = MPIchemps2::mpi_rank();
+   struct timeval mid; // The local work for the load balance ends before the communication of the Q-tensors
+   std::vector< MPI_Request > requests; // Nonblocking transfers, completed after the Q-tensors
+   std::vector< std::pair< int, TensorQ * > > q_received; // The pieces of the other processes for the owned Q-tensors
+   std::vector< TensorQ * > q_sent;
+   const int owner_x = MPIchemps2::owner_x();
+   if ( index > 0 ){ // The tensors which owner_x needs for the X-tensor are not changed by this update: their transfers overlap with it
+      const int owner_q       = MPIchemps2::owner_q( L, index );
+      const int owner_absigma = MPIchemps2::owner_absigma( index, index );
+      const int owner_cdf     = MPIchemps2::owner_cdf( L, index, index );
+      const int Idiff         = 0; // Irreps::directProd( denBK->gIrrep( index ), denBK->gIrrep( index ) );
+
+      if ( owner_x != owner_q ){
+         if ( owner_x == MPIRANK ){
+            Qtensors[ index - 1 ][ 0 ] = new TensorQ( index, denBK->gIrrep( index ), true, denBK, Prob, index );
+            MPIchemps2::irecv_tensor( Qtensors[ index - 1 ][ 0 ], owner_q, 3 * L + 3, requests );
+         }
+         if ( owner_q == MPIRANK ){ MPIchemps2::isend_tensor( Qtensors[ index - 1 ][ 0 ], owner_x, 3 * L + 3, requests ); }
+      }
+
+      if ( owner_x != owner_absigma ){
+         if ( owner_x == MPIRANK ){
+            Atensors[ index - 1 ][ 0 ][ 0 ] = new TensorOperator( index, 0, 2, Idiff, true, true, false, denBK, denBK );
+            MPIchemps2::irecv_tensor( Atensors[ index - 1 ][ 0 ][ 0 ], owner_absigma, 3 * L + 4, requests );
+         }
+         if ( owner_absigma == MPIRANK ){ MPIchemps2::isend_tensor( Atensors[ index - 1 ][ 0 ][ 0 ], owner_x, 3 * L + 4, requests ); }
+      }
+
+      if ( owner_x != owner_cdf ){
+         if ( owner_x == MPIRANK ){
+            Ctensors[ index - 1 ][ 0 ][ 0 ] = new TensorOperator( index, 0, 0, Idiff, true, true, false, denBK, denBK );
+            Dtensors[ index - 1 ][ 0 ][ 0 ] = new TensorOperator( index, 2, 0, Idiff, true, true, false, denBK, denBK );
+            MPIchemps2::irecv_tensor( Ctensors[ index - 1 ][ 0 ][ 0 ], owner_cdf, 3 * L + 5, requests );
+            MPIchemps2::irecv_tensor( Dtensors[ index - 1 ][ 0 ][ 0 ], owner_cdf, 3 * L + 6, requests );
+         }
+         if ( owner_cdf == MPIRANK ){
+            MPIchemps2::isend_tensor( Ctensors[ index - 1 ][ 0 ][ 0 ], owner_x, 3 * L + 5, requests );
+            MPIchemps2::isend_tensor( Dtensors[ index - 1 ][ 0 ][ 0 ], owner_x, 3 * L + 6, requests );
+         }
+      }
+   }
    #endif
 
    #pragma omp parallel
    {
 
-      double * workmem = new double[ dimL * dimR ];
+      double * workmem = workspace->get_double( 0, dimL * dimR );
 
       //Ltensors : all processes own all Ltensors
       #pragma omp for schedule(static) nowait
@@ -407,6 +535,8 @@ void CheMPS2::DMRG::updateMovingRight( const int index ){
 
       // Qtensors : certain processes own certain Qtensors --- You don't want to locally parallellize when sending and receiving buffers!
       #ifdef CHEMPS2_MPI_COMPILATION
+         #pragma omp master
+         { gettimeofday( &mid, NULL ); } // The previous omp for ends with a barrier
          #pragma omp single
       #else
          #pragma omp for schedule(static) nowait
@@ -435,51 +565,56 @@ void CheMPS2::DMRG::updateMovingRight( const int index ){
             if (( owner_q == owner_absigma ) && ( owner_q == owner_cdf ) && ( owner_q == MPIRANK )){ // No MPI needed
             #endif
 
-               double * workmemBIS = new double[ dimL * dimL ];
+               double * workmemBIS = workspace->get_double( 1, dimL * dimL );
                Qtensors[ index ][ cnt2 ]->update( Qtensors[ index - 1 ][ cnt2 + 1 ], MPS[ index ], MPS[ index ], workmem );
                Qtensors[ index ][ cnt2 ]->AddTermSimple( MPS[ index ] );
                Qtensors[ index ][ cnt2 ]->AddTermsL( Ltensors[ index - 1 ], MPS[ index ], workmemBIS, workmem );
                Qtensors[ index ][ cnt2 ]->AddTermsAB( Atensors[ index - 1 ][ cnt2 + 1 ][ 0 ], Btensors[ index - 1 ][ cnt2 + 1 ][ 0 ], MPS[ index ], workmemBIS, workmem );
                Qtensors[ index ][ cnt2 ]->AddTermsCD( Ctensors[ index - 1 ][ cnt2 + 1 ][ 0 ], Dtensors[ index - 1 ][ cnt2 + 1 ][ 0 ], MPS[ index ], workmemBIS, workmem );
-               delete [] workmemBIS;
 
             #ifdef CHEMPS2_MPI_COMPILATION
-            } else { // There's going to have to be some communication
+            } else { // There's going to have to be some communication: posted here, completed after the loop
 
                if (( owner_q == MPIRANK ) || ( owner_absigma == MPIRANK ) || ( owner_cdf == MPIRANK )){
 
-                  TensorQ * tempQ = new TensorQ( index + 1, denBK->gIrrep( siteindex ), true, denBK, Prob, siteindex );
-                  tempQ->clear();
+                  // owner_q posts the receives of the other pieces before it computes its own piece in Qtensors[index][cnt2]
+                  TensorQ * mine = Qtensors[ index ][ cnt2 ];
+                  if ( owner_q == MPIRANK ){
+                     if ( owner_absigma != owner_q ){
+                        TensorQ * piece = new TensorQ( index + 1, denBK->gIrrep( siteindex ), true, denBK, Prob, siteindex );
+                        MPIchemps2::irecv_tensor( piece, owner_absigma, 2 * siteindex, requests );
+                        q_received.push_back( std::pair< int, TensorQ * >( cnt2, piece ) );
+                     }
+                     if (( owner_cdf != owner_q ) && ( owner_cdf != owner_absigma )){
+                        TensorQ * piece = new TensorQ( index + 1, denBK->gIrrep( siteindex ), true, denBK, Prob, siteindex );
+                        MPIchemps2::irecv_tensor( piece, owner_cdf, 2 * siteindex + 1, requests );
+                        q_received.push_back( std::pair< int, TensorQ * >( cnt2, piece ) );
+                     }
+                  } else {
+                     mine = new TensorQ( index + 1, denBK->gIrrep( siteindex ), true, denBK, Prob, siteindex );
+                  }
+                  mine->clear();
 
                   // Everyone creates his/her piece
-                  double * workmemBIS = new double[ dimL * dimL ];
+                  double * workmemBIS = workspace->get_double( 1, dimL * dimL );
                   if ( owner_q == MPIRANK ){
-                     tempQ->update( Qtensors[ index - 1 ][ cnt2 + 1 ], MPS[ index ], MPS[ index ], workmem );
-                     tempQ->AddTermSimple( MPS[ index ] );
-                     tempQ->AddTermsL( Ltensors[ index - 1 ], MPS[ index ], workmemBIS, workmem );
+                     mine->update( Qtensors[ index - 1 ][ cnt2 + 1 ], MPS[ index ], MPS[ index ], workmem );
+                     mine->AddTermSimple( MPS[ index ] );
+                     mine->AddTermsL( Ltensors[ index - 1 ], MPS[ index ], workmemBIS, workmem );
                   }
                   if ( owner_absigma == MPIRANK ){
-                     tempQ->AddTermsAB( Atensors[ index - 1 ][ cnt2 + 1 ][ 0 ], Btensors[ index - 1 ][ cnt2 + 1 ][ 0 ], MPS[ index ], workmemBIS, workmem );
+                     mine->AddTermsAB( Atensors[ index - 1 ][ cnt2 + 1 ][ 0 ], Btensors[ index - 1 ][ cnt2 + 1 ][ 0 ], MPS[ index ], workmemBIS, workmem );
                   }
                   if ( owner_cdf == MPIRANK ){
-                     tempQ->AddTermsCD( Ctensors[ index - 1 ][ cnt2 + 1 ][ 0 ], Dtensors[ index - 1 ][ cnt2 + 1 ][ 0 ], MPS[ index ], workmemBIS, workmem );
-                  }
-                  delete [] workmemBIS;
-
-                  // Add everything to owner_q's Qtensors[index][cnt2]: replace later with custom communication group?
-                  int inc = 1;
-                  int arraysize = tempQ->gKappa2index( tempQ->gNKappa() );
-                  double alpha = 1.0;
-                  if ( owner_q == MPIRANK ){ dcopy_( &arraysize, tempQ->gStorage(), &inc, Qtensors[ index ][ cnt2 ]->gStorage(), &inc ); }
-                  if ( owner_q != owner_absigma ){
-                     MPIchemps2::sendreceive_tensor( tempQ, owner_absigma, owner_q, 2 * siteindex );
-                     if ( owner_q == MPIRANK ){ daxpy_( &arraysize, &alpha, tempQ->gStorage(), &inc, Qtensors[ index ][ cnt2 ]->gStorage(), &inc ); }
+                     mine->AddTermsCD( Ctensors[ index - 1 ][ cnt2 + 1 ][ 0 ], Dtensors[ index - 1 ][ cnt2 + 1 ][ 0 ], MPS[ index ], workmemBIS, workmem );
                   }
-                  if (( owner_q != owner_cdf ) && ( owner_absigma != owner_cdf )){
-                     MPIchemps2::sendreceive_tensor( tempQ, owner_cdf, owner_q, 2 * siteindex + 1 );
-                     if ( owner_q == MPIRANK ){ daxpy_( &arraysize, &alpha, tempQ->gStorage(), &inc, Qtensors[ index ][ cnt2 ]->gStorage(), &inc ); }
+
+                  // The piece is sent while the next Q-tensor is computed
+                  if ( owner_q != MPIRANK ){
+                     MPIchemps2::isend_tensor( mine, owner_q, (( owner_absigma == MPIRANK ) ? 2 * siteindex : 2 * siteindex + 1 ), requests );
+                     q_sent.push_back( mine );
                   }
-                  delete tempQ;
+                  MPIchemps2::test_requests( requests );
 
                }
             }
@@ -487,14 +622,20 @@ void CheMPS2::DMRG::updateMovingRight( const int index ){
          }
       }
 
-      delete [] workmem;
-
    }
 
-   //Xtensors
    #ifdef CHEMPS2_MPI_COMPILATION
-   const int owner_x = MPIchemps2::owner_x();
+   // Complete the transfers, and add the received pieces to the owned Q-tensors
+   MPIchemps2::wait_requests( requests );
+   for ( int piece = 0; piece < ( int ) q_received.size(); piece++ ){
+      TensorQ * target = Qtensors[ index ][ q_received[ piece ].first ];
+      Special::daxpy64( target->gKappa2index( target->gNKappa() ), 1.0, q_received[ piece ].second->gStorage(), target->gStorage() );
+      delete q_received[ piece ].second;
+   }
+   for ( int piece = 0; piece < ( int ) q_sent.size(); piece++ ){ delete q_sent[ piece ]; }
    #endif
+
+   //Xtensors
    if ( index == 0 ){
 
       #ifdef CHEMPS2_MPI_COMPILATION
@@ -505,33 +646,10 @@ void CheMPS2::DMRG::updateMovingRight( const int index ){
    } else {
 
       #ifdef CHEMPS2_MPI_COMPILATION
-      //Make sure that owner_x has all required tensors to construct X. Not as optimal as Q-tensor case, but easier hack.
+      //Make sure that owner_x has all required tensors to construct X: their transfers were posted at the start
       const int owner_q       = MPIchemps2::owner_q( L, index );
       const int owner_absigma = MPIchemps2::owner_absigma( index, index );
       const int owner_cdf     = MPIchemps2::owner_cdf( L, index, index );
-      const int Idiff         = 0; // Irreps::directProd( denBK->gIrrep( index ), denBK->gIrrep( index ) );
-
-      if ( owner_x != owner_q ){
-         if ( owner_x == MPIRANK ){ Qtensors[ index - 1 ][ 0 ] = new TensorQ( index, denBK->gIrrep( index ), true, denBK, Prob, index ); }
-         if (( owner_x == MPIRANK ) || ( owner_q == MPIRANK )){ MPIchemps2::sendreceive_tensor( Qtensors[ index - 1 ][ 0 ], owner_q, owner_x, 3 * L + 3 ); }
-      }
-
-      if ( owner_x != owner_absigma ){
-         if ( owner_x == MPIRANK ){ Atensors[ index - 1 ][ 0 ][ 0 ] = new TensorOperator( index, 0, 2, Idiff, true, true, false, denBK, denBK ); }
-         if (( owner_x == MPIRANK ) || ( owner_absigma == MPIRANK )){ MPIchemps2::sendreceive_tensor( Atensors[ index - 1 ][ 0 ][ 0 ], owner_absigma, owner_x, 3 * L + 4 ); }
-      }
-
-      if ( owner_x != owner_cdf ){
-         if ( owner_x == MPIRANK ){
-            Ctensors[ index - 1 ][ 0 ][ 0 ] = new TensorOperator( index, 0, 0, Idiff, true, true, false, denBK, denBK );
-            Dtensors[ index - 1 ][ 0 ][ 0 ] = new TensorOperator( index, 2, 0, Idiff, true, true, false, denBK, denBK );
-         }
-         if (( owner_x == MPIRANK ) || ( owner_cdf == MPIRANK )){
-            MPIchemps2::sendreceive_tensor( Ctensors[ index - 1 ][ 0 ][ 0 ], owner_cdf, owner_x, 3 * L + 5 );
-            MPIchemps2::sendreceive_tensor( Dtensors[ index - 1 ][ 0 ][ 0 ], owner_cdf, owner_x, 3 * L + 6 );
-         }
-      }
-
       if ( owner_x == MPIRANK ){
       #endif
 
@@ -570,6 +688,9 @@ void CheMPS2::DMRG::updateMovingRight( const int index ){
 
    gettimeofday( &end, NULL );
    timings[ CHEMPS2_TIME_TENS_CALC ] += ( end.tv_sec - start.tv_sec ) + 1e-6 * ( end.tv_usec - start.tv_usec );
+   #ifdef CHEMPS2_MPI_COMPILATION
+   timings[ CHEMPS2_TIME_MPI_WORK ] += ( mid.tv_sec - start.tv_sec ) + 1e-6 * ( mid.tv_usec - start.tv_usec );
+   #endif
 
 }
 
@@ -582,12 +703,52 @@ void CheMPS2::DMRG::updateMovingLeft( const int index ){
    const int dimR = denBK->gMaxDimAtBound( index + 2 );
    #ifdef CHEMPS2_MPI_COMPILATION
    const int MPIRANK = MPIchemps2::mpi_rank();
+   struct timeval mid; // The local work for the load balance ends before the communication of the Q-tensors
+   std::vector< MPI_Request > requests; // Nonblocking transfers, completed after the Q-tensors
+   std::vector< std::pair< int, TensorQ * > > q_received; // The pieces of the other processes for the owned Q-tensors
+   std::vector< TensorQ * > q_sent;
+   const int owner_x = MPIchemps2::owner_x();
+   if ( index < L - 2 ){ // The tensors which owner_x needs for the X-tensor are not changed by this update: their transfers overlap with it
+      const int owner_q       = MPIchemps2::owner_q( L, index + 1 );
+      const int owner_absigma = MPIchemps2::owner_absigma( index + 1, index + 1 );
+      const int owner_cdf     = MPIchemps2::owner_cdf(  L, index + 1, index + 1 );
+      const int Idiff         = 0; // Irreps::directProd( denBK->gIrrep( index + 1 ), denBK->gIrrep( index + 1 ) );
+
+      if ( owner_x != owner_q ){
+         if ( owner_x == MPIRANK ){
+            Qtensors[ index + 1 ][ 0 ] = new TensorQ( index + 2, denBK->gIrrep( index + 1 ), false, denBK, Prob, index + 1 );
+            MPIchemps2::irecv_tensor( Qtensors[ index + 1 ][ 0 ], owner_q, 3 * L + 3, requests );
+         }
+         if ( owner_q == MPIRANK ){ MPIchemps2::isend_tensor( Qtensors[ index + 1 ][ 0 ], owner_x, 3 * L + 3, requests ); }
+      }
+
+      if ( owner_x != owner_absigma ){
+         if ( owner_x == MPIRANK ){
+            Atensors[ index + 1 ][ 0 ][ 0 ] = new TensorOperator( index + 2, 0, 2, Idiff, false, true, false, denBK, denBK );
+            MPIchemps2::irecv_tensor( Atensors[ index + 1 ][ 0 ][ 0 ], owner_absigma, 3 * L + 4, requests );
+         }
+         if ( owner_absigma == MPIRANK ){ MPIchemps2::isend_tensor( Atensors[ index + 1 ][ 0 ][ 0 ], owner_x, 3 * L + 4, requests ); }
+      }
+
+      if ( owner_x != owner_cdf ){
+         if ( owner_x == MPIRANK ){
+            Ctensors[ index + 1 ][ 0 ][ 0 ] = new TensorOperator( index + 2, 0, 0, Idiff, false, true,  false, denBK, denBK );
+            Dtensors[ index + 1 ][ 0 ][ 0 ] = new TensorOperator( index + 2, 2, 0, Idiff, false, false, false, denBK, denBK );
+            MPIchemps2::irecv_tensor( Ctensors[ index + 1 ][ 0 ][ 0 ], owner_cdf, 3 * L + 5, requests );
+            MPIchemps2::irecv_tensor( Dtensors[ index + 1 ][ 0 ][ 0 ], owner_cdf, 3 * L + 6, requests );
+         }
+         if ( owner_cdf == MPIRANK ){
+            MPIchemps2::isend_tensor( Ctensors[ index + 1 ][ 0 ][ 0 ], owner_x, 3 * L + 5, requests );
+            MPIchemps2::isend_tensor( Dtensors[ index + 1 ][ 0 ][ 0 ], owner_x, 3 * L + 6, requests );
+         }
+      }
+   }
    #endif
 
    #pragma omp parallel
    {
 
-      double * workmem = new double[ dimL * dimR ];
+      double * workmem = workspace->get_double( 0, dimL * dimR );
 
       // Ltensors : all processes own all Ltensors
       #pragma omp for schedule(static) nowait
@@ -740,6 +901,8 @@ void CheMPS2::DMRG::updateMovingLeft( const int index ){
 
       // Qtensors : certain processes own certain Qtensors --- You don't want to locally parallellize when sending and receiving buffers!
       #ifdef CHEMPS2_MPI_COMPILATION
+         #pragma omp master
+         { gettimeofday( &mid, NULL ); } // The previous omp for ends with a barrier
          #pragma omp single
       #else
          #pragma omp for schedule(static) nowait
@@ -768,51 +931,56 @@ void CheMPS2::DMRG::updateMovingLeft( const int index ){
             if (( owner_q == owner_absigma ) && ( owner_q == owner_cdf ) && ( owner_q == MPIRANK )){ // No MPI needed
             #endif
 
-               double * workmemBIS = new double[ dimR * dimR ];
+               double * workmemBIS = workspace->get_double( 1, dimR * dimR );
                Qtensors[ index ][ cnt2 ]->update( Qtensors[ index + 1 ][ cnt2 + 1 ], MPS[ index + 1 ], MPS[ index + 1 ], workmem );
                Qtensors[ index ][ cnt2 ]->AddTermSimple( MPS[ index + 1 ] );
                Qtensors[ index ][ cnt2 ]->AddTermsL( Ltensors[ index + 1 ], MPS[ index + 1 ], workmemBIS, workmem );
                Qtensors[ index ][ cnt2 ]->AddTermsAB( Atensors[ index + 1 ][ cnt2 + 1 ][ 0 ], Btensors[ index + 1 ][ cnt2 + 1 ][ 0 ], MPS[ index + 1 ], workmemBIS, workmem );
                Qtensors[ index ][ cnt2 ]->AddTermsCD( Ctensors[ index + 1 ][ cnt2 + 1 ][ 0 ], Dtensors[ index + 1 ][ cnt2 + 1 ][ 0 ], MPS[ index + 1 ], workmemBIS, workmem );
-               delete [] workmemBIS;
 
             #ifdef CHEMPS2_MPI_COMPILATION
-            } else { // There's going to have to be some communication
+            } else { // There's going to have to be some communication: posted here, completed after the loop
 
                if (( owner_q == MPIRANK ) || ( owner_absigma == MPIRANK ) || ( owner_cdf == MPIRANK )){
 
-                  TensorQ * tempQ = new TensorQ( index + 1, denBK->gIrrep( siteindex ), false, denBK, Prob, siteindex );
-                  tempQ->clear();
+                  // owner_q posts the receives of the other pieces before it computes its own piece in Qtensors[index][cnt2]
+                  TensorQ * mine = Qtensors[ index ][ cnt2 ];
+                  if ( owner_q == MPIRANK ){
+                     if ( owner_absigma != owner_q ){
+                        TensorQ * piece = new TensorQ( index + 1, denBK->gIrrep( siteindex ), false, denBK, Prob, siteindex );
+                        MPIchemps2::irecv_tensor( piece, owner_absigma, 2 * siteindex, requests );
+                        q_received.push_back( std::pair< int, TensorQ * >( cnt2, piece ) );
+                     }
+                     if (( owner_cdf != owner_q ) && ( owner_cdf != owner_absigma )){
+                        TensorQ * piece = new TensorQ( index + 1, denBK->gIrrep( siteindex ), false, denBK, Prob, siteindex );
+                        MPIchemps2::irecv_tensor( piece, owner_cdf, 2 * siteindex + 1, requests );
+                        q_received.push_back( std::pair< int, TensorQ * >( cnt2, piece ) );
+                     }
+                  } else {
+                     mine = new TensorQ( index + 1, denBK->gIrrep( siteindex ), false, denBK, Prob, siteindex );
+                  }
+                  mine->clear();
 
                   // Everyone creates his/her piece
-                  double * workmemBIS = new double[ dimR * dimR ];
+                  double * workmemBIS = workspace->get_double( 1, dimR * dimR );
                   if ( owner_q == MPIRANK ){
-                     tempQ->update( Qtensors[ index + 1 ][ cnt2 + 1 ], MPS[ index + 1 ], MPS[ index + 1 ], workmem );
-                     tempQ->AddTermSimple( MPS[ index + 1 ] );
-                     tempQ->AddTermsL( Ltensors[ index + 1 ], MPS[ index + 1 ], workmemBIS, workmem );
+                     mine->update( Qtensors[ index + 1 ][ cnt2 + 1 ], MPS[ index + 1 ], MPS[ index + 1 ], workmem );
+                     mine->AddTermSimple( MPS[ index + 1 ] );
+                     mine->AddTermsL( Ltensors[ index + 1 ], MPS[ index + 1 ], workmemBIS, workmem );
                   }
                   if ( owner_absigma == MPIRANK ){
-                     tempQ->AddTermsAB( Atensors[ index + 1 ][ cnt2 + 1 ][ 0 ], Btensors[ index + 1 ][ cnt2 + 1 ][ 0 ], MPS[ index + 1 ], workmemBIS, workmem );
+                     mine->AddTermsAB( Atensors[ index + 1 ][ cnt2 + 1 ][ 0 ], Btensors[ index + 1 ][ cnt2 + 1 ][ 0 ], MPS[ index + 1 ], workmemBIS, workmem );
                   }
                   if ( owner_cdf == MPIRANK ){
-                     tempQ->AddTermsCD( Ctensors[ index + 1 ][ cnt2 + 1 ][ 0 ], Dtensors[ index + 1 ][ cnt2 + 1 ][ 0 ], MPS[ index + 1 ], workmemBIS, workmem );
-                  }
-                  delete [] workmemBIS;
-
-                  // Add everything to owner_q's Qtensors[index][cnt2]: replace later with custom communication group?
-                  int inc = 1;
-                  int arraysize = tempQ->gKappa2index( tempQ->gNKappa() );
-                  double alpha = 1.0;
-                  if ( owner_q == MPIRANK ){ dcopy_( &arraysize, tempQ->gStorage(), &inc, Qtensors[index][cnt2]->gStorage(), &inc ); }
-                  if ( owner_q != owner_absigma ){
-                     MPIchemps2::sendreceive_tensor( tempQ, owner_absigma, owner_q, 2 * siteindex );
-                     if ( owner_q == MPIRANK ){ daxpy_( &arraysize, &alpha, tempQ->gStorage(), &inc, Qtensors[ index ][ cnt2 ]->gStorage(), &inc ); }
+                     mine->AddTermsCD( Ctensors[ index + 1 ][ cnt2 + 1 ][ 0 ], Dtensors[ index + 1 ][ cnt2 + 1 ][ 0 ], MPS[ index + 1 ], workmemBIS, workmem );
                   }
-                  if (( owner_q != owner_cdf ) && ( owner_absigma != owner_cdf )){
-                     MPIchemps2::sendreceive_tensor( tempQ, owner_cdf, owner_q, 2 * siteindex + 1 );
-                     if ( owner_q == MPIRANK ){ daxpy_( &arraysize, &alpha, tempQ->gStorage(), &inc, Qtensors[ index ][ cnt2 ]->gStorage(), &inc ); }
+
+                  // The piece is sent while the next Q-tensor is computed
+                  if ( owner_q != MPIRANK ){
+                     MPIchemps2::isend_tensor( mine, owner_q, (( owner_absigma == MPIRANK ) ? 2 * siteindex : 2 * siteindex + 1 ), requests );
+                     q_sent.push_back( mine );
                   }
-                  delete tempQ;
+                  MPIchemps2::test_requests( requests );
 
                }
             }
@@ -820,14 +988,20 @@ void CheMPS2::DMRG::updateMovingLeft( const int index ){
          }
       }
 
-      delete [] workmem;
-
    }
 
-   //Xtensors
    #ifdef CHEMPS2_MPI_COMPILATION
-   const int owner_x = MPIchemps2::owner_x();
+   // Complete the transfers, and add the received pieces to the owned Q-tensors
+   MPIchemps2::wait_requests( requests );
+   for ( int piece = 0; piece < ( int ) q_received.size(); piece++ ){
+      TensorQ * target = Qtensors[ index ][ q_received[ piece ].first ];
+      Special::daxpy64( target->gKappa2index( target->gNKappa() ), 1.0, q_received[ piece ].second->gStorage(), target->gStorage() );
+      delete q_received[ piece ].second;
+   }
+   for ( int piece = 0; piece < ( int ) q_sent.size(); piece++ ){ delete q_sent[ piece ]; }
    #endif
+
+   //Xtensors
    if ( index == L - 2 ){
 
       #ifdef CHEMPS2_MPI_COMPILATION
@@ -838,33 +1012,10 @@ void CheMPS2::DMRG::updateMovingLeft( const int index ){
    } else {
 
       #ifdef CHEMPS2_MPI_COMPILATION
-      //Make sure that owner_x has all required tensors to construct X. Not as optimal as Q-tensor case, but easier hack.
+      //Make sure that owner_x has all required tensors to construct X: their transfers were posted at the start
       const int owner_q       = MPIchemps2::owner_q( L, index + 1 );
       const int owner_absigma = MPIchemps2::owner_absigma( index + 1, index + 1 );
       const int owner_cdf     = MPIchemps2::owner_cdf(  L, index + 1, index + 1 );
-      const int Idiff         = 0; // Irreps::directProd( denBK->gIrrep( index + 1 ), denBK->gIrrep( index + 1 ) );
-
-      if ( owner_x != owner_q ){
-         if ( owner_x == MPIRANK ){ Qtensors[ index + 1 ][ 0 ] = new TensorQ( index + 2, denBK->gIrrep( index + 1 ), false, denBK, Prob, index + 1 ); }
-         if (( owner_x == MPIRANK ) || ( owner_q == MPIRANK )){ MPIchemps2::sendreceive_tensor( Qtensors[ index + 1 ][ 0 ], owner_q, owner_x, 3 * L + 3 ); }
-      }
-
-      if ( owner_x != owner_absigma ){
-         if ( owner_x == MPIRANK ){ Atensors[ index + 1 ][ 0 ][ 0 ] = new TensorOperator( index + 2, 0, 2, Idiff, false, true, false, denBK, denBK ); }
-         if (( owner_x == MPIRANK ) || ( owner_absigma == MPIRANK )){ MPIchemps2::sendreceive_tensor( Atensors[ index + 1 ][ 0 ][ 0 ], owner_absigma, owner_x, 3 * L + 4 ); }
-      }
-
-      if ( owner_x != owner_cdf ){
-         if ( owner_x == MPIRANK ){
-            Ctensors[ index + 1 ][ 0 ][ 0 ] = new TensorOperator( index + 2, 0, 0, Idiff, false, true,  false, denBK, denBK );
-            Dtensors[ index + 1 ][ 0 ][ 0 ] = new TensorOperator( index + 2, 2, 0, Idiff, false, false, false, denBK, denBK );
-         }
-         if (( owner_x == MPIRANK ) || ( owner_cdf == MPIRANK )){
-            MPIchemps2::sendreceive_tensor( Ctensors[ index + 1 ][ 0 ][ 0 ], owner_cdf, owner_x, 3 * L + 5 );
-            MPIchemps2::sendreceive_tensor( Dtensors[ index + 1 ][ 0 ][ 0 ], owner_cdf, owner_x, 3 * L + 6 );
-         }
-      }
-
       if ( owner_x == MPIRANK ){
       #endif
 
@@ -903,6 +1054,9 @@ void CheMPS2::DMRG::updateMovingLeft( const int index ){
 
    gettimeofday( &end, NULL );
    timings[ CHEMPS2_TIME_TENS_CALC ] += ( end.tv_sec - start.tv_sec ) + 1e-6 * ( end.tv_usec - start.tv_usec );
+   #ifdef CHEMPS2_MPI_COMPILATION
+   timings[ CHEMPS2_TIME_MPI_WORK ] += ( mid.tv_sec - start.tv_sec ) + 1e-6 * ( mid.tv_usec - start.tv_usec );
+   #endif
 
 }
 
@@ -1144,79 +1298,23 @@ void CheMPS2::DMRG::allocateTensors(const int index, const bool movingRight){
 
 }
 
-void CheMPS2::DMRG::MY_HDF5_READ_BATCH( const hid_t file_id, const int number, Tensor ** batch, const long long totalsize, const std::string tag ){
-
-   const hid_t   group_id     = H5Gopen(file_id, tag.c_str(), H5P_DEFAULT);
-   const hsize_t dimarray     = totalsize;
-   const hid_t   dataspace_id = H5Screate_simple(1, &dimarray, NULL);
-   const hid_t   dataset_id   = H5Dopen(group_id, "storage", H5P_DEFAULT);
-   
-   long long offset = 0;
-   for (int cnt=0; cnt<number; cnt++){
-      const int tensor_size = batch[cnt]->gKappa2index(batch[cnt]->gNKappa());
-      if ( tensor_size > 0 ){
-      
-         const hsize_t start = offset;
-         const hsize_t count = tensor_size;
-         H5Sselect_hyperslab(dataspace_id, H5S_SELECT_SET, &start, NULL, &count, NULL);
-         const hid_t memspace_id = H5Screate_simple(1, &count, NULL);
-         H5Dread(dataset_id, H5T_NATIVE_DOUBLE, memspace_id, dataspace_id, H5P_DEFAULT, batch[cnt]->gStorage());
-         H5Sclose(memspace_id);
-
-         offset += tensor_size;
-      }
-   }
-   
-   H5Dclose(dataset_id);
-   H5Sclose(dataspace_id);
-   H5Gclose(group_id);
-   
-   assert( totalsize == offset );
-   num_double_read_disk += totalsize;
+std::string CheMPS2::DMRG::operator_filename(const int index) const{
 
-}
-
-void CheMPS2::DMRG::MY_HDF5_WRITE_BATCH( const hid_t file_id, const int number, Tensor ** batch, const long long totalsize, const std::string tag ){
-
-   const hid_t   group_id     = H5Gcreate(file_id, tag.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
-   const hsize_t dimarray     = totalsize;
-   const hid_t   dataspace_id = H5Screate_simple(1, &dimarray, NULL);
-   const hid_t   dataset_id   = H5Dcreate(group_id, "storage", H5T_NATIVE_DOUBLE, dataspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
-                                /* Switch from H5T_IEEE_F64LE to H5T_NATIVE_DOUBLE to avoid processing of the doubles
-                                   --> only MPS checkpoint is reused in between calculations anyway                   */
-   
-   long long offset = 0;
-   for (int cnt=0; cnt<number; cnt++){
-      const int tensor_size = batch[cnt]->gKappa2index(batch[cnt]->gNKappa());
-      if ( tensor_size > 0 ){
-      
-         const hsize_t start = offset;
-         const hsize_t count = tensor_size;
-         H5Sselect_hyperslab(dataspace_id, H5S_SELECT_SET, &start, NULL, &count, NULL);
-         const hid_t memspace_id = H5Screate_simple(1, &count, NULL);
-         H5Dwrite(dataset_id, H5T_NATIVE_DOUBLE, memspace_id, dataspace_id, H5P_DEFAULT, batch[cnt]->gStorage());
-         H5Sclose(memspace_id);
-         
-         offset += tensor_size;
-      }
-   }
-   
-   H5Dclose(dataset_id);
-   H5Sclose(dataspace_id);
-   H5Gclose(group_id);
-   
-   assert( totalsize == offset );
-   num_double_write_disk += totalsize;
+   std::stringstream thefilename;
+   //The PID is different for each MPI process
+   thefilename << tempfolder << "/" << CheMPS2::DMRG_OPERATOR_storage_prefix << thePID << "_index_" << index;
+   return thefilename.str();
 
 }
 
-void CheMPS2::DMRG::OperatorsOnDisk(const int index, const bool movingRight, const bool store){
+void CheMPS2::DMRG::OperatorsOnDisk(const int index, const bool movingRight, const bool store, const std::string filename){
 
    /*
    
-      By working with hyperslabs and batches of tensors, there
-      are exactly 11 groups which need to be written to the file
-      ( 12 when there are excitations ).
+      By working with batches of tensors, there are exactly
+      11 groups which need to be written to the file ( 12 when
+      there are excitations ). The file format is determined
+      by the OperatorStorage backend.
    
    */
 
@@ -1229,13 +1327,7 @@ void CheMPS2::DMRG::OperatorsOnDisk(const int index, const bool movingRight, con
    const int MPIRANK = MPIchemps2::mpi_rank();
    #endif
 
-   std::stringstream thefilename;
-   //The PID is different for each MPI process
-   thefilename << tempfolder << "/" << CheMPS2::DMRG_OPERATOR_storage_prefix << thePID << "_index_" << index << ".h5";
-
-   //The hdf5 file
-   const hid_t file_id = ( store ) ? H5Fcreate( thefilename.str().c_str(), H5F_ACC_TRUNC,  H5P_DEFAULT, H5P_DEFAULT )
-                                   : H5Fopen(   thefilename.str().c_str(), H5F_ACC_RDONLY, H5P_DEFAULT );
+   op_storage->open( filename, store );
 
    //Ltensors : all processes own all Ltensors
    {
@@ -1247,8 +1339,8 @@ void CheMPS2::DMRG::OperatorsOnDisk(const int index, const bool movingRight, con
       }
       if ( totalsizeL > 0 ){
          const std::string tag = "Ltensors";
-         if ( store ){ MY_HDF5_WRITE_BATCH( file_id, Nbound, batchL, totalsizeL, tag ); }
-         else{         MY_HDF5_READ_BATCH(  file_id, Nbound, batchL, totalsizeL, tag ); }
+         if ( store ){ op_storage->write_batch( Nbound, batchL, totalsizeL, tag, false ); }
+         else{         op_storage->read_batch(  Nbound, batchL, totalsizeL, tag ); }
       }
       delete [] batchL;
    }
@@ -1283,23 +1375,23 @@ void CheMPS2::DMRG::OperatorsOnDisk(const int index, const bool movingRight, con
       
       if ( totalsizeF0 > 0 ){
          const std::string tag = "F0tensors";
-         if ( store ){ MY_HDF5_WRITE_BATCH( file_id, numF0, batchF0, totalsizeF0, tag ); }
-         else{         MY_HDF5_READ_BATCH(  file_id, numF0, batchF0, totalsizeF0, tag ); }
+         if ( store ){ op_storage->write_batch( numF0, batchF0, totalsizeF0, tag, false ); }
+         else{         op_storage->read_batch(  numF0, batchF0, totalsizeF0, tag ); }
       }
       if ( totalsizeF1 > 0 ){
          const std::string tag = "F1tensors";
-         if ( store ){ MY_HDF5_WRITE_BATCH( file_id, numF1, batchF1, totalsizeF1, tag ); }
-         else{         MY_HDF5_READ_BATCH(  file_id, numF1, batchF1, totalsizeF1, tag ); }
+         if ( store ){ op_storage->write_batch( numF1, batchF1, totalsizeF1, tag, false ); }
+         else{         op_storage->read_batch(  numF1, batchF1, totalsizeF1, tag ); }
       }
       if ( totalsizeS0 > 0 ){
          const std::string tag = "S0tensors";
-         if ( store ){ MY_HDF5_WRITE_BATCH( file_id, numS0, batchS0, totalsizeS0, tag ); }
-         else{         MY_HDF5_READ_BATCH(  file_id, numS0, batchS0, totalsizeS0, tag ); }
+         if ( store ){ op_storage->write_batch( numS0, batchS0, totalsizeS0, tag, false ); }
+         else{         op_storage->read_batch(  numS0, batchS0, totalsizeS0, tag ); }
       }
       if ( totalsizeS1 > 0 ){
          const std::string tag = "S1tensors";
-         if ( store ){ MY_HDF5_WRITE_BATCH( file_id, numS1, batchS1, totalsizeS1, tag ); }
-         else{         MY_HDF5_READ_BATCH(  file_id, numS1, batchS1, totalsizeS1, tag ); }
+         if ( store ){ op_storage->write_batch( numS1, batchS1, totalsizeS1, tag, false ); }
+         else{         op_storage->read_batch(  numS1, batchS1, totalsizeS1, tag ); }
       }
       
       delete [] batchF0;
@@ -1339,23 +1431,23 @@ void CheMPS2::DMRG::OperatorsOnDisk(const int index, const bool movingRight, con
       
       if ( totalsizeA > 0 ){
          const std::string tag = "Atensors";
-         if ( store ){ MY_HDF5_WRITE_BATCH( file_id, numA, batchA, totalsizeA, tag ); }
-         else{         MY_HDF5_READ_BATCH(  file_id, numA, batchA, totalsizeA, tag ); }
+         if ( store ){ op_storage->write_batch( numA, batchA, totalsizeA, tag, true ); }
+         else{         op_storage->read_batch(  numA, batchA, totalsizeA, tag ); }
       }
       if ( totalsizeB > 0 ){
          const std::string tag = "Btensors";
-         if ( store ){ MY_HDF5_WRITE_BATCH( file_id, numB, batchB, totalsizeB, tag ); }
-         else{         MY_HDF5_READ_BATCH(  file_id, numB, batchB, totalsizeB, tag ); }
+         if ( store ){ op_storage->write_batch( numB, batchB, totalsizeB, tag, true ); }
+         else{         op_storage->read_batch(  numB, batchB, totalsizeB, tag ); }
       }
       if ( totalsizeC > 0 ){
          const std::string tag = "Ctensors";
-         if ( store ){ MY_HDF5_WRITE_BATCH( file_id, numC, batchC, totalsizeC, tag ); }
-         else{         MY_HDF5_READ_BATCH(  file_id, numC, batchC, totalsizeC, tag ); }
+         if ( store ){ op_storage->write_batch( numC, batchC, totalsizeC, tag, true ); }
+         else{         op_storage->read_batch(  numC, batchC, totalsizeC, tag ); }
       }
       if ( totalsizeD > 0 ){
          const std::string tag = "Dtensors";
-         if ( store ){ MY_HDF5_WRITE_BATCH( file_id, numD, batchD, totalsizeD, tag ); }
-         else{         MY_HDF5_READ_BATCH(  file_id, numD, batchD, totalsizeD, tag ); }
+         if ( store ){ op_storage->write_batch( numD, batchD, totalsizeD, tag, true ); }
+         else{         op_storage->read_batch(  numD, batchD, totalsizeD, tag ); }
       }
       
       delete [] batchA;
@@ -1381,8 +1473,8 @@ void CheMPS2::DMRG::OperatorsOnDisk(const int index, const bool movingRight, con
       }
       if ( totalsizeQ > 0 ){
          const std::string tag = "Qtensors";
-         if ( store ){ MY_HDF5_WRITE_BATCH( file_id, numQ, batchQ, totalsizeQ, tag ); }
-         else{         MY_HDF5_READ_BATCH(  file_id, numQ, batchQ, totalsizeQ, tag ); }
+         if ( store ){ op_storage->write_batch( numQ, batchQ, totalsizeQ, tag, true ); }
+         else{         op_storage->read_batch(  numQ, batchQ, totalsizeQ, tag ); }
       }
       delete [] batchQ;
    }
@@ -1397,8 +1489,8 @@ void CheMPS2::DMRG::OperatorsOnDisk(const int index, const bool movingRight, con
       batchX[0] = Xtensors[index];
       if ( totalsizeX > 0 ){
          const std::string tag = "Xtensors";
-         if ( store ){ MY_HDF5_WRITE_BATCH( file_id, 1, batchX, totalsizeX, tag ); }
-         else{         MY_HDF5_READ_BATCH(  file_id, 1, batchX, totalsizeX, tag ); }
+         if ( store ){ op_storage->write_batch( 1, batchX, totalsizeX, tag, false ); }
+         else{         op_storage->read_batch(  1, batchX, totalsizeX, tag ); }
       }
       delete [] batchX;
    }
@@ -1418,13 +1510,19 @@ void CheMPS2::DMRG::OperatorsOnDisk(const int index, const bool movingRight, con
       }
       if ( totalsizeO > 0 ){
          const std::string tag = "Otensors";
-         if ( store ){ MY_HDF5_WRITE_BATCH( file_id, numO, batchO, totalsizeO, tag ); }
-         else{         MY_HDF5_READ_BATCH(  file_id, numO, batchO, totalsizeO, tag ); }
+         if ( store ){ op_storage->write_batch( numO, batchO, totalsizeO, tag, false ); }
+         else{         op_storage->read_batch(  numO, batchO, totalsizeO, tag ); }
       }
       delete [] batchO;
    }
 
-   H5Fclose(file_id);
+   const long long num_bytes = op_storage->close();
+   if ( store ){
+      num_double_write_disk += op_size[ index ];
+      num_byte_write_file   += num_bytes;
+   } else {
+      num_double_read_disk  += op_size[ index ];
+   }
 
    gettimeofday(&end, NULL);
    if ( store ){ timings[ CHEMPS2_TIME_DISK_WRITE ] += (end.tv_sec - start.tv_sec) + 1e-6 * (end.tv_usec - start.tv_usec); }
@@ -1432,6 +1530,93 @@ void CheMPS2::DMRG::OperatorsOnDisk(const int index, const bool movingRight, con
 
 }
 
+long long CheMPS2::DMRG::sizeTensors(const int index) const{
+
+   assert( isAllocated[index] != 0 );
+   const bool movingRight = ( isAllocated[index] == 1 );
+   const int Nbound = movingRight ? index+1 : L-1-index;
+   const int Cbound = movingRight ? L-1-index : index+1;
+   #ifdef CHEMPS2_MPI_COMPILATION
+   const int MPIRANK = MPIchemps2::mpi_rank();
+   #endif
+   long long total = 0;
+
+   //Ltensors : all processes own all Ltensors
+   for (int cnt2=0; cnt2<Nbound; cnt2++){ total += Ltensors[index][cnt2]->gKappa2index(Ltensors[index][cnt2]->gNKappa()); }
+
+   //Two-operator tensors : certain processes own certain two-operator tensors
+   for (int cnt2=0; cnt2<Nbound; cnt2++){
+      for (int cnt3=0; cnt3<Nbound-cnt2; cnt3++){
+         #ifdef CHEMPS2_MPI_COMPILATION
+         const int siteindex1 = movingRight ? index - cnt2 - cnt3 : index + 1 + cnt3;
+         const int siteindex2 = movingRight ? index - cnt3        : index + 1 + cnt2 + cnt3;
+         if (( cnt3 == 0 ) || ( MPIchemps2::owner_cdf(L, siteindex1, siteindex2) == MPIRANK ))
+         #endif
+         {
+            total += F0tensors[index][cnt2][cnt3]->gKappa2index(F0tensors[index][cnt2][cnt3]->gNKappa());
+            total += F1tensors[index][cnt2][cnt3]->gKappa2index(F1tensors[index][cnt2][cnt3]->gNKappa());
+         }
+         #ifdef CHEMPS2_MPI_COMPILATION
+         if (( cnt3 == 0 ) || ( MPIchemps2::owner_absigma(siteindex1, siteindex2) == MPIRANK ))
+         #endif
+         {
+                         total += S0tensors[index][cnt2][cnt3]->gKappa2index(S0tensors[index][cnt2][cnt3]->gNKappa());
+            if (cnt2>0){ total += S1tensors[index][cnt2][cnt3]->gKappa2index(S1tensors[index][cnt2][cnt3]->gNKappa()); }
+         }
+      }
+   }
+
+   //Complementary two-operator tensors : certain processes own certain complementary two-operator tensors
+   for (int cnt2=0; cnt2<Cbound; cnt2++){
+      for (int cnt3=0; cnt3<Cbound-cnt2; cnt3++){
+         #ifdef CHEMPS2_MPI_COMPILATION
+         const int siteindex1 = movingRight ? index + 1 + cnt3        : index - cnt2 - cnt3;
+         const int siteindex2 = movingRight ? index + 1 + cnt2 + cnt3 : index - cnt3;
+         if ( MPIchemps2::owner_absigma(siteindex1, siteindex2) == MPIRANK )
+         #endif
+         {
+                         total += Atensors[index][cnt2][cnt3]->gKappa2index(Atensors[index][cnt2][cnt3]->gNKappa());
+            if (cnt2>0){ total += Btensors[index][cnt2][cnt3]->gKappa2index(Btensors[index][cnt2][cnt3]->gNKappa()); }
+         }
+         #ifdef CHEMPS2_MPI_COMPILATION
+         if ( MPIchemps2::owner_cdf(L, siteindex1, siteindex2) == MPIRANK )
+         #endif
+         {
+            total += Ctensors[index][cnt2][cnt3]->gKappa2index(Ctensors[index][cnt2][cnt3]->gNKappa());
+            total += Dtensors[index][cnt2][cnt3]->gKappa2index(Dtensors[index][cnt2][cnt3]->gNKappa());
+         }
+      }
+   }
+
+   //Qtensors : certain processes own certain Qtensors
+   for (int cnt2=0; cnt2<Cbound; cnt2++){
+      #ifdef CHEMPS2_MPI_COMPILATION
+      const int siteindex = movingRight ? index + 1 + cnt2 : index - cnt2;
+      if ( MPIchemps2::owner_q(L, siteindex) == MPIRANK )
+      #endif
+      { total += Qtensors[index][cnt2]->gKappa2index(Qtensors[index][cnt2]->gNKappa()); }
+   }
+
+   //Xtensors
+   #ifdef CHEMPS2_MPI_COMPILATION
+   if ( MPIchemps2::owner_x() == MPIRANK )
+   #endif
+   { total += Xtensors[index]->gKappa2index(Xtensors[index]->gNKappa()); }
+
+   //Otensors
+   if (Exc_activated){
+      for (int state=0; state<nStates-1; state++){
+         #ifdef CHEMPS2_MPI_COMPILATION
+         if ( MPIchemps2::owner_specific_excitation( L, state ) == MPIRANK )
+         #endif
+         { total += Exc_Overlaps[state][index]->gKappa2index(Exc_Overlaps[state][index]->gNKappa()); }
+      }
+   }
+
+   return total;
+
+}
+
 void CheMPS2::DMRG::deleteTensors(const int index, const bool movingRight){
 
    struct timeval start, end;
@@ -1540,10 +1725,15 @@ void CheMPS2::DMRG::deleteTensors(const int index, const bool movingRight){
 
 void CheMPS2::DMRG::deleteStoredOperators(){
 
+   io_sync();
+   if ( op_files == false ){ return; } // Everything fitted in the memory budget
+
    std::stringstream temp;
-   temp << "rm " << tempfolder << "/" << CheMPS2::DMRG_OPERATOR_storage_prefix << thePID << "*.h5";
+   temp << "rm " << tempfolder << "/" << CheMPS2::DMRG_OPERATOR_storage_prefix << thePID << "_index_*";
    int info = system(temp.str().c_str());
    std::cout << "Info on DMRG::operators rm call to system: " << info << std::endl;
+   op_files = false;
+   for ( int cnt = 0; cnt < L - 1; cnt++ ){ op_on_disk[ cnt ] = 0; }
 
 }
 
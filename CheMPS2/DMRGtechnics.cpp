@@ -39,16 +39,20 @@ using std::endl;
 
 void CheMPS2::DMRG::calc_rdms_and_correlations( const bool do_3rdm, const bool disk_3rdm ){
 
+   MPIbalance::activate( balance );
    #ifdef CHEMPS2_MPI_COMPILATION
       const bool am_i_master = ( MPIchemps2::mpi_rank() == MPI_CHEMPS2_MASTER );
    #else
       const bool am_i_master = true;
    #endif
 
+   if ( resume_pending ){ PreSolve(); } // The renormalized operators of a mid-sweep checkpoint do not belong to the LLLLLLLC gauge
+
    // Reset timings
    for ( int timecnt = 0; timecnt < CHEMPS2_TIME_VECLENGTH; timecnt++ ){ timings[ timecnt ] = 0.0; }
    num_double_write_disk = 0;
    num_double_read_disk  = 0;
+   num_byte_write_file   = 0;
    struct timeval start_global, end_global, start_part, end_part;
    gettimeofday( &start_global, NULL );
 
@@ -79,7 +83,7 @@ void CheMPS2::DMRG::calc_rdms_and_correlations( const bool do_3rdm, const bool d
 
    // Calculate the 2DM
    if ( the2DM != NULL ){ delete the2DM; the2DM = NULL; }
-   the2DM = new TwoDM( denBK, Prob );
+   the2DM = new TwoDM( denBK, Prob, workspace );
 
    for ( int siteindex = L - 1; siteindex >= 0; siteindex-- ){
 
@@ -123,7 +127,7 @@ void CheMPS2::DMRG::calc_rdms_and_correlations( const bool do_3rdm, const bool d
    // Calculate the 3DM and Correlations
    if ( the3DM  != NULL ){ delete the3DM;  the3DM  = NULL; }
    if ( theCorr != NULL ){ delete theCorr; theCorr = NULL; }
-   if ( do_3rdm ){ the3DM = new ThreeDM( denBK, Prob, disk_3rdm ); }
+   if ( do_3rdm ){ the3DM = new ThreeDM( denBK, Prob, disk_3rdm, workspace ); }
    theCorr = new Correlations( denBK, Prob, the2DM );
    if ( am_i_master ){
       Gtensors = new TensorGYZ*[ L - 1 ];
@@ -184,11 +188,9 @@ void CheMPS2::DMRG::calc_rdms_and_correlations( const bool do_3rdm, const bool d
 
    // Delete the renormalized operators from boundary L-2 and load the ones from boundary L-3
    gettimeofday( &start_part, NULL );
-   assert( isAllocated[ L - 2 ] == 1 );                      // Renormalized operators exist on the last boundary (L-2) and are moving to the right.
-   assert( isAllocated[ L - 3 ] == 0 );                      // Renormalized operators do not exist on boundary L-3.
-     deleteTensors( L - 2, true ); isAllocated[ L - 2 ] = 0; // Delete the renormalized operators on the last boundary (L-2).
-   allocateTensors( L - 3, true ); isAllocated[ L - 3 ] = 1; // Create the renormalized operators on boundary L-3.
-   OperatorsOnDisk( L - 3, true, false );                    // Load the renormalized operators on boundary L-3.
+   assert( isAllocated[ L - 2 ] == 1 ); // Renormalized operators exist on the last boundary (L-2) and are moving to the right.
+   boundary_delete( L - 2 );            // Delete the renormalized operators on the last boundary (L-2).
+   boundary_load( L - 3, true );        // Load the renormalized operators on boundary L-3 if they are not in memory.
    gettimeofday( &end_part, NULL );
    timings[ CHEMPS2_TIME_TENS_TOTAL ] += ( end_part.tv_sec - start_part.tv_sec ) + 1e-6 * ( end_part.tv_usec - start_part.tv_usec );
 
@@ -258,6 +260,8 @@ void CheMPS2::DMRG::calc_rdms_and_correlations( const bool do_3rdm, const bool d
                else { cout << "***************************************************" << endl; }
    }
 
+   workspace->release(); // The work arrays are not kept while the DMRG object is idle
+
 }
 
 void CheMPS2::DMRG::print_tensor_update_performance() const{
@@ -267,9 +271,37 @@ void CheMPS2::DMRG::print_tensor_update_performance() const{
     cout << "***              |--> destroy    = " << timings[ CHEMPS2_TIME_TENS_FREE  ] << " seconds" << endl;
     cout << "***              |--> disk write = " << timings[ CHEMPS2_TIME_DISK_WRITE ] << " seconds" << endl;
     cout << "***              |--> disk read  = " << timings[ CHEMPS2_TIME_DISK_READ  ] << " seconds" << endl;
+    cout << "***              |--> disk wait  = " << timings[ CHEMPS2_TIME_DISK_WAIT  ] << " seconds" << endl;
     cout << "***              |--> calc       = " << timings[ CHEMPS2_TIME_TENS_CALC  ] << " seconds" << endl;
     cout << "***     Disk write bandwidth     = " << num_double_write_disk * sizeof(double) / ( timings[ CHEMPS2_TIME_DISK_WRITE ] * 1048576 ) << " MB/s" << endl;
     cout << "***     Disk read  bandwidth     = " << num_double_read_disk  * sizeof(double) / ( timings[ CHEMPS2_TIME_DISK_READ  ] * 1048576 ) << " MB/s" << endl;
+    cout << "***     Disk compression ratio   = " << num_double_write_disk * sizeof(double) / ( 1.0 * num_byte_write_file ) << endl;
+    cout << "***     Operators in memory      = " << op_resident * sizeof(double) / 1048576.0 << " MB" << endl;
+
+}
+
+void CheMPS2::DMRG::print_sweep_summary() const{
+
+    cout << "***     Davidson multiplications = " << NumMatvecLastSweep << " ( residual tolerance " << MinRtolLastSweep << " to " << MaxRtolLastSweep << " )" << endl;
+    cout << "***     Bond dimensions          = [ " << denBK->gTotDimAtBound( 1 ); for ( int bound = 2; bound < L; bound++ ){ cout << " ; " << denBK->gTotDimAtBound( bound ); } cout << " ]" << endl;
+    cout << "***     Discarded weights        = [ " << DiscWeightBonds[ 1 ]; for ( int bound = 2; bound < L; bound++ ){ cout << " ; " << DiscWeightBonds[ bound ]; } cout << " ]" << endl;
+    #ifdef CHEMPS2_MPI_COMPILATION
+    cout << "***     MPI load imbalance       = " << ImbalanceLastSweep << " ( estimated " << balance->imbalance( denBK ) << " )" << endl;
+    #endif
+
+}
+
+void CheMPS2::DMRG::measure_imbalance(){
+
+   ImbalanceLastSweep = 1.0;
+   #ifdef CHEMPS2_MPI_COMPILATION
+   const int num_procs = MPIchemps2::mpi_size();
+   double work  = timings[ CHEMPS2_TIME_MPI_WORK ];
+   double total = 0.0;
+   MPIchemps2::allreduce_array_double( &work, &total, 1 );
+   const double largest = MPIchemps2::allreduce_max_double( work );
+   if ( total > 0.0 ){ ImbalanceLastSweep = largest * num_procs / total; }
+   #endif
 
 }
 
@@ -539,8 +571,8 @@ void CheMPS2::DMRG::cleanup_excitations(double ** VeffTilde) const{
 
 void CheMPS2::DMRG::calcVeffTilde(double * result, Sobject * currentS, int state_number){
 
-   int dimTot = currentS->gKappa2index(currentS->gNKappa());
-   for (int cnt=0; cnt<dimTot; cnt++){ result[cnt] = 0.0; }
+   const long long dimTot = currentS->gKappa2index(currentS->gNKappa());
+   for (long long cnt=0; cnt<dimTot; cnt++){ result[cnt] = 0.0; }
    int index = currentS->gIndex();
    
    const int dimL = std::max(denBK->gMaxDimAtBound(index),   Exc_BKs[state_number]->gMaxDimAtBound(index)   );
@@ -593,7 +625,7 @@ void CheMPS2::DMRG::calcVeffTilde(double * result, Sobject * currentS, int state
          }
          
          //Do (workmem * OR)_{block} --> result + jumpCurrentS
-         int jumpCurrentS = currentS->gKappa2index(ikappa);
+         long long jumpCurrentS = currentS->gKappa2index(ikappa);
          if (index==L-2){
          
             int dimBlock = dimLdown * dimRdown;
@@ -21,16 +21,21 @@
 #include <stdlib.h>
 #include <iostream>
 #include <assert.h>
+#include <algorithm>
 
 #include "Davidson.h"
 #include "Lapack.h"
+#include "Special.h"
+#include "MPIchemps2.h"
 
 using std::cout;
 using std::endl;
 
-CheMPS2::Davidson::Davidson( const int veclength, const int MAX_NUM_VEC, const int NUM_VEC_KEEP, const double RTOL, const double DIAG_CUTOFF, const bool debug_print, const char problem_type ){
+CheMPS2::Davidson::Davidson( const long long veclength, const int MAX_NUM_VEC, const int NUM_VEC_KEEP, const double RTOL, const double DIAG_CUTOFF, const bool debug_print, const char problem_type, const int num_roots, const int block_size, const bool distributed ){
 
    assert( ( problem_type == 'E' ) || ( problem_type == 'L' ) );
+   assert( ( num_roots == 1 ) || (( problem_type == 'E' ) && ( num_roots <= NUM_VEC_KEEP ) && ( NUM_VEC_KEEP < MAX_NUM_VEC )) );
+   assert( ( block_size == 1 ) || (( problem_type == 'E' ) && ( block_size > 1 ) && ( NUM_VEC_KEEP + block_size <= MAX_NUM_VEC )) );
 
    this->debug_print  = debug_print;
    this->veclength    = veclength;
@@ -39,6 +44,13 @@ CheMPS2::Davidson::Davidson( const int veclength, const int MAX_NUM_VEC, const i
    this->NUM_VEC_KEEP = NUM_VEC_KEEP;
    this->DIAG_CUTOFF  = DIAG_CUTOFF;
    this->RTOL         = RTOL;
+   this->num_roots    = num_roots;
+   this->block_size   = block_size;
+   this->distributed  = distributed;
+   num_guess = 0;
+   num_new   = 0;
+   num_block = 0;
+   num_corr  = 0;
 
    state = 'I'; // <I>nitialized Davidson
    nMultiplications = 0;
@@ -63,6 +75,11 @@ CheMPS2::Davidson::Davidson( const int veclength, const int MAX_NUM_VEC, const i
    u_vec    = new double[ veclength ];
    work_vec = new double[ veclength ];
    RHS      = (( problem_type == 'L' ) ? new double[ veclength ] : NULL );
+   roots_vecs = (( num_roots > 1 ) ? new double[ veclength * num_roots ] : NULL );
+   roots_eigs = (( num_roots > 1 ) ? new double[ num_roots ] : NULL );
+   block_vecs  = (( block_size > 1 ) ? new double[ veclength * block_size ] : NULL );
+   block_Hvecs = (( block_size > 1 ) ? new double[ veclength * block_size ] : NULL );
+   block_corr  = (( block_size > 1 ) ? new double[ veclength * block_size ] : NULL );
 
    // For the deflation
    Reortho_Lowdin       = NULL;
@@ -92,6 +109,11 @@ CheMPS2::Davidson::~Davidson(){
    delete [] u_vec;
    delete [] work_vec;
    if ( RHS != NULL ){ delete [] RHS; }
+   if ( roots_vecs != NULL ){ delete [] roots_vecs; }
+   if ( roots_eigs != NULL ){ delete [] roots_eigs; }
+   if ( block_vecs  != NULL ){ delete [] block_vecs;  }
+   if ( block_Hvecs != NULL ){ delete [] block_Hvecs; }
+   if ( block_corr  != NULL ){ delete [] block_corr;  }
 
    if ( Reortho_Lowdin       != NULL ){ delete [] Reortho_Lowdin; }
    if ( Reortho_Overlap_eigs != NULL ){ delete [] Reortho_Overlap_eigs; }
@@ -102,25 +124,28 @@ CheMPS2::Davidson::~Davidson(){
 
 int CheMPS2::Davidson::GetNumMultiplications() const{ return nMultiplications; }
 
+int CheMPS2::Davidson::GetBlockSize() const{ return num_block; }
+
 char CheMPS2::Davidson::FetchInstruction( double ** pointers ){
 
    /* 
       Possible states:
        - I : just initialized
        - U : just before the big loop, the initial guess and the diagonal are set
-       - N : a new vector has just been added to the list and a matrix-vector multiplication has been performed
+       - G : the initial guesses of the other roots are being added to the subspace
+       - N : new vectors have just been added to the list and the matrix-vector multiplications have been performed
        - F : the space has been deflated and a few matrix-vector multiplications are required
        - C : convergence was reached
 
       Possible instructions:
        - A : copy the initial guess to pointers[0], the diagonal to pointers[1], and if problem_type=='L' the right-hand side of the linear problem to pointers[2]
-       - B : perform pointers[1] = symmetric matrix times pointers[0]
+       - B : perform pointers[1] = symmetric matrix times pointers[0], for GetBlockSize() consecutive vectors
        - C : copy the converged solution from pointers[0] back; pointers[1][0] contains the converged energy if problem_type=='E' and the residual norm if problem_type=='L'
        - D : there was an error
    */
 
    if ( state == 'I' ){
-      pointers[ 0 ] = t_vec;
+      pointers[ 0 ] = (( num_roots > 1 ) ? roots_vecs : t_vec );
       pointers[ 1 ] = diag;
       if ( problem_type == 'L' ){ pointers[ 2 ] = RHS; }
       state = 'U';
@@ -128,37 +153,62 @@ char CheMPS2::Davidson::FetchInstruction( double ** pointers ){
    }
 
    if ( state == 'U' ){
+      if ( num_roots > 1 ){
+         Special::dcopy64( veclength, roots_vecs, t_vec );
+      }
       SafetyCheckGuess();
       AddNewVec();
-      pointers[ 0 ] =  vecs[ num_vec ];
-      pointers[ 1 ] = Hvecs[ num_vec ];
-      nMultiplications++;
-      state = 'N';
-      return 'B';
+      num_guess = 1;
+      AddGuesses();
+      state = (( num_guess < num_roots ) ? 'G' : 'N' );
+      return RequestMultiplication( pointers );
+   }
+
+   if ( state == 'G' ){
+      StoreMultiplication();
+      DiagonalizeSmallMatrixAndCalcResidual(); // Only to extend mxM with the new vectors
+      AddGuesses();
+      state = (( num_guess < num_roots ) ? 'G' : 'N' );
+      return RequestMultiplication( pointers );
    }
 
    if ( state == 'N' ){
-      const double rnorm = DiagonalizeSmallMatrixAndCalcResidual();
+      StoreMultiplication();
+      double rnorm = DiagonalizeSmallMatrixAndCalcResidual();
       // if ( debug_print ){ cout << "WARNING AT DAVIDSON : Current residual norm = " << rnorm << endl; }
-      if ( rnorm > RTOL ){ // Not yet converged
-         CalculateNewVec();
-         if ( num_vec == MAX_NUM_VEC ){
+      num_corr = 0; // The lowest unconverged roots receive a correction vector
+      for ( int root = 0; ( root < num_roots ) && ( num_corr < block_size ); root++ ){
+         if ( root > 0 ){ rnorm = CalcResidual( root ); }
+         if ( rnorm > RTOL ){ // Not yet converged
+            CalculateNewVec( root );
+            if ( block_size > 1 ){
+               Special::dcopy64( veclength, t_vec, block_corr + veclength * num_corr );
+            }
+            num_corr++;
+         }
+      }
+      if ( num_corr > 0 ){ // Not yet converged
+         if ( num_vec + num_corr > MAX_NUM_VEC ){
             Deflation();
-            pointers[ 0 ] =  vecs[ num_vec ];
-            pointers[ 1 ] = Hvecs[ num_vec ];
-            nMultiplications++;
-            num_vec++;
+            num_new = std::min( block_size, NUM_VEC_KEEP );
             state = 'F';
-            return 'B';
+            return RequestMultiplication( pointers );
          }
-         AddNewVec();
-         pointers[ 0 ] =  vecs[ num_vec ];
-         pointers[ 1 ] = Hvecs[ num_vec ];
-         nMultiplications++;
+         AddCorrections();
          state = 'N';
-         return 'B';
+         return RequestMultiplication( pointers );
       } else { // Converged
          state = 'C';
+         if ( num_roots > 1 ){
+            for ( int cnt = 0; cnt < num_roots; cnt++ ){
+               CalcResidual( cnt );
+               Special::dcopy64( veclength, u_vec, roots_vecs + veclength * cnt );
+               roots_eigs[ cnt ] = mxM_eigs[ cnt ];
+            }
+            pointers[ 0 ] = roots_vecs;
+            pointers[ 1 ] = roots_eigs;
+            return 'C';
+         }
          pointers[ 0 ] = u_vec;
          pointers[ 1 ] = work_vec;
          if ( problem_type == 'E' ){ work_vec[ 0 ] = mxM_eigs[ 0 ]; }
@@ -168,21 +218,18 @@ char CheMPS2::Davidson::FetchInstruction( double ** pointers ){
    }
 
    if ( state == 'F' ){
+      StoreMultiplication();
+      num_vec += num_new;
+      num_new = 0;
       if ( num_vec == NUM_VEC_KEEP ){
          MxMafterDeflation();
-         AddNewVec();
-         pointers[ 0 ] =  vecs[ num_vec ];
-         pointers[ 1 ] = Hvecs[ num_vec ];
-         nMultiplications++;
+         AddCorrections();
          state = 'N';
-         return 'B';
+         return RequestMultiplication( pointers );
       } else {
-         pointers[ 0 ] =  vecs[ num_vec ];
-         pointers[ 1 ] = Hvecs[ num_vec ];
-         nMultiplications++;
-         num_vec++;
+         num_new = std::min( block_size, NUM_VEC_KEEP - num_vec );
          state = 'F';
-         return 'B';
+         return RequestMultiplication( pointers );
       }
    }
 
@@ -190,11 +237,22 @@ char CheMPS2::Davidson::FetchInstruction( double ** pointers ){
 
 }
 
+double CheMPS2::Davidson::Inprod( double * vector1, double * vector2 ){
+
+   double result = Special::ddot64( veclength, vector1, vector2 );
+   #ifdef CHEMPS2_MPI_COMPILATION
+   if ( distributed ){
+      double local = result;
+      MPIchemps2::allreduce_array_double( &local, &result, 1 );
+   }
+   #endif
+   return result;
+
+}
+
 double CheMPS2::Davidson::FrobeniusNorm( double * current_vector ){
 
-   char frobenius = 'F';
-   int inc1 = 1;
-   const double twonorm = dlange_( &frobenius, &veclength, &inc1, current_vector, &veclength, NULL ); // Work is not referenced for Frobenius norm
+   const double twonorm = sqrt( Inprod( current_vector, current_vector ) );
    return twonorm;
 
 }
@@ -203,7 +261,7 @@ void CheMPS2::Davidson::SafetyCheckGuess(){
 
    const double twonorm = FrobeniusNorm( t_vec );
    if ( twonorm == 0.0 ){
-      for ( int cnt = 0; cnt < veclength; cnt++ ){ t_vec[ cnt ] = ( (double) rand() ) / RAND_MAX; }
+      for ( long long cnt = 0; cnt < veclength; cnt++ ){ t_vec[ cnt ] = ( (double) rand() ) / RAND_MAX; }
       if ( debug_print ){
          cout << "WARNING AT DAVIDSON : Initial guess was a zero-vector. Now it is overwritten with random numbers." << endl;
       }
@@ -211,24 +269,32 @@ void CheMPS2::Davidson::SafetyCheckGuess(){
 
 }
 
-void CheMPS2::Davidson::AddNewVec(){
+bool CheMPS2::Davidson::AddNewVec(){
 
-   int inc1 = 1;
+   const int slot = num_vec + num_new;
+   const double norm_in = FrobeniusNorm( t_vec );
 
-   // Orthogonalize the new vector w.r.t. the old basis
-   for ( int cnt = 0; cnt < num_vec; cnt++ ){
-      double minus_overlap = - ddot_( &veclength, t_vec, &inc1, vecs[ cnt ], &inc1 );
-      daxpy_( &veclength, &minus_overlap, vecs[ cnt ], &inc1, t_vec, &inc1 );
+   // Orthogonalize the new vector w.r.t. the old basis and the other new vectors
+   for ( int cnt = 0; cnt < slot; cnt++ ){
+      double minus_overlap = - Inprod( t_vec, vecs[ cnt ] );
+      Special::daxpy64( veclength, minus_overlap, vecs[ cnt ], t_vec );
+   }
+
+   // A correction vector of a block which is ( nearly ) linearly dependent on the others is dropped
+   const double norm_out = FrobeniusNorm( t_vec );
+   if (( num_new > 0 ) && ( norm_out <= 1e-10 * norm_in )){
+      if ( debug_print ){ cout << "WARNING AT DAVIDSON : A linearly dependent vector of the block has been dropped." << endl; }
+      return false;
    }
 
    // Normalize the new vector
-   double alpha = 1.0 / FrobeniusNorm( t_vec );
-   dscal_( &veclength, &alpha, t_vec, &inc1 );
+   double alpha = 1.0 / norm_out;
+   Special::dscal64( veclength, alpha, t_vec );
 
    // The new vector becomes part of vecs
-   if ( num_vec < num_allocated ){
-      double * temp = vecs[ num_vec ];
-      vecs[ num_vec ] = t_vec;
+   if ( slot < num_allocated ){
+      double * temp = vecs[ slot ];
+      vecs[ slot ] = t_vec;
       t_vec = temp;
    } else {
       vecs[ num_allocated ] = t_vec;
@@ -236,6 +302,76 @@ void CheMPS2::Davidson::AddNewVec(){
       t_vec = new double[ veclength ];
       num_allocated++;
    }
+   num_new++;
+   return true;
+
+}
+
+void CheMPS2::Davidson::AddGuesses(){
+
+   while (( num_guess < num_roots ) && ( num_new < block_size )){
+      AddNewGuess();
+      AddNewVec();
+      num_guess++;
+   }
+
+}
+
+void CheMPS2::Davidson::AddCorrections(){
+
+   for ( int corr = 0; corr < num_corr; corr++ ){
+      if ( block_size > 1 ){ Special::dcopy64( veclength, block_corr + veclength * corr, t_vec ); }
+      AddNewVec();
+   }
+   num_corr = 0;
+
+}
+
+char CheMPS2::Davidson::RequestMultiplication( double ** pointers ){
+
+   // The vectors vecs[ num_vec ] up to vecs[ num_vec + num_new - 1 ] should be multiplied with the symmetric matrix
+   if ( num_new == 1 ){
+      pointers[ 0 ] =  vecs[ num_vec ];
+      pointers[ 1 ] = Hvecs[ num_vec ];
+   } else {
+      for ( int vec = 0; vec < num_new; vec++ ){
+         Special::dcopy64( veclength, vecs[ num_vec + vec ], block_vecs + veclength * vec );
+      }
+      pointers[ 0 ] = block_vecs;
+      pointers[ 1 ] = block_Hvecs;
+   }
+   num_block = num_new;
+   nMultiplications += num_new;
+   return 'B';
+
+}
+
+void CheMPS2::Davidson::StoreMultiplication(){
+
+   if ( num_block > 1 ){
+      for ( int vec = 0; vec < num_block; vec++ ){
+         Special::dcopy64( veclength, block_Hvecs + veclength * vec, Hvecs[ num_vec + vec ] );
+      }
+   }
+
+}
+
+void CheMPS2::Davidson::AddNewGuess(){
+
+   Special::dcopy64( veclength, roots_vecs + veclength * num_guess, t_vec );
+   const double norm_guess = FrobeniusNorm( t_vec );
+
+   // Orthogonalize the new guess w.r.t. the old basis and the other new vectors; replace it with random numbers if it is ( nearly ) linearly dependent
+   for ( int cnt = 0; cnt < num_vec + num_new; cnt++ ){
+      double minus_overlap = - Inprod( t_vec, vecs[ cnt ] );
+      Special::daxpy64( veclength, minus_overlap, vecs[ cnt ], t_vec );
+   }
+   if ( FrobeniusNorm( t_vec ) <= 1e-8 * norm_guess ){
+      for ( long long cnt = 0; cnt < veclength; cnt++ ){ t_vec[ cnt ] = ( (double) rand() ) / RAND_MAX - 0.5; }
+      if ( debug_print ){
+         cout << "WARNING AT DAVIDSON : Initial guess " << num_guess << " was linearly dependent. Now it is overwritten with random numbers." << endl;
+      }
+   }
 
 }
 
@@ -243,26 +379,29 @@ double CheMPS2::Davidson::DiagonalizeSmallMatrixAndCalcResidual(){
 
    int inc1 = 1;
 
-   if ( problem_type == 'E' ){ // EIGENVALUE PROBLEM
-      // mxM contains V^T . A . V
-      for ( int cnt = 0; cnt < num_vec; cnt++ ){
-         mxM[ cnt + MAX_NUM_VEC * num_vec ] = ddot_( &veclength, vecs[ num_vec ], &inc1, Hvecs[ cnt ], &inc1 );
-         mxM[ num_vec + MAX_NUM_VEC * cnt ] = mxM[ cnt + MAX_NUM_VEC * num_vec ];
-      }
-      mxM[ num_vec + MAX_NUM_VEC * num_vec ] = ddot_( &veclength, vecs[ num_vec ], &inc1, Hvecs[ num_vec ], &inc1 );
-   } else { // LINEAR PROBLEM
-      // mxM contains V^T . A^T . A . V
-      for ( int cnt = 0; cnt < num_vec; cnt++ ){
-         mxM[ cnt + MAX_NUM_VEC * num_vec ] = ddot_( &veclength, Hvecs[ num_vec ], &inc1, Hvecs[ cnt ], &inc1 );
-         mxM[ num_vec + MAX_NUM_VEC * cnt ] = mxM[ cnt + MAX_NUM_VEC * num_vec ];
+   for ( int inew = num_vec; inew < num_vec + num_new; inew++ ){
+      if ( problem_type == 'E' ){ // EIGENVALUE PROBLEM
+         // mxM contains V^T . A . V
+         for ( int cnt = 0; cnt < inew; cnt++ ){
+            mxM[ cnt + MAX_NUM_VEC * inew ] = Inprod( vecs[ inew ], Hvecs[ cnt ] );
+            mxM[ inew + MAX_NUM_VEC * cnt ] = mxM[ cnt + MAX_NUM_VEC * inew ];
+         }
+         mxM[ inew + MAX_NUM_VEC * inew ] = Inprod( vecs[ inew ], Hvecs[ inew ] );
+      } else { // LINEAR PROBLEM
+         // mxM contains V^T . A^T . A . V
+         for ( int cnt = 0; cnt < inew; cnt++ ){
+            mxM[ cnt + MAX_NUM_VEC * inew ] = Inprod( Hvecs[ inew ], Hvecs[ cnt ] );
+            mxM[ inew + MAX_NUM_VEC * cnt ] = mxM[ cnt + MAX_NUM_VEC * inew ];
+         }
+         mxM[ inew + MAX_NUM_VEC * inew ] = Inprod( Hvecs[ inew ], Hvecs[ inew ] );
+         // mxM_rhs contains V^T . A^T . RHS
+         mxM_rhs[ inew ] = Inprod( Hvecs[ inew ], RHS );
       }
-      mxM[ num_vec + MAX_NUM_VEC * num_vec ] = ddot_( &veclength, Hvecs[ num_vec ], &inc1, Hvecs[ num_vec ], &inc1 );
-      // mxM_rhs contains V^T . A^T . RHS
-      mxM_rhs[ num_vec ] = ddot_( &veclength, Hvecs[ num_vec ], &inc1, RHS, &inc1 );
    }
 
-   // When t-vec was added to vecs, the number of vecs was actually increased by one. Now the number is incremented.
-   num_vec++;
+   // When t-vec was added to vecs, the number of vecs was actually increased. Now the number is incremented.
+   num_vec += num_new;
+   num_new = 0;
 
    // Diagonalize mxM ( always )
    char jobz = 'V';
@@ -296,20 +435,27 @@ double CheMPS2::Davidson::DiagonalizeSmallMatrixAndCalcResidual(){
       for ( int cnt = 0; cnt < num_vec; cnt++ ){ mxM_vecs[ cnt ] = mxM_work[ MAX_NUM_VEC + cnt ]; } // mxM_vecs = U * eigs^{-1} * U^T * RHS
    }
 
+   return CalcResidual( 0 );
+
+}
+
+double CheMPS2::Davidson::CalcResidual( const int root ){
+
+
    // Calculate u and r. r is stored in t_vec, u in u_vec.
-   for ( int cnt = 0; cnt < veclength; cnt++ ){ t_vec[ cnt ] = 0.0; }
-   for ( int cnt = 0; cnt < veclength; cnt++ ){ u_vec[ cnt ] = 0.0; }
+   for ( long long cnt = 0; cnt < veclength; cnt++ ){ t_vec[ cnt ] = 0.0; }
+   for ( long long cnt = 0; cnt < veclength; cnt++ ){ u_vec[ cnt ] = 0.0; }
    for ( int cnt = 0; cnt < num_vec; cnt++ ){
-      double alpha = mxM_vecs[ cnt ]; // Eigenvector with lowest eigenvalue, hence mxM_vecs[ cnt + MAX_NUM_VEC * 0 ]
-      daxpy_( &veclength, &alpha, Hvecs[ cnt ], &inc1, t_vec, &inc1 );
-      daxpy_( &veclength, &alpha,  vecs[ cnt ], &inc1, u_vec, &inc1 );
+      double alpha = mxM_vecs[ cnt + MAX_NUM_VEC * root ]; // Eigenvector with the root-th lowest eigenvalue
+      Special::daxpy64( veclength, alpha, Hvecs[ cnt ], t_vec );
+      Special::daxpy64( veclength, alpha,  vecs[ cnt ], u_vec );
    }
    if ( problem_type == 'E' ){ // t_vec = H * x - lambda * x
-      double alpha = - mxM_eigs[ 0 ];
-      daxpy_( &veclength, &alpha, u_vec, &inc1, t_vec, &inc1 );
+      double alpha = - mxM_eigs[ root ];
+      Special::daxpy64( veclength, alpha, u_vec, t_vec );
    } else { // t_vec = H * x - RHS
       double alpha = -1.0;
-      daxpy_( &veclength, &alpha, RHS, &inc1, t_vec, &inc1 );
+      Special::daxpy64( veclength, alpha, RHS, t_vec );
    }
 
    // Calculate the norm of r
@@ -319,13 +465,12 @@ double CheMPS2::Davidson::DiagonalizeSmallMatrixAndCalcResidual(){
 
 }
 
-void CheMPS2::Davidson::CalculateNewVec(){
+void CheMPS2::Davidson::CalculateNewVec( const int root ){
 
-   int inc1 = 1;
-   const double shift = (( problem_type == 'E' ) ? mxM_eigs[ 0 ] : 0.0 );
+   const double shift = (( problem_type == 'E' ) ? mxM_eigs[ root ] : 0.0 );
 
-   // Calculate the new t_vec based on the residual of the lowest eigenvalue, to add to the vecs.
-   for ( int cnt = 0; cnt < veclength; cnt++ ){
+   // Calculate the new t_vec based on the residual of the root-th lowest eigenvalue, to add to the vecs.
+   for ( long long cnt = 0; cnt < veclength; cnt++ ){
       const double difference = diag[ cnt ] - shift;
       const double fabsdiff   = fabs( difference );
       if ( fabsdiff > DIAG_CUTOFF ){
@@ -335,9 +480,9 @@ void CheMPS2::Davidson::CalculateNewVec(){
          if ( debug_print ){ cout << "WARNING AT DAVIDSON : fabs( precon[" << cnt << "] ) = " << fabsdiff << endl; }
       }
    }
-   double alpha = - ddot_( &veclength, work_vec, &inc1, t_vec, &inc1 ) / ddot_( &veclength, work_vec, &inc1, u_vec, &inc1 ); // alpha = - (u^T K^(-1) r) / (u^T K^(-1) u)
-   daxpy_( &veclength, &alpha, u_vec, &inc1, t_vec, &inc1 ); // t_vec = r - (u^T K^(-1) r) / (u^T K^(-1) u) u
-   for ( int cnt = 0; cnt < veclength; cnt++ ){
+   double alpha = - Inprod( work_vec, t_vec ) / Inprod( work_vec, u_vec ); // alpha = - (u^T K^(-1) r) / (u^T K^(-1) u)
+   Special::daxpy64( veclength, alpha, u_vec, t_vec ); // t_vec = r - (u^T K^(-1) r) / (u^T K^(-1) u) u
+   for ( long long cnt = 0; cnt < veclength; cnt++ ){
       const double difference = diag[ cnt ] - shift;
       const double fabsdiff   = fabs( difference );
        if ( fabsdiff > DIAG_CUTOFF ){
@@ -357,8 +502,8 @@ void CheMPS2::Davidson::Deflation(){
    if ( NUM_VEC_KEEP <= 1 ){
 
       double alpha = 1.0 / FrobeniusNorm( u_vec );
-      dscal_( &veclength, &alpha, u_vec, &inc1 );
-      dcopy_( &veclength, u_vec, &inc1, vecs[ 0 ], &inc1 );
+      Special::dscal64( veclength, alpha, u_vec );
+      Special::dcopy64( veclength, u_vec, vecs[ 0 ] );
 
    } else {
 
@@ -369,25 +514,31 @@ void CheMPS2::Davidson::Deflation(){
       if ( Reortho_Overlap_eigs == NULL ){ Reortho_Overlap_eigs = new double[ NUM_VEC_KEEP                ]; }
       if ( Reortho_Lowdin       == NULL ){ Reortho_Lowdin       = new double[ NUM_VEC_KEEP * NUM_VEC_KEEP ]; }
    
-      // Construct the lowest NUM_VEC_KEEP eigenvectors
-      dcopy_( &veclength, u_vec, &inc1, Reortho_Eigenvecs, &inc1 );
-      for ( int cnt = 1; cnt < NUM_VEC_KEEP; cnt++ ){
-         for ( int irow = 0; irow < veclength; irow++ ){
+      // Construct the lowest NUM_VEC_KEEP eigenvectors; u_vec only contains the lowest one when there is a single root
+      if ( num_roots == 1 ){ Special::dcopy64( veclength, u_vec, Reortho_Eigenvecs ); }
+      for ( int cnt = (( num_roots == 1 ) ? 1 : 0 ); cnt < NUM_VEC_KEEP; cnt++ ){
+         for ( long long irow = 0; irow < veclength; irow++ ){
             Reortho_Eigenvecs[ irow + veclength * cnt ] = 0.0;
-            for ( int ivec = 0; ivec < MAX_NUM_VEC; ivec++ ){
+            for ( int ivec = 0; ivec < num_vec; ivec++ ){
                Reortho_Eigenvecs[ irow + veclength * cnt ] += vecs[ ivec ][ irow ] * mxM_vecs[ ivec + MAX_NUM_VEC * cnt ];
             }
          }
       }
 
       // Calculate the overlap matrix
+      for ( int row = 0; row < NUM_VEC_KEEP; row++ ){
+         for ( int col = row; col < NUM_VEC_KEEP; col++ ){
+            const double overlap = Inprod( Reortho_Eigenvecs + veclength * row, Reortho_Eigenvecs + veclength * col );
+            Reortho_Overlap[ row + NUM_VEC_KEEP * col ] = overlap;
+            Reortho_Overlap[ col + NUM_VEC_KEEP * row ] = overlap;
+         }
+      }
+
+      // Calculate the Lowdin tfo
       char trans  = 'T';
       char notr   = 'N';
       double one  = 1.0;
       double zero = 0.0; //set
-      dgemm_( &trans, &notr, &NUM_VEC_KEEP, &NUM_VEC_KEEP, &veclength, &one, Reortho_Eigenvecs, &veclength, Reortho_Eigenvecs, &veclength, &zero, Reortho_Overlap, &NUM_VEC_KEEP );
-
-      // Calculate the Lowdin tfo
       char jobz = 'V';
       char uplo = 'U';
       int info;
@@ -400,9 +551,9 @@ void CheMPS2::Davidson::Deflation(){
 
       // Reortho: Put the Lowdin tfo eigenvecs in vecs
       for ( int ivec = 0; ivec < NUM_VEC_KEEP; ivec++ ){
-         for ( int loop = 0; loop < veclength; loop++ ){ vecs[ ivec ][ loop ] = 0.0; }
+         for ( long long loop = 0; loop < veclength; loop++ ){ vecs[ ivec ][ loop ] = 0.0; }
          for ( int ivec2 = 0; ivec2 < NUM_VEC_KEEP; ivec2++ ){
-            daxpy_( &veclength, Reortho_Lowdin + ivec2 + NUM_VEC_KEEP * ivec, Reortho_Eigenvecs + veclength * ivec2, &inc1, vecs[ ivec ], &inc1 );
+            Special::daxpy64( veclength, Reortho_Lowdin[ ivec2 + NUM_VEC_KEEP * ivec ], Reortho_Eigenvecs + veclength * ivec2, vecs[ ivec ] );
          }
       }
    }
@@ -509,13 +660,12 @@ void CheMPS2::Davidson::SolveLinearSystemDeflation( const int NUM_SOLUTIONS ){
 
 void CheMPS2::Davidson::MxMafterDeflation(){
 
-   int inc1 = 1;
 
    if ( problem_type == 'E' ){ // EIGENVALUE PROBLEM
       // mxM contains V^T . A . V
       for ( int ivec = 0; ivec < NUM_VEC_KEEP; ivec++ ){
          for ( int ivec2 = ivec; ivec2 < NUM_VEC_KEEP; ivec2++ ){
-            mxM[ ivec + MAX_NUM_VEC * ivec2 ] = ddot_( &veclength, vecs[ ivec ], &inc1, Hvecs[ ivec2 ], &inc1 );
+            mxM[ ivec + MAX_NUM_VEC * ivec2 ] = Inprod( vecs[ ivec ], Hvecs[ ivec2 ] );
             mxM[ ivec2 + MAX_NUM_VEC * ivec ] = mxM[ ivec + MAX_NUM_VEC * ivec2 ];
          }
       }
@@ -523,13 +673,13 @@ void CheMPS2::Davidson::MxMafterDeflation(){
       // mxM contains V^T . A^T . A . V
       for ( int ivec = 0; ivec < NUM_VEC_KEEP; ivec++ ){
          for ( int ivec2 = ivec; ivec2 < NUM_VEC_KEEP; ivec2++ ){
-            mxM[ ivec + MAX_NUM_VEC * ivec2 ] = ddot_( &veclength, Hvecs[ ivec ], &inc1, Hvecs[ ivec2 ], &inc1 );
+            mxM[ ivec + MAX_NUM_VEC * ivec2 ] = Inprod( Hvecs[ ivec ], Hvecs[ ivec2 ] );
             mxM[ ivec2 + MAX_NUM_VEC * ivec ] = mxM[ ivec + MAX_NUM_VEC * ivec2 ];
          }
       }
       // mxM_rhs contains V^T . A^T . RHS
       for ( int ivec = 0; ivec < NUM_VEC_KEEP; ivec++ ){
-         mxM_rhs[ ivec ] = ddot_( &veclength, Hvecs[ ivec ], &inc1, RHS, &inc1 );
+         mxM_rhs[ ivec ] = Inprod( Hvecs[ ivec ], RHS );
       }
    }
 
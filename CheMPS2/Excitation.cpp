@@ -101,10 +101,10 @@ double CheMPS2::Excitation::matvec( const SyBookkeeper * book_up, const SyBookke
 
 void CheMPS2::Excitation::clear( const int ikappa, Sobject * S_up ){
 
-   const int start  = S_up->gKappa2index( ikappa );
-   const int stop   = S_up->gKappa2index( ikappa + 1 );
+   const long long start = S_up->gKappa2index( ikappa );
+   const long long stop  = S_up->gKappa2index( ikappa + 1 );
    double * storage = S_up->gStorage();
-   for ( int cnt = start; cnt < stop; cnt++ ){ storage[ cnt ] = 0.0; }
+   for ( long long cnt = start; cnt < stop; cnt++ ){ storage[ cnt ] = 0.0; }
 
 }
 
@@ -22,228 +22,379 @@
 #include <iostream>
 #include <algorithm>
 #include <assert.h>
+#include <sys/time.h>
 
 #include "Heff.h"
 #include "Davidson.h"
 #include "Lapack.h"
 #include "MPIchemps2.h"
+#include "Special.h"
 
-CheMPS2::Heff::Heff(const SyBookkeeper * denBKIn, const Problem * ProbIn, const double dvdson_rtol_in){
+CheMPS2::Heff::Heff(const SyBookkeeper * denBKIn, const Problem * ProbIn, const double dvdson_rtol_in, Workspace * work_in, const long long distribute_size_in){
 
    denBK = denBKIn;
    Prob = ProbIn;
    dvdson_rtol = dvdson_rtol_in;
+   distribute_size = distribute_size_in;
+   num_matvec = 0;
+   mult_time = 0.0;
+   plan = NULL;
+   own_work = ( work_in == NULL );
+   work = (( own_work ) ? new Workspace() : work_in );
 
 }
 
 CheMPS2::Heff::~Heff(){
 
+   if ( plan != NULL ){ delete plan; }
+   if ( own_work ){ delete work; }
+
+}
+
+int CheMPS2::Heff::gNumMultiplications() const{ return num_matvec; }
+
+double CheMPS2::Heff::gMultiplicationTime() const{ return mult_time; }
+
+void CheMPS2::Heff::planDgemm(char * transA, char * transB, int * m, int * n, int * k, double * alpha, double * A, int * lda, double * B, int * ldb, double * beta, double * C, int * ldc) const{
+
+   dgemm_(transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+   if ( plan != NULL ){ plan->dgemm(transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc); }
+
+}
+
+void CheMPS2::Heff::planDaxpy(int * n, double * alpha, double * x, int * incx, double * y, int * incy) const{
+
+   daxpy_(n, alpha, x, incx, y, incy);
+   if ( plan != NULL ){ plan->daxpy(n, alpha, x, incx, y, incy); }
+
+}
+
+void CheMPS2::Heff::planDcopy(int * n, double * x, int * incx, double * y, int * incy) const{
+
+   dcopy_(n, x, incx, y, incy);
+   if ( plan != NULL ){ plan->dcopy(n, x, incx, y, incy); }
+
+}
+
+void CheMPS2::Heff::planClear(double * x, int n) const{
+
+   for (int cnt=0; cnt<n; cnt++){ x[cnt] = 0.0; }
+   if ( plan != NULL ){ plan->clear(x, n); }
+
 }
 
 void CheMPS2::Heff::makeHeff(double * memS, double * memHeff, const Sobject * denS, TensorL *** Ltensors, TensorOperator **** Atensors, TensorOperator **** Btensors, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorS0 **** S0tensors, TensorS1 **** S1tensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorQ *** Qtensors, TensorX ** Xtensors, int nLower, double ** VeffTilde) const{
 
+   makeHeff(memS, memHeff, 1, denS, Ltensors, Atensors, Btensors, Ctensors, Dtensors, S0tensors, S1tensors, F0tensors, F1tensors, Qtensors, Xtensors, nLower, VeffTilde);
+
+}
+
+void CheMPS2::Heff::makeHeff(double * memS, double * memHeff, const int num_vectors, const Sobject * denS, TensorL *** Ltensors, TensorOperator **** Atensors, TensorOperator **** Btensors, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorS0 **** S0tensors, TensorS1 **** S1tensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorQ *** Qtensors, TensorX ** Xtensors, int nLower, double ** VeffTilde) const{
+
    const int indexS = denS->gIndex();
    const bool atLeft  = (indexS==0)?true:false;
    const bool atRight = (indexS==Prob->gL()-2)?true:false;
    const int DIM = std::max(denBK->gMaxDimAtBound(indexS), denBK->gMaxDimAtBound(indexS+2));
+   const long long veclength = denS->gKappa2index(denS->gNKappa());
    #ifdef CHEMPS2_MPI_COMPILATION
    const int MPIRANK = MPIchemps2::mpi_rank();
    #endif
+   struct timeval start, end;
+   gettimeofday(&start, NULL);
+   
+   /* The diagrams only depend on the site and the symmetry sectors of denS: during the first multiplication at the site,
+      their BLAS calls are recorded in the contraction plan, and the subsequent multiplications execute the plan. */
+   if (( plan != NULL ) && ( plan->gSobject() != denS )){
+      delete plan;
+      plan = NULL;
+   }
+   if ( plan == NULL ){ plan = new HeffPlan(denS, HEFF_PLAN_MAX_MB); }
+   if ( plan->gComplete() ){
+   
+      plan->prepare(num_vectors);
+      const int num_tasks = plan->gNumTasks();
+      
+      #pragma omp parallel
+      {
+      
+         double * temp  = work->get_double(0, ((long long) DIM) * DIM * num_vectors);
+         double * temp2 = work->get_double(1, ((long long) DIM) * DIM * num_vectors);
+         
+         // Several vectors are multiplied in the block layout of the plan, in which the vectors of a sector are consecutive
+         #pragma omp for schedule(static)
+         for (int ikappa=0; ikappa<denS->gNKappa(); ikappa++){ plan->load(ikappa, memS); }
+         
+         // Tasks are (sector, diagram groups) pairs, in order of decreasing cost; the tasks of one sector write to separate partial blocks
+         #pragma omp for schedule(dynamic)
+         for (int task=0; task<num_tasks; task++){ plan->execute(task, memS, memHeff, temp, temp2); }
+         
+         #pragma omp for schedule(dynamic)
+         for (int ikappaBIS=0; ikappaBIS<denS->gNKappa(); ikappaBIS++){
+            const int ikappa = denS->gReorder(ikappaBIS);
+            plan->reduce(ikappa, memHeff);
+            for (int vec=0; vec<num_vectors; vec++){
+               addDiagramExcitations(ikappa, memS + veclength * vec, memHeff + veclength * vec, denS, nLower, VeffTilde); //The MPI check occurs in this function
+            }
+         }
+      
+      }
+      gettimeofday(&end, NULL);
+      mult_time += (end.tv_sec - start.tv_sec) + 1e-6 * (end.tv_usec - start.tv_usec);
+      return;
+   
+   }
+   const bool record = plan->gEmpty();
    
    //PARALLEL
    #pragma omp parallel
    {
    
-      double * temp  = new double[DIM*DIM];
-      double * temp2 = new double[DIM*DIM];
+      double * temp  = work->get_double(0, DIM*DIM);
+      double * temp2 = work->get_double(1, DIM*DIM);
    
       #pragma omp for schedule(dynamic)
       for (int ikappaBIS=0; ikappaBIS<denS->gNKappa(); ikappaBIS++){
       
          const int ikappa = denS->gReorder(ikappaBIS);
-         for (int cnt=denS->gKappa2index(ikappa); cnt<denS->gKappa2index(ikappa+1); cnt++){ memHeff[cnt] = 0.0; }
+         // The operator blocks needed for sector ikappa are reused for all vectors of the block
+         for (int vec=0; vec<num_vectors; vec++){
          
-         #ifdef CHEMPS2_MPI_COMPILATION
-         if ( MPIchemps2::owner_1cd2d3eh() == MPIRANK )
-         #endif
-         {
-            addDiagram1C(ikappa, memS,memHeff,denS,Prob->gMxElement(indexS,indexS,indexS,indexS));
-            addDiagram1D(ikappa, memS,memHeff,denS,Prob->gMxElement(indexS+1,indexS+1,indexS+1,indexS+1));
-            addDiagram2dall(ikappa, memS, memHeff, denS);
-            addDiagram3Eand3H(ikappa, memS, memHeff, denS);
-         }
-         addDiagramExcitations(ikappa, memS, memHeff, denS, nLower, VeffTilde); //The MPI check occurs in this function
+            double * vecS    = memS    + veclength * vec;
+            double * vecHeff = memHeff + veclength * vec;
+            for (long long cnt=denS->gKappa2index(ikappa); cnt<denS->gKappa2index(ikappa+1); cnt++){ vecHeff[cnt] = 0.0; }
+            if (( record ) && ( vec == 0 )){ plan->start(ikappa, vecS, vecHeff, temp, temp2, DIM*DIM); } // Diagram groups are separated by plan->cut()
          
-         if (!atLeft){
-
-            /*********************
-            *  Diagrams group 1  *
-            *********************/
-            #ifdef CHEMPS2_MPI_COMPILATION
-            if ( MPIchemps2::owner_x() == MPIRANK )
-            #endif
-            {  addDiagram1A(ikappa, memS, memHeff, denS, Xtensors[indexS-1]); }
-
-            /*********************
-            *  Diagrams group 2  *
-            *********************/
             #ifdef CHEMPS2_MPI_COMPILATION
-            if ( MPIchemps2::owner_absigma( indexS, indexS ) == MPIRANK )
+            if ( MPIchemps2::owner_1cd2d3eh() == MPIRANK )
             #endif
-            {  addDiagram2b1and2b2(ikappa, memS, memHeff, denS, Atensors[indexS-1][0][0]); }
-            #ifdef CHEMPS2_MPI_COMPILATION
-            if ( MPIchemps2::owner_absigma( indexS+1, indexS+1 ) == MPIRANK )
-            #endif
-            { addDiagram2c1and2c2(ikappa, memS, memHeff, denS, Atensors[indexS-1][0][1]); }
-            #ifdef CHEMPS2_MPI_COMPILATION
-            if ( MPIchemps2::owner_cdf( Prob->gL(), indexS, indexS ) == MPIRANK )
-            #endif
-            {  addDiagram2b3spin0(ikappa, memS, memHeff, denS, Ctensors[indexS-1][0][0]);
-               addDiagram2b3spin1(ikappa, memS, memHeff, denS, Dtensors[indexS-1][0][0]); }
-            #ifdef CHEMPS2_MPI_COMPILATION
-            if ( MPIchemps2::owner_cdf( Prob->gL(), indexS+1, indexS+1 ) == MPIRANK )
-            #endif
-            {  addDiagram2c3spin0(ikappa, memS, memHeff, denS, Ctensors[indexS-1][0][1]);
-               addDiagram2c3spin1(ikappa, memS, memHeff, denS, Dtensors[indexS-1][0][1]); }
-
-            /*********************
-            *  Diagrams group 3  *
-            *********************/
-            #ifdef CHEMPS2_MPI_COMPILATION
-            if ( MPIchemps2::owner_q( Prob->gL(), indexS ) == MPIRANK )
-            #endif
-            {  addDiagram3Aand3D(ikappa, memS, memHeff, denS, Qtensors[indexS-1][0], Ltensors[indexS-1], temp); }
-            #ifdef CHEMPS2_MPI_COMPILATION
-            if ( MPIchemps2::owner_q( Prob->gL(), indexS+1 ) == MPIRANK )
-            #endif
-            {  addDiagram3Band3I(ikappa, memS, memHeff, denS, Qtensors[indexS-1][1], Ltensors[indexS-1], temp); }
-
-            /*********************
-            *  Diagrams group 4  *
-            *********************/
-            #ifdef CHEMPS2_MPI_COMPILATION
-            if ( MPIchemps2::owner_absigma( indexS, indexS+1 ) == MPIRANK )
-            #endif
-            {  addDiagram4A1and4A2spin0(ikappa, memS, memHeff, denS, Atensors[indexS-1][1][0]);
-               addDiagram4A1and4A2spin1(ikappa, memS, memHeff, denS, Btensors[indexS-1][1][0]); }
-            #ifdef CHEMPS2_MPI_COMPILATION
-            if ( MPIchemps2::owner_cdf( Prob->gL(), indexS, indexS+1 ) == MPIRANK )
-            #endif
-            {  addDiagram4A3and4A4spin0(ikappa, memS, memHeff, denS, Ctensors[indexS-1][1][0]);
-               addDiagram4A3and4A4spin1(ikappa, memS, memHeff, denS, Dtensors[indexS-1][1][0]); }
-            addDiagram4D(ikappa, memS, memHeff, denS, Ltensors[indexS-1], temp); //The MPI check occurs in this function
-            addDiagram4I(ikappa, memS, memHeff, denS, Ltensors[indexS-1], temp); //The MPI check occurs in this function
-
-         }
+            {
+               addDiagram1C(ikappa, vecS,vecHeff,denS,Prob->gMxElement(indexS,indexS,indexS,indexS));
+               addDiagram1D(ikappa, vecS,vecHeff,denS,Prob->gMxElement(indexS+1,indexS+1,indexS+1,indexS+1));
+               addDiagram2dall(ikappa, vecS, vecHeff, denS);
+               addDiagram3Eand3H(ikappa, vecS, vecHeff, denS);
+            }
+            addDiagramExcitations(ikappa, vecS, vecHeff, denS, nLower, VeffTilde); //The MPI check occurs in this function
+            plan->cut();
          
-         if (!atRight){
-
-            /*********************
-            *  Diagrams group 1  *
-            *********************/
-            #ifdef CHEMPS2_MPI_COMPILATION
-            if ( MPIchemps2::owner_x() == MPIRANK )
-            #endif
-            {  addDiagram1B(ikappa, memS, memHeff, denS, Xtensors[indexS+1]); }
-
-            /*********************
-            *  Diagrams group 2  *
-            *********************/
-            #ifdef CHEMPS2_MPI_COMPILATION
-            if ( MPIchemps2::owner_absigma( indexS, indexS ) == MPIRANK )
-            #endif
-            {  addDiagram2e1and2e2(ikappa, memS, memHeff, denS, Atensors[indexS+1][0][1]); }
-            #ifdef CHEMPS2_MPI_COMPILATION
-            if ( MPIchemps2::owner_absigma( indexS+1, indexS+1 ) == MPIRANK )
-            #endif
-            { addDiagram2f1and2f2(ikappa, memS, memHeff, denS, Atensors[indexS+1][0][0]); }
-            #ifdef CHEMPS2_MPI_COMPILATION
-            if ( MPIchemps2::owner_cdf( Prob->gL(), indexS, indexS ) == MPIRANK )
-            #endif
-            {  addDiagram2e3spin0(ikappa, memS, memHeff, denS, Ctensors[indexS+1][0][1]);
-               addDiagram2e3spin1(ikappa, memS, memHeff, denS, Dtensors[indexS+1][0][1]); }
-            #ifdef CHEMPS2_MPI_COMPILATION
-            if ( MPIchemps2::owner_cdf( Prob->gL(), indexS+1, indexS+1 ) == MPIRANK )
-            #endif
-            {  addDiagram2f3spin0(ikappa, memS, memHeff, denS, Ctensors[indexS+1][0][0]);
-               addDiagram2f3spin1(ikappa, memS, memHeff, denS, Dtensors[indexS+1][0][0]); }
-
-            /*********************
-            *  Diagrams group 3  *
-            *********************/
-            #ifdef CHEMPS2_MPI_COMPILATION
-            if ( MPIchemps2::owner_q( Prob->gL(), indexS ) == MPIRANK )
-            #endif
-            {  addDiagram3Kand3F(ikappa, memS, memHeff, denS, Qtensors[indexS+1][1], Ltensors[indexS+1], temp); }
-            #ifdef CHEMPS2_MPI_COMPILATION
-            if ( MPIchemps2::owner_q( Prob->gL(), indexS+1 ) == MPIRANK )
-            #endif
-            {  addDiagram3Land3G(ikappa, memS, memHeff, denS, Qtensors[indexS+1][0], Ltensors[indexS+1], temp); }
-
-            /*********************
-            *  Diagrams group 4  *
-            *********************/
-            #ifdef CHEMPS2_MPI_COMPILATION
-            if ( MPIchemps2::owner_absigma( indexS, indexS+1 ) == MPIRANK )
-            #endif
-            {  addDiagram4J1and4J2spin0(ikappa, memS, memHeff, denS, Atensors[indexS+1][1][0]);
-               addDiagram4J1and4J2spin1(ikappa, memS, memHeff, denS, Btensors[indexS+1][1][0]); }
-            #ifdef CHEMPS2_MPI_COMPILATION
-            if ( MPIchemps2::owner_cdf( Prob->gL(), indexS, indexS+1 ) == MPIRANK )
-            #endif
-            {  addDiagram4J3and4J4spin0(ikappa, memS, memHeff, denS, Ctensors[indexS+1][1][0]);
-               addDiagram4J3and4J4spin1(ikappa, memS, memHeff, denS, Dtensors[indexS+1][1][0]); }
-            addDiagram4F(ikappa, memS, memHeff, denS, Ltensors[indexS+1], temp); //The MPI check occurs in this function
-            addDiagram4G(ikappa, memS, memHeff, denS, Ltensors[indexS+1], temp); //The MPI check occurs in this function
-
-         }
+            if (!atLeft){
+
+               /*********************
+               *  Diagrams group 1  *
+               *********************/
+               #ifdef CHEMPS2_MPI_COMPILATION
+               if ( MPIchemps2::owner_x() == MPIRANK )
+               #endif
+               {  addDiagram1A(ikappa, vecS, vecHeff, denS, Xtensors[indexS-1]); }
+               plan->cut();
+
+               /*********************
+               *  Diagrams group 2  *
+               *********************/
+               #ifdef CHEMPS2_MPI_COMPILATION
+               if ( MPIchemps2::owner_absigma( indexS, indexS ) == MPIRANK )
+               #endif
+               {  addDiagram2b1and2b2(ikappa, vecS, vecHeff, denS, Atensors[indexS-1][0][0]); }
+               #ifdef CHEMPS2_MPI_COMPILATION
+               if ( MPIchemps2::owner_absigma( indexS+1, indexS+1 ) == MPIRANK )
+               #endif
+               { addDiagram2c1and2c2(ikappa, vecS, vecHeff, denS, Atensors[indexS-1][0][1]); }
+               #ifdef CHEMPS2_MPI_COMPILATION
+               if ( MPIchemps2::owner_cdf( Prob->gL(), indexS, indexS ) == MPIRANK )
+               #endif
+               {  addDiagram2b3spin0(ikappa, vecS, vecHeff, denS, Ctensors[indexS-1][0][0]);
+                  addDiagram2b3spin1(ikappa, vecS, vecHeff, denS, Dtensors[indexS-1][0][0]); }
+               #ifdef CHEMPS2_MPI_COMPILATION
+               if ( MPIchemps2::owner_cdf( Prob->gL(), indexS+1, indexS+1 ) == MPIRANK )
+               #endif
+               {  addDiagram2c3spin0(ikappa, vecS, vecHeff, denS, Ctensors[indexS-1][0][1]);
+                  addDiagram2c3spin1(ikappa, vecS, vecHeff, denS, Dtensors[indexS-1][0][1]); }
+               plan->cut();
+
+               /*********************
+               *  Diagrams group 3  *
+               *********************/
+               #ifdef CHEMPS2_MPI_COMPILATION
+               if ( MPIchemps2::owner_q( Prob->gL(), indexS ) == MPIRANK )
+               #endif
+               {  addDiagram3Aand3D(ikappa, vecS, vecHeff, denS, Qtensors[indexS-1][0], Ltensors[indexS-1], temp); }
+               #ifdef CHEMPS2_MPI_COMPILATION
+               if ( MPIchemps2::owner_q( Prob->gL(), indexS+1 ) == MPIRANK )
+               #endif
+               {  addDiagram3Band3I(ikappa, vecS, vecHeff, denS, Qtensors[indexS-1][1], Ltensors[indexS-1], temp); }
+               plan->cut();
+
+               /*********************
+               *  Diagrams group 4  *
+               *********************/
+               #ifdef CHEMPS2_MPI_COMPILATION
+               if ( MPIchemps2::owner_absigma( indexS, indexS+1 ) == MPIRANK )
+               #endif
+               {  addDiagram4A1and4A2spin0(ikappa, vecS, vecHeff, denS, Atensors[indexS-1][1][0]);
+                  addDiagram4A1and4A2spin1(ikappa, vecS, vecHeff, denS, Btensors[indexS-1][1][0]); }
+               #ifdef CHEMPS2_MPI_COMPILATION
+               if ( MPIchemps2::owner_cdf( Prob->gL(), indexS, indexS+1 ) == MPIRANK )
+               #endif
+               {  addDiagram4A3and4A4spin0(ikappa, vecS, vecHeff, denS, Ctensors[indexS-1][1][0]);
+                  addDiagram4A3and4A4spin1(ikappa, vecS, vecHeff, denS, Dtensors[indexS-1][1][0]); }
+               addDiagram4D(ikappa, vecS, vecHeff, denS, Ltensors[indexS-1], temp); //The MPI check occurs in this function
+               addDiagram4I(ikappa, vecS, vecHeff, denS, Ltensors[indexS-1], temp); //The MPI check occurs in this function
+               plan->cut();
+
+            }
+         
+            if (!atRight){
+
+               /*********************
+               *  Diagrams group 1  *
+               *********************/
+               #ifdef CHEMPS2_MPI_COMPILATION
+               if ( MPIchemps2::owner_x() == MPIRANK )
+               #endif
+               {  addDiagram1B(ikappa, vecS, vecHeff, denS, Xtensors[indexS+1]); }
+               plan->cut();
+
+               /*********************
+               *  Diagrams group 2  *
+               *********************/
+               #ifdef CHEMPS2_MPI_COMPILATION
+               if ( MPIchemps2::owner_absigma( indexS, indexS ) == MPIRANK )
+               #endif
+               {  addDiagram2e1and2e2(ikappa, vecS, vecHeff, denS, Atensors[indexS+1][0][1]); }
+               #ifdef CHEMPS2_MPI_COMPILATION
+               if ( MPIchemps2::owner_absigma( indexS+1, indexS+1 ) == MPIRANK )
+               #endif
+               { addDiagram2f1and2f2(ikappa, vecS, vecHeff, denS, Atensors[indexS+1][0][0]); }
+               #ifdef CHEMPS2_MPI_COMPILATION
+               if ( MPIchemps2::owner_cdf( Prob->gL(), indexS, indexS ) == MPIRANK )
+               #endif
+               {  addDiagram2e3spin0(ikappa, vecS, vecHeff, denS, Ctensors[indexS+1][0][1]);
+                  addDiagram2e3spin1(ikappa, vecS, vecHeff, denS, Dtensors[indexS+1][0][1]); }
+               #ifdef CHEMPS2_MPI_COMPILATION
+               if ( MPIchemps2::owner_cdf( Prob->gL(), indexS+1, indexS+1 ) == MPIRANK )
+               #endif
+               {  addDiagram2f3spin0(ikappa, vecS, vecHeff, denS, Ctensors[indexS+1][0][0]);
+                  addDiagram2f3spin1(ikappa, vecS, vecHeff, denS, Dtensors[indexS+1][0][0]); }
+               plan->cut();
+
+               /*********************
+               *  Diagrams group 3  *
+               *********************/
+               #ifdef CHEMPS2_MPI_COMPILATION
+               if ( MPIchemps2::owner_q( Prob->gL(), indexS ) == MPIRANK )
+               #endif
+               {  addDiagram3Kand3F(ikappa, vecS, vecHeff, denS, Qtensors[indexS+1][1], Ltensors[indexS+1], temp); }
+               #ifdef CHEMPS2_MPI_COMPILATION
+               if ( MPIchemps2::owner_q( Prob->gL(), indexS+1 ) == MPIRANK )
+               #endif
+               {  addDiagram3Land3G(ikappa, vecS, vecHeff, denS, Qtensors[indexS+1][0], Ltensors[indexS+1], temp); }
+               plan->cut();
+
+               /*********************
+               *  Diagrams group 4  *
+               *********************/
+               #ifdef CHEMPS2_MPI_COMPILATION
+               if ( MPIchemps2::owner_absigma( indexS, indexS+1 ) == MPIRANK )
+               #endif
+               {  addDiagram4J1and4J2spin0(ikappa, vecS, vecHeff, denS, Atensors[indexS+1][1][0]);
+                  addDiagram4J1and4J2spin1(ikappa, vecS, vecHeff, denS, Btensors[indexS+1][1][0]); }
+               #ifdef CHEMPS2_MPI_COMPILATION
+               if ( MPIchemps2::owner_cdf( Prob->gL(), indexS, indexS+1 ) == MPIRANK )
+               #endif
+               {  addDiagram4J3and4J4spin0(ikappa, vecS, vecHeff, denS, Ctensors[indexS+1][1][0]);
+                  addDiagram4J3and4J4spin1(ikappa, vecS, vecHeff, denS, Dtensors[indexS+1][1][0]); }
+               addDiagram4F(ikappa, vecS, vecHeff, denS, Ltensors[indexS+1], temp); //The MPI check occurs in this function
+               addDiagram4G(ikappa, vecS, vecHeff, denS, Ltensors[indexS+1], temp); //The MPI check occurs in this function
+               plan->cut();
+
+            }
          
-         if ((!atLeft) && (!atRight)){
+            if ((!atLeft) && (!atRight)){
          
-            addDiagram2a1spin0(ikappa, memS, memHeff, denS, Atensors, S0tensors, temp); //The MPI check occurs in this function
-            addDiagram2a2spin0(ikappa, memS, memHeff, denS, Atensors, S0tensors, temp); //The MPI check occurs in this function
-            addDiagram2a1spin1(ikappa, memS, memHeff, denS, Btensors, S1tensors, temp); //The MPI check occurs in this function
-            addDiagram2a2spin1(ikappa, memS, memHeff, denS, Btensors, S1tensors, temp); //The MPI check occurs in this function
-            addDiagram2a3spin0(ikappa, memS, memHeff, denS, Ctensors, F0tensors, temp); //The MPI check occurs in this function
-            addDiagram2a3spin1(ikappa, memS, memHeff, denS, Dtensors, F1tensors, temp); //The MPI check occurs in this function
+               addDiagram2a1spin0(ikappa, vecS, vecHeff, denS, Atensors, S0tensors, temp); //The MPI check occurs in this function
+         
+               plan->cut();
+               addDiagram2a2spin0(ikappa, vecS, vecHeff, denS, Atensors, S0tensors, temp); //The MPI check occurs in this function
+               plan->cut();
+               addDiagram2a1spin1(ikappa, vecS, vecHeff, denS, Btensors, S1tensors, temp); //The MPI check occurs in this function
+               plan->cut();
+               addDiagram2a2spin1(ikappa, vecS, vecHeff, denS, Btensors, S1tensors, temp); //The MPI check occurs in this function
+               plan->cut();
+               addDiagram2a3spin0(ikappa, vecS, vecHeff, denS, Ctensors, F0tensors, temp); //The MPI check occurs in this function
+               plan->cut();
+               addDiagram2a3spin1(ikappa, vecS, vecHeff, denS, Dtensors, F1tensors, temp); //The MPI check occurs in this function
+               plan->cut();
+            
+               addDiagram3C(ikappa, vecS, vecHeff, denS, Qtensors[indexS-1], Ltensors[indexS+1], temp); //The MPI check occurs in this function
             
-            addDiagram3C(ikappa, memS, memHeff, denS, Qtensors[indexS-1], Ltensors[indexS+1], temp); //The MPI check occurs in this function
-            addDiagram3J(ikappa, memS, memHeff, denS, Qtensors[indexS+1], Ltensors[indexS-1], temp); //The MPI check occurs in this function
+               plan->cut();
+               addDiagram3J(ikappa, vecS, vecHeff, denS, Qtensors[indexS+1], Ltensors[indexS-1], temp); //The MPI check occurs in this function
+               plan->cut();
             
-            addDiagram4B1and4B2spin0(ikappa, memS, memHeff, denS, Atensors[indexS-1], Ltensors[indexS+1], temp); //The MPI check occurs in this function
-            addDiagram4B1and4B2spin1(ikappa, memS, memHeff, denS, Btensors[indexS-1], Ltensors[indexS+1], temp); //The MPI check occurs in this function
-            addDiagram4B3and4B4spin0(ikappa, memS, memHeff, denS, Ctensors[indexS-1], Ltensors[indexS+1], temp); //The MPI check occurs in this function
-            addDiagram4B3and4B4spin1(ikappa, memS, memHeff, denS, Dtensors[indexS-1], Ltensors[indexS+1], temp); //The MPI check occurs in this function
-            addDiagram4C1and4C2spin0(ikappa, memS, memHeff, denS, Atensors[indexS-1], Ltensors[indexS+1], temp); //The MPI check occurs in this function
-            addDiagram4C1and4C2spin1(ikappa, memS, memHeff, denS, Btensors[indexS-1], Ltensors[indexS+1], temp); //The MPI check occurs in this function
-            addDiagram4C3and4C4spin0(ikappa, memS, memHeff, denS, Ctensors[indexS-1], Ltensors[indexS+1], temp); //The MPI check occurs in this function
-            addDiagram4C3and4C4spin1(ikappa, memS, memHeff, denS, Dtensors[indexS-1], Ltensors[indexS+1], temp); //The MPI check occurs in this function
-            addDiagram4E(ikappa, memS, memHeff, denS, Ltensors[indexS-1], Ltensors[indexS+1], temp, temp2); //The MPI check occurs in this function
-            addDiagram4H(ikappa, memS, memHeff, denS, Ltensors[indexS-1], Ltensors[indexS+1], temp, temp2); //The MPI check occurs in this function
-            addDiagram4K1and4K2spin0(ikappa, memS, memHeff, denS, Ltensors[indexS-1], Atensors[indexS+1], temp); //The MPI check occurs in this function
-            addDiagram4L1and4L2spin0(ikappa, memS, memHeff, denS, Ltensors[indexS-1], Atensors[indexS+1], temp); //The MPI check occurs in this function
-            addDiagram4K1and4K2spin1(ikappa, memS, memHeff, denS, Ltensors[indexS-1], Btensors[indexS+1], temp); //The MPI check occurs in this function
-            addDiagram4L1and4L2spin1(ikappa, memS, memHeff, denS, Ltensors[indexS-1], Btensors[indexS+1], temp); //The MPI check occurs in this function
-            addDiagram4K3and4K4spin0(ikappa, memS, memHeff, denS, Ltensors[indexS-1], Ctensors[indexS+1], temp); //The MPI check occurs in this function
-            addDiagram4L3and4L4spin0(ikappa, memS, memHeff, denS, Ltensors[indexS-1], Ctensors[indexS+1], temp); //The MPI check occurs in this function
-            addDiagram4K3and4K4spin1(ikappa, memS, memHeff, denS, Ltensors[indexS-1], Dtensors[indexS+1], temp); //The MPI check occurs in this function
-            addDiagram4L3and4L4spin1(ikappa, memS, memHeff, denS, Ltensors[indexS-1], Dtensors[indexS+1], temp); //The MPI check occurs in this function
+               addDiagram4B1and4B2spin0(ikappa, vecS, vecHeff, denS, Atensors[indexS-1], Ltensors[indexS+1], temp); //The MPI check occurs in this function
             
-            addDiagram5A(ikappa, memS, memHeff, denS, Ltensors[indexS-1], Ltensors[indexS+1], temp, temp2); //The MPI check occurs in this function
-            addDiagram5B(ikappa, memS, memHeff, denS, Ltensors[indexS-1], Ltensors[indexS+1], temp, temp2); //The MPI check occurs in this function
-            addDiagram5C(ikappa, memS, memHeff, denS, Ltensors[indexS-1], Ltensors[indexS+1], temp, temp2); //The MPI check occurs in this function
-            addDiagram5D(ikappa, memS, memHeff, denS, Ltensors[indexS-1], Ltensors[indexS+1], temp, temp2); //The MPI check occurs in this function
-            addDiagram5E(ikappa, memS, memHeff, denS, Ltensors[indexS-1], Ltensors[indexS+1], temp, temp2); //The MPI check occurs in this function
-            addDiagram5F(ikappa, memS, memHeff, denS, Ltensors[indexS-1], Ltensors[indexS+1], temp, temp2); //The MPI check occurs in this function
+               plan->cut();
+               addDiagram4B1and4B2spin1(ikappa, vecS, vecHeff, denS, Btensors[indexS-1], Ltensors[indexS+1], temp); //The MPI check occurs in this function
+               plan->cut();
+               addDiagram4B3and4B4spin0(ikappa, vecS, vecHeff, denS, Ctensors[indexS-1], Ltensors[indexS+1], temp); //The MPI check occurs in this function
+               plan->cut();
+               addDiagram4B3and4B4spin1(ikappa, vecS, vecHeff, denS, Dtensors[indexS-1], Ltensors[indexS+1], temp); //The MPI check occurs in this function
+               plan->cut();
+               addDiagram4C1and4C2spin0(ikappa, vecS, vecHeff, denS, Atensors[indexS-1], Ltensors[indexS+1], temp); //The MPI check occurs in this function
+               plan->cut();
+               addDiagram4C1and4C2spin1(ikappa, vecS, vecHeff, denS, Btensors[indexS-1], Ltensors[indexS+1], temp); //The MPI check occurs in this function
+               plan->cut();
+               addDiagram4C3and4C4spin0(ikappa, vecS, vecHeff, denS, Ctensors[indexS-1], Ltensors[indexS+1], temp); //The MPI check occurs in this function
+               plan->cut();
+               addDiagram4C3and4C4spin1(ikappa, vecS, vecHeff, denS, Dtensors[indexS-1], Ltensors[indexS+1], temp); //The MPI check occurs in this function
+               plan->cut();
+               addDiagram4E(ikappa, vecS, vecHeff, denS, Ltensors[indexS-1], Ltensors[indexS+1], temp, temp2); //The MPI check occurs in this function
+               plan->cut();
+               addDiagram4H(ikappa, vecS, vecHeff, denS, Ltensors[indexS-1], Ltensors[indexS+1], temp, temp2); //The MPI check occurs in this function
+               plan->cut();
+               addDiagram4K1and4K2spin0(ikappa, vecS, vecHeff, denS, Ltensors[indexS-1], Atensors[indexS+1], temp); //The MPI check occurs in this function
+               plan->cut();
+               addDiagram4L1and4L2spin0(ikappa, vecS, vecHeff, denS, Ltensors[indexS-1], Atensors[indexS+1], temp); //The MPI check occurs in this function
+               plan->cut();
+               addDiagram4K1and4K2spin1(ikappa, vecS, vecHeff, denS, Ltensors[indexS-1], Btensors[indexS+1], temp); //The MPI check occurs in this function
+               plan->cut();
+               addDiagram4L1and4L2spin1(ikappa, vecS, vecHeff, denS, Ltensors[indexS-1], Btensors[indexS+1], temp); //The MPI check occurs in this function
+               plan->cut();
+               addDiagram4K3and4K4spin0(ikappa, vecS, vecHeff, denS, Ltensors[indexS-1], Ctensors[indexS+1], temp); //The MPI check occurs in this function
+               plan->cut();
+               addDiagram4L3and4L4spin0(ikappa, vecS, vecHeff, denS, Ltensors[indexS-1], Ctensors[indexS+1], temp); //The MPI check occurs in this function
+               plan->cut();
+               addDiagram4K3and4K4spin1(ikappa, vecS, vecHeff, denS, Ltensors[indexS-1], Dtensors[indexS+1], temp); //The MPI check occurs in this function
+               plan->cut();
+               addDiagram4L3and4L4spin1(ikappa, vecS, vecHeff, denS, Ltensors[indexS-1], Dtensors[indexS+1], temp); //The MPI check occurs in this function
+               plan->cut();
+            
+               addDiagram5A(ikappa, vecS, vecHeff, denS, Ltensors[indexS-1], Ltensors[indexS+1], temp, temp2); //The MPI check occurs in this function
+            
+               plan->cut();
+               addDiagram5B(ikappa, vecS, vecHeff, denS, Ltensors[indexS-1], Ltensors[indexS+1], temp, temp2); //The MPI check occurs in this function
+               plan->cut();
+               addDiagram5C(ikappa, vecS, vecHeff, denS, Ltensors[indexS-1], Ltensors[indexS+1], temp, temp2); //The MPI check occurs in this function
+               plan->cut();
+               addDiagram5D(ikappa, vecS, vecHeff, denS, Ltensors[indexS-1], Ltensors[indexS+1], temp, temp2); //The MPI check occurs in this function
+               plan->cut();
+               addDiagram5E(ikappa, vecS, vecHeff, denS, Ltensors[indexS-1], Ltensors[indexS+1], temp, temp2); //The MPI check occurs in this function
+               plan->cut();
+               addDiagram5F(ikappa, vecS, vecHeff, denS, Ltensors[indexS-1], Ltensors[indexS+1], temp, temp2); //The MPI check occurs in this function
+               plan->cut();
                   
+            }
+            
+            if (( record ) && ( vec == 0 )){ plan->stop(); }
+         
          }
          
       }
-      
-      delete [] temp;
-      delete [] temp2;
    
    }
+   
+   if ( record ){ plan->finish(); }
+   gettimeofday(&end, NULL);
+   mult_time += (end.tv_sec - start.tv_sec) + 1e-6 * (end.tv_usec - start.tv_usec);
 
 }
 
@@ -261,7 +412,7 @@ void CheMPS2::Heff::fillHeffDiag(double * memHeffDiag, const Sobject * denS, Ten
    for (int ikappaBIS=0; ikappaBIS<denS->gNKappa(); ikappaBIS++){
    
       const int ikappa = denS->gReorder(ikappaBIS);
-      for (int cnt=denS->gKappa2index(ikappa); cnt<denS->gKappa2index(ikappa+1); cnt++){ memHeffDiag[cnt] = 0.0; }
+      for (long long cnt=denS->gKappa2index(ikappa); cnt<denS->gKappa2index(ikappa+1); cnt++){ memHeffDiag[cnt] = 0.0; }
       
       #ifdef CHEMPS2_MPI_COMPILATION
       if ( MPIchemps2::owner_1cd2d3eh() == MPIRANK )
@@ -316,103 +467,219 @@ void CheMPS2::Heff::fillHeffDiag(double * memHeffDiag, const Sobject * denS, Ten
 
 double CheMPS2::Heff::SolveDAVIDSON(Sobject * denS, TensorL *** Ltensors, TensorOperator **** Atensors, TensorOperator **** Btensors, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorS0 **** S0tensors, TensorS1 **** S1tensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorQ *** Qtensors, TensorX ** Xtensors, int nLower, double ** VeffTilde) const{
 
+   double eigenvalue = 0.0;
+   #ifdef CHEMPS2_MPI_COMPILATION
+   if ( distribute( denS ) ){
+      SolveDAVIDSON_distributed(&denS, &eigenvalue, 1, Ltensors, Atensors, Btensors, Ctensors, Dtensors, S0tensors, S1tensors, F0tensors, F1tensors, Qtensors, Xtensors, nLower, VeffTilde);
+   } else if ( MPIchemps2::mpi_rank() == MPI_CHEMPS2_MASTER ){
+      SolveDAVIDSON_main(&denS, &eigenvalue, 1, Ltensors, Atensors, Btensors, Ctensors, Dtensors, S0tensors, S1tensors, F0tensors, F1tensors, Qtensors, Xtensors, nLower, VeffTilde);
+   } else {
+      SolveDAVIDSON_help(&denS, &eigenvalue, 1, Ltensors, Atensors, Btensors, Ctensors, Dtensors, S0tensors, S1tensors, F0tensors, F1tensors, Qtensors, Xtensors, nLower, VeffTilde);
+   }
+   #else
+      SolveDAVIDSON_main(&denS, &eigenvalue, 1, Ltensors, Atensors, Btensors, Ctensors, Dtensors, S0tensors, S1tensors, F0tensors, F1tensors, Qtensors, Xtensors, nLower, VeffTilde);
+   #endif
+   return eigenvalue;
+
+}
+
+void CheMPS2::Heff::SolveDAVIDSON(Sobject ** denS, double * energies, const int num_roots, TensorL *** Ltensors, TensorOperator **** Atensors, TensorOperator **** Btensors, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorS0 **** S0tensors, TensorS1 **** S1tensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorQ *** Qtensors, TensorX ** Xtensors) const{
+
    #ifdef CHEMPS2_MPI_COMPILATION
-   if ( MPIchemps2::mpi_rank() == MPI_CHEMPS2_MASTER ){
-      return SolveDAVIDSON_main(denS, Ltensors, Atensors, Btensors, Ctensors, Dtensors, S0tensors, S1tensors, F0tensors, F1tensors, Qtensors, Xtensors, nLower, VeffTilde);
+   if ( distribute( denS[0] ) ){
+      SolveDAVIDSON_distributed(denS, energies, num_roots, Ltensors, Atensors, Btensors, Ctensors, Dtensors, S0tensors, S1tensors, F0tensors, F1tensors, Qtensors, Xtensors, 0, NULL);
+   } else if ( MPIchemps2::mpi_rank() == MPI_CHEMPS2_MASTER ){
+      SolveDAVIDSON_main(denS, energies, num_roots, Ltensors, Atensors, Btensors, Ctensors, Dtensors, S0tensors, S1tensors, F0tensors, F1tensors, Qtensors, Xtensors, 0, NULL);
    } else {
-      return SolveDAVIDSON_help(denS, Ltensors, Atensors, Btensors, Ctensors, Dtensors, S0tensors, S1tensors, F0tensors, F1tensors, Qtensors, Xtensors, nLower, VeffTilde);
+      SolveDAVIDSON_help(denS, energies, num_roots, Ltensors, Atensors, Btensors, Ctensors, Dtensors, S0tensors, S1tensors, F0tensors, F1tensors, Qtensors, Xtensors, 0, NULL);
    }
    #else
-      return SolveDAVIDSON_main(denS, Ltensors, Atensors, Btensors, Ctensors, Dtensors, S0tensors, S1tensors, F0tensors, F1tensors, Qtensors, Xtensors, nLower, VeffTilde);
+      SolveDAVIDSON_main(denS, energies, num_roots, Ltensors, Atensors, Btensors, Ctensors, Dtensors, S0tensors, S1tensors, F0tensors, F1tensors, Qtensors, Xtensors, 0, NULL);
    #endif
 
 }
 
-double CheMPS2::Heff::SolveDAVIDSON_main(Sobject * denS, TensorL *** Ltensors, TensorOperator **** Atensors, TensorOperator **** Btensors, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorS0 **** S0tensors, TensorS1 **** S1tensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorQ *** Qtensors, TensorX ** Xtensors, int nLower, double ** VeffTilde) const{
+void CheMPS2::Heff::SolveDAVIDSON_main(Sobject ** denS, double * energies, const int num_roots, TensorL *** Ltensors, TensorOperator **** Atensors, TensorOperator **** Btensors, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorS0 **** S0tensors, TensorS1 **** S1tensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorQ *** Qtensors, TensorX ** Xtensors, int nLower, double ** VeffTilde) const{
 
-   int inc1 = 1;
-   int veclength = denS->gKappa2index( denS->gNKappa() );
+   assert(( num_roots == 1 ) || ( nLower == 0 ));
+   const long long veclength = denS[0]->gKappa2index( denS[0]->gNKappa() );
+   const int num_vec_keep = std::max( CheMPS2::DAVIDSON_NUM_VEC_KEEP, num_roots );
 
-   Davidson deBoskabouter( veclength, CheMPS2::DAVIDSON_NUM_VEC,
-                                      CheMPS2::DAVIDSON_NUM_VEC_KEEP,
+   Davidson deBoskabouter( veclength, std::max( CheMPS2::DAVIDSON_NUM_VEC, 4 * num_vec_keep ),
+                                      num_vec_keep,
                                       // CheMPS2::DAVIDSON_DMRG_RTOL,
                                       dvdson_rtol,
-                                      CheMPS2::DAVIDSON_PRECOND_CUTOFF, CheMPS2::HEFF_debugPrint );
+                                      CheMPS2::DAVIDSON_PRECOND_CUTOFF, CheMPS2::HEFF_debugPrint, 'E', num_roots, num_roots );
    double ** whichpointers = new double*[2];
 
    char instruction = deBoskabouter.FetchInstruction( whichpointers );
    assert( instruction == 'A' );
-   denS->prog2symm(); // Convert mem of Sobject to symmetric conventions
-   dcopy_(&veclength, denS->gStorage(), &inc1, whichpointers[0], &inc1); // Starting vector for Davidson is the current state of the Sobject in symmetric conventions
+   for ( int root = 0; root < num_roots; root++ ){
+      denS[root]->prog2symm(); // Convert mem of Sobject to symmetric conventions
+      Special::dcopy64( veclength, denS[root]->gStorage(), whichpointers[0] + veclength * root ); // Starting vectors for Davidson are the current states of the Sobjects in symmetric conventions
+   }
    #ifdef CHEMPS2_MPI_COMPILATION
-      double * workspace = new double[ veclength ];
-      fillHeffDiag(workspace, denS, Ctensors, Dtensors, F0tensors, F1tensors, Xtensors, nLower, VeffTilde);
+      double * workspace = work->get_double(2, veclength * num_roots);
+      fillHeffDiag(workspace, denS[0], Ctensors, Dtensors, F0tensors, F1tensors, Xtensors, nLower, VeffTilde);
       MPIchemps2::reduce_array_double( workspace, whichpointers[1], veclength, MPI_CHEMPS2_MASTER );
    #else
-      fillHeffDiag(whichpointers[1], denS, Ctensors, Dtensors, F0tensors, F1tensors, Xtensors, nLower, VeffTilde);
+      fillHeffDiag(whichpointers[1], denS[0], Ctensors, Dtensors, F0tensors, F1tensors, Xtensors, nLower, VeffTilde);
    #endif
 
    instruction = deBoskabouter.FetchInstruction( whichpointers );
    while ( instruction == 'B' ){
    
+      int num_vectors = deBoskabouter.GetBlockSize(); // The roots request their multiplications together
       #ifdef CHEMPS2_MPI_COMPILATION
       {
          int mpi_instruction = 2;
          MPIchemps2::broadcast_array_int( &mpi_instruction, 1, MPI_CHEMPS2_MASTER );
-         MPIchemps2::broadcast_array_double( whichpointers[0], veclength, MPI_CHEMPS2_MASTER );
-         makeHeff(whichpointers[0], workspace, denS, Ltensors, Atensors, Btensors, Ctensors, Dtensors, S0tensors, S1tensors, F0tensors, F1tensors, Qtensors, Xtensors, nLower, VeffTilde);
-         MPIchemps2::reduce_array_double( workspace, whichpointers[1], veclength, MPI_CHEMPS2_MASTER );
+         MPIchemps2::broadcast_array_int( &num_vectors, 1, MPI_CHEMPS2_MASTER );
+         MPIchemps2::broadcast_array_double( whichpointers[0], veclength * num_vectors, MPI_CHEMPS2_MASTER );
+         makeHeff(whichpointers[0], workspace, num_vectors, denS[0], Ltensors, Atensors, Btensors, Ctensors, Dtensors, S0tensors, S1tensors, F0tensors, F1tensors, Qtensors, Xtensors, nLower, VeffTilde);
+         MPIchemps2::reduce_array_double( workspace, whichpointers[1], veclength * num_vectors, MPI_CHEMPS2_MASTER );
       }
       #else
-         makeHeff(whichpointers[0], whichpointers[1], denS, Ltensors, Atensors, Btensors, Ctensors, Dtensors, S0tensors, S1tensors, F0tensors, F1tensors, Qtensors, Xtensors, nLower, VeffTilde);
+         makeHeff(whichpointers[0], whichpointers[1], num_vectors, denS[0], Ltensors, Atensors, Btensors, Ctensors, Dtensors, S0tensors, S1tensors, F0tensors, F1tensors, Qtensors, Xtensors, nLower, VeffTilde);
       #endif
       instruction = deBoskabouter.FetchInstruction( whichpointers );
    }
 
    assert( instruction == 'C' );
-   dcopy_( &veclength, whichpointers[0], &inc1, denS->gStorage(), &inc1 ); // Copy the solution in symmetric conventions back
-   denS->symm2prog(); // Convert mem of Sobject to program conventions
-   double eigenvalue = whichpointers[1][0];
+   for ( int root = 0; root < num_roots; root++ ){
+      Special::dcopy64( veclength, whichpointers[0] + veclength * root, denS[root]->gStorage() ); // Copy the solution in symmetric conventions back
+      denS[root]->symm2prog(); // Convert mem of Sobject to program conventions
+      energies[root] = whichpointers[1][root];
+   }
+   num_matvec = deBoskabouter.GetNumMultiplications();
    if (CheMPS2::HEFF_debugPrint){ std::cout << "   Stats: nIt(DAVIDSON) = " << deBoskabouter.GetNumMultiplications() << std::endl; }
    delete [] whichpointers;
    #ifdef CHEMPS2_MPI_COMPILATION
-      delete [] workspace;
       int mpi_instruction = 3;
       MPIchemps2::broadcast_array_int( &mpi_instruction, 1, MPI_CHEMPS2_MASTER );
-      MPIchemps2::broadcast_array_double( &eigenvalue, 1, MPI_CHEMPS2_MASTER );
+      MPIchemps2::broadcast_array_double( energies, num_roots, MPI_CHEMPS2_MASTER );
    #endif
-   return eigenvalue;
 
 }
 
 #ifdef CHEMPS2_MPI_COMPILATION
-double CheMPS2::Heff::SolveDAVIDSON_help(Sobject * denS, TensorL *** Ltensors, TensorOperator **** Atensors, TensorOperator **** Btensors, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorS0 **** S0tensors, TensorS1 **** S1tensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorQ *** Qtensors, TensorX ** Xtensors, int nLower, double ** VeffTilde) const{
+void CheMPS2::Heff::SolveDAVIDSON_help(Sobject ** denS, double * energies, const int num_roots, TensorL *** Ltensors, TensorOperator **** Atensors, TensorOperator **** Btensors, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorS0 **** S0tensors, TensorS1 **** S1tensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorQ *** Qtensors, TensorX ** Xtensors, int nLower, double ** VeffTilde) const{
 
-   int veclength = denS->gKappa2index( denS->gNKappa() );
-   double * vecin  = new double[ veclength ];
-   double * vecout = new double[ veclength ];
+   const long long veclength = denS[0]->gKappa2index( denS[0]->gNKappa() );
+   double * vecin  = new double[ veclength * num_roots ];
+   double * vecout = new double[ veclength * num_roots ];
    int mpi_instruction = -1;
+   int num_vectors = 1;
    
-   fillHeffDiag( vecout, denS, Ctensors, Dtensors, F0tensors, F1tensors, Xtensors, nLower, VeffTilde );
+   fillHeffDiag( vecout, denS[0], Ctensors, Dtensors, F0tensors, F1tensors, Xtensors, nLower, VeffTilde );
    MPIchemps2::reduce_array_double( vecout, vecin, veclength, MPI_CHEMPS2_MASTER );
    MPIchemps2::broadcast_array_int( &mpi_instruction, 1, MPI_CHEMPS2_MASTER );
    
    while ( mpi_instruction == 2 ){ // Mat Vec
    
-      MPIchemps2::broadcast_array_double( vecin, veclength, MPI_CHEMPS2_MASTER );
-      makeHeff(vecin, vecout, denS, Ltensors, Atensors, Btensors, Ctensors, Dtensors, S0tensors, S1tensors, F0tensors, F1tensors, Qtensors, Xtensors, nLower, VeffTilde);
-      MPIchemps2::reduce_array_double( vecout, vecin, veclength, MPI_CHEMPS2_MASTER );
+      MPIchemps2::broadcast_array_int( &num_vectors, 1, MPI_CHEMPS2_MASTER );
+      MPIchemps2::broadcast_array_double( vecin, veclength * num_vectors, MPI_CHEMPS2_MASTER );
+      makeHeff(vecin, vecout, num_vectors, denS[0], Ltensors, Atensors, Btensors, Ctensors, Dtensors, S0tensors, S1tensors, F0tensors, F1tensors, Qtensors, Xtensors, nLower, VeffTilde);
+      MPIchemps2::reduce_array_double( vecout, vecin, veclength * num_vectors, MPI_CHEMPS2_MASTER );
       MPIchemps2::broadcast_array_int( &mpi_instruction, 1, MPI_CHEMPS2_MASTER );
    
    }
    
-   assert( mpi_instruction == 3 ); // Receive energy
-   double eigenvalue = 0.0;
-   MPIchemps2::broadcast_array_double( &eigenvalue, 1, MPI_CHEMPS2_MASTER );
+   assert( mpi_instruction == 3 ); // Receive energies
+   MPIchemps2::broadcast_array_double( energies, num_roots, MPI_CHEMPS2_MASTER ); // The eigenvalues are correct on each process, denS not
    delete [] vecin;
    delete [] vecout;
-   
-   return eigenvalue; // The eigenvalue is correct on each process, denS not
+
+}
+
+void CheMPS2::Heff::SolveDAVIDSON_distributed(Sobject ** denS, double * energies, const int num_roots, TensorL *** Ltensors, TensorOperator **** Atensors, TensorOperator **** Btensors, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorS0 **** S0tensors, TensorS1 **** S1tensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorQ *** Qtensors, TensorX ** Xtensors, int nLower, double ** VeffTilde) const{
+
+   assert(( num_roots == 1 ) || ( nLower == 0 ));
+   const bool am_i_master = ( MPIchemps2::mpi_rank() == MPI_CHEMPS2_MASTER );
+   const long long veclength = denS[0]->gKappa2index( denS[0]->gNKappa() );
+   const int num_vec_keep = std::max( CheMPS2::DAVIDSON_NUM_VEC_KEEP, num_roots );
+
+   // Each process only keeps its slice of the Davidson vectors; the effective Hamiltonian needs the full vectors
+   long long * slices = new long long[ MPIchemps2::mpi_size() + 1 ];
+   partition_sectors( denS[0], slices );
+   const long long my_start  = slices[ MPIchemps2::mpi_rank() ];
+   const long long my_length = slices[ MPIchemps2::mpi_rank() + 1 ] - my_start;
+   double * vecin  = new double[ veclength * num_roots ];
+   double * vecout = new double[ veclength * num_roots ];
+
+   Davidson deBoskabouter( my_length, std::max( CheMPS2::DAVIDSON_NUM_VEC, 4 * num_vec_keep ),
+                                      num_vec_keep,
+                                      dvdson_rtol,
+                                      CheMPS2::DAVIDSON_PRECOND_CUTOFF, ( CheMPS2::HEFF_debugPrint && am_i_master ), 'E', num_roots, num_roots, true );
+   double ** whichpointers = new double*[2];
+
+   char instruction = deBoskabouter.FetchInstruction( whichpointers );
+   assert( instruction == 'A' );
+   for ( int root = 0; root < num_roots; root++ ){
+      if ( am_i_master ){
+         denS[root]->prog2symm(); // Convert mem of Sobject to symmetric conventions
+         Special::dcopy64( veclength, denS[root]->gStorage(), vecin + veclength * root );
+      }
+      MPIchemps2::scatter_slices( vecin + veclength * root, whichpointers[0] + my_length * root, slices, MPI_CHEMPS2_MASTER );
+   }
+   fillHeffDiag( vecout, denS[0], Ctensors, Dtensors, F0tensors, F1tensors, Xtensors, nLower, VeffTilde );
+   MPIchemps2::reduce_scatter_slices( vecout, whichpointers[1], slices );
+
+   instruction = deBoskabouter.FetchInstruction( whichpointers );
+   while ( instruction == 'B' ){
+      const int num_vectors = deBoskabouter.GetBlockSize();
+      for ( int vec = 0; vec < num_vectors; vec++ ){
+         Special::dcopy64( my_length, whichpointers[0] + my_length * vec, vecin + veclength * vec + my_start );
+         MPIchemps2::allgather_slices( vecin + veclength * vec, slices );
+      }
+      makeHeff(vecin, vecout, num_vectors, denS[0], Ltensors, Atensors, Btensors, Ctensors, Dtensors, S0tensors, S1tensors, F0tensors, F1tensors, Qtensors, Xtensors, nLower, VeffTilde);
+      for ( int vec = 0; vec < num_vectors; vec++ ){
+         MPIchemps2::reduce_scatter_slices( vecout + veclength * vec, whichpointers[1] + my_length * vec, slices );
+      }
+      instruction = deBoskabouter.FetchInstruction( whichpointers );
+   }
+
+   assert( instruction == 'C' );
+   for ( int root = 0; root < num_roots; root++ ){
+      MPIchemps2::gather_slices( whichpointers[0] + my_length * root, vecin + veclength * root, slices, MPI_CHEMPS2_MASTER );
+      if ( am_i_master ){
+         Special::dcopy64( veclength, vecin + veclength * root, denS[root]->gStorage() ); // Copy the solution in symmetric conventions back
+         denS[root]->symm2prog(); // Convert mem of Sobject to program conventions
+      }
+      energies[root] = whichpointers[1][root]; // The eigenvalues are correct on each process, denS not
+   }
+   num_matvec = deBoskabouter.GetNumMultiplications();
+   if (( CheMPS2::HEFF_debugPrint ) && ( am_i_master )){ std::cout << "   Stats: nIt(DAVIDSON) = " << deBoskabouter.GetNumMultiplications() << std::endl; }
+   delete [] whichpointers;
+   delete [] vecin;
+   delete [] vecout;
+   delete [] slices;
+
+}
+
+bool CheMPS2::Heff::distribute(const Sobject * denS) const{
+
+   const int num_procs = MPIchemps2::mpi_size();
+   return (( num_procs > 1 ) && ( denS->gNKappa() >= num_procs ) && ( denS->gKappa2index( denS->gNKappa() ) >= distribute_size ));
+
+}
+
+void CheMPS2::Heff::partition_sectors(const Sobject * denS, long long * slices){
+
+   const int num_procs = MPIchemps2::mpi_size();
+   const int num_kappa = denS->gNKappa();
+   const long long veclength = denS->gKappa2index( num_kappa );
+   assert( num_kappa >= num_procs );
+
+   int boundary = 0;
+   slices[ 0 ] = 0;
+   for ( int proc = 1; proc < num_procs; proc++ ){
+      const long long target = ( veclength * proc ) / num_procs;
+      boundary++; // Each process has at least one sector
+      while (( boundary < num_kappa - num_procs + proc ) && ( denS->gKappa2index( boundary ) < target )){ boundary++; }
+      slices[ proc ] = denS->gKappa2index( boundary );
+   }
+   slices[ num_procs ] = veclength;
 
 }
 #endif
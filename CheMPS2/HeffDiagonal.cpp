@@ -28,7 +28,7 @@ void CheMPS2::Heff::addDiagonal1A(const int ikappa, double * memHeffDiag, const
    int dimL = denBK->gCurrentDim(denS->gIndex(), denS->gNL(ikappa), denS->gTwoSL(ikappa), denS->gIL(ikappa));
    int dimR = denBK->gCurrentDim(denS->gIndex()+2, denS->gNR(ikappa), denS->gTwoSR(ikappa), denS->gIR(ikappa));
    double * BlockX = Xleft->gStorage( denS->gNL(ikappa), denS->gTwoSL(ikappa), denS->gIL(ikappa), denS->gNL(ikappa), denS->gTwoSL(ikappa), denS->gIL(ikappa) );
-   int ptr = denS->gKappa2index(ikappa);
+   long long ptr = denS->gKappa2index(ikappa);
    
    for (int cnt=0; cnt<dimL; cnt++){
       for (int cnt2=0; cnt2<dimR; cnt2++){
@@ -42,7 +42,7 @@ void CheMPS2::Heff::addDiagonal1B(const int ikappa, double * memHeffDiag, const
    int dimL = denBK->gCurrentDim(denS->gIndex(), denS->gNL(ikappa), denS->gTwoSL(ikappa), denS->gIL(ikappa));
    int dimR = denBK->gCurrentDim(denS->gIndex()+2, denS->gNR(ikappa), denS->gTwoSR(ikappa), denS->gIR(ikappa));
    double * BlockX = Xright->gStorage( denS->gNR(ikappa), denS->gTwoSR(ikappa), denS->gIR(ikappa), denS->gNR(ikappa), denS->gTwoSR(ikappa), denS->gIR(ikappa) );
-   int ptr = denS->gKappa2index(ikappa);
+   long long ptr = denS->gKappa2index(ikappa);
    
    for (int cnt=0; cnt<dimL; cnt++){
       for (int cnt2=0; cnt2<dimR; cnt2++){
@@ -54,7 +54,7 @@ void CheMPS2::Heff::addDiagonal1B(const int ikappa, double * memHeffDiag, const
 
 void CheMPS2::Heff::addDiagonal1C(const int ikappa, double * memHeffDiag, const Sobject * denS, const double Helem_links) const{
    if (denS->gN1(ikappa)==2){
-      int ptr = denS->gKappa2index(ikappa);
+      long long ptr = denS->gKappa2index(ikappa);
       int dim = denS->gKappa2index(ikappa+1) - ptr;
       for (int cnt=0; cnt<dim; cnt++){ memHeffDiag[ptr + cnt] += Helem_links; }
    }
@@ -62,7 +62,7 @@ void CheMPS2::Heff::addDiagonal1C(const int ikappa, double * memHeffDiag, const
 
 void CheMPS2::Heff::addDiagonal1D(const int ikappa, double * memHeffDiag, const Sobject * denS, const double Helem_rechts) const{
    if (denS->gN2(ikappa)==2){
-      int ptr = denS->gKappa2index(ikappa);
+      long long ptr = denS->gKappa2index(ikappa);
       int dim = denS->gKappa2index(ikappa+1) - ptr;
       for (int cnt=0; cnt<dim; cnt++){ memHeffDiag[ptr + cnt] += Helem_rechts; }
    }
@@ -73,7 +73,7 @@ void CheMPS2::Heff::addDiagonal2d3all(const int ikappa, double * memHeffDiag, co
    if ((denS->gN1(ikappa)==2)&&(denS->gN2(ikappa)==2)){ //2d3a
    
       const int theindex = denS->gIndex();
-      const int ptr = denS->gKappa2index(ikappa);
+      const long long ptr = denS->gKappa2index(ikappa);
       const int dim = denS->gKappa2index(ikappa+1) - ptr;
       const double factor = 4 * Prob->gMxElement(theindex,theindex+1,theindex,theindex+1)
                           - 2 * Prob->gMxElement(theindex,theindex+1,theindex+1,theindex);
@@ -85,7 +85,7 @@ void CheMPS2::Heff::addDiagonal2d3all(const int ikappa, double * memHeffDiag, co
    if ((denS->gN1(ikappa)==1)&&(denS->gN2(ikappa)==1)){ //2d3b
    
       const int theindex = denS->gIndex();
-      const int ptr = denS->gKappa2index(ikappa);
+      const long long ptr = denS->gKappa2index(ikappa);
       const int dim = denS->gKappa2index(ikappa+1) - ptr;
       const int fase = (denS->gTwoJ(ikappa) == 2)? -1: 1;
       const double factor = Prob->gMxElement(theindex,theindex+1,theindex,theindex+1)
@@ -98,7 +98,7 @@ void CheMPS2::Heff::addDiagonal2d3all(const int ikappa, double * memHeffDiag, co
    if ((denS->gN1(ikappa)==2)&&(denS->gN2(ikappa)==1)){ //2d3c
    
       const int theindex = denS->gIndex();
-      const int ptr = denS->gKappa2index(ikappa);
+      const long long ptr = denS->gKappa2index(ikappa);
       const int dim = denS->gKappa2index(ikappa+1) - ptr;
       const double factor = 2 * Prob->gMxElement(theindex,theindex+1,theindex,theindex+1)
                               - Prob->gMxElement(theindex,theindex+1,theindex+1,theindex);
@@ -110,7 +110,7 @@ void CheMPS2::Heff::addDiagonal2d3all(const int ikappa, double * memHeffDiag, co
    if ((denS->gN1(ikappa)==1)&&(denS->gN2(ikappa)==2)){ //2d3d
    
       const int theindex = denS->gIndex();
-      const int ptr = denS->gKappa2index(ikappa);
+      const long long ptr = denS->gKappa2index(ikappa);
       const int dim = denS->gKappa2index(ikappa+1) - ptr;
       const double factor = 2 * Prob->gMxElement(theindex,theindex+1,theindex,theindex+1)
                               - Prob->gMxElement(theindex,theindex+1,theindex+1,theindex);
@@ -128,7 +128,7 @@ void CheMPS2::Heff::addDiagonal2b3spin0(const int ikappa, double * memHeffDiag,
    if (N1!=0){
 
       int theindex = denS->gIndex();
-      int ptr = denS->gKappa2index(ikappa);
+      long long ptr = denS->gKappa2index(ikappa);
       
       double sqrt0p5 = sqrt(0.5);
       
@@ -157,7 +157,7 @@ void CheMPS2::Heff::addDiagonal2c3spin0(const int ikappa, double * memHeffDiag,
    if (N2!=0){
 
       int theindex = denS->gIndex();
-      int ptr = denS->gKappa2index(ikappa);
+      long long ptr = denS->gKappa2index(ikappa);
       
       double sqrt0p5 = sqrt(0.5);
       
@@ -186,7 +186,7 @@ void CheMPS2::Heff::addDiagonal2e3spin0(const int ikappa, double * memHeffDiag,
    if (N1!=0){
 
       int theindex = denS->gIndex();
-      int ptr = denS->gKappa2index(ikappa);
+      long long ptr = denS->gKappa2index(ikappa);
       
       double sqrt0p5 = sqrt(0.5);
       
@@ -215,7 +215,7 @@ void CheMPS2::Heff::addDiagonal2f3spin0(const int ikappa, double * memHeffDiag,
    if (N2!=0){
 
       int theindex = denS->gIndex();
-      int ptr = denS->gKappa2index(ikappa);
+      long long ptr = denS->gKappa2index(ikappa);
       
       double sqrt0p5 = sqrt(0.5);
       
@@ -244,7 +244,7 @@ void CheMPS2::Heff::addDiagonal2b3spin1(const int ikappa, double * memHeffDiag,
    if (N1==1){
 
       int theindex = denS->gIndex();
-      int ptr = denS->gKappa2index(ikappa);
+      long long ptr = denS->gKappa2index(ikappa);
       
       int NL = denS->gNL(ikappa);
       int TwoSL = denS->gTwoSL(ikappa);
@@ -279,7 +279,7 @@ void CheMPS2::Heff::addDiagonal2c3spin1(const int ikappa, double * memHeffDiag,
    if (N2==1){
 
       int theindex = denS->gIndex();
-      int ptr = denS->gKappa2index(ikappa);
+      long long ptr = denS->gKappa2index(ikappa);
       
       int NL = denS->gNL(ikappa);
       int TwoSL = denS->gTwoSL(ikappa);
@@ -314,7 +314,7 @@ void CheMPS2::Heff::addDiagonal2e3spin1(const int ikappa, double * memHeffDiag,
    if (N1==1){
 
       int theindex = denS->gIndex();
-      int ptr = denS->gKappa2index(ikappa);
+      long long ptr = denS->gKappa2index(ikappa);
       
       int NL = denS->gNL(ikappa);
       int TwoSL = denS->gTwoSL(ikappa);
@@ -349,7 +349,7 @@ void CheMPS2::Heff::addDiagonal2f3spin1(const int ikappa, double * memHeffDiag,
    if (N2==1){
 
       int theindex = denS->gIndex();
-      int ptr = denS->gKappa2index(ikappa);
+      long long ptr = denS->gKappa2index(ikappa);
       
       int NL = denS->gNL(ikappa);
       int TwoSL = denS->gTwoSL(ikappa);
@@ -392,7 +392,7 @@ void CheMPS2::Heff::addDiagonal2a3spin0(const int ikappa, double * memHeffDiag,
    int IR = denS->gIR(ikappa);
    
    int theindex = denS->gIndex();
-   int ptr = denS->gKappa2index(ikappa);
+   long long ptr = denS->gKappa2index(ikappa);
    
    int dimL = denBK->gCurrentDim(theindex  ,NL,TwoSL,IL);
    int dimR = denBK->gCurrentDim(theindex+2,NR,TwoSR,IR);
@@ -514,7 +514,7 @@ void CheMPS2::Heff::addDiagonal2a3spin1(const int ikappa, double * memHeffDiag,
    const double alpha = fase * sqrt((TwoSR + 1)*(TwoSL + 1.0)) * Wigner::wigner6j(TwoSL,TwoSR,TwoJ,TwoSR,TwoSL,2);
    
    int theindex = denS->gIndex();
-   int ptr = denS->gKappa2index(ikappa);
+   long long ptr = denS->gKappa2index(ikappa);
    
    int dimL = denBK->gCurrentDim(theindex  ,NL,TwoSL,IL);
    int dimR = denBK->gCurrentDim(theindex+2,NR,TwoSR,IR);
@@ -620,7 +620,7 @@ void CheMPS2::Heff::addDiagonal2a3spin1(const int ikappa, double * memHeffDiag,
 
 void CheMPS2::Heff::addDiagonalExcitations(const int ikappa, double * memHeffDiag, const Sobject * denS, int nLower, double ** VeffTilde) const{
 
-   const int loc = denS->gKappa2index(ikappa);
+   const long long loc = denS->gKappa2index(ikappa);
    const int dim = denS->gKappa2index(ikappa+1) - loc;
    #ifdef CHEMPS2_MPI_COMPILATION
    const int MPIRANK = MPIchemps2::mpi_rank();
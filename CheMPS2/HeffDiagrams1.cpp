@@ -22,6 +22,7 @@
 #include "Heff.h"
 #include "Lapack.h"
 #include "MPIchemps2.h"
+#include "Special.h"
 
 void CheMPS2::Heff::addDiagram1A(const int ikappa, double * memS, double * memHeff, const Sobject * denS, TensorX * Xleft) const{
    int dimL = denBK->gCurrentDim(denS->gIndex(), denS->gNL(ikappa), denS->gTwoSL(ikappa), denS->gIL(ikappa));
@@ -30,7 +31,7 @@ void CheMPS2::Heff::addDiagram1A(const int ikappa, double * memS, double * memHe
    
    double one = 1.0;
    char notr = 'N';
-   dgemm_(&notr,&notr,&dimL,&dimR,&dimL,&one,BlockX,&dimL,memS+denS->gKappa2index(ikappa),&dimL,&one,memHeff+denS->gKappa2index(ikappa),&dimL);
+   planDgemm(&notr,&notr,&dimL,&dimR,&dimL,&one,BlockX,&dimL,memS+denS->gKappa2index(ikappa),&dimL,&one,memHeff+denS->gKappa2index(ikappa),&dimL);
 }
 
 void CheMPS2::Heff::addDiagram1B(const int ikappa, double * memS, double * memHeff, const Sobject * denS, TensorX * Xright) const{
@@ -41,31 +42,31 @@ void CheMPS2::Heff::addDiagram1B(const int ikappa, double * memS, double * memHe
    double one = 1.0;
    char notr = 'N';
    char trans = 'T';
-   dgemm_(&notr,&trans,&dimL,&dimR,&dimR,&one,memS+denS->gKappa2index(ikappa),&dimL,BlockX,&dimR,&one,memHeff+denS->gKappa2index(ikappa),&dimL);
+   planDgemm(&notr,&trans,&dimL,&dimR,&dimR,&one,memS+denS->gKappa2index(ikappa),&dimL,BlockX,&dimR,&one,memHeff+denS->gKappa2index(ikappa),&dimL);
 }
 
 void CheMPS2::Heff::addDiagram1C(const int ikappa, double * memS, double * memHeff, const Sobject * denS, double Helem_links) const{
    if (denS->gN1(ikappa)==2){
       int inc = 1;
-      int ptr = denS->gKappa2index(ikappa);
+      long long ptr = denS->gKappa2index(ikappa);
       int dim = denS->gKappa2index(ikappa+1) - ptr;
-      daxpy_(&dim,&Helem_links,memS+ptr,&inc,memHeff+ptr,&inc);
+      planDaxpy(&dim,&Helem_links,memS+ptr,&inc,memHeff+ptr,&inc);
    }
 }
 
 void CheMPS2::Heff::addDiagram1D(const int ikappa, double * memS, double * memHeff, const Sobject * denS, double Helem_rechts) const{
    if (denS->gN2(ikappa)==2){
       int inc = 1;
-      int ptr = denS->gKappa2index(ikappa);
+      long long ptr = denS->gKappa2index(ikappa);
       int dim = denS->gKappa2index(ikappa+1) - ptr;
-      daxpy_(&dim,&Helem_rechts,memS+ptr,&inc,memHeff+ptr,&inc);
+      planDaxpy(&dim,&Helem_rechts,memS+ptr,&inc,memHeff+ptr,&inc);
    }
 }
 
 void CheMPS2::Heff::addDiagramExcitations(const int ikappa, double * memS, double * memHeff, const Sobject * denS, int nLower, double ** VeffTilde) const{
 
-   int dimTotal = denS->gKappa2index(denS->gNKappa());
-   int ptr = denS->gKappa2index(ikappa);
+   const long long dimTotal = denS->gKappa2index(denS->gNKappa());
+   long long ptr = denS->gKappa2index(ikappa);
    int dimBlock = denS->gKappa2index(ikappa+1) - ptr;
    int inc = 1;
    #ifdef CHEMPS2_MPI_COMPILATION
@@ -77,7 +78,7 @@ void CheMPS2::Heff::addDiagramExcitations(const int ikappa, double * memS, doubl
       if ( MPIchemps2::owner_specific_excitation( Prob->gL(), state ) == MPIRANK )
       #endif
       {
-         double alpha = ddot_(&dimTotal, memS, &inc, VeffTilde[state], &inc);
+         double alpha = Special::ddot64(dimTotal, memS, VeffTilde[state]);
          daxpy_(&dimBlock,&alpha,VeffTilde[state]+ptr,&inc,memHeff+ptr,&inc);
       }
    }
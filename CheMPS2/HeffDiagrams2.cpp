@@ -75,11 +75,11 @@ void CheMPS2::Heff::addDiagram2a1spin0(const int ikappa, double * memS, double *
                   double alpha = 1.0;
                   double beta = 0.0;
                   
-                  dgemm_(&trans,&notrans,&dimL,&dimRdown,&dimLdown,&alpha,BlockS0,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
+                  planDgemm(&trans,&notrans,&dimL,&dimRdown,&dimLdown,&alpha,BlockS0,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
                   
                   beta = 1.0;
                   
-                  dgemm_(&notrans,&notrans,&dimL,&dimR,&dimRdown,&alpha,workspace,&dimL,BlockA,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                  planDgemm(&notrans,&notrans,&dimL,&dimR,&dimRdown,&alpha,workspace,&dimL,BlockA,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
                   
                }
             }
@@ -112,11 +112,11 @@ void CheMPS2::Heff::addDiagram2a1spin0(const int ikappa, double * memS, double *
                   double alpha = 1.0;
                   double beta = 0.0;
                   
-                  dgemm_(&trans,&notrans,&dimL,&dimRdown,&dimLdown,&alpha,BlockA,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
+                  planDgemm(&trans,&notrans,&dimL,&dimRdown,&dimLdown,&alpha,BlockA,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
                   
                   beta = 1.0;
                   
-                  dgemm_(&notrans,&notrans,&dimL,&dimR,&dimRdown,&alpha,workspace,&dimL,BlockS0,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                  planDgemm(&notrans,&notrans,&dimL,&dimR,&dimRdown,&alpha,workspace,&dimL,BlockS0,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
                   
                }
             }
@@ -176,11 +176,11 @@ void CheMPS2::Heff::addDiagram2a2spin0(const int ikappa, double * memS, double *
                   double alpha = 1.0;
                   double beta = 0.0;
                   
-                  dgemm_(&notrans,&notrans,&dimL,&dimRdown,&dimLdown,&alpha,BlockS0,&dimL,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
+                  planDgemm(&notrans,&notrans,&dimL,&dimRdown,&dimLdown,&alpha,BlockS0,&dimL,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
                   
                   beta = 1.0;
                   
-                  dgemm_(&notrans,&trans,&dimL,&dimR,&dimRdown,&alpha,workspace,&dimL,BlockA,&dimR,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                  planDgemm(&notrans,&trans,&dimL,&dimR,&dimRdown,&alpha,workspace,&dimL,BlockA,&dimR,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
                   
                }
             }
@@ -213,11 +213,11 @@ void CheMPS2::Heff::addDiagram2a2spin0(const int ikappa, double * memS, double *
                   double alpha = 1.0;
                   double beta = 0.0;
                   
-                  dgemm_(&notrans,&notrans,&dimL,&dimRdown,&dimLdown,&alpha,BlockA,&dimL,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
+                  planDgemm(&notrans,&notrans,&dimL,&dimRdown,&dimLdown,&alpha,BlockA,&dimL,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
                   
                   beta = 1.0;
                   
-                  dgemm_(&notrans,&trans,&dimL,&dimR,&dimRdown,&alpha,workspace,&dimL,BlockS0,&dimR,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                  planDgemm(&notrans,&trans,&dimL,&dimR,&dimRdown,&alpha,workspace,&dimL,BlockS0,&dimR,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
                   
                }
             }
@@ -285,11 +285,11 @@ void CheMPS2::Heff::addDiagram2a1spin1(const int ikappa, double * memS, double *
                            double alpha = thefactor;
                            double beta = 0.0;
                   
-                           dgemm_(&trans,&notrans,&dimL,&dimRdown,&dimLdown,&alpha,BlockS1,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
+                           planDgemm(&trans,&notrans,&dimL,&dimRdown,&dimLdown,&alpha,BlockS1,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
                   
                            alpha = beta = 1.0;
                   
-                           dgemm_(&notrans,&notrans,&dimL,&dimR,&dimRdown,&alpha,workspace,&dimL,BlockB,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                           planDgemm(&notrans,&notrans,&dimL,&dimR,&dimRdown,&alpha,workspace,&dimL,BlockB,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
                   
                         }
                      }
@@ -333,11 +333,11 @@ void CheMPS2::Heff::addDiagram2a1spin1(const int ikappa, double * memS, double *
                            double alpha = thefactor;
                            double beta = 0.0;
                         
-                           dgemm_(&trans,&notrans,&dimL,&dimRdown,&dimLdown,&alpha,BlockB,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
+                           planDgemm(&trans,&notrans,&dimL,&dimRdown,&dimLdown,&alpha,BlockB,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
                         
                            alpha = beta = 1.0;
                         
-                           dgemm_(&notrans,&notrans,&dimL,&dimR,&dimRdown,&alpha,workspace,&dimL,BlockS1,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                           planDgemm(&notrans,&notrans,&dimL,&dimR,&dimRdown,&alpha,workspace,&dimL,BlockS1,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
                   
                         }
                      }
@@ -408,11 +408,11 @@ void CheMPS2::Heff::addDiagram2a2spin1(const int ikappa, double * memS, double *
                            double alpha = thefactor;
                            double beta = 0.0;
                   
-                           dgemm_(&notr,&notr,&dimL,&dimRdown,&dimLdown,&alpha,BlockS1,&dimL,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
+                           planDgemm(&notr,&notr,&dimL,&dimRdown,&dimLdown,&alpha,BlockS1,&dimL,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
                   
                            alpha = beta = 1.0;
                   
-                           dgemm_(&notr,&trans,&dimL,&dimR,&dimRdown,&alpha,workspace,&dimL,BlockB,&dimR,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                           planDgemm(&notr,&trans,&dimL,&dimR,&dimRdown,&alpha,workspace,&dimL,BlockB,&dimR,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
                   
                         }
                      }
@@ -456,11 +456,11 @@ void CheMPS2::Heff::addDiagram2a2spin1(const int ikappa, double * memS, double *
                            double alpha = thefactor;
                            double beta = 0.0;
                   
-                           dgemm_(&notrans,&notrans,&dimL,&dimRdown,&dimLdown,&alpha,BlockB,&dimL,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
+                           planDgemm(&notrans,&notrans,&dimL,&dimRdown,&dimLdown,&alpha,BlockB,&dimL,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
                   
                            alpha = beta = 1.0;
                   
-                           dgemm_(&notrans,&trans,&dimL,&dimR,&dimRdown,&alpha,workspace,&dimL,BlockS1,&dimR,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                           planDgemm(&notrans,&trans,&dimL,&dimR,&dimRdown,&alpha,workspace,&dimL,BlockS1,&dimR,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
                     
                         }
                      }
@@ -524,11 +524,11 @@ void CheMPS2::Heff::addDiagram2a3spin0(const int ikappa, double * memS, double *
                   double alpha = 1.0;
                   double beta = 0.0;
                   
-                  dgemm_(&notrans,&notrans,&dimL,&dimRdown,&dimLdown,&alpha,BlockF0,&dimL,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
+                  planDgemm(&notrans,&notrans,&dimL,&dimRdown,&dimLdown,&alpha,BlockF0,&dimL,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
                   
                   beta = 1.0;
                   
-                  dgemm_(&notrans,&trans,&dimL,&dimR,&dimRdown,&alpha,workspace,&dimL,ptr,&dimR,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                  planDgemm(&notrans,&trans,&dimL,&dimR,&dimRdown,&alpha,workspace,&dimL,ptr,&dimR,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
                   
                }
             }
@@ -560,11 +560,11 @@ void CheMPS2::Heff::addDiagram2a3spin0(const int ikappa, double * memS, double *
                   double alpha = 1.0;
                   double beta = 0.0;
                   
-                  dgemm_(&trans,&notrans,&dimL,&dimRdown,&dimLdown,&alpha,BlockF0,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
+                  planDgemm(&trans,&notrans,&dimL,&dimRdown,&dimLdown,&alpha,BlockF0,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
                   
                   beta = 1.0;
                   
-                  dgemm_(&notrans,&notrans,&dimL,&dimR,&dimRdown,&alpha,workspace,&dimL,ptr,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                  planDgemm(&notrans,&notrans,&dimL,&dimR,&dimRdown,&alpha,workspace,&dimL,ptr,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
                   
                }
             }
@@ -598,11 +598,11 @@ void CheMPS2::Heff::addDiagram2a3spin0(const int ikappa, double * memS, double *
                   double alpha = 1.0;
                   double beta = 0.0;
                   
-                  dgemm_(&notrans,&notrans,&dimL,&dimRdown,&dimLdown,&alpha,ptr,&dimL,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
+                  planDgemm(&notrans,&notrans,&dimL,&dimRdown,&dimLdown,&alpha,ptr,&dimL,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
                   
                   beta = 1.0;
                   
-                  dgemm_(&notrans,&trans,&dimL,&dimR,&dimRdown,&alpha,workspace,&dimL,BlockF0,&dimR,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                  planDgemm(&notrans,&trans,&dimL,&dimR,&dimRdown,&alpha,workspace,&dimL,BlockF0,&dimR,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
                   
                }
             }
@@ -634,11 +634,11 @@ void CheMPS2::Heff::addDiagram2a3spin0(const int ikappa, double * memS, double *
                   double alpha = 1.0;
                   double beta = 0.0;
                   
-                  dgemm_(&trans,&notrans,&dimL,&dimRdown,&dimLdown,&alpha,ptr,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
+                  planDgemm(&trans,&notrans,&dimL,&dimRdown,&dimLdown,&alpha,ptr,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
                   
                   beta = 1.0;
                   
-                  dgemm_(&notrans,&notrans,&dimL,&dimR,&dimRdown,&alpha,workspace,&dimL,BlockF0,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                  planDgemm(&notrans,&notrans,&dimL,&dimR,&dimRdown,&alpha,workspace,&dimL,BlockF0,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
                   
                }
             }
@@ -706,11 +706,11 @@ void CheMPS2::Heff::addDiagram2a3spin1(const int ikappa, double * memS, double *
                            char notr = 'N';
                            double beta = 0.0;
                   
-                           dgemm_(&notr,&notr,&dimL,&dimRdown,&dimLdown,&prefactor,BlockF1,&dimL,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
+                           planDgemm(&notr,&notr,&dimL,&dimRdown,&dimLdown,&prefactor,BlockF1,&dimL,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
                   
                            beta = 1.0;
                   
-                           dgemm_(&notr,&trans,&dimL,&dimR,&dimRdown,&beta,workspace,&dimL,ptr,&dimR,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                           planDgemm(&notr,&trans,&dimL,&dimR,&dimRdown,&beta,workspace,&dimL,ptr,&dimR,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
                   
                         }
                      }
@@ -744,11 +744,11 @@ void CheMPS2::Heff::addDiagram2a3spin1(const int ikappa, double * memS, double *
                            char notr = 'N';
                            double beta = 0.0;
                            
-                           dgemm_(&trans,&notr,&dimL,&dimRdown,&dimLdown,&prefactor,BlockF1,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
+                           planDgemm(&trans,&notr,&dimL,&dimRdown,&dimLdown,&prefactor,BlockF1,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
                   
                            beta = 1.0;
                   
-                           dgemm_(&notr,&notr,&dimL,&dimR,&dimRdown,&beta,workspace,&dimL,ptr,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                           planDgemm(&notr,&notr,&dimL,&dimR,&dimRdown,&beta,workspace,&dimL,ptr,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
                   
                         }
                      }
@@ -792,11 +792,11 @@ void CheMPS2::Heff::addDiagram2a3spin1(const int ikappa, double * memS, double *
                            char notr = 'N';
                            double beta = 0.0;
                   
-                           dgemm_(&notr,&notr,&dimL,&dimRdown,&dimLdown,&prefactor,ptr,&dimL,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
+                           planDgemm(&notr,&notr,&dimL,&dimRdown,&dimLdown,&prefactor,ptr,&dimL,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
                   
                            beta = 1.0;
                   
-                           dgemm_(&notr,&trans,&dimL,&dimR,&dimRdown,&beta,workspace,&dimL,BlockF1,&dimR,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                           planDgemm(&notr,&trans,&dimL,&dimR,&dimRdown,&beta,workspace,&dimL,BlockF1,&dimR,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
                   
                         }
                      }
@@ -830,11 +830,11 @@ void CheMPS2::Heff::addDiagram2a3spin1(const int ikappa, double * memS, double *
                            char notr = 'N';
                            double beta = 0.0;
                   
-                           dgemm_(&trans,&notr,&dimL,&dimRdown,&dimLdown,&prefactor,ptr,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
+                           planDgemm(&trans,&notr,&dimL,&dimRdown,&dimLdown,&prefactor,ptr,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,workspace,&dimL);
                   
                            beta = 1.0;
                   
-                           dgemm_(&notr,&notr,&dimL,&dimR,&dimRdown,&beta,workspace,&dimL,BlockF1,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                           planDgemm(&notr,&notr,&dimL,&dimR,&dimRdown,&beta,workspace,&dimL,BlockF1,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
                   
                         }
                      }
@@ -879,7 +879,7 @@ void CheMPS2::Heff::addDiagram2b1and2b2(const int ikappa, double * memS, double
             double alpha = sqrt(2.0);
             double beta = 1.0;
             
-            dgemm_(&trans,&notrans,&dimLup,&dimR,&dimLdown,&alpha,BlockA,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+            planDgemm(&trans,&notrans,&dimLup,&dimR,&dimLdown,&alpha,BlockA,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
          
          }
       }
@@ -912,7 +912,7 @@ void CheMPS2::Heff::addDiagram2b1and2b2(const int ikappa, double * memS, double
             double alpha = sqrt(2.0);
             double beta = 1.0;
             
-            dgemm_(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&alpha,BlockA,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+            planDgemm(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&alpha,BlockA,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
          
          }
       }
@@ -952,7 +952,7 @@ void CheMPS2::Heff::addDiagram2c1and2c2(const int ikappa, double * memS, double
             double alpha = sqrt(2.0);
             double beta = 1.0;
             
-            dgemm_(&trans,&notrans,&dimLup,&dimR,&dimLdown,&alpha,BlockA,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+            planDgemm(&trans,&notrans,&dimLup,&dimR,&dimLdown,&alpha,BlockA,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
          
          }
       }
@@ -985,7 +985,7 @@ void CheMPS2::Heff::addDiagram2c1and2c2(const int ikappa, double * memS, double
             double alpha = sqrt(2.0);
             double beta = 1.0;
             
-            dgemm_(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&alpha,BlockA,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+            planDgemm(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&alpha,BlockA,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
          
          }
       }
@@ -1008,7 +1008,7 @@ void CheMPS2::Heff::addDiagram2dall(const int ikappa, double * memS, double * me
       
       if (memSkappa!=-1){
          double factor = Prob->gMxElement(theindex, theindex, theindex+1, theindex+1);
-         daxpy_(&size,&factor,memS+denS->gKappa2index(memSkappa),&inc,memHeff+denS->gKappa2index(ikappa),&inc);
+         planDaxpy(&size,&factor,memS+denS->gKappa2index(memSkappa),&inc,memHeff+denS->gKappa2index(ikappa),&inc);
       }
    }
    
@@ -1018,7 +1018,7 @@ void CheMPS2::Heff::addDiagram2dall(const int ikappa, double * memS, double * me
       
       if (memSkappa!=-1){
          double factor = Prob->gMxElement(theindex, theindex, theindex+1, theindex+1);
-         daxpy_(&size,&factor,memS+denS->gKappa2index(memSkappa),&inc,memHeff+denS->gKappa2index(ikappa),&inc);
+         planDaxpy(&size,&factor,memS+denS->gKappa2index(memSkappa),&inc,memHeff+denS->gKappa2index(ikappa),&inc);
       }
    }
    
@@ -1026,7 +1026,7 @@ void CheMPS2::Heff::addDiagram2dall(const int ikappa, double * memS, double * me
    
       double factor = 4 * Prob->gMxElement(theindex, theindex+1, theindex, theindex+1)
                     - 2 * Prob->gMxElement(theindex, theindex+1, theindex+1, theindex);
-      daxpy_(&size,&factor,memS+denS->gKappa2index(ikappa),&inc,memHeff+denS->gKappa2index(ikappa),&inc);
+      planDaxpy(&size,&factor,memS+denS->gKappa2index(ikappa),&inc,memHeff+denS->gKappa2index(ikappa),&inc);
    
    }
    
@@ -1035,7 +1035,7 @@ void CheMPS2::Heff::addDiagram2dall(const int ikappa, double * memS, double * me
       int fase = (denS->gTwoJ(ikappa) == 0)? 1: -1;
       double factor = Prob->gMxElement(theindex, theindex+1, theindex, theindex+1)
              + fase * Prob->gMxElement(theindex, theindex+1, theindex+1, theindex);
-      daxpy_(&size,&factor,memS+denS->gKappa2index(ikappa),&inc,memHeff+denS->gKappa2index(ikappa),&inc);
+      planDaxpy(&size,&factor,memS+denS->gKappa2index(ikappa),&inc,memHeff+denS->gKappa2index(ikappa),&inc);
    
    }
    
@@ -1043,7 +1043,7 @@ void CheMPS2::Heff::addDiagram2dall(const int ikappa, double * memS, double * me
    
       double factor = 2 * Prob->gMxElement(theindex, theindex+1, theindex, theindex+1)
                         - Prob->gMxElement(theindex, theindex+1, theindex+1, theindex);
-      daxpy_(&size,&factor,memS+denS->gKappa2index(ikappa),&inc,memHeff+denS->gKappa2index(ikappa),&inc);
+      planDaxpy(&size,&factor,memS+denS->gKappa2index(ikappa),&inc,memHeff+denS->gKappa2index(ikappa),&inc);
    
    }
    
@@ -1051,7 +1051,7 @@ void CheMPS2::Heff::addDiagram2dall(const int ikappa, double * memS, double * me
    
       double factor = 2 * Prob->gMxElement(theindex, theindex+1, theindex, theindex+1)
                         - Prob->gMxElement(theindex, theindex+1, theindex+1, theindex);
-      daxpy_(&size,&factor,memS+denS->gKappa2index(ikappa),&inc,memHeff+denS->gKappa2index(ikappa),&inc);
+      planDaxpy(&size,&factor,memS+denS->gKappa2index(ikappa),&inc,memHeff+denS->gKappa2index(ikappa),&inc);
    
    }
    
@@ -1084,7 +1084,7 @@ void CheMPS2::Heff::addDiagram2e1and2e2(const int ikappa, double * memS, double
          double alpha = sqrt(2.0);
          double beta = 1.0;
             
-         dgemm_(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,BlockA,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+         planDgemm(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,BlockA,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
 
       }
    }
@@ -1113,7 +1113,7 @@ void CheMPS2::Heff::addDiagram2e1and2e2(const int ikappa, double * memS, double
          double alpha = sqrt(2.0);
          double beta = 1.0;
             
-         dgemm_(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,BlockA,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+         planDgemm(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,BlockA,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
 
       }
    }
@@ -1147,7 +1147,7 @@ void CheMPS2::Heff::addDiagram2f1and2f2(const int ikappa, double * memS, double
          double alpha = sqrt(2.0);
          double beta = 1.0;
             
-         dgemm_(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,BlockA,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+         planDgemm(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,BlockA,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
 
       }
    }
@@ -1176,7 +1176,7 @@ void CheMPS2::Heff::addDiagram2f1and2f2(const int ikappa, double * memS, double
          double alpha = sqrt(2.0);
          double beta = 1.0;
             
-         dgemm_(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,BlockA,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+         planDgemm(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,BlockA,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
 
       }
    }
@@ -1205,7 +1205,7 @@ void CheMPS2::Heff::addDiagram2b3spin0(const int ikappa, double * memS, double *
       double alpha = ((N1==2)?1.0:0.5)*sqrt(2.0);
       double beta = 1.0;
             
-      dgemm_(&trans,&notrans,&dimL,&dimR,&dimL,&alpha,Cblock,&dimL,memS+denS->gKappa2index(ikappa),&dimL,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+      planDgemm(&trans,&notrans,&dimL,&dimR,&dimL,&alpha,Cblock,&dimL,memS+denS->gKappa2index(ikappa),&dimL,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
 
    }
    
@@ -1233,7 +1233,7 @@ void CheMPS2::Heff::addDiagram2c3spin0(const int ikappa, double * memS, double *
       double alpha = ((N2==2)?1.0:0.5)*sqrt(2.0);
       double beta = 1.0;
             
-      dgemm_(&trans,&notrans,&dimL,&dimR,&dimL,&alpha,Cblock,&dimL,memS+denS->gKappa2index(ikappa),&dimL,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+      planDgemm(&trans,&notrans,&dimL,&dimR,&dimL,&alpha,Cblock,&dimL,memS+denS->gKappa2index(ikappa),&dimL,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
 
    }
    
@@ -1260,7 +1260,7 @@ void CheMPS2::Heff::addDiagram2e3spin0(const int ikappa, double * memS, double *
       double alpha = ((N1==2)?1.0:0.5)*sqrt(2.0);
       double beta = 1.0;
             
-      dgemm_(&notrans,&notrans,&dimL,&dimR,&dimR,&alpha,memS+denS->gKappa2index(ikappa),&dimL,Cblock,&dimR,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+      planDgemm(&notrans,&notrans,&dimL,&dimR,&dimR,&alpha,memS+denS->gKappa2index(ikappa),&dimL,Cblock,&dimR,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
 
    }
    
@@ -1287,7 +1287,7 @@ void CheMPS2::Heff::addDiagram2f3spin0(const int ikappa, double * memS, double *
       double alpha = ((N2==2)?1.0:0.5)*sqrt(2.0);
       double beta = 1.0;
             
-      dgemm_(&notrans,&notrans,&dimL,&dimR,&dimR,&alpha,memS+denS->gKappa2index(ikappa),&dimL,Cblock,&dimR,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+      planDgemm(&notrans,&notrans,&dimL,&dimR,&dimR,&alpha,memS+denS->gKappa2index(ikappa),&dimL,Cblock,&dimR,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
 
    }
    
@@ -1336,7 +1336,7 @@ void CheMPS2::Heff::addDiagram2b3spin1(const int ikappa, double * memS, double *
                      char notra = 'N';
                      double beta = 1.0;
                
-                     dgemm_(&trans,&notra,&dimLup,&dimR,&dimLdown,&alpha,Dblock,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&trans,&notra,&dimLup,&dimR,&dimLdown,&alpha,Dblock,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
             
                   }
                }
@@ -1390,7 +1390,7 @@ void CheMPS2::Heff::addDiagram2c3spin1(const int ikappa, double * memS, double *
                      char notra = 'N';
                      double beta = 1.0;
                
-                     dgemm_(&trans,&notra,&dimLup,&dimR,&dimLdown,&alpha,Dblock,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&trans,&notra,&dimLup,&dimR,&dimLdown,&alpha,Dblock,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                      
                   }
                }
@@ -1443,7 +1443,7 @@ void CheMPS2::Heff::addDiagram2e3spin1(const int ikappa, double * memS, double *
                      char notr = 'N';
                      double beta = 1.0;
                
-                     dgemm_(&notr,&notr,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Dblock,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                     planDgemm(&notr,&notr,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Dblock,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
                      
                   }
                }
@@ -1496,7 +1496,7 @@ void CheMPS2::Heff::addDiagram2f3spin1(const int ikappa, double * memS, double *
                      char notr = 'N';
                      double beta = 1.0;
                
-                     dgemm_(&notr,&notr,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Dblock,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                     planDgemm(&notr,&notr,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Dblock,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
                      
                   }
                }
@@ -64,17 +64,17 @@ void CheMPS2::Heff::addDiagram3Aand3D(const int ikappa, double * memS, double *
                      double * BlockQ = Qleft->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
                      int inc = 1;
                      int size = dimLup * dimLdown;
-                     dcopy_(&size, BlockQ, &inc, temp, &inc);
+                     planDcopy(&size, BlockQ, &inc, temp, &inc);
                   
                      for (int l_index=0; l_index<theindex; l_index++){
                         if (denBK->gIrrep(l_index) == denBK->gIrrep(theindex)){
                            double alpha = Prob->gMxElement(l_index,theindex,theindex,theindex);
                            double * BlockL = Lleft[theindex-1-l_index]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
-                           daxpy_(&size, &alpha, BlockL, &inc, temp, &inc);
+                           planDaxpy(&size, &alpha, BlockL, &inc, temp, &inc);
                         }
                      }
                   
-                     dgemm_(&notr,&notr,&dimLup,&dimR,&dimLdown,&factor,temp,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&notr,&notr,&dimLup,&dimR,&dimLdown,&factor,temp,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   }
                }
             }
@@ -93,7 +93,7 @@ void CheMPS2::Heff::addDiagram3Aand3D(const int ikappa, double * memS, double *
                double beta = 1.0;
                char notr = 'N';
                double * BlockQ = Qleft->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
-               dgemm_(&notr,&notr,&dimLup,&dimR,&dimLdown,&factor,BlockQ,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+               planDgemm(&notr,&notr,&dimLup,&dimR,&dimLdown,&factor,BlockQ,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
             }
          }
       }
@@ -117,7 +117,7 @@ void CheMPS2::Heff::addDiagram3Aand3D(const int ikappa, double * memS, double *
                      char notr = 'N';
                      char trans = 'T';
                      double * BlockQ = Qleft->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
-                     dgemm_(&trans,&notr,&dimLup,&dimR,&dimLdown,&factor,BlockQ,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&trans,&notr,&dimLup,&dimR,&dimLdown,&factor,BlockQ,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   }
                }
             }
@@ -140,17 +140,17 @@ void CheMPS2::Heff::addDiagram3Aand3D(const int ikappa, double * memS, double *
                double * BlockQ = Qleft->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
                int inc = 1;
                int size = dimLup * dimLdown;
-               dcopy_(&size, BlockQ, &inc, temp, &inc);
+               planDcopy(&size, BlockQ, &inc, temp, &inc);
                
                for (int l_index=0; l_index<theindex; l_index++){
                   if (denBK->gIrrep(l_index) == denBK->gIrrep(theindex)){
                      double alpha = Prob->gMxElement(l_index,theindex,theindex,theindex);
                      double * BlockL = Lleft[theindex-1-l_index]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
-                     daxpy_(&size, &alpha, BlockL, &inc, temp, &inc);
+                     planDaxpy(&size, &alpha, BlockL, &inc, temp, &inc);
                   }
                }
                
-               dgemm_(&trans,&notr,&dimLup,&dimR,&dimLdown,&factor,temp,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+               planDgemm(&trans,&notr,&dimLup,&dimR,&dimLdown,&factor,temp,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
             }
          }
       }
@@ -197,17 +197,17 @@ void CheMPS2::Heff::addDiagram3Band3I(const int ikappa, double * memS, double *
                      double * BlockQ = Qleft->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
                      int inc = 1;
                      int size = dimLup * dimLdown;
-                     dcopy_(&size, BlockQ, &inc, temp, &inc);
+                     planDcopy(&size, BlockQ, &inc, temp, &inc);
                   
                      for (int l_index=0; l_index<theindex; l_index++){
                         if (denBK->gIrrep(l_index) == denBK->gIrrep(theindex+1)){
                            double alpha = Prob->gMxElement(l_index,theindex+1,theindex+1,theindex+1);
                            double * BlockL = Lleft[theindex-1-l_index]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
-                           daxpy_(&size, &alpha, BlockL, &inc, temp, &inc);
+                           planDaxpy(&size, &alpha, BlockL, &inc, temp, &inc);
                         }
                      }
                   
-                     dgemm_(&notr,&notr,&dimLup,&dimR,&dimLdown,&factor,temp,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&notr,&notr,&dimLup,&dimR,&dimLdown,&factor,temp,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   }
                }
             }
@@ -226,7 +226,7 @@ void CheMPS2::Heff::addDiagram3Band3I(const int ikappa, double * memS, double *
                double beta = 1.0;
                char notr = 'N';
                double * BlockQ = Qleft->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
-               dgemm_(&notr,&notr,&dimLup,&dimR,&dimLdown,&factor,BlockQ,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+               planDgemm(&notr,&notr,&dimLup,&dimR,&dimLdown,&factor,BlockQ,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
             }
          }
       }
@@ -250,7 +250,7 @@ void CheMPS2::Heff::addDiagram3Band3I(const int ikappa, double * memS, double *
                      char notr = 'N';
                      char trans = 'T';
                      double * BlockQ = Qleft->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
-                     dgemm_(&trans,&notr,&dimLup,&dimR,&dimLdown,&factor,BlockQ,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&trans,&notr,&dimLup,&dimR,&dimLdown,&factor,BlockQ,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   }
                }
             }
@@ -273,17 +273,17 @@ void CheMPS2::Heff::addDiagram3Band3I(const int ikappa, double * memS, double *
                double * BlockQ = Qleft->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
                int inc = 1;
                int size = dimLup * dimLdown;
-               dcopy_(&size, BlockQ, &inc, temp, &inc);
+               planDcopy(&size, BlockQ, &inc, temp, &inc);
                
                for (int l_index=0; l_index<theindex; l_index++){
                   if (denBK->gIrrep(l_index) == denBK->gIrrep(theindex+1)){
                      double alpha = Prob->gMxElement(l_index,theindex+1,theindex+1,theindex+1);
                      double * BlockL = Lleft[theindex-1-l_index]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
-                     daxpy_(&size, &alpha, BlockL, &inc, temp, &inc);
+                     planDaxpy(&size, &alpha, BlockL, &inc, temp, &inc);
                   }
                }
             
-               dgemm_(&trans,&notr,&dimLup,&dimR,&dimLdown,&factor,temp,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+               planDgemm(&trans,&notr,&dimLup,&dimR,&dimLdown,&factor,temp,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
             }
          }
       }
@@ -340,11 +340,11 @@ void CheMPS2::Heff::addDiagram3C(const int ikappa, double * memS, double * memHe
                      char notra = 'N';
                      double beta = 0.0; //set
                      double alpha = factor;
-                     dgemm_(&notra,&notra,&dimLup,&dimRdown,&dimLdown,&alpha,Qblock,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,temp,&dimLup);
+                     planDgemm(&notra,&notra,&dimLup,&dimRdown,&dimLdown,&alpha,Qblock,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,temp,&dimLup);
                   
                      beta = 1.0; //add
                      alpha = 1.0;
-                     dgemm_(&notra,&trans,&dimLup,&dimRup,&dimRdown,&alpha,temp,&dimLup,Lblock,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&notra,&trans,&dimLup,&dimRup,&dimRdown,&alpha,temp,&dimLup,Lblock,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                   }
                }
@@ -381,11 +381,11 @@ void CheMPS2::Heff::addDiagram3C(const int ikappa, double * memS, double * memHe
                      char notra = 'N';
                      double beta = 0.0; //set
                      double alpha = factor;
-                     dgemm_(&trans,&notra,&dimLup,&dimRdown,&dimLdown,&alpha,Qblock,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,temp,&dimLup);
+                     planDgemm(&trans,&notra,&dimLup,&dimRdown,&dimLdown,&alpha,Qblock,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,temp,&dimLup);
                   
                      beta = 1.0; //add
                      alpha = 1.0;
-                     dgemm_(&notra,&notra,&dimLup,&dimRup,&dimRdown,&alpha,temp,&dimLup,Lblock,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&notra,&notra,&dimLup,&dimRup,&dimRdown,&alpha,temp,&dimLup,Lblock,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                   }
                }
@@ -420,7 +420,7 @@ void CheMPS2::Heff::addDiagram3Eand3H(const int ikappa, double * memS, double *
       int memSkappa = denS->gKappa(NL,TwoSL,IL,1,1,0,NR,TwoSR,IR);
       if (memSkappa!=-1){
          double alpha = sqrt(2.0) * Prob->gMxElement(theindex,theindex,theindex,theindex+1);
-         daxpy_(&size,&alpha,memS+denS->gKappa2index(memSkappa),&inc,memHeff+denS->gKappa2index(ikappa),&inc);
+         planDaxpy(&size,&alpha,memS+denS->gKappa2index(memSkappa),&inc,memHeff+denS->gKappa2index(ikappa),&inc);
       }
    
    }
@@ -430,7 +430,7 @@ void CheMPS2::Heff::addDiagram3Eand3H(const int ikappa, double * memS, double *
       int memSkappa = denS->gKappa(NL,TwoSL,IL,1,2,1,NR,TwoSR,IR);
       if (memSkappa!=-1){
          double alpha = - ( Prob->gMxElement(theindex,theindex,theindex,theindex+1) + Prob->gMxElement(theindex,theindex+1,theindex+1,theindex+1) );
-         daxpy_(&size,&alpha,memS+denS->gKappa2index(memSkappa),&inc,memHeff+denS->gKappa2index(ikappa),&inc);
+         planDaxpy(&size,&alpha,memS+denS->gKappa2index(memSkappa),&inc,memHeff+denS->gKappa2index(ikappa),&inc);
       }
    
    }
@@ -440,13 +440,13 @@ void CheMPS2::Heff::addDiagram3Eand3H(const int ikappa, double * memS, double *
       int memSkappa = denS->gKappa(NL,TwoSL,IL,2,0,0,NR,TwoSR,IR);
       if (memSkappa!=-1){
          double alpha = sqrt(2.0) * Prob->gMxElement(theindex,theindex,theindex,theindex+1);
-         daxpy_(&size,&alpha,memS+denS->gKappa2index(memSkappa),&inc,memHeff+denS->gKappa2index(ikappa),&inc);
+         planDaxpy(&size,&alpha,memS+denS->gKappa2index(memSkappa),&inc,memHeff+denS->gKappa2index(ikappa),&inc);
       }
       
       memSkappa = denS->gKappa(NL,TwoSL,IL,0,2,0,NR,TwoSR,IR);
       if (memSkappa!=-1){
          double alpha = sqrt(2.0) * Prob->gMxElement(theindex,theindex+1,theindex+1,theindex+1);
-         daxpy_(&size,&alpha,memS+denS->gKappa2index(memSkappa),&inc,memHeff+denS->gKappa2index(ikappa),&inc);
+         planDaxpy(&size,&alpha,memS+denS->gKappa2index(memSkappa),&inc,memHeff+denS->gKappa2index(ikappa),&inc);
       }
    
    }
@@ -456,7 +456,7 @@ void CheMPS2::Heff::addDiagram3Eand3H(const int ikappa, double * memS, double *
       int memSkappa = denS->gKappa(NL,TwoSL,IL,2,1,1,NR,TwoSR,IR);
       if (memSkappa!=-1){
          double alpha = - ( Prob->gMxElement(theindex,theindex,theindex,theindex+1) + Prob->gMxElement(theindex,theindex+1,theindex+1,theindex+1) );
-         daxpy_(&size,&alpha,memS+denS->gKappa2index(memSkappa),&inc,memHeff+denS->gKappa2index(ikappa),&inc);
+         planDaxpy(&size,&alpha,memS+denS->gKappa2index(memSkappa),&inc,memHeff+denS->gKappa2index(ikappa),&inc);
       }
    
    }
@@ -466,7 +466,7 @@ void CheMPS2::Heff::addDiagram3Eand3H(const int ikappa, double * memS, double *
       int memSkappa = denS->gKappa(NL,TwoSL,IL,1,1,0,NR,TwoSR,IR);
       if (memSkappa!=-1){
          double alpha = sqrt(2.0) * Prob->gMxElement(theindex,theindex+1,theindex+1,theindex+1);
-         daxpy_(&size,&alpha,memS+denS->gKappa2index(memSkappa),&inc,memHeff+denS->gKappa2index(ikappa),&inc);
+         planDaxpy(&size,&alpha,memS+denS->gKappa2index(memSkappa),&inc,memHeff+denS->gKappa2index(ikappa),&inc);
       }
    
    }
@@ -503,7 +503,7 @@ void CheMPS2::Heff::addDiagram3Kand3F(const int ikappa, double * memS, double *
                double beta = 1.0; //add
                char notr = 'N';
                double * BlockQ = Qright->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
-               dgemm_(&notr,&notr,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,BlockQ,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+               planDgemm(&notr,&notr,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,BlockQ,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
             }
          }
       }
@@ -529,17 +529,17 @@ void CheMPS2::Heff::addDiagram3Kand3F(const int ikappa, double * memS, double *
                      double * BlockQ = Qright->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
                      int inc = 1;
                      int size = dimRup * dimRdown;
-                     dcopy_(&size,BlockQ,&inc,temp,&inc);
+                     planDcopy(&size,BlockQ,&inc,temp,&inc);
                   
                      for (int l_index=theindex+2; l_index<Prob->gL(); l_index++){
                         if (denBK->gIrrep(l_index) == denBK->gIrrep(theindex)){
                            double alpha = Prob->gMxElement(theindex,theindex,theindex,l_index);
                            double * BlockL = Lright[l_index-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
-                           daxpy_(&size, &alpha, BlockL, &inc, temp, &inc);
+                           planDaxpy(&size, &alpha, BlockL, &inc, temp, &inc);
                         }
                      }
                   
-                     dgemm_(&notr,&notr,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,temp,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                     planDgemm(&notr,&notr,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,temp,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
                   }
                }
             }
@@ -565,7 +565,7 @@ void CheMPS2::Heff::addDiagram3Kand3F(const int ikappa, double * memS, double *
                      char notr = 'N';
                      char tran = 'T';
                      double * BlockQ = Qright->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
-                     dgemm_(&notr,&tran,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,BlockQ,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                     planDgemm(&notr,&tran,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,BlockQ,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
                   }
                }
             }
@@ -588,17 +588,17 @@ void CheMPS2::Heff::addDiagram3Kand3F(const int ikappa, double * memS, double *
                double * BlockQ = Qright->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
                int inc = 1;
                int size = dimRup * dimRdown;
-               dcopy_(&size,BlockQ,&inc,temp,&inc);
+               planDcopy(&size,BlockQ,&inc,temp,&inc);
             
                for (int l_index=theindex+2; l_index<Prob->gL(); l_index++){
                   if (denBK->gIrrep(l_index) == denBK->gIrrep(theindex)){
                      double alpha = Prob->gMxElement(theindex,theindex,theindex,l_index);
                      double * BlockL = Lright[l_index-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
-                     daxpy_(&size, &alpha, BlockL, &inc, temp, &inc);
+                     planDaxpy(&size, &alpha, BlockL, &inc, temp, &inc);
                   }
                }
             
-               dgemm_(&notr,&tran,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,temp,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+               planDgemm(&notr,&tran,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,temp,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
             }
          }
       }
@@ -636,7 +636,7 @@ void CheMPS2::Heff::addDiagram3Land3G(const int ikappa, double * memS, double *
                double beta = 1.0; //add
                char notr = 'N';
                double * BlockQ = Qright->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
-               dgemm_(&notr,&notr,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,BlockQ,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+               planDgemm(&notr,&notr,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,BlockQ,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
             }
          }
       }
@@ -662,17 +662,17 @@ void CheMPS2::Heff::addDiagram3Land3G(const int ikappa, double * memS, double *
                      double * BlockQ = Qright->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
                      int inc = 1;
                      int size = dimRup * dimRdown;
-                     dcopy_(&size,BlockQ,&inc,temp,&inc);
+                     planDcopy(&size,BlockQ,&inc,temp,&inc);
                   
                      for (int l_index=theindex+2; l_index<Prob->gL(); l_index++){
                         if (denBK->gIrrep(l_index) == denBK->gIrrep(theindex+1)){
                            double alpha = Prob->gMxElement(theindex+1,theindex+1,theindex+1,l_index);
                            double * BlockL = Lright[l_index-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
-                           daxpy_(&size, &alpha, BlockL, &inc, temp, &inc);
+                           planDaxpy(&size, &alpha, BlockL, &inc, temp, &inc);
                         }
                      }
                   
-                     dgemm_(&notr,&notr,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,temp,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                     planDgemm(&notr,&notr,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,temp,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
                   }
                }
             }
@@ -698,7 +698,7 @@ void CheMPS2::Heff::addDiagram3Land3G(const int ikappa, double * memS, double *
                      char notr = 'N';
                      char tran = 'T';
                      double * BlockQ = Qright->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
-                     dgemm_(&notr,&tran,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,BlockQ,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                     planDgemm(&notr,&tran,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,BlockQ,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
                   }
                }
             }
@@ -721,17 +721,17 @@ void CheMPS2::Heff::addDiagram3Land3G(const int ikappa, double * memS, double *
                double * BlockQ = Qright->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
                int inc = 1;
                int size = dimRup * dimRdown;
-               dcopy_(&size,BlockQ,&inc,temp,&inc);
+               planDcopy(&size,BlockQ,&inc,temp,&inc);
             
                for (int l_index=theindex+2; l_index<Prob->gL(); l_index++){
                   if (denBK->gIrrep(l_index) == denBK->gIrrep(theindex+1)){
                      double alpha = Prob->gMxElement(theindex+1,theindex+1,theindex+1,l_index);
                      double * BlockL = Lright[l_index-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
-                     daxpy_(&size, &alpha, BlockL, &inc, temp, &inc);
+                     planDaxpy(&size, &alpha, BlockL, &inc, temp, &inc);
                   }
                }
             
-               dgemm_(&notr,&tran,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,temp,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+               planDgemm(&notr,&tran,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,temp,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
             }
          }
       }
@@ -789,11 +789,11 @@ void CheMPS2::Heff::addDiagram3J(const int ikappa, double * memS, double * memHe
                      char notra = 'N';
                      double beta = 0.0; //set
                      double alpha = factor;
-                     dgemm_(&notra,&notra,&dimLup,&dimRdown,&dimLdown,&alpha,Lblock,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,temp,&dimLup);
+                     planDgemm(&notra,&notra,&dimLup,&dimRdown,&dimLdown,&alpha,Lblock,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,temp,&dimLup);
                   
                      beta = 1.0; //add
                      alpha = 1.0;
-                     dgemm_(&notra,&trans,&dimLup,&dimRup,&dimRdown,&alpha,temp,&dimLup,Qblock,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&notra,&trans,&dimLup,&dimRup,&dimRdown,&alpha,temp,&dimLup,Qblock,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                   }
                }
@@ -830,11 +830,11 @@ void CheMPS2::Heff::addDiagram3J(const int ikappa, double * memS, double * memHe
                      char notra = 'N';
                      double beta = 0.0; //set
                      double alpha = factor;
-                     dgemm_(&trans,&notra,&dimLup,&dimRdown,&dimLdown,&alpha,Lblock,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,temp,&dimLup);
+                     planDgemm(&trans,&notra,&dimLup,&dimRdown,&dimLdown,&alpha,Lblock,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,temp,&dimLup);
                   
                      beta = 1.0; //add
                      alpha = 1.0;
-                     dgemm_(&notra,&notra,&dimLup,&dimRup,&dimRdown,&alpha,temp,&dimLup,Qblock,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&notra,&notra,&dimLup,&dimRup,&dimRdown,&alpha,temp,&dimLup,Qblock,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                   }
                }
@@ -59,7 +59,7 @@ void CheMPS2::Heff::addDiagram4A1and4A2spin0(const int ikappa, double * memS, do
          double * Ablock = Atens->gStorage(NL-2,TwoSL,ILdown,NL,TwoSL,IL);
          int dimLdown = denBK->gCurrentDim(theindex,NL-2,TwoSL,ILdown);
          
-         dgemm_(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Ablock,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+         planDgemm(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Ablock,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
          
       }
    }
@@ -74,7 +74,7 @@ void CheMPS2::Heff::addDiagram4A1and4A2spin0(const int ikappa, double * memS, do
          double * Ablock = Atens->gStorage(NL-2,TwoSL,ILdown,NL,TwoSL,IL);
          int dimLdown = denBK->gCurrentDim(theindex,NL-2,TwoSL,ILdown);
          
-         dgemm_(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Ablock,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+         planDgemm(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Ablock,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
          
       }
    }
@@ -89,7 +89,7 @@ void CheMPS2::Heff::addDiagram4A1and4A2spin0(const int ikappa, double * memS, do
          double * Ablock = Atens->gStorage(NL-2,TwoSL,ILdown,NL,TwoSL,IL);
          int dimLdown = denBK->gCurrentDim(theindex,NL-2,TwoSL,ILdown);
          
-         dgemm_(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Ablock,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+         planDgemm(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Ablock,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
          
       }
    }
@@ -104,7 +104,7 @@ void CheMPS2::Heff::addDiagram4A1and4A2spin0(const int ikappa, double * memS, do
          double * Ablock = Atens->gStorage(NL-2,TwoSL,ILdown,NL,TwoSL,IL);
          int dimLdown = denBK->gCurrentDim(theindex,NL-2,TwoSL,ILdown);
          
-         dgemm_(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Ablock,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+         planDgemm(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Ablock,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
          
       }
       memSkappa = denS->gKappa(NL+2,TwoSL,ILdown,0,0,0,NR,TwoSR,IR);
@@ -114,7 +114,7 @@ void CheMPS2::Heff::addDiagram4A1and4A2spin0(const int ikappa, double * memS, do
          double * Ablock = Atens->gStorage(NL,TwoSL,IL,NL+2,TwoSL,ILdown);
          int dimLdown = denBK->gCurrentDim(theindex,NL+2,TwoSL,ILdown);
          
-         dgemm_(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Ablock,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+         planDgemm(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Ablock,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
          
       }
    }
@@ -129,7 +129,7 @@ void CheMPS2::Heff::addDiagram4A1and4A2spin0(const int ikappa, double * memS, do
          double * Ablock = Atens->gStorage(NL,TwoSL,IL,NL+2,TwoSL,ILdown);
          int dimLdown = denBK->gCurrentDim(theindex,NL+2,TwoSL,ILdown);
          
-         dgemm_(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Ablock,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+         planDgemm(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Ablock,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
          
       }
    }
@@ -144,7 +144,7 @@ void CheMPS2::Heff::addDiagram4A1and4A2spin0(const int ikappa, double * memS, do
          double * Ablock = Atens->gStorage(NL,TwoSL,IL,NL+2,TwoSL,ILdown);
          int dimLdown = denBK->gCurrentDim(theindex,NL+2,TwoSL,ILdown);
 
-         dgemm_(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Ablock,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+         planDgemm(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Ablock,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
          
       }
    }
@@ -159,7 +159,7 @@ void CheMPS2::Heff::addDiagram4A1and4A2spin0(const int ikappa, double * memS, do
          double * Ablock = Atens->gStorage(NL,TwoSL,IL,NL+2,TwoSL,ILdown);
          int dimLdown = denBK->gCurrentDim(theindex,NL+2,TwoSL,ILdown);
 
-         dgemm_(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Ablock,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+         planDgemm(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Ablock,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
          
       }
    }
@@ -203,7 +203,7 @@ void CheMPS2::Heff::addDiagram4A1and4A2spin1(const int ikappa, double * memS, do
                double * Bblock = Btens->gStorage(NL-2,TwoSLdown,ILdown,NL,TwoSL,IL);
                int dimLdown = denBK->gCurrentDim(theindex,NL-2,TwoSLdown,ILdown);
          
-               dgemm_(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Bblock,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+               planDgemm(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Bblock,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
          
             }
          }
@@ -224,7 +224,7 @@ void CheMPS2::Heff::addDiagram4A1and4A2spin1(const int ikappa, double * memS, do
                double * Bblock = Btens->gStorage(NL-2,TwoSLdown,ILdown,NL,TwoSL,IL);
                int dimLdown = denBK->gCurrentDim(theindex,NL-2,TwoSLdown,ILdown);
          
-               dgemm_(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Bblock,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+               planDgemm(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Bblock,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
             }
          }
       }
@@ -244,7 +244,7 @@ void CheMPS2::Heff::addDiagram4A1and4A2spin1(const int ikappa, double * memS, do
                double * Bblock = Btens->gStorage(NL-2,TwoSLdown,ILdown,NL,TwoSL,IL);
                int dimLdown = denBK->gCurrentDim(theindex,NL-2,TwoSLdown,ILdown);
          
-               dgemm_(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Bblock,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+               planDgemm(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Bblock,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
             }
          }
       }
@@ -263,7 +263,7 @@ void CheMPS2::Heff::addDiagram4A1and4A2spin1(const int ikappa, double * memS, do
          double * Bblock = Btens->gStorage(NL-2,TwoSLdown,ILdown,NL,TwoSL,IL);
          int dimLdown = denBK->gCurrentDim(theindex,NL-2,TwoSLdown,ILdown);
          
-         dgemm_(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Bblock,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+         planDgemm(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Bblock,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
          
       }
       memSkappa = denS->gKappa(NL+2,TwoSLdown,ILdown,0,0,0,NR,TwoSR,IR);
@@ -273,7 +273,7 @@ void CheMPS2::Heff::addDiagram4A1and4A2spin1(const int ikappa, double * memS, do
          double * Bblock = Btens->gStorage(NL,TwoSL,IL,NL+2,TwoSLdown,ILdown);
          int dimLdown = denBK->gCurrentDim(theindex,NL+2,TwoSLdown,ILdown);
          
-         dgemm_(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Bblock,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+         planDgemm(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Bblock,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
          
       }
    }
@@ -292,7 +292,7 @@ void CheMPS2::Heff::addDiagram4A1and4A2spin1(const int ikappa, double * memS, do
                double * Bblock = Btens->gStorage(NL,TwoSL,IL,NL+2,TwoSLdown,ILdown);
                int dimLdown = denBK->gCurrentDim(theindex,NL+2,TwoSLdown,ILdown);
          
-               dgemm_(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Bblock,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+               planDgemm(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Bblock,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
             }
          }
       }
@@ -312,7 +312,7 @@ void CheMPS2::Heff::addDiagram4A1and4A2spin1(const int ikappa, double * memS, do
                double * Bblock = Btens->gStorage(NL,TwoSL,IL,NL+2,TwoSLdown,ILdown);
                int dimLdown = denBK->gCurrentDim(theindex,NL+2,TwoSLdown,ILdown);
          
-               dgemm_(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Bblock,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+               planDgemm(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Bblock,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
             }
          }
       }
@@ -333,7 +333,7 @@ void CheMPS2::Heff::addDiagram4A1and4A2spin1(const int ikappa, double * memS, do
                double * Bblock = Btens->gStorage(NL,TwoSL,IL,NL+2,TwoSLdown,ILdown);
                int dimLdown = denBK->gCurrentDim(theindex,NL+2,TwoSLdown,ILdown);
          
-               dgemm_(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Bblock,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+               planDgemm(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,Bblock,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
             }
          }
       }
@@ -375,7 +375,7 @@ void CheMPS2::Heff::addDiagram4A3and4A4spin0(const int ikappa, double * memS, do
          int dimLdown = denBK->gCurrentDim(theindex,NL,TwoSL,ILdown);
          double * ptr = Ctens->gStorage(NL,TwoSL,ILdown,NL,TwoSL,IL);
 
-         dgemm_(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+         planDgemm(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
          
       }  
    }
@@ -390,7 +390,7 @@ void CheMPS2::Heff::addDiagram4A3and4A4spin0(const int ikappa, double * memS, do
          int dimLdown = denBK->gCurrentDim(theindex,NL,TwoSL,ILdown);
          double * ptr = Ctens->gStorage(NL,TwoSL,ILdown,NL,TwoSL,IL);
          
-         dgemm_(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+         planDgemm(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
          
       }
    }
@@ -405,7 +405,7 @@ void CheMPS2::Heff::addDiagram4A3and4A4spin0(const int ikappa, double * memS, do
          int dimLdown = denBK->gCurrentDim(theindex,NL,TwoSL,ILdown);
          double * ptr = Ctens->gStorage(NL,TwoSL,ILdown,NL,TwoSL,IL);
          
-         dgemm_(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+         planDgemm(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
          
       }
    }
@@ -420,7 +420,7 @@ void CheMPS2::Heff::addDiagram4A3and4A4spin0(const int ikappa, double * memS, do
          int dimLdown = denBK->gCurrentDim(theindex,NL,TwoSL,ILdown);
          double * ptr = Ctens->gStorage(NL,TwoSL,ILdown,NL,TwoSL,IL);
          
-         dgemm_(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+         planDgemm(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
          
       }
    }
@@ -435,7 +435,7 @@ void CheMPS2::Heff::addDiagram4A3and4A4spin0(const int ikappa, double * memS, do
          int dimLdown = denBK->gCurrentDim(theindex,NL,TwoSL,ILdown);
          double * ptr = Ctens->gStorage(NL,TwoSL,IL,NL,TwoSL,ILdown);
          
-         dgemm_(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+         planDgemm(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
          
       }
    }
@@ -450,7 +450,7 @@ void CheMPS2::Heff::addDiagram4A3and4A4spin0(const int ikappa, double * memS, do
          int dimLdown = denBK->gCurrentDim(theindex,NL,TwoSL,ILdown);
          double * ptr = Ctens->gStorage(NL,TwoSL,IL,NL,TwoSL,ILdown);
          
-         dgemm_(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+         planDgemm(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
          
       }
    }
@@ -465,7 +465,7 @@ void CheMPS2::Heff::addDiagram4A3and4A4spin0(const int ikappa, double * memS, do
          int dimLdown = denBK->gCurrentDim(theindex,NL,TwoSL,ILdown);
          double * ptr = Ctens->gStorage(NL,TwoSL,IL,NL,TwoSL,ILdown);
          
-         dgemm_(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+         planDgemm(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
          
       }
    }
@@ -480,7 +480,7 @@ void CheMPS2::Heff::addDiagram4A3and4A4spin0(const int ikappa, double * memS, do
          int dimLdown = denBK->gCurrentDim(theindex,NL,TwoSL,ILdown);
          double * ptr = Ctens->gStorage(NL,TwoSL,IL,NL,TwoSL,ILdown);
          
-         dgemm_(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+         planDgemm(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
          
       }
    }
@@ -525,7 +525,7 @@ void CheMPS2::Heff::addDiagram4A3and4A4spin1(const int ikappa, double * memS, do
                int dimLdown = denBK->gCurrentDim(theindex,NL,TwoSLdown,ILdown);
                double * ptr = Dtens->gStorage(NL,TwoSLdown,ILdown,NL,TwoSL,IL);
          
-               dgemm_(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+               planDgemm(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
             }
          }
       }
@@ -544,7 +544,7 @@ void CheMPS2::Heff::addDiagram4A3and4A4spin1(const int ikappa, double * memS, do
          int dimLdown = denBK->gCurrentDim(theindex,NL,TwoSLdown,ILdown);
          double * ptr = Dtens->gStorage(NL,TwoSLdown,ILdown,NL,TwoSL,IL);
          
-         dgemm_(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+         planDgemm(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
          
       }
    }
@@ -562,7 +562,7 @@ void CheMPS2::Heff::addDiagram4A3and4A4spin1(const int ikappa, double * memS, do
                int dimLdown = denBK->gCurrentDim(theindex,NL,TwoSLdown,ILdown);
                double * ptr = Dtens->gStorage(NL,TwoSLdown,ILdown,NL,TwoSL,IL);
          
-               dgemm_(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+               planDgemm(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
             }
          }
       }
@@ -582,7 +582,7 @@ void CheMPS2::Heff::addDiagram4A3and4A4spin1(const int ikappa, double * memS, do
                int dimLdown = denBK->gCurrentDim(theindex,NL,TwoSLdown,ILdown);
                double * ptr = Dtens->gStorage(NL,TwoSLdown,ILdown,NL,TwoSL,IL);
          
-               dgemm_(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+               planDgemm(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
             }
          }
       }
@@ -602,7 +602,7 @@ void CheMPS2::Heff::addDiagram4A3and4A4spin1(const int ikappa, double * memS, do
                int dimLdown = denBK->gCurrentDim(theindex,NL,TwoSLdown,ILdown);
                double * ptr = Dtens->gStorage(NL,TwoSL,IL,NL,TwoSLdown,ILdown);
          
-               dgemm_(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+               planDgemm(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
             }
          }
       }
@@ -622,7 +622,7 @@ void CheMPS2::Heff::addDiagram4A3and4A4spin1(const int ikappa, double * memS, do
                int dimLdown = denBK->gCurrentDim(theindex,NL,TwoSLdown,ILdown);
                double * ptr = Dtens->gStorage(NL,TwoSL,IL,NL,TwoSLdown,ILdown);
             
-               dgemm_(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+               planDgemm(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
             }
          }
       }
@@ -640,7 +640,7 @@ void CheMPS2::Heff::addDiagram4A3and4A4spin1(const int ikappa, double * memS, do
          int dimLdown = denBK->gCurrentDim(theindex,NL,TwoSLdown,ILdown);
          double * ptr = Dtens->gStorage(NL,TwoSL,IL,NL,TwoSLdown,ILdown);
 
-         dgemm_(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+         planDgemm(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
 
       }
    }
@@ -659,7 +659,7 @@ void CheMPS2::Heff::addDiagram4A3and4A4spin1(const int ikappa, double * memS, do
                int dimLdown = denBK->gCurrentDim(theindex,NL,TwoSLdown,ILdown);
                double * ptr = Dtens->gStorage(NL,TwoSL,IL,NL,TwoSLdown,ILdown);
          
-               dgemm_(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+               planDgemm(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,ptr,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
             }
          }
       }
@@ -723,12 +723,12 @@ void CheMPS2::Heff::addDiagram4B1and4B2spin0(const int ikappa, double * memS, do
                         double * Lblock = Lright[l_index-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
                         double alpha = 1.0;
                         double beta = 0.0; //set
-                        dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown, &beta,temp,&dimLdown);
+                        planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown, &beta,temp,&dimLdown);
                      
                         double * Ablock = Aleft[l_index-theindex][0]->gStorage(NL-2,TwoSL,ILdown,NL,TwoSL,IL);
                         alpha = factor;
                         beta = 1.0; //add
-                        dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Ablock,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Ablock,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                    
                      }
                   }
@@ -765,12 +765,12 @@ void CheMPS2::Heff::addDiagram4B1and4B2spin0(const int ikappa, double * memS, do
                      double * Lblock = Lright[l_index-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
                      double alpha = 1.0;
                      double beta = 0.0; //set
-                     dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp,&dimLdown);
+                     planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp,&dimLdown);
                      
                      double * Ablock = Aleft[l_index-theindex][0]->gStorage(NL-2,TwoSL,ILdown,NL,TwoSL,IL);
                      alpha = factor;
                      beta = 1.0; //add
-                     dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Ablock,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Ablock,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                   }
                }
@@ -806,12 +806,12 @@ void CheMPS2::Heff::addDiagram4B1and4B2spin0(const int ikappa, double * memS, do
                      double * Lblock = Lright[l_index-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
                      double alpha = 1.0;
                      double beta = 0.0; //set
-                     dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
+                     planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
                      
                      double * Ablock = Aleft[l_index-theindex][0]->gStorage(NL,TwoSL,IL,NL+2,TwoSL,ILdown);
                      alpha = factor;
                      beta = 1.0; //add
-                     dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Ablock,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Ablock,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                   }
                }
@@ -850,12 +850,12 @@ void CheMPS2::Heff::addDiagram4B1and4B2spin0(const int ikappa, double * memS, do
                         double * Lblock = Lright[l_index-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
                         double alpha = 1.0;
                         double beta = 0.0; //set
-                        dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
                      
                         double * Ablock = Aleft[l_index-theindex][0]->gStorage(NL,TwoSL,IL,NL+2,TwoSL,ILdown);
                         alpha = factor;
                         beta = 1.0; //add
-                        dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Ablock,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Ablock,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                      }
                   }
@@ -925,12 +925,12 @@ void CheMPS2::Heff::addDiagram4B1and4B2spin1(const int ikappa, double * memS, do
                            double * Lblock = Lright[l_index-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
                            double alpha = 1.0;
                            double beta = 0.0; //set
-                           dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown, Lblock,&dimRdown, &beta,temp, &dimLdown);
+                           planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown, Lblock,&dimRdown, &beta,temp, &dimLdown);
                      
                            double * Bblock = Bleft[l_index-theindex][0]->gStorage(NL-2,TwoSLdown,ILdown,NL,TwoSL,IL);
                            alpha = factor;
                            beta = 1.0; //add
-                           dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Bblock,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                           planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Bblock,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                         }
                      }
@@ -970,12 +970,12 @@ void CheMPS2::Heff::addDiagram4B1and4B2spin1(const int ikappa, double * memS, do
                         double * Lblock = Lright[l_index-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
                         double alpha = 1.0;
                         double beta = 0.0; //set
-                        dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp, &dimLdown);
+                        planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp, &dimLdown);
                      
                         double * Bblock = Bleft[l_index-theindex][0]->gStorage(NL-2,TwoSLdown,ILdown,NL,TwoSL,IL);
                         alpha = factor;
                         beta = 1.0; //add
-                        dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Bblock,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Bblock,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                      }
                   }
@@ -1014,12 +1014,12 @@ void CheMPS2::Heff::addDiagram4B1and4B2spin1(const int ikappa, double * memS, do
                         double * Lblock = Lright[l_index-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
                         double alpha = 1.0;
                         double beta = 0.0; //set
-                        dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
                      
                         double * Bblock = Bleft[l_index-theindex][0]->gStorage(NL,TwoSL,IL,NL+2,TwoSLdown,ILdown);
                         alpha = factor;
                         beta = 1.0; //add
-                        dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Bblock,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Bblock,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                      }
                   }
@@ -1061,12 +1061,12 @@ void CheMPS2::Heff::addDiagram4B1and4B2spin1(const int ikappa, double * memS, do
                            double * Lblock = Lright[l_index-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
                            double alpha = 1.0;
                            double beta = 0.0; //set
-                           dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp, &dimLdown);
+                           planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp, &dimLdown);
                      
                            double * Bblock = Bleft[l_index-theindex][0]->gStorage(NL,TwoSL,IL,NL+2,TwoSLdown,ILdown);
                            alpha = factor;
                            beta = 1.0; //add
-                           dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Bblock,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                           planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Bblock,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                         }
                      }
@@ -1132,13 +1132,13 @@ void CheMPS2::Heff::addDiagram4B3and4B4spin0(const int ikappa, double * memS, do
                      double * Lblock = Lright[l_index-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
                      double alpha = 1.0;
                      double beta = 0.0; //set
-                     dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp,&dimLdown);
+                     planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp,&dimLdown);
                      
                      double * ptr = Cleft[l_index-theindex][0]->gStorage(NL,TwoSL,ILdown,NL,TwoSL,IL);
                   
                      alpha = factor;
                      beta = 1.0; //add
-                     dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                   }
                }
@@ -1177,13 +1177,13 @@ void CheMPS2::Heff::addDiagram4B3and4B4spin0(const int ikappa, double * memS, do
                         double * Lblock = Lright[l_index-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
                         double alpha = 1.0;
                         double beta = 0.0; //set
-                        dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp, &dimLdown);
+                        planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp, &dimLdown);
                      
                         double * ptr = Cleft[l_index-theindex][0]->gStorage(NL,TwoSL,ILdown,NL,TwoSL,IL);
                   
                         alpha = factor;
                         beta = 1.0; //add
-                        dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                      }
                   }
@@ -1223,13 +1223,13 @@ void CheMPS2::Heff::addDiagram4B3and4B4spin0(const int ikappa, double * memS, do
                         double * Lblock = Lright[l_index-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
                         double alpha = 1.0;
                         double beta = 0.0; //set
-                        dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
                      
                         double * ptr = Cleft[l_index-theindex][0]->gStorage(NL,TwoSL,IL,NL,TwoSL,ILdown);
                   
                         alpha = factor;
                         beta = 1.0; //add
-                        dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                      }
                   }
@@ -1266,13 +1266,13 @@ void CheMPS2::Heff::addDiagram4B3and4B4spin0(const int ikappa, double * memS, do
                      double * Lblock = Lright[l_index-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
                      double alpha = 1.0;
                      double beta = 0.0; //set
-                     dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
+                     planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
                      
                      double * ptr = Cleft[l_index-theindex][0]->gStorage(NL,TwoSL,IL,NL,TwoSL,ILdown);
                   
                      alpha = factor;
                      beta = 1.0; //add
-                     dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                   }
                }
@@ -1338,13 +1338,13 @@ void CheMPS2::Heff::addDiagram4B3and4B4spin1(const int ikappa, double * memS, do
                         double * Lblock = Lright[l_index-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
                         double alpha = 1.0;
                         double beta = 0.0; //set
-                        dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp, &dimLdown);
+                        planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp, &dimLdown);
                      
                         double * ptr = Dleft[l_index-theindex][0]->gStorage(NL,TwoSLdown,ILdown,NL,TwoSL,IL);
                         
                         alpha = factor;
                         beta = 1.0; //add
-                        dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                      }
                   }
@@ -1386,13 +1386,13 @@ void CheMPS2::Heff::addDiagram4B3and4B4spin1(const int ikappa, double * memS, do
                            double * Lblock = Lright[l_index-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
                            double alpha = 1.0;
                            double beta = 0.0; //set
-                           dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp, &dimLdown);
+                           planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp, &dimLdown);
                      
                            double * ptr = Dleft[l_index-theindex][0]->gStorage(NL,TwoSLdown,ILdown,NL,TwoSL,IL);
                   
                            alpha = factor;
                            beta = 1.0; //add
-                           dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                           planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                         }
                      }
@@ -1435,13 +1435,13 @@ void CheMPS2::Heff::addDiagram4B3and4B4spin1(const int ikappa, double * memS, do
                            double * Lblock = Lright[l_index-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
                            double alpha = 1.0;
                            double beta = 0.0; //set
-                           dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp, &dimLdown);
+                           planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp, &dimLdown);
                      
                            double * ptr = Dleft[l_index-theindex][0]->gStorage(NL,TwoSL,IL,NL,TwoSLdown,ILdown);
                   
                            alpha = factor;
                            beta = 1.0; //add
-                           dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                           planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                         }
                      }
@@ -1481,13 +1481,13 @@ void CheMPS2::Heff::addDiagram4B3and4B4spin1(const int ikappa, double * memS, do
                         double * Lblock = Lright[l_index-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
                         double alpha = 1.0;
                         double beta = 0.0; //set
-                        dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
                      
                         double * ptr = Dleft[l_index-theindex][0]->gStorage(NL,TwoSL,IL,NL,TwoSLdown,ILdown);
                   
                         alpha = factor;
                         beta = 1.0; //add
-                        dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                      }
                   }
@@ -1555,12 +1555,12 @@ void CheMPS2::Heff::addDiagram4C1and4C2spin0(const int ikappa, double * memS, do
                         double * Lblock = Lright[l_index-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
                         double alpha = 1.0;
                         double beta = 0.0; //set
-                        dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp,&dimLdown);
                      
                         double * Ablock = Aleft[l_index-theindex-1][1]->gStorage(NL-2,TwoSL,ILdown,NL,TwoSL,IL);
                         alpha = factor;
                         beta = 1.0; //add
-                        dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Ablock,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Ablock,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                      }
                   }
@@ -1597,12 +1597,12 @@ void CheMPS2::Heff::addDiagram4C1and4C2spin0(const int ikappa, double * memS, do
                      double * Lblock = Lright[l_index-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
                      double alpha = 1.0;
                      double beta = 0.0; //set
-                     dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp,&dimLdown);
+                     planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp,&dimLdown);
                      
                      double * Ablock = Aleft[l_index-theindex-1][1]->gStorage(NL-2,TwoSL,ILdown,NL,TwoSL,IL);
                      alpha = factor;
                      beta = 1.0; //add
-                     dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Ablock,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Ablock,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                   }
                }
@@ -1638,12 +1638,12 @@ void CheMPS2::Heff::addDiagram4C1and4C2spin0(const int ikappa, double * memS, do
                      double * Lblock = Lright[l_index-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
                      double alpha = 1.0;
                      double beta = 0.0; //set
-                     dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
+                     planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
                      
                      double * Ablock = Aleft[l_index-theindex-1][1]->gStorage(NL,TwoSL,IL,NL+2,TwoSL,ILdown);
                      alpha = factor;
                      beta = 1.0; //add
-                     dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Ablock,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Ablock,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                   }
                }
@@ -1682,12 +1682,12 @@ void CheMPS2::Heff::addDiagram4C1and4C2spin0(const int ikappa, double * memS, do
                         double * Lblock = Lright[l_index-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
                         double alpha = 1.0;
                         double beta = 0.0; //set
-                        dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
                      
                         double * Ablock = Aleft[l_index-theindex-1][1]->gStorage(NL,TwoSL,IL,NL+2,TwoSL,ILdown);
                         alpha = factor;
                         beta = 1.0; //add
-                        dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Ablock,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Ablock,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                      }
                   }
@@ -1757,12 +1757,12 @@ void CheMPS2::Heff::addDiagram4C1and4C2spin1(const int ikappa, double * memS, do
                            double * Lblock = Lright[l_index-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
                            double alpha = 1.0;
                            double beta = 0.0; //set
-                           dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp,&dimLdown);
+                           planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp,&dimLdown);
                      
                            double * Bblock = Bleft[l_index-theindex-1][1]->gStorage(NL-2,TwoSLdown,ILdown,NL,TwoSL,IL);
                            alpha = factor;
                            beta = 1.0; //add
-                           dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Bblock,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                           planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Bblock,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                         }
                      }
@@ -1802,12 +1802,12 @@ void CheMPS2::Heff::addDiagram4C1and4C2spin1(const int ikappa, double * memS, do
                         double * Lblock = Lright[l_index-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
                         double alpha = 1.0;
                         double beta = 0.0; //set
-                        dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp,&dimLdown);
                      
                         double * Bblock = Bleft[l_index-theindex-1][1]->gStorage(NL-2,TwoSLdown,ILdown,NL,TwoSL,IL);
                         alpha = factor;
                         beta = 1.0; //add
-                        dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Bblock,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Bblock,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                      }
                   }
@@ -1846,12 +1846,12 @@ void CheMPS2::Heff::addDiagram4C1and4C2spin1(const int ikappa, double * memS, do
                         double * Lblock = Lright[l_index-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
                         double alpha = 1.0;
                         double beta = 0.0; //set
-                        dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
                      
                         double * Bblock = Bleft[l_index-theindex-1][1]->gStorage(NL,TwoSL,IL,NL+2,TwoSLdown,ILdown);
                         alpha = factor;
                         beta = 1.0; //add
-                        dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Bblock,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Bblock,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                      }
                   }
@@ -1893,12 +1893,12 @@ void CheMPS2::Heff::addDiagram4C1and4C2spin1(const int ikappa, double * memS, do
                            double * Lblock = Lright[l_index-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
                            double alpha = 1.0;
                            double beta = 0.0; //set
-                           dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
+                           planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
                      
                            double * Bblock = Bleft[l_index-theindex-1][1]->gStorage(NL,TwoSL,IL,NL+2,TwoSLdown,ILdown);
                            alpha = factor;
                            beta = 1.0; //add
-                           dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Bblock,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                           planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,Bblock,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                         }
                      }
@@ -1964,13 +1964,13 @@ void CheMPS2::Heff::addDiagram4C3and4C4spin0(const int ikappa, double * memS, do
                      double * Lblock = Lright[l_index-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
                      double alpha = 1.0;
                      double beta = 0.0; //set
-                     dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp,&dimLdown);
+                     planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp,&dimLdown);
                      
                      double * ptr = Cleft[l_index-theindex-1][1]->gStorage(NL,TwoSL,ILdown,NL,TwoSL,IL);
                   
                      alpha = factor;
                      beta = 1.0; //add
-                     dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                   }
                }
@@ -2009,13 +2009,13 @@ void CheMPS2::Heff::addDiagram4C3and4C4spin0(const int ikappa, double * memS, do
                         double * Lblock = Lright[l_index-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
                         double alpha = 1.0;
                         double beta = 0.0; //set
-                        dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp,&dimLdown);
                      
                         double * ptr = Cleft[l_index-theindex-1][1]->gStorage(NL,TwoSL,ILdown,NL,TwoSL,IL);
                   
                         alpha = factor;
                         beta = 1.0; //add
-                        dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                      }
                   }
@@ -2055,13 +2055,13 @@ void CheMPS2::Heff::addDiagram4C3and4C4spin0(const int ikappa, double * memS, do
                         double * Lblock = Lright[l_index-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
                         double alpha = 1.0;
                         double beta = 0.0; //set
-                        dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
                      
                         double * ptr = Cleft[l_index-theindex-1][1]->gStorage(NL,TwoSL,IL,NL,TwoSL,ILdown);
                   
                         alpha = factor;
                         beta = 1.0; //add
-                        dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                      }
                   }
@@ -2098,13 +2098,13 @@ void CheMPS2::Heff::addDiagram4C3and4C4spin0(const int ikappa, double * memS, do
                      double * Lblock = Lright[l_index-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
                      double alpha = 1.0;
                      double beta = 0.0; //set
-                     dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
+                     planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
                      
                      double * ptr = Cleft[l_index-theindex-1][1]->gStorage(NL,TwoSL,IL,NL,TwoSL,ILdown);
                   
                      alpha = factor;
                      beta = 1.0; //add
-                     dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                   }
                }
@@ -2170,13 +2170,13 @@ void CheMPS2::Heff::addDiagram4C3and4C4spin1(const int ikappa, double * memS, do
                         double * Lblock = Lright[l_index-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
                         double alpha = 1.0;
                         double beta = 0.0; //set
-                        dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp,&dimLdown);
                      
                         double * ptr = Dleft[l_index-theindex-1][1]->gStorage(NL,TwoSLdown,ILdown,NL,TwoSL,IL);
                         
                         alpha = factor;
                         beta = 1.0; //add
-                        dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                      }
                   }
@@ -2218,13 +2218,13 @@ void CheMPS2::Heff::addDiagram4C3and4C4spin1(const int ikappa, double * memS, do
                            double * Lblock = Lright[l_index-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
                            double alpha = 1.0;
                            double beta = 0.0; //set
-                           dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp,&dimLdown);
+                           planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRdown,&beta,temp,&dimLdown);
                      
                            double * ptr = Dleft[l_index-theindex-1][1]->gStorage(NL,TwoSLdown,ILdown,NL,TwoSL,IL);
                            
                            alpha = factor;
                            beta = 1.0; //add
-                           dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                           planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                         }
                      }
@@ -2267,13 +2267,13 @@ void CheMPS2::Heff::addDiagram4C3and4C4spin1(const int ikappa, double * memS, do
                            double * Lblock = Lright[l_index-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
                            double alpha = 1.0;
                            double beta = 0.0; //set
-                           dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
+                           planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
                      
                            double * ptr = Dleft[l_index-theindex-1][1]->gStorage(NL,TwoSL,IL,NL,TwoSLdown,ILdown);
                            
                            alpha = factor;
                            beta = 1.0; //add
-                           dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                           planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                         }
                      }
@@ -2313,13 +2313,13 @@ void CheMPS2::Heff::addDiagram4C3and4C4spin1(const int ikappa, double * memS, do
                         double * Lblock = Lright[l_index-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
                         double alpha = 1.0;
                         double beta = 0.0; //set
-                        dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,Lblock,&dimRup,&beta,temp,&dimLdown);
                      
                         double * ptr = Dleft[l_index-theindex-1][1]->gStorage(NL,TwoSL,IL,NL,TwoSLdown,ILdown);
                         
                         alpha = factor;
                         beta = 1.0; //add
-                        dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,ptr,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                      }
                   }
@@ -2374,14 +2374,14 @@ void CheMPS2::Heff::addDiagram4D(const int ikappa, double * memS, double * memHe
             if (dimLdown>0){
             
                int size = dimLup * dimLdown;
-               for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+               planClear(temp, size);
          
                int number = 0;
                for (int l_index=0; l_index<theindex; l_index++){
                   if (denBK->gIrrep(l_index) == denBK->gIrrep(theindex+1)){
                      double alpha = Prob->gMxElement(l_index,theindex+1,theindex,theindex);
                      double * Lblock = Lleft[theindex-1-l_index]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
-                     daxpy_(&size,&alpha,Lblock,&inc,temp,&inc);
+                     planDaxpy(&size,&alpha,Lblock,&inc,temp,&inc);
                      number++;
                   }
                }
@@ -2394,7 +2394,7 @@ void CheMPS2::Heff::addDiagram4D(const int ikappa, double * memS, double * memHe
                      factor = fase * sqrt((TwoSL+1.0)/(TwoSR+1.0));
                   }
                   int memSkappa = denS->gKappa(NL-1,TwoSLdown,ILdown,2,N2-1,TwoS2down,NR,TwoSR,IR);
-                  dgemm_(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,temp,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                  planDgemm(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,temp,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                }
             }
          }
@@ -2416,14 +2416,14 @@ void CheMPS2::Heff::addDiagram4D(const int ikappa, double * memS, double * memHe
             if (dimLdown>0){
             
                int size = dimLup * dimLdown;
-               for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+               planClear(temp, size);
          
                int number = 0;
                for (int l_index=0; l_index<theindex; l_index++){
                   if (denBK->gIrrep(l_index) == denBK->gIrrep(theindex+1)){
                      double alpha = Prob->gMxElement(l_index,theindex+1,theindex,theindex);
                      double * Lblock = Lleft[theindex-1-l_index]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
-                     daxpy_(&size,&alpha,Lblock,&inc,temp,&inc);
+                     planDaxpy(&size,&alpha,Lblock,&inc,temp,&inc);
                      number++;
                   }
                }
@@ -2436,7 +2436,7 @@ void CheMPS2::Heff::addDiagram4D(const int ikappa, double * memS, double * memHe
                      factor = fase * sqrt((TwoSLdown+1.0)/(TwoSR+1.0));
                   }
                   int memSkappa = denS->gKappa(NL+1,TwoSLdown,ILdown,0,N2+1,TwoS2down,NR,TwoSR,IR);
-                  dgemm_(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,temp,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                  planDgemm(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,temp,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                }
             }
          }
@@ -2461,7 +2461,7 @@ void CheMPS2::Heff::addDiagram4D(const int ikappa, double * memS, double * memHe
                if (abs(TwoSLdown-TwoSR)<=TwoJdown){
             
                   int size = dimLup * dimLdown;
-                  for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                  planClear(temp, size);
                
                   double alpha_fact = 0.0;
                   if ((N1==1) && (N2==0)){ //4D3A
@@ -2499,7 +2499,7 @@ void CheMPS2::Heff::addDiagram4D(const int ikappa, double * memS, double * memHe
                         }
                      
                         double * Lblock = Lleft[theindex-1-l_index]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
-                        daxpy_(&size,&alpha,Lblock,&inc,temp,&inc);
+                        planDaxpy(&size,&alpha,Lblock,&inc,temp,&inc);
                         number++;
                      }
                   }
@@ -2508,7 +2508,7 @@ void CheMPS2::Heff::addDiagram4D(const int ikappa, double * memS, double * memHe
             
                      double factor = 1.0;
                      int memSkappa = denS->gKappa(NL-1,TwoSLdown,ILdown,N1,N2+1,TwoJdown,NR,TwoSR,IR);
-                     dgemm_(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,temp,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&trans,&notrans,&dimLup,&dimR,&dimLdown,&factor,temp,&dimLdown,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   }
                }
             }
@@ -2536,7 +2536,7 @@ void CheMPS2::Heff::addDiagram4D(const int ikappa, double * memS, double * memHe
                if (abs(TwoSLdown-TwoSR)<=TwoJdown){
             
                   int size = dimLup * dimLdown;
-                  for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                  planClear(temp, size);
                
                   double alpha_fact = 0.0;
                   if ((N1==1) && (N2==1)){ //4D4A
@@ -2574,7 +2574,7 @@ void CheMPS2::Heff::addDiagram4D(const int ikappa, double * memS, double * memHe
                         }
                      
                         double * Lblock = Lleft[theindex-1-l_index]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
-                        daxpy_(&size,&alpha,Lblock,&inc,temp,&inc);
+                        planDaxpy(&size,&alpha,Lblock,&inc,temp,&inc);
                         number++;
                      }
                   }
@@ -2583,7 +2583,7 @@ void CheMPS2::Heff::addDiagram4D(const int ikappa, double * memS, double * memHe
             
                      double factor = 1.0;
                      int memSkappa = denS->gKappa(NL+1,TwoSLdown,ILdown,N1,N2-1,TwoJdown,NR,TwoSR,IR);
-                     dgemm_(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,temp,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&notrans,&notrans,&dimLup,&dimR,&dimLdown,&factor,temp,&dimLup,memS+denS->gKappa2index(memSkappa),&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   }
                }
             }
@@ -2656,24 +2656,24 @@ void CheMPS2::Heff::addDiagram4E(const int ikappa, double * memS, double * memHe
                            if (Irrep == denBK->gIrrep(l_alpha)){
                      
                               int size = dimRup * dimRdown;
-                              for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                              planClear(temp, size);
                               for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                                  if (Irrep == denBK->gIrrep(l_beta)){
                                     double * LblockRight = Lright[l_beta-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
                                     double prefact = Prob->gMxElement(l_alpha,l_beta,theindex,theindex);
-                                    daxpy_(&size,&prefact,LblockRight,&inc,temp,&inc);
+                                    planDaxpy(&size,&prefact,LblockRight,&inc,temp,&inc);
                                  }
                               }
                            
                               int memSkappa = denS->gKappa(NL-1,TwoSLdown,ILdown,2,N2,TwoS2,NR+1,TwoSRdown,IRdown);
                               double alpha = factor;
                               double beta = 0.0; //set
-                              dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
+                              planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
                            
                               alpha = 1.0;
                               beta = 1.0; //add
                               double * LblockLeft = Lleft[theindex-1-l_alpha]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
-                              dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockLeft,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                              planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockLeft,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                            }
                         }
                      }
@@ -2720,24 +2720,24 @@ void CheMPS2::Heff::addDiagram4E(const int ikappa, double * memS, double * memHe
                            if (Irrep == denBK->gIrrep(l_gamma)){
                      
                               int size = dimRup * dimRdown;
-                              for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                              planClear(temp, size);
                               for (int l_delta=theindex+2; l_delta<Prob->gL(); l_delta++){
                                  if (Irrep == denBK->gIrrep(l_delta)){
                                     double * LblockRight = Lright[l_delta-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
                                     double prefact = Prob->gMxElement(l_gamma,l_delta,theindex,theindex);
-                                    daxpy_(&size,&prefact,LblockRight,&inc,temp,&inc);
+                                    planDaxpy(&size,&prefact,LblockRight,&inc,temp,&inc);
                                  }
                               }
                            
                               int memSkappa = denS->gKappa(NL+1,TwoSLdown,ILdown,0,N2,TwoS2,NR-1,TwoSRdown,IRdown);
                               double alpha = factor;
                               double beta = 0.0; //set
-                              dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
+                              planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
                            
                               alpha = 1.0;
                               beta = 1.0; //add
                               double * LblockLeft = Lleft[theindex-1-l_gamma]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
-                              dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockLeft,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                              planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockLeft,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                            }
                         }
                      }
@@ -2793,24 +2793,24 @@ void CheMPS2::Heff::addDiagram4E(const int ikappa, double * memS, double * memHe
                               if (Irrep == denBK->gIrrep(l_alpha)){
                      
                                  int size = dimRup * dimRdown;
-                                 for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                                 planClear(temp, size);
                                  for (int l_delta=theindex+2; l_delta<Prob->gL(); l_delta++){
                                     if (Irrep == denBK->gIrrep(l_delta)){
                                        double * LblockRight = Lright[l_delta-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
                                        double prefact = factor1 * Prob->gMxElement(l_alpha,theindex,theindex,l_delta);
                                        if (TwoJ == TwoJdown){ prefact += factor2 * Prob->gMxElement(l_alpha,theindex,l_delta,theindex); }
-                                       daxpy_(&size,&prefact,LblockRight,&inc,temp,&inc);
+                                       planDaxpy(&size,&prefact,LblockRight,&inc,temp,&inc);
                                     }
                                  }
                            
                                  int memSkappa = denS->gKappa(NL-1,TwoSLdown,ILdown,1,N2,TwoJdown,NR-1,TwoSRdown,IRdown);
                                  double alpha = 1.0;
                                  double beta = 0.0; //set
-                                 dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
+                                 planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
                               
                                  beta = 1.0; //add
                                  double * LblockLeft = Lleft[theindex-1-l_alpha]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
-                                 dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockLeft,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                                 planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockLeft,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                               }
                            }
                         }
@@ -2858,24 +2858,24 @@ void CheMPS2::Heff::addDiagram4E(const int ikappa, double * memS, double * memHe
                            if (Irrep == denBK->gIrrep(l_alpha)){
                      
                               int size = dimRup * dimRdown;
-                              for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                              planClear(temp, size);
                               for (int l_delta=theindex+2; l_delta<Prob->gL(); l_delta++){
                                  if (Irrep == denBK->gIrrep(l_delta)){
                                     double * LblockRight = Lright[l_delta-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
                                     double prefact = Prob->gMxElement(l_alpha,theindex,theindex,l_delta) - 2 * Prob->gMxElement(l_alpha,theindex,l_delta,theindex);
-                                    daxpy_(&size,&prefact,LblockRight,&inc,temp,&inc);
+                                    planDaxpy(&size,&prefact,LblockRight,&inc,temp,&inc);
                                  }
                               }
                              
                               int memSkappa = denS->gKappa(NL-1,TwoSLdown,ILdown,2,N2,TwoS2,NR-1,TwoSRdown,IRdown);
                               double alpha = factor;
                               double beta = 0.0; //set
-                              dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
+                              planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
                               
                               alpha = 1.0;
                               beta = 1.0; //add
                               double * LblockLeft = Lleft[theindex-1-l_alpha]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
-                              dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockLeft,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                              planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockLeft,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                            }
                         }
                      }
@@ -2931,24 +2931,24 @@ void CheMPS2::Heff::addDiagram4E(const int ikappa, double * memS, double * memHe
                               if (Irrep == denBK->gIrrep(l_gamma)){
                         
                                  int size = dimRup * dimRdown;
-                                 for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                                 planClear(temp, size);
                                  for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                                     if (Irrep == denBK->gIrrep(l_beta)){
                                        double * LblockRight = Lright[l_beta-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
                                        double prefact = factor1 * Prob->gMxElement(l_gamma,theindex,theindex,l_beta);
                                        if (TwoJ == TwoJdown){ prefact += factor2 * Prob->gMxElement(l_gamma,theindex,l_beta,theindex); }
-                                       daxpy_(&size,&prefact,LblockRight,&inc,temp,&inc);
+                                       planDaxpy(&size,&prefact,LblockRight,&inc,temp,&inc);
                                     }
                                  }
                               
                                  int memSkappa = denS->gKappa(NL+1,TwoSLdown,ILdown,1,N2,TwoJdown,NR+1,TwoSRdown,IRdown);
                                  double alpha = 1.0;
                                  double beta = 0.0; //set
-                                 dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
+                                 planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
                                  
                                  beta = 1.0; //add
                                  double * LblockLeft = Lleft[theindex-1-l_gamma]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
-                                 dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockLeft,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                                 planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockLeft,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                               }
                            }
                         }
@@ -2996,24 +2996,24 @@ void CheMPS2::Heff::addDiagram4E(const int ikappa, double * memS, double * memHe
                            if (Irrep == denBK->gIrrep(l_gamma)){
                      
                               int size = dimRup * dimRdown;
-                              for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                              planClear(temp, size);
                               for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                                  if (Irrep == denBK->gIrrep(l_beta)){
                                     double * LblockRight = Lright[l_beta-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
                                     double prefact = Prob->gMxElement(l_gamma,theindex,theindex,l_beta) - 2 * Prob->gMxElement(l_gamma,theindex,l_beta,theindex);
-                                    daxpy_(&size,&prefact,LblockRight,&inc,temp,&inc);
+                                    planDaxpy(&size,&prefact,LblockRight,&inc,temp,&inc);
                                  }
                               }
                              
                               int memSkappa = denS->gKappa(NL+1,TwoSLdown,ILdown,2,N2,TwoS2,NR+1,TwoSRdown,IRdown);
                               double alpha = factor;
                               double beta = 0.0; //set
-                              dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
+                              planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
                               
                               alpha = 1.0;
                               beta = 1.0; //add
                               double * LblockLeft = Lleft[theindex-1-l_gamma]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
-                              dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockLeft,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                              planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockLeft,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                            }
                         }
                      }
@@ -3069,14 +3069,14 @@ void CheMPS2::Heff::addDiagram4F(const int ikappa, double * memS, double * memHe
             if (dimRdown>0){
                
                int size = dimRup * dimRdown;
-               for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+               planClear(temp, size);
             
                int number = 0;
                for (int l_index=theindex+2; l_index<Prob->gL(); l_index++){
                   if (denBK->gIrrep(l_index) == denBK->gIrrep(theindex+1)){
                      double alpha = Prob->gMxElement(theindex,theindex,theindex+1,l_index);
                      double * Lblock = Lright[l_index-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
-                     daxpy_(&size,&alpha,Lblock,&inc,temp,&inc);
+                     planDaxpy(&size,&alpha,Lblock,&inc,temp,&inc);
                      number++;
                   }
                }
@@ -3090,7 +3090,7 @@ void CheMPS2::Heff::addDiagram4F(const int ikappa, double * memS, double * memHe
                      factor = phase(TwoSR+1-TwoSRdown);
                   }
                   int memSkappa = denS->gKappa(NL,TwoSL,IL,0,N2+1,TwoS2down,NR-1,TwoSRdown,IRdown);
-                  dgemm_(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,temp,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                  planDgemm(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,temp,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
                }
             }
          }
@@ -3112,14 +3112,14 @@ void CheMPS2::Heff::addDiagram4F(const int ikappa, double * memS, double * memHe
             if (dimRdown>0){
                
                int size = dimRup * dimRdown;
-               for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+               planClear(temp, size);
             
                int number = 0;
                for (int l_index=theindex+2; l_index<Prob->gL(); l_index++){
                   if (denBK->gIrrep(l_index) == denBK->gIrrep(theindex+1)){
                      double alpha = Prob->gMxElement(theindex,theindex,theindex+1,l_index);
                      double * Lblock = Lright[l_index-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
-                     daxpy_(&size,&alpha,Lblock,&inc,temp,&inc);
+                     planDaxpy(&size,&alpha,Lblock,&inc,temp,&inc);
                      number++;
                   }
                }
@@ -3133,7 +3133,7 @@ void CheMPS2::Heff::addDiagram4F(const int ikappa, double * memS, double * memHe
                      factor = phase(TwoSRdown+1-TwoSR);
                   }
                   int memSkappa = denS->gKappa(NL,TwoSL,IL,2,N2-1,TwoS2down,NR+1,TwoSRdown,IRdown);
-                  dgemm_(&notrans,&trans,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,temp,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                  planDgemm(&notrans,&trans,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,temp,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
                }
             }
          }
@@ -3160,7 +3160,7 @@ void CheMPS2::Heff::addDiagram4F(const int ikappa, double * memS, double * memHe
                if (abs(TwoSL-TwoSRdown)<=TwoJdown){
                
                   int size = dimRup * dimRdown;
-                  for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                  planClear(temp, size);
                   
                   double factor = 0.0;
                   double factor2 = 0.0;
@@ -3198,7 +3198,7 @@ void CheMPS2::Heff::addDiagram4F(const int ikappa, double * memS, double * memHe
                         }
                         
                         double * Lblock = Lright[l_index-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
-                        daxpy_(&size,&prefact,Lblock,&inc,temp,&inc);
+                        planDaxpy(&size,&prefact,Lblock,&inc,temp,&inc);
                         number++;
                      }
                   }
@@ -3207,7 +3207,7 @@ void CheMPS2::Heff::addDiagram4F(const int ikappa, double * memS, double * memHe
                
                      double alpha = 1.0;
                      int memSkappa = denS->gKappa(NL,TwoSL,IL,N1,N2-1,TwoJdown,NR-1,TwoSRdown,IRdown);
-                     dgemm_(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,temp,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                     planDgemm(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,temp,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
             
                   }
                }
@@ -3236,7 +3236,7 @@ void CheMPS2::Heff::addDiagram4F(const int ikappa, double * memS, double * memHe
                if (abs(TwoSL-TwoSRdown)<=TwoJdown){
                
                   int size = dimRup * dimRdown;
-                  for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                  planClear(temp, size);
                   
                   double factor = 0.0;
                   double factor2 = 0.0;
@@ -3274,7 +3274,7 @@ void CheMPS2::Heff::addDiagram4F(const int ikappa, double * memS, double * memHe
                         }
                         
                         double * Lblock = Lright[l_index-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
-                        daxpy_(&size,&prefact,Lblock,&inc,temp,&inc);
+                        planDaxpy(&size,&prefact,Lblock,&inc,temp,&inc);
                         number++;
                      }
                   }
@@ -3283,7 +3283,7 @@ void CheMPS2::Heff::addDiagram4F(const int ikappa, double * memS, double * memHe
                
                      double alpha = 1.0;
                      int memSkappa = denS->gKappa(NL,TwoSL,IL,N1,N2+1,TwoJdown,NR+1,TwoSRdown,IRdown);
-                     dgemm_(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,temp,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                     planDgemm(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,temp,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
             
                   }
                }
@@ -3337,14 +3337,14 @@ void CheMPS2::Heff::addDiagram4G(const int ikappa, double * memS, double * memHe
             if (dimRdown>0){
                
                int size = dimRup * dimRdown;
-               for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+               planClear(temp, size);
             
                int number = 0;
                for (int l_index=theindex+2; l_index<Prob->gL(); l_index++){
                   if (denBK->gIrrep(l_index) == denBK->gIrrep(theindex)){
                      double alpha = Prob->gMxElement(theindex,l_index,theindex+1,theindex+1);
                      double * Lblock = Lright[l_index-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
-                     daxpy_(&size,&alpha,Lblock,&inc,temp,&inc);
+                     planDaxpy(&size,&alpha,Lblock,&inc,temp,&inc);
                      number++;
                   }
                }
@@ -3358,7 +3358,7 @@ void CheMPS2::Heff::addDiagram4G(const int ikappa, double * memS, double * memHe
                      factor = phase(TwoSR+1-TwoSRdown);
                   }
                   int memSkappa = denS->gKappa(NL,TwoSL,IL,N1+1,0,TwoS1down,NR-1,TwoSRdown,IRdown);
-                  dgemm_(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,temp,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                  planDgemm(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,temp,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
                }
             }
          }
@@ -3380,14 +3380,14 @@ void CheMPS2::Heff::addDiagram4G(const int ikappa, double * memS, double * memHe
             if (dimRdown>0){
                
                int size = dimRup * dimRdown;
-               for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+               planClear(temp, size);
             
                int number = 0;
                for (int l_index=theindex+2; l_index<Prob->gL(); l_index++){
                   if (denBK->gIrrep(l_index) == denBK->gIrrep(theindex)){
                      double alpha = Prob->gMxElement(theindex,l_index,theindex+1,theindex+1);
                      double * Lblock = Lright[l_index-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
-                     daxpy_(&size,&alpha,Lblock,&inc,temp,&inc);
+                     planDaxpy(&size,&alpha,Lblock,&inc,temp,&inc);
                      number++;
                   }
                }
@@ -3401,7 +3401,7 @@ void CheMPS2::Heff::addDiagram4G(const int ikappa, double * memS, double * memHe
                      factor = phase(TwoSRdown+1-TwoSR);
                   }
                   int memSkappa = denS->gKappa(NL,TwoSL,IL,N1-1,2,TwoS1down,NR+1,TwoSRdown,IRdown);
-                  dgemm_(&notrans,&trans,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,temp,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                  planDgemm(&notrans,&trans,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,temp,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
                   
                }
             }
@@ -3429,7 +3429,7 @@ void CheMPS2::Heff::addDiagram4G(const int ikappa, double * memS, double * memHe
                if (abs(TwoSL-TwoSRdown)<=TwoJdown){
                
                   int size = dimRup * dimRdown;
-                  for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                  planClear(temp, size);
                
                   double alpha_prefact = 0.0;
                   double alpha_prefact2 = 0.0;
@@ -3466,7 +3466,7 @@ void CheMPS2::Heff::addDiagram4G(const int ikappa, double * memS, double * memHe
                         }
                         
                         double * Lblock = Lright[l_index-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
-                        daxpy_(&size,&alpha,Lblock,&inc,temp,&inc);
+                        planDaxpy(&size,&alpha,Lblock,&inc,temp,&inc);
                         number++;
                      }
                   }
@@ -3475,7 +3475,7 @@ void CheMPS2::Heff::addDiagram4G(const int ikappa, double * memS, double * memHe
                
                      double factor = 1.0;
                      int memSkappa = denS->gKappa(NL,TwoSL,IL,N1+1,N2,TwoJdown,NR+1,TwoSRdown,IRdown);
-                     dgemm_(&notrans,&trans,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,temp,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                     planDgemm(&notrans,&trans,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,temp,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
                   }
                }
             }
@@ -3503,7 +3503,7 @@ void CheMPS2::Heff::addDiagram4G(const int ikappa, double * memS, double * memHe
                if (abs(TwoSL-TwoSRdown)<=TwoJdown){
             
                   int size = dimRup * dimRdown;
-                  for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                  planClear(temp, size);
                
                   double alpha_prefact = 0.0;
                   double alpha_prefact2 = 0.0;
@@ -3540,7 +3540,7 @@ void CheMPS2::Heff::addDiagram4G(const int ikappa, double * memS, double * memHe
                         }
                         
                         double * Lblock = Lright[l_index-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
-                        daxpy_(&size,&alpha,Lblock,&inc,temp,&inc);
+                        planDaxpy(&size,&alpha,Lblock,&inc,temp,&inc);
                         number++;
                      }
                   }
@@ -3549,7 +3549,7 @@ void CheMPS2::Heff::addDiagram4G(const int ikappa, double * memS, double * memHe
                
                      double factor = 1.0;
                      int memSkappa = denS->gKappa(NL,TwoSL,IL,N1-1,N2,TwoJdown,NR-1,TwoSRdown,IRdown);
-                     dgemm_(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,temp,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
+                     planDgemm(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&factor,memS+denS->gKappa2index(memSkappa),&dimL,temp,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimL);
             
                   }
                }
@@ -3622,14 +3622,14 @@ void CheMPS2::Heff::addDiagram4H(const int ikappa, double * memS, double * memHe
                            if (Irrep == denBK->gIrrep(l_gamma)){
                               
                               int size = dimRup * dimRdown;
-                              for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                              planClear(temp, size);
                               
                               for (int l_delta=theindex+2; l_delta<Prob->gL(); l_delta++){
                                  if (Irrep == denBK->gIrrep(l_delta)){
                                     double fact = factor * Prob->gMxElement(l_gamma,l_delta,theindex+1,theindex+1);
                                     double * LblockR = Lright[l_delta-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
                                     int inc = 1;
-                                    daxpy_(&size,&fact,LblockR,&inc,temp,&inc);
+                                    planDaxpy(&size,&fact,LblockR,&inc,temp,&inc);
                                  }
                               }
                               
@@ -3638,10 +3638,10 @@ void CheMPS2::Heff::addDiagram4H(const int ikappa, double * memS, double * memHe
                               double * LblockL = Lleft[theindex-1-l_gamma]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
                               
                               int memSkappa = denS->gKappa(NL+1,TwoSLdown,ILdown,N1,0,TwoS1,NR-1,TwoSRdown,IRdown);
-                              dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta, temp2,&dimLdown);
+                              planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta, temp2,&dimLdown);
                               
                               beta = 1.0; //add
-                              dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                              planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                               
                            }
                         }
@@ -3689,14 +3689,14 @@ void CheMPS2::Heff::addDiagram4H(const int ikappa, double * memS, double * memHe
                            if (Irrep == denBK->gIrrep(l_alpha)){
                               
                               int size = dimRup * dimRdown;
-                              for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                              planClear(temp, size);
                               
                               for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                                  if (Irrep == denBK->gIrrep(l_beta)){
                                     double fact = factor * Prob->gMxElement(l_alpha,l_beta,theindex+1,theindex+1);
                                     double * LblockR = Lright[l_beta-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
                                     int inc = 1;
-                                    daxpy_(&size,&fact,LblockR,&inc,temp,&inc);
+                                    planDaxpy(&size,&fact,LblockR,&inc,temp,&inc);
                                  }
                               }
                               
@@ -3705,10 +3705,10 @@ void CheMPS2::Heff::addDiagram4H(const int ikappa, double * memS, double * memHe
                               double * LblockL = Lleft[theindex-1-l_alpha]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
                               
                               int memSkappa = denS->gKappa(NL-1,TwoSLdown,ILdown,N1,2,TwoS1,NR+1,TwoSRdown,IRdown);
-                              dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta, temp2,&dimLdown);
+                              planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta, temp2,&dimLdown);
                               
                               beta = 1.0; //add
-                              dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                              planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                               
                            }
                         }
@@ -3765,7 +3765,7 @@ void CheMPS2::Heff::addDiagram4H(const int ikappa, double * memS, double * memHe
                               if (Irrep == denBK->gIrrep(l_alpha)){
                               
                                  int size = dimRup * dimRdown;
-                                 for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                                 planClear(temp, size);
                               
                                  for (int l_delta=theindex+2; l_delta<Prob->gL(); l_delta++){
                                     if (Irrep == denBK->gIrrep(l_delta)){
@@ -3773,7 +3773,7 @@ void CheMPS2::Heff::addDiagram4H(const int ikappa, double * memS, double * memHe
                                        if (TwoJ==TwoJdown){ fact += factor2 * Prob->gMxElement(l_alpha,theindex+1,l_delta,theindex+1); }
                                        double * LblockR = Lright[l_delta-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
                                        int inc = 1;
-                                       daxpy_(&size,&fact,LblockR,&inc,temp,&inc);
+                                       planDaxpy(&size,&fact,LblockR,&inc,temp,&inc);
                                     }
                                  }
                               
@@ -3782,10 +3782,10 @@ void CheMPS2::Heff::addDiagram4H(const int ikappa, double * memS, double * memHe
                                  double * LblockL = Lleft[theindex-1-l_alpha]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
                               
                                  int memSkappa = denS->gKappa(NL-1,TwoSLdown,ILdown,N1,1,TwoJdown,NR-1,TwoSRdown,IRdown);
-                                 dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta, temp2,&dimLdown);
+                                 planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta, temp2,&dimLdown);
                               
                                  beta = 1.0; //add
-                                 dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                                 planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                               
                               }
                            }
@@ -3834,14 +3834,14 @@ void CheMPS2::Heff::addDiagram4H(const int ikappa, double * memS, double * memHe
                            if (Irrep == denBK->gIrrep(l_alpha)){
                               
                               int size = dimRup * dimRdown;
-                              for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                              planClear(temp, size);
                               
                               for (int l_delta=theindex+2; l_delta<Prob->gL(); l_delta++){
                                  if (Irrep == denBK->gIrrep(l_delta)){
                                     double fact = factor * ( Prob->gMxElement(l_alpha,theindex+1,theindex+1,l_delta) - 2 * Prob->gMxElement(l_alpha,theindex+1,l_delta,theindex+1) );
                                     double * LblockR = Lright[l_delta-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
                                     int inc = 1;
-                                    daxpy_(&size,&fact,LblockR,&inc,temp,&inc);
+                                    planDaxpy(&size,&fact,LblockR,&inc,temp,&inc);
                                  }
                               }
                               
@@ -3850,10 +3850,10 @@ void CheMPS2::Heff::addDiagram4H(const int ikappa, double * memS, double * memHe
                               double * LblockL = Lleft[theindex-1-l_alpha]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
                               
                               int memSkappa = denS->gKappa(NL-1,TwoSLdown,ILdown,N1,2,TwoS1,NR-1,TwoSRdown,IRdown);
-                              dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta, temp2,&dimLdown);
+                              planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta, temp2,&dimLdown);
                               
                               beta = 1.0; //add
-                              dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                              planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                               
                            }
                         }
@@ -3910,7 +3910,7 @@ void CheMPS2::Heff::addDiagram4H(const int ikappa, double * memS, double * memHe
                               if (Irrep == denBK->gIrrep(l_gamma)){
                               
                                  int size = dimRup * dimRdown;
-                                 for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                                 planClear(temp, size);
                               
                                  for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                                     if (Irrep == denBK->gIrrep(l_beta)){
@@ -3918,7 +3918,7 @@ void CheMPS2::Heff::addDiagram4H(const int ikappa, double * memS, double * memHe
                                        if (TwoJ==TwoJdown){ fact += factor2 * Prob->gMxElement(l_gamma,theindex+1,l_beta,theindex+1); }
                                        double * LblockR = Lright[l_beta-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
                                        int inc = 1;
-                                       daxpy_(&size,&fact,LblockR,&inc,temp,&inc);
+                                       planDaxpy(&size,&fact,LblockR,&inc,temp,&inc);
                                     }
                                  }
                               
@@ -3927,10 +3927,10 @@ void CheMPS2::Heff::addDiagram4H(const int ikappa, double * memS, double * memHe
                                  double * LblockL = Lleft[theindex-1-l_gamma]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
                               
                                  int memSkappa = denS->gKappa(NL+1,TwoSLdown,ILdown,N1,1,TwoJdown,NR+1,TwoSRdown,IRdown);
-                                 dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta, temp2,&dimLdown);
+                                 planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta, temp2,&dimLdown);
                               
                                  beta = 1.0; //add
-                                 dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                                 planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                               
                               }
                            }
@@ -3979,14 +3979,14 @@ void CheMPS2::Heff::addDiagram4H(const int ikappa, double * memS, double * memHe
                            if (Irrep == denBK->gIrrep(l_gamma)){
                               
                               int size = dimRup * dimRdown;
-                              for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                              planClear(temp, size);
                               
                               for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                                  if (Irrep == denBK->gIrrep(l_beta)){
                                     double fact = factor * ( Prob->gMxElement(l_gamma,theindex+1,theindex+1,l_beta) - 2 * Prob->gMxElement(l_gamma,theindex+1,l_beta,theindex+1) );
                                     double * LblockR = Lright[l_beta-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
                                     int inc = 1;
-                                    daxpy_(&size,&fact,LblockR,&inc,temp,&inc);
+                                    planDaxpy(&size,&fact,LblockR,&inc,temp,&inc);
                                  }
                               }
                               
@@ -3995,10 +3995,10 @@ void CheMPS2::Heff::addDiagram4H(const int ikappa, double * memS, double * memHe
                               double * LblockL = Lleft[theindex-1-l_gamma]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
                               
                               int memSkappa = denS->gKappa(NL+1,TwoSLdown,ILdown,N1,2,TwoS1,NR+1,TwoSRdown,IRdown);
-                              dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta, temp2,&dimLdown);
+                              planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta, temp2,&dimLdown);
                               
                               beta = 1.0; //add
-                              dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                              planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                               
                            }
                         }
@@ -4055,7 +4055,7 @@ void CheMPS2::Heff::addDiagram4I(const int ikappa, double * memS, double * memHe
             if (dimLdown>0){
                
                int size = dimLdown * dimLup;
-               for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+               planClear(temp, size);
                
                int number = 0;
                for (int l_index=0; l_index<theindex; l_index++){
@@ -4063,7 +4063,7 @@ void CheMPS2::Heff::addDiagram4I(const int ikappa, double * memS, double * memHe
                      number++;
                      double alpha = Prob->gMxElement(l_index,theindex,theindex+1,theindex+1);
                      double * Lblock = Lleft[theindex-1-l_index]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
-                     daxpy_(&size,&alpha,Lblock,&inc,temp,&inc);
+                     planDaxpy(&size,&alpha,Lblock,&inc,temp,&inc);
                   }
                }
                
@@ -4075,7 +4075,7 @@ void CheMPS2::Heff::addDiagram4I(const int ikappa, double * memS, double * memHe
                      factor = fase * sqrt((TwoSL+1.0)/(TwoSR+1.0));
                   }
                   int memSkappa = denS->gKappa(NL-1, TwoSLdown, ILdown, N1-1, 2, TwoJdown, NR, TwoSR, IR);
-                  dgemm_(&trans, &notrans, &dimLup, &dimR, &dimLdown, &factor, temp, &dimLdown, memS+denS->gKappa2index(memSkappa), &dimLdown, &beta, memHeff+denS->gKappa2index(ikappa), &dimLup);
+                  planDgemm(&trans, &notrans, &dimLup, &dimR, &dimLdown, &factor, temp, &dimLdown, memS+denS->gKappa2index(memSkappa), &dimLdown, &beta, memHeff+denS->gKappa2index(ikappa), &dimLup);
                }
             }
          }
@@ -4097,7 +4097,7 @@ void CheMPS2::Heff::addDiagram4I(const int ikappa, double * memS, double * memHe
             if (dimLdown>0){
                
                int size = dimLdown * dimLup;
-               for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+               planClear(temp, size);
                
                int number = 0;
                for (int l_index=0; l_index<theindex; l_index++){
@@ -4105,7 +4105,7 @@ void CheMPS2::Heff::addDiagram4I(const int ikappa, double * memS, double * memHe
                      number++;
                      double alpha = Prob->gMxElement(l_index,theindex,theindex+1,theindex+1);
                      double * Lblock = Lleft[theindex-1-l_index]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
-                     daxpy_(&size,&alpha,Lblock,&inc,temp,&inc);
+                     planDaxpy(&size,&alpha,Lblock,&inc,temp,&inc);
                   }
                }
                
@@ -4117,7 +4117,7 @@ void CheMPS2::Heff::addDiagram4I(const int ikappa, double * memS, double * memHe
                      factor = fase * sqrt((TwoSLdown+1.0)/(TwoSR+1.0));
                   }
                   int memSkappa = denS->gKappa(NL+1, TwoSLdown, ILdown, N1+1, 0, TwoJdown, NR, TwoSR, IR);
-                  dgemm_(&notrans, &notrans, &dimLup, &dimR, &dimLdown, &factor, temp, &dimLup, memS+denS->gKappa2index(memSkappa), &dimLdown, &beta, memHeff+denS->gKappa2index(ikappa), &dimLup);
+                  planDgemm(&notrans, &notrans, &dimLup, &dimR, &dimLdown, &factor, temp, &dimLup, memS+denS->gKappa2index(memSkappa), &dimLdown, &beta, memHeff+denS->gKappa2index(ikappa), &dimLup);
                }
             }
          }
@@ -4144,7 +4144,7 @@ void CheMPS2::Heff::addDiagram4I(const int ikappa, double * memS, double * memHe
                if (abs(TwoSLdown-TwoSR)<=TwoJdown){
             
                   int size = dimLdown * dimLup;
-                  for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                  planClear(temp, size);
                   
                   double prefact = 0.0;
                   if ((N1==0)&&(N2==1)){
@@ -4182,7 +4182,7 @@ void CheMPS2::Heff::addDiagram4I(const int ikappa, double * memS, double * memHe
                         }
                         
                         double * Lblock = Lleft[theindex-1-l_index]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
-                        daxpy_(&size,&alpha,Lblock,&inc,temp,&inc);
+                        planDaxpy(&size,&alpha,Lblock,&inc,temp,&inc);
                      }
                   }
                
@@ -4190,7 +4190,7 @@ void CheMPS2::Heff::addDiagram4I(const int ikappa, double * memS, double * memHe
       
                      double factor = 1.0;
                      int memSkappa = denS->gKappa(NL-1, TwoSLdown, ILdown, N1+1, N2, TwoJdown, NR, TwoSR, IR);
-                     dgemm_(&trans, &notrans, &dimLup, &dimR, &dimLdown, &factor, temp, &dimLdown, memS+denS->gKappa2index(memSkappa), &dimLdown, &beta, memHeff+denS->gKappa2index(ikappa), &dimLup);
+                     planDgemm(&trans, &notrans, &dimLup, &dimR, &dimLdown, &factor, temp, &dimLdown, memS+denS->gKappa2index(memSkappa), &dimLdown, &beta, memHeff+denS->gKappa2index(ikappa), &dimLup);
                   }
                }   
             }
@@ -4218,7 +4218,7 @@ void CheMPS2::Heff::addDiagram4I(const int ikappa, double * memS, double * memHe
                if (abs(TwoSLdown-TwoSR)<=TwoJdown){
                
                   int size = dimLdown * dimLup;
-                  for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                  planClear(temp, size);
                   
                   double prefact = 0.0;
                   if ((N1==1)&&(N2==1)){
@@ -4256,7 +4256,7 @@ void CheMPS2::Heff::addDiagram4I(const int ikappa, double * memS, double * memHe
                         }
                         
                         double * Lblock = Lleft[theindex-1-l_index]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
-                        daxpy_(&size,&alpha,Lblock,&inc,temp,&inc);
+                        planDaxpy(&size,&alpha,Lblock,&inc,temp,&inc);
                      }
                   }
                
@@ -4264,7 +4264,7 @@ void CheMPS2::Heff::addDiagram4I(const int ikappa, double * memS, double * memHe
       
                      double factor = 1.0;
                      int memSkappa = denS->gKappa(NL+1, TwoSLdown, ILdown, N1-1, N2, TwoJdown, NR, TwoSR, IR);
-                     dgemm_(&notrans, &notrans, &dimLup, &dimR, &dimLdown, &factor, temp, &dimLup, memS+denS->gKappa2index(memSkappa), &dimLdown, &beta, memHeff+denS->gKappa2index(ikappa), &dimLup);
+                     planDgemm(&notrans, &notrans, &dimLup, &dimR, &dimLdown, &factor, temp, &dimLup, memS+denS->gKappa2index(memSkappa), &dimLdown, &beta, memHeff+denS->gKappa2index(ikappa), &dimLup);
                   }
                }   
             }
@@ -4306,7 +4306,7 @@ void CheMPS2::Heff::addDiagram4J1and4J2spin0(const int ikappa, double * memS, do
          double alpha = 1.0;
          double beta = 1.0;
          double * Ablock = Aright->gStorage(NR,TwoSR,IR,NR+2,TwoSR,IRdown);
-         dgemm_(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Ablock,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+         planDgemm(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Ablock,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
       
       }
    }
@@ -4321,7 +4321,7 @@ void CheMPS2::Heff::addDiagram4J1and4J2spin0(const int ikappa, double * memS, do
          double alpha = - sqrt(0.5);
          double beta = 1.0;
          double * Ablock = Aright->gStorage(NR,TwoSR,IR,NR+2,TwoSR,IRdown);
-         dgemm_(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Ablock,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+         planDgemm(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Ablock,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
       
       }
    }
@@ -4336,7 +4336,7 @@ void CheMPS2::Heff::addDiagram4J1and4J2spin0(const int ikappa, double * memS, do
          double alpha = - sqrt(0.5);
          double beta = 1.0;
          double * Ablock = Aright->gStorage(NR,TwoSR,IR,NR+2,TwoSR,IRdown);
-         dgemm_(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Ablock,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+         planDgemm(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Ablock,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
       
       }
    }
@@ -4351,7 +4351,7 @@ void CheMPS2::Heff::addDiagram4J1and4J2spin0(const int ikappa, double * memS, do
          double alpha = -1.0;
          double beta = 1.0;
          double * Ablock = Aright->gStorage(NR,TwoSR,IR,NR+2,TwoSR,IRdown);
-         dgemm_(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Ablock,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+         planDgemm(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Ablock,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
       
       }
       
@@ -4362,7 +4362,7 @@ void CheMPS2::Heff::addDiagram4J1and4J2spin0(const int ikappa, double * memS, do
          double alpha = 1.0;
          double beta = 1.0;
          double * Ablock = Aright->gStorage(NR-2,TwoSR,IRdown,NR,TwoSR,IR);
-         dgemm_(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Ablock,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+         planDgemm(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Ablock,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
       
       }
    }
@@ -4377,7 +4377,7 @@ void CheMPS2::Heff::addDiagram4J1and4J2spin0(const int ikappa, double * memS, do
          double alpha = - sqrt(0.5);
          double beta = 1.0;
          double * Ablock = Aright->gStorage(NR-2,TwoSR,IRdown,NR,TwoSR,IR);
-         dgemm_(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Ablock,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+         planDgemm(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Ablock,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
       
       }
    }
@@ -4392,7 +4392,7 @@ void CheMPS2::Heff::addDiagram4J1and4J2spin0(const int ikappa, double * memS, do
          double alpha = - sqrt(0.5);
          double beta = 1.0;
          double * Ablock = Aright->gStorage(NR-2,TwoSR,IRdown,NR,TwoSR,IR);
-         dgemm_(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Ablock,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+         planDgemm(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Ablock,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
       
       }
    }
@@ -4407,7 +4407,7 @@ void CheMPS2::Heff::addDiagram4J1and4J2spin0(const int ikappa, double * memS, do
          double alpha = -1.0;
          double beta = 1.0;
          double * Ablock = Aright->gStorage(NR-2,TwoSR,IRdown,NR,TwoSR,IR);
-         dgemm_(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Ablock,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+         planDgemm(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Ablock,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
       
       }
    }
@@ -4448,7 +4448,7 @@ void CheMPS2::Heff::addDiagram4J1and4J2spin1(const int ikappa, double * memS, do
             double alpha = sqrt((TwoSRdown+1.0)/(TwoSR+1.0));
             double beta = 1.0;
             double * Bblock = Bright->gStorage(NR,TwoSR,IR,NR+2,TwoSRdown,IRdown);
-            dgemm_(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Bblock,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+            planDgemm(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Bblock,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
          
          }
       }
@@ -4468,7 +4468,7 @@ void CheMPS2::Heff::addDiagram4J1and4J2spin1(const int ikappa, double * memS, do
                double alpha = fase * sqrt(3.0 * (TwoSRdown+1)) * Wigner::wigner6j(1,1,2,TwoSR,TwoSRdown,TwoSL);
                double beta = 1.0;
                double * Bblock = Bright->gStorage(NR,TwoSR,IR,NR+2,TwoSRdown,IRdown);
-               dgemm_(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Bblock,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+               planDgemm(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Bblock,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
             }
          }
       }
@@ -4488,7 +4488,7 @@ void CheMPS2::Heff::addDiagram4J1and4J2spin1(const int ikappa, double * memS, do
                double alpha = fase * sqrt(3.0 * (TwoSRdown+1)) * Wigner::wigner6j(1,1,2,TwoSR,TwoSRdown,TwoSL);
                double beta = 1.0;
                double * Bblock = Bright->gStorage(NR,TwoSR,IR,NR+2,TwoSRdown,IRdown);
-               dgemm_(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Bblock,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+               planDgemm(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Bblock,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
             }
          }
       }
@@ -4506,7 +4506,7 @@ void CheMPS2::Heff::addDiagram4J1and4J2spin1(const int ikappa, double * memS, do
          double alpha = phase(TwoSR-TwoSRdown);
          double beta = 1.0;
          double * Bblock = Bright->gStorage(NR,TwoSR,IR,NR+2,TwoSRdown,IRdown);
-         dgemm_(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Bblock,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+         planDgemm(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Bblock,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
       
       }
 
@@ -4518,7 +4518,7 @@ void CheMPS2::Heff::addDiagram4J1and4J2spin1(const int ikappa, double * memS, do
          double alpha = sqrt((TwoSR+1.0)/(TwoSRdown+1.0));
          double beta = 1.0;
          double * Bblock = Bright->gStorage(NR-2,TwoSRdown,IRdown,NR,TwoSR,IR);
-         dgemm_(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Bblock,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+         planDgemm(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Bblock,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
          
       }
 
@@ -4538,7 +4538,7 @@ void CheMPS2::Heff::addDiagram4J1and4J2spin1(const int ikappa, double * memS, do
                double alpha = fase * sqrt(3.0 * (TwoSR+1)) * Wigner::wigner6j(1,1,2,TwoSRdown,TwoSR,TwoSL);
                double beta = 1.0;
                double * Bblock = Bright->gStorage(NR-2,TwoSRdown,IRdown,NR,TwoSR,IR);
-               dgemm_(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Bblock,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+               planDgemm(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Bblock,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
             }
          }
       }
@@ -4558,7 +4558,7 @@ void CheMPS2::Heff::addDiagram4J1and4J2spin1(const int ikappa, double * memS, do
                double alpha = fase * sqrt(3.0 * (TwoSR+1)) * Wigner::wigner6j(1,1,2,TwoSRdown,TwoSR,TwoSL);
                double beta = 1.0;
                double * Bblock = Bright->gStorage(NR-2,TwoSRdown,IRdown,NR,TwoSR,IR);
-               dgemm_(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Bblock,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+               planDgemm(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Bblock,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
             
             }
          }
@@ -4577,7 +4577,7 @@ void CheMPS2::Heff::addDiagram4J1and4J2spin1(const int ikappa, double * memS, do
             double alpha = phase(TwoSR-TwoSRdown);
             double beta = 1.0;
             double * Bblock = Bright->gStorage(NR-2,TwoSRdown,IRdown,NR,TwoSR,IR);
-            dgemm_(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Bblock,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+            planDgemm(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,Bblock,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
       
          }
       }
@@ -4619,7 +4619,7 @@ void CheMPS2::Heff::addDiagram4J3and4J4spin0(const int ikappa, double * memS, do
          double beta = 1.0;
          double * ptr = Cright->gStorage(NR,TwoSR,IRdown,NR,TwoSR,IR);
          
-         dgemm_(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+         planDgemm(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
          
       }
    
@@ -4631,7 +4631,7 @@ void CheMPS2::Heff::addDiagram4J3and4J4spin0(const int ikappa, double * memS, do
          double beta = 1.0;
          double * ptr = Cright->gStorage(NR,TwoSR,IRdown,NR,TwoSR,IR);
          
-         dgemm_(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+         planDgemm(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
       
       }
    
@@ -4643,7 +4643,7 @@ void CheMPS2::Heff::addDiagram4J3and4J4spin0(const int ikappa, double * memS, do
          double beta = 1.0;
          double * ptr = Cright->gStorage(NR,TwoSR,IRdown,NR,TwoSR,IR);
          
-         dgemm_(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+         planDgemm(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
       
       }
    
@@ -4655,7 +4655,7 @@ void CheMPS2::Heff::addDiagram4J3and4J4spin0(const int ikappa, double * memS, do
          double beta = 1.0;
          double * ptr = Cright->gStorage(NR,TwoSR,IRdown,NR,TwoSR,IR);
          
-         dgemm_(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+         planDgemm(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
       
       }
 
@@ -4667,7 +4667,7 @@ void CheMPS2::Heff::addDiagram4J3and4J4spin0(const int ikappa, double * memS, do
          double beta = 1.0;
          double * ptr = Cright->gStorage(NR,TwoSR,IR,NR,TwoSR,IRdown);
          
-         dgemm_(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+         planDgemm(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
       
       }
    
@@ -4679,7 +4679,7 @@ void CheMPS2::Heff::addDiagram4J3and4J4spin0(const int ikappa, double * memS, do
          double beta = 1.0;
          double * ptr = Cright->gStorage(NR,TwoSR,IR,NR,TwoSR,IRdown);
          
-         dgemm_(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+         planDgemm(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
       
       }
 
@@ -4691,7 +4691,7 @@ void CheMPS2::Heff::addDiagram4J3and4J4spin0(const int ikappa, double * memS, do
          double beta = 1.0;
          double * ptr = Cright->gStorage(NR,TwoSR,IR,NR,TwoSR,IRdown);
          
-         dgemm_(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+         planDgemm(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
       
       }
    
@@ -4703,7 +4703,7 @@ void CheMPS2::Heff::addDiagram4J3and4J4spin0(const int ikappa, double * memS, do
          double beta = 1.0;
          double * ptr = Cright->gStorage(NR,TwoSR,IR,NR,TwoSR,IRdown);
          
-         dgemm_(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+         planDgemm(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
       
       }
    
@@ -4748,7 +4748,7 @@ void CheMPS2::Heff::addDiagram4J3and4J4spin1(const int ikappa, double * memS, do
             double beta = 1.0;
             double * ptr = Dright->gStorage(NR,TwoSRdown,IRdown,NR,TwoSR,IR);
          
-            dgemm_(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+            planDgemm(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
          
          }
    
@@ -4760,7 +4760,7 @@ void CheMPS2::Heff::addDiagram4J3and4J4spin1(const int ikappa, double * memS, do
             double beta = 1.0;
             double * ptr = Dright->gStorage(NR,TwoSRdown,IRdown,NR,TwoSR,IR);
          
-            dgemm_(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+            planDgemm(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
       
          }
    
@@ -4772,7 +4772,7 @@ void CheMPS2::Heff::addDiagram4J3and4J4spin1(const int ikappa, double * memS, do
             double beta = 1.0;
             double * ptr = Dright->gStorage(NR,TwoSRdown,IRdown,NR,TwoSR,IR);
          
-            dgemm_(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+            planDgemm(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
       
          }
    
@@ -4785,7 +4785,7 @@ void CheMPS2::Heff::addDiagram4J3and4J4spin1(const int ikappa, double * memS, do
             double beta = 1.0;
             double * ptr = Dright->gStorage(NR,TwoSRdown,IRdown,NR,TwoSR,IR);
          
-            dgemm_(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+            planDgemm(&notrans,&notrans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRdown,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
       
          }
 
@@ -4798,7 +4798,7 @@ void CheMPS2::Heff::addDiagram4J3and4J4spin1(const int ikappa, double * memS, do
             double beta = 1.0;
             double * ptr = Dright->gStorage(NR,TwoSR,IR,NR,TwoSRdown,IRdown);
          
-            dgemm_(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+            planDgemm(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
       
          }
    
@@ -4810,7 +4810,7 @@ void CheMPS2::Heff::addDiagram4J3and4J4spin1(const int ikappa, double * memS, do
             double beta = 1.0;
             double * ptr = Dright->gStorage(NR,TwoSR,IR,NR,TwoSRdown,IRdown);
          
-            dgemm_(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+            planDgemm(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
       
          }
 
@@ -4822,7 +4822,7 @@ void CheMPS2::Heff::addDiagram4J3and4J4spin1(const int ikappa, double * memS, do
             double beta = 1.0;
             double * ptr = Dright->gStorage(NR,TwoSR,IR,NR,TwoSRdown,IRdown);
          
-            dgemm_(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+            planDgemm(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
       
          }
    
@@ -4835,7 +4835,7 @@ void CheMPS2::Heff::addDiagram4J3and4J4spin1(const int ikappa, double * memS, do
             double beta = 1.0;
             double * ptr = Dright->gStorage(NR,TwoSR,IR,NR,TwoSRdown,IRdown);
          
-            dgemm_(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
+            planDgemm(&notrans,&trans,&dimL,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimL,ptr,&dimRup,&beta,memHeff+denS->gKappa2index(ikappa), &dimL);
       
          }
       }
@@ -4897,13 +4897,13 @@ void CheMPS2::Heff::addDiagram4K1and4K2spin0(const int ikappa, double * memS, do
                      double beta = 0.0; //set
                      double alpha = factor;
                      
-                     dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockA,&dimRdown,&beta,temp,&dimLdown);
+                     planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockA,&dimRdown,&beta,temp,&dimLdown);
                      
                      beta = 1.0; //add
                      alpha = 1.0;
                      double * blockL = Lleft[theindex-1-l_index]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
                      
-                     dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                   }
                }
@@ -4942,13 +4942,13 @@ void CheMPS2::Heff::addDiagram4K1and4K2spin0(const int ikappa, double * memS, do
                         double beta = 0.0; //set
                         double alpha = factor;
                      
-                        dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockA,&dimRdown,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockA,&dimRdown,&beta,temp,&dimLdown);
                      
                         beta = 1.0; //add
                         alpha = 1.0;
                         double * blockL = Lleft[theindex-1-l_index]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
                      
-                        dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                         
                      }
                   }
@@ -4988,13 +4988,13 @@ void CheMPS2::Heff::addDiagram4K1and4K2spin0(const int ikappa, double * memS, do
                         double beta = 0.0; //set
                         double alpha = factor;
                      
-                        dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockA,&dimRup,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockA,&dimRup,&beta,temp,&dimLdown);
                      
                         beta = 1.0; //add
                         alpha = 1.0;
                         double * blockL = Lleft[theindex-1-l_index]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
                      
-                        dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                      
                      }
                   }
@@ -5031,13 +5031,13 @@ void CheMPS2::Heff::addDiagram4K1and4K2spin0(const int ikappa, double * memS, do
                      double beta = 0.0; //set
                      double alpha = factor;
                      
-                     dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockA,&dimRup,&beta,temp,&dimLdown);
+                     planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockA,&dimRup,&beta,temp,&dimLdown);
                      
                      beta = 1.0; //add
                      alpha = 1.0;
                      double * blockL = Lleft[theindex-1-l_index]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
                      
-                     dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                   }
                }
@@ -5102,13 +5102,13 @@ void CheMPS2::Heff::addDiagram4L1and4L2spin0(const int ikappa, double * memS, do
                      double beta = 0.0; //set
                      double alpha = factor;
                      
-                     dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockA,&dimRdown,&beta,temp,&dimLdown);
+                     planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockA,&dimRdown,&beta,temp,&dimLdown);
                      
                      beta = 1.0; //add
                      alpha = 1.0;
                      double * blockL = Lleft[theindex-1-l_index]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
                      
-                     dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                   }
                }
@@ -5148,13 +5148,13 @@ void CheMPS2::Heff::addDiagram4L1and4L2spin0(const int ikappa, double * memS, do
                         double beta = 0.0; //set
                         double alpha = factor;
                      
-                        dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockA,&dimRdown,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockA,&dimRdown,&beta,temp,&dimLdown);
                      
                         beta = 1.0; //add
                         alpha = 1.0;
                         double * blockL = Lleft[theindex-1-l_index]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
                      
-                        dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                      
                      }
                   }
@@ -5195,13 +5195,13 @@ void CheMPS2::Heff::addDiagram4L1and4L2spin0(const int ikappa, double * memS, do
                         double beta = 0.0; //set
                         double alpha = factor;
                      
-                        dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockA,&dimRup,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockA,&dimRup,&beta,temp,&dimLdown);
                      
                         beta = 1.0; //add
                         alpha = 1.0;
                         double * blockL = Lleft[theindex-1-l_index]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
                      
-                        dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                      
                      }
                   }
@@ -5239,13 +5239,13 @@ void CheMPS2::Heff::addDiagram4L1and4L2spin0(const int ikappa, double * memS, do
                      double beta = 0.0; //set
                      double alpha = factor;
                      
-                     dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockA,&dimRup,&beta,temp,&dimLdown);
+                     planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockA,&dimRup,&beta,temp,&dimLdown);
                      
                      beta = 1.0; //add
                      alpha = 1.0;
                      double * blockL = Lleft[theindex-1-l_index]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
                      
-                     dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   
                   }
                }
@@ -5311,13 +5311,13 @@ void CheMPS2::Heff::addDiagram4K1and4K2spin1(const int ikappa, double * memS, do
                         double beta = 0.0; //set
                         double alpha = factor;
                      
-                        dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockB,&dimRdown,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockB,&dimRdown,&beta,temp,&dimLdown);
                      
                         beta = 1.0; //add
                         alpha = 1.0;
                         double * blockL = Lleft[theindex-1-l_index]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
                      
-                        dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                      
                      }
                   }
@@ -5359,13 +5359,13 @@ void CheMPS2::Heff::addDiagram4K1and4K2spin1(const int ikappa, double * memS, do
                            double beta = 0.0; //set
                            double alpha = factor;
                      
-                           dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockB,&dimRdown,&beta, temp,&dimLdown);
+                           planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockB,&dimRdown,&beta, temp,&dimLdown);
                      
                            beta = 1.0; //add
                            alpha = 1.0;
                            double * blockL = Lleft[theindex-1-l_index]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
                      
-                           dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                           planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                         
                         }
                      }
@@ -5408,13 +5408,13 @@ void CheMPS2::Heff::addDiagram4K1and4K2spin1(const int ikappa, double * memS, do
                            double beta = 0.0; //set
                            double alpha = factor;
                      
-                           dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockB,&dimRup,&beta,temp,&dimLdown);
+                           planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockB,&dimRup,&beta,temp,&dimLdown);
                      
                            beta = 1.0; //add
                            alpha = 1.0;
                            double * blockL = Lleft[theindex-1-l_index]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
                      
-                           dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                           planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                         
                         }
                      }
@@ -5454,13 +5454,13 @@ void CheMPS2::Heff::addDiagram4K1and4K2spin1(const int ikappa, double * memS, do
                         double beta = 0.0; //set
                         double alpha = factor;
                      
-                        dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockB,&dimRup,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockB,&dimRup,&beta,temp,&dimLdown);
                      
                         beta = 1.0; //add
                         alpha = 1.0;
                         double * blockL = Lleft[theindex-1-l_index]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
                      
-                        dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                      }
                   }
                }
@@ -5526,13 +5526,13 @@ void CheMPS2::Heff::addDiagram4L1and4L2spin1(const int ikappa, double * memS, do
                         double beta = 0.0; //set
                         double alpha = factor;
                      
-                        dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockB,&dimRdown,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockB,&dimRdown,&beta,temp,&dimLdown);
                      
                         beta = 1.0; //add
                         alpha = 1.0;
                         double * blockL = Lleft[theindex-1-l_index]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
                      
-                        dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                      }
                   }
                }
@@ -5573,13 +5573,13 @@ void CheMPS2::Heff::addDiagram4L1and4L2spin1(const int ikappa, double * memS, do
                            double beta = 0.0; //set
                            double alpha = factor;
                      
-                           dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockB,&dimRdown,&beta, temp,&dimLdown);
+                           planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockB,&dimRdown,&beta, temp,&dimLdown);
                      
                            beta = 1.0; //add
                            alpha = 1.0;
                            double * blockL = Lleft[theindex-1-l_index]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
                      
-                           dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                           planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                         }
                      }
                   }
@@ -5621,13 +5621,13 @@ void CheMPS2::Heff::addDiagram4L1and4L2spin1(const int ikappa, double * memS, do
                            double beta = 0.0; //set
                            double alpha = factor;
                      
-                           dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockB,&dimRup,&beta,temp,&dimLdown);
+                           planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockB,&dimRup,&beta,temp,&dimLdown);
                      
                            beta = 1.0; //add
                            alpha = 1.0;
                            double * blockL = Lleft[theindex-1-l_index]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
                      
-                           dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                           planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                         }
                      }
                   }
@@ -5666,13 +5666,13 @@ void CheMPS2::Heff::addDiagram4L1and4L2spin1(const int ikappa, double * memS, do
                         double beta = 0.0; //set
                         double alpha = factor;
                      
-                        dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockB,&dimRup,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,blockB,&dimRup,&beta,temp,&dimLdown);
                      
                         beta = 1.0; //add
                         alpha = 1.0;
                         double * blockL = Lleft[theindex-1-l_index]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
                      
-                        dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                      }
                   }
                }
@@ -5737,13 +5737,13 @@ void CheMPS2::Heff::addDiagram4K3and4K4spin0(const int ikappa, double * memS, do
                      double beta = 0.0; //set
                      double alpha = factor;
                      
-                     dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRup,&beta,temp,&dimLdown);
+                     planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRup,&beta,temp,&dimLdown);
                      
                      beta = 1.0; //add
                      alpha = 1.0;
                      double * blockL = Lleft[theindex-1-l_index]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
                      
-                     dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   }
                }
             }
@@ -5782,13 +5782,13 @@ void CheMPS2::Heff::addDiagram4K3and4K4spin0(const int ikappa, double * memS, do
                         double beta = 0.0; //set
                         double alpha = factor;
                      
-                        dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRup,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRup,&beta,temp,&dimLdown);
                      
                         beta = 1.0; //add
                         alpha = 1.0;
                         double * blockL = Lleft[theindex-1-l_index]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
                      
-                        dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                      }
                   }
                }
@@ -5828,13 +5828,13 @@ void CheMPS2::Heff::addDiagram4K3and4K4spin0(const int ikappa, double * memS, do
                         double beta = 0.0; //set
                         double alpha = factor;
                      
-                        dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRdown,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRdown,&beta,temp,&dimLdown);
                      
                         beta = 1.0; //add
                         alpha = 1.0;
                         double * blockL = Lleft[theindex-1-l_index]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
                      
-                        dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                      }
                   }
                }
@@ -5871,13 +5871,13 @@ void CheMPS2::Heff::addDiagram4K3and4K4spin0(const int ikappa, double * memS, do
                      double beta = 0.0; //set
                      double alpha = factor;
                      
-                     dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRdown,&beta,temp,&dimLdown);
+                     planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRdown,&beta,temp,&dimLdown);
                      
                      beta = 1.0; //add
                      alpha = 1.0;
                      double * blockL = Lleft[theindex-1-l_index]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
                    
-                     dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   }
                }
             }
@@ -5941,13 +5941,13 @@ void CheMPS2::Heff::addDiagram4L3and4L4spin0(const int ikappa, double * memS, do
                      double beta = 0.0; //set
                      double alpha = factor;
                      
-                     dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRup,&beta,temp,&dimLdown);
+                     planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRup,&beta,temp,&dimLdown);
                      
                      beta = 1.0; //add
                      alpha = 1.0;
                      double * blockL = Lleft[theindex-1-l_index]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
                      
-                     dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   }
                }
             }
@@ -5986,13 +5986,13 @@ void CheMPS2::Heff::addDiagram4L3and4L4spin0(const int ikappa, double * memS, do
                         double beta = 0.0; //set
                         double alpha = factor;
                      
-                        dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRup,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRup,&beta,temp,&dimLdown);
                      
                         beta = 1.0; //add
                         alpha = 1.0;
                         double * blockL = Lleft[theindex-1-l_index]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
                      
-                        dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                      }
                   }
                }
@@ -6032,13 +6032,13 @@ void CheMPS2::Heff::addDiagram4L3and4L4spin0(const int ikappa, double * memS, do
                         double beta = 0.0; //set
                         double alpha = factor;
                      
-                        dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRdown,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRdown,&beta,temp,&dimLdown);
                      
                         beta = 1.0; //add
                         alpha = 1.0;
                         double * blockL = Lleft[theindex-1-l_index]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
                      
-                        dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                      }
                   }
                }
@@ -6075,13 +6075,13 @@ void CheMPS2::Heff::addDiagram4L3and4L4spin0(const int ikappa, double * memS, do
                      double beta = 0.0; //set
                      double alpha = factor;
                      
-                     dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRdown,&beta,temp,&dimLdown);
+                     planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRdown,&beta,temp,&dimLdown);
                      
                      beta = 1.0; //add
                      alpha = 1.0;
                      double * blockL = Lleft[theindex-1-l_index]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
                    
-                     dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                     planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                   }
                }
             }
@@ -6146,13 +6146,13 @@ void CheMPS2::Heff::addDiagram4K3and4K4spin1(const int ikappa, double * memS, do
                         double beta = 0.0; //set
                         double alpha = factor;
                      
-                        dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRup,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRup,&beta,temp,&dimLdown);
                      
                         beta = 1.0; //add
                         alpha = 1.0;
                         double * blockL = Lleft[theindex-1-l_index]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
                      
-                        dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                      }
                   }
                }
@@ -6193,13 +6193,13 @@ void CheMPS2::Heff::addDiagram4K3and4K4spin1(const int ikappa, double * memS, do
                            double beta = 0.0; //set
                            double alpha = factor;
                      
-                           dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRup,&beta,temp,&dimLdown);
+                           planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRup,&beta,temp,&dimLdown);
                      
                            beta = 1.0; //add
                            alpha = 1.0;
                            double * blockL = Lleft[theindex-1-l_index]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
                      
-                           dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                           planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                         }
                      }
                   }
@@ -6241,13 +6241,13 @@ void CheMPS2::Heff::addDiagram4K3and4K4spin1(const int ikappa, double * memS, do
                            double beta = 0.0; //set
                            double alpha = factor;
                      
-                           dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRdown,&beta,temp,&dimLdown);
+                           planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRdown,&beta,temp,&dimLdown);
                      
                            beta = 1.0; //add
                            alpha = 1.0;
                            double * blockL = Lleft[theindex-1-l_index]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
                      
-                           dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                           planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                         }
                      }
                   }
@@ -6286,13 +6286,13 @@ void CheMPS2::Heff::addDiagram4K3and4K4spin1(const int ikappa, double * memS, do
                         double beta = 0.0; //set
                         double alpha = factor;
                      
-                        dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRdown,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRdown,&beta,temp,&dimLdown);
                      
                         beta = 1.0; //add
                         alpha = 1.0;
                         double * blockL = Lleft[theindex-1-l_index]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
                    
-                        dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                      }
                   }
                }
@@ -6358,13 +6358,13 @@ void CheMPS2::Heff::addDiagram4L3and4L4spin1(const int ikappa, double * memS, do
                         double beta = 0.0; //set
                         double alpha = factor;
                      
-                        dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRup,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRup,&beta,temp,&dimLdown);
                      
                         beta = 1.0; //add
                         alpha = 1.0;
                         double * blockL = Lleft[theindex-1-l_index]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
                      
-                        dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                      }
                   }
                }
@@ -6405,13 +6405,13 @@ void CheMPS2::Heff::addDiagram4L3and4L4spin1(const int ikappa, double * memS, do
                            double beta = 0.0; //set
                            double alpha = factor;
                      
-                           dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRup,&beta,temp,&dimLdown);
+                           planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRup,&beta,temp,&dimLdown);
                      
                            beta = 1.0; //add
                            alpha = 1.0;
                            double * blockL = Lleft[theindex-1-l_index]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
                      
-                           dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                           planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLup,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                         }
                      }
                   }
@@ -6453,13 +6453,13 @@ void CheMPS2::Heff::addDiagram4L3and4L4spin1(const int ikappa, double * memS, do
                            double beta = 0.0; //set
                            double alpha = factor;
                      
-                           dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRdown,&beta,temp,&dimLdown);
+                           planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRdown,&beta,temp,&dimLdown);
                      
                            beta = 1.0; //add
                            alpha = 1.0;
                            double * blockL = Lleft[theindex-1-l_index]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
                      
-                           dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                           planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                         }
                      }
                   }
@@ -6498,13 +6498,13 @@ void CheMPS2::Heff::addDiagram4L3and4L4spin1(const int ikappa, double * memS, do
                         double beta = 0.0; //set
                         double alpha = factor;
                      
-                        dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRdown,&beta,temp,&dimLdown);
+                        planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,ptr,&dimRdown,&beta,temp,&dimLdown);
                      
                         beta = 1.0; //add
                         alpha = 1.0;
                         double * blockL = Lleft[theindex-1-l_index]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
                    
-                        dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                        planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,blockL,&dimLdown,temp,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                      }
                   }
                }
@@ -95,14 +95,14 @@ void CheMPS2::Heff::addDiagram5A(const int ikappa, double * memS, double * memHe
                               if ((dimLdown>0) && (dimRdown>0)){
                               
                                  int size = dimRup * dimRdown;
-                                 for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                                 planClear(temp, size);
                               
                                  for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                                     if (denBK->gIrrep(l_beta) == IrrepTimesMid){
                                        double prefac =             factor * ( Prob->gMxElement(l_alpha, l_beta, theindex, theindex+1) 
                                                      + ((TwoJdown==0)?1:-1) * Prob->gMxElement(l_alpha, l_beta, theindex+1, theindex) );
                                        double * LblockR = Lright[l_beta-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
-                                       daxpy_(&size,&prefac,LblockR,&inc,temp,&inc);
+                                       planDaxpy(&size,&prefac,LblockR,&inc,temp,&inc);
                                     }
                                  }
                               
@@ -110,11 +110,11 @@ void CheMPS2::Heff::addDiagram5A(const int ikappa, double * memS, double * memHe
                                  double beta = 0.0; //set
                                  int memSkappa = denS->gKappa(NL-1, TwoSLdown, ILdown, 1, 1, TwoJdown, NR+1, TwoSRdown, IRdown);
                               
-                                 dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
+                                 planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
                               
                                  beta = 1.0; //add
                                  double * LblockL = Lleft[theindex-1-l_alpha]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
-                                 dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                                 planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                               
                               }
                            }
@@ -175,14 +175,14 @@ void CheMPS2::Heff::addDiagram5A(const int ikappa, double * memS, double * memHe
                            if ((dimLdown>0) && (dimRdown>0)){
                               
                               int size = dimRup * dimRdown;
-                              for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                              planClear(temp, size);
                               
                               for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                                  if (denBK->gIrrep(l_beta) == IrrepTimesMid){
                                     double prefac = factor1 * Prob->gMxElement(l_alpha, l_beta, theindex, theindex+1) 
                                                   + factor2 * Prob->gMxElement(l_alpha, l_beta, theindex+1, theindex);
                                     double * LblockR = Lright[l_beta-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
-                                    daxpy_(&size,&prefac,LblockR,&inc,temp,&inc);
+                                    planDaxpy(&size,&prefac,LblockR,&inc,temp,&inc);
                                  }
                               }
                               
@@ -190,11 +190,11 @@ void CheMPS2::Heff::addDiagram5A(const int ikappa, double * memS, double * memHe
                               double beta = 0.0; //set
                               int memSkappa = denS->gKappa(NL-1, TwoSLdown, ILdown, 2, 1, 1, NR+1, TwoSRdown, IRdown);
                               
-                              dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
+                              planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
                               
                               beta = 1.0; //add
                               double * LblockL = Lleft[theindex-1-l_alpha]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
-                              dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                              planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
 
                            }
                         }
@@ -254,14 +254,14 @@ void CheMPS2::Heff::addDiagram5A(const int ikappa, double * memS, double * memHe
                            if ((dimLdown>0) && (dimRdown>0)){
                               
                               int size = dimRup * dimRdown;
-                              for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                              planClear(temp, size);
                               
                               for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                                  if (denBK->gIrrep(l_beta) == IrrepTimesMid){
                                     double prefac = factor1 * Prob->gMxElement(l_alpha, l_beta, theindex, theindex+1) 
                                                   + factor2 * Prob->gMxElement(l_alpha, l_beta, theindex+1, theindex);
                                     double * LblockR = Lright[l_beta-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
-                                    daxpy_(&size,&prefac,LblockR,&inc,temp,&inc);
+                                    planDaxpy(&size,&prefac,LblockR,&inc,temp,&inc);
                                  }
                               }
                               
@@ -269,11 +269,11 @@ void CheMPS2::Heff::addDiagram5A(const int ikappa, double * memS, double * memHe
                               double beta = 0.0; //set
                               int memSkappa = denS->gKappa(NL-1, TwoSLdown, ILdown, 1, 2, 1, NR+1, TwoSRdown, IRdown);
                               
-                              dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
+                              planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
                               
                               beta = 1.0; //add
                               double * LblockL = Lleft[theindex-1-l_alpha]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
-                              dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                              planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                            
                            }
                         }
@@ -326,14 +326,14 @@ void CheMPS2::Heff::addDiagram5A(const int ikappa, double * memS, double * memHe
                         if ((dimLdown>0) && (dimRdown>0)){
                          
                            int size = dimRup * dimRdown;
-                           for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                           planClear(temp, size);
                              
                            for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                               if (denBK->gIrrep(l_beta) == IrrepTimesMid){
                                  double prefac =         factor * ( Prob->gMxElement(l_alpha, l_beta, theindex, theindex+1) 
                                                + ((TwoJ==0)?1:-1) * Prob->gMxElement(l_alpha, l_beta, theindex+1, theindex) );
                                  double * LblockR = Lright[l_beta-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
-                                 daxpy_(&size,&prefac,LblockR,&inc,temp,&inc);
+                                 planDaxpy(&size,&prefac,LblockR,&inc,temp,&inc);
                               }
                            }
                                  
@@ -341,11 +341,11 @@ void CheMPS2::Heff::addDiagram5A(const int ikappa, double * memS, double * memHe
                            double beta = 0.0; //set
                            int memSkappa = denS->gKappa(NL-1, TwoSLdown, ILdown, 2, 2, 0, NR+1, TwoSRdown, IRdown);
                                  
-                           dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
+                           planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
                                  
                            beta = 1.0; //add
                            double * LblockL = Lleft[theindex-1-l_alpha]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
-                           dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                           planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                         }
                      }
                   }
@@ -425,14 +425,14 @@ void CheMPS2::Heff::addDiagram5B(const int ikappa, double * memS, double * memHe
                         if ((dimLdown>0) && (dimRdown>0)){
                              
                            int size = dimRup * dimRdown;
-                           for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                           planClear(temp, size);
                               
                            for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                               if (denBK->gIrrep(l_beta) == IrrepTimesMid){
                                  double prefac =         factor * ( Prob->gMxElement(l_alpha, l_beta, theindex, theindex+1) 
                                                + ((TwoJ==0)?1:-1) * Prob->gMxElement(l_alpha, l_beta, theindex+1, theindex) );
                                  double * LblockR = Lright[l_beta-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
-                                 daxpy_(&size,&prefac,LblockR,&inc,temp,&inc);
+                                 planDaxpy(&size,&prefac,LblockR,&inc,temp,&inc);
                               }
                            }
                                  
@@ -440,11 +440,11 @@ void CheMPS2::Heff::addDiagram5B(const int ikappa, double * memS, double * memHe
                            double beta = 0.0; //set
                            int memSkappa = denS->gKappa(NL+1, TwoSLdown, ILdown, 0, 0, 0, NR-1, TwoSRdown, IRdown);
                                 
-                           dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
+                           planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
                                  
                            beta = 1.0; //add
                            double * LblockL = Lleft[theindex-1-l_alpha]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
-                           dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                           planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                         }
                      }
                   }
@@ -502,14 +502,14 @@ void CheMPS2::Heff::addDiagram5B(const int ikappa, double * memS, double * memHe
                            if ((dimLdown>0) && (dimRdown>0)){
                               
                               int size = dimRup * dimRdown;
-                              for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                              planClear(temp, size);
                               
                               for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                                  if (denBK->gIrrep(l_beta) == IrrepTimesMid){
                                     double prefac = factor1 * Prob->gMxElement(l_alpha, l_beta, theindex, theindex+1) 
                                                   + factor2 * Prob->gMxElement(l_alpha, l_beta, theindex+1, theindex);
                                     double * LblockR = Lright[l_beta-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
-                                    daxpy_(&size,&prefac,LblockR,&inc,temp,&inc);
+                                    planDaxpy(&size,&prefac,LblockR,&inc,temp,&inc);
                                  }
                               }
                               
@@ -517,11 +517,11 @@ void CheMPS2::Heff::addDiagram5B(const int ikappa, double * memS, double * memHe
                               double beta = 0.0; //set
                               int memSkappa = denS->gKappa(NL+1, TwoSLdown, ILdown, 1, 0, 1, NR-1, TwoSRdown, IRdown);
                               
-                              dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
+                              planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
                               
                               beta = 1.0; //add
                               double * LblockL = Lleft[theindex-1-l_alpha]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
-                              dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                              planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                            
                            }
                         }
@@ -580,14 +580,14 @@ void CheMPS2::Heff::addDiagram5B(const int ikappa, double * memS, double * memHe
                            if ((dimLdown>0) && (dimRdown>0)){
                               
                               int size = dimRup * dimRdown;
-                              for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                              planClear(temp, size);
                               
                               for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                                  if (denBK->gIrrep(l_beta) == IrrepTimesMid){
                                     double prefac = factor1 * Prob->gMxElement(l_alpha, l_beta, theindex, theindex+1) 
                                                   + factor2 * Prob->gMxElement(l_alpha, l_beta, theindex+1, theindex);
                                     double * LblockR = Lright[l_beta-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
-                                    daxpy_(&size,&prefac,LblockR,&inc,temp,&inc);
+                                    planDaxpy(&size,&prefac,LblockR,&inc,temp,&inc);
                                  }
                               }
                               
@@ -595,11 +595,11 @@ void CheMPS2::Heff::addDiagram5B(const int ikappa, double * memS, double * memHe
                               double beta = 0.0; //set
                               int memSkappa = denS->gKappa(NL+1, TwoSLdown, ILdown, 0, 1, 1, NR-1, TwoSRdown, IRdown);
                               
-                              dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
+                              planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
                               
                               beta = 1.0; //add
                               double * LblockL = Lleft[theindex-1-l_alpha]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
-                              dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                              planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                            
                            }
                         }
@@ -653,14 +653,14 @@ void CheMPS2::Heff::addDiagram5B(const int ikappa, double * memS, double * memHe
                               if ((dimLdown>0) && (dimRdown>0)){
                               
                                  int size = dimRup * dimRdown;
-                                 for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                                 planClear(temp, size);
                               
                                  for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                                     if (denBK->gIrrep(l_beta) == IrrepTimesMid){
                                        double prefac =             factor * ( Prob->gMxElement(l_alpha, l_beta, theindex, theindex+1) 
                                                      + ((TwoJdown==0)?1:-1) * Prob->gMxElement(l_alpha, l_beta, theindex+1, theindex) );
                                        double * LblockR = Lright[l_beta-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
-                                       daxpy_(&size,&prefac,LblockR,&inc,temp,&inc);
+                                       planDaxpy(&size,&prefac,LblockR,&inc,temp,&inc);
                                     }
                                  }
                               
@@ -668,11 +668,11 @@ void CheMPS2::Heff::addDiagram5B(const int ikappa, double * memS, double * memHe
                                  double beta = 0.0; //set
                                  int memSkappa = denS->gKappa(NL+1, TwoSLdown, ILdown, 1, 1, TwoJdown, NR-1, TwoSRdown, IRdown);
                               
-                                 dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
+                                 planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
                               
                                  beta = 1.0; //add
                                  double * LblockL = Lleft[theindex-1-l_alpha]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
-                                 dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                                 planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                               }
                            }
                         }
@@ -756,14 +756,14 @@ void CheMPS2::Heff::addDiagram5C(const int ikappa, double * memS, double * memHe
                            if ((dimLdown>0) && (dimRdown>0)){
                               
                               int size = dimRup * dimRdown;
-                              for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                              planClear(temp, size);
                               
                               for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                                  if (denBK->gIrrep(l_beta) == IrrepTimesMid){
                                     double prefac = factor1 * Prob->gMxElement(l_alpha,theindex,theindex+1,l_beta)
                                                   + factor2 * Prob->gMxElement(l_alpha,theindex,l_beta,theindex+1);
                                     double * LblockR = Lright[l_beta-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
-                                    daxpy_(&size,&prefac,LblockR,&inc,temp,&inc);
+                                    planDaxpy(&size,&prefac,LblockR,&inc,temp,&inc);
                                  }
                               }
                               
@@ -771,11 +771,11 @@ void CheMPS2::Heff::addDiagram5C(const int ikappa, double * memS, double * memHe
                               double beta = 0.0; //set
                               int memSkappa = denS->gKappa(NL-1, TwoSLdown, ILdown, 0, 1, 1, NR-1, TwoSRdown, IRdown);
                              
-                              dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
+                              planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
                               
                               beta = 1.0; //add
                               double * LblockL = Lleft[theindex-1-l_alpha]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
-                              dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                              planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                            }
                         }
                      }
@@ -829,14 +829,14 @@ void CheMPS2::Heff::addDiagram5C(const int ikappa, double * memS, double * memHe
                               if ((dimLdown>0) && (dimRdown>0)){
                               
                                  int size = dimRup * dimRdown;
-                                 for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                                 planClear(temp, size);
                               
                                  for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                                     if (denBK->gIrrep(l_beta) == IrrepTimesMid){
                                        double prefac = factor1 * Prob->gMxElement(l_alpha, theindex, theindex+1, l_beta) 
                                                      + factor2 * Prob->gMxElement(l_alpha, theindex, l_beta, theindex+1);
                                        double * LblockR = Lright[l_beta-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
-                                       daxpy_(&size,&prefac,LblockR,&inc,temp,&inc);
+                                       planDaxpy(&size,&prefac,LblockR,&inc,temp,&inc);
                                     }
                                  }
                               
@@ -844,11 +844,11 @@ void CheMPS2::Heff::addDiagram5C(const int ikappa, double * memS, double * memHe
                                  double beta = 0.0; //set
                                  int memSkappa = denS->gKappa(NL-1, TwoSLdown, ILdown, 1, 1, TwoJdown, NR-1, TwoSRdown, IRdown);
                               
-                                 dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
+                                 planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
                               
                                  beta = 1.0; //add
                                  double * LblockL = Lleft[theindex-1-l_alpha]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
-                                 dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                                 planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                               }
                            }
                         }
@@ -902,14 +902,14 @@ void CheMPS2::Heff::addDiagram5C(const int ikappa, double * memS, double * memHe
                         if ((dimLdown>0) && (dimRdown>0)){
                              
                            int size = dimRup * dimRdown;
-                           for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                           planClear(temp, size);
                               
                            for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                               if (denBK->gIrrep(l_beta) == IrrepTimesMid){
                                  double prefac = factor1 * Prob->gMxElement(l_alpha, theindex, theindex+1, l_beta) 
                                                + factor2 * Prob->gMxElement(l_alpha, theindex, l_beta, theindex+1);
                                  double * LblockR = Lright[l_beta-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
-                                 daxpy_(&size,&prefac,LblockR,&inc,temp,&inc);
+                                 planDaxpy(&size,&prefac,LblockR,&inc,temp,&inc);
                               }
                            }
                                  
@@ -917,11 +917,11 @@ void CheMPS2::Heff::addDiagram5C(const int ikappa, double * memS, double * memHe
                            double beta = 0.0; //set
                            int memSkappa = denS->gKappa(NL-1, TwoSLdown, ILdown, 0, 2, 0, NR-1, TwoSRdown, IRdown);
                                
-                           dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
+                           planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
                                  
                            beta = 1.0; //add
                            double * LblockL = Lleft[theindex-1-l_alpha]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
-                           dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                           planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                         }
                      }
                   }
@@ -972,14 +972,14 @@ void CheMPS2::Heff::addDiagram5C(const int ikappa, double * memS, double * memHe
                            if ((dimLdown>0) && (dimRdown>0)){
                               
                               int size = dimRup * dimRdown;
-                              for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                              planClear(temp, size);
                               
                               for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                                  if (denBK->gIrrep(l_beta) == IrrepTimesMid){
                                     double prefac = factor1 * Prob->gMxElement(l_alpha, theindex, theindex+1, l_beta) 
                                                   + factor2 * Prob->gMxElement(l_alpha, theindex, l_beta, theindex+1);
                                     double * LblockR = Lright[l_beta-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
-                                    daxpy_(&size,&prefac,LblockR,&inc,temp,&inc);
+                                    planDaxpy(&size,&prefac,LblockR,&inc,temp,&inc);
                                  }
                               }
                               
@@ -987,11 +987,11 @@ void CheMPS2::Heff::addDiagram5C(const int ikappa, double * memS, double * memHe
                               double beta = 0.0; //set
                               int memSkappa = denS->gKappa(NL-1, TwoSLdown, ILdown, 1, 2, 1, NR-1, TwoSRdown, IRdown);
                               
-                              dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
+                              planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
                               
                               beta = 1.0; //add
                               double * LblockL = Lleft[theindex-1-l_alpha]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
-                              dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                              planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                            }
                         }
                      }
@@ -1074,14 +1074,14 @@ void CheMPS2::Heff::addDiagram5D(const int ikappa, double * memS, double * memHe
                            if ((dimLdown>0) && (dimRdown>0)){
                               
                               int size = dimRup * dimRdown;
-                              for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                              planClear(temp, size);
                               
                               for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                                  if (denBK->gIrrep(l_beta) == IrrepTimesMid){
                                     double prefac = factor1 * Prob->gMxElement(l_alpha,theindex,theindex+1,l_beta)
                                                   + factor2 * Prob->gMxElement(l_alpha,theindex,l_beta,theindex+1);
                                     double * LblockR = Lright[l_beta-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
-                                    daxpy_(&size,&prefac,LblockR,&inc,temp,&inc);
+                                    planDaxpy(&size,&prefac,LblockR,&inc,temp,&inc);
                                  }
                               }
                               
@@ -1089,11 +1089,11 @@ void CheMPS2::Heff::addDiagram5D(const int ikappa, double * memS, double * memHe
                               double beta = 0.0; //set
                               int memSkappa = denS->gKappa(NL+1, TwoSLdown, ILdown, 1, 0, 1, NR+1, TwoSRdown, IRdown);
                              
-                              dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
+                              planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
                               
                               beta = 1.0; //add
                               double * LblockL = Lleft[theindex-1-l_alpha]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
-                              dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                              planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                            
                            }
                         }
@@ -1147,14 +1147,14 @@ void CheMPS2::Heff::addDiagram5D(const int ikappa, double * memS, double * memHe
                         if ((dimLdown>0) && (dimRdown>0)){
                                  
                            int size = dimRup * dimRdown;
-                           for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                           planClear(temp, size);
                                  
                            for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                               if (denBK->gIrrep(l_beta) == IrrepTimesMid){
                                  double prefac = factor1 * Prob->gMxElement(l_alpha, theindex, theindex+1, l_beta) 
                                                + factor2 * Prob->gMxElement(l_alpha, theindex, l_beta, theindex+1);
                                  double * LblockR = Lright[l_beta-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
-                                 daxpy_(&size,&prefac,LblockR,&inc,temp,&inc);
+                                 planDaxpy(&size,&prefac,LblockR,&inc,temp,&inc);
                               }
                            }
                                 
@@ -1162,11 +1162,11 @@ void CheMPS2::Heff::addDiagram5D(const int ikappa, double * memS, double * memHe
                            double beta = 0.0; //set
                            int memSkappa = denS->gKappa(NL+1, TwoSLdown, ILdown, 2, 0, 0, NR+1, TwoSRdown, IRdown);
                                  
-                           dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
+                           planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
                                  
                            beta = 1.0; //add
                            double * LblockL = Lleft[theindex-1-l_alpha]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
-                           dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                           planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                         }
                      }
                   }
@@ -1219,14 +1219,14 @@ void CheMPS2::Heff::addDiagram5D(const int ikappa, double * memS, double * memHe
                               if ((dimLdown>0) && (dimRdown>0)){
                               
                                  int size = dimRup * dimRdown;
-                                 for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                                 planClear(temp, size);
                               
                                  for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                                     if (denBK->gIrrep(l_beta) == IrrepTimesMid){
                                        double prefac = factor1 * Prob->gMxElement(l_alpha, theindex, theindex+1, l_beta) 
                                                      + factor2 * Prob->gMxElement(l_alpha, theindex, l_beta, theindex+1);
                                        double * LblockR = Lright[l_beta-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
-                                       daxpy_(&size,&prefac,LblockR,&inc,temp,&inc);
+                                       planDaxpy(&size,&prefac,LblockR,&inc,temp,&inc);
                                     }
                                  }
                               
@@ -1234,11 +1234,11 @@ void CheMPS2::Heff::addDiagram5D(const int ikappa, double * memS, double * memHe
                                  double beta = 0.0; //set
                                  int memSkappa = denS->gKappa(NL+1, TwoSLdown, ILdown, 1, 1, TwoJdown, NR+1, TwoSRdown, IRdown);
                             
-                                 dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
+                                 planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
                               
                                  beta = 1.0; //add
                                  double * LblockL = Lleft[theindex-1-l_alpha]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
-                                 dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                                 planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                               }
                            }
                         }
@@ -1291,14 +1291,14 @@ void CheMPS2::Heff::addDiagram5D(const int ikappa, double * memS, double * memHe
                            if ((dimLdown>0) && (dimRdown>0)){
                               
                               int size = dimRup * dimRdown;
-                              for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                              planClear(temp, size);
                               
                               for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                                  if (denBK->gIrrep(l_beta) == IrrepTimesMid){
                                     double prefac = factor1 * Prob->gMxElement(l_alpha, theindex, theindex+1, l_beta) 
                                                   + factor2 * Prob->gMxElement(l_alpha, theindex, l_beta, theindex+1);
                                     double * LblockR = Lright[l_beta-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
-                                    daxpy_(&size,&prefac,LblockR,&inc,temp,&inc);
+                                    planDaxpy(&size,&prefac,LblockR,&inc,temp,&inc);
                                  }
                               }
                               
@@ -1306,11 +1306,11 @@ void CheMPS2::Heff::addDiagram5D(const int ikappa, double * memS, double * memHe
                               double beta = 0.0; //set
                               int memSkappa = denS->gKappa(NL+1, TwoSLdown, ILdown, 2, 1, 1, NR+1, TwoSRdown, IRdown);
                               
-                              dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
+                              planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
                               
                               beta = 1.0; //add
                               double * LblockL = Lleft[theindex-1-l_alpha]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
-                              dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                              planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                            }
                         }
                      }
@@ -1392,14 +1392,14 @@ void CheMPS2::Heff::addDiagram5E(const int ikappa, double * memS, double * memHe
                            if ((dimLdown>0) && (dimRdown>0)){
                               
                               int size = dimRup * dimRdown;
-                              for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                              planClear(temp, size);
                               
                               for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                                  if (denBK->gIrrep(l_beta) == IrrepTimesMid){
                                     double prefac = factor1 * Prob->gMxElement(l_alpha,theindex+1,theindex,l_beta)
                                                   + factor2 * Prob->gMxElement(l_alpha,theindex+1,l_beta,theindex);
                                     double * LblockR = Lright[l_beta-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
-                                    daxpy_(&size,&prefac,LblockR,&inc,temp,&inc);
+                                    planDaxpy(&size,&prefac,LblockR,&inc,temp,&inc);
                                  }
                               }
                               
@@ -1407,11 +1407,11 @@ void CheMPS2::Heff::addDiagram5E(const int ikappa, double * memS, double * memHe
                               double beta = 0.0; //set
                               int memSkappa = denS->gKappa(NL-1, TwoSLdown, ILdown, 1, 0, 1, NR-1, TwoSRdown, IRdown);
                              
-                              dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
+                              planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
                               
                               beta = 1.0; //add
                               double * LblockL = Lleft[theindex-1-l_alpha]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
-                              dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                              planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                            }
                         }
                      }
@@ -1465,14 +1465,14 @@ void CheMPS2::Heff::addDiagram5E(const int ikappa, double * memS, double * memHe
                               if ((dimLdown>0) && (dimRdown>0)){
                               
                                  int size = dimRup * dimRdown;
-                                 for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                                 planClear(temp, size);
                               
                                  for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                                     if (denBK->gIrrep(l_beta) == IrrepTimesMid){
                                        double prefac = factor1 * Prob->gMxElement(l_alpha, theindex+1, theindex, l_beta) 
                                                      + factor2 * Prob->gMxElement(l_alpha, theindex+1, l_beta, theindex);
                                        double * LblockR = Lright[l_beta-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
-                                       daxpy_(&size,&prefac,LblockR,&inc,temp,&inc);
+                                       planDaxpy(&size,&prefac,LblockR,&inc,temp,&inc);
                                     }
                                  }
                               
@@ -1480,11 +1480,11 @@ void CheMPS2::Heff::addDiagram5E(const int ikappa, double * memS, double * memHe
                                  double beta = 0.0; //set
                                  int memSkappa = denS->gKappa(NL-1, TwoSLdown, ILdown, 1, 1, TwoJdown, NR-1, TwoSRdown, IRdown);
                               
-                                 dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
+                                 planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
                               
                                  beta = 1.0; //add
                                  double * LblockL = Lleft[theindex-1-l_alpha]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
-                                 dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                                 planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                               }
                            }
                         }
@@ -1538,14 +1538,14 @@ void CheMPS2::Heff::addDiagram5E(const int ikappa, double * memS, double * memHe
                         if ((dimLdown>0) && (dimRdown>0)){
                                  
                            int size = dimRup * dimRdown;
-                           for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                           planClear(temp, size);
                                  
                            for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                               if (denBK->gIrrep(l_beta) == IrrepTimesMid){
                                  double prefac = factor1 * Prob->gMxElement(l_alpha, theindex+1, theindex, l_beta) 
                                                + factor2 * Prob->gMxElement(l_alpha, theindex+1, l_beta, theindex);
                                  double * LblockR = Lright[l_beta-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
-                                 daxpy_(&size,&prefac,LblockR,&inc,temp,&inc);
+                                 planDaxpy(&size,&prefac,LblockR,&inc,temp,&inc);
                               }
                            }
                                  
@@ -1553,11 +1553,11 @@ void CheMPS2::Heff::addDiagram5E(const int ikappa, double * memS, double * memHe
                            double beta = 0.0; //set
                            int memSkappa = denS->gKappa(NL-1, TwoSLdown, ILdown, 2, 0, 0, NR-1, TwoSRdown, IRdown);
                                
-                           dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
+                           planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
                                  
                            beta = 1.0; //add
                            double * LblockL = Lleft[theindex-1-l_alpha]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
-                           dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                           planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                         }
                      }
                   }
@@ -1608,14 +1608,14 @@ void CheMPS2::Heff::addDiagram5E(const int ikappa, double * memS, double * memHe
                            if ((dimLdown>0) && (dimRdown>0)){
                               
                               int size = dimRup * dimRdown;
-                              for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                              planClear(temp, size);
                               
                               for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                                  if (denBK->gIrrep(l_beta) == IrrepTimesMid){
                                     double prefac = factor1 * Prob->gMxElement(l_alpha, theindex+1, theindex, l_beta) 
                                                   + factor2 * Prob->gMxElement(l_alpha, theindex+1, l_beta, theindex);
                                     double * LblockR = Lright[l_beta-theindex-2]->gStorage(NR-1,TwoSRdown,IRdown,NR,TwoSR,IR);
-                                    daxpy_(&size,&prefac,LblockR,&inc,temp,&inc);
+                                    planDaxpy(&size,&prefac,LblockR,&inc,temp,&inc);
                                  }
                               }
                                
@@ -1623,11 +1623,11 @@ void CheMPS2::Heff::addDiagram5E(const int ikappa, double * memS, double * memHe
                               double beta = 0.0; //set
                               int memSkappa = denS->gKappa(NL-1, TwoSLdown, ILdown, 2, 1, 1, NR-1, TwoSRdown, IRdown);
                               
-                              dgemm_(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
+                              planDgemm(&notrans,&notrans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRdown,&beta,temp2,&dimLdown);
                               
                               beta = 1.0; //add
                               double * LblockL = Lleft[theindex-1-l_alpha]->gStorage(NL-1,TwoSLdown,ILdown,NL,TwoSL,IL);
-                              dgemm_(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                              planDgemm(&trans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLdown,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                            }
                         }
                      }
@@ -1709,14 +1709,14 @@ void CheMPS2::Heff::addDiagram5F(const int ikappa, double * memS, double * memHe
                            if ((dimLdown>0) && (dimRdown>0)){
                               
                               int size = dimRup * dimRdown;
-                              for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                              planClear(temp, size);
                               
                               for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                                  if (denBK->gIrrep(l_beta) == IrrepTimesMid){
                                     double prefac = factor1 * Prob->gMxElement(l_alpha,theindex+1,theindex,l_beta)
                                                   + factor2 * Prob->gMxElement(l_alpha,theindex+1,l_beta,theindex);
                                     double * LblockR = Lright[l_beta-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
-                                    daxpy_(&size,&prefac,LblockR,&inc,temp,&inc);
+                                    planDaxpy(&size,&prefac,LblockR,&inc,temp,&inc);
                                  }
                               }
                               
@@ -1724,11 +1724,11 @@ void CheMPS2::Heff::addDiagram5F(const int ikappa, double * memS, double * memHe
                               double beta = 0.0; //set
                               int memSkappa = denS->gKappa(NL+1, TwoSLdown, ILdown, 0, 1, 1, NR+1, TwoSRdown, IRdown);
                              
-                              dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
+                              planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
                               
                               beta = 1.0; //add
                               double * LblockL = Lleft[theindex-1-l_alpha]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
-                              dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                              planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                            }
                         }
                      }
@@ -1780,14 +1780,14 @@ void CheMPS2::Heff::addDiagram5F(const int ikappa, double * memS, double * memHe
                         if ((dimLdown>0) && (dimRdown>0)){
                            
                            int size = dimRup * dimRdown;
-                           for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                           planClear(temp, size);
                             
                            for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                               if (denBK->gIrrep(l_beta) == IrrepTimesMid){
                                  double prefac = factor1 * Prob->gMxElement(l_alpha, theindex+1, theindex, l_beta) 
                                                + factor2 * Prob->gMxElement(l_alpha, theindex+1, l_beta, theindex);
                                  double * LblockR = Lright[l_beta-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
-                                 daxpy_(&size,&prefac,LblockR,&inc,temp,&inc);
+                                 planDaxpy(&size,&prefac,LblockR,&inc,temp,&inc);
                               }
                            }
                              
@@ -1795,11 +1795,11 @@ void CheMPS2::Heff::addDiagram5F(const int ikappa, double * memS, double * memHe
                            double beta = 0.0; //set
                            int memSkappa = denS->gKappa(NL+1, TwoSLdown, ILdown, 0, 2, 0, NR+1, TwoSRdown, IRdown);
                               
-                           dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
+                           planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
                               
                            beta = 1.0; //add
                            double * LblockL = Lleft[theindex-1-l_alpha]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
-                           dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                           planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                         }
                      }
                   }
@@ -1851,14 +1851,14 @@ void CheMPS2::Heff::addDiagram5F(const int ikappa, double * memS, double * memHe
                               if ((dimLdown>0) && (dimRdown>0)){
                               
                                  int size = dimRup * dimRdown;
-                                 for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                                 planClear(temp, size);
                               
                                  for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                                     if (denBK->gIrrep(l_beta) == IrrepTimesMid){
                                        double prefac = factor1 * Prob->gMxElement(l_alpha, theindex+1, theindex, l_beta) 
                                                      + factor2 * Prob->gMxElement(l_alpha, theindex+1, l_beta, theindex);
                                        double * LblockR = Lright[l_beta-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
-                                       daxpy_(&size,&prefac,LblockR,&inc,temp,&inc);
+                                       planDaxpy(&size,&prefac,LblockR,&inc,temp,&inc);
                                     }
                                  }
                               
@@ -1866,11 +1866,11 @@ void CheMPS2::Heff::addDiagram5F(const int ikappa, double * memS, double * memHe
                                  double beta = 0.0; //set
                                  int memSkappa = denS->gKappa(NL+1, TwoSLdown, ILdown, 1, 1, TwoJdown, NR+1, TwoSRdown, IRdown);
                             
-                                 dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
+                                 planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
                               
                                  beta = 1.0; //add
                                  double * LblockL = Lleft[theindex-1-l_alpha]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
-                                 dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                                 planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                               }
                            }
                         }
@@ -1923,14 +1923,14 @@ void CheMPS2::Heff::addDiagram5F(const int ikappa, double * memS, double * memHe
                            if ((dimLdown>0) && (dimRdown>0)){
                               
                               int size = dimRup * dimRdown;
-                              for (int cnt=0; cnt<size; cnt++){ temp[cnt] = 0.0; }
+                              planClear(temp, size);
                               
                               for (int l_beta=theindex+2; l_beta<Prob->gL(); l_beta++){
                                  if (denBK->gIrrep(l_beta) == IrrepTimesMid){
                                     double prefac = factor1 * Prob->gMxElement(l_alpha, theindex+1, theindex, l_beta) 
                                                   + factor2 * Prob->gMxElement(l_alpha, theindex+1, l_beta, theindex);
                                     double * LblockR = Lright[l_beta-theindex-2]->gStorage(NR,TwoSR,IR,NR+1,TwoSRdown,IRdown);
-                                    daxpy_(&size,&prefac,LblockR,&inc,temp,&inc);
+                                    planDaxpy(&size,&prefac,LblockR,&inc,temp,&inc);
                                  }
                               }
                               
@@ -1938,11 +1938,11 @@ void CheMPS2::Heff::addDiagram5F(const int ikappa, double * memS, double * memHe
                               double beta = 0.0; //set
                               int memSkappa = denS->gKappa(NL+1, TwoSLdown, ILdown, 1, 2, 1, NR+1, TwoSRdown, IRdown);
                               
-                              dgemm_(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
+                              planDgemm(&notrans,&trans,&dimLdown,&dimRup,&dimRdown,&alpha,memS+denS->gKappa2index(memSkappa),&dimLdown,temp,&dimRup,&beta,temp2,&dimLdown);
                               
                               beta = 1.0; //add
                               double * LblockL = Lleft[theindex-1-l_alpha]->gStorage(NL,TwoSL,IL,NL+1,TwoSLdown,ILdown);
-                              dgemm_(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
+                              planDgemm(&notrans,&notrans,&dimLup,&dimRup,&dimLdown,&alpha,LblockL,&dimLup,temp2,&dimLdown,&beta,memHeff+denS->gKappa2index(ikappa),&dimLup);
                            }
                         }
                      }
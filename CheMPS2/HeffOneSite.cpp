@@ -0,0 +1,844 @@
+/*
+   CheMPS2: a spin-adapted implementation of DMRG for ab initio quantum chemistry
+   Copyright (C) 2013-2016 Sebastian Wouters
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include <math.h>
+#include <stdlib.h>
+#include <iostream>
+#include <algorithm>
+#include <assert.h>
+#include <sys/time.h>
+
+#include "HeffOneSite.h"
+#include "Davidson.h"
+#include "Lapack.h"
+#include "MPIchemps2.h"
+#include "Irreps.h"
+#include "Wigner.h"
+#include "Special.h"
+
+CheMPS2::HeffOneSite::HeffOneSite(SyBookkeeper * denBKIn, const Problem * ProbIn, const double dvdson_rtol_in, Workspace * work_in){
+
+   denBK = denBKIn;
+   Prob = ProbIn;
+   dvdson_rtol = dvdson_rtol_in;
+   num_matvec = 0;
+   mult_time = 0.0;
+   own_work = ( work_in == NULL );
+   work = (( own_work ) ? new Workspace() : work_in );
+
+}
+
+CheMPS2::HeffOneSite::~HeffOneSite(){
+
+   if ( own_work ){ delete work; }
+
+}
+
+int CheMPS2::HeffOneSite::gNumMultiplications() const{ return num_matvec; }
+
+double CheMPS2::HeffOneSite::gMultiplicationTime() const{ return mult_time; }
+
+void CheMPS2::HeffOneSite::convention(TensorT * denT, const bool prog2symm){
+
+   #pragma omp parallel for schedule(dynamic)
+   for ( int ikappa = 0; ikappa < denT->gNKappa(); ikappa++ ){
+
+      int dim = denT->gKappa2index( ikappa + 1 ) - denT->gKappa2index( ikappa );
+      double alpha = sqrt( denT->gTwoSR( ikappa ) + 1.0 );
+      if ( prog2symm == false ){ alpha = 1.0 / alpha; }
+      int inc = 1;
+      dscal_( &dim, &alpha, denT->gStorage() + denT->gKappa2index( ikappa ), &inc );
+
+   }
+
+}
+
+
+void CheMPS2::HeffOneSite::makeHeff(double * memT, double * memHeff, const TensorT * denT, TensorL *** Ltensors, TensorOperator **** Atensors, TensorOperator **** Btensors, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorS0 **** S0tensors, TensorS1 **** S1tensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorQ *** Qtensors, TensorX ** Xtensors) const{
+
+   #ifdef CHEMPS2_MPI_COMPILATION
+   const int MPIRANK = MPIchemps2::mpi_rank();
+   #endif
+   struct timeval start, end;
+   gettimeofday(&start, NULL);
+
+   const int theindex = denT->gIndex();
+   const bool atLeft  = ( theindex == 0 );
+   const bool atRight = ( theindex == Prob->gL() - 1 );
+   const int DIM = std::max( denBK->gMaxDimAtBound( theindex ), denBK->gMaxDimAtBound( theindex + 1 ) );
+
+   #pragma omp parallel
+   {
+
+      double * temp  = work->get_double( 0, ((long long) DIM ) * DIM );
+      double * temp2 = work->get_double( 1, ((long long) DIM ) * DIM );
+
+      #pragma omp for schedule(dynamic)
+      for ( int ikappa = 0; ikappa < denT->gNKappa(); ikappa++ ){
+
+         for ( long long cnt = denT->gKappa2index( ikappa ); cnt < denT->gKappa2index( ikappa + 1 ); cnt++ ){ memHeff[ cnt ] = 0.0; }
+
+         //Diagram 1C
+         #ifdef CHEMPS2_MPI_COMPILATION
+         if ( MPIchemps2::owner_1cd2d3eh() == MPIRANK )
+         #endif
+         { addDiagram1C( ikappa, memT, memHeff, denT, Prob->gMxElement( theindex, theindex, theindex, theindex ), temp ); }
+
+         //Operators on the left boundary and the site
+         if ( !atLeft ){
+
+            #ifdef CHEMPS2_MPI_COMPILATION
+            if ( MPIchemps2::owner_x() == MPIRANK )
+            #endif
+            { addDiagram1A( ikappa, memT, memHeff, denT, Xtensors[ theindex - 1 ], temp ); }
+
+            addDiagram2b( ikappa, memT, memHeff, denT, Atensors[ theindex - 1 ][ 0 ][ 0 ], Ctensors[ theindex - 1 ][ 0 ][ 0 ], Dtensors[ theindex - 1 ][ 0 ][ 0 ], temp );
+
+            #ifdef CHEMPS2_MPI_COMPILATION
+            if ( MPIchemps2::owner_q( Prob->gL(), theindex ) == MPIRANK )
+            #endif
+            { addDiagram3Aand3D( ikappa, memT, memHeff, denT, Qtensors[ theindex - 1 ][ 0 ], Ltensors[ theindex - 1 ], temp, temp2 ); }
+
+         }
+
+         //Operators on the site and the right boundary
+         if ( !atRight ){
+
+            #ifdef CHEMPS2_MPI_COMPILATION
+            if ( MPIchemps2::owner_x() == MPIRANK )
+            #endif
+            { addDiagram1B( ikappa, memT, memHeff, denT, Xtensors[ theindex ], temp ); }
+
+            addDiagram2e( ikappa, memT, memHeff, denT, Atensors[ theindex ][ 0 ][ 0 ], Ctensors[ theindex ][ 0 ][ 0 ], Dtensors[ theindex ][ 0 ][ 0 ], temp );
+
+            #ifdef CHEMPS2_MPI_COMPILATION
+            if ( MPIchemps2::owner_q( Prob->gL(), theindex ) == MPIRANK )
+            #endif
+            { addDiagram3Kand3F( ikappa, memT, memHeff, denT, Qtensors[ theindex ][ 0 ], Ltensors[ theindex ], temp, temp2 ); }
+
+         }
+
+         //Operators on both boundaries
+         if (( !atLeft ) && ( !atRight )){
+
+            addDiagram2a1and2a2spin0( ikappa, memT, memHeff, denT, Atensors, S0tensors, temp );
+            addDiagram2a1and2a2spin1( ikappa, memT, memHeff, denT, Btensors, S1tensors, temp );
+            addDiagram2a3( ikappa, memT, memHeff, denT, Ctensors, Dtensors, F0tensors, F1tensors, temp );
+            addDiagram3C( ikappa, memT, memHeff, denT, Qtensors[ theindex - 1 ], Ltensors[ theindex ], temp );
+            addDiagram3J( ikappa, memT, memHeff, denT, Qtensors[ theindex ], Ltensors[ theindex - 1 ], temp );
+            addDiagram4B( ikappa, memT, memHeff, denT, Atensors[ theindex - 1 ], Btensors[ theindex - 1 ], Ctensors[ theindex - 1 ], Dtensors[ theindex - 1 ], Ltensors[ theindex ], temp );
+            addDiagram4E( ikappa, memT, memHeff, denT, Ltensors[ theindex - 1 ], Ltensors[ theindex ], temp, temp2 );
+            addDiagram4L( ikappa, memT, memHeff, denT, Ltensors[ theindex - 1 ], Atensors[ theindex ], Btensors[ theindex ], Ctensors[ theindex ], Dtensors[ theindex ], temp );
+
+         }
+      }
+   }
+
+   gettimeofday(&end, NULL);
+   mult_time += (end.tv_sec - start.tv_sec) + 1e-6 * (end.tv_usec - start.tv_usec);
+
+}
+
+void CheMPS2::HeffOneSite::fillHeffDiag(double * memHeffDiag, const TensorT * denT, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorX ** Xtensors) const{
+
+   #ifdef CHEMPS2_MPI_COMPILATION
+   const int MPIRANK = MPIchemps2::mpi_rank();
+   #endif
+
+   const int theindex = denT->gIndex();
+   const bool atLeft  = ( theindex == 0 );
+   const bool atRight = ( theindex == Prob->gL() - 1 );
+   const bool leftSum = ( theindex < Prob->gL()*0.5 )?true:false;
+
+   #pragma omp parallel for schedule(dynamic)
+   for ( int ikappa = 0; ikappa < denT->gNKappa(); ikappa++ ){
+
+      const int NL = denT->gNL(ikappa); const int TwoSL = denT->gTwoSL(ikappa); const int IL = denT->gIL(ikappa);
+      const int NR = denT->gNR(ikappa); const int TwoSR = denT->gTwoSR(ikappa); const int IR = denT->gIR(ikappa);
+      const int N1 = NR - NL;
+      const int TwoJ = (( N1 == 1 ) ? 1 : 0 );
+      const int dimL = denBK->gCurrentDim( theindex,     NL, TwoSL, IL );
+      const int dimR = denBK->gCurrentDim( theindex + 1, NR, TwoSR, IR );
+      double * diag = memHeffDiag + denT->gKappa2index( ikappa );
+
+      /* The diagonal is the sum of a left part diag_left[ l ], a right part diag_right[ r ], and products
+         diag_left[ l ] * diag_right[ r ] of the F-operators with the C- and D-operators (diagram 2a3). */
+      double constant = 0.0;
+      for ( int cnt = 0; cnt < dimL * dimR; cnt++ ){ diag[ cnt ] = 0.0; }
+
+      #ifdef CHEMPS2_MPI_COMPILATION
+      if ( MPIchemps2::owner_1cd2d3eh() == MPIRANK )
+      #endif
+      { if ( N1 == 2 ){ constant += Prob->gMxElement( theindex, theindex, theindex, theindex ); } }
+
+      if ( !atLeft ){
+
+         #ifdef CHEMPS2_MPI_COMPILATION
+         if ( MPIchemps2::owner_x() == MPIRANK )
+         #endif
+         {
+            double * Xblock = Xtensors[ theindex - 1 ]->gStorage( NL, TwoSL, IL, NL, TwoSL, IL );
+            for ( int l = 0; l < dimL; l++ ){
+               for ( int r = 0; r < dimR; r++ ){ diag[ l + dimL * r ] += Xblock[ l * ( dimL + 1 ) ]; }
+            }
+         }
+
+         #ifdef CHEMPS2_MPI_COMPILATION
+         if ( MPIchemps2::owner_cdf( Prob->gL(), theindex, theindex ) == MPIRANK )
+         #endif
+         {
+            if ( N1 != 0 ){ // 2b3spin0 and 2b3spin1
+               double * Cblock = Ctensors[ theindex - 1 ][ 0 ][ 0 ]->gStorage( NL, TwoSL, IL, NL, TwoSL, IL );
+               double * Dblock = Dtensors[ theindex - 1 ][ 0 ][ 0 ]->gStorage( NL, TwoSL, IL, NL, TwoSL, IL );
+               const double alpha_c = (( N1 == 2 ) ? 1.0 : 0.5 ) * sqrt(2.0);
+               const double alpha_d = (( N1 == 1 ) ? Special::phase(TwoSL + TwoSR + 1) * sqrt(12.0 * (TwoSL + 1)) * Wigner::wigner6j(1, 1, 2, 1, 1, 0) * Wigner::wigner6j(1, 1, 2, TwoSL, TwoSL, TwoSR) : 0.0 );
+               for ( int l = 0; l < dimL; l++ ){
+                  const double value = alpha_c * Cblock[ l * ( dimL + 1 ) ] + (( Dblock == NULL ) ? 0.0 : alpha_d * Dblock[ l * ( dimL + 1 ) ] );
+                  for ( int r = 0; r < dimR; r++ ){ diag[ l + dimL * r ] += value; }
+               }
+            }
+         }
+
+      }
+
+      if ( !atRight ){
+
+         #ifdef CHEMPS2_MPI_COMPILATION
+         if ( MPIchemps2::owner_x() == MPIRANK )
+         #endif
+         {
+            double * Xblock = Xtensors[ theindex ]->gStorage( NR, TwoSR, IR, NR, TwoSR, IR );
+            for ( int r = 0; r < dimR; r++ ){
+               for ( int l = 0; l < dimL; l++ ){ diag[ l + dimL * r ] += Xblock[ r * ( dimR + 1 ) ]; }
+            }
+         }
+
+         #ifdef CHEMPS2_MPI_COMPILATION
+         if ( MPIchemps2::owner_cdf( Prob->gL(), theindex, theindex ) == MPIRANK )
+         #endif
+         {
+            if ( N1 != 0 ){ // 2e3spin0 and 2e3spin1
+               double * Cblock = Ctensors[ theindex ][ 0 ][ 0 ]->gStorage( NR, TwoSR, IR, NR, TwoSR, IR );
+               double * Dblock = Dtensors[ theindex ][ 0 ][ 0 ]->gStorage( NR, TwoSR, IR, NR, TwoSR, IR );
+               const double alpha_c = (( N1 == 2 ) ? 1.0 : 0.5 ) * sqrt(2.0);
+               const double alpha_d = (( N1 == 1 ) ? Special::phase(TwoSR + TwoSL + 3) * sqrt(12.0 * (TwoSR + 1)) * Wigner::wigner6j(1, 1, 2, 1, 1, 0) * Wigner::wigner6j(1, 1, 2, TwoSR, TwoSR, TwoSL) : 0.0 );
+               for ( int r = 0; r < dimR; r++ ){
+                  const double value = alpha_c * Cblock[ r * ( dimR + 1 ) ] + (( Dblock == NULL ) ? 0.0 : alpha_d * Dblock[ r * ( dimR + 1 ) ] );
+                  for ( int l = 0; l < dimL; l++ ){ diag[ l + dimL * r ] += value; }
+               }
+            }
+         }
+
+      }
+
+      if (( !atLeft ) && ( !atRight )){ // 2a3spin0 and 2a3spin1: only the operators of the trivial irrep have diagonal blocks
+
+         const int first = (( leftSum ) ? 0        : theindex + 1 );
+         const int last  = (( leftSum ) ? theindex : Prob->gL()   );
+         for ( int l_one = first; l_one < last; l_one++ ){
+            for ( int l_two = l_one; l_two < last; l_two++ ){
+               #ifdef CHEMPS2_MPI_COMPILATION
+               if ( MPIchemps2::owner_cdf( Prob->gL(), l_one, l_two ) == MPIRANK )
+               #endif
+               {
+                  if ( denBK->gIrrep( l_one ) == denBK->gIrrep( l_two ) ){
+                     for ( int spin = 0; spin < 2; spin++ ){
+                        TensorOperator * Left;
+                        TensorOperator * Right;
+                        if ( leftSum ){
+                           Left  = (( spin == 0 ) ? (TensorOperator *) F0tensors[theindex-1][l_two-l_one][theindex-1-l_two] : (TensorOperator *) F1tensors[theindex-1][l_two-l_one][theindex-1-l_two] );
+                           Right = (( spin == 0 ) ? Ctensors[theindex][l_two-l_one][theindex-l_two] : Dtensors[theindex][l_two-l_one][theindex-l_two] );
+                        } else {
+                           Left  = (( spin == 0 ) ? Ctensors[theindex-1][l_two-l_one][l_one-theindex] : Dtensors[theindex-1][l_two-l_one][l_one-theindex] );
+                           Right = (( spin == 0 ) ? (TensorOperator *) F0tensors[theindex][l_two-l_one][l_one-theindex-1] : (TensorOperator *) F1tensors[theindex][l_two-l_one][l_one-theindex-1] );
+                        }
+                        double * Lblock = Left ->gStorage( NL, TwoSL, IL, NL, TwoSL, IL );
+                        double * Rblock = Right->gStorage( NR, TwoSR, IR, NR, TwoSR, IR );
+                        if (( Lblock != NULL ) && ( Rblock != NULL )){
+                           double factor = (( l_one < l_two ) ? 2.0 : 1.0 );
+                           if ( spin == 1 ){ factor *= Special::phase(TwoSL + TwoSR + TwoJ + 2) * sqrt((TwoSR + 1) * (TwoSL + 1.0)) * Wigner::wigner6j(TwoSL, TwoSR, TwoJ, TwoSR, TwoSL, 2); }
+                           for ( int r = 0; r < dimR; r++ ){
+                              for ( int l = 0; l < dimL; l++ ){ diag[ l + dimL * r ] += factor * Lblock[ l * ( dimL + 1 ) ] * Rblock[ r * ( dimR + 1 ) ]; }
+                           }
+                        }
+                     }
+                  }
+               }
+            }
+         }
+
+      }
+
+      for ( int cnt = 0; cnt < dimL * dimR; cnt++ ){ diag[ cnt ] += constant; }
+
+   }
+
+}
+
+double CheMPS2::HeffOneSite::SolveDAVIDSON(TensorT * denT, TensorL *** Ltensors, TensorOperator **** Atensors, TensorOperator **** Btensors, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorS0 **** S0tensors, TensorS1 **** S1tensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorQ *** Qtensors, TensorX ** Xtensors) const{
+
+   #ifdef CHEMPS2_MPI_COMPILATION
+   if ( MPIchemps2::mpi_rank() != MPI_CHEMPS2_MASTER ){
+      return SolveDAVIDSON_help(denT, Ltensors, Atensors, Btensors, Ctensors, Dtensors, S0tensors, S1tensors, F0tensors, F1tensors, Qtensors, Xtensors);
+   }
+   #endif
+   return SolveDAVIDSON_main(denT, Ltensors, Atensors, Btensors, Ctensors, Dtensors, S0tensors, S1tensors, F0tensors, F1tensors, Qtensors, Xtensors);
+
+}
+
+double CheMPS2::HeffOneSite::SolveDAVIDSON_main(TensorT * denT, TensorL *** Ltensors, TensorOperator **** Atensors, TensorOperator **** Btensors, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorS0 **** S0tensors, TensorS1 **** S1tensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorQ *** Qtensors, TensorX ** Xtensors) const{
+
+   const long long veclength = denT->gKappa2index( denT->gNKappa() );
+
+   Davidson deBoskabouter( veclength, CheMPS2::DAVIDSON_NUM_VEC,
+                                      CheMPS2::DAVIDSON_NUM_VEC_KEEP,
+                                      dvdson_rtol,
+                                      CheMPS2::DAVIDSON_PRECOND_CUTOFF, CheMPS2::HEFF_debugPrint );
+   double ** whichpointers = new double*[2];
+
+   char instruction = deBoskabouter.FetchInstruction( whichpointers );
+   assert( instruction == 'A' );
+   convention( denT, true ); // Convert mem of TensorT to symmetric conventions
+   Special::dcopy64( veclength, denT->gStorage(), whichpointers[0] ); // Starting vector for Davidson is the current MPS tensor in symmetric conventions
+   #ifdef CHEMPS2_MPI_COMPILATION
+      double * workspace = new double[ veclength ];
+      fillHeffDiag(workspace, denT, Ctensors, Dtensors, F0tensors, F1tensors, Xtensors);
+      MPIchemps2::reduce_array_double( workspace, whichpointers[1], veclength, MPI_CHEMPS2_MASTER );
+   #else
+      fillHeffDiag(whichpointers[1], denT, Ctensors, Dtensors, F0tensors, F1tensors, Xtensors);
+   #endif
+
+   instruction = deBoskabouter.FetchInstruction( whichpointers );
+   while ( instruction == 'B' ){
+
+      #ifdef CHEMPS2_MPI_COMPILATION
+      {
+         int mpi_instruction = 2;
+         MPIchemps2::broadcast_array_int( &mpi_instruction, 1, MPI_CHEMPS2_MASTER );
+         MPIchemps2::broadcast_array_double( whichpointers[0], veclength, MPI_CHEMPS2_MASTER );
+         makeHeff(whichpointers[0], workspace, denT, Ltensors, Atensors, Btensors, Ctensors, Dtensors, S0tensors, S1tensors, F0tensors, F1tensors, Qtensors, Xtensors);
+         MPIchemps2::reduce_array_double( workspace, whichpointers[1], veclength, MPI_CHEMPS2_MASTER );
+      }
+      #else
+         makeHeff(whichpointers[0], whichpointers[1], denT, Ltensors, Atensors, Btensors, Ctensors, Dtensors, S0tensors, S1tensors, F0tensors, F1tensors, Qtensors, Xtensors);
+      #endif
+      instruction = deBoskabouter.FetchInstruction( whichpointers );
+   }
+
+   assert( instruction == 'C' );
+   Special::dcopy64( veclength, whichpointers[0], denT->gStorage() ); // Copy the solution in symmetric conventions back
+   convention( denT, false ); // Convert mem of TensorT to program conventions
+   double eigenvalue = whichpointers[1][0];
+   num_matvec = deBoskabouter.GetNumMultiplications();
+   if (CheMPS2::HEFF_debugPrint){ std::cout << "   Stats: nIt(DAVIDSON) = " << deBoskabouter.GetNumMultiplications() << std::endl; }
+   delete [] whichpointers;
+   #ifdef CHEMPS2_MPI_COMPILATION
+      delete [] workspace;
+      int mpi_instruction = 3;
+      MPIchemps2::broadcast_array_int( &mpi_instruction, 1, MPI_CHEMPS2_MASTER );
+      MPIchemps2::broadcast_array_double( &eigenvalue, 1, MPI_CHEMPS2_MASTER );
+   #endif
+   return eigenvalue;
+
+}
+
+#ifdef CHEMPS2_MPI_COMPILATION
+double CheMPS2::HeffOneSite::SolveDAVIDSON_help(TensorT * denT, TensorL *** Ltensors, TensorOperator **** Atensors, TensorOperator **** Btensors, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorS0 **** S0tensors, TensorS1 **** S1tensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorQ *** Qtensors, TensorX ** Xtensors) const{
+
+   const long long veclength = denT->gKappa2index( denT->gNKappa() );
+   double * vecin  = new double[ veclength ];
+   double * vecout = new double[ veclength ];
+   int mpi_instruction = -1;
+
+   fillHeffDiag( vecout, denT, Ctensors, Dtensors, F0tensors, F1tensors, Xtensors );
+   MPIchemps2::reduce_array_double( vecout, vecin, veclength, MPI_CHEMPS2_MASTER );
+   MPIchemps2::broadcast_array_int( &mpi_instruction, 1, MPI_CHEMPS2_MASTER );
+
+   while ( mpi_instruction == 2 ){ // Mat Vec
+
+      MPIchemps2::broadcast_array_double( vecin, veclength, MPI_CHEMPS2_MASTER );
+      makeHeff(vecin, vecout, denT, Ltensors, Atensors, Btensors, Ctensors, Dtensors, S0tensors, S1tensors, F0tensors, F1tensors, Qtensors, Xtensors);
+      MPIchemps2::reduce_array_double( vecout, vecin, veclength, MPI_CHEMPS2_MASTER );
+      MPIchemps2::broadcast_array_int( &mpi_instruction, 1, MPI_CHEMPS2_MASTER );
+
+   }
+
+   assert( mpi_instruction == 3 ); // Receive energy
+   double eigenvalue = 0.0;
+   MPIchemps2::broadcast_array_double( &eigenvalue, 1, MPI_CHEMPS2_MASTER );
+   delete [] vecin;
+   delete [] vecout;
+
+   return eigenvalue; // The eigenvalue is correct on each process, denT not
+
+}
+#endif
+
+void CheMPS2::HeffOneSite::expansion_sector(TensorT * denT, const bool moving_right, const int NM, const int TwoSM, const int IM, const int num_blocks, const int * blockN, const int * blockTwoS, const int * blockI, const int * offset, double * stacked, double * rho, const double alpha, TensorL *** Ltensors) const{
+
+   /* Moving right, the rows of stacked are the left sectors ( NL, TwoSL, IL ) which couple with the site to the bond sector,
+      and stacked contains the blocks T( NL, NM ). Moving left, the rows are the right sectors ( NR, TwoSR, IR ), and stacked
+      contains sqrt( ( TwoSR + 1 ) / ( TwoSM + 1 ) ) * T( NM, NR )^T. In both cases rho = stacked * stacked^T is the reduced
+      density matrix of the bond sector. It is enlarged with alpha^2 * P * P^T, with P the terms of the Hamiltonian with a single
+      2nd quantized operator on the bond and the other three on the site or the boundary opposite to the bond, without the
+      operator on the bond. Each group of terms which ends in the same sector on the bond gets its own P. */
+   const int theindex = denT->gIndex();
+   const int bound    = (( moving_right ) ? theindex + 1 : theindex );
+   const int other    = (( moving_right ) ? theindex : theindex + 1 );
+   int rows = offset[ num_blocks ];
+   int dimM = denBK->gCurrentDim( bound, NM, TwoSM, IM );
+   const int theirrep = denBK->gIrrep( theindex );
+   char uplo = 'U';
+   char notrans = 'N';
+   char trans = 'T';
+   double one = 1.0;
+
+   for ( long long cnt = 0; cnt < ((long long) rows ) * rows; cnt++ ){ rho[ cnt ] = 0.0; }
+   for ( long long cnt = 0; cnt < ((long long) rows ) * dimM; cnt++ ){ stacked[ cnt ] = 0.0; }
+   for ( int block = 0; block < num_blocks; block++ ){
+      const int dimB = offset[ block + 1 ] - offset[ block ];
+      if ( moving_right ){
+         const int ikappa = denT->gKappa( blockN[ block ], blockTwoS[ block ], blockI[ block ], NM, TwoSM, IM );
+         if ( ikappa != -1 ){
+            double * Tblock = denT->gStorage() + denT->gKappa2index( ikappa );
+            for ( int col = 0; col < dimM; col++ ){
+               for ( int row = 0; row < dimB; row++ ){ stacked[ offset[ block ] + row + rows * col ] = Tblock[ row + dimB * col ]; }
+            }
+         }
+      } else {
+         const int ikappa = denT->gKappa( NM, TwoSM, IM, blockN[ block ], blockTwoS[ block ], blockI[ block ] );
+         if ( ikappa != -1 ){
+            double * Tblock = denT->gStorage() + denT->gKappa2index( ikappa );
+            const double factor = sqrt( ( blockTwoS[ block ] + 1.0 ) / ( TwoSM + 1 ) );
+            for ( int col = 0; col < dimM; col++ ){
+               for ( int row = 0; row < dimB; row++ ){ stacked[ offset[ block ] + row + rows * col ] = factor * Tblock[ col + dimM * row ]; }
+            }
+         }
+      }
+   }
+   if ( dimM > 0 ){ dsyrk_( &uplo, &notrans, &rows, &dimM, &one, stacked, &rows, &one, rho, &rows ); }
+   if ( alpha == 0.0 ){ return; }
+
+   double alpha_sq = alpha * alpha;
+   const int num_ops = 1 + (( moving_right ) ? theindex : Prob->gL() - 1 - theindex );
+   for ( int op = 0; op < num_ops; op++ ){ // op == 0 is the site, op > 0 the orbitals of the opposite boundary
+      const int orb = (( op == 0 ) ? theindex : (( moving_right ) ? op - 1 : theindex + op ));
+      TensorL * Lop = (( op == 0 ) ? NULL : (( moving_right ) ? Ltensors[ theindex - 1 ][ theindex - 1 - orb ] : Ltensors[ theindex ][ orb - theindex - 1 ] ));
+      const int IMdown = Irreps::directProd( IM, (( op == 0 ) ? theirrep : denBK->gIrrep( orb )) );
+      for ( int dir = -1; dir <= 1; dir += 2 ){
+         const int NMdown = NM + dir;
+         for ( int TwoSMdown = TwoSM - 1; TwoSMdown <= TwoSM + 1; TwoSMdown += 2 ){
+            int cols = (( TwoSMdown >= 0 ) ? denBK->gCurrentDim( bound, NMdown, TwoSMdown, IMdown ) : 0 );
+            if ( cols == 0 ){ continue; }
+            double * P = work->get_double( 0, ((long long) rows ) * cols );
+            for ( long long cnt = 0; cnt < ((long long) rows ) * cols; cnt++ ){ P[ cnt ] = 0.0; }
+            bool filled = false;
+
+            for ( int block = 0; block < num_blocks; block++ ){
+               const int NB = blockN[ block ]; const int TwoSB = blockTwoS[ block ]; const int IB = blockI[ block ];
+               int dimB = offset[ block + 1 ] - offset[ block ];
+               const int N1 = (( moving_right ) ? NM - NB : NB - NM );
+               const int TwoJ = (( N1 == 1 ) ? 1 : 0 );
+               // With moving_right, ( TwoSL, TwoSR ) = ( TwoSB, TwoSM ), else ( TwoSM, TwoSB ); the prefactors follow diagrams 3A, 3C, 3F and 3J
+               if ( op == 0 ){
+                  const int ikappa = (( moving_right ) ? denT->gKappa( NB, TwoSB, IB, NMdown, TwoSMdown, IMdown )
+                                                       : denT->gKappa( NMdown, TwoSMdown, IMdown, NB, TwoSB, IB ));
+                  const int N1down = N1 - (( moving_right ) ? -dir : dir );
+                  if (( ikappa == -1 ) || ( N1down < 0 ) || ( N1down > 2 )){ continue; }
+                  const int TwoSupper = (( N1     == 1 ) ? 1 : 0 );
+                  const int TwoSlower = (( N1down == 1 ) ? 1 : 0 );
+                  const int TwoSmore  = (( N1 > N1down ) ? TwoSM : TwoSMdown ); // The bond spin of the sector with the most electrons on the site
+                  const int TwoSless  = (( N1 > N1down ) ? TwoSMdown : TwoSM );
+                  double factor = Special::phase( TwoSB + TwoSmore + 1 + (( N1 + N1down == 3 ) ? 1 : 0 ) )
+                                * sqrt( 2.0 * ((( moving_right ) ? TwoSmore : TwoSless ) + 1 ) )
+                                * Wigner::wigner6j( TwoSlower, TwoSupper, 1, TwoSM, TwoSMdown, TwoSB );
+                  factor *= (( moving_right ) ? sqrt( ( TwoSMdown + 1.0 ) / ( TwoSM + 1 ) ) : sqrt( ( TwoSB + 1.0 ) / ( TwoSM + 1 ) ));
+                  double * Tblock = denT->gStorage() + denT->gKappa2index( ikappa );
+                  for ( int col = 0; col < cols; col++ ){
+                     for ( int row = 0; row < dimB; row++ ){
+                        P[ offset[ block ] + row + rows * col ] += factor * (( moving_right ) ? Tblock[ row + dimB * col ] : Tblock[ col + cols * row ] );
+                     }
+                  }
+                  filled = true;
+               } else {
+                  const int IBdown = Irreps::directProd( IB, denBK->gIrrep( orb ) );
+                  const int NBdown = NB + dir;
+                  for ( int TwoSBdown = TwoSB - 1; TwoSBdown <= TwoSB + 1; TwoSBdown += 2 ){
+                     if ( TwoSBdown < 0 ){ continue; }
+                     const int ikappa = (( moving_right ) ? denT->gKappa( NBdown, TwoSBdown, IBdown, NMdown, TwoSMdown, IMdown )
+                                                          : denT->gKappa( NMdown, TwoSMdown, IMdown, NBdown, TwoSBdown, IBdown ));
+                     if ( ikappa == -1 ){ continue; }
+                     double * Lblock = (( dir == 1 ) ? Lop->gStorage( NB, TwoSB, IB, NBdown, TwoSBdown, IBdown )
+                                                     : Lop->gStorage( NBdown, TwoSBdown, IBdown, NB, TwoSB, IB ));
+                     if ( Lblock == NULL ){ continue; }
+                     const int TwoSL     = (( moving_right ) ? TwoSB     : TwoSM     );
+                     const int TwoSR     = (( moving_right ) ? TwoSM     : TwoSB     );
+                     const int TwoSLdown = (( moving_right ) ? TwoSBdown : TwoSMdown );
+                     const int TwoSRdown = (( moving_right ) ? TwoSMdown : TwoSBdown );
+                     double factor = (( dir == 1 ) ? Special::phase( TwoSLdown + TwoSR + TwoJ + 1 + (( N1 == 1 ) ? 2 : 0 ) ) * sqrt( ( TwoSLdown + 1.0 ) * ( TwoSRdown + 1 ) )
+                                                   : Special::phase( TwoSL + TwoSRdown + TwoJ + 1 + (( N1 == 1 ) ? 2 : 0 ) ) * sqrt( ( TwoSL + 1.0 ) * ( TwoSR + 1 ) ))
+                                   * Wigner::wigner6j( TwoSL, TwoSR, TwoJ, TwoSRdown, TwoSLdown, 1 );
+                     factor *= sqrt( ( TwoSRdown + 1.0 ) / ( TwoSM + 1 ) );
+                     int dimBdown = denBK->gCurrentDim( other, NBdown, TwoSBdown, IBdown );
+                     double * Tblock = denT->gStorage() + denT->gKappa2index( ikappa );
+                     if ( moving_right ){ // P_block += factor * L * T( down ), with L the ( up, down ) block
+                        char op_trans = (( dir == 1 ) ? 'N' : 'T' );
+                        int ld_op = (( dir == 1 ) ? dimB : dimBdown );
+                        dgemm_( &op_trans, &notrans, &dimB, &cols, &dimBdown, &factor, Lblock, &ld_op, Tblock, &dimBdown, &one, P + offset[ block ], &rows );
+                     } else { // P_block += factor * L * T( down )^T, with L the ( up, down ) block
+                        char op_trans = (( dir == 1 ) ? 'N' : 'T' );
+                        int ld_op = (( dir == 1 ) ? dimB : dimBdown );
+                        dgemm_( &op_trans, &trans, &dimB, &cols, &dimBdown, &factor, Lblock, &ld_op, Tblock, &cols, &one, P + offset[ block ], &rows );
+                     }
+                     filled = true;
+                  }
+               }
+            }
+
+            if ( filled ){ dsyrk_( &uplo, &notrans, &rows, &cols, &alpha_sq, P, &rows, &one, rho, &rows ); }
+         }
+      }
+   }
+
+}
+
+double CheMPS2::HeffOneSite::Expand(TensorT * denT, TensorT * neighbour, const double alpha, const int virtualdimensionD, const bool change, const double max_discarded_weight, const int min_dimension, TensorL *** Ltensors) const{
+
+   const int theindex = denT->gIndex();
+   const bool moving_right = ( neighbour->gIndex() == theindex + 1 );
+   assert( neighbour->gIndex() == theindex + (( moving_right ) ? 1 : -1 ) );
+   const int bound    = (( moving_right ) ? theindex + 1 : theindex );
+   const int other    = (( moving_right ) ? theindex : theindex + 1 );
+   const int theirrep = denBK->gIrrep( theindex );
+
+   #ifdef CHEMPS2_MPI_COMPILATION
+   const bool am_i_master = ( MPIchemps2::mpi_rank() == MPI_CHEMPS2_MASTER );
+   #else
+   const bool am_i_master = true;
+   #endif
+
+   // Get the bond sectors
+   int nSectors = 0;
+   for ( int NM = denBK->gNmin( bound ); NM <= denBK->gNmax( bound ); NM++ ){
+      for ( int TwoSM = denBK->gTwoSmin( bound, NM ); TwoSM <= denBK->gTwoSmax( bound, NM ); TwoSM += 2 ){
+         for ( int IM = 0; IM < denBK->getNumberOfIrreps(); IM++ ){
+            if ( denBK->gFCIdim( bound, NM, TwoSM, IM ) > 0 ){ nSectors++; }
+         }
+      }
+   }
+   int * SectNM    = new int[ nSectors ];
+   int * SectTwoSM = new int[ nSectors ];
+   int * SectIM    = new int[ nSectors ];
+   int * OldDims   = new int[ nSectors ];
+   int * NewDims   = new int[ nSectors ];
+   nSectors = 0;
+   for ( int NM = denBK->gNmin( bound ); NM <= denBK->gNmax( bound ); NM++ ){
+      for ( int TwoSM = denBK->gTwoSmin( bound, NM ); TwoSM <= denBK->gTwoSmax( bound, NM ); TwoSM += 2 ){
+         for ( int IM = 0; IM < denBK->getNumberOfIrreps(); IM++ ){
+            if ( denBK->gFCIdim( bound, NM, TwoSM, IM ) > 0 ){
+               SectNM   [ nSectors ] = NM;
+               SectTwoSM[ nSectors ] = TwoSM;
+               SectIM   [ nSectors ] = IM;
+               OldDims  [ nSectors ] = denBK->gCurrentDim( bound, NM, TwoSM, IM );
+               NewDims  [ nSectors ] = OldDims[ nSectors ];
+               nSectors++;
+            }
+         }
+      }
+   }
+
+   /* Per bond sector, at most four sectors of the other boundary of denT couple with the site to it. The MPI_CHEMPS2_MASTER
+      process stacks their blocks, and diagonalizes the enlarged reduced density matrix: rho is overwritten by its eigenvectors,
+      and eigs contains its eigenvalues, both in decreasing order. */
+   int * BlockN      = NULL;
+   int * BlockTwoS   = NULL;
+   int * BlockI      = NULL;
+   int * BlockOffset = NULL;
+   int * NumBlocks   = NULL;
+   double ** Stacked = NULL;
+   double ** Rhos    = NULL;
+   double ** Eigs    = NULL;
+   TensorT * old_neighbour = NULL;
+   double discardedWeight = 0.0; // Only if change==true; will the discardedWeight be meaningful and different from zero.
+   int updateSectors = 0;
+
+   if ( am_i_master ){
+
+      BlockN      = new int[ 4 * nSectors ];
+      BlockTwoS   = new int[ 4 * nSectors ];
+      BlockI      = new int[ 4 * nSectors ];
+      BlockOffset = new int[ 5 * nSectors ];
+      NumBlocks   = new int[ nSectors ];
+      Stacked     = new double*[ nSectors ];
+      Rhos        = new double*[ nSectors ];
+      Eigs        = new double*[ nSectors ];
+
+      #pragma omp parallel for schedule(dynamic)
+      for ( int iSect = 0; iSect < nSectors; iSect++ ){
+         const int NM = SectNM[ iSect ];
+         const int TwoSM = SectTwoSM[ iSect ];
+         const int IM = SectIM[ iSect ];
+         int num = 0;
+         BlockOffset[ 5 * iSect ] = 0;
+         for ( int N1 = 0; N1 <= 2; N1++ ){
+            const int TwoS1 = (( N1 == 1 ) ? 1 : 0 );
+            const int NB = (( moving_right ) ? NM - N1 : NM + N1 );
+            const int IB = (( TwoS1 == 1 ) ? Irreps::directProd( IM, theirrep ) : IM );
+            for ( int TwoSB = TwoSM - TwoS1; TwoSB <= TwoSM + TwoS1; TwoSB += 2 ){
+               const int dimB = (( TwoSB >= 0 ) ? denBK->gCurrentDim( other, NB, TwoSB, IB ) : 0 );
+               if ( dimB > 0 ){
+                  BlockN   [ 4 * iSect + num ] = NB;
+                  BlockTwoS[ 4 * iSect + num ] = TwoSB;
+                  BlockI   [ 4 * iSect + num ] = IB;
+                  BlockOffset[ 5 * iSect + num + 1 ] = BlockOffset[ 5 * iSect + num ] + dimB;
+                  num++;
+               }
+            }
+         }
+         NumBlocks[ iSect ] = num;
+         int rows = BlockOffset[ 5 * iSect + num ];
+         Stacked[ iSect ] = NULL;
+         Rhos   [ iSect ] = NULL;
+         Eigs   [ iSect ] = NULL;
+         if ( rows > 0 ){
+            Stacked[ iSect ] = new double[ std::max( 1LL, ((long long) rows ) * OldDims[ iSect ] ) ];
+            Rhos   [ iSect ] = new double[ ((long long) rows ) * rows ];
+            Eigs   [ iSect ] = new double[ rows ];
+            expansion_sector( denT, moving_right, NM, TwoSM, IM, num, BlockN + 4 * iSect, BlockTwoS + 4 * iSect, BlockI + 4 * iSect, BlockOffset + 5 * iSect, Stacked[ iSect ], Rhos[ iSect ], alpha, Ltensors );
+
+            char jobz = 'V';
+            char uplo = 'U';
+            int lwork = 34 * rows;
+            double * eig_work = work->get_double( 1, lwork );
+            int info;
+            if ( SPLIT_LAPACK_threadsafe ){
+               dsyev_( &jobz, &uplo, &rows, Rhos[ iSect ], &rows, Eigs[ iSect ], eig_work, &lwork, &info );
+            } else {
+               #pragma omp critical
+               dsyev_( &jobz, &uplo, &rows, Rhos[ iSect ], &rows, Eigs[ iSect ], eig_work, &lwork, &info );
+            }
+
+            // Reverse the order to decreasing eigenvalues
+            for ( int low = 0, high = rows - 1; low < high; low++, high-- ){
+               const double temp = Eigs[ iSect ][ low ];
+               Eigs[ iSect ][ low  ] = Eigs[ iSect ][ high ];
+               Eigs[ iSect ][ high ] = temp;
+               for ( int cnt = 0; cnt < rows; cnt++ ){
+                  const double temp2 = Rhos[ iSect ][ cnt + rows * low ];
+                  Rhos[ iSect ][ cnt + rows * low  ] = Rhos[ iSect ][ cnt + rows * high ];
+                  Rhos[ iSect ][ cnt + rows * high ] = temp2;
+               }
+            }
+            for ( int cnt = 0; cnt < rows; cnt++ ){ Eigs[ iSect ][ cnt ] = std::max( Eigs[ iSect ][ cnt ], 0.0 ); }
+         }
+      }
+
+      // If change: determine new virtual dimensions, as in Sobject::Split with the eigenvalues of the enlarged reduced density matrices
+      if ( change ){
+
+         int totalDim = 0;
+         for ( int iSect = 0; iSect < nSectors; iSect++ ){
+            NewDims[ iSect ] = std::min( BlockOffset[ 5 * iSect + NumBlocks[ iSect ] ], denBK->gFCIdim( bound, SectNM[ iSect ], SectTwoSM[ iSect ], SectIM[ iSect ] ) );
+            totalDim += NewDims[ iSect ];
+         }
+
+         if (( totalDim > virtualdimensionD ) || ( max_discarded_weight > 0.0 )){
+            double * values = new double[ std::max( 1, totalDim ) ];
+            double totalSum = 0.0;
+            totalDim = 0;
+            for ( int iSect = 0; iSect < nSectors; iSect++ ){
+               for ( int cnt = 0; cnt < NewDims[ iSect ]; cnt++ ){ values[ totalDim++ ] = Eigs[ iSect ][ cnt ]; }
+               for ( int cnt = 0; cnt < BlockOffset[ 5 * iSect + NumBlocks[ iSect ] ]; cnt++ ){ totalSum += ( SectTwoSM[ iSect ] + 1 ) * Eigs[ iSect ][ cnt ]; }
+            }
+            char ID = 'D';
+            int info;
+            dlasrt_( &ID, &totalDim, values, &info ); // Quicksort
+
+            // The number of states to keep: the discarded weight decreases monotonically with it, hence bisection
+            int num_keep = std::min( virtualdimensionD, totalDim );
+            if ( max_discarded_weight > 0.0 ){
+               int lower = std::max( 0, std::min( min_dimension, num_keep ) );
+               while ( lower < num_keep ){
+                  const int middle = ( lower + num_keep ) / 2;
+                  double discarded = 0.0;
+                  for ( int iSect = 0; iSect < nSectors; iSect++ ){
+                     for ( int cnt = 0; cnt < BlockOffset[ 5 * iSect + NumBlocks[ iSect ] ]; cnt++ ){
+                        if ( Eigs[ iSect ][ cnt ] <= values[ middle ] ){ discarded += ( SectTwoSM[ iSect ] + 1 ) * Eigs[ iSect ][ cnt ]; }
+                     }
+                  }
+                  if ( discarded <= max_discarded_weight * totalSum ){ num_keep = middle; }
+                  else { lower = middle + 1; }
+               }
+            }
+
+            if ( num_keep < totalDim ){
+               const double lowerBound = values[ num_keep ];
+               for ( int iSect = 0; iSect < nSectors; iSect++ ){
+                  for ( int cnt = 0; cnt < NewDims[ iSect ]; cnt++ ){
+                     if ( Eigs[ iSect ][ cnt ] <= lowerBound ){ NewDims[ iSect ] = cnt; }
+                  }
+               }
+            }
+            delete [] values;
+         }
+
+         for ( int iSect = 0; iSect < nSectors; iSect++ ){
+            if ( NewDims[ iSect ] != OldDims[ iSect ] ){ updateSectors = 1; }
+         }
+
+      }
+
+      // The old neighbour keeps the layout of the old virtual dimensions
+      old_neighbour = new TensorT( neighbour->gIndex(), denBK );
+      Special::dcopy64( neighbour->gKappa2index( neighbour->gNKappa() ), neighbour->gStorage(), old_neighbour->gStorage() );
+
+   }
+
+   #ifdef CHEMPS2_MPI_COMPILATION
+   MPIchemps2::broadcast_array_int( &updateSectors, 1, MPI_CHEMPS2_MASTER );
+   #endif
+
+   if ( updateSectors == 1 ){
+
+      #ifdef CHEMPS2_MPI_COMPILATION
+      MPIchemps2::broadcast_array_int( NewDims, nSectors, MPI_CHEMPS2_MASTER );
+      #endif
+
+      for ( int iSect = 0; iSect < nSectors; iSect++ ){
+         denBK->SetDim( bound, SectNM[ iSect ], SectTwoSM[ iSect ], SectIM[ iSect ], NewDims[ iSect ] );
+      }
+      denT->Reset();
+      neighbour->Reset();
+
+   }
+
+   if ( am_i_master ){
+
+      /* With U the leading eigenvectors of rho, the new denT is U ( moving_right ) or sqrt( ( TwoSM + 1 ) / ( TwoSR + 1 ) ) * U^T ( !moving_right ),
+         and C = U^T * stacked is moved into the neighbour: neighbour = C * neighbour ( moving_right ) or neighbour * C^T ( !moving_right ). */
+      double total_norm = 0.0;
+      double kept_norm  = 0.0;
+      #pragma omp parallel for schedule(dynamic) reduction(+:total_norm,kept_norm)
+      for ( int iSect = 0; iSect < nSectors; iSect++ ){
+         const int NM = SectNM[ iSect ];
+         const int TwoSM = SectTwoSM[ iSect ];
+         const int IM = SectIM[ iSect ];
+         int rows = BlockOffset[ 5 * iSect + NumBlocks[ iSect ] ];
+         int dimOld = OldDims[ iSect ];
+         int dimNew = NewDims[ iSect ];
+         int avail = std::min( dimNew, rows );
+         for ( long long cnt = 0; cnt < ((long long) rows ) * dimOld; cnt++ ){ total_norm += ( TwoSM + 1 ) * Stacked[ iSect ][ cnt ] * Stacked[ iSect ][ cnt ]; }
+         if ( dimNew == 0 ){ continue; }
+
+         double * C = work->get_double( 0, std::max( 1LL, ((long long) dimNew ) * dimOld ) ); // dimNew x dimOld, zero beyond avail
+         for ( long long cnt = 0; cnt < ((long long) dimNew ) * dimOld; cnt++ ){ C[ cnt ] = 0.0; }
+         if (( avail > 0 ) && ( dimOld > 0 )){
+            char trans = 'T';
+            char notrans = 'N';
+            double one = 1.0;
+            double zero = 0.0;
+            dgemm_( &trans, &notrans, &avail, &dimOld, &rows, &one, Rhos[ iSect ], &rows, Stacked[ iSect ], &rows, &zero, C, &dimNew );
+            for ( long long cnt = 0; cnt < ((long long) dimNew ) * dimOld; cnt++ ){ kept_norm += ( TwoSM + 1 ) * C[ cnt ] * C[ cnt ]; }
+         }
+
+         for ( int block = 0; block < NumBlocks[ iSect ]; block++ ){
+            const int NB = BlockN[ 4 * iSect + block ];
+            const int TwoSB = BlockTwoS[ 4 * iSect + block ];
+            const int IB = BlockI[ 4 * iSect + block ];
+            const int shift = BlockOffset[ 5 * iSect + block ];
+            const int dimB = BlockOffset[ 5 * iSect + block + 1 ] - shift;
+            if ( moving_right ){
+               double * Tblock = denT->gStorage( NB, TwoSB, IB, NM, TwoSM, IM );
+               for ( int col = 0; col < dimNew; col++ ){
+                  for ( int row = 0; row < dimB; row++ ){ Tblock[ row + dimB * col ] = (( col < avail ) ? Rhos[ iSect ][ shift + row + rows * col ] : 0.0 ); }
+               }
+            } else {
+               double * Tblock = denT->gStorage( NM, TwoSM, IM, NB, TwoSB, IB );
+               const double factor = sqrt( ( TwoSM + 1.0 ) / ( TwoSB + 1 ) );
+               for ( int col = 0; col < dimB; col++ ){
+                  for ( int row = 0; row < dimNew; row++ ){ Tblock[ row + dimNew * col ] = (( row < avail ) ? factor * Rhos[ iSect ][ shift + col + rows * row ] : 0.0 ); }
+               }
+            }
+         }
+
+         for ( int ikappa = 0; ikappa < neighbour->gNKappa(); ikappa++ ){
+            const bool match = ( moving_right ) ? (( neighbour->gNL( ikappa ) == NM ) && ( neighbour->gTwoSL( ikappa ) == TwoSM ) && ( neighbour->gIL( ikappa ) == IM ))
+                                                : (( neighbour->gNR( ikappa ) == NM ) && ( neighbour->gTwoSR( ikappa ) == TwoSM ) && ( neighbour->gIR( ikappa ) == IM ));
+            if ( match ){
+               const int NL = neighbour->gNL( ikappa ); const int TwoSL = neighbour->gTwoSL( ikappa ); const int IL = neighbour->gIL( ikappa );
+               const int NR = neighbour->gNR( ikappa ); const int TwoSR = neighbour->gTwoSR( ikappa ); const int IR = neighbour->gIR( ikappa );
+               double * block_new = neighbour->gStorage() + neighbour->gKappa2index( ikappa );
+               const int size = neighbour->gKappa2index( ikappa + 1 ) - neighbour->gKappa2index( ikappa );
+               for ( int cnt = 0; cnt < size; cnt++ ){ block_new[ cnt ] = 0.0; }
+               const int kappa_old = old_neighbour->gKappa( NL, TwoSL, IL, NR, TwoSR, IR );
+               if (( kappa_old != -1 ) && ( dimOld > 0 )){
+                  double * block_old = old_neighbour->gStorage() + old_neighbour->gKappa2index( kappa_old );
+                  char trans = 'T';
+                  char notrans = 'N';
+                  double one = 1.0;
+                  double zero = 0.0;
+                  if ( moving_right ){ // ( dimNew x dimR ) = C * ( dimOld x dimR )
+                     int dimR = size / dimNew;
+                     dgemm_( &notrans, &notrans, &dimNew, &dimR, &dimOld, &one, C, &dimNew, block_old, &dimOld, &zero, block_new, &dimNew );
+                  } else { // ( dimL x dimNew ) = ( dimL x dimOld ) * C^T
+                     int dimL = size / dimNew;
+                     dgemm_( &notrans, &trans, &dimL, &dimNew, &dimOld, &one, block_old, &dimL, C, &dimNew, &zero, block_new, &dimL );
+                  }
+               }
+            }
+         }
+      }
+      if (( change ) && ( total_norm > 0.0 )){ discardedWeight = std::max( 0.0, 1.0 - kept_norm / total_norm ); }
+
+   }
+
+   #ifdef CHEMPS2_MPI_COMPILATION
+   MPIchemps2::broadcast_array_double( &discardedWeight, 1, MPI_CHEMPS2_MASTER );
+   MPIchemps2::broadcast_tensor( denT,      MPI_CHEMPS2_MASTER );
+   MPIchemps2::broadcast_tensor( neighbour, MPI_CHEMPS2_MASTER );
+   #endif
+
+   // Clean up
+   if ( am_i_master ){
+      for ( int iSect = 0; iSect < nSectors; iSect++ ){
+         if ( Stacked[ iSect ] != NULL ){
+            delete [] Stacked[ iSect ];
+            delete [] Rhos[ iSect ];
+            delete [] Eigs[ iSect ];
+         }
+      }
+      delete [] Stacked;
+      delete [] Rhos;
+      delete [] Eigs;
+      delete [] BlockN;
+      delete [] BlockTwoS;
+      delete [] BlockI;
+      delete [] BlockOffset;
+      delete [] NumBlocks;
+      delete old_neighbour;
+   }
+   delete [] SectNM;
+   delete [] SectTwoSM;
+   delete [] SectIM;
+   delete [] OldDims;
+   delete [] NewDims;
+
+   return discardedWeight;
+
+}
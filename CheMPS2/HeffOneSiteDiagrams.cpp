@@ -0,0 +1,879 @@
+/*
+   CheMPS2: a spin-adapted implementation of DMRG for ab initio quantum chemistry
+   Copyright (C) 2013-2016 Sebastian Wouters
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "HeffOneSite.h"
+#include "Lapack.h"
+#include "MPIchemps2.h"
+#include "Irreps.h"
+#include "Wigner.h"
+#include "Special.h"
+
+/* The one-site diagrams are the two-site diagrams of the Heff class with an empty second site: the diagrams which contain
+   an operator on the second site vanish, and the others reduce to TwoJ = TwoS1. The sector ikappa of denT is the upper
+   sector; sandwich adds alpha * left * T( down ) * right to it, with NULL for the identity. The blocks of the left
+   operators are dimLup x dimLdown and the blocks of the right operators dimRdown x dimRup, or their transposes. */
+
+void CheMPS2::HeffOneSite::sandwich(const int ikappa, const int NLdown, const int TwoSLdown, const int ILdown, const int NRdown, const int TwoSRdown, const int IRdown, double alpha, double * left, const bool trans_left, double * right, const bool trans_right, double * memT, double * memHeff, const TensorT * denT, double * temp) const{
+
+   if (( TwoSLdown < 0 ) || ( TwoSRdown < 0 ) || ( alpha == 0.0 )){ return; }
+   const int kappa_down = denT->gKappa( NLdown, TwoSLdown, ILdown, NRdown, TwoSRdown, IRdown );
+   if ( kappa_down == -1 ){ return; }
+
+   const int index = denT->gIndex();
+   int dimLup   = denBK->gCurrentDim( index,     denT->gNL( ikappa ), denT->gTwoSL( ikappa ), denT->gIL( ikappa ) );
+   int dimRup   = denBK->gCurrentDim( index + 1, denT->gNR( ikappa ), denT->gTwoSR( ikappa ), denT->gIR( ikappa ) );
+   int dimLdown = denBK->gCurrentDim( index,     NLdown, TwoSLdown, ILdown );
+   int dimRdown = denBK->gCurrentDim( index + 1, NRdown, TwoSRdown, IRdown );
+   double * block_down = memT    + denT->gKappa2index( kappa_down );
+   double * block_up   = memHeff + denT->gKappa2index( ikappa );
+
+   char notrans = 'N';
+   char tleft   = (( trans_left  ) ? 'T' : 'N' );
+   char tright  = (( trans_right ) ? 'T' : 'N' );
+   int  ldleft  = (( trans_left  ) ? dimLdown : dimLup   );
+   int  ldright = (( trans_right ) ? dimRup   : dimRdown );
+   double one  = 1.0;
+   double zero = 0.0;
+
+   if (( left == NULL ) && ( right == NULL )){
+      int size = dimLup * dimRup;
+      int inc = 1;
+      daxpy_( &size, &alpha, block_down, &inc, block_up, &inc );
+   } else if ( left == NULL ){
+      dgemm_( &notrans, &tright, &dimLup, &dimRup, &dimRdown, &alpha, block_down, &dimLdown, right, &ldright, &one, block_up, &dimLup );
+   } else if ( right == NULL ){
+      dgemm_( &tleft, &notrans, &dimLup, &dimRup, &dimLdown, &alpha, left, &ldleft, block_down, &dimLdown, &one, block_up, &dimLup );
+   } else {
+      const double cost_left  = ( 1.0 * dimLup ) * dimRdown * ( dimLdown + dimRup );
+      const double cost_right = ( 1.0 * dimLdown ) * dimRup * ( dimRdown + dimLup );
+      if ( cost_left <= cost_right ){
+         dgemm_( &tleft, &notrans, &dimLup, &dimRdown, &dimLdown, &alpha, left, &ldleft, block_down, &dimLdown, &zero, temp, &dimLup );
+         dgemm_( &notrans, &tright, &dimLup, &dimRup, &dimRdown, &one, temp, &dimLup, right, &ldright, &one, block_up, &dimLup );
+      } else {
+         dgemm_( &notrans, &tright, &dimLdown, &dimRup, &dimRdown, &alpha, block_down, &dimLdown, right, &ldright, &zero, temp, &dimLdown );
+         dgemm_( &tleft, &notrans, &dimLup, &dimRup, &dimLdown, &one, left, &ldleft, temp, &dimLdown, &one, block_up, &dimLup );
+      }
+   }
+
+}
+
+/*********************
+*  Diagrams group 1  *
+*********************/
+
+void CheMPS2::HeffOneSite::addDiagram1A(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorX * Xleft, double * temp) const{
+
+   const int NL = denT->gNL(ikappa); const int TwoSL = denT->gTwoSL(ikappa); const int IL = denT->gIL(ikappa);
+   const int NR = denT->gNR(ikappa); const int TwoSR = denT->gTwoSR(ikappa); const int IR = denT->gIR(ikappa);
+   sandwich(ikappa, NL, TwoSL, IL, NR, TwoSR, IR, 1.0, Xleft->gStorage(NL, TwoSL, IL, NL, TwoSL, IL), false, NULL, false, memT, memHeff, denT, temp);
+
+}
+
+void CheMPS2::HeffOneSite::addDiagram1B(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorX * Xright, double * temp) const{
+
+   const int NL = denT->gNL(ikappa); const int TwoSL = denT->gTwoSL(ikappa); const int IL = denT->gIL(ikappa);
+   const int NR = denT->gNR(ikappa); const int TwoSR = denT->gTwoSR(ikappa); const int IR = denT->gIR(ikappa);
+   sandwich(ikappa, NL, TwoSL, IL, NR, TwoSR, IR, 1.0, NULL, false, Xright->gStorage(NR, TwoSR, IR, NR, TwoSR, IR), true, memT, memHeff, denT, temp);
+
+}
+
+void CheMPS2::HeffOneSite::addDiagram1C(const int ikappa, double * memT, double * memHeff, const TensorT * denT, const double Helem, double * temp) const{
+
+   const int NL = denT->gNL(ikappa); const int TwoSL = denT->gTwoSL(ikappa); const int IL = denT->gIL(ikappa);
+   const int NR = denT->gNR(ikappa); const int TwoSR = denT->gTwoSR(ikappa); const int IR = denT->gIR(ikappa);
+   if ( NR - NL == 2 ){ sandwich(ikappa, NL, TwoSL, IL, NR, TwoSR, IR, Helem, NULL, false, NULL, false, memT, memHeff, denT, temp); }
+
+}
+
+/*********************
+*  Diagrams group 2  *
+*********************/
+
+void CheMPS2::HeffOneSite::addDiagram2b(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorOperator * Atens, TensorOperator * Ctens, TensorOperator * Dtens, double * temp) const{
+
+   #ifdef CHEMPS2_MPI_COMPILATION
+   const int MPIRANK = MPIchemps2::mpi_rank();
+   #endif
+   const int NL = denT->gNL(ikappa); const int TwoSL = denT->gTwoSL(ikappa); const int IL = denT->gIL(ikappa);
+   const int NR = denT->gNR(ikappa); const int TwoSR = denT->gTwoSR(ikappa); const int IR = denT->gIR(ikappa);
+   const int N1 = NR - NL;
+   const int theindex = denT->gIndex();
+
+   #ifdef CHEMPS2_MPI_COMPILATION
+   if ( MPIchemps2::owner_absigma( theindex, theindex ) == MPIRANK )
+   #endif
+   {  //2b1 and 2b2
+      if ( N1 == 0 ){ sandwich(ikappa, NL-2, TwoSL, IL, NR, TwoSR, IR, sqrt(2.0), Atens->gStorage(NL-2, TwoSL, IL, NL, TwoSL, IL), true,  NULL, false, memT, memHeff, denT, temp); }
+      if ( N1 == 2 ){ sandwich(ikappa, NL+2, TwoSL, IL, NR, TwoSR, IR, sqrt(2.0), Atens->gStorage(NL, TwoSL, IL, NL+2, TwoSL, IL), false, NULL, false, memT, memHeff, denT, temp); }
+   }
+
+   #ifdef CHEMPS2_MPI_COMPILATION
+   if ( MPIchemps2::owner_cdf( Prob->gL(), theindex, theindex ) == MPIRANK )
+   #endif
+   {  //2b3spin0
+      if ( N1 != 0 ){
+         const double alpha = (( N1 == 2 ) ? 1.0 : 0.5 ) * sqrt(2.0);
+         sandwich(ikappa, NL, TwoSL, IL, NR, TwoSR, IR, alpha, Ctens->gStorage(NL, TwoSL, IL, NL, TwoSL, IL), false, NULL, false, memT, memHeff, denT, temp);
+      }
+      //2b3spin1
+      if ( N1 == 1 ){
+         for ( int TwoSLdown = TwoSL-2; TwoSLdown <= TwoSL+2; TwoSLdown+=2 ){
+            if ( TwoSLdown >= 0 ){
+               const double alpha = Special::phase(TwoSLdown + TwoSR + 1) * sqrt(12.0 * (TwoSL + 1))
+                                  * Wigner::wigner6j(1, 1, 2, 1, 1, 0) * Wigner::wigner6j(1, 1, 2, TwoSL, TwoSLdown, TwoSR);
+               sandwich(ikappa, NL, TwoSLdown, IL, NR, TwoSR, IR, alpha, Dtens->gStorage(NL, TwoSLdown, IL, NL, TwoSL, IL), true, NULL, false, memT, memHeff, denT, temp);
+            }
+         }
+      }
+   }
+
+}
+
+void CheMPS2::HeffOneSite::addDiagram2e(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorOperator * Atens, TensorOperator * Ctens, TensorOperator * Dtens, double * temp) const{
+
+   #ifdef CHEMPS2_MPI_COMPILATION
+   const int MPIRANK = MPIchemps2::mpi_rank();
+   #endif
+   const int NL = denT->gNL(ikappa); const int TwoSL = denT->gTwoSL(ikappa); const int IL = denT->gIL(ikappa);
+   const int NR = denT->gNR(ikappa); const int TwoSR = denT->gTwoSR(ikappa); const int IR = denT->gIR(ikappa);
+   const int N1 = NR - NL;
+   const int theindex = denT->gIndex();
+
+   #ifdef CHEMPS2_MPI_COMPILATION
+   if ( MPIchemps2::owner_absigma( theindex, theindex ) == MPIRANK )
+   #endif
+   {  //2e1 and 2e2
+      if ( N1 == 2 ){ sandwich(ikappa, NL, TwoSL, IL, NR-2, TwoSR, IR, sqrt(2.0), NULL, false, Atens->gStorage(NR-2, TwoSR, IR, NR, TwoSR, IR), false, memT, memHeff, denT, temp); }
+      if ( N1 == 0 ){ sandwich(ikappa, NL, TwoSL, IL, NR+2, TwoSR, IR, sqrt(2.0), NULL, false, Atens->gStorage(NR, TwoSR, IR, NR+2, TwoSR, IR), true,  memT, memHeff, denT, temp); }
+   }
+
+   #ifdef CHEMPS2_MPI_COMPILATION
+   if ( MPIchemps2::owner_cdf( Prob->gL(), theindex, theindex ) == MPIRANK )
+   #endif
+   {  //2e3spin0
+      if ( N1 != 0 ){
+         const double alpha = (( N1 == 2 ) ? 1.0 : 0.5 ) * sqrt(2.0);
+         sandwich(ikappa, NL, TwoSL, IL, NR, TwoSR, IR, alpha, NULL, false, Ctens->gStorage(NR, TwoSR, IR, NR, TwoSR, IR), false, memT, memHeff, denT, temp);
+      }
+      //2e3spin1
+      if ( N1 == 1 ){
+         for ( int TwoSRdown = TwoSR-2; TwoSRdown <= TwoSR+2; TwoSRdown+=2 ){
+            if ( TwoSRdown >= 0 ){
+               const double alpha = Special::phase(TwoSRdown + TwoSL + 3) * sqrt(12.0 * (TwoSRdown + 1))
+                                  * Wigner::wigner6j(1, 1, 2, 1, 1, 0) * Wigner::wigner6j(1, 1, 2, TwoSR, TwoSRdown, TwoSL);
+               sandwich(ikappa, NL, TwoSL, IL, NR, TwoSRdown, IR, alpha, NULL, false, Dtens->gStorage(NR, TwoSRdown, IR, NR, TwoSR, IR), false, memT, memHeff, denT, temp);
+            }
+         }
+      }
+   }
+
+}
+
+void CheMPS2::HeffOneSite::addDiagram2a1and2a2spin0(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorOperator **** Atensors, TensorS0 **** S0tensors, double * temp) const{
+
+   #ifdef CHEMPS2_MPI_COMPILATION
+   const int MPIRANK = MPIchemps2::mpi_rank();
+   #endif
+   const int NL = denT->gNL(ikappa); const int TwoSL = denT->gTwoSL(ikappa); const int IL = denT->gIL(ikappa);
+   const int NR = denT->gNR(ikappa); const int TwoSR = denT->gTwoSR(ikappa); const int IR = denT->gIR(ikappa);
+   const int theindex = denT->gIndex();
+   const bool leftSum = ( theindex < Prob->gL()*0.5 )?true:false;
+
+   // The complementary operators are on the side with the most orbitals
+   const int first = (( leftSum ) ? 0        : theindex + 1 );
+   const int last  = (( leftSum ) ? theindex : Prob->gL()   );
+   for ( int l_alpha = first; l_alpha < last; l_alpha++ ){
+      for ( int l_beta = l_alpha; l_beta < last; l_beta++ ){
+         #ifdef CHEMPS2_MPI_COMPILATION
+         if ( MPIchemps2::owner_absigma( l_alpha, l_beta ) == MPIRANK )
+         #endif
+         {
+            TensorOperator * Left  = (( leftSum ) ? (TensorOperator *) S0tensors[theindex-1][l_beta-l_alpha][theindex-1-l_beta] : Atensors[theindex-1][l_beta-l_alpha][l_alpha-theindex] );
+            TensorOperator * Right = (( leftSum ) ? Atensors[theindex][l_beta-l_alpha][theindex-l_beta] : (TensorOperator *) S0tensors[theindex][l_beta-l_alpha][l_alpha-theindex-1] );
+            const int ILdown = Irreps::directProd( IL, Left->get_irrep() );
+            const int IRdown = Irreps::directProd( IR, Right->get_irrep() );
+            //2a1
+            sandwich(ikappa, NL-2, TwoSL, ILdown, NR-2, TwoSR, IRdown, 1.0, Left->gStorage(NL-2, TwoSL, ILdown, NL, TwoSL, IL), true,
+                                                                           Right->gStorage(NR-2, TwoSR, IRdown, NR, TwoSR, IR), false, memT, memHeff, denT, temp);
+            //2a2
+            sandwich(ikappa, NL+2, TwoSL, ILdown, NR+2, TwoSR, IRdown, 1.0, Left->gStorage(NL, TwoSL, IL, NL+2, TwoSL, ILdown), false,
+                                                                           Right->gStorage(NR, TwoSR, IR, NR+2, TwoSR, IRdown), true, memT, memHeff, denT, temp);
+         }
+      }
+   }
+
+}
+
+void CheMPS2::HeffOneSite::addDiagram2a1and2a2spin1(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorOperator **** Btensors, TensorS1 **** S1tensors, double * temp) const{
+
+   #ifdef CHEMPS2_MPI_COMPILATION
+   const int MPIRANK = MPIchemps2::mpi_rank();
+   #endif
+   const int NL = denT->gNL(ikappa); const int TwoSL = denT->gTwoSL(ikappa); const int IL = denT->gIL(ikappa);
+   const int NR = denT->gNR(ikappa); const int TwoSR = denT->gTwoSR(ikappa); const int IR = denT->gIR(ikappa);
+   const int TwoJ = (( NR - NL == 1 ) ? 1 : 0 );
+   const int theindex = denT->gIndex();
+   const bool leftSum = ( theindex < Prob->gL()*0.5 )?true:false;
+
+   const int first = (( leftSum ) ? 0        : theindex + 1 );
+   const int last  = (( leftSum ) ? theindex : Prob->gL()   );
+   for ( int TwoSLdown = TwoSL-2; TwoSLdown <= TwoSL+2; TwoSLdown+=2 ){
+      for ( int TwoSRdown = TwoSR-2; TwoSRdown <= TwoSR+2; TwoSRdown+=2 ){
+         if (( TwoSLdown >= 0 ) && ( TwoSRdown >= 0 ) && ( abs( TwoSLdown - TwoSRdown ) <= TwoJ )){
+            const double factor1 = Special::phase(TwoSRdown + TwoSL + TwoJ + 2) * sqrt((TwoSR + 1) * (TwoSL + 1.0))
+                                 * Wigner::wigner6j(TwoSLdown, TwoSRdown, TwoJ, TwoSR, TwoSL, 2);
+            const double factor2 = Special::phase(TwoSLdown + TwoSR + TwoJ + 2) * sqrt((TwoSRdown + 1) * (TwoSLdown + 1.0))
+                                 * Wigner::wigner6j(TwoSLdown, TwoSRdown, TwoJ, TwoSR, TwoSL, 2);
+            for ( int l_alpha = first; l_alpha < last; l_alpha++ ){
+               for ( int l_beta = l_alpha + 1; l_beta < last; l_beta++ ){
+                  #ifdef CHEMPS2_MPI_COMPILATION
+                  if ( MPIchemps2::owner_absigma( l_alpha, l_beta ) == MPIRANK )
+                  #endif
+                  {
+                     TensorOperator * Left  = (( leftSum ) ? (TensorOperator *) S1tensors[theindex-1][l_beta-l_alpha][theindex-1-l_beta] : Btensors[theindex-1][l_beta-l_alpha][l_alpha-theindex] );
+                     TensorOperator * Right = (( leftSum ) ? Btensors[theindex][l_beta-l_alpha][theindex-l_beta] : (TensorOperator *) S1tensors[theindex][l_beta-l_alpha][l_alpha-theindex-1] );
+                     const int ILdown = Irreps::directProd( IL, Left->get_irrep() );
+                     const int IRdown = Irreps::directProd( IR, Right->get_irrep() );
+                     //2a1
+                     sandwich(ikappa, NL-2, TwoSLdown, ILdown, NR-2, TwoSRdown, IRdown, factor1, Left->gStorage(NL-2, TwoSLdown, ILdown, NL, TwoSL, IL), true,
+                                                                                                 Right->gStorage(NR-2, TwoSRdown, IRdown, NR, TwoSR, IR), false, memT, memHeff, denT, temp);
+                     //2a2
+                     sandwich(ikappa, NL+2, TwoSLdown, ILdown, NR+2, TwoSRdown, IRdown, factor2, Left->gStorage(NL, TwoSL, IL, NL+2, TwoSLdown, ILdown), false,
+                                                                                                 Right->gStorage(NR, TwoSR, IR, NR+2, TwoSRdown, IRdown), true, memT, memHeff, denT, temp);
+                  }
+               }
+            }
+         }
+      }
+   }
+
+}
+
+void CheMPS2::HeffOneSite::addDiagram2a3(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, double * temp) const{
+
+   #ifdef CHEMPS2_MPI_COMPILATION
+   const int MPIRANK = MPIchemps2::mpi_rank();
+   #endif
+   const int NL = denT->gNL(ikappa); const int TwoSL = denT->gTwoSL(ikappa); const int IL = denT->gIL(ikappa);
+   const int NR = denT->gNR(ikappa); const int TwoSR = denT->gTwoSR(ikappa); const int IR = denT->gIR(ikappa);
+   const int TwoJ = (( NR - NL == 1 ) ? 1 : 0 );
+   const int theindex = denT->gIndex();
+   const bool leftSum = ( theindex < Prob->gL()*0.5 )?true:false;
+
+   /* With leftSum, the F-operators of the pairs l_one <= l_two on the left side are combined with the C/D-operators on the right side,
+      and otherwise the C/D-operators on the left side with the F-operators on the right side. Part (a) contains the ( up, down ) blocks
+      and only occurs for l_one < l_two, part (b) contains the ( down, up ) blocks. */
+   const int first = (( leftSum ) ? 0        : theindex + 1 );
+   const int last  = (( leftSum ) ? theindex : Prob->gL()   );
+   for ( int l_one = first; l_one < last; l_one++ ){
+      for ( int l_two = l_one; l_two < last; l_two++ ){
+         #ifdef CHEMPS2_MPI_COMPILATION
+         if ( MPIchemps2::owner_cdf( Prob->gL(), l_one, l_two ) == MPIRANK )
+         #endif
+         {
+            for ( int spin = 0; spin < 2; spin++ ){
+               TensorOperator * Left;
+               TensorOperator * Right;
+               if ( leftSum ){
+                  Left  = (( spin == 0 ) ? (TensorOperator *) F0tensors[theindex-1][l_two-l_one][theindex-1-l_two] : (TensorOperator *) F1tensors[theindex-1][l_two-l_one][theindex-1-l_two] );
+                  Right = (( spin == 0 ) ? Ctensors[theindex][l_two-l_one][theindex-l_two] : Dtensors[theindex][l_two-l_one][theindex-l_two] );
+               } else {
+                  Left  = (( spin == 0 ) ? Ctensors[theindex-1][l_two-l_one][l_one-theindex] : Dtensors[theindex-1][l_two-l_one][l_one-theindex] );
+                  Right = (( spin == 0 ) ? (TensorOperator *) F0tensors[theindex][l_two-l_one][l_one-theindex-1] : (TensorOperator *) F1tensors[theindex][l_two-l_one][l_one-theindex-1] );
+               }
+               const int ILdown = Irreps::directProd( IL, Left->get_irrep() );
+               const int IRdown = Irreps::directProd( IR, Right->get_irrep() );
+               for ( int TwoSLdown = TwoSL-2*spin; TwoSLdown <= TwoSL+2*spin; TwoSLdown+=2 ){
+                  for ( int TwoSRdown = TwoSR-2*spin; TwoSRdown <= TwoSR+2*spin; TwoSRdown+=2 ){
+                     if (( TwoSLdown >= 0 ) && ( TwoSRdown >= 0 ) && ( abs( TwoSLdown - TwoSRdown ) <= TwoJ )){
+                        double factor_a = 1.0;
+                        double factor_b = 1.0;
+                        if ( spin == 1 ){
+                           factor_a = Special::phase(TwoSLdown + TwoSRdown + TwoJ + 2) * sqrt((TwoSR + 1) * (TwoSLdown + 1.0)) * Wigner::wigner6j(TwoSLdown, TwoSRdown, TwoJ, TwoSR, TwoSL, 2);
+                           factor_b = Special::phase(TwoSL + TwoSR + TwoJ + 2) * sqrt((TwoSRdown + 1) * (TwoSL + 1.0)) * Wigner::wigner6j(TwoSLdown, TwoSRdown, TwoJ, TwoSR, TwoSL, 2);
+                        }
+                        if ( l_one < l_two ){ // part (a)
+                           sandwich(ikappa, NL, TwoSLdown, ILdown, NR, TwoSRdown, IRdown, factor_a, Left->gStorage(NL, TwoSL, IL, NL, TwoSLdown, ILdown), false,
+                                                                                                 Right->gStorage(NR, TwoSR, IR, NR, TwoSRdown, IRdown), true, memT, memHeff, denT, temp);
+                        }
+                        // part (b)
+                        sandwich(ikappa, NL, TwoSLdown, ILdown, NR, TwoSRdown, IRdown, factor_b, Left->gStorage(NL, TwoSLdown, ILdown, NL, TwoSL, IL), true,
+                                                                                              Right->gStorage(NR, TwoSRdown, IRdown, NR, TwoSR, IR), false, memT, memHeff, denT, temp);
+                     }
+                  }
+               }
+            }
+         }
+      }
+   }
+
+}
+
+/*********************
+*  Diagrams group 3  *
+*********************/
+
+void CheMPS2::HeffOneSite::fill_qtilde(double * result, TensorQ * Qtens, TensorL ** Ltens, const bool left_side, const int theindex, const int N1, const int TwoS1, const int I1, const int N2, const int TwoS2, const int I2) const{
+
+   const int boundary = (( left_side ) ? theindex : theindex + 1 );
+   int size = denBK->gCurrentDim( boundary, N1, TwoS1, I1 ) * denBK->gCurrentDim( boundary, N2, TwoS2, I2 );
+   int inc = 1;
+   dcopy_( &size, Qtens->gStorage( N1, TwoS1, I1, N2, TwoS2, I2 ), &inc, result, &inc );
+   const int first = (( left_side ) ? 0        : theindex + 1 );
+   const int last  = (( left_side ) ? theindex : Prob->gL()   );
+   for ( int l_index = first; l_index < last; l_index++ ){
+      if ( denBK->gIrrep( l_index ) == denBK->gIrrep( theindex ) ){
+         double alpha = (( left_side ) ? Prob->gMxElement( l_index, theindex, theindex, theindex ) : Prob->gMxElement( theindex, theindex, theindex, l_index ));
+         TensorL * Lop = Ltens[ ( left_side ) ? theindex - 1 - l_index : l_index - theindex - 1 ];
+         daxpy_( &size, &alpha, Lop->gStorage( N1, TwoS1, I1, N2, TwoS2, I2 ), &inc, result, &inc );
+      }
+   }
+
+}
+
+void CheMPS2::HeffOneSite::addDiagram3Aand3D(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorQ * Qleft, TensorL ** Lleft, double * temp, double * temp2) const{
+
+   const int NL = denT->gNL(ikappa); const int TwoSL = denT->gTwoSL(ikappa); const int IL = denT->gIL(ikappa);
+   const int NR = denT->gNR(ikappa); const int TwoSR = denT->gTwoSR(ikappa); const int IR = denT->gIR(ikappa);
+   const int N1 = NR - NL;
+   const int theindex = denT->gIndex();
+   const int ILdown = Irreps::directProd( IL, denBK->gIrrep( theindex ) );
+
+   for ( int TwoSLdown = TwoSL-1; TwoSLdown <= TwoSL+1; TwoSLdown+=2 ){
+      if ( TwoSLdown >= 0 ){
+         if (( N1 == 2 ) && ( denT->gKappa( NL+1, TwoSLdown, ILdown, NR, TwoSR, IR ) != -1 )){
+            const double factor = Special::phase(TwoSL + TwoSR + 2) * sqrt(2.0 * (TwoSLdown + 1)) * Wigner::wigner6j(1, 0, 1, TwoSL, TwoSLdown, TwoSR);
+            fill_qtilde(temp2, Qleft, Lleft, true, theindex, NL, TwoSL, IL, NL+1, TwoSLdown, ILdown);
+            sandwich(ikappa, NL+1, TwoSLdown, ILdown, NR, TwoSR, IR, factor, temp2, false, NULL, false, memT, memHeff, denT, temp);
+         }
+         if ( N1 == 1 ){
+            const double factor = Special::phase(TwoSL + TwoSR + 1) * sqrt(2.0 * (TwoSLdown + 1)) * Wigner::wigner6j(0, 1, 1, TwoSL, TwoSLdown, TwoSR);
+            sandwich(ikappa, NL+1, TwoSLdown, ILdown, NR, TwoSR, IR, factor, Qleft->gStorage(NL, TwoSL, IL, NL+1, TwoSLdown, ILdown), false, NULL, false, memT, memHeff, denT, temp);
+         }
+         if ( N1 == 0 ){
+            const double factor = Special::phase(TwoSLdown + TwoSR + 1) * sqrt(2.0 * (TwoSL + 1)) * Wigner::wigner6j(1, 0, 1, TwoSL, TwoSLdown, TwoSR);
+            sandwich(ikappa, NL-1, TwoSLdown, ILdown, NR, TwoSR, IR, factor, Qleft->gStorage(NL-1, TwoSLdown, ILdown, NL, TwoSL, IL), true, NULL, false, memT, memHeff, denT, temp);
+         }
+         if (( N1 == 1 ) && ( denT->gKappa( NL-1, TwoSLdown, ILdown, NR, TwoSR, IR ) != -1 )){
+            const double factor = Special::phase(TwoSLdown + TwoSR + 2) * sqrt(2.0 * (TwoSL + 1)) * Wigner::wigner6j(0, 1, 1, TwoSL, TwoSLdown, TwoSR);
+            fill_qtilde(temp2, Qleft, Lleft, true, theindex, NL-1, TwoSLdown, ILdown, NL, TwoSL, IL);
+            sandwich(ikappa, NL-1, TwoSLdown, ILdown, NR, TwoSR, IR, factor, temp2, true, NULL, false, memT, memHeff, denT, temp);
+         }
+      }
+   }
+
+}
+
+void CheMPS2::HeffOneSite::addDiagram3Kand3F(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorQ * Qright, TensorL ** Lright, double * temp, double * temp2) const{
+
+   const int NL = denT->gNL(ikappa); const int TwoSL = denT->gTwoSL(ikappa); const int IL = denT->gIL(ikappa);
+   const int NR = denT->gNR(ikappa); const int TwoSR = denT->gTwoSR(ikappa); const int IR = denT->gIR(ikappa);
+   const int N1 = NR - NL;
+   const int theindex = denT->gIndex();
+   const int IRdown = Irreps::directProd( IR, denBK->gIrrep( theindex ) );
+
+   for ( int TwoSRdown = TwoSR-1; TwoSRdown <= TwoSR+1; TwoSRdown+=2 ){
+      if ( TwoSRdown >= 0 ){
+         if ( N1 == 1 ){
+            const double factor = sqrt(2.0 * (TwoSR + 1)) * Special::phase(TwoSL + TwoSR + 1) * Wigner::wigner6j(0, 1, 1, TwoSR, TwoSRdown, TwoSL);
+            sandwich(ikappa, NL, TwoSL, IL, NR-1, TwoSRdown, IRdown, factor, NULL, false, Qright->gStorage(NR-1, TwoSRdown, IRdown, NR, TwoSR, IR), false, memT, memHeff, denT, temp);
+         }
+         if (( N1 == 2 ) && ( denT->gKappa( NL, TwoSL, IL, NR-1, TwoSRdown, IRdown ) != -1 )){
+            const double factor = sqrt(2.0 * (TwoSR + 1)) * Special::phase(TwoSL + TwoSR + 2) * Wigner::wigner6j(1, 0, 1, TwoSR, TwoSRdown, TwoSL);
+            fill_qtilde(temp2, Qright, Lright, false, theindex, NR-1, TwoSRdown, IRdown, NR, TwoSR, IR);
+            sandwich(ikappa, NL, TwoSL, IL, NR-1, TwoSRdown, IRdown, factor, NULL, false, temp2, false, memT, memHeff, denT, temp);
+         }
+         if ( N1 == 0 ){
+            const double factor = sqrt(2.0 * (TwoSRdown + 1)) * Special::phase(TwoSL + TwoSRdown + 1) * Wigner::wigner6j(1, 0, 1, TwoSR, TwoSRdown, TwoSL);
+            sandwich(ikappa, NL, TwoSL, IL, NR+1, TwoSRdown, IRdown, factor, NULL, false, Qright->gStorage(NR, TwoSR, IR, NR+1, TwoSRdown, IRdown), true, memT, memHeff, denT, temp);
+         }
+         if (( N1 == 1 ) && ( denT->gKappa( NL, TwoSL, IL, NR+1, TwoSRdown, IRdown ) != -1 )){
+            const double factor = sqrt(2.0 * (TwoSRdown + 1)) * Special::phase(TwoSL + TwoSRdown + 2) * Wigner::wigner6j(0, 1, 1, TwoSR, TwoSRdown, TwoSL);
+            fill_qtilde(temp2, Qright, Lright, false, theindex, NR, TwoSR, IR, NR+1, TwoSRdown, IRdown);
+            sandwich(ikappa, NL, TwoSL, IL, NR+1, TwoSRdown, IRdown, factor, NULL, false, temp2, true, memT, memHeff, denT, temp);
+         }
+      }
+   }
+
+}
+
+void CheMPS2::HeffOneSite::addDiagram3C(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorQ ** Qleft, TensorL ** Lright, double * temp) const{
+
+   #ifdef CHEMPS2_MPI_COMPILATION
+   const int MPIRANK = MPIchemps2::mpi_rank();
+   #endif
+   const int NL = denT->gNL(ikappa); const int TwoSL = denT->gTwoSL(ikappa); const int IL = denT->gIL(ikappa);
+   const int NR = denT->gNR(ikappa); const int TwoSR = denT->gTwoSR(ikappa); const int IR = denT->gIR(ikappa);
+   const int N1 = NR - NL;
+   const int TwoJ = (( N1 == 1 ) ? 1 : 0 );
+   const int theindex = denT->gIndex();
+
+   for ( int l_index = theindex + 1; l_index < Prob->gL(); l_index++ ){
+      #ifdef CHEMPS2_MPI_COMPILATION
+      if ( MPIchemps2::owner_q( Prob->gL(), l_index ) == MPIRANK )
+      #endif
+      {
+         const int ILdown = Irreps::directProd( IL, denBK->gIrrep( l_index ) );
+         const int IRdown = Irreps::directProd( IR, denBK->gIrrep( l_index ) );
+         TensorQ * Qop = Qleft[ l_index - theindex ];
+         TensorL * Lop = Lright[ l_index - theindex - 1 ];
+         for ( int TwoSLdown = TwoSL-1; TwoSLdown <= TwoSL+1; TwoSLdown+=2 ){
+            for ( int TwoSRdown = TwoSR-1; TwoSRdown <= TwoSR+1; TwoSRdown+=2 ){
+               if (( TwoSLdown >= 0 ) && ( TwoSRdown >= 0 ) && ( abs( TwoSLdown - TwoSRdown ) <= TwoJ )){
+                  //3C1
+                  double factor = Special::phase(TwoSLdown + TwoSR + TwoJ + 1 + (( N1 == 1 ) ? 2 : 0 )) * sqrt((TwoSLdown + 1) * (TwoSRdown + 1.0))
+                                * Wigner::wigner6j(TwoSL, TwoSR, TwoJ, TwoSRdown, TwoSLdown, 1);
+                  sandwich(ikappa, NL+1, TwoSLdown, ILdown, NR+1, TwoSRdown, IRdown, factor, Qop->gStorage(NL, TwoSL, IL, NL+1, TwoSLdown, ILdown), false,
+                                                                                        Lop->gStorage(NR, TwoSR, IR, NR+1, TwoSRdown, IRdown), true, memT, memHeff, denT, temp);
+                  //3C2
+                  factor = Special::phase(TwoSL + TwoSRdown + TwoJ + 1 + (( N1 == 1 ) ? 2 : 0 )) * sqrt((TwoSL + 1) * (TwoSR + 1.0))
+                         * Wigner::wigner6j(TwoSL, TwoSR, TwoJ, TwoSRdown, TwoSLdown, 1);
+                  sandwich(ikappa, NL-1, TwoSLdown, ILdown, NR-1, TwoSRdown, IRdown, factor, Qop->gStorage(NL-1, TwoSLdown, ILdown, NL, TwoSL, IL), true,
+                                                                                        Lop->gStorage(NR-1, TwoSRdown, IRdown, NR, TwoSR, IR), false, memT, memHeff, denT, temp);
+               }
+            }
+         }
+      }
+   }
+
+}
+
+void CheMPS2::HeffOneSite::addDiagram3J(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorQ ** Qright, TensorL ** Lleft, double * temp) const{
+
+   #ifdef CHEMPS2_MPI_COMPILATION
+   const int MPIRANK = MPIchemps2::mpi_rank();
+   #endif
+   const int NL = denT->gNL(ikappa); const int TwoSL = denT->gTwoSL(ikappa); const int IL = denT->gIL(ikappa);
+   const int NR = denT->gNR(ikappa); const int TwoSR = denT->gTwoSR(ikappa); const int IR = denT->gIR(ikappa);
+   const int N1 = NR - NL;
+   const int TwoJ = (( N1 == 1 ) ? 1 : 0 );
+   const int theindex = denT->gIndex();
+
+   for ( int l_index = 0; l_index < theindex; l_index++ ){
+      #ifdef CHEMPS2_MPI_COMPILATION
+      if ( MPIchemps2::owner_q( Prob->gL(), l_index ) == MPIRANK )
+      #endif
+      {
+         const int ILdown = Irreps::directProd( IL, denBK->gIrrep( l_index ) );
+         const int IRdown = Irreps::directProd( IR, denBK->gIrrep( l_index ) );
+         TensorL * Lop = Lleft[ theindex - 1 - l_index ];
+         TensorQ * Qop = Qright[ theindex - l_index ];
+         for ( int TwoSLdown = TwoSL-1; TwoSLdown <= TwoSL+1; TwoSLdown+=2 ){
+            for ( int TwoSRdown = TwoSR-1; TwoSRdown <= TwoSR+1; TwoSRdown+=2 ){
+               if (( TwoSLdown >= 0 ) && ( TwoSRdown >= 0 ) && ( abs( TwoSLdown - TwoSRdown ) <= TwoJ )){
+                  //3J2
+                  double factor = Special::phase(TwoSLdown + TwoSR + TwoJ + 1 + (( N1 == 1 ) ? 2 : 0 )) * sqrt((TwoSLdown + 1) * (TwoSRdown + 1.0))
+                                * Wigner::wigner6j(TwoSL, TwoSR, TwoJ, TwoSRdown, TwoSLdown, 1);
+                  sandwich(ikappa, NL+1, TwoSLdown, ILdown, NR+1, TwoSRdown, IRdown, factor, Lop->gStorage(NL, TwoSL, IL, NL+1, TwoSLdown, ILdown), false,
+                                                                                        Qop->gStorage(NR, TwoSR, IR, NR+1, TwoSRdown, IRdown), true, memT, memHeff, denT, temp);
+                  //3J1
+                  factor = Special::phase(TwoSL + TwoSRdown + TwoJ + 1 + (( N1 == 1 ) ? 2 : 0 )) * sqrt((TwoSL + 1) * (TwoSR + 1.0))
+                         * Wigner::wigner6j(TwoSL, TwoSR, TwoJ, TwoSRdown, TwoSLdown, 1);
+                  sandwich(ikappa, NL-1, TwoSLdown, ILdown, NR-1, TwoSRdown, IRdown, factor, Lop->gStorage(NL-1, TwoSLdown, ILdown, NL, TwoSL, IL), true,
+                                                                                        Qop->gStorage(NR-1, TwoSRdown, IRdown, NR, TwoSR, IR), false, memT, memHeff, denT, temp);
+               }
+            }
+         }
+      }
+   }
+
+}
+
+/*********************
+*  Diagrams group 4  *
+*********************/
+
+void CheMPS2::HeffOneSite::addDiagram4B(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorOperator *** Aleft, TensorOperator *** Bleft, TensorOperator *** Cleft, TensorOperator *** Dleft, TensorL ** Lright, double * temp) const{
+
+   #ifdef CHEMPS2_MPI_COMPILATION
+   const int MPIRANK = MPIchemps2::mpi_rank();
+   #endif
+   const int NL = denT->gNL(ikappa); const int TwoSL = denT->gTwoSL(ikappa); const int IL = denT->gIL(ikappa);
+   const int NR = denT->gNR(ikappa); const int TwoSR = denT->gTwoSR(ikappa); const int IR = denT->gIR(ikappa);
+   const int N1 = NR - NL;
+   const int TwoJ = (( N1 == 1 ) ? 1 : 0 );
+   const int theindex = denT->gIndex();
+
+   for ( int l_index = theindex + 1; l_index < Prob->gL(); l_index++ ){
+      const int IRdown = Irreps::directProd( IR, denBK->gIrrep( l_index ) );
+      TensorL * Lop = Lright[ l_index - theindex - 1 ];
+
+      #ifdef CHEMPS2_MPI_COMPILATION
+      if ( MPIchemps2::owner_absigma( theindex, l_index ) == MPIRANK )
+      #endif
+      {
+         //4B1and4B2spin0
+         TensorOperator * Aop = Aleft[ l_index - theindex ][ 0 ];
+         int ILdown = Irreps::directProd( IL, Aop->get_irrep() );
+         for ( int TwoSRdown = TwoSR-1; TwoSRdown <= TwoSR+1; TwoSRdown+=2 ){
+            if ( TwoSRdown >= 0 ){
+               if ( N1 == 0 ){
+                  const double factor = Special::phase(TwoSR + TwoSL + 2) * sqrt(0.5 * (TwoSR + 1) * 2) * Wigner::wigner6j(1, 0, 1, TwoSR, TwoSRdown, TwoSL);
+                  sandwich(ikappa, NL-2, TwoSL, ILdown, NR-1, TwoSRdown, IRdown, factor, Aop->gStorage(NL-2, TwoSL, ILdown, NL, TwoSL, IL), true,
+                                                                                      Lop->gStorage(NR-1, TwoSRdown, IRdown, NR, TwoSR, IR), false, memT, memHeff, denT, temp);
+               }
+               if ( N1 == 1 ){
+                  double factor = Special::phase(TwoSR + TwoSL + 3) * sqrt(0.5 * (TwoSR + 1) * 2) * Wigner::wigner6j(1, 0, 1, TwoSRdown, TwoSR, TwoSL);
+                  sandwich(ikappa, NL-2, TwoSL, ILdown, NR-1, TwoSRdown, IRdown, factor, Aop->gStorage(NL-2, TwoSL, ILdown, NL, TwoSL, IL), true,
+                                                                                      Lop->gStorage(NR-1, TwoSRdown, IRdown, NR, TwoSR, IR), false, memT, memHeff, denT, temp);
+                  factor = Special::phase(TwoSRdown + TwoSL + 2) * sqrt(0.5 * (TwoSRdown + 1) * 2) * Wigner::wigner6j(1, 0, 1, TwoSRdown, TwoSR, TwoSL);
+                  sandwich(ikappa, NL+2, TwoSL, ILdown, NR+1, TwoSRdown, IRdown, factor, Aop->gStorage(NL, TwoSL, IL, NL+2, TwoSL, ILdown), false,
+                                                                                      Lop->gStorage(NR, TwoSR, IR, NR+1, TwoSRdown, IRdown), true, memT, memHeff, denT, temp);
+               }
+               if ( N1 == 2 ){
+                  const double factor = Special::phase(TwoSRdown + TwoSL + 3) * sqrt(0.5 * (TwoSRdown + 1) * 2) * Wigner::wigner6j(1, 0, 1, TwoSR, TwoSRdown, TwoSL);
+                  sandwich(ikappa, NL+2, TwoSL, ILdown, NR+1, TwoSRdown, IRdown, factor, Aop->gStorage(NL, TwoSL, IL, NL+2, TwoSL, ILdown), false,
+                                                                                      Lop->gStorage(NR, TwoSR, IR, NR+1, TwoSRdown, IRdown), true, memT, memHeff, denT, temp);
+               }
+            }
+         }
+
+         //4B1and4B2spin1
+         TensorOperator * Bop = Bleft[ l_index - theindex ][ 0 ];
+         ILdown = Irreps::directProd( IL, Bop->get_irrep() );
+         for ( int TwoSLdown = TwoSL-2; TwoSLdown <= TwoSL+2; TwoSLdown+=2 ){
+            for ( int TwoSRdown = TwoSR-1; TwoSRdown <= TwoSR+1; TwoSRdown+=2 ){
+               if (( TwoSLdown >= 0 ) && ( TwoSRdown >= 0 )){
+                  if ( N1 == 0 ){
+                     const double factor = sqrt(3.0 * (TwoSR + 1) * (TwoSL + 1) * 2) * Wigner::wigner9j(2, TwoSLdown, TwoSL, 1, TwoSRdown, TwoSR, 1, 1, 0);
+                     sandwich(ikappa, NL-2, TwoSLdown, ILdown, NR-1, TwoSRdown, IRdown, factor, Bop->gStorage(NL-2, TwoSLdown, ILdown, NL, TwoSL, IL), true,
+                                                                                             Lop->gStorage(NR-1, TwoSRdown, IRdown, NR, TwoSR, IR), false, memT, memHeff, denT, temp);
+                  }
+                  if ( N1 == 1 ){
+                     double factor = Special::phase(TwoSR - TwoSRdown + TwoSL + 3 - TwoSLdown) * sqrt(3.0 * (TwoSR + 1) * (TwoSL + 1) * (TwoJ + 1))
+                                   * Wigner::wigner9j(2, TwoSL, TwoSLdown, 1, TwoSR, TwoSRdown, 1, TwoJ, 0);
+                     sandwich(ikappa, NL-2, TwoSLdown, ILdown, NR-1, TwoSRdown, IRdown, factor, Bop->gStorage(NL-2, TwoSLdown, ILdown, NL, TwoSL, IL), true,
+                                                                                             Lop->gStorage(NR-1, TwoSRdown, IRdown, NR, TwoSR, IR), false, memT, memHeff, denT, temp);
+                     factor = sqrt(3.0 * (TwoSRdown + 1) * (TwoSLdown + 1) * (TwoJ + 1)) * Wigner::wigner9j(2, TwoSL, TwoSLdown, 1, TwoSR, TwoSRdown, 1, TwoJ, 0);
+                     sandwich(ikappa, NL+2, TwoSLdown, ILdown, NR+1, TwoSRdown, IRdown, factor, Bop->gStorage(NL, TwoSL, IL, NL+2, TwoSLdown, ILdown), false,
+                                                                                             Lop->gStorage(NR, TwoSR, IR, NR+1, TwoSRdown, IRdown), true, memT, memHeff, denT, temp);
+                  }
+                  if ( N1 == 2 ){
+                     const double factor = Special::phase(TwoSLdown + 3 - TwoSL + TwoSRdown - TwoSR) * sqrt(3.0 * (TwoSRdown + 1) * 2 * (TwoSLdown + 1))
+                                         * Wigner::wigner9j(2, TwoSLdown, TwoSL, 1, TwoSRdown, TwoSR, 1, 1, 0);
+                     sandwich(ikappa, NL+2, TwoSLdown, ILdown, NR+1, TwoSRdown, IRdown, factor, Bop->gStorage(NL, TwoSL, IL, NL+2, TwoSLdown, ILdown), false,
+                                                                                             Lop->gStorage(NR, TwoSR, IR, NR+1, TwoSRdown, IRdown), true, memT, memHeff, denT, temp);
+                  }
+               }
+            }
+         }
+      }
+
+      #ifdef CHEMPS2_MPI_COMPILATION
+      if ( MPIchemps2::owner_cdf( Prob->gL(), theindex, l_index ) == MPIRANK )
+      #endif
+      {
+         //4B3and4B4spin0
+         TensorOperator * Cop = Cleft[ l_index - theindex ][ 0 ];
+         int ILdown = Irreps::directProd( IL, Cop->get_irrep() );
+         for ( int TwoSRdown = TwoSR-1; TwoSRdown <= TwoSR+1; TwoSRdown+=2 ){
+            if ( TwoSRdown >= 0 ){
+               if ( N1 == 1 ){
+                  double factor = Special::phase(TwoSR + TwoSL + TwoJ) * sqrt(0.5 * (TwoSR + 1) * (TwoJ + 1)) * Wigner::wigner6j(TwoJ, 0, 1, TwoSRdown, TwoSR, TwoSL);
+                  sandwich(ikappa, NL, TwoSL, ILdown, NR-1, TwoSRdown, IRdown, factor, Cop->gStorage(NL, TwoSL, ILdown, NL, TwoSL, IL), true,
+                                                                                    Lop->gStorage(NR-1, TwoSRdown, IRdown, NR, TwoSR, IR), false, memT, memHeff, denT, temp);
+                  factor = Special::phase(TwoSRdown + TwoSL + 1 + TwoJ) * sqrt(0.5 * (TwoSRdown + 1) * (TwoJ + 1)) * Wigner::wigner6j(TwoJ, 0, 1, TwoSRdown, TwoSR, TwoSL);
+                  sandwich(ikappa, NL, TwoSL, ILdown, NR+1, TwoSRdown, IRdown, factor, Cop->gStorage(NL, TwoSL, IL, NL, TwoSL, ILdown), false,
+                                                                                    Lop->gStorage(NR, TwoSR, IR, NR+1, TwoSRdown, IRdown), true, memT, memHeff, denT, temp);
+               }
+               if ( N1 == 2 ){
+                  const double factor = Special::phase(TwoSR + TwoSL + 2) * sqrt(0.5 * (TwoSR + 1) * 2) * Wigner::wigner6j(1, 0, 1, TwoSR, TwoSRdown, TwoSL);
+                  sandwich(ikappa, NL, TwoSL, ILdown, NR-1, TwoSRdown, IRdown, factor, Cop->gStorage(NL, TwoSL, ILdown, NL, TwoSL, IL), true,
+                                                                                    Lop->gStorage(NR-1, TwoSRdown, IRdown, NR, TwoSR, IR), false, memT, memHeff, denT, temp);
+               }
+               if ( N1 == 0 ){
+                  const double factor = Special::phase(TwoSRdown + TwoSL + 1) * sqrt(0.5 * (TwoSRdown + 1) * 2) * Wigner::wigner6j(1, 0, 1, TwoSR, TwoSRdown, TwoSL);
+                  sandwich(ikappa, NL, TwoSL, ILdown, NR+1, TwoSRdown, IRdown, factor, Cop->gStorage(NL, TwoSL, IL, NL, TwoSL, ILdown), false,
+                                                                                    Lop->gStorage(NR, TwoSR, IR, NR+1, TwoSRdown, IRdown), true, memT, memHeff, denT, temp);
+               }
+            }
+         }
+
+         //4B3and4B4spin1
+         TensorOperator * Dop = Dleft[ l_index - theindex ][ 0 ];
+         ILdown = Irreps::directProd( IL, Dop->get_irrep() );
+         for ( int TwoSLdown = TwoSL-2; TwoSLdown <= TwoSL+2; TwoSLdown+=2 ){
+            for ( int TwoSRdown = TwoSR-1; TwoSRdown <= TwoSR+1; TwoSRdown+=2 ){
+               if (( TwoSLdown >= 0 ) && ( TwoSRdown >= 0 )){
+                  if ( N1 == 1 ){
+                     double factor = Special::phase(TwoSL - TwoSLdown + TwoSR - TwoSRdown + 3) * sqrt(3.0 * (TwoSR + 1) * (TwoJ + 1) * (TwoSL + 1))
+                                   * Wigner::wigner9j(2, TwoSL, TwoSLdown, 1, TwoSR, TwoSRdown, 1, TwoJ, 0);
+                     sandwich(ikappa, NL, TwoSLdown, ILdown, NR-1, TwoSRdown, IRdown, factor, Dop->gStorage(NL, TwoSLdown, ILdown, NL, TwoSL, IL), true,
+                                                                                           Lop->gStorage(NR-1, TwoSRdown, IRdown, NR, TwoSR, IR), false, memT, memHeff, denT, temp);
+                     factor = - sqrt(3.0 * (TwoSRdown + 1) * (TwoJ + 1) * (TwoSLdown + 1)) * Wigner::wigner9j(2, TwoSL, TwoSLdown, 1, TwoSR, TwoSRdown, 1, TwoJ, 0);
+                     sandwich(ikappa, NL, TwoSLdown, ILdown, NR+1, TwoSRdown, IRdown, factor, Dop->gStorage(NL, TwoSL, IL, NL, TwoSLdown, ILdown), false,
+                                                                                           Lop->gStorage(NR, TwoSR, IR, NR+1, TwoSRdown, IRdown), true, memT, memHeff, denT, temp);
+                  }
+                  if ( N1 == 2 ){
+                     const double factor = - sqrt(3.0 * (TwoSR + 1) * 2 * (TwoSL + 1)) * Wigner::wigner9j(2, TwoSLdown, TwoSL, 1, TwoSRdown, TwoSR, 1, 1, 0);
+                     sandwich(ikappa, NL, TwoSLdown, ILdown, NR-1, TwoSRdown, IRdown, factor, Dop->gStorage(NL, TwoSLdown, ILdown, NL, TwoSL, IL), true,
+                                                                                           Lop->gStorage(NR-1, TwoSRdown, IRdown, NR, TwoSR, IR), false, memT, memHeff, denT, temp);
+                  }
+                  if ( N1 == 0 ){
+                     const double factor = Special::phase(TwoSRdown - TwoSR + TwoSLdown - TwoSL + 3) * sqrt(3.0 * (TwoSRdown + 1) * 2 * (TwoSLdown + 1))
+                                         * Wigner::wigner9j(2, TwoSLdown, TwoSL, 1, TwoSRdown, TwoSR, 1, 1, 0);
+                     sandwich(ikappa, NL, TwoSLdown, ILdown, NR+1, TwoSRdown, IRdown, factor, Dop->gStorage(NL, TwoSL, IL, NL, TwoSLdown, ILdown), false,
+                                                                                           Lop->gStorage(NR, TwoSR, IR, NR+1, TwoSRdown, IRdown), true, memT, memHeff, denT, temp);
+                  }
+               }
+            }
+         }
+      }
+   }
+
+}
+
+void CheMPS2::HeffOneSite::addDiagram4E(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorL ** Lleft, TensorL ** Lright, double * temp, double * temp2) const{
+
+   #ifdef CHEMPS2_MPI_COMPILATION
+   const int MPIRANK = MPIchemps2::mpi_rank();
+   #endif
+   const int NL = denT->gNL(ikappa); const int TwoSL = denT->gTwoSL(ikappa); const int IL = denT->gIL(ikappa);
+   const int NR = denT->gNR(ikappa); const int TwoSR = denT->gTwoSR(ikappa); const int IR = denT->gIR(ikappa);
+   const int N1 = NR - NL;
+   const int theindex = denT->gIndex();
+   int inc = 1;
+
+   /* The four cases: 4E1 and 4E2 for an empty or doubly occupied site, 4E3 (T( NL-1, NR-1 )) and 4E4 (T( NL+1, NR+1 )) for a singly or doubly occupied site.
+      For each left orbital l_left, the right L-operators are summed with their integrals in temp2, and then sandwiched. */
+   for ( int type = 0; type < 4; type++ ){
+      bool active = ( type == 0 ) ? ( N1 == 0 ) : (( type == 1 ) ? ( N1 == 2 ) : ( N1 >= 1 ));
+      #ifdef CHEMPS2_MPI_COMPILATION
+      int diagram = MPI_CHEMPS2_4E1;
+      if ( type == 1 ){ diagram = MPI_CHEMPS2_4E2; }
+      if ( type == 2 ){ diagram = (( N1 == 1 ) ? MPI_CHEMPS2_4E3A : MPI_CHEMPS2_4E3B ); }
+      if ( type == 3 ){ diagram = (( N1 == 1 ) ? MPI_CHEMPS2_4E4A : MPI_CHEMPS2_4E4B ); }
+      if ( MPIchemps2::owner_specific_diagram( Prob->gL(), diagram ) != MPIRANK ){ active = false; }
+      #endif
+      if ( active ){
+         const int NLdown = (( type == 0 ) || ( type == 2 )) ? NL - 1 : NL + 1;
+         const int NRdown = (( type == 1 ) || ( type == 2 )) ? NR - 1 : NR + 1;
+         for ( int TwoSLdown = TwoSL-1; TwoSLdown <= TwoSL+1; TwoSLdown+=2 ){
+            for ( int TwoSRdown = TwoSR-1; TwoSRdown <= TwoSR+1; TwoSRdown+=2 ){
+               if (( TwoSLdown >= 0 ) && ( TwoSRdown >= 0 )){
+                  double factor1 = 0.0; // Coefficient of Mx( l_left, l_right, theindex, theindex ) or Mx( l_left, theindex, theindex, l_right )
+                  double factor2 = 0.0; // Coefficient of Mx( l_left, theindex, l_right, theindex )
+                  if ( type == 0 ){
+                     factor1 = Special::phase(TwoSL + TwoSR) * sqrt((TwoSL + 1) * (TwoSRdown + 1.0)) * Wigner::wigner6j(TwoSL, TwoSR, 0, TwoSRdown, TwoSLdown, 1);
+                  }
+                  if ( type == 1 ){
+                     factor1 = Special::phase(TwoSLdown + TwoSRdown) * sqrt((TwoSLdown + 1) * (TwoSR + 1.0)) * Wigner::wigner6j(TwoSLdown, TwoSRdown, 0, TwoSR, TwoSL, 1);
+                  }
+                  if (( type == 2 ) && ( N1 == 1 )){
+                     factor1 = Special::phase(TwoSL + TwoSR + 1 + TwoSLdown + TwoSRdown + 1) * sqrt(4.0 * (TwoSL + 1) * (TwoSR + 1))
+                             * Wigner::wigner6j(TwoSL, TwoSRdown, 0, 1, 1, TwoSLdown) * Wigner::wigner6j(1, 1, 0, TwoSRdown, TwoSL, TwoSR);
+                     factor2 = Special::phase(TwoSL + TwoSRdown + 4) * sqrt((TwoSL + 1) * (TwoSR + 1.0)) * Wigner::wigner6j(TwoSLdown, TwoSRdown, 1, TwoSR, TwoSL, 1);
+                  }
+                  if (( type == 2 ) && ( N1 == 2 )){
+                     const double factor = Special::phase(TwoSL + TwoSRdown + 3) * sqrt((TwoSL + 1) * (TwoSR + 1.0)) * Wigner::wigner6j(TwoSLdown, TwoSRdown, 0, TwoSR, TwoSL, 1);
+                     factor1 = factor;
+                     factor2 = -2 * factor;
+                  }
+                  if (( type == 3 ) && ( N1 == 1 )){
+                     factor1 = Special::phase(TwoSL + TwoSR + 1 + TwoSLdown + TwoSRdown + 1) * sqrt(4.0 * (TwoSLdown + 1) * (TwoSRdown + 1))
+                             * Wigner::wigner6j(TwoSLdown, TwoSR, 0, 1, 1, TwoSL) * Wigner::wigner6j(1, 1, 0, TwoSR, TwoSLdown, TwoSRdown);
+                     factor2 = Special::phase(TwoSLdown + TwoSR + 4) * sqrt((TwoSLdown + 1) * (TwoSRdown + 1.0)) * Wigner::wigner6j(TwoSL, TwoSR, 1, TwoSRdown, TwoSLdown, 1);
+                  }
+                  if (( type == 3 ) && ( N1 == 2 )){
+                     const double factor = Special::phase(TwoSLdown + TwoSR + 3) * sqrt((TwoSLdown + 1) * (TwoSRdown + 1.0)) * Wigner::wigner6j(TwoSL, TwoSR, 0, TwoSRdown, TwoSLdown, 1);
+                     factor1 = factor;
+                     factor2 = -2 * factor;
+                  }
+                  if (( factor1 == 0.0 ) && ( factor2 == 0.0 )){ continue; }
+                  for ( int Irrep = 0; Irrep < denBK->getNumberOfIrreps(); Irrep++ ){
+                     const int ILdown = Irreps::directProd( IL, Irrep );
+                     const int IRdown = Irreps::directProd( IR, Irrep );
+                     if ( denT->gKappa( NLdown, TwoSLdown, ILdown, NRdown, TwoSRdown, IRdown ) != -1 ){
+                        // The right L-operator blocks: ( NR, NR+1 ) blocks are transposed, ( NR-1, NR ) blocks are not
+                        const bool trans_right = ( NRdown > NR );
+                        const bool trans_left  = ( NLdown < NL );
+                        int size = denBK->gCurrentDim( theindex + 1, NR, TwoSR, IR ) * denBK->gCurrentDim( theindex + 1, NRdown, TwoSRdown, IRdown );
+                        for ( int l_left = 0; l_left < theindex; l_left++ ){
+                           if ( denBK->gIrrep( l_left ) == Irrep ){
+                              bool filled = false;
+                              for ( int l_right = theindex + 1; l_right < Prob->gL(); l_right++ ){
+                                 if ( denBK->gIrrep( l_right ) == Irrep ){
+                                    double * Lblock = (( trans_right ) ? Lright[ l_right - theindex - 1 ]->gStorage( NR, TwoSR, IR, NRdown, TwoSRdown, IRdown )
+                                                                       : Lright[ l_right - theindex - 1 ]->gStorage( NRdown, TwoSRdown, IRdown, NR, TwoSR, IR ));
+                                    double prefact = ( type <= 1 ) ? factor1 * Prob->gMxElement( l_left, l_right, theindex, theindex )
+                                                                   : factor1 * Prob->gMxElement( l_left, theindex, theindex, l_right )
+                                                                   + factor2 * Prob->gMxElement( l_left, theindex, l_right, theindex );
+                                    if ( filled == false ){
+                                       for ( int cnt = 0; cnt < size; cnt++ ){ temp2[ cnt ] = 0.0; }
+                                       filled = true;
+                                    }
+                                    daxpy_( &size, &prefact, Lblock, &inc, temp2, &inc );
+                                 }
+                              }
+                              if ( filled ){
+                                 double * Lblock = (( trans_left ) ? Lleft[ theindex - 1 - l_left ]->gStorage( NLdown, TwoSLdown, ILdown, NL, TwoSL, IL )
+                                                                  : Lleft[ theindex - 1 - l_left ]->gStorage( NL, TwoSL, IL, NLdown, TwoSLdown, ILdown ));
+                                 sandwich(ikappa, NLdown, TwoSLdown, ILdown, NRdown, TwoSRdown, IRdown, 1.0, Lblock, trans_left, temp2, trans_right, memT, memHeff, denT, temp);
+                              }
+                           }
+                        }
+                     }
+                  }
+               }
+            }
+         }
+      }
+   }
+
+}
+
+void CheMPS2::HeffOneSite::addDiagram4L(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorL ** Lleft, TensorOperator *** Aright, TensorOperator *** Bright, TensorOperator *** Cright, TensorOperator *** Dright, double * temp) const{
+
+   #ifdef CHEMPS2_MPI_COMPILATION
+   const int MPIRANK = MPIchemps2::mpi_rank();
+   #endif
+   const int NL = denT->gNL(ikappa); const int TwoSL = denT->gTwoSL(ikappa); const int IL = denT->gIL(ikappa);
+   const int NR = denT->gNR(ikappa); const int TwoSR = denT->gTwoSR(ikappa); const int IR = denT->gIR(ikappa);
+   const int N1 = NR - NL;
+   const int theindex = denT->gIndex();
+
+   for ( int l_index = 0; l_index < theindex; l_index++ ){
+      const int ILdown = Irreps::directProd( IL, denBK->gIrrep( l_index ) );
+      TensorL * Lop = Lleft[ theindex - 1 - l_index ];
+
+      #ifdef CHEMPS2_MPI_COMPILATION
+      if ( MPIchemps2::owner_absigma( l_index, theindex ) == MPIRANK )
+      #endif
+      {
+         //4L1and4L2spin0
+         TensorOperator * Aop = Aright[ theindex - l_index ][ 0 ];
+         int IRdown = Irreps::directProd( IR, Aop->get_irrep() );
+         for ( int TwoSLdown = TwoSL-1; TwoSLdown <= TwoSL+1; TwoSLdown+=2 ){
+            if ( TwoSLdown >= 0 ){
+               if ( N1 == 1 ){
+                  double factor = Special::phase(TwoSLdown + TwoSR + 2) * sqrt(0.5 * (TwoSL + 1) * 2) * Wigner::wigner6j(0, 1, 1, TwoSL, TwoSLdown, TwoSR);
+                  sandwich(ikappa, NL-1, TwoSLdown, ILdown, NR-2, TwoSR, IRdown, factor, Lop->gStorage(NL-1, TwoSLdown, ILdown, NL, TwoSL, IL), true,
+                                                                                      Aop->gStorage(NR-2, TwoSR, IRdown, NR, TwoSR, IR), false, memT, memHeff, denT, temp);
+                  factor = Special::phase(TwoSL + TwoSR + 3) * sqrt(0.5 * (TwoSLdown + 1) * 2) * Wigner::wigner6j(1, 0, 1, TwoSLdown, TwoSL, TwoSR);
+                  sandwich(ikappa, NL+1, TwoSLdown, ILdown, NR+2, TwoSR, IRdown, factor, Lop->gStorage(NL, TwoSL, IL, NL+1, TwoSLdown, ILdown), false,
+                                                                                      Aop->gStorage(NR, TwoSR, IR, NR+2, TwoSR, IRdown), true, memT, memHeff, denT, temp);
+               }
+               if ( N1 == 2 ){
+                  const double factor = Special::phase(TwoSLdown + TwoSR + 3) * sqrt(0.5 * (TwoSL + 1) * 2) * Wigner::wigner6j(1, 0, 1, TwoSL, TwoSLdown, TwoSR);
+                  sandwich(ikappa, NL-1, TwoSLdown, ILdown, NR-2, TwoSR, IRdown, factor, Lop->gStorage(NL-1, TwoSLdown, ILdown, NL, TwoSL, IL), true,
+                                                                                      Aop->gStorage(NR-2, TwoSR, IRdown, NR, TwoSR, IR), false, memT, memHeff, denT, temp);
+               }
+               if ( N1 == 0 ){
+                  const double factor = Special::phase(TwoSL + TwoSR + 2) * sqrt(0.5 * (TwoSLdown + 1) * 2) * Wigner::wigner6j(1, 0, 1, TwoSL, TwoSLdown, TwoSR);
+                  sandwich(ikappa, NL+1, TwoSLdown, ILdown, NR+2, TwoSR, IRdown, factor, Lop->gStorage(NL, TwoSL, IL, NL+1, TwoSLdown, ILdown), false,
+                                                                                      Aop->gStorage(NR, TwoSR, IR, NR+2, TwoSR, IRdown), true, memT, memHeff, denT, temp);
+               }
+            }
+         }
+
+         //4L1and4L2spin1
+         TensorOperator * Bop = Bright[ theindex - l_index ][ 0 ];
+         IRdown = Irreps::directProd( IR, Bop->get_irrep() );
+         for ( int TwoSLdown = TwoSL-1; TwoSLdown <= TwoSL+1; TwoSLdown+=2 ){
+            for ( int TwoSRdown = TwoSR-2; TwoSRdown <= TwoSR+2; TwoSRdown+=2 ){
+               if (( TwoSLdown >= 0 ) && ( TwoSRdown >= 0 )){
+                  if ( N1 == 1 ){
+                     double factor = sqrt(3.0 * (TwoSR + 1) * (TwoSL + 1) * 2) * Wigner::wigner9j(2, TwoSR, TwoSRdown, 1, TwoSL, TwoSLdown, 1, 1, 0);
+                     sandwich(ikappa, NL-1, TwoSLdown, ILdown, NR-2, TwoSRdown, IRdown, factor, Lop->gStorage(NL-1, TwoSLdown, ILdown, NL, TwoSL, IL), true,
+                                                                                             Bop->gStorage(NR-2, TwoSRdown, IRdown, NR, TwoSR, IR), false, memT, memHeff, denT, temp);
+                     factor = Special::phase(TwoSRdown - TwoSR + TwoSL - TwoSLdown - 1) * sqrt(3.0 * (TwoSRdown + 1) * (TwoSLdown + 1) * 2)
+                            * Wigner::wigner9j(2, TwoSR, TwoSRdown, 1, TwoSL, TwoSLdown, 1, 1, 0);
+                     sandwich(ikappa, NL+1, TwoSLdown, ILdown, NR+2, TwoSRdown, IRdown, factor, Lop->gStorage(NL, TwoSL, IL, NL+1, TwoSLdown, ILdown), false,
+                                                                                             Bop->gStorage(NR, TwoSR, IR, NR+2, TwoSRdown, IRdown), true, memT, memHeff, denT, temp);
+                  }
+                  if ( N1 == 2 ){
+                     const double factor = Special::phase(TwoSR - TwoSRdown + TwoSLdown - TwoSL - 1) * sqrt(3.0 * (TwoSR + 1) * (TwoSL + 1) * 2)
+                                         * Wigner::wigner9j(2, TwoSRdown, TwoSR, 1, TwoSLdown, TwoSL, 1, 1, 0);
+                     sandwich(ikappa, NL-1, TwoSLdown, ILdown, NR-2, TwoSRdown, IRdown, factor, Lop->gStorage(NL-1, TwoSLdown, ILdown, NL, TwoSL, IL), true,
+                                                                                             Bop->gStorage(NR-2, TwoSRdown, IRdown, NR, TwoSR, IR), false, memT, memHeff, denT, temp);
+                  }
+                  if ( N1 == 0 ){
+                     const double factor = sqrt(3.0 * (TwoSRdown + 1) * (TwoSLdown + 1) * 2) * Wigner::wigner9j(2, TwoSRdown, TwoSR, 1, TwoSLdown, TwoSL, 1, 1, 0);
+                     sandwich(ikappa, NL+1, TwoSLdown, ILdown, NR+2, TwoSRdown, IRdown, factor, Lop->gStorage(NL, TwoSL, IL, NL+1, TwoSLdown, ILdown), false,
+                                                                                             Bop->gStorage(NR, TwoSR, IR, NR+2, TwoSRdown, IRdown), true, memT, memHeff, denT, temp);
+                  }
+               }
+            }
+         }
+      }
+
+      #ifdef CHEMPS2_MPI_COMPILATION
+      if ( MPIchemps2::owner_cdf( Prob->gL(), l_index, theindex ) == MPIRANK )
+      #endif
+      {
+         //4L3and4L4spin0
+         TensorOperator * Cop = Cright[ theindex - l_index ][ 0 ];
+         int IRdown = Irreps::directProd( IR, Cop->get_irrep() );
+         for ( int TwoSLdown = TwoSL-1; TwoSLdown <= TwoSL+1; TwoSLdown+=2 ){
+            if ( TwoSLdown >= 0 ){
+               if ( N1 == 1 ){
+                  double factor = Special::phase(TwoSL + TwoSR + 1) * sqrt(0.5 * (TwoSLdown + 1) * 2) * Wigner::wigner6j(1, 0, 1, TwoSLdown, TwoSL, TwoSR);
+                  sandwich(ikappa, NL+1, TwoSLdown, ILdown, NR, TwoSR, IRdown, factor, Lop->gStorage(NL, TwoSL, IL, NL+1, TwoSLdown, ILdown), false,
+                                                                                    Cop->gStorage(NR, TwoSR, IR, NR, TwoSR, IRdown), true, memT, memHeff, denT, temp);
+                  factor = Special::phase(TwoSLdown + TwoSR + 2) * sqrt(0.5 * (TwoSL + 1) * 2) * Wigner::wigner6j(1, 0, 1, TwoSLdown, TwoSL, TwoSR);
+                  sandwich(ikappa, NL-1, TwoSLdown, ILdown, NR, TwoSR, IRdown, factor, Lop->gStorage(NL-1, TwoSLdown, ILdown, NL, TwoSL, IL), true,
+                                                                                    Cop->gStorage(NR, TwoSR, IRdown, NR, TwoSR, IR), false, memT, memHeff, denT, temp);
+               }
+               if ( N1 == 2 ){
+                  const double factor = Special::phase(TwoSL + TwoSR + 2) * sqrt(0.5 * (TwoSLdown + 1) * 2) * Wigner::wigner6j(1, 0, 1, TwoSL, TwoSLdown, TwoSR);
+                  sandwich(ikappa, NL+1, TwoSLdown, ILdown, NR, TwoSR, IRdown, factor, Lop->gStorage(NL, TwoSL, IL, NL+1, TwoSLdown, ILdown), false,
+                                                                                    Cop->gStorage(NR, TwoSR, IR, NR, TwoSR, IRdown), true, memT, memHeff, denT, temp);
+               }
+               if ( N1 == 0 ){
+                  const double factor = Special::phase(TwoSLdown + TwoSR + 1) * sqrt(0.5 * (TwoSL + 1) * 2) * Wigner::wigner6j(1, 0, 1, TwoSL, TwoSLdown, TwoSR);
+                  sandwich(ikappa, NL-1, TwoSLdown, ILdown, NR, TwoSR, IRdown, factor, Lop->gStorage(NL-1, TwoSLdown, ILdown, NL, TwoSL, IL), true,
+                                                                                    Cop->gStorage(NR, TwoSR, IRdown, NR, TwoSR, IR), false, memT, memHeff, denT, temp);
+               }
+            }
+         }
+
+         //4L3and4L4spin1
+         TensorOperator * Dop = Dright[ theindex - l_index ][ 0 ];
+         IRdown = Irreps::directProd( IR, Dop->get_irrep() );
+         for ( int TwoSLdown = TwoSL-1; TwoSLdown <= TwoSL+1; TwoSLdown+=2 ){
+            for ( int TwoSRdown = TwoSR-2; TwoSRdown <= TwoSR+2; TwoSRdown+=2 ){
+               if (( TwoSLdown >= 0 ) && ( TwoSRdown >= 0 )){
+                  if ( N1 == 1 ){
+                     double factor = Special::phase(TwoSL - TwoSLdown + 1) * sqrt(3.0 * (TwoSR + 1) * (TwoSLdown + 1) * 2) * Wigner::wigner9j(2, TwoSR, TwoSRdown, 1, TwoSL, TwoSLdown, 1, 1, 0);
+                     sandwich(ikappa, NL+1, TwoSLdown, ILdown, NR, TwoSRdown, IRdown, factor, Lop->gStorage(NL, TwoSL, IL, NL+1, TwoSLdown, ILdown), false,
+                                                                                           Dop->gStorage(NR, TwoSR, IR, NR, TwoSRdown, IRdown), true, memT, memHeff, denT, temp);
+                     factor = Special::phase(TwoSR - TwoSRdown) * sqrt(3.0 * (TwoSRdown + 1) * (TwoSL + 1) * 2) * Wigner::wigner9j(2, TwoSR, TwoSRdown, 1, TwoSL, TwoSLdown, 1, 1, 0);
+                     sandwich(ikappa, NL-1, TwoSLdown, ILdown, NR, TwoSRdown, IRdown, factor, Lop->gStorage(NL-1, TwoSLdown, ILdown, NL, TwoSL, IL), true,
+                                                                                           Dop->gStorage(NR, TwoSRdown, IRdown, NR, TwoSR, IR), false, memT, memHeff, denT, temp);
+                  }
+                  if ( N1 == 2 ){
+                     const double factor = Special::phase(TwoSR - TwoSRdown) * sqrt(3.0 * (TwoSR + 1) * (TwoSLdown + 1) * 2) * Wigner::wigner9j(2, TwoSRdown, TwoSR, 1, TwoSLdown, TwoSL, 1, 1, 0);
+                     sandwich(ikappa, NL+1, TwoSLdown, ILdown, NR, TwoSRdown, IRdown, factor, Lop->gStorage(NL, TwoSL, IL, NL+1, TwoSLdown, ILdown), false,
+                                                                                           Dop->gStorage(NR, TwoSR, IR, NR, TwoSRdown, IRdown), true, memT, memHeff, denT, temp);
+                  }
+                  if ( N1 == 0 ){
+                     const double factor = Special::phase(TwoSLdown - TwoSL + 1) * sqrt(3.0 * (TwoSRdown + 1) * (TwoSL + 1) * 2) * Wigner::wigner9j(2, TwoSRdown, TwoSR, 1, TwoSLdown, TwoSL, 1, 1, 0);
+                     sandwich(ikappa, NL-1, TwoSLdown, ILdown, NR, TwoSRdown, IRdown, factor, Lop->gStorage(NL-1, TwoSLdown, ILdown, NL, TwoSL, IL), true,
+                                                                                           Dop->gStorage(NR, TwoSRdown, IRdown, NR, TwoSR, IR), false, memT, memHeff, denT, temp);
+                  }
+               }
+            }
+         }
+      }
+   }
+
+}
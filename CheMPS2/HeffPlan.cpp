@@ -0,0 +1,602 @@
+/*
+   CheMPS2: a spin-adapted implementation of DMRG for ab initio quantum chemistry
+   Copyright (C) 2013-2016 Sebastian Wouters
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include <stdlib.h>
+#include <assert.h>
+#include <algorithm>
+#include <utility>
+#ifdef _OPENMP
+   #include <omp.h>
+#endif
+
+#include "HeffPlan.h"
+#include "Lapack.h"
+
+CheMPS2::HeffPlan::HeffPlan( const Sobject * denS, const int max_megabytes ){
+
+   this->denS = denS;
+   #ifdef _OPENMP
+   num_threads = omp_get_max_threads();
+   #else
+   num_threads = 1;
+   #endif
+   num_kappa = denS->gNKappa();
+   veclength = denS->gKappa2index( num_kappa );
+   status    = 0;
+   max_bytes = ((long long) max_megabytes) * 1048576;
+
+   ops       = new HeffPlanOp*[ num_kappa ];
+   num_ops   = new int[ num_kappa ];
+   cap_ops   = new int[ num_kappa ];
+   for ( int ikappa = 0; ikappa < num_kappa; ikappa++ ){
+      ops[ ikappa ]       = NULL;
+      num_ops[ ikappa ]   = 0;
+      cap_ops[ ikappa ]   = 0;
+   }
+   kappa_unit = new int[ num_kappa + 1 ];
+   num_units   = 0;
+   unit_kappa  = NULL;
+   unit_first  = NULL;
+   unit_last   = NULL;
+   unit_offset = NULL;
+   unit_order  = NULL;
+
+   num_vectors     = 1;
+   partial_size    = 0;
+   partial_vectors = 0;
+   partial         = NULL;
+   block_vectors   = 0;
+   block_S         = NULL;
+   block_H         = NULL;
+
+   rec_ikappa = new int[ num_threads ];
+   rec_base   = new double*[ 5 * num_threads ];
+   rec_size   = new long long[ 5 * num_threads ];
+   for ( int th = 0; th < num_threads; th++ ){
+      rec_ikappa[ th ] = -1;
+      for ( int base = 0; base < 5; base++ ){
+         rec_base[ base + 5 * th ] = NULL;
+         rec_size[ base + 5 * th ] = 0;
+      }
+   }
+
+}
+
+CheMPS2::HeffPlan::~HeffPlan(){
+
+   clear_ops();
+   if ( block_S != NULL ){
+      delete [] block_S;
+      delete [] block_H;
+   }
+   delete [] ops;
+   delete [] num_ops;
+   delete [] cap_ops;
+   delete [] kappa_unit;
+   delete [] rec_ikappa;
+   delete [] rec_base;
+   delete [] rec_size;
+
+}
+
+const CheMPS2::Sobject * CheMPS2::HeffPlan::gSobject() const{ return denS; }
+
+bool CheMPS2::HeffPlan::gComplete() const{ return ( status == 1 ); }
+
+bool CheMPS2::HeffPlan::gEmpty() const{ return ( status == 0 ); }
+
+void CheMPS2::HeffPlan::clear_ops(){
+
+   for ( int ikappa = 0; ikappa < num_kappa; ikappa++ ){
+      if ( ops[ ikappa ] != NULL ){ delete [] ops[ ikappa ]; }
+      ops[ ikappa ]       = NULL;
+      num_ops[ ikappa ]   = 0;
+      cap_ops[ ikappa ]   = 0;
+   }
+   if ( unit_kappa != NULL ){
+      delete [] unit_kappa;
+      delete [] unit_first;
+      delete [] unit_last;
+      delete [] unit_offset;
+      delete [] unit_order;
+   }
+   num_units   = 0;
+   unit_kappa  = NULL;
+   unit_first  = NULL;
+   unit_last   = NULL;
+   unit_offset = NULL;
+   unit_order  = NULL;
+   if ( partial != NULL ){ delete [] partial; }
+   partial_size    = 0;
+   partial_vectors = 0;
+   partial         = NULL;
+
+}
+
+int CheMPS2::HeffPlan::thread() const{
+
+   #ifdef _OPENMP
+   const int th = omp_get_thread_num();
+   #else
+   const int th = 0;
+   #endif
+   assert( th < num_threads );
+   return th;
+
+}
+
+void CheMPS2::HeffPlan::start( const int ikappa, double * memS, double * memHeff, double * temp, double * temp2, const int tempsize ){
+
+   assert( status == 0 );
+   const int th = thread();
+   rec_ikappa[ th ] = ikappa;
+   rec_base[ base_S  + 5 * th ] = memS;
+   rec_base[ base_H  + 5 * th ] = memHeff + denS->gKappa2index( ikappa );
+   rec_base[ base_T1 + 5 * th ] = temp;
+   rec_base[ base_T2 + 5 * th ] = temp2;
+   rec_size[ base_S  + 5 * th ] = veclength;
+   rec_size[ base_H  + 5 * th ] = denS->gKappa2index( ikappa + 1 ) - denS->gKappa2index( ikappa );
+   rec_size[ base_T1 + 5 * th ] = tempsize;
+   rec_size[ base_T2 + 5 * th ] = tempsize;
+   num_ops[ ikappa ] = 0;
+
+}
+
+void CheMPS2::HeffPlan::cut(){
+
+   const int th = thread();
+   if ( rec_ikappa[ th ] == -1 ){ return; }
+   HeffPlanOp * op = append( th );
+   op->type = 'X';
+
+}
+
+void CheMPS2::HeffPlan::stop(){
+
+   rec_ikappa[ thread() ] = -1;
+
+}
+
+void CheMPS2::HeffPlan::finish(){
+
+   assert( status == 0 );
+   divide();
+   layout();
+   long long num_bytes = partial_size * sizeof( double );
+   for ( int ikappa = 0; ikappa < num_kappa; ikappa++ ){ num_bytes += ((long long) cap_ops[ ikappa ]) * sizeof( HeffPlanOp ); }
+   if ( num_bytes > max_bytes ){
+      clear_ops();
+      status = 2;
+   } else {
+      status = 1;
+   }
+
+}
+
+double CheMPS2::HeffPlan::cost( const HeffPlanOp & op ){
+
+   switch ( op.type ){
+      case 'G': return 2.0 * op.dim[0] * op.dim[1] * op.dim[2];
+      case 'A': return 2.0 * op.dim[0];
+      case 'C': return op.dim[0];
+      case 'Z': return op.dim[0];
+   }
+   return 0.0;
+
+}
+
+void CheMPS2::HeffPlan::divide(){
+
+   double total = 0.0;
+   int max_units = num_kappa;
+   for ( int ikappa = 0; ikappa < num_kappa; ikappa++ ){
+      for ( int cnt = 0; cnt < num_ops[ ikappa ]; cnt++ ){
+         total += cost( ops[ ikappa ][ cnt ] );
+         if ( ops[ ikappa ][ cnt ].type == 'X' ){ max_units++; }
+      }
+   }
+
+   // Aim for about four tasks per thread; a single thread does not split the sectors
+   const double target = ( num_threads == 1 ) ? ( total + 1.0 ) : total / ( 4 * num_threads );
+
+   unit_kappa  = new int[ max_units ];
+   unit_first  = new int[ max_units ];
+   unit_last   = new int[ max_units ];
+   unit_offset = new long long[ max_units ];
+   double * unit_cost = new double[ max_units ];
+   num_units = 0;
+   for ( int ikappa = 0; ikappa < num_kappa; ikappa++ ){
+      kappa_unit[ ikappa ] = num_units;
+      int first = 0;
+      double acc = 0.0;
+      for ( int cnt = 0; cnt < num_ops[ ikappa ]; cnt++ ){
+         acc += cost( ops[ ikappa ][ cnt ] );
+         if (( ops[ ikappa ][ cnt ].type == 'X' ) && ( acc >= target )){
+            unit_kappa[ num_units ] = ikappa;
+            unit_first[ num_units ] = first;
+            unit_last [ num_units ] = cnt + 1;
+            unit_cost [ num_units ] = acc;
+            num_units++;
+            first = cnt + 1;
+            acc = 0.0;
+         }
+      }
+      if (( num_units > kappa_unit[ ikappa ] ) && ( acc < 0.5 * target )){ // Merge a small remainder with the previous task
+         unit_last[ num_units - 1 ]  = num_ops[ ikappa ];
+         unit_cost[ num_units - 1 ] += acc;
+      } else if (( num_units == kappa_unit[ ikappa ] ) || ( first < num_ops[ ikappa ] )){
+         unit_kappa[ num_units ] = ikappa;
+         unit_first[ num_units ] = first;
+         unit_last [ num_units ] = num_ops[ ikappa ];
+         unit_cost [ num_units ] = acc;
+         num_units++;
+      }
+   }
+   kappa_unit[ num_kappa ] = num_units;
+
+   partial_size = 0;
+   for ( int ikappa = 0; ikappa < num_kappa; ikappa++ ){
+      const int size = denS->gKappa2index( ikappa + 1 ) - denS->gKappa2index( ikappa );
+      const bool split = ( kappa_unit[ ikappa + 1 ] - kappa_unit[ ikappa ] > 1 );
+      for ( int unit = kappa_unit[ ikappa ]; unit < kappa_unit[ ikappa + 1 ]; unit++ ){
+         unit_offset[ unit ] = ( split ) ? partial_size : -1;
+         if ( split ){ partial_size += size; }
+      }
+   }
+
+   // Largest tasks first, for the dynamic scheduling
+   std::pair<double, int> * sorted = new std::pair<double, int>[ num_units ];
+   for ( int unit = 0; unit < num_units; unit++ ){ sorted[ unit ] = std::pair<double, int>( -unit_cost[ unit ], unit ); }
+   std::sort( sorted, sorted + num_units );
+   unit_order = new int[ num_units ];
+   for ( int task = 0; task < num_units; task++ ){ unit_order[ task ] = sorted[ task ].second; }
+   delete [] sorted;
+   delete [] unit_cost;
+
+}
+
+int CheMPS2::HeffPlan::shape( const HeffPlanOp & op, const int number, const int rc ){
+
+   // dim = { m, n, k }: op( A ) is m x k, op( B ) is k x n, and C is m x n
+   const int rows[] = { op.dim[0], op.dim[2], op.dim[0] };
+   const int cols[] = { op.dim[2], op.dim[1], op.dim[1] };
+   const bool transposed = (( number < 2 ) && ( op.trans[ number ] != 'N' ) && ( op.trans[ number ] != 'n' ));
+   return ((( rc == 0 ) != transposed ) ? rows[ number ] : cols[ number ] );
+
+}
+
+long long CheMPS2::HeffPlan::extent( const HeffPlanOp & op, const int number ){
+
+   if ( op.type == 'G' ){
+      const int rows = shape( op, number, 0 );
+      const int cols = shape( op, number, 1 );
+      return ((( rows == 0 ) || ( cols == 0 )) ? 0 : ((long long) op.ld[ number ]) * ( cols - 1 ) + rows );
+   }
+   if ( op.type == 'Z' ){ return op.dim[0]; }
+   return (( op.dim[0] == 0 ) ? 0 : ((long long) op.ld[ number ]) * ( op.dim[0] - 1 ) + 1 ); // daxpy_ and dcopy_
+
+}
+
+bool CheMPS2::HeffPlan::contiguous( const HeffPlanOp & op, const int number ){
+
+   if (( op.stride[ number ] == 0 ) || ( op.offset[ number ] != op.start[ number ] )){ return false; }
+   if ( op.type == 'G' ){
+      return (( op.ld[ number ] == shape( op, number, 0 ) ) && ( op.stride[ number ] == ((long long) op.ld[ number ]) * shape( op, number, 1 ) ));
+   }
+   if ( op.type == 'Z' ){ return ( op.stride[ number ] == op.dim[0] ); }
+   return (( op.ld[ number ] == 1 ) && ( op.stride[ number ] == op.dim[0] ));
+
+}
+
+void CheMPS2::HeffPlan::layout(){
+
+   for ( int ikappa = 0; ikappa < num_kappa; ikappa++ ){
+      int first = 0;
+      while ( first < num_ops[ ikappa ] ){
+         int last = first;
+         while (( last < num_ops[ ikappa ] ) && ( ops[ ikappa ][ last ].type != 'X' )){ last++; }
+         layout_group( ikappa, ops[ ikappa ] + first, last - first );
+         first = last + 1;
+      }
+   }
+
+}
+
+void CheMPS2::HeffPlan::layout_group( const int ikappa, HeffPlanOp * group, const int num ){
+
+   // The operands of a call range from first to output: A, B and C for dgemm_, x and y for daxpy_ and dcopy_, and x (number 1) for the zeroing
+
+   // The area of the work arrays which is used by the diagram group
+   long long area[] = { 0, 0 };
+   for ( int cnt = 0; cnt < num; cnt++ ){
+      const HeffPlanOp & op = group[ cnt ];
+      const int first  = ( op.type == 'Z' ) ? 1 : 0;
+      const int output = ( op.type == 'G' ) ? 2 : 1;
+      for ( int number = first; number <= output; number++ ){
+         if ( op.base[ number ] >= base_T1 ){
+            const int work = op.base[ number ] - base_T1;
+            area[ work ] = std::max( area[ work ], op.offset[ number ] + extent( op, number ) );
+         }
+      }
+   }
+
+   // A work array holds vector data when a call with vector data in one of its operands writes to it
+   bool vector_data[] = { false, false };
+   bool change = true;
+   while ( change ){
+      change = false;
+      for ( int cnt = 0; cnt < num; cnt++ ){
+         const HeffPlanOp & op = group[ cnt ];
+         const int first  = ( op.type == 'Z' ) ? 1 : 0;
+         const int output = ( op.type == 'G' ) ? 2 : 1;
+         if (( op.base[ output ] >= base_T1 ) && ( vector_data[ op.base[ output ] - base_T1 ] == false )){
+            bool dependent = false;
+            for ( int number = first; number <= output; number++ ){
+               if (( op.base[ number ] == base_S ) || ( op.base[ number ] == base_H )
+                || (( op.base[ number ] >= base_T1 ) && ( vector_data[ op.base[ number ] - base_T1 ] ))){ dependent = true; }
+            }
+            if ( dependent ){
+               vector_data[ op.base[ output ] - base_T1 ] = true;
+               change = true;
+            }
+         }
+      }
+   }
+
+   for ( int cnt = 0; cnt < num; cnt++ ){
+      HeffPlanOp & op = group[ cnt ];
+      const int first  = ( op.type == 'Z' ) ? 1 : 0;
+      const int output = ( op.type == 'G' ) ? 2 : 1;
+      bool dependent = false;
+      for ( int number = first; number <= output; number++ ){
+         op.start[ number ]  = 0;
+         op.stride[ number ] = 0;
+         if ( op.base[ number ] == base_S ){ // The vectors of the S-object sector of the operand are consecutive
+            int low  = 0;
+            int high = num_kappa;
+            while ( high - low > 1 ){
+               const int mid = ( low + high ) / 2;
+               if ( denS->gKappa2index( mid ) <= op.offset[ number ] ){ low = mid; } else { high = mid; }
+            }
+            op.start[ number ]  = denS->gKappa2index( low );
+            op.stride[ number ] = denS->gKappa2index( low + 1 ) - denS->gKappa2index( low );
+            assert( op.offset[ number ] + extent( op, number ) <= op.start[ number ] + op.stride[ number ] );
+         }
+         if ( op.base[ number ] == base_H ){ op.stride[ number ] = denS->gKappa2index( ikappa + 1 ) - denS->gKappa2index( ikappa ); }
+         if (( op.base[ number ] >= base_T1 ) && ( vector_data[ op.base[ number ] - base_T1 ] )){ op.stride[ number ] = area[ op.base[ number ] - base_T1 ]; }
+         if ( op.stride[ number ] > 0 ){ dependent = true; }
+      }
+      if ( dependent == false ){
+         op.multi = 0;
+      } else if ( op.type == 'G' ){ // op( A ) * [ B_0 B_1 ... ] = [ C_0 C_1 ... ]
+         const bool B_plain = (( op.trans[1] == 'N' ) || ( op.trans[1] == 'n' ));
+         op.multi = ((( op.stride[0] == 0 ) && ( B_plain ) && ( contiguous( op, 1 ) ) && ( contiguous( op, 2 ) )) ? 2 : 1 );
+      } else if ( op.type == 'Z' ){
+         op.multi = (( contiguous( op, 1 ) ) ? 2 : 1 );
+      } else {
+         op.multi = ((( contiguous( op, 0 ) ) && ( contiguous( op, 1 ) )) ? 2 : 1 );
+      }
+   }
+
+}
+
+int CheMPS2::HeffPlan::gNumTasks() const{ return num_units; }
+
+void CheMPS2::HeffPlan::prepare( const int num_vectors ){
+
+   assert( status == 1 );
+   this->num_vectors = num_vectors;
+   if (( partial_size > 0 ) && ( partial_vectors < num_vectors )){
+      if ( partial != NULL ){ delete [] partial; }
+      partial = new double[ partial_size * num_vectors ];
+      partial_vectors = num_vectors;
+   }
+   if (( num_vectors > 1 ) && ( block_vectors < num_vectors )){
+      if ( block_S != NULL ){
+         delete [] block_S;
+         delete [] block_H;
+      }
+      block_S = new double[ veclength * num_vectors ];
+      block_H = new double[ veclength * num_vectors ];
+      block_vectors = num_vectors;
+   }
+
+}
+
+void CheMPS2::HeffPlan::load( const int ikappa, double * memS ) const{
+
+   if ( num_vectors == 1 ){ return; }
+   const long long start = denS->gKappa2index( ikappa );
+   int size = denS->gKappa2index( ikappa + 1 ) - start;
+   int inc = 1;
+   for ( int vec = 0; vec < num_vectors; vec++ ){
+      dcopy_( &size, memS + veclength * vec + start, &inc, block_S + num_vectors * start + size * vec, &inc );
+   }
+
+}
+
+CheMPS2::HeffPlan::HeffPlanOp * CheMPS2::HeffPlan::append( const int th ){
+
+   const int ikappa = rec_ikappa[ th ];
+   if ( num_ops[ ikappa ] == cap_ops[ ikappa ] ){
+      const int new_cap = ( cap_ops[ ikappa ] == 0 ) ? 16 : 2 * cap_ops[ ikappa ];
+      HeffPlanOp * new_ops = new HeffPlanOp[ new_cap ];
+      for ( int op = 0; op < num_ops[ ikappa ]; op++ ){ new_ops[ op ] = ops[ ikappa ][ op ]; }
+      if ( ops[ ikappa ] != NULL ){ delete [] ops[ ikappa ]; }
+      ops[ ikappa ] = new_ops;
+      cap_ops[ ikappa ] = new_cap;
+   }
+   HeffPlanOp * result = ops[ ikappa ] + num_ops[ ikappa ];
+   num_ops[ ikappa ]++;
+   result->multi = 1;
+   for ( int number = 0; number < 3; number++ ){
+      result->base[ number ]   = base_abs;
+      result->offset[ number ] = 0;
+      result->start[ number ]  = 0;
+      result->stride[ number ] = 0;
+      result->ptr[ number ]    = NULL;
+   }
+   return result;
+
+}
+
+void CheMPS2::HeffPlan::classify( const int th, HeffPlanOp * op, const int number, double * pointer ) const{
+
+   for ( int base = base_S; base <= base_T2; base++ ){
+      double * start = rec_base[ base + 5 * th ];
+      if (( start != NULL ) && ( pointer >= start ) && ( pointer < start + rec_size[ base + 5 * th ] )){
+         op->base[ number ]   = base;
+         op->offset[ number ] = pointer - start;
+         op->ptr[ number ]    = NULL;
+         return;
+      }
+   }
+   // Renormalized operators: they do not change at a fixed site
+   op->base[ number ]   = base_abs;
+   op->offset[ number ] = 0;
+   op->ptr[ number ]    = pointer;
+
+}
+
+void CheMPS2::HeffPlan::dgemm( char * transA, char * transB, int * m, int * n, int * k, double * alpha, double * A, int * lda, double * B, int * ldb, double * beta, double * C, int * ldc ){
+
+   const int th = thread();
+   if ( rec_ikappa[ th ] == -1 ){ return; }
+   HeffPlanOp * op = append( th );
+   op->type     = 'G';
+   op->trans[0] = transA[0];
+   op->trans[1] = transB[0];
+   op->dim[0]   = m[0];
+   op->dim[1]   = n[0];
+   op->dim[2]   = k[0];
+   op->ld[0]    = lda[0];
+   op->ld[1]    = ldb[0];
+   op->ld[2]    = ldc[0];
+   op->alpha    = alpha[0];
+   op->beta     = beta[0];
+   classify( th, op, 0, A );
+   classify( th, op, 1, B );
+   classify( th, op, 2, C );
+
+}
+
+void CheMPS2::HeffPlan::daxpy( int * n, double * alpha, double * x, int * incx, double * y, int * incy ){
+
+   const int th = thread();
+   if ( rec_ikappa[ th ] == -1 ){ return; }
+   HeffPlanOp * op = append( th );
+   op->type   = 'A';
+   op->dim[0] = n[0];
+   op->ld[0]  = incx[0];
+   op->ld[1]  = incy[0];
+   op->alpha  = alpha[0];
+   classify( th, op, 0, x );
+   classify( th, op, 1, y );
+
+}
+
+void CheMPS2::HeffPlan::dcopy( int * n, double * x, int * incx, double * y, int * incy ){
+
+   const int th = thread();
+   if ( rec_ikappa[ th ] == -1 ){ return; }
+   HeffPlanOp * op = append( th );
+   op->type   = 'C';
+   op->dim[0] = n[0];
+   op->ld[0]  = incx[0];
+   op->ld[1]  = incy[0];
+   classify( th, op, 0, x );
+   classify( th, op, 1, y );
+
+}
+
+void CheMPS2::HeffPlan::clear( double * x, const int n ){
+
+   const int th = thread();
+   if ( rec_ikappa[ th ] == -1 ){ return; }
+   HeffPlanOp * op = append( th );
+   op->type   = 'Z';
+   op->dim[0] = n;
+   classify( th, op, 1, x );
+
+}
+
+void CheMPS2::HeffPlan::execute( const int task, double * memS, double * memHeff, double * temp, double * temp2 ) const{
+
+   assert( status == 1 );
+   const int unit   = unit_order[ task ];
+   const int ikappa = unit_kappa[ unit ];
+   const long long size = ( denS->gKappa2index( ikappa + 1 ) - denS->gKappa2index( ikappa ) ) * num_vectors;
+   double * vecS    = ( num_vectors == 1 ) ? memS    : block_S;
+   double * vecHeff = ( num_vectors == 1 ) ? memHeff : block_H;
+   double * block   = ( unit_offset[ unit ] == -1 ) ? vecHeff + num_vectors * denS->gKappa2index( ikappa ) : partial + num_vectors * unit_offset[ unit ];
+   for ( long long elem = 0; elem < size; elem++ ){ block[ elem ] = 0.0; }
+   double * bases[] = { NULL, vecS, block, temp, temp2 };
+
+   for ( int cnt = unit_first[ unit ]; cnt < unit_last[ unit ]; cnt++ ){
+      HeffPlanOp op = ops[ ikappa ][ cnt ];
+      if ( op.type == 'X' ){ continue; }
+      double * operand[ 3 ];
+      for ( int number = 0; number < 3; number++ ){
+         operand[ number ] = ( op.base[ number ] == base_abs ) ? op.ptr[ number ] : bases[ (int) op.base[ number ] ] + op.offset[ number ] + ( num_vectors - 1 ) * op.start[ number ];
+      }
+      if ( op.multi == 2 ){ op.dim[ ( op.type == 'G' ) ? 1 : 0 ] *= num_vectors; }
+      const int repeat = ( op.multi == 1 ) ? num_vectors : 1;
+      for ( int vec = 0; vec < repeat; vec++ ){
+         switch ( op.type ){
+            case 'G':
+               dgemm_( op.trans, op.trans + 1, op.dim, op.dim + 1, op.dim + 2, &op.alpha, operand[0], op.ld, operand[1], op.ld + 1, &op.beta, operand[2], op.ld + 2 );
+               break;
+            case 'A':
+               daxpy_( op.dim, &op.alpha, operand[0], op.ld, operand[1], op.ld + 1 );
+               break;
+            case 'C':
+               dcopy_( op.dim, operand[0], op.ld, operand[1], op.ld + 1 );
+               break;
+            case 'Z':
+               for ( int elem = 0; elem < op.dim[0]; elem++ ){ operand[1][ elem ] = 0.0; }
+               break;
+         }
+         for ( int number = 0; number < 3; number++ ){ operand[ number ] += op.stride[ number ]; }
+      }
+   }
+
+}
+
+void CheMPS2::HeffPlan::reduce( const int ikappa, double * memHeff ) const{
+
+   assert( status == 1 );
+   const long long start = denS->gKappa2index( ikappa );
+   int size = denS->gKappa2index( ikappa + 1 ) - start;
+   int inc = 1;
+   double * block = ( num_vectors == 1 ) ? memHeff + start : block_H + num_vectors * start;
+   if ( kappa_unit[ ikappa + 1 ] - kappa_unit[ ikappa ] > 1 ){
+      int length = size * num_vectors;
+      double one = 1.0;
+      dcopy_( &length, partial + num_vectors * unit_offset[ kappa_unit[ ikappa ] ], &inc, block, &inc );
+      for ( int unit = kappa_unit[ ikappa ] + 1; unit < kappa_unit[ ikappa + 1 ]; unit++ ){
+         daxpy_( &length, &one, partial + num_vectors * unit_offset[ unit ], &inc, block, &inc );
+      }
+   }
+   if ( num_vectors > 1 ){
+      for ( int vec = 0; vec < num_vectors; vec++ ){
+         dcopy_( &size, block + size * vec, &inc, memHeff + veclength * vec + start, &inc );
+      }
+   }
+
+}
@@ -0,0 +1,275 @@
+/*
+   CheMPS2: a spin-adapted implementation of DMRG for ab initio quantum chemistry
+   Copyright (C) 2013-2016 Sebastian Wouters
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <vector>
+#include <assert.h>
+
+#include "MPIbalance.h"
+#include "MPIchemps2.h"
+#include "Irreps.h"
+
+const CheMPS2::MPIbalance * CheMPS2::MPIbalance::active = NULL;
+
+CheMPS2::MPIbalance::MPIbalance( const int L, const int num_procs ){
+
+   assert( num_procs >= 1 );
+   this->L         = L;
+   this->num_procs = num_procs;
+   num_pairs       = ( L * ( L + 1 ) ) / 2;
+   num_triples     = ( L * ( L + 1 ) * ( L + 2 ) ) / 6;
+
+   // The round-robin formulas: consecutive owners for the {A,B,Sigma0,Sigma1} pairs, the {C,D,F0,F1} pairs, and the Q orbitals; the triples start at the Q orbitals
+   table = new int[ gTableSize() ];
+   for ( int item = 0; item < 2 * num_pairs + L; item++ ){ table[ item ] = ( 1 + item ) % num_procs; }
+   for ( int triple = 0; triple < num_triples; triple++ ){ table[ 2 * num_pairs + L + triple ] = ( 1 + 2 * num_pairs + triple ) % num_procs; }
+
+   bond_dims = new int[ L + 1 ];
+   for ( int bound = 0; bound <= L; bound++ ){ bond_dims[ bound ] = 0; }
+
+}
+
+CheMPS2::MPIbalance::~MPIbalance(){
+
+   if ( active == this ){ active = NULL; }
+   delete [] table;
+   delete [] bond_dims;
+
+}
+
+void CheMPS2::MPIbalance::activate( const MPIbalance * balance ){ active = balance; }
+
+const CheMPS2::MPIbalance * CheMPS2::MPIbalance::gActive(){ return active; }
+
+int CheMPS2::MPIbalance::gTableSize() const{ return 2 * num_pairs + L + num_triples; }
+
+int * CheMPS2::MPIbalance::gTable(){ return table; }
+
+int CheMPS2::MPIbalance::gOwnerABSigma( const int index1, const int index2 ) const{
+
+   assert( index1 <= index2 );
+   assert( index2 < L );
+   return table[ index1 + ( index2 * ( index2 + 1 ) ) / 2 ];
+
+}
+
+int CheMPS2::MPIbalance::gOwnerCDF( const int index1, const int index2 ) const{
+
+   assert( index1 <= index2 );
+   assert( index2 < L );
+   return table[ num_pairs + index1 + ( index2 * ( index2 + 1 ) ) / 2 ];
+
+}
+
+int CheMPS2::MPIbalance::gOwnerQ( const int index ) const{
+
+   assert( index < L );
+   return table[ 2 * num_pairs + index ];
+
+}
+
+int CheMPS2::MPIbalance::gOwner3RDM( const int index1, const int index2, const int index3 ) const{
+
+   assert( index1 <= index2 );
+   assert( index2 <= index3 );
+   assert( index3 < L );
+   return table[ 2 * num_pairs + L + index1 + ( index2 * ( index2 + 1 ) ) / 2 + ( index3 * ( index3 + 1 ) * ( index3 + 2 ) ) / 6 ];
+
+}
+
+double CheMPS2::MPIbalance::block_cost( const SyBookkeeper * denBK, const int boundary, const int two_j, const int n_elec, const int n_irrep ){
+
+   // Same symmetry blocks as the constructor of TensorOperator
+   double cost = 0.0;
+   for ( int n_up = denBK->gNmin( boundary ); n_up <= denBK->gNmax( boundary ); n_up++ ){
+      for ( int two_s_up = denBK->gTwoSmin( boundary, n_up ); two_s_up <= denBK->gTwoSmax( boundary, n_up ); two_s_up += 2 ){
+         for ( int irrep_up = 0; irrep_up < denBK->getNumberOfIrreps(); irrep_up++ ){
+            const int dim_up = denBK->gCurrentDim( boundary, n_up, two_s_up, irrep_up );
+            if ( dim_up > 0 ){
+               const int irrep_down = Irreps::directProd( n_irrep, irrep_up );
+               for ( int two_s_down = two_s_up - two_j; two_s_down <= two_s_up + two_j; two_s_down += 2 ){
+                  if ( two_s_down >= 0 ){
+                     const int dim_down = denBK->gCurrentDim( boundary, n_up + n_elec, two_s_down, irrep_down );
+                     cost += ( 1.0 * dim_up ) * dim_down * ( dim_up + dim_down );
+                  }
+               }
+            }
+         }
+      }
+   }
+   return cost;
+
+}
+
+double CheMPS2::MPIbalance::range( const double * partial, const int first, const int last ) const{
+
+   const int start = std::max( first, 0 );
+   const int stop  = std::min( last, L - 2 );
+   return (( stop >= start ) ? partial[ stop + 1 ] - partial[ start ] : 0.0 );
+
+}
+
+void CheMPS2::MPIbalance::costs( const SyBookkeeper * denBK, double * cost, double * cost_master ) const{
+
+   // Tensor types ( two_j, n_elec ): {C,F0}, {D,F1}, {A,Sigma0}, {B,Sigma1}, Q, and the four types of 3-RDM tensors
+   const int num_types = 8;
+   const int two_j [] = { 0, 2, 0, 2, 1, 1, 3, 3 };
+   const int n_elec[] = { 0, 0, 2, 2, 1, 3, 1, 3 };
+   const int num_irreps = denBK->getNumberOfIrreps();
+
+   // partial[ L * ( irrep + num_irreps * type ) + index ] = summed cost at the DMRG boundaries [ 0, index ), which are at SyBookkeeper boundary index + 1
+   double * partial = new double[ L * num_irreps * num_types ];
+   for ( int type = 0; type < num_types; type++ ){
+      for ( int irrep = 0; irrep < num_irreps; irrep++ ){
+         double * sum = partial + L * ( irrep + num_irreps * type );
+         sum[ 0 ] = 0.0;
+         for ( int index = 0; index < L - 1; index++ ){ sum[ index + 1 ] = sum[ index ] + block_cost( denBK, index + 1, two_j[ type ], n_elec[ type ], irrep ); }
+      }
+   }
+
+   /* Pair ( i1 <= i2 ) at DMRG boundary index: Sigma and F moving right for i2 < index, A to D moving right for i1 > index,
+      Sigma and F moving left for i1 > index + 1, and A to D moving left for i2 <= index. For i2 == index ( moving right )
+      or i1 == index + 1 ( moving left ), all processes own the Sigma and F tensors. */
+   for ( int i2 = 0; i2 < L; i2++ ){
+      for ( int i1 = 0; i1 <= i2; i1++ ){
+         const int irrep = Irreps::directProd( denBK->gIrrep( i1 ), denBK->gIrrep( i2 ) );
+         double pair_cost[ 4 ];
+         for ( int type = 0; type < 4; type++ ){
+            const double * sum = partial + L * ( irrep + num_irreps * type );
+            pair_cost[ type ] = range( sum, i2 + 1, L - 2 ) + range( sum, 0, i1 - 1 ) + range( sum, 0, i1 - 2 ) + range( sum, i2, L - 2 );
+         }
+         const int pair = i1 + ( i2 * ( i2 + 1 ) ) / 2;
+         cost[ pair ]             = pair_cost[ 2 ] + (( i1 < i2 ) ? pair_cost[ 3 ] : 0.0 );
+         cost[ num_pairs + pair ] = pair_cost[ 0 ] + pair_cost[ 1 ];
+      }
+   }
+
+   // The Q-tensors of an orbital exist at each boundary, moving right or moving left
+   for ( int orb = 0; orb < L; orb++ ){ cost[ 2 * num_pairs + orb ] = range( partial + L * ( denBK->gIrrep( orb ) + num_irreps * 4 ), 0, L - 2 ); }
+
+   // The 3-RDM tensors of triple ( i1 <= i2 <= i3 ) exist at the boundaries index >= i3, moving right
+   for ( int i3 = 0; i3 < L; i3++ ){
+      for ( int i2 = 0; i2 <= i3; i2++ ){
+         for ( int i1 = 0; i1 <= i2; i1++ ){
+            const int irrep = Irreps::directProd( Irreps::directProd( denBK->gIrrep( i1 ), denBK->gIrrep( i2 ) ), denBK->gIrrep( i3 ) );
+            double triple_cost = 0.0;
+            for ( int type = 4; type < num_types; type++ ){ triple_cost += range( partial + L * ( irrep + num_irreps * type ), i3, L - 2 ); }
+            cost[ 2 * num_pairs + L + i1 + ( i2 * ( i2 + 1 ) ) / 2 + ( i3 * ( i3 + 1 ) * ( i3 + 2 ) ) / 6 ] = triple_cost;
+         }
+      }
+   }
+
+   // The X-tensors, moving right and moving left
+   cost_master[ 0 ] = 2 * range( partial, 0, L - 2 );
+
+   delete [] partial;
+
+}
+
+void CheMPS2::MPIbalance::longest_first( const double * cost, double * load, const int start, const int stop ){
+
+   std::pair< double, int > * order = new std::pair< double, int >[ stop - start ];
+   for ( int item = start; item < stop; item++ ){ order[ item - start ] = std::pair< double, int >( cost[ item ], item ); }
+   std::sort( order, order + ( stop - start ), std::greater< std::pair< double, int > >() );
+
+   // Processes in order of increasing load, and increasing rank for equal loads
+   std::priority_queue< std::pair< double, int >, std::vector< std::pair< double, int > >, std::greater< std::pair< double, int > > > procs;
+   for ( int proc = 0; proc < num_procs; proc++ ){ procs.push( std::pair< double, int >( load[ proc ], proc ) ); }
+
+   for ( int cnt = 0; cnt < stop - start; cnt++ ){
+      const int proc = procs.top().second;
+      procs.pop();
+      table[ order[ cnt ].second ] = proc;
+      load[ proc ] += order[ cnt ].first;
+      procs.push( std::pair< double, int >( load[ proc ], proc ) );
+   }
+
+   delete [] order;
+
+}
+
+void CheMPS2::MPIbalance::assign( const SyBookkeeper * denBK ){
+
+   assert( denBK->gL() == L );
+   if ( num_procs > 1 ){
+      #ifdef CHEMPS2_MPI_COMPILATION
+      if ( MPIchemps2::mpi_rank() == MPI_CHEMPS2_MASTER )
+      #endif
+      {
+         double * cost = new double[ gTableSize() ];
+         double * load = new double[ num_procs ];
+         double cost_master;
+         costs( denBK, cost, &cost_master );
+
+         for ( int proc = 0; proc < num_procs; proc++ ){ load[ proc ] = 0.0; }
+         load[ 0 ] = cost_master; // MPI_CHEMPS2_MASTER = 0 owns the X-tensors
+         longest_first( cost, load, 0, 2 * num_pairs + L );
+
+         for ( int proc = 0; proc < num_procs; proc++ ){ load[ proc ] = 0.0; }
+         longest_first( cost, load, 2 * num_pairs + L, gTableSize() );
+
+         delete [] cost;
+         delete [] load;
+      }
+      #ifdef CHEMPS2_MPI_COMPILATION
+      MPIchemps2::broadcast_array_int( table, gTableSize(), MPI_CHEMPS2_MASTER );
+      #endif
+   }
+   changed( denBK ); // Remember the virtual dimensions
+
+}
+
+double CheMPS2::MPIbalance::imbalance( const SyBookkeeper * denBK ) const{
+
+   if ( num_procs == 1 ){ return 1.0; }
+
+   double * cost = new double[ gTableSize() ];
+   double * load = new double[ num_procs ];
+   double cost_master;
+   costs( denBK, cost, &cost_master );
+
+   for ( int proc = 0; proc < num_procs; proc++ ){ load[ proc ] = 0.0; }
+   load[ 0 ] = cost_master; // MPI_CHEMPS2_MASTER = 0 owns the X-tensors
+   double total   = cost_master;
+   double maximum = 0.0;
+   for ( int item = 0; item < 2 * num_pairs + L; item++ ){
+      load[ table[ item ] ] += cost[ item ];
+      total += cost[ item ];
+   }
+   for ( int proc = 0; proc < num_procs; proc++ ){ maximum = std::max( maximum, load[ proc ] ); }
+
+   delete [] cost;
+   delete [] load;
+   return (( total > 0.0 ) ? ( maximum * num_procs ) / total : 1.0 );
+
+}
+
+bool CheMPS2::MPIbalance::changed( const SyBookkeeper * denBK ){
+
+   bool differ = false;
+   for ( int bound = 0; bound <= L; bound++ ){
+      const int dim = denBK->gTotDimAtBound( bound );
+      if ( dim != bond_dims[ bound ] ){ differ = true; }
+      bond_dims[ bound ] = dim;
+   }
+   return differ;
+
+}
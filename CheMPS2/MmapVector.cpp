@@ -0,0 +1,87 @@
+/*
+   CheMPS2: a spin-adapted implementation of DMRG for ab initio quantum chemistry
+   Copyright (C) 2013-2016 Sebastian Wouters
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include <assert.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "MmapVector.h"
+
+double * CheMPS2::MmapVector::allocate( const long long size, const std::string tmp_folder ){
+
+   assert( size >= 0 );
+   if ( tmp_folder.length() == 0 ){ return new double[ size ]; }
+
+   const long long num_bytes = (( size > 0 ) ? size : 1 ) * sizeof(double);
+   const std::string name = tmp_folder + "/CheMPS2_vector_XXXXXX";
+   char * filename = new char[ name.length() + 1 ];
+   name.copy( filename, name.length() );
+   filename[ name.length() ] = '\0';
+   const int fd = mkstemp( filename );
+   if ( fd < 0 ){ fail( "Could not create the scratch file", filename, errno ); }
+   unlink( filename ); // The file is removed when the mapping is released
+
+   // Reserve the disk space now: a sparse file would give SIGBUS when a page cannot be written back
+   const int info = posix_fallocate( fd, 0, num_bytes );
+   if ( info != 0 ){ fail( "Could not allocate disk space for the scratch file", filename, info ); }
+   void * region = mmap( NULL, num_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+   if ( region == MAP_FAILED ){ fail( "Could not map the scratch file", filename, errno ); }
+   close( fd ); // The mapping keeps the file open
+   delete [] filename;
+   return static_cast<double *>( region );
+
+}
+
+void CheMPS2::MmapVector::release( double * vector, const long long size, const std::string tmp_folder ){
+
+   if ( tmp_folder.length() == 0 ){
+      delete [] vector;
+   } else {
+      const long long num_bytes = (( size > 0 ) ? size : 1 ) * sizeof(double);
+      munmap( vector, num_bytes );
+   }
+
+}
+
+void CheMPS2::MmapVector::prefetch( const double * start, const long long size ){
+
+   if ( size <= 0 ){ return; }
+   const uintptr_t page_size = sysconf( _SC_PAGESIZE );
+   const uintptr_t first = reinterpret_cast<uintptr_t>( start );
+   const uintptr_t begin = first - ( first % page_size );
+   const uintptr_t end   = first + size * sizeof(double);
+   madvise( reinterpret_cast<void *>( begin ), end - begin, MADV_WILLNEED );
+
+}
+
+void CheMPS2::MmapVector::fail( const std::string message, const std::string filename, const int error ){
+
+   std::cerr << "CheMPS2::MmapVector : " << message << " " << filename;
+   if ( error != 0 ){ std::cerr << " : " << strerror( error ); }
+   std::cerr << std::endl;
+   exit( EXIT_FAILURE );
+
+}
+
@@ -0,0 +1,406 @@
+/*
+   CheMPS2: a spin-adapted implementation of DMRG for ab initio quantum chemistry
+   Copyright (C) 2013-2016 Sebastian Wouters
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include <math.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <iostream>
+
+#include "MultiShiftSolver.h"
+#include "MmapVector.h"
+#include "Special.h"
+#include "Lapack.h"
+
+using std::cout;
+using std::endl;
+
+CheMPS2::MultiShiftSolver::MultiShiftSolver( const long long veclength_in, const int num_shifts_in, const double * shift1_in, const double * shift2_in, const int MAX_NUM_VEC_in, const double RTOL_in, const double DIAG_CUTOFF_in, const bool print_in, const std::string scratch_in ){
+
+   assert( num_shifts_in >= 1 );
+   assert( MAX_NUM_VEC_in > num_shifts_in );
+
+   veclength   = veclength_in;
+   num_shifts  = num_shifts_in;
+   MAX_NUM_VEC = MAX_NUM_VEC_in;
+   RTOL        = RTOL_in;
+   DIAG_CUTOFF = DIAG_CUTOFF_in;
+   print       = print_in;
+   scratch     = scratch_in;
+
+   state = 'I';
+   num_matvec = 0;
+
+   shift1 = new double[ num_shifts ];
+   shift2 = new double[ num_shifts ];
+   for ( int shift = 0; shift < num_shifts; shift++ ){
+      shift1[ shift ] = shift1_in[ shift ];
+      shift2[ shift ] = shift2_in[ shift ];
+   }
+
+   DIAG  = MmapVector::allocate( veclength, scratch );
+   RHS   = MmapVector::allocate( veclength, scratch );
+   DIAG1 = MmapVector::allocate( veclength, scratch );
+   DIAG2 = MmapVector::allocate( veclength, scratch );
+   u_vec = MmapVector::allocate( veclength, scratch );
+   r_vec = MmapVector::allocate( veclength, scratch );
+   t_vec = MmapVector::allocate( veclength, scratch );
+
+   num_vec       = 0;
+   num_allocated = 0;
+   vecs    = new double*[ MAX_NUM_VEC ];
+   op_vecs = new double*[ MAX_NUM_VEC ];
+
+   proj_op    = new double[ MAX_NUM_VEC * MAX_NUM_VEC ];
+   proj_diag1 = new double[ MAX_NUM_VEC * MAX_NUM_VEC ];
+   proj_diag2 = new double[ MAX_NUM_VEC * MAX_NUM_VEC ];
+   proj_rhs   = new double[ MAX_NUM_VEC ];
+   proj_sol   = new double[ MAX_NUM_VEC * num_shifts ];
+   rnorms     = new double[ num_shifts ];
+   for ( int shift = 0; shift < num_shifts; shift++ ){ rnorms[ shift ] = 0.0; }
+
+   mx_matrix = new double[ MAX_NUM_VEC * MAX_NUM_VEC ];
+   mx_eigs   = new double[ MAX_NUM_VEC ];
+   mx_lwork  = 3 * MAX_NUM_VEC - 1;
+   mx_work   = new double[ mx_lwork ];
+
+}
+
+CheMPS2::MultiShiftSolver::~MultiShiftSolver(){
+
+   delete [] shift1;
+   delete [] shift2;
+
+   MmapVector::release( DIAG,  veclength, scratch );
+   MmapVector::release( RHS,   veclength, scratch );
+   MmapVector::release( DIAG1, veclength, scratch );
+   MmapVector::release( DIAG2, veclength, scratch );
+   MmapVector::release( u_vec, veclength, scratch );
+   MmapVector::release( r_vec, veclength, scratch );
+   MmapVector::release( t_vec, veclength, scratch );
+
+   for ( int cnt = 0; cnt < num_allocated; cnt++ ){
+      MmapVector::release( vecs[ cnt ],    veclength, scratch );
+      MmapVector::release( op_vecs[ cnt ], veclength, scratch );
+   }
+   delete [] vecs;
+   delete [] op_vecs;
+
+   delete [] proj_op;
+   delete [] proj_diag1;
+   delete [] proj_diag2;
+   delete [] proj_rhs;
+   delete [] proj_sol;
+   delete [] rnorms;
+
+   delete [] mx_matrix;
+   delete [] mx_eigs;
+   delete [] mx_work;
+
+}
+
+int CheMPS2::MultiShiftSolver::get_num_matvec() const{ return num_matvec; }
+
+double CheMPS2::MultiShiftSolver::get_residual_norm( const int shift ) const{ return rnorms[ shift ]; }
+
+void CheMPS2::MultiShiftSolver::get_solution( const int shift, double * solution, double * op_solution ) const{
+
+   assert( state == 'Z' );
+   combine( vecs,    proj_sol + MAX_NUM_VEC * shift, solution    );
+   combine( op_vecs, proj_sol + MAX_NUM_VEC * shift, op_solution );
+
+}
+
+char CheMPS2::MultiShiftSolver::step( double ** pointers ){
+
+   /*
+      Possible states:
+       - I : just created the class
+       - G : the diagonals have been set in DIAG, DIAG1, and DIAG2, and the right-hand side in RHS
+       - N : a new subspace vector has been added, and op_vecs contains the operator times this vector
+       - Z : the converged signal has been given to the user, nothing remains to be done
+
+      Possible instructions:
+       - A : copy the diagonal of the operator to pointers[0], the right-hand side to pointers[1], diag1 to pointers[2], and diag2 to pointers[3]
+       - B : perform pointers[1] = operator * pointers[0]
+       - C : the solutions can be obtained with get_solution()
+       - D : there was an error
+   */
+
+   if ( state == 'I' ){
+      pointers[ 0 ] = DIAG;
+      pointers[ 1 ] = RHS;
+      pointers[ 2 ] = DIAG1;
+      pointers[ 3 ] = DIAG2;
+      state = 'G';
+      return 'A';
+   }
+
+   if ( state == 'G' ){
+      // The first subspace vector is the preconditioned right-hand side of the first shift
+      for ( long long elem = 0; elem < veclength; elem++ ){ t_vec[ elem ] = RHS[ elem ] / shifted_diagonal( 0, elem ); }
+      if ( add_vector() == false ){ // RHS = 0 --> all solutions are 0
+         state = 'Z';
+         return 'C';
+      }
+      pointers[ 0 ] = vecs[ num_vec ];
+      pointers[ 1 ] = op_vecs[ num_vec ];
+      state = 'N';
+      num_matvec++;
+      return 'B';
+   }
+
+   if ( state == 'N' ){
+      extend_projection();
+      solve_projected();
+
+      // Residuals of all shifts; t_vec becomes the preconditioned residual of the shift with the largest residual
+      double worst_norm  = -1.0;
+      int    worst_shift = -1;
+      for ( int shift = 0; shift < num_shifts; shift++ ){
+         combine( vecs,    proj_sol + MAX_NUM_VEC * shift, u_vec );
+         combine( op_vecs, proj_sol + MAX_NUM_VEC * shift, r_vec );
+         double rdotr = 0.0;
+         double precon_rdotr = 0.0;
+         for ( long long elem = 0; elem < veclength; elem++ ){
+            const double resid = r_vec[ elem ] + ( shift1[ shift ] * DIAG1[ elem ] + shift2[ shift ] * DIAG2[ elem ] ) * u_vec[ elem ] - RHS[ elem ];
+            r_vec[ elem ] = resid;
+            rdotr        += resid * resid;
+            precon_rdotr += resid * resid / shifted_diagonal( shift, elem );
+         }
+         rnorms[ shift ] = sqrt( rdotr );
+         const double precon_rnorm = sqrt( precon_rdotr );
+         if ( precon_rnorm > worst_norm ){
+            worst_norm  = precon_rnorm;
+            worst_shift = shift;
+            for ( long long elem = 0; elem < veclength; elem++ ){ t_vec[ elem ] = r_vec[ elem ] / shifted_diagonal( shift, elem ); }
+         }
+      }
+      if ( print ){ cout << "MultiShiftSolver : After " << num_matvec << " matrix-vector products, the largest preconditioned residual is " << worst_norm << " for shift " << worst_shift << endl; }
+
+      if ( worst_norm < RTOL ){
+         state = 'Z';
+         return 'C';
+      }
+      if ( num_vec == MAX_NUM_VEC ){ collapse(); }
+      if ( add_vector() == false ){
+         cout << "MultiShiftSolver : The subspace cannot be extended; the largest preconditioned residual is " << worst_norm << endl;
+         state = 'Z';
+         return 'C';
+      }
+      pointers[ 0 ] = vecs[ num_vec ];
+      pointers[ 1 ] = op_vecs[ num_vec ];
+      num_matvec++;
+      return 'B';
+   }
+
+   return 'D';
+
+}
+
+double CheMPS2::MultiShiftSolver::shifted_diagonal( const int shift, const long long elem ) const{
+
+   const double value = DIAG[ elem ] + shift1[ shift ] * DIAG1[ elem ] + shift2[ shift ] * DIAG2[ elem ];
+   return (( value < DIAG_CUTOFF ) ? DIAG_CUTOFF : value );
+
+}
+
+bool CheMPS2::MultiShiftSolver::add_vector(){
+
+   assert( num_vec < MAX_NUM_VEC );
+
+   // Classical Gram-Schmidt, twice
+   const double norm_before = sqrt( Special::ddot64( veclength, t_vec, t_vec ) );
+   if ( norm_before == 0.0 ){ return false; }
+   for ( int repeat = 0; repeat < 2; repeat++ ){
+      for ( int vec = 0; vec < num_vec; vec++ ){
+         const double overlap = Special::ddot64( veclength, vecs[ vec ], t_vec );
+         Special::daxpy64( veclength, -overlap, vecs[ vec ], t_vec );
+      }
+   }
+   const double norm_after = sqrt( Special::ddot64( veclength, t_vec, t_vec ) );
+   if ( norm_after < 1e-12 * norm_before ){ return false; }
+
+   if ( num_vec == num_allocated ){
+      vecs[ num_allocated ]    = MmapVector::allocate( veclength, scratch );
+      op_vecs[ num_allocated ] = MmapVector::allocate( veclength, scratch );
+      num_allocated++;
+   }
+   Special::dcopy64( veclength, t_vec, vecs[ num_vec ] );
+   Special::dscal64( veclength, 1.0 / norm_after, vecs[ num_vec ] );
+   return true;
+
+}
+
+void CheMPS2::MultiShiftSolver::extend_projection(){
+
+   const int last = num_vec;
+   for ( int vec = 0; vec <= last; vec++ ){
+      const double value = Special::ddot64( veclength, vecs[ vec ], op_vecs[ last ] );
+      proj_op[ vec + MAX_NUM_VEC * last ] = value;
+      proj_op[ last + MAX_NUM_VEC * vec ] = value;
+   }
+   for ( long long elem = 0; elem < veclength; elem++ ){ u_vec[ elem ] = DIAG1[ elem ] * vecs[ last ][ elem ]; }
+   for ( int vec = 0; vec <= last; vec++ ){
+      const double value = Special::ddot64( veclength, vecs[ vec ], u_vec );
+      proj_diag1[ vec + MAX_NUM_VEC * last ] = value;
+      proj_diag1[ last + MAX_NUM_VEC * vec ] = value;
+   }
+   for ( long long elem = 0; elem < veclength; elem++ ){ u_vec[ elem ] = DIAG2[ elem ] * vecs[ last ][ elem ]; }
+   for ( int vec = 0; vec <= last; vec++ ){
+      const double value = Special::ddot64( veclength, vecs[ vec ], u_vec );
+      proj_diag2[ vec + MAX_NUM_VEC * last ] = value;
+      proj_diag2[ last + MAX_NUM_VEC * vec ] = value;
+   }
+   proj_rhs[ last ] = Special::ddot64( veclength, vecs[ last ], RHS );
+   num_vec++;
+
+}
+
+void CheMPS2::MultiShiftSolver::solve_projected(){
+
+   for ( int shift = 0; shift < num_shifts; shift++ ){
+
+      // mx_matrix = proj_op + shift1 * proj_diag1 + shift2 * proj_diag2 = U * eigs * U^T
+      for ( int col = 0; col < num_vec; col++ ){
+         for ( int row = 0; row < num_vec; row++ ){
+            const int ptr = row + MAX_NUM_VEC * col;
+            mx_matrix[ ptr ] = proj_op[ ptr ] + shift1[ shift ] * proj_diag1[ ptr ] + shift2[ shift ] * proj_diag2[ ptr ];
+         }
+      }
+      char jobz = 'V';
+      char uplo = 'U';
+      int info;
+      dsyev_( &jobz, &uplo, &num_vec, mx_matrix, &MAX_NUM_VEC, mx_eigs, mx_work, &mx_lwork, &info );
+
+      // proj_sol = U * eigs^{-1} * U^T * proj_rhs
+      double * solution = proj_sol + MAX_NUM_VEC * shift;
+      for ( int vec = 0; vec < num_vec; vec++ ){
+         double value = 0.0;
+         for ( int row = 0; row < num_vec; row++ ){ value += mx_matrix[ row + MAX_NUM_VEC * vec ] * proj_rhs[ row ]; }
+         double eigenvalue = mx_eigs[ vec ];
+         if ( fabs( eigenvalue ) < DIAG_CUTOFF ){
+            eigenvalue = DIAG_CUTOFF * (( eigenvalue < 0.0 ) ? -1 : 1 );
+            if ( print ){ cout << "WARNING AT MultiShiftSolver : The eigenvalue " << mx_eigs[ vec ] << " of shift " << shift << " has been overwritten with " << eigenvalue << "." << endl; }
+         }
+         mx_work[ vec ] = value / eigenvalue;
+      }
+      for ( int row = 0; row < num_vec; row++ ){
+         double value = 0.0;
+         for ( int vec = 0; vec < num_vec; vec++ ){ value += mx_matrix[ row + MAX_NUM_VEC * vec ] * mx_work[ vec ]; }
+         solution[ row ] = value;
+      }
+   }
+
+}
+
+void CheMPS2::MultiShiftSolver::collapse(){
+
+   // Orthonormalize the projected solutions of all shifts with modified Gram-Schmidt
+   double * coeff = new double[ MAX_NUM_VEC * num_shifts ];
+   int num_keep = 0;
+   for ( int shift = 0; shift < num_shifts; shift++ ){
+      double * target = coeff + MAX_NUM_VEC * num_keep;
+      for ( int row = 0; row < num_vec; row++ ){ target[ row ] = proj_sol[ row + MAX_NUM_VEC * shift ]; }
+      double norm_before = 0.0;
+      for ( int row = 0; row < num_vec; row++ ){ norm_before += target[ row ] * target[ row ]; }
+      for ( int prev = 0; prev < num_keep; prev++ ){
+         double overlap = 0.0;
+         for ( int row = 0; row < num_vec; row++ ){ overlap += coeff[ row + MAX_NUM_VEC * prev ] * target[ row ]; }
+         for ( int row = 0; row < num_vec; row++ ){ target[ row ] -= overlap * coeff[ row + MAX_NUM_VEC * prev ]; }
+      }
+      double norm_after = 0.0;
+      for ( int row = 0; row < num_vec; row++ ){ norm_after += target[ row ] * target[ row ]; }
+      if ( norm_after > 1e-20 * norm_before ){
+         for ( int row = 0; row < num_vec; row++ ){ target[ row ] = target[ row ] / sqrt( norm_after ); }
+         num_keep++;
+      }
+   }
+   assert( num_keep >= 1 );
+
+   // vecs <-- vecs * coeff and op_vecs <-- op_vecs * coeff, row by row in place
+   #pragma omp parallel
+   {
+      double * row_old = new double[ 2 * num_vec ];
+      #pragma omp for schedule(static)
+      for ( long long elem = 0; elem < veclength; elem++ ){
+         for ( int vec = 0; vec < num_vec; vec++ ){
+            row_old[ vec           ] = vecs[ vec ][ elem ];
+            row_old[ vec + num_vec ] = op_vecs[ vec ][ elem ];
+         }
+         for ( int keep = 0; keep < num_keep; keep++ ){
+            double value1 = 0.0;
+            double value2 = 0.0;
+            for ( int vec = 0; vec < num_vec; vec++ ){
+               value1 += row_old[ vec           ] * coeff[ vec + MAX_NUM_VEC * keep ];
+               value2 += row_old[ vec + num_vec ] * coeff[ vec + MAX_NUM_VEC * keep ];
+            }
+            vecs[ keep ][ elem ]    = value1;
+            op_vecs[ keep ][ elem ] = value2;
+         }
+      }
+      delete [] row_old;
+   }
+
+   // The projections in the collapsed subspace: coeff^T * proj * coeff
+   transform_projection( proj_op,    coeff, num_keep );
+   transform_projection( proj_diag1, coeff, num_keep );
+   transform_projection( proj_diag2, coeff, num_keep );
+   for ( int keep = 0; keep < num_keep; keep++ ){
+      double value = 0.0;
+      for ( int vec = 0; vec < num_vec; vec++ ){ value += coeff[ vec + MAX_NUM_VEC * keep ] * proj_rhs[ vec ]; }
+      mx_work[ keep ] = value;
+   }
+   for ( int keep = 0; keep < num_keep; keep++ ){ proj_rhs[ keep ] = mx_work[ keep ]; }
+
+   if ( print ){ cout << "MultiShiftSolver : Collapsed the subspace from " << num_vec << " to " << num_keep << " vectors" << endl; }
+   num_vec = num_keep;
+   delete [] coeff;
+
+}
+
+void CheMPS2::MultiShiftSolver::combine( double ** basis, const double * coeff, double * result ) const{
+
+   for ( long long elem = 0; elem < veclength; elem++ ){ result[ elem ] = 0.0; }
+   for ( int vec = 0; vec < num_vec; vec++ ){
+      Special::daxpy64( veclength, coeff[ vec ], basis[ vec ], result );
+   }
+
+}
+
+void CheMPS2::MultiShiftSolver::transform_projection( double * matrix, const double * coeff, const int num_keep ) const{
+
+   // mx_matrix = matrix * coeff
+   for ( int keep = 0; keep < num_keep; keep++ ){
+      for ( int row = 0; row < num_vec; row++ ){
+         double value = 0.0;
+         for ( int vec = 0; vec < num_vec; vec++ ){ value += matrix[ row + MAX_NUM_VEC * vec ] * coeff[ vec + MAX_NUM_VEC * keep ]; }
+         mx_matrix[ row + MAX_NUM_VEC * keep ] = value;
+      }
+   }
+
+   // matrix = coeff^T * mx_matrix
+   for ( int col = 0; col < num_keep; col++ ){
+      for ( int row = 0; row < num_keep; row++ ){
+         double value = 0.0;
+         for ( int vec = 0; vec < num_vec; vec++ ){ value += coeff[ vec + MAX_NUM_VEC * row ] * mx_matrix[ vec + MAX_NUM_VEC * col ]; }
+         matrix[ row + MAX_NUM_VEC * col ] = value;
+      }
+   }
+
+}
@@ -0,0 +1,155 @@
+/*
+   CheMPS2: a spin-adapted implementation of DMRG for ab initio quantum chemistry
+   Copyright (C) 2013-2016 Sebastian Wouters
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include <assert.h>
+#include <sys/stat.h>
+
+#include "OperatorStorageHDF5.h"
+#include "Options.h"
+
+CheMPS2::OperatorStorageHDF5::OperatorStorageHDF5( const int deflate_level_in, const int lossy_digits_in ){
+
+   assert(( deflate_level_in >= 0 ) && ( deflate_level_in <= 9 ));
+   assert( lossy_digits_in >= 0 );
+   file_id = -1;
+   storing = false;
+   deflate_level = deflate_level_in;
+   lossy_digits  = lossy_digits_in;
+
+}
+
+CheMPS2::OperatorStorageHDF5::~OperatorStorageHDF5(){
+
+   if ( file_id >= 0 ){ close(); }
+
+}
+
+std::string CheMPS2::OperatorStorageHDF5::extension() const{
+
+   return ".h5";
+
+}
+
+void CheMPS2::OperatorStorageHDF5::open( const std::string filename, const bool store ){
+
+   assert( file_id < 0 );
+   name    = filename + extension();
+   storing = store;
+   file_id = ( store ) ? H5Fcreate( name.c_str(), H5F_ACC_TRUNC,  H5P_DEFAULT, H5P_DEFAULT )
+                       : H5Fopen(   name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT );
+   assert( file_id >= 0 );
+
+}
+
+long long CheMPS2::OperatorStorageHDF5::close(){
+
+   H5Fclose( file_id );
+   file_id = -1;
+
+   long long num_bytes = 0;
+   if ( storing ){
+      struct stat file_info;
+      if ( stat( name.c_str(), &file_info ) == 0 ){ num_bytes = file_info.st_size; }
+   }
+   return num_bytes;
+
+}
+
+void CheMPS2::OperatorStorageHDF5::write_batch( const int number, Tensor ** batch, const long long totalsize, const std::string tag, const bool lossy ){
+
+   /* Optional compression: chunks of byte-shuffled doubles are deflated by the HDF5 filter pipeline, which runs
+      in the background I/O thread. When lossy is true, the doubles can first be rounded to a fixed number of
+      decimal digits (error bound 0.5e-digits) with the scale-offset filter. The filters are undone by H5Dread.  */
+   const hid_t create_id = H5Pcreate(H5P_DATASET_CREATE);
+   const hid_t access_id = H5Pcreate(H5P_DATASET_ACCESS);
+   if (( deflate_level > 0 ) && ( H5Zfilter_avail(H5Z_FILTER_DEFLATE) > 0 ) && ( H5Zfilter_avail(H5Z_FILTER_SHUFFLE) > 0 )){
+      const hsize_t chunk = ( totalsize < CheMPS2::DMRG_OPERATOR_chunk_size ) ? totalsize : CheMPS2::DMRG_OPERATOR_chunk_size;
+      H5Pset_chunk(create_id, 1, &chunk);
+      if (( lossy ) && ( lossy_digits > 0 ) && ( H5Zfilter_avail(H5Z_FILTER_SCALEOFFSET) > 0 )){
+         H5Pset_scaleoffset(create_id, H5Z_SO_FLOAT_DSCALE, lossy_digits);
+      }
+      H5Pset_shuffle(create_id);
+      H5Pset_deflate(create_id, deflate_level);
+      H5Pset_chunk_cache(access_id, 521, 4 * chunk * sizeof(double), 1.0); // The tensors are written sequentially: each chunk is compressed once
+   }
+
+   const hid_t   group_id     = H5Gcreate(file_id, tag.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+   const hsize_t dimarray     = totalsize;
+   const hid_t   dataspace_id = H5Screate_simple(1, &dimarray, NULL);
+   const hid_t   dataset_id   = H5Dcreate(group_id, "storage", H5T_NATIVE_DOUBLE, dataspace_id, H5P_DEFAULT, create_id, access_id);
+                                /* Switch from H5T_IEEE_F64LE to H5T_NATIVE_DOUBLE to avoid processing of the doubles
+                                   --> only MPS checkpoint is reused in between calculations anyway                   */
+   
+   long long offset = 0;
+   for (int cnt=0; cnt<number; cnt++){
+      const long long tensor_size = batch[cnt]->gKappa2index(batch[cnt]->gNKappa());
+      if ( tensor_size > 0 ){
+      
+         const hsize_t start = offset;
+         const hsize_t count = tensor_size;
+         H5Sselect_hyperslab(dataspace_id, H5S_SELECT_SET, &start, NULL, &count, NULL);
+         const hid_t memspace_id = H5Screate_simple(1, &count, NULL);
+         H5Dwrite(dataset_id, H5T_NATIVE_DOUBLE, memspace_id, dataspace_id, H5P_DEFAULT, batch[cnt]->gStorage());
+         H5Sclose(memspace_id);
+         
+         offset += tensor_size;
+      }
+   }
+   
+   H5Dclose(dataset_id);
+   H5Sclose(dataspace_id);
+   H5Gclose(group_id);
+   H5Pclose(access_id);
+   H5Pclose(create_id);
+   
+   assert( totalsize == offset );
+
+}
+
+void CheMPS2::OperatorStorageHDF5::read_batch( const int number, Tensor ** batch, const long long totalsize, const std::string tag ){
+
+   const hid_t   group_id     = H5Gopen(file_id, tag.c_str(), H5P_DEFAULT);
+   const hsize_t dimarray     = totalsize;
+   const hid_t   dataspace_id = H5Screate_simple(1, &dimarray, NULL);
+   const hid_t   dataset_id   = H5Dopen(group_id, "storage", H5P_DEFAULT);
+   
+   long long offset = 0;
+   for (int cnt=0; cnt<number; cnt++){
+      const long long tensor_size = batch[cnt]->gKappa2index(batch[cnt]->gNKappa());
+      if ( tensor_size > 0 ){
+      
+         const hsize_t start = offset;
+         const hsize_t count = tensor_size;
+         H5Sselect_hyperslab(dataspace_id, H5S_SELECT_SET, &start, NULL, &count, NULL);
+         const hid_t memspace_id = H5Screate_simple(1, &count, NULL);
+         H5Dread(dataset_id, H5T_NATIVE_DOUBLE, memspace_id, dataspace_id, H5P_DEFAULT, batch[cnt]->gStorage());
+         H5Sclose(memspace_id);
+
+         offset += tensor_size;
+      }
+   }
+   
+   H5Dclose(dataset_id);
+   H5Sclose(dataspace_id);
+   H5Gclose(group_id);
+   
+   assert( totalsize == offset );
+
+}
+
@@ -0,0 +1,159 @@
+/*
+   CheMPS2: a spin-adapted implementation of DMRG for ab initio quantum chemistry
+   Copyright (C) 2013-2016 Sebastian Wouters
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "OperatorStorageMmap.h"
+
+#define CHEMPS2_MMAP_HEADER  64 // Bytes: tag ( up to 55 characters ) and number of doubles
+#define CHEMPS2_MMAP_TAGSIZE 56
+
+CheMPS2::OperatorStorageMmap::OperatorStorageMmap(){
+
+   fd        = -1;
+   storing   = false;
+   offset    = 0;
+   page_size = sysconf( _SC_PAGESIZE );
+
+}
+
+CheMPS2::OperatorStorageMmap::~OperatorStorageMmap(){
+
+   if ( fd >= 0 ){ close(); }
+
+}
+
+std::string CheMPS2::OperatorStorageMmap::extension() const{
+
+   return ".bin";
+
+}
+
+void CheMPS2::OperatorStorageMmap::open( const std::string filename, const bool store ){
+
+   assert( fd < 0 );
+   name    = filename + extension();
+   storing = store;
+   offset  = 0;
+   fd = ( store ) ? ::open( name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600 )
+                  : ::open( name.c_str(), O_RDONLY );
+   if ( fd < 0 ){ fail( "Could not open the file", errno ); }
+
+}
+
+long long CheMPS2::OperatorStorageMmap::close(){
+
+   long long num_bytes = 0;
+   if ( storing ){
+      struct stat file_info;
+      if ( fstat( fd, &file_info ) == 0 ){ num_bytes = file_info.st_size; }
+   }
+   ::close( fd ); // The dirty pages are written back by the kernel
+   fd = -1;
+   return num_bytes;
+
+}
+
+char * CheMPS2::OperatorStorageMmap::map_batch( const long long num_bytes, const bool writable ){
+
+   if ( writable ){
+      // Reserve the blocks on disk: a full disk is reported here instead of as SIGBUS when the mapping is written
+      const int info = posix_fallocate( fd, offset, num_bytes );
+      if ( info != 0 ){ fail( "Could not allocate disk space for the file", info ); }
+   } else {
+      // A truncated file would give SIGBUS when the mapping is read
+      struct stat file_info;
+      if ( fstat( fd, &file_info ) != 0 ){ fail( "Could not stat the file", errno ); }
+      if ( file_info.st_size < offset + num_bytes ){ fail( "The file is truncated", 0 ); }
+   }
+   void * region = mmap( NULL, num_bytes, (( writable ) ? ( PROT_READ | PROT_WRITE ) : PROT_READ ), MAP_SHARED, fd, offset );
+   if ( region == MAP_FAILED ){ fail( "Could not map the file", errno ); }
+   if ( writable == false ){ madvise( region, num_bytes, MADV_SEQUENTIAL ); }
+   return static_cast<char *>( region );
+
+}
+
+void CheMPS2::OperatorStorageMmap::write_batch( const int number, Tensor ** batch, const long long totalsize, const std::string tag, const bool lossy ){
+
+   assert( storing );
+   assert( tag.length() < CHEMPS2_MMAP_TAGSIZE );
+   const long long num_bytes = CHEMPS2_MMAP_HEADER + totalsize * sizeof(double);
+   char * region = map_batch( num_bytes, true );
+
+   memset( region, 0, CHEMPS2_MMAP_HEADER );
+   memcpy( region, tag.c_str(), tag.length() );
+   memcpy( region + CHEMPS2_MMAP_TAGSIZE, &totalsize, sizeof(long long) );
+
+   double * data = reinterpret_cast<double *>( region + CHEMPS2_MMAP_HEADER );
+   long long jump = 0;
+   for ( int cnt = 0; cnt < number; cnt++ ){
+      const long long tensor_size = batch[cnt]->gKappa2index( batch[ cnt ]->gNKappa() );
+      memcpy( data + jump, batch[ cnt ]->gStorage(), tensor_size * sizeof(double) );
+      jump += tensor_size;
+   }
+   assert( totalsize == jump );
+
+   munmap( region, num_bytes );
+   offset += (( num_bytes + page_size - 1 ) / page_size ) * page_size;
+
+}
+
+void CheMPS2::OperatorStorageMmap::read_batch( const int number, Tensor ** batch, const long long totalsize, const std::string tag ){
+
+   assert( storing == false );
+   const long long num_bytes = CHEMPS2_MMAP_HEADER + totalsize * sizeof(double);
+   char * region = map_batch( num_bytes, false );
+
+   long long stored_size = 0;
+   memcpy( &stored_size, region + CHEMPS2_MMAP_TAGSIZE, sizeof(long long) );
+   if (( strncmp( region, tag.c_str(), CHEMPS2_MMAP_TAGSIZE ) != 0 ) || ( stored_size != totalsize )){
+      fail( "The header does not match the batch " + tag + " in the file", 0 );
+   }
+
+   const double * data = reinterpret_cast<const double *>( region + CHEMPS2_MMAP_HEADER );
+   long long jump = 0;
+   for ( int cnt = 0; cnt < number; cnt++ ){
+      const long long tensor_size = batch[cnt]->gKappa2index( batch[ cnt ]->gNKappa() );
+      memcpy( batch[ cnt ]->gStorage(), data + jump, tensor_size * sizeof(double) );
+      jump += tensor_size;
+   }
+   assert( totalsize == jump );
+
+   munmap( region, num_bytes );
+   offset += (( num_bytes + page_size - 1 ) / page_size ) * page_size;
+
+}
+
+void CheMPS2::OperatorStorageMmap::fail( const std::string message, const int error ) const{
+
+   std::cerr << "CheMPS2::OperatorStorageMmap : " << message << " " << name;
+   if ( error != 0 ){ std::cerr << " : " << strerror( error ); }
+   std::cerr << std::endl;
+   exit( EXIT_FAILURE );
+
+}
+
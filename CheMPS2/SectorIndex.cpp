@@ -0,0 +1,72 @@
+/*
+   CheMPS2: a spin-adapted implementation of DMRG for ab initio quantum chemistry
+   Copyright (C) 2013-2016 Sebastian Wouters
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include <stdlib.h>
+#include <assert.h>
+#include <algorithm>
+
+#include "SectorIndex.h"
+
+using std::min;
+using std::max;
+
+CheMPS2::SectorIndex::SectorIndex( const int num_sectors, const int * sector_n, const int * sector_two_s, const int * sector_irrep, const int num_irreps ){
+
+   this->num_irreps = num_irreps;
+
+   n_min = 0;
+   int n_max = -1;
+   int two_s_max = 0;
+   for ( int ikappa = 0; ikappa < num_sectors; ikappa++ ){
+      n_min     = (( ikappa == 0 ) ? sector_n[ ikappa ] : min( n_min, sector_n[ ikappa ] ));
+      n_max     = max( n_max, sector_n[ ikappa ] );
+      two_s_max = max( two_s_max, sector_two_s[ ikappa ] );
+   }
+   num_n = n_max - n_min + 1;
+   num_s = two_s_max / 2 + 1;
+
+   for ( int ikappa = 1; ikappa < num_sectors; ikappa++ ){
+      assert( gKey( sector_n[ ikappa - 1 ], sector_two_s[ ikappa - 1 ], sector_irrep[ ikappa - 1 ] ) <= gKey( sector_n[ ikappa ], sector_two_s[ ikappa ], sector_irrep[ ikappa ] ) );
+   }
+
+   const int num_keys = num_n * num_s * num_irreps;
+   first = new int[ num_keys + 1 ];
+
+   // The sectors are ordered by key; first[ key ] is the first sector with a key larger than or equal to key
+   int ikappa = 0;
+   for ( int key = 0; key <= num_keys; key++ ){
+      while (( ikappa < num_sectors ) && ( gKey( sector_n[ ikappa ], sector_two_s[ ikappa ], sector_irrep[ ikappa ] ) < key )){ ikappa++; }
+      first[ key ] = ikappa;
+   }
+   assert( first[ num_keys ] == num_sectors );
+
+}
+
+CheMPS2::SectorIndex::~SectorIndex(){
+
+   delete [] first;
+
+}
+
+int CheMPS2::SectorIndex::gKey( const int N, const int TwoS, const int I ) const{
+
+   if (( N < n_min ) || ( N >= n_min + num_n ) || ( TwoS < 0 ) || ( TwoS / 2 >= num_s ) || ( I < 0 ) || ( I >= num_irreps )){ return -1; }
+   return ( ( N - n_min ) * num_s + TwoS / 2 ) * num_irreps + I;
+
+}
@@ -0,0 +1,262 @@
+/*
+   CheMPS2: a spin-adapted implementation of DMRG for ab initio quantum chemistry
+   Copyright (C) 2013-2016 Sebastian Wouters
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include <stdlib.h>
+#include <assert.h>
+#include <algorithm>
+
+#include "SixIndex.h"
+#include "Irreps.h"
+#include "MPIchemps2.h"
+
+using std::min;
+using std::swap;
+
+CheMPS2::SixIndex::SixIndex( const int L_in, const int * irreps_in ){
+
+   L = L_in;
+   assert( L >= 1 );
+
+   int max_irrep = 0;
+   for ( int orb = 0; orb < L; orb++ ){ max_irrep = (( irreps_in[ orb ] > max_irrep ) ? irreps_in[ orb ] : max_irrep ); }
+   num_irreps = 1;
+   while ( num_irreps <= max_irrep ){ num_irreps *= 2; }
+
+   // Give the orbital pairs keys, ordered by their irrep
+   pair_key         = new int[ L * L ];
+   pair_creator     = new int[ L * L ];
+   pair_annihilator = new int[ L * L ];
+   pair_irrep       = new int[ L * L ];
+   pair_begin       = new int[ num_irreps + 1 ];
+   int key = 0;
+   for ( int irrep = 0; irrep < num_irreps; irrep++ ){
+      pair_begin[ irrep ] = key;
+      for ( int anni = 0; anni < L; anni++ ){
+         for ( int crea = 0; crea < L; crea++ ){
+            if ( Irreps::directProd( irreps_in[ crea ], irreps_in[ anni ] ) == irrep ){
+               pair_key[ crea + L * anni ] = key;
+               pair_creator[ key ]         = crea;
+               pair_annihilator[ key ]     = anni;
+               pair_irrep[ key ]           = irrep;
+               key++;
+            }
+         }
+      }
+   }
+   pair_begin[ num_irreps ] = key;
+   assert( key == L * L );
+
+   // The blocks of ordered pair irreps I1 <= I2 <= I3 = I1 x I2
+   block_start = new long long[ num_irreps * num_irreps ];
+   array_size  = 0;
+   for ( int irrep2 = 0; irrep2 < num_irreps; irrep2++ ){
+      for ( int irrep1 = 0; irrep1 < num_irreps; irrep1++ ){
+         const int irrep3 = Irreps::directProd( irrep1, irrep2 );
+         block_start[ irrep1 + num_irreps * irrep2 ] = -1;
+         if (( irrep1 <= irrep2 ) && ( irrep2 <= irrep3 )){
+            block_start[ irrep1 + num_irreps * irrep2 ] = array_size;
+            const long long num1 = pair_begin[ irrep1 + 1 ] - pair_begin[ irrep1 ];
+            const long long num2 = pair_begin[ irrep2 + 1 ] - pair_begin[ irrep2 ];
+            const long long num3 = pair_begin[ irrep3 + 1 ] - pair_begin[ irrep3 ];
+            if ( irrep1 == irrep2 ){ // I1 == I2 == I3 == 0
+               array_size += ( num1 * ( num1 + 1 ) * ( num1 + 2 ) ) / 6;
+            } else if ( irrep2 == irrep3 ){ // I1 == 0
+               array_size += num1 * (( num2 * ( num2 + 1 ) ) / 2 );
+            } else {
+               array_size += num1 * num2 * num3;
+            }
+         }
+      }
+   }
+
+   elements = new double[ array_size ];
+   clear();
+
+}
+
+CheMPS2::SixIndex::~SixIndex(){
+
+   delete [] pair_key;
+   delete [] pair_creator;
+   delete [] pair_annihilator;
+   delete [] pair_irrep;
+   delete [] pair_begin;
+   delete [] block_start;
+   delete [] elements;
+
+}
+
+void CheMPS2::SixIndex::clear(){
+
+   #pragma omp simd
+   for ( long long cnt = 0; cnt < array_size; cnt++ ){ elements[ cnt ] = 0.0; }
+
+}
+
+long long CheMPS2::SixIndex::get_pointer_keys( const int key1, const int key2, const int key3 ) const{
+
+   assert( key1 <= key2 );
+   assert( key2 <= key3 );
+
+   const int irrep1 = pair_irrep[ key1 ];
+   const int irrep2 = pair_irrep[ key2 ];
+   const int irrep3 = pair_irrep[ key3 ];
+   assert( Irreps::directProd( irrep1, irrep2 ) == irrep3 );
+
+   const long long rank1 = key1 - pair_begin[ irrep1 ];
+   const long long rank2 = key2 - pair_begin[ irrep2 ];
+   const long long rank3 = key3 - pair_begin[ irrep3 ];
+   const long long start = block_start[ irrep1 + num_irreps * irrep2 ];
+
+   if ( irrep1 == irrep2 ){ // I1 == I2 == I3 == 0
+      return start + rank1 + ( rank2 * ( rank2 + 1 ) ) / 2 + ( rank3 * ( rank3 + 1 ) * ( rank3 + 2 ) ) / 6;
+   }
+   const long long num1 = pair_begin[ irrep1 + 1 ] - pair_begin[ irrep1 ];
+   if ( irrep2 == irrep3 ){ // I1 == 0
+      return start + rank1 + num1 * ( rank2 + ( rank3 * ( rank3 + 1 ) ) / 2 );
+   }
+   const long long num2 = pair_begin[ irrep2 + 1 ] - pair_begin[ irrep2 ];
+   return start + rank1 + num1 * ( rank2 + num2 * rank3 );
+
+}
+
+long long CheMPS2::SixIndex::get_pointer( const int i, const int j, const int k, const int l, const int m, const int n ) const{
+
+   int key1 = pair_key[ i + L * l ];
+   int key2 = pair_key[ j + L * m ];
+   int key3 = pair_key[ k + L * n ];
+   if ( Irreps::directProd( pair_irrep[ key1 ], pair_irrep[ key2 ] ) != pair_irrep[ key3 ] ){ return -1; }
+
+   if ( key1 > key2 ){ swap( key1, key2 ); }
+   if ( key2 > key3 ){ swap( key2, key3 ); }
+   if ( key1 > key2 ){ swap( key1, key2 ); }
+   return get_pointer_keys( key1, key2, key3 );
+
+}
+
+double CheMPS2::SixIndex::get( const int i, const int j, const int k, const int l, const int m, const int n ) const{
+
+   const long long ptr = get_pointer( i, j, k, l, m, n );
+   return (( ptr == -1 ) ? 0.0 : elements[ ptr ] );
+
+}
+
+void CheMPS2::SixIndex::set( const int i, const int j, const int k, const int l, const int m, const int n, const double value ){
+
+   const long long ptr = get_pointer( i, j, k, l, m, n );
+   assert( ptr != -1 );
+   elements[ ptr ] = value;
+
+}
+
+void CheMPS2::SixIndex::add( const int i, const int j, const int k, const int l, const int m, const int n, const double value ){
+
+   const long long ptr = get_pointer( i, j, k, l, m, n );
+   assert( ptr != -1 );
+   elements[ ptr ] += value;
+
+}
+
+bool CheMPS2::SixIndex::canonical( const int i, const int j, const int k, const int l, const int m, const int n ) const{
+
+   const int key1 = pair_key[ i + L * l ];
+   const int key2 = pair_key[ j + L * m ];
+   const int key3 = pair_key[ k + L * n ];
+   return (( key1 <= key2 ) && ( key2 <= key3 ) && ( Irreps::directProd( pair_irrep[ key1 ], pair_irrep[ key2 ] ) == pair_irrep[ key3 ] ));
+
+}
+
+void CheMPS2::SixIndex::fill_dense_slice( double * slice, const int last_orb ) const{
+
+   assert(( last_orb >= 0 ) && ( last_orb < L ));
+
+   #pragma omp parallel for schedule(static)
+   for ( int m = 0; m < L; m++ ){
+      for ( int l = 0; l < L; l++ ){
+         for ( int k = 0; k < L; k++ ){
+            for ( int j = 0; j < L; j++ ){
+               double * target = slice + L * ( j + L * ( k + L * ( l + L * m )));
+               for ( int i = 0; i < L; i++ ){ target[ i ] = get( i, j, k, l, m, last_orb ); }
+            }
+         }
+      }
+   }
+
+}
+
+void CheMPS2::SixIndex::add_dense_slice( const double * slice, const int last_orb, const double alpha, double * packed ) const{
+
+   assert(( last_orb >= 0 ) && ( last_orb < L ));
+
+   const long long L1 = L;
+   #pragma omp parallel for schedule(dynamic)
+   for ( int k = 0; k < L; k++ ){
+      const int key3 = pair_key[ k + L * last_orb ];
+      for ( int key2 = 0; key2 <= key3; key2++ ){
+         const long long j = pair_creator[ key2 ];
+         const long long m = pair_annihilator[ key2 ];
+         const int irrep1 = Irreps::directProd( pair_irrep[ key2 ], pair_irrep[ key3 ] );
+         const int stop1  = min( key2 + 1, pair_begin[ irrep1 + 1 ] );
+         for ( int key1 = pair_begin[ irrep1 ]; key1 < stop1; key1++ ){
+            const long long i = pair_creator[ key1 ];
+            const long long l = pair_annihilator[ key1 ];
+            packed[ get_pointer_keys( key1, key2, key3 ) ] += alpha * slice[ i + L1 * ( j + L1 * ( k + L1 * ( l + L1 * m ))) ];
+         }
+      }
+   }
+
+}
+
+void CheMPS2::SixIndex::fill_dense( double * dense ) const{
+
+   const long long size5 = (( long long ) L ) * L * L * L * L;
+   for ( int last_orb = 0; last_orb < L; last_orb++ ){ fill_dense_slice( dense + size5 * last_orb, last_orb ); }
+
+}
+
+void CheMPS2::SixIndex::read_dense( const double * dense ){
+
+   const long long L1 = L;
+   #pragma omp parallel for schedule(dynamic)
+   for ( int key3 = 0; key3 < L * L; key3++ ){
+      const long long k = pair_creator[ key3 ];
+      const long long n = pair_annihilator[ key3 ];
+      for ( int key2 = 0; key2 <= key3; key2++ ){
+         const long long j = pair_creator[ key2 ];
+         const long long m = pair_annihilator[ key2 ];
+         const int irrep1 = Irreps::directProd( pair_irrep[ key2 ], pair_irrep[ key3 ] );
+         const int stop1  = min( key2 + 1, pair_begin[ irrep1 + 1 ] );
+         for ( int key1 = pair_begin[ irrep1 ]; key1 < stop1; key1++ ){
+            const long long i = pair_creator[ key1 ];
+            const long long l = pair_annihilator[ key1 ];
+            elements[ get_pointer_keys( key1, key2, key3 ) ] = dense[ i + L1 * ( j + L1 * ( k + L1 * ( l + L1 * ( m + L1 * n )))) ];
+         }
+      }
+   }
+
+}
+
+#ifdef CHEMPS2_MPI_COMPILATION
+void CheMPS2::SixIndex::broadcast( const int ROOT ){
+
+   MPIchemps2::broadcast_array_double( elements, array_size, ROOT );
+
+}
+#endif
+
@@ -21,6 +21,9 @@
 #include <stdlib.h>
 #include <algorithm>
 #include <assert.h>
+#ifdef _OPENMP
+   #include <omp.h>
+#endif
 
 #include "Sobject.h"
 #include "TensorT.h"
@@ -80,7 +83,7 @@ CheMPS2::Sobject::Sobject( const int index, SyBookkeeper * denBK ){
    sectorNR    = new int[ nKappa ];
    sectorTwoSR = new int[ nKappa ];
    sectorIR    = new int[ nKappa ];
-   kappa2index = new int[ nKappa + 1 ];
+   kappa2index = new long long[ nKappa + 1 ];
    kappa2index[ 0 ] = 0;
 
    nKappa = 0;
@@ -125,6 +128,7 @@ CheMPS2::Sobject::Sobject( const int index, SyBookkeeper * denBK ){
    }
 
    storage = new double[ kappa2index[ nKappa ] ];
+   sector_index = new SectorIndex( nKappa, sectorNL, sectorTwoSL, sectorIL, denBK->getNumberOfIrreps() );
 
    reorder = new int[ nKappa ];
    for ( int cnt = 0; cnt < nKappa; cnt++ ){ reorder[ cnt ] = cnt; }
@@ -160,6 +164,7 @@ CheMPS2::Sobject::~Sobject(){
    delete [] kappa2index;
    delete [] storage;
    delete [] reorder;
+   delete sector_index;
 
 }
 
@@ -171,7 +176,10 @@ int CheMPS2::Sobject::gReorder( const int ikappa ) const{ return reorder[ ikappa
 
 int CheMPS2::Sobject::gKappa( const int NL, const int TwoSL, const int IL, const int N1, const int N2, const int TwoJ, const int NR, const int TwoSR, const int IR ) const{
 
-   for ( int ikappa = 0; ikappa < nKappa; ikappa++ ){
+   const int key = sector_index->gKey( NL, TwoSL, IL );
+   if ( key == -1 ){ return -1; }
+
+   for ( int ikappa = sector_index->gBegin( key ); ikappa < sector_index->gEnd( key ); ikappa++ ){
       if (( sectorNL   [ ikappa ] == NL    ) &&
           ( sectorTwoSL[ ikappa ] == TwoSL ) &&
           ( sectorIL   [ ikappa ] == IL    ) &&
@@ -187,7 +195,7 @@ int CheMPS2::Sobject::gKappa( const int NL, const int TwoSL, const int IL, const
 
 }
 
-int CheMPS2::Sobject::gKappa2index( const int kappa ) const{ return kappa2index[ kappa ]; }
+long long CheMPS2::Sobject::gKappa2index( const int kappa ) const{ return kappa2index[ kappa ]; }
 
 double * CheMPS2::Sobject::gStorage( const int NL, const int TwoSL, const int IL, const int N1, const int N2, const int TwoJ, const int NR, const int TwoSR, const int IR ){
 
@@ -257,7 +265,13 @@ void CheMPS2::Sobject::Join( TensorT * Tleft, TensorT * Tright ){
 
 }
 
-double CheMPS2::Sobject::Split( TensorT * Tleft, TensorT * Tright, const int virtualdimensionD, const bool movingright, const bool change ){
+double CheMPS2::Sobject::Split( TensorT * Tleft, TensorT * Tright, const int virtualdimensionD, const bool movingright, const bool change, const int num_extra, Sobject ** extra_S, TensorT ** extra_T, Workspace * work, const double max_discarded_weight, const int min_dimension ){
+
+   /* With extra roots, the weighted S-objects are stacked next to ( movingright ) or on top of ( !movingright ) each other before the SVD.
+      The squared singular values are then the eigenvalues of the state-averaged reduced density matrix. The shared basis goes to Tleft
+      ( movingright ) or Tright ( !movingright ), and the projection of each root on the shared basis to Tright / Tleft and extra_T. */
+   const int num_roots = 1 + num_extra;
+   const double root_weight = 1.0 / sqrt( 1.0 * num_roots );
 
    #ifdef CHEMPS2_MPI_COMPILATION
    const bool am_i_master = ( MPIchemps2::mpi_rank() == MPI_CHEMPS2_MASTER );
@@ -302,17 +316,27 @@ double CheMPS2::Sobject::Split( TensorT * Tleft, TensorT * Tright, const int vir
    int * CenterDims  = NULL;
    int * DimLtotal   = NULL;
    int * DimRtotal   = NULL;
+   int * DimRows     = NULL;
+   int * DimCols     = NULL;
+   double * Tails    = NULL;
 
    #ifdef CHEMPS2_MPI_COMPILATION
    if ( am_i_master ){
    #endif
 
+   Workspace local_work;
+   Workspace * arena = (( work == NULL ) ? &local_work : work );
+
    Lambdas = new double*[ nCenterSectors ];
    Us      = new double*[ nCenterSectors ];
    VTs     = new double*[ nCenterSectors ];
    CenterDims  = new int[ nCenterSectors ];
    DimLtotal   = new int[ nCenterSectors ];
    DimRtotal   = new int[ nCenterSectors ];
+   DimRows     = new int[ nCenterSectors ];
+   DimCols     = new int[ nCenterSectors ];
+   Tails       = new double[ nCenterSectors ];
+   int * Large = new int[ nCenterSectors ];
 
    //PARALLEL
    #pragma omp parallel for schedule(dynamic)
@@ -345,84 +369,113 @@ double CheMPS2::Sobject::Split( TensorT * Tleft, TensorT * Tright, const int vir
             }
          }
       }
-      CenterDims[ iCenter ] = min( DimLtotal[ iCenter ], DimRtotal[ iCenter ] ); // CenterDims contains the min. amount
-
-      //Allocate memory to copy the different parts of the S-object. Use prefactor sqrt((2jR+1)/(2jM+1) * (2jM+1) * (2j+1)) W6J (-1)^(jL+jR+s1+s2) and sum over j.
-      if ( CenterDims[ iCenter ] > 0 ){
-
-         // Only if CenterDims[ iCenter ] exists should you allocate the following three arrays
-         Lambdas[ iCenter ] = new double[ CenterDims[ iCenter ] ];
-              Us[ iCenter ] = new double[ CenterDims[ iCenter ] * DimLtotal[ iCenter ] ];
-             VTs[ iCenter ] = new double[ CenterDims[ iCenter ] * DimRtotal[ iCenter ] ];
-
-         const int memsize = DimLtotal[ iCenter ] * DimRtotal[ iCenter ];
-         double * mem = new double[ memsize ];
-         for ( int cnt = 0; cnt < memsize; cnt++ ){ mem[ cnt ] = 0.0; }
-
-         int dimLtotal2 = 0;
-         for ( int NL = SplitSectNM[ iCenter ] - 2; NL <= SplitSectNM[ iCenter ]; NL++ ){
-            const int TwoS1 = (( NL + 1 == SplitSectNM[ iCenter ] ) ? 1 : 0 );
-            for ( int TwoSL = SplitSectTwoJM[ iCenter ] - TwoS1; TwoSL <= SplitSectTwoJM[ iCenter ] + TwoS1; TwoSL += 2 ){
-               if ( TwoSL >= 0 ){
-                  const int IL = (( TwoS1 == 1 ) ? Irreps::directProd( Ilocal1, SplitSectIM[ iCenter ] ) : SplitSectIM[ iCenter ] );
-                  const int dimL = denBK->gCurrentDim( index, NL, TwoSL, IL );
-                  if ( dimL > 0 ){
-                     int dimRtotal2 = 0;
-                     for ( int NR = SplitSectNM[ iCenter ]; NR <= SplitSectNM[ iCenter ] + 2; NR++ ){
-                        const int TwoS2 = (( NR == SplitSectNM[ iCenter ] + 1 ) ? 1 : 0 );
-                        for ( int TwoSR = SplitSectTwoJM[ iCenter ] - TwoS2; TwoSR <= SplitSectTwoJM[ iCenter ] + TwoS2; TwoSR += 2 ){
-                           if ( TwoSR >= 0 ){
-                              const int IR = (( TwoS2 == 1 ) ? Irreps::directProd( Ilocal2, SplitSectIM[ iCenter ] ) : SplitSectIM[ iCenter ] );
-                              const int dimR = denBK->gCurrentDim( index + 2, NR, TwoSR, IR );
-                              if ( dimR > 0 ){
-                                 // Loop over contributing TwoJ's
-                                 const int fase = Special::phase( TwoSL + TwoSR + TwoS1 + TwoS2 );
-                                 const int TwoJmin = max( abs( TwoSR - TwoSL ), abs( TwoS2 - TwoS1 ) );
-                                 const int TwoJmax = min( TwoS1 + TwoS2, TwoSL + TwoSR );
-                                 for ( int TwoJ = TwoJmin; TwoJ <= TwoJmax; TwoJ += 2 ){
-                                    // Calc prefactor
-                                    const double prefactor = fase
-                                                           * sqrt( 1.0 * ( TwoJ + 1 ) * ( TwoSR + 1 ) )
-                                                           * Wigner::wigner6j( TwoSL, TwoSR, TwoJ, TwoS2, TwoS1, SplitSectTwoJM[ iCenter ] );
-
-                                    // Add them to mem --> += because several TwoJ
-                                    double * Block = gStorage( NL, TwoSL, IL, SplitSectNM[ iCenter ] - NL, NR - SplitSectNM[ iCenter ], TwoJ, NR, TwoSR, IR );
-                                    for ( int l = 0; l < dimL; l++ ){
-                                       for ( int r = 0; r < dimR; r++ ){
-                                          mem[ dimLtotal2 + l + DimLtotal[ iCenter ] * ( dimRtotal2 + r ) ] += prefactor * Block[ l + dimL * r ];
+      DimRows[ iCenter ] = DimLtotal[ iCenter ] * (( movingright ) ? 1 : num_roots );
+      DimCols[ iCenter ] = DimRtotal[ iCenter ] * (( movingright ) ? num_roots : 1 );
+      CenterDims[ iCenter ] = min( DimRows[ iCenter ], DimCols[ iCenter ] ); // CenterDims contains the min. amount
+      Tails[ iCenter ] = 0.0;
+
+      /* At most virtualdimensionD singular values of a sector are kept: if this is much smaller than the rank, only the largest
+         virtualdimensionD + 1 are computed from the reduced density matrix of the side which becomes normalized. */
+      if (( change ) && ( SPLIT_EIGEN_factor > 0 ) && ( ( virtualdimensionD + 1.0 ) * SPLIT_EIGEN_factor <= CenterDims[ iCenter ] )){
+         const int dim_normalized = (( movingright ) ? DimRows[ iCenter ] : DimCols[ iCenter ] );
+         if ( dim_normalized <= 2 * CenterDims[ iCenter ] ){ CenterDims[ iCenter ] = virtualdimensionD + 1; }
+      }
+   }
+
+   /* Sectors which cost more than an equal share of the threads are decomposed one after another with the threads of the LAPACK
+      library ( Large == 1 ), and the other sectors in parallel with one thread each ( Large == 0 ). */
+   #ifdef _OPENMP
+   const int num_threads = omp_get_max_threads();
+   #else
+   const int num_threads = 1;
+   #endif
+   double total_cost = 0.0;
+   for ( int iCenter = 0; iCenter < nCenterSectors; iCenter++ ){
+      total_cost += ( 1.0 * DimRows[ iCenter ] ) * DimCols[ iCenter ] * CenterDims[ iCenter ];
+   }
+   for ( int iCenter = 0; iCenter < nCenterSectors; iCenter++ ){
+      const double cost = ( 1.0 * DimRows[ iCenter ] ) * DimCols[ iCenter ] * CenterDims[ iCenter ];
+      Large[ iCenter ] = ((( SPLIT_LAPACK_threaded ) && ( num_threads > 1 ) && ( cost * num_threads > total_cost )) ? 1 : 0 );
+   }
+
+   for ( int large = 0; large < 2; large++ ){
+      #pragma omp parallel for schedule(dynamic) if ( large == 0 )
+      for ( int iCenter = 0; iCenter < nCenterSectors; iCenter++ ){
+
+         //Allocate memory to copy the different parts of the S-object. Use prefactor sqrt((2jR+1)/(2jM+1) * (2jM+1) * (2j+1)) W6J (-1)^(jL+jR+s1+s2) and sum over j.
+         if (( CenterDims[ iCenter ] > 0 ) && ( Large[ iCenter ] == large )){
+
+            // Only if CenterDims[ iCenter ] exists should you allocate the following three arrays
+            Lambdas[ iCenter ] = new double[ CenterDims[ iCenter ] ];
+                 Us[ iCenter ] = new double[ CenterDims[ iCenter ] * DimRows[ iCenter ] ];
+                VTs[ iCenter ] = new double[ CenterDims[ iCenter ] * DimCols[ iCenter ] ];
+
+            const int memsize = DimRows[ iCenter ] * DimCols[ iCenter ];
+            double * mem = arena->get_double( 0, memsize );
+            for ( int cnt = 0; cnt < memsize; cnt++ ){ mem[ cnt ] = 0.0; }
+
+            for ( int root = 0; root < num_roots; root++ ){
+               Sobject * current = (( root == 0 ) ? this : extra_S[ root - 1 ] );
+               const int jumpRow = (( movingright ) ? 0 : root * DimLtotal[ iCenter ] );
+               const int jumpCol = (( movingright ) ? root * DimRtotal[ iCenter ] : 0 );
+               int dimLtotal2 = 0;
+               for ( int NL = SplitSectNM[ iCenter ] - 2; NL <= SplitSectNM[ iCenter ]; NL++ ){
+                  const int TwoS1 = (( NL + 1 == SplitSectNM[ iCenter ] ) ? 1 : 0 );
+                  for ( int TwoSL = SplitSectTwoJM[ iCenter ] - TwoS1; TwoSL <= SplitSectTwoJM[ iCenter ] + TwoS1; TwoSL += 2 ){
+                     if ( TwoSL >= 0 ){
+                        const int IL = (( TwoS1 == 1 ) ? Irreps::directProd( Ilocal1, SplitSectIM[ iCenter ] ) : SplitSectIM[ iCenter ] );
+                        const int dimL = denBK->gCurrentDim( index, NL, TwoSL, IL );
+                        if ( dimL > 0 ){
+                           int dimRtotal2 = 0;
+                           for ( int NR = SplitSectNM[ iCenter ]; NR <= SplitSectNM[ iCenter ] + 2; NR++ ){
+                              const int TwoS2 = (( NR == SplitSectNM[ iCenter ] + 1 ) ? 1 : 0 );
+                              for ( int TwoSR = SplitSectTwoJM[ iCenter ] - TwoS2; TwoSR <= SplitSectTwoJM[ iCenter ] + TwoS2; TwoSR += 2 ){
+                                 if ( TwoSR >= 0 ){
+                                    const int IR = (( TwoS2 == 1 ) ? Irreps::directProd( Ilocal2, SplitSectIM[ iCenter ] ) : SplitSectIM[ iCenter ] );
+                                    const int dimR = denBK->gCurrentDim( index + 2, NR, TwoSR, IR );
+                                    if ( dimR > 0 ){
+                                       // Loop over contributing TwoJ's
+                                       const int fase = Special::phase( TwoSL + TwoSR + TwoS1 + TwoS2 );
+                                       const int TwoJmin = max( abs( TwoSR - TwoSL ), abs( TwoS2 - TwoS1 ) );
+                                       const int TwoJmax = min( TwoS1 + TwoS2, TwoSL + TwoSR );
+                                       for ( int TwoJ = TwoJmin; TwoJ <= TwoJmax; TwoJ += 2 ){
+                                          // Calc prefactor
+                                          const double prefactor = fase
+                                                                 * sqrt( 1.0 * ( TwoJ + 1 ) * ( TwoSR + 1 ) )
+                                                                 * Wigner::wigner6j( TwoSL, TwoSR, TwoJ, TwoS2, TwoS1, SplitSectTwoJM[ iCenter ] )
+                                                                 * root_weight;
+
+                                          // Add them to mem --> += because several TwoJ
+                                          double * Block = current->gStorage( NL, TwoSL, IL, SplitSectNM[ iCenter ] - NL, NR - SplitSectNM[ iCenter ], TwoJ, NR, TwoSR, IR );
+                                          for ( int l = 0; l < dimL; l++ ){
+                                             for ( int r = 0; r < dimR; r++ ){
+                                                mem[ jumpRow + dimLtotal2 + l + DimRows[ iCenter ] * ( jumpCol + dimRtotal2 + r ) ] += prefactor * Block[ l + dimL * r ];
+                                             }
+                                          }
                                        }
+                                       dimRtotal2 += dimR;
                                     }
                                  }
-                                 dimRtotal2 += dimR;
                               }
                            }
+                           dimLtotal2 += dimL;
                         }
                      }
-                     dimLtotal2 += dimL;
                   }
                }
             }
-         }
-
-         // Now mem contains sqrt((2jR+1)/(2jM+1)) * (TT)^{jM nM IM) --> SVD per central symmetry
-         char jobz = 'S'; // M x min(M,N) in U and min(M,N) x N in VT
-         int lwork = 3 * CenterDims[ iCenter ] + max( max( DimLtotal[ iCenter ], DimRtotal[ iCenter ] ), 4 * CenterDims[ iCenter ] * ( CenterDims[ iCenter ] + 1 ) );
-         double * work = new double[ lwork ];
-         int * iwork = new int[ 8 * CenterDims[ iCenter ] ];
-         int info;
-
-         // dgesdd is not thread-safe in every implementation ( intel MKL is safe, Atlas is not safe )
-         #ifndef CHEMPS2_MKL
-         #pragma omp critical
-         #endif
-         dgesdd_( &jobz, DimLtotal + iCenter, DimRtotal + iCenter, mem, DimLtotal + iCenter,
-                  Lambdas[ iCenter ], Us[ iCenter ], DimLtotal + iCenter, VTs[ iCenter ], CenterDims + iCenter, work, &lwork, iwork, &info );
 
-         delete [] work;
-         delete [] iwork;
-         delete [] mem;
+            // Now mem contains sqrt((2jR+1)/(2jM+1)) * (TT)^{jM nM IM) --> SVD per central symmetry
+            if ( SPLIT_LAPACK_threadsafe ){
+               Tails[ iCenter ] = decompose( mem, DimRows[ iCenter ], DimCols[ iCenter ], CenterDims[ iCenter ], movingright, Lambdas[ iCenter ], Us[ iCenter ], VTs[ iCenter ], arena );
+            } else {
+               #pragma omp critical
+               Tails[ iCenter ] = decompose( mem, DimRows[ iCenter ], DimCols[ iCenter ], CenterDims[ iCenter ], movingright, Lambdas[ iCenter ], Us[ iCenter ], VTs[ iCenter ], arena );
+            }
+         }
       }
    }
+   delete [] Large;
 
    #ifdef CHEMPS2_MPI_COMPILATION
    }
@@ -447,8 +500,10 @@ double CheMPS2::Sobject::Split( TensorT * Tleft, TensorT * Tright, const int vir
          totalDimSVD += NewDims[ iCenter ];
       }
 
-      // If larger then the required virtualdimensionD, new virtual dimensions will be set in NewDims.
-      if ( totalDimSVD > virtualdimensionD ){
+      /* If larger then the required virtualdimensionD, new virtual dimensions will be set in NewDims. With max_discarded_weight > 0.0,
+         the smallest number of states in [ min_dimension, virtualdimensionD ] is kept for which the discarded weight does not exceed
+         max_discarded_weight; the bond dimension then adapts to the entanglement over the bond. */
+      if (( totalDimSVD > virtualdimensionD ) || ( max_discarded_weight > 0.0 )){
          // Copy them all in 1 array
          double * values = new double[ totalDimSVD ];
          totalDimSVD = 0;
@@ -465,25 +520,36 @@ double CheMPS2::Sobject::Split( TensorT * Tleft, TensorT * Tright, const int vir
          int info;
          dlasrt_( &ID, &totalDimSVD, values, &info ); // Quicksort
 
-         // The D+1'th value becomes the lower bound Schmidt value. Every value smaller than or equal to the D+1'th value is thrown out (hence Dactual <= Ddesired).
-         const double lowerBound = values[ virtualdimensionD ];
-         for ( int iCenter = 0; iCenter < nCenterSectors; iCenter++ ){
-            for ( int cnt = 0; cnt < NewDims[ iCenter ]; cnt++ ){
-               if ( Lambdas[ iCenter ][ cnt ] <= lowerBound ){ NewDims[ iCenter ] = cnt; }
+         // The number of states to keep: the discarded weight decreases monotonically with it, hence bisection
+         int num_keep = min( virtualdimensionD, totalDimSVD );
+         if ( max_discarded_weight > 0.0 ){
+            double totalSum = 0.0;
+            discarded_sum( -1.0, nCenterSectors, SplitSectTwoJM, CenterDims, Lambdas, Tails, &totalSum );
+            int lower = max( 0, min( min_dimension, num_keep ) );
+            while ( lower < num_keep ){
+               const int middle = ( lower + num_keep ) / 2;
+               if ( discarded_sum( values[ middle ], nCenterSectors, SplitSectTwoJM, CenterDims, Lambdas, Tails, &totalSum ) <= max_discarded_weight * totalSum ){
+                  num_keep = middle;
+               } else {
+                  lower = middle + 1;
+               }
             }
          }
 
-         // Discarded weight
-         double totalSum = 0.0;
-         double discardedSum = 0.0;
-         for ( int iCenter = 0; iCenter < nCenterSectors; iCenter++ ){
-            for ( int iLocal = 0; iLocal < CenterDims[ iCenter ]; iLocal++ ){
-               double temp = ( SplitSectTwoJM[ iCenter ] + 1 ) * Lambdas[ iCenter ][ iLocal ] * Lambdas[ iCenter ][ iLocal ];
-               totalSum += temp;
-               if ( Lambdas[ iCenter ][ iLocal ] <= lowerBound ){ discardedSum += temp; }
+         if ( num_keep < totalDimSVD ){
+            // The num_keep+1'th value becomes the lower bound Schmidt value. Every value smaller than or equal to the num_keep+1'th value is thrown out (hence Dactual <= num_keep).
+            const double lowerBound = values[ num_keep ];
+            for ( int iCenter = 0; iCenter < nCenterSectors; iCenter++ ){
+               for ( int cnt = 0; cnt < NewDims[ iCenter ]; cnt++ ){
+                  if ( Lambdas[ iCenter ][ cnt ] <= lowerBound ){ NewDims[ iCenter ] = cnt; }
+               }
             }
+
+            // Discarded weight
+            double totalSum = 0.0;
+            const double discardedSum = discarded_sum( lowerBound, nCenterSectors, SplitSectTwoJM, CenterDims, Lambdas, Tails, &totalSum );
+            discardedWeight = discardedSum / totalSum;
          }
-         discardedWeight = discardedSum / totalSum;
 
          // Clean-up
          delete [] values;
@@ -515,6 +581,7 @@ double CheMPS2::Sobject::Split( TensorT * Tleft, TensorT * Tright, const int vir
       }
       Tleft ->Reset();
       Tright->Reset();
+      for ( int extra = 0; extra < num_extra; extra++ ){ extra_T[ extra ]->Reset(); }
 
    }
 
@@ -530,57 +597,65 @@ double CheMPS2::Sobject::Split( TensorT * Tleft, TensorT * Tright, const int vir
       const int dimM = denBK->gCurrentDim( index + 1, SplitSectNM[ iCenter ], SplitSectTwoJM[ iCenter ], SplitSectIM[ iCenter ] );
       if ( dimM > 0 ){
          // U-part: copy
-         int dimLtotal2 = 0;
-         for ( int NL = SplitSectNM[ iCenter ] - 2; NL <= SplitSectNM[ iCenter ]; NL++ ){
-            const int TwoS1 = (( NL + 1 == SplitSectNM[ iCenter ] ) ? 1 : 0 );
-            for ( int TwoSL = SplitSectTwoJM[ iCenter ] - TwoS1; TwoSL <= SplitSectTwoJM[ iCenter ] + TwoS1; TwoSL += 2 ){
-               if ( TwoSL >= 0 ){
-                  const int IL = (( TwoS1 == 1 ) ? Irreps::directProd( Ilocal1, SplitSectIM[ iCenter ] ) : SplitSectIM[ iCenter ] );
-                  const int dimL = denBK->gCurrentDim( index, NL, TwoSL, IL );
-                  if ( dimL > 0 ){
-                     double * TleftBlock = Tleft->gStorage( NL, TwoSL, IL, SplitSectNM[ iCenter ], SplitSectTwoJM[ iCenter ], SplitSectIM[ iCenter ] );
-                     const int dimension_limit_right = min( dimM, CenterDims[ iCenter ] );
-                     for ( int r = 0; r < dimension_limit_right; r++ ){
-                        const double factor = (( movingright ) ? 1.0 : Lambdas[ iCenter ][ r ] );
-                        for ( int l = 0; l < dimL; l++ ){
-                           TleftBlock[ l + dimL * r ] = factor * Us[ iCenter ][ dimLtotal2 + l + DimLtotal[ iCenter ] * r ];
+         for ( int root = 0; root < (( movingright ) ? 1 : num_roots ); root++ ){
+            TensorT * Ttarget = (( root == 0 ) ? Tleft : extra_T[ root - 1 ] );
+            const int jumpRow = root * DimLtotal[ iCenter ];
+            int dimLtotal2 = 0;
+            for ( int NL = SplitSectNM[ iCenter ] - 2; NL <= SplitSectNM[ iCenter ]; NL++ ){
+               const int TwoS1 = (( NL + 1 == SplitSectNM[ iCenter ] ) ? 1 : 0 );
+               for ( int TwoSL = SplitSectTwoJM[ iCenter ] - TwoS1; TwoSL <= SplitSectTwoJM[ iCenter ] + TwoS1; TwoSL += 2 ){
+                  if ( TwoSL >= 0 ){
+                     const int IL = (( TwoS1 == 1 ) ? Irreps::directProd( Ilocal1, SplitSectIM[ iCenter ] ) : SplitSectIM[ iCenter ] );
+                     const int dimL = denBK->gCurrentDim( index, NL, TwoSL, IL );
+                     if ( dimL > 0 ){
+                        double * TleftBlock = Ttarget->gStorage( NL, TwoSL, IL, SplitSectNM[ iCenter ], SplitSectTwoJM[ iCenter ], SplitSectIM[ iCenter ] );
+                        const int dimension_limit_right = min( dimM, CenterDims[ iCenter ] );
+                        for ( int r = 0; r < dimension_limit_right; r++ ){
+                           const double factor = (( movingright ) ? 1.0 : Lambdas[ iCenter ][ r ] / root_weight );
+                           for ( int l = 0; l < dimL; l++ ){
+                              TleftBlock[ l + dimL * r ] = factor * Us[ iCenter ][ jumpRow + dimLtotal2 + l + DimRows[ iCenter ] * r ];
+                           }
                         }
-                     }
-                     for ( int r = dimension_limit_right; r < dimM; r++ ){
-                        for ( int l = 0; l < dimL; l++ ){
-                           TleftBlock[ l + dimL * r ] = 0.0;
+                        for ( int r = dimension_limit_right; r < dimM; r++ ){
+                           for ( int l = 0; l < dimL; l++ ){
+                              TleftBlock[ l + dimL * r ] = 0.0;
+                           }
                         }
+                        dimLtotal2 += dimL;
                      }
-                     dimLtotal2 += dimL;
                   }
                }
             }
          }
 
          // VT-part: copy
-         int dimRtotal2 = 0;
-         for ( int NR = SplitSectNM[ iCenter ]; NR <= SplitSectNM[ iCenter ] + 2; NR++ ){
-            const int TwoS2 = (( NR == SplitSectNM[ iCenter ] + 1 ) ? 1 : 0 );
-            for ( int TwoSR = SplitSectTwoJM[ iCenter ] - TwoS2; TwoSR <= SplitSectTwoJM[ iCenter ] + TwoS2; TwoSR += 2 ){
-               if ( TwoSR >= 0 ){
-                  const int IR = (( TwoS2 == 1 ) ? Irreps::directProd( Ilocal2, SplitSectIM[ iCenter ] ) : SplitSectIM[ iCenter ] );
-                  const int dimR = denBK->gCurrentDim( index + 2, NR, TwoSR, IR );
-                  if ( dimR > 0 ){
-                     double * TrightBlock = Tright->gStorage( SplitSectNM[ iCenter ], SplitSectTwoJM[ iCenter ], SplitSectIM[ iCenter ], NR, TwoSR, IR );
-                     const int dimension_limit_left = min( dimM, CenterDims[ iCenter ] );
-                     const double factor_base = sqrt( ( SplitSectTwoJM[ iCenter ] + 1.0 ) / ( TwoSR + 1 ) );
-                     for ( int l = 0; l < dimension_limit_left; l++ ){
-                        const double factor = factor_base * (( movingright ) ? Lambdas[ iCenter ][ l ] : 1.0 );
-                        for ( int r = 0; r < dimR; r++ ){
-                           TrightBlock[ l + dimM * r ] = factor * VTs[ iCenter ][ l + CenterDims[ iCenter ] * ( dimRtotal2 + r ) ];
+         for ( int root = 0; root < (( movingright ) ? num_roots : 1 ); root++ ){
+            TensorT * Ttarget = (( root == 0 ) ? Tright : extra_T[ root - 1 ] );
+            const int jumpCol = root * DimRtotal[ iCenter ];
+            int dimRtotal2 = 0;
+            for ( int NR = SplitSectNM[ iCenter ]; NR <= SplitSectNM[ iCenter ] + 2; NR++ ){
+               const int TwoS2 = (( NR == SplitSectNM[ iCenter ] + 1 ) ? 1 : 0 );
+               for ( int TwoSR = SplitSectTwoJM[ iCenter ] - TwoS2; TwoSR <= SplitSectTwoJM[ iCenter ] + TwoS2; TwoSR += 2 ){
+                  if ( TwoSR >= 0 ){
+                     const int IR = (( TwoS2 == 1 ) ? Irreps::directProd( Ilocal2, SplitSectIM[ iCenter ] ) : SplitSectIM[ iCenter ] );
+                     const int dimR = denBK->gCurrentDim( index + 2, NR, TwoSR, IR );
+                     if ( dimR > 0 ){
+                        double * TrightBlock = Ttarget->gStorage( SplitSectNM[ iCenter ], SplitSectTwoJM[ iCenter ], SplitSectIM[ iCenter ], NR, TwoSR, IR );
+                        const int dimension_limit_left = min( dimM, CenterDims[ iCenter ] );
+                        const double factor_base = sqrt( ( SplitSectTwoJM[ iCenter ] + 1.0 ) / ( TwoSR + 1 ) );
+                        for ( int l = 0; l < dimension_limit_left; l++ ){
+                           const double factor = factor_base * (( movingright ) ? Lambdas[ iCenter ][ l ] / root_weight : 1.0 );
+                           for ( int r = 0; r < dimR; r++ ){
+                              TrightBlock[ l + dimM * r ] = factor * VTs[ iCenter ][ l + CenterDims[ iCenter ] * ( jumpCol + dimRtotal2 + r ) ];
+                           }
                         }
-                     }
-                     for ( int r = 0; r < dimR; r++ ){
-                        for ( int l = dimension_limit_left; l < dimM; l++ ){
-                           TrightBlock[ l + dimM * r ] = 0.0;
+                        for ( int r = 0; r < dimR; r++ ){
+                           for ( int l = dimension_limit_left; l < dimM; l++ ){
+                              TrightBlock[ l + dimM * r ] = 0.0;
+                           }
                         }
+                        dimRtotal2 += dimR;
                      }
-                     dimRtotal2 += dimR;
                   }
                }
             }
@@ -590,8 +665,10 @@ double CheMPS2::Sobject::Split( TensorT * Tleft, TensorT * Tright, const int vir
 
    #ifdef CHEMPS2_MPI_COMPILATION
    }
-   MPIchemps2::broadcast_tensor( Tleft,  MPI_CHEMPS2_MASTER );
-   MPIchemps2::broadcast_tensor( Tright, MPI_CHEMPS2_MASTER );
+   std::vector<MPI_Request> requests; // The new MPS tensors are in flight while the work arrays are freed
+   MPIchemps2::ibroadcast_tensor( Tleft,  MPI_CHEMPS2_MASTER, requests );
+   MPIchemps2::ibroadcast_tensor( Tright, MPI_CHEMPS2_MASTER, requests );
+   for ( int extra = 0; extra < num_extra; extra++ ){ MPIchemps2::ibroadcast_tensor( extra_T[ extra ], MPI_CHEMPS2_MASTER, requests ); }
    #endif
 
    // Clean up
@@ -615,12 +692,121 @@ double CheMPS2::Sobject::Split( TensorT * Tleft, TensorT * Tright, const int vir
       delete [] CenterDims;
       delete [] DimLtotal;
       delete [] DimRtotal;
+      delete [] DimRows;
+      delete [] DimCols;
+      delete [] Tails;
    }
+   #ifdef CHEMPS2_MPI_COMPILATION
+   MPIchemps2::wait_requests( requests );
+   #endif
 
    return discardedWeight;
 
 }
 
+double CheMPS2::Sobject::discarded_sum( const double lower_bound, const int num_center, const int * two_j, const int * dims, double ** lambdas, const double * tails, double * total_sum ){
+
+   double total = 0.0;
+   double discarded = 0.0;
+   for ( int iCenter = 0; iCenter < num_center; iCenter++ ){
+      for ( int iLocal = 0; iLocal < dims[ iCenter ]; iLocal++ ){
+         const double temp = ( two_j[ iCenter ] + 1 ) * lambdas[ iCenter ][ iLocal ] * lambdas[ iCenter ][ iLocal ];
+         total += temp;
+         if ( lambdas[ iCenter ][ iLocal ] <= lower_bound ){ discarded += temp; }
+      }
+      total     += ( two_j[ iCenter ] + 1 ) * tails[ iCenter ];
+      discarded += ( two_j[ iCenter ] + 1 ) * tails[ iCenter ];
+   }
+   *total_sum = total;
+   return discarded;
+
+}
+
+double CheMPS2::Sobject::decompose( double * mem, int rows, int cols, int rank, const bool movingright, double * lambda, double * u, double * vt, Workspace * arena ){
+
+   int min_dim = min( rows, cols );
+   if ( rank == min_dim ){
+      char jobz = 'S'; // M x min(M,N) in U and min(M,N) x N in VT
+      int lwork = 3 * min_dim + max( max( rows, cols ), 4 * min_dim * ( min_dim + 1 ) );
+      double * svd_work = arena->get_double( 1, lwork );
+      int * iwork = arena->get_int( 0, 8 * min_dim );
+      int info;
+      dgesdd_( &jobz, &rows, &cols, mem, &rows, lambda, u, &rows, vt, &rank, svd_work, &lwork, iwork, &info );
+      return 0.0;
+   }
+
+   /* Largest eigenvalues of rho = mem * mem^T ( movingright ) or mem^T * mem ( !movingright ), in decreasing order.
+      The eigenvectors form the normalized side, and the other side is obtained as mem^T * U or mem * V. */
+   assert( rank < min_dim );
+   int dim = (( movingright ) ? rows : cols );
+   int ext = (( movingright ) ? cols : rows );
+   char uplo = 'U';
+   char trans = (( movingright ) ? 'N' : 'T');
+   double one = 1.0;
+   double zero = 0.0;
+   double * rho = arena->get_double( 2, ((long long) dim ) * dim );
+   dsyrk_( &uplo, &trans, &dim, &ext, &one, mem, &rows, &zero, rho, &dim );
+   double trace = 0.0;
+   for ( int cnt = 0; cnt < dim; cnt++ ){ trace += rho[ cnt * ( 1 + (long long) dim ) ]; }
+
+   char jobz = 'V';
+   char range = 'I';
+   double bound = 0.0;
+   int il = dim - rank + 1;
+   int iu = dim;
+   double abstol = 0.0;
+   int num_eigs;
+   int lwork = 26 * dim;
+   int liwork = 10 * dim;
+   double * work = arena->get_double( 1, lwork + rank );
+   double * eigs = work + lwork;
+   int * iwork = arena->get_int( 0, liwork + 2 * rank );
+   int * isuppz = iwork + liwork;
+   double * vecs = (( movingright ) ? u : vt );
+   int info;
+   dsyevr_( &jobz, &range, &uplo, &dim, rho, &dim, &bound, &bound, &il, &iu, &abstol, &num_eigs, eigs, vecs, &dim, isuppz, work, &lwork, iwork, &liwork, &info );
+   assert( num_eigs == rank );
+
+   // Reverse the order to decreasing eigenvalues
+   double tail = trace;
+   for ( int cnt = 0; cnt < rank; cnt++ ){
+      lambda[ cnt ] = sqrt( max( eigs[ rank - 1 - cnt ], 0.0 ) );
+      tail -= eigs[ cnt ];
+   }
+   for ( int low = 0, high = rank - 1; low < high; low++, high-- ){
+      for ( int cnt = 0; cnt < dim; cnt++ ){
+         const double temp = vecs[ cnt + dim * low ];
+         vecs[ cnt + dim * low  ] = vecs[ cnt + dim * high ];
+         vecs[ cnt + dim * high ] = temp;
+      }
+   }
+
+   if ( movingright ){ // vt = diag( 1 / lambda ) * U^T * mem
+      char tra = 'T';
+      char notr = 'N';
+      dgemm_( &tra, &notr, &rank, &cols, &rows, &one, u, &rows, mem, &rows, &zero, vt, &rank );
+      for ( int cnt = 0; cnt < rank; cnt++ ){
+         const double factor = (( lambda[ cnt ] > 0.0 ) ? 1.0 / lambda[ cnt ] : 0.0 );
+         for ( int col = 0; col < cols; col++ ){ vt[ cnt + rank * col ] *= factor; }
+      }
+   } else { // vecs = V ( cols x rank ) is transposed in place to vt, and u = mem * V * diag( 1 / lambda )
+      char notr = 'N';
+      dgemm_( &notr, &notr, &rows, &rank, &cols, &one, mem, &rows, vecs, &cols, &zero, u, &rows );
+      double * temp = arena->get_double( 0, ((long long) cols ) * rank ); // mem is no longer needed
+      for ( int cnt = 0; cnt < cols * rank; cnt++ ){ temp[ cnt ] = vecs[ cnt ]; }
+      for ( int cnt = 0; cnt < rank; cnt++ ){
+         for ( int col = 0; col < cols; col++ ){ vt[ cnt + rank * col ] = temp[ col + cols * cnt ]; }
+      }
+      for ( int cnt = 0; cnt < rank; cnt++ ){
+         const double factor = (( lambda[ cnt ] > 0.0 ) ? 1.0 / lambda[ cnt ] : 0.0 );
+         for ( int row = 0; row < rows; row++ ){ u[ row + rows * cnt ] *= factor; }
+      }
+   }
+
+   return max( tail, 0.0 );
+
+}
+
 void CheMPS2::Sobject::prog2symm(){
 
    #pragma omp parallel for schedule(dynamic)
@@ -651,7 +837,7 @@ void CheMPS2::Sobject::symm2prog(){
 
 void CheMPS2::Sobject::addNoise( const double NoiseLevel ){
    
-   for ( int cnt = 0; cnt < gKappa2index( gNKappa() ); cnt++ ){
+   for ( long long cnt = 0; cnt < gKappa2index( gNKappa() ); cnt++ ){
       const double RN = ( ( double ) rand() ) / RAND_MAX - 0.5;
       gStorage()[ cnt ] += RN * NoiseLevel;
    }
@@ -24,6 +24,7 @@
 
 #include "SyBookkeeper.h"
 #include "Irreps.h"
+#include "Wigner.h"
 #include "Options.h"
 
 CheMPS2::SyBookkeeper::SyBookkeeper( const Problem * Prob, const int D ){
@@ -38,6 +39,15 @@ CheMPS2::SyBookkeeper::SyBookkeeper( const Problem * Prob, const int D ){
    // Fill FCIdim
    fillFCIdim();
 
+   // Tabulate the Wigner-6j symbols up to the maximum virtual spin
+   int two_s_max = 0;
+   for ( int boundary = 0; boundary <= gL(); boundary++ ){
+      for ( int N = gNmin( boundary ); N <= gNmax( boundary ); N++ ){
+         two_s_max = std::max( two_s_max, gTwoSmax( boundary, N ) );
+      }
+   }
+   Wigner::prepare( two_s_max );
+
    // Copy FCIdim to CURdim
    CopyDim( FCIdim, CURdim );
 
@@ -552,16 +552,14 @@ double CheMPS2::Tensor3RDM::contract( Tensor3RDM * buddy ) const{
 
    if ( buddy->get_prime_last() ){ // Tensor abc
    
-      int length = kappa2index[ nKappa ];
-      int inc    = 1;
-      value = ddot_( &length, storage, &inc, buddy->gStorage(), &inc );
+      value = Special::ddot64( kappa2index[ nKappa ], storage, buddy->gStorage() );
       return value;
          
    } else { // Tensor d
    
       for ( int ikappa = 0; ikappa < nKappa; ikappa++ ){
       
-         int offset = kappa2index[ ikappa ];
+         long long offset = kappa2index[ ikappa ];
          int length = kappa2index[ ikappa + 1 ] - offset;
          int inc    = 1;
          double prefactor = sqrt( ( sector_spin_up[ ikappa ] + 1.0 ) / ( sector_spin_down[ ikappa ] + 1 ) )
@@ -77,7 +77,7 @@ void CheMPS2::TensorGYZ::construct(TensorT * denT){
          double beta = 0.0;
          dgemm_(&trans,&notr,&dimR,&dimR,&dimL,&alpha,BlockT,&dimL,BlockT,&dimL,&beta,storage+kappa2index[ikappa],&dimR);
       } else {
-         for (int cnt=kappa2index[ikappa]; cnt<kappa2index[ikappa+1]; cnt++){ storage[cnt] = 0.0; }
+         for (long long cnt=kappa2index[ikappa]; cnt<kappa2index[ikappa+1]; cnt++){ storage[cnt] = 0.0; }
       }
 
       if (identity=='G'){
@@ -68,7 +68,7 @@ CheMPS2::TensorOperator::TensorOperator( const int boundary_index, const int two
    sector_irrep_up  = new int[ nKappa ];
    sector_spin_up   = new int[ nKappa ];
    sector_spin_down = (( two_j == 0 ) ? sector_spin_up : new int[ nKappa ] );
-   kappa2index = new int[ nKappa + 1 ];
+   kappa2index = new long long[ nKappa + 1 ];
    kappa2index[ 0 ] = 0;
 
    nKappa = 0;
@@ -98,6 +98,7 @@ CheMPS2::TensorOperator::TensorOperator( const int boundary_index, const int two
    }
 
    storage = new double[ kappa2index[ nKappa ] ];
+   sector_index = new SectorIndex( nKappa, sector_nelec_up, sector_spin_up, sector_irrep_up, bk_up->getNumberOfIrreps() );
 
 }
 
@@ -109,6 +110,7 @@ CheMPS2::TensorOperator::~TensorOperator(){
    delete [] kappa2index;
    delete [] storage;
    if ( two_j != 0 ){ delete [] sector_spin_down; }
+   delete sector_index;
 
 }
 
@@ -122,12 +124,15 @@ int CheMPS2::TensorOperator::gKappa( const int N1, const int TwoS1, const int I1
    if ( N2 != N1 + n_elec ){ return -1; }
    if ( abs( TwoS1 - TwoS2 ) > two_j ){ return -1; }
 
+   const int key = sector_index->gKey( N1, TwoS1, I1 );
+   if ( key == -1 ){ return -1; }
+
    if ( two_j == 0 ){
-      for ( int cnt = 0; cnt < nKappa; cnt++ ){
+      for ( int cnt = sector_index->gBegin( key ); cnt < sector_index->gEnd( key ); cnt++ ){
          if (( sector_nelec_up[ cnt ] == N1 ) && ( sector_spin_up[ cnt ] == TwoS1 ) && ( sector_irrep_up[ cnt ] == I1 )){ return cnt; }
       }
    } else {
-      for ( int cnt = 0; cnt < nKappa; cnt++ ){
+      for ( int cnt = sector_index->gBegin( key ); cnt < sector_index->gEnd( key ); cnt++ ){
          if (( sector_nelec_up[ cnt ] == N1 ) && ( sector_spin_up[ cnt ] == TwoS1 ) && ( sector_irrep_up[ cnt ] == I1 ) && ( sector_spin_down[ cnt ] == TwoS2 )){ return cnt; }
       }
    }
@@ -136,7 +141,7 @@ int CheMPS2::TensorOperator::gKappa( const int N1, const int TwoS1, const int I1
 
 }
 
-int CheMPS2::TensorOperator::gKappa2index( const int kappa ) const{ return kappa2index[ kappa ]; }
+long long CheMPS2::TensorOperator::gKappa2index( const int kappa ) const{ return kappa2index[ kappa ]; }
 
 double * CheMPS2::TensorOperator::gStorage( const int N1, const int TwoS1, const int I1, const int N2, const int TwoS2, const int I2 ){
 
@@ -156,7 +161,7 @@ int CheMPS2::TensorOperator::get_irrep() const { return n_irrep; }
 
 void CheMPS2::TensorOperator::clear(){
 
-   for ( int cnt = 0; cnt < kappa2index[ nKappa ]; cnt++ ){ storage[ cnt ] = 0.0; }
+   for ( long long cnt = 0; cnt < kappa2index[ nKappa ]; cnt++ ){ storage[ cnt ] = 0.0; }
 
 }
 
@@ -408,8 +413,7 @@ void CheMPS2::TensorOperator::daxpy( double alpha, TensorOperator * to_add ){
 
    assert( nKappa == to_add->gNKappa() );
    assert( kappa2index[ nKappa ] == to_add->gKappa2index( to_add->gNKappa() ) );
-   int inc = 1;
-   daxpy_( kappa2index + nKappa, &alpha, to_add->gStorage(), &inc, storage, &inc );
+   Special::daxpy64( kappa2index[ nKappa ], alpha, to_add->gStorage(), storage );
 
 }
 
@@ -466,9 +470,7 @@ double CheMPS2::TensorOperator::inproduct( TensorOperator * buddy, const char tr
 
    if ( trans == 'N' ){
 
-      int length = kappa2index[ nKappa ];
-      int inc    = 1;
-      value = ddot_( &length, storage, &inc, buddy->gStorage(), &inc );
+      value = Special::ddot64( kappa2index[ nKappa ], storage, buddy->gStorage() );
 
    } else {
 
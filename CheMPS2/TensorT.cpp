@@ -66,7 +66,7 @@ void CheMPS2::TensorT::AllocateAllArrays(){
    sectorIR    = new int[ nKappa ];
    sectorTwoSL = new int[ nKappa ];
    sectorTwoSR = new int[ nKappa ];
-   kappa2index = new int[ nKappa + 1 ];
+   kappa2index = new long long[ nKappa + 1 ];
    kappa2index[ 0 ] = 0;
 
    nKappa = 0;
@@ -100,6 +100,7 @@ void CheMPS2::TensorT::AllocateAllArrays(){
    }
 
    storage = new double[ kappa2index[ nKappa ] ];
+   sector_index = new SectorIndex( nKappa, sectorNL, sectorTwoSL, sectorIL, denBK->getNumberOfIrreps() );
 
 }
 
@@ -119,6 +120,7 @@ void CheMPS2::TensorT::DeleteAllArrays(){
    delete [] sectorTwoSR;
    delete [] kappa2index;
    delete [] storage;
+   delete sector_index;
 
 }
 
@@ -135,7 +137,10 @@ double * CheMPS2::TensorT::gStorage() { return storage; }
 
 int CheMPS2::TensorT::gKappa( const int N1, const int TwoS1, const int I1, const int N2, const int TwoS2, const int I2 ) const{
 
-   for ( int cnt = 0; cnt < nKappa; cnt++ ){
+   const int key = sector_index->gKey( N1, TwoS1, I1 );
+   if ( key == -1 ){ return -1; }
+
+   for ( int cnt = sector_index->gBegin( key ); cnt < sector_index->gEnd( key ); cnt++ ){
       if (( sectorNL[ cnt ] == N1 ) &&
           ( sectorNR[ cnt ] == N2 ) &&
           ( sectorIL[ cnt ] == I1 ) &&
@@ -148,7 +153,14 @@ int CheMPS2::TensorT::gKappa( const int N1, const int TwoS1, const int I1, const
 
 }
 
-int CheMPS2::TensorT::gKappa2index( const int kappa ) const{ return kappa2index[ kappa ]; }
+long long CheMPS2::TensorT::gKappa2index( const int kappa ) const{ return kappa2index[ kappa ]; }
+
+int CheMPS2::TensorT::gNL   ( const int ikappa ) const{ return sectorNL   [ ikappa ]; }
+int CheMPS2::TensorT::gTwoSL( const int ikappa ) const{ return sectorTwoSL[ ikappa ]; }
+int CheMPS2::TensorT::gIL   ( const int ikappa ) const{ return sectorIL   [ ikappa ]; }
+int CheMPS2::TensorT::gNR   ( const int ikappa ) const{ return sectorNR   [ ikappa ]; }
+int CheMPS2::TensorT::gTwoSR( const int ikappa ) const{ return sectorTwoSR[ ikappa ]; }
+int CheMPS2::TensorT::gIR   ( const int ikappa ) const{ return sectorIR   [ ikappa ]; }
 
 double * CheMPS2::TensorT::gStorage( const int N1, const int TwoS1, const int I1, const int N2, const int TwoS2, const int I2 ){
 
@@ -166,7 +178,7 @@ void CheMPS2::TensorT::sBK( const SyBookkeeper * newBK ){ denBK = newBK; }
 
 void CheMPS2::TensorT::random(){
 
-   for ( int cnt = 0; cnt < kappa2index[ nKappa ]; cnt++ ){
+   for ( long long cnt = 0; cnt < kappa2index[ nKappa ]; cnt++ ){
       storage[ cnt ] = ((double) rand()) / RAND_MAX;
    }
 
@@ -35,41 +35,48 @@
 
 using std::max;
 
-CheMPS2::ThreeDM::ThreeDM( const SyBookkeeper * book_in, const Problem * prob_in, const bool disk_in ){
+CheMPS2::ThreeDM::ThreeDM( const SyBookkeeper * book_in, const Problem * prob_in, const bool disk_in, Workspace * work_in ){
 
    book = book_in;
    prob = prob_in;
    disk = disk_in;
+   own_work = ( work_in == NULL );
+   work = (( own_work ) ? new Workspace() : work_in );
 
    L = book->gL();
-   {
+
+   if ( disk ){
       const long long linsize = ( long long ) L;
-      const long long size    = (( disk ) ? linsize * linsize * linsize * linsize * linsize
-                                          : linsize * linsize * linsize * linsize * linsize * linsize );
+      const long long size    = linsize * linsize * linsize * linsize * linsize;
       assert( INT_MAX >= size );
       array_size = size;
-   }
-
-   elements = new double[ array_size ];
-   #pragma omp simd
-   for ( int cnt = 0; cnt < array_size; cnt++ ){ elements[ cnt ] = 0.0; }
-
-   if ( disk ){
+      elements = new double[ array_size ];
+      #pragma omp simd
+      for ( int cnt = 0; cnt < array_size; cnt++ ){ elements[ cnt ] = 0.0; }
       temp_disk_orbs = new int[ 6 * array_size ];
       temp_disk_vals = new double [ array_size ];
       create_file();
+      packed = NULL;
    } else {
+      array_size = 0;
+      elements = NULL;
       temp_disk_orbs = NULL;
       temp_disk_vals = NULL;
+      int * irreps = new int[ L ];
+      for ( int orb = 0; orb < L; orb++ ){ irreps[ orb ] = prob->gIrrep(( prob->gReorder() ) ? prob->gf1( orb ) : orb ); }
+      packed = new SixIndex( L, irreps );
+      delete [] irreps;
    }
 
 }
 
 CheMPS2::ThreeDM::~ThreeDM(){
 
-   delete [] elements;
-   if ( disk ){ delete [] temp_disk_orbs;
+   if ( disk ){ delete [] elements;
+                delete [] temp_disk_orbs;
                 delete [] temp_disk_vals; }
+   else { delete packed; }
+   if ( own_work ){ delete work; }
 
 }
 
@@ -88,10 +95,10 @@ void CheMPS2::ThreeDM::mpi_allreduce(){
 
    } else {
 
-      double * temp = new double[ array_size ];
-      MPIchemps2::allreduce_array_double( elements, temp, array_size );
-      #pragma omp simd
-      for ( int cnt = 0; cnt < array_size; cnt++ ){ elements[ cnt ] = temp[ cnt ]; }
+      const long long size = packed->get_array_size();
+      double * temp = new double[ size ];
+      MPIchemps2::allreduce_array_double( packed->get_storage(), temp, size );
+      Special::dcopy64( size, temp, packed->get_storage() );
       delete [] temp;
 
    }
@@ -129,26 +136,16 @@ void CheMPS2::ThreeDM::set_dmrg_index( const int cnt1, const int cnt2, const int
       return;
    }
 
-   elements[ orb1 + L * ( orb2 + L * ( orb3 + L * ( orb4 + L * ( orb5 + L * orb6 )))) ] = value;
-   elements[ orb2 + L * ( orb3 + L * ( orb1 + L * ( orb5 + L * ( orb6 + L * orb4 )))) ] = value;
-   elements[ orb3 + L * ( orb1 + L * ( orb2 + L * ( orb6 + L * ( orb4 + L * orb5 )))) ] = value;
-   elements[ orb2 + L * ( orb1 + L * ( orb3 + L * ( orb5 + L * ( orb4 + L * orb6 )))) ] = value;
-   elements[ orb3 + L * ( orb2 + L * ( orb1 + L * ( orb6 + L * ( orb5 + L * orb4 )))) ] = value;
-   elements[ orb1 + L * ( orb3 + L * ( orb2 + L * ( orb4 + L * ( orb6 + L * orb5 )))) ] = value;
-
-   elements[ orb4 + L * ( orb5 + L * ( orb6 + L * ( orb1 + L * ( orb2 + L * orb3 )))) ] = value;
-   elements[ orb5 + L * ( orb6 + L * ( orb4 + L * ( orb2 + L * ( orb3 + L * orb1 )))) ] = value;
-   elements[ orb6 + L * ( orb4 + L * ( orb5 + L * ( orb3 + L * ( orb1 + L * orb2 )))) ] = value;
-   elements[ orb5 + L * ( orb4 + L * ( orb6 + L * ( orb2 + L * ( orb1 + L * orb3 )))) ] = value;
-   elements[ orb6 + L * ( orb5 + L * ( orb4 + L * ( orb3 + L * ( orb2 + L * orb1 )))) ] = value;
-   elements[ orb4 + L * ( orb6 + L * ( orb5 + L * ( orb1 + L * ( orb3 + L * orb2 )))) ] = value;
+   // The SixIndex object covers the 6 permutations of the orbital pairs, the transpose covers the other 6
+   packed->set( orb1, orb2, orb3, orb4, orb5, orb6, value );
+   packed->set( orb4, orb5, orb6, orb1, orb2, orb3, value );
 
 }
 
 double CheMPS2::ThreeDM::get_ham_index( const int cnt1, const int cnt2, const int cnt3, const int cnt4, const int cnt5, const int cnt6 ) const{
 
    assert( disk == false );
-   return elements[ cnt1 + L * ( cnt2 + L * ( cnt3 + L * ( cnt4 + L * ( cnt5 + L * cnt6 )))) ];
+   return packed->get( cnt1, cnt2, cnt3, cnt4, cnt5, cnt6 );
 
 }
 
@@ -174,14 +171,59 @@ void CheMPS2::ThreeDM::fill_ham_index( const double alpha, const bool add, doubl
 
    } else {
 
-      const int shift = last_orb_start * L * L * L * L * L;
-      const int size  = last_orb_num   * L * L * L * L * L;
+      const long long size5 = (( long long ) L ) * L * L * L * L;
+      double * slice = (( add ) ? new double[ size5 ] : NULL );
+      for ( int ham_orb = last_orb_start; ham_orb < ( last_orb_start + last_orb_num ); ham_orb++ ){
+         double * target = storage + ( ham_orb - last_orb_start ) * size5;
+         if ( add == false ){
+            packed->fill_dense_slice( target, ham_orb );
+            Special::dscal64( size5, alpha, target );
+         } else {
+            packed->fill_dense_slice( slice, ham_orb );
+            Special::daxpy64( size5, alpha, slice, target );
+         }
+      }
+      if ( add ){ delete [] slice; }
+
+   }
+
+}
+
+void CheMPS2::ThreeDM::fill_ham_index( const double alpha, const bool add, SixIndex * storage ){
+
+   assert( storage->get_L() == L );
+
+   if ( disk ){
+
+      // The files contain all permutations: only the stored representatives are copied
+      if ( add == false ){ storage->clear(); }
+      for ( int ham_orb = 0; ham_orb < L; ham_orb++ ){
+         read_file( ham_orb );
+         for ( int orb5 = 0; orb5 < L; orb5++ ){
+            for ( int orb4 = 0; orb4 < L; orb4++ ){
+               for ( int orb3 = 0; orb3 < L; orb3++ ){
+                  for ( int orb2 = 0; orb2 < L; orb2++ ){
+                     for ( int orb1 = 0; orb1 < L; orb1++ ){
+                        if ( storage->canonical( orb1, orb2, orb3, orb4, orb5, ham_orb ) ){
+                           storage->add( orb1, orb2, orb3, orb4, orb5, ham_orb, alpha * elements[ orb1 + L * ( orb2 + L * ( orb3 + L * ( orb4 + L * orb5 ))) ] );
+                        }
+                     }
+                  }
+               }
+            }
+         }
+      }
+
+   } else {
+
+      // Same orbital irreps, hence the same layout
+      const long long size = packed->get_array_size();
+      assert( storage->get_array_size() == size );
       if ( add == false ){
-         #pragma omp simd
-         for ( int cnt = 0; cnt < size; cnt++ ){ storage[ cnt ]  = alpha * elements[ shift + cnt ]; }
+         Special::dcopy64( size, packed->get_storage(), storage->get_storage() );
+         Special::dscal64( size, alpha, storage->get_storage() );
       } else {
-         #pragma omp simd
-         for ( int cnt = 0; cnt < size; cnt++ ){ storage[ cnt ] += alpha * elements[ shift + cnt ]; }
+         Special::daxpy64( size, alpha, packed->get_storage(), storage->get_storage() );
       }
 
    }
@@ -325,7 +367,7 @@ void CheMPS2::ThreeDM::correct_higher_multiplicities(){
             write_file( ham_orb );
          }
       } else {
-         dscal_( &array_size, &alpha, elements, &inc1 );
+         Special::dscal64( packed->get_array_size(), alpha, packed->get_storage() );
       }
    }
 
@@ -371,7 +413,7 @@ void CheMPS2::ThreeDM::flush_disk(){
 void CheMPS2::ThreeDM::save_HAM( const string filename ) const{
 
    assert( disk == false );
-   save_HAM_generic( filename, L, "3-RDM", elements );
+   save_HAM_generic( filename, "3-RDM", packed );
 
 }
 
@@ -395,6 +437,40 @@ void CheMPS2::ThreeDM::save_HAM_generic( const string filename, const int LAS, c
 
 }
 
+void CheMPS2::ThreeDM::save_HAM_generic( const string filename, const string tag, const SixIndex * array ){
+
+   const int LAS = array->get_L();
+   const long long linsize = ( long long ) LAS;
+   const long long size5   = linsize * linsize * linsize * linsize * linsize;
+   double * slice = new double[ size5 ];
+
+   hid_t   file_id      = H5Fcreate( filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT );
+   hsize_t dimarray     = size5 * linsize;
+   hid_t   group_id     = H5Gcreate( file_id, tag.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
+   hid_t   dataspace_id = H5Screate_simple( 1, &dimarray, NULL );
+   hid_t   dataset_id   = H5Dcreate( group_id, "elements", H5T_IEEE_F64LE, dataspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
+
+   hsize_t dimslice = size5;
+   hid_t   memspace_id = H5Screate_simple( 1, &dimslice, NULL );
+   for ( int last_orb = 0; last_orb < LAS; last_orb++ ){
+      array->fill_dense_slice( slice, last_orb );
+      hsize_t start = size5 * last_orb;
+      H5Sselect_hyperslab( dataspace_id, H5S_SELECT_SET, &start, NULL, &dimslice, NULL );
+      H5Dwrite( dataset_id, H5T_NATIVE_DOUBLE, memspace_id, dataspace_id, H5P_DEFAULT, slice );
+   }
+   H5Sclose( memspace_id );
+
+   H5Dclose( dataset_id );
+   H5Sclose( dataspace_id );
+   H5Gclose( group_id );
+   H5Fclose( file_id );
+
+   delete [] slice;
+
+   std::cout << "Saved the " << tag << " to the file " << filename << std::endl;
+
+}
+
 void CheMPS2::ThreeDM::fill_site( TensorT * denT, TensorL *** Ltensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorS0 **** S0tensors, TensorS1 **** S1tensors,
                                   Tensor3RDM **** dm3_a_J0_doublet, Tensor3RDM **** dm3_a_J1_doublet, Tensor3RDM **** dm3_a_J1_quartet,
                                   Tensor3RDM **** dm3_b_J0_doublet, Tensor3RDM **** dm3_b_J1_doublet, Tensor3RDM **** dm3_b_J1_quartet,
@@ -413,8 +489,8 @@ void CheMPS2::ThreeDM::fill_site( TensorT * denT, TensorL *** Ltensors, TensorF0
    #pragma omp parallel
    {
 
-      double * workmem  = new double[ DIM * DIM ];
-      double * workmem2 = new double[ DIM * DIM ];
+      double * workmem  = work->get_double( 0, DIM * DIM );
+      double * workmem2 = work->get_double( 1, DIM * DIM );
 
       const int upperbound1 = ( orb_i * ( orb_i + 1 )) / 2;
       int jkl[] = { 0, 0, 0 };
@@ -1440,9 +1516,6 @@ void CheMPS2::ThreeDM::fill_site( TensorT * denT, TensorL *** Ltensors, TensorF0
          }
       
       }
-      
-      delete [] workmem;
-      delete [] workmem2;
 
    }
 
@@ -36,11 +36,13 @@ using std::max;
 using std::cout;
 using std::endl;
 
-CheMPS2::TwoDM::TwoDM(const SyBookkeeper * denBKIn, const Problem * ProbIn){
+CheMPS2::TwoDM::TwoDM(const SyBookkeeper * denBKIn, const Problem * ProbIn, Workspace * work_in){
 
    denBK = denBKIn;
    Prob = ProbIn;
    L = denBK->gL();
+   own_work = ( work_in == NULL );
+   work = (( own_work ) ? new Workspace() : work_in );
 
    const long long size = ((long long) L ) * ((long long) L ) * ((long long) L ) * ((long long) L );
    assert( INT_MAX >= size );
@@ -57,6 +59,7 @@ CheMPS2::TwoDM::~TwoDM(){
 
    delete [] two_rdm_A;
    delete [] two_rdm_B;
+   if ( own_work ){ delete work; }
 
 }
 
@@ -463,8 +466,8 @@ void CheMPS2::TwoDM::FillSite(TensorT * denT, TensorL *** Ltens, TensorF0 **** F
    #pragma omp parallel
    {
    
-      double * workmem  = new double[DIM*DIM];
-      double * workmem2 = new double[DIM*DIM];
+      double * workmem  = work->get_double( 0, DIM*DIM );
+      double * workmem2 = work->get_double( 1, DIM*DIM );
       
       #pragma omp for schedule(static) nowait
       for (int j_index=theindex+1; j_index<L; j_index++){
@@ -618,9 +621,6 @@ void CheMPS2::TwoDM::FillSite(TensorT * denT, TensorL *** Ltens, TensorF0 **** F
             }
          }
       }
-
-      delete [] workmem;
-      delete [] workmem2;
    
    }
 
@@ -22,6 +22,7 @@
 #include <algorithm>
 
 #include "Wigner.h"
+#include "Options.h"
 
 using std::max;
 using std::min;
@@ -222,6 +223,10 @@ const long double CheMPS2::Wigner::sqrt_fact[ CHEMPS2_WIGNER_FACTORIAL_MAX + 1 ]
    1.35975793102072127197584619684017539710327446682830024041110759004397440380130651896772216452518306764491453984964618714830010495e177   // sqrt( 191! )
 };
 
+double * CheMPS2::Wigner::table_6j = NULL;
+
+int CheMPS2::Wigner::table_2j = -1;
+
 int CheMPS2::Wigner::max_2j(){ return CHEMPS2_WIGNER_MAX_2J; }
 
 bool CheMPS2::Wigner::triangle_fails( const int two_ja, const int two_jb, const int two_jc ){
@@ -301,6 +306,87 @@ double CheMPS2::Wigner::wigner6j( const int two_ja, const int two_jb, const int
        ( triangle_fails( two_ja, two_je, two_jf ) ) ||
        ( triangle_fails( two_jd, two_jb, two_jf ) )){ return 0.0; }
 
+   if ( table_6j != NULL ){
+
+      /* Move the smallest spin to the position of two_jc with the tetrahedral symmetry of the 6j-symbol:
+         the columns can be permuted, and the upper and lower spins of two columns can be interchanged. */
+      int two_j[ 6 ] = { two_ja, two_jb, two_jc, two_jd, two_je, two_jf };
+      int pos = 2;
+      for ( int cnt = 0; cnt < 6; cnt++ ){ if ( two_j[ cnt ] < two_j[ pos ] ){ pos = cnt; } }
+      if ( pos >= 3 ){ // Interchange the upper and lower spins of column pos - 3 and another column
+         const int other = (( pos == 5 ) ? 0 : 2 );
+         std::swap( two_j[ pos - 3 ], two_j[ pos ] );
+         std::swap( two_j[ other ], two_j[ other + 3 ] );
+         pos = pos - 3;
+      }
+      if ( pos != 2 ){ // Interchange column pos and column 2
+         std::swap( two_j[ pos     ], two_j[ 2 ] );
+         std::swap( two_j[ pos + 3 ], two_j[ 5 ] );
+      }
+
+      if (( two_j[ 2 ] <= CHEMPS2_WIGNER_TABLE_SMALL_2J ) && ( two_j[ 0 ] <= table_2j ) && ( two_j[ 3 ] <= table_2j ) && ( two_j[ 5 ] <= table_2j )){
+         return table_6j[ index_6j( two_j[ 0 ], two_j[ 1 ], two_j[ 2 ], two_j[ 3 ], two_j[ 4 ], two_j[ 5 ] ) ];
+      }
+   }
+
+   return wigner6j_direct( two_ja, two_jb, two_jc, two_jd, two_je, two_jf );
+
+}
+
+long long CheMPS2::Wigner::index_6j( const int two_ja, const int two_jb, const int two_jc, const int two_jd, const int two_je, const int two_jf ){
+
+   // The triangle conditions (a,b,c) and (d,e,c) fix b and e up to ( two_jc + 1 ) possibilities; ( a + e + f ) even fixes the parity of f
+   const int num_small = CHEMPS2_WIGNER_TABLE_SMALL_2J + 1;
+   const int index_b   = ( two_jb - two_ja + two_jc ) / 2;
+   const int index_e   = ( two_je - two_jd + two_jc ) / 2;
+   long long index = ( two_jc * num_small + index_b ) * num_small + index_e;
+   index = index * ( table_2j + 1 ) + two_ja;
+   index = index * ( table_2j + 1 ) + two_jd;
+   index = index * ( table_2j / 2 + 1 ) + two_jf / 2;
+   return index;
+
+}
+
+long long CheMPS2::Wigner::size_6j( const int two_j_max ){
+
+   const long long num_small = CHEMPS2_WIGNER_TABLE_SMALL_2J + 1;
+   return num_small * num_small * num_small * ( two_j_max + 1 ) * ( two_j_max + 1 ) * ( two_j_max / 2 + 1 );
+
+}
+
+void CheMPS2::Wigner::prepare( const int two_j_max ){
+
+   int two_j_table = min( two_j_max, max_2j() - CHEMPS2_WIGNER_TABLE_SMALL_2J );
+   while (( two_j_table >= 0 ) && ( size_6j( two_j_table ) * sizeof( double ) > 1048576LL * WIGNER_TABLE_MAX_MB )){ two_j_table--; }
+   if ( two_j_table <= table_2j ){ return; }
+
+   double * table = new double[ size_6j( two_j_table ) ];
+   if ( table_6j != NULL ){ delete [] table_6j; }
+   table_6j = table;
+   table_2j = two_j_table;
+
+   for ( int two_jc = 0; two_jc <= CHEMPS2_WIGNER_TABLE_SMALL_2J; two_jc++ ){
+      for ( int index_b = 0; index_b <= two_jc; index_b++ ){
+         for ( int index_e = 0; index_e <= two_jc; index_e++ ){
+            for ( int two_ja = two_jc; two_ja <= table_2j; two_ja++ ){
+               const int two_jb = two_ja - two_jc + 2 * index_b;
+               for ( int two_jd = two_jc; two_jd <= table_2j; two_jd++ ){
+                  const int two_je = two_jd - two_jc + 2 * index_e;
+                  for ( int two_jf = ( two_ja + two_je ) % 2; two_jf <= table_2j; two_jf += 2 ){
+                     const bool valid = (( two_jb >= two_jc ) && ( two_je >= two_jc ) && ( two_jf >= two_jc ) &&
+                                         ( !triangle_fails( two_ja, two_je, two_jf ) ) && ( !triangle_fails( two_jd, two_jb, two_jf ) ));
+                     table_6j[ index_6j( two_ja, two_jb, two_jc, two_jd, two_je, two_jf ) ] = (( valid ) ? wigner6j_direct( two_ja, two_jb, two_jc, two_jd, two_je, two_jf ) : 0.0 );
+                  }
+               }
+            }
+         }
+      }
+   }
+
+}
+
+double CheMPS2::Wigner::wigner6j_direct( const int two_ja, const int two_jb, const int two_jc, const int two_jd, const int two_je, const int two_jf ){
+
    const int alpha1 = ( two_ja + two_jb + two_jc ) / 2;
    const int alpha2 = ( two_jd + two_je + two_jc ) / 2;
    const int alpha3 = ( two_ja + two_je + two_jf ) / 2;
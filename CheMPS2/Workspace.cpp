@@ -0,0 +1,113 @@
+/*
+   CheMPS2: a spin-adapted implementation of DMRG for ab initio quantum chemistry
+   Copyright (C) 2013-2016 Sebastian Wouters
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include <stdlib.h>
+#include <assert.h>
+#ifdef _OPENMP
+   #include <omp.h>
+#endif
+
+#include "Workspace.h"
+
+CheMPS2::Workspace::Workspace(){
+
+   #ifdef _OPENMP
+   num_threads = omp_get_max_threads();
+   #else
+   num_threads = 1;
+   #endif
+
+   doubles      = new double*[ num_double_slots * num_threads ];
+   double_sizes = new long long[ num_double_slots * num_threads ];
+   for ( int cnt = 0; cnt < num_double_slots * num_threads; cnt++ ){
+      doubles[ cnt ]      = NULL;
+      double_sizes[ cnt ] = 0;
+   }
+
+   ints      = new int*[ num_int_slots * num_threads ];
+   int_sizes = new long long[ num_int_slots * num_threads ];
+   for ( int cnt = 0; cnt < num_int_slots * num_threads; cnt++ ){
+      ints[ cnt ]      = NULL;
+      int_sizes[ cnt ] = 0;
+   }
+
+}
+
+CheMPS2::Workspace::~Workspace(){
+
+   release();
+   delete [] doubles;
+   delete [] double_sizes;
+   delete [] ints;
+   delete [] int_sizes;
+
+}
+
+int CheMPS2::Workspace::thread() const{
+
+   #ifdef _OPENMP
+   const int th = omp_get_thread_num();
+   #else
+   const int th = 0;
+   #endif
+   assert( th < num_threads );
+   return th;
+
+}
+
+double * CheMPS2::Workspace::get_double( const int slot, const long long size ){
+
+   assert(( slot >= 0 ) && ( slot < num_double_slots ));
+   const int index = slot + num_double_slots * thread();
+   if ( double_sizes[ index ] < size ){
+      if ( doubles[ index ] != NULL ){ delete [] doubles[ index ]; }
+      doubles[ index ]      = new double[ size ];
+      double_sizes[ index ] = size;
+   }
+   return doubles[ index ];
+
+}
+
+int * CheMPS2::Workspace::get_int( const int slot, const long long size ){
+
+   assert(( slot >= 0 ) && ( slot < num_int_slots ));
+   const int index = slot + num_int_slots * thread();
+   if ( int_sizes[ index ] < size ){
+      if ( ints[ index ] != NULL ){ delete [] ints[ index ]; }
+      ints[ index ]      = new int[ size ];
+      int_sizes[ index ] = size;
+   }
+   return ints[ index ];
+
+}
+
+void CheMPS2::Workspace::release(){
+
+   for ( int cnt = 0; cnt < num_double_slots * num_threads; cnt++ ){
+      if ( doubles[ cnt ] != NULL ){ delete [] doubles[ cnt ]; }
+      doubles[ cnt ]      = NULL;
+      double_sizes[ cnt ] = 0;
+   }
+   for ( int cnt = 0; cnt < num_int_slots * num_threads; cnt++ ){
+      if ( ints[ cnt ] != NULL ){ delete [] ints[ cnt ]; }
+      ints[ cnt ]      = NULL;
+      int_sizes[ cnt ] = 0;
+   }
+
+}
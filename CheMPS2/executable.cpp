@@ -312,6 +312,12 @@ cout << "\n"
 "       SWEEP_DVDSON_RTOL = flt, flt, flt\n"
 "              Set the residual norm tolerance for the Davidson algorithm for the successive sweep instructions (positive floats).\n"
 "\n"
+"       SWEEP_SITES = int, int, int\n"
+"              Set the number of sites (1 or 2) which are optimized together for the successive sweep instructions (default 2 for all instructions).\n"
+"\n"
+"       SWEEP_EXPANSION = flt, flt, flt\n"
+"              Set the subspace expansion prefactors for the successive one-site sweep instructions (non-negative floats) (default 1e-4 for all instructions).\n"
+"\n"
 "       NOCC = int, int, int, int\n"
 "              Set the number of occupied (external core) orbitals per irrep (psi4 irrep ordering).\n"
 "\n"
@@ -375,12 +381,33 @@ cout << "\n"
 "       CASPT2_CUMUL = bool\n"
 "              Use a cumulant approximation for the CASPT2 4-RDM and overwrite CASPT2_CHECKPT to FALSE (TRUE or FALSE; default FALSE).\n"
 "\n"
+"       CASPT2_OOC = bool\n"
+"              Store the CASPT2 vectors as memory-mapped files in TMP_FOLDER instead of in memory, and solve the CASPT2 equation with conjugate gradient (TRUE or FALSE; default FALSE).\n"
+"\n"
+"       CASPT2_SCAN_IMAG = flt, flt, flt\n"
+"              Additional imaginary level shifts for which the CASPT2 energy is calculated. They are solved together with CASPT2_IMAG in one shared subspace, at roughly the cost of a single solution (default none; zeros if only CASPT2_SCAN_REAL is specified).\n"
+"\n"
+"       CASPT2_SCAN_REAL = flt, flt, flt\n"
+"              Additional real level shifts for which the CASPT2 energy is calculated, paired with the values in CASPT2_SCAN_IMAG (default none; zeros if only CASPT2_SCAN_IMAG is specified).\n"
+"\n"
 "       PRINT_CORR = bool\n"
 "              Print correlation functions (TRUE or FALSE; default FALSE).\n"
 "\n"
 "       TMP_FOLDER = /path/to/tmp/folder\n"
 "              Overwrite the tmp folder for the renormalized operators. With MPI, separate folders per process can (but do not have to) be used (default /tmp).\n"
 "\n"
+"       MEM_BUDGET = flt\n"
+"              Memory budget in MB for the renormalized operators (per process with MPI). The least recently used boundaries which do not fit are stored in TMP_FOLDER. With 0.0 only the boundaries for the current sites are kept in memory, and with a negative value all boundaries are kept in memory (default 0.0).\n"
+"\n"
+"       TMP_FORMAT = char\n"
+"              File format for the renormalized operators in TMP_FOLDER: HDF5 (H) or memory-mapped flat files (M) (default H).\n"
+"\n"
+"       TMP_DEFLATE = int\n"
+"              Shuffle + deflate level (1-9) for the renormalized operators in HDF5 files; 0 stores them uncompressed (default 0).\n"
+"\n"
+"       TMP_LOSSY = int\n"
+"              If larger than 0, the renormalized operators in HDF5 files are rounded to this number of decimals before compression; requires TMP_DEFLATE > 0 (default 0).\n"
+"\n"
 "   EXAMPLE\n"
 "       $ cd /tmp\n"
 "       $ wget \'https://github.com/SebWouters/CheMPS2/raw/master/tests/matrixelements/N2.CCPVDZ.FCIDUMP\'\n"
@@ -420,6 +447,8 @@ int main( int argc, char ** argv ){
    string sweep_maxit  = "";
    string sweep_noise  = "";
    string sweep_rtol   = "";
+   string sweep_sites  = "";
+   string sweep_expan  = "";
 
    string nocc = "";
    string nact = "";
@@ -445,9 +474,16 @@ int main( int argc, char ** argv ){
    double caspt2_imag    = 0.0;
    bool   caspt2_checkpt = false;
    bool   caspt2_cumul   = false;
+   bool   caspt2_ooc     = false;
+   string caspt2_scan_imag = "";
+   string caspt2_scan_real = "";
 
    bool   print_corr = false;
    string tmp_folder = "/tmp";
+   double mem_budget = CheMPS2::DMRG_OPERATOR_memory_budget;
+   char   tmp_format = CheMPS2::DMRG_OPERATOR_storage;
+   int    tmp_deflate = CheMPS2::DMRG_OPERATOR_deflate_level;
+   int    tmp_lossy   = CheMPS2::DMRG_OPERATOR_lossy_digits;
 
    struct option long_options[] =
    {
@@ -539,17 +575,22 @@ int main( int argc, char ** argv ){
       if ( find_integer( &nelectrons,   line, "NELECTRONS",   true, 2, false, -1 ) == false ){ return clean_exit( -1 ); }
       if ( find_integer( &irrep,        line, "IRREP",        true, 0, true,   7 ) == false ){ return clean_exit( -1 ); }
       if ( find_integer( &excitation,   line, "EXCITATION",   true, 0, false, -1 ) == false ){ return clean_exit( -1 ); }
+      if ( find_integer( &tmp_deflate,  line, "TMP_DEFLATE",  true, 0, true,   9 ) == false ){ return clean_exit( -1 ); }
+      if ( find_integer( &tmp_lossy,    line, "TMP_LOSSY",    true, 0, false, -1 ) == false ){ return clean_exit( -1 ); }
       if ( find_integer( &scf_max_iter, line, "SCF_MAX_ITER", true, 1, false, -1 ) == false ){ return clean_exit( -1 ); }
 
       if ( find_double( &scf_diis_thr, line, "SCF_DIIS_THR", true, 0.0 ) == false ){ return clean_exit( -1 ); }
       if ( find_double( &scf_grad_thr, line, "SCF_GRAD_THR", true, 0.0 ) == false ){ return clean_exit( -1 ); }
       if ( find_double( &caspt2_ipea,  line, "CASPT2_IPEA",  true, 0.0 ) == false ){ return clean_exit( -1 ); }
       if ( find_double( &caspt2_imag,  line, "CASPT2_IMAG",  true, 0.0 ) == false ){ return clean_exit( -1 ); }
+      if ( find_double( &mem_budget,   line, "MEM_BUDGET",  false, 0.0 ) == false ){ return clean_exit( -1 ); }
 
       char options1[] = { 'I', 'N', 'L', 'F' };
       char options2[] = { 'A', 'P' };
+      char options3[] = { 'H', 'M' };
       if ( find_character( &scf_active_space, line, "SCF_ACTIVE_SPACE", options1, 4 ) == false ){ return clean_exit( -1 ); }
       if ( find_character( &caspt2_orbs,      line, "CASPT2_ORBS",      options2, 2 ) == false ){ return clean_exit( -1 ); }
+      if ( find_character( &tmp_format,       line, "TMP_FORMAT",       options3, 2 ) == false ){ return clean_exit( -1 ); }
 
       if ( find_boolean( &molcas_reorder, line, "MOLCAS_REORDER" ) == false ){ return clean_exit( -1 ); }
       if ( find_boolean( &molcas_mps,     line, "MOLCAS_MPS"     ) == false ){ return clean_exit( -1 ); }
@@ -557,6 +598,7 @@ int main( int argc, char ** argv ){
       if ( find_boolean( &caspt2_calc,    line, "CASPT2_CALC"    ) == false ){ return clean_exit( -1 ); }
       if ( find_boolean( &caspt2_checkpt, line, "CASPT2_CHECKPT" ) == false ){ return clean_exit( -1 ); }
       if ( find_boolean( &caspt2_cumul,   line, "CASPT2_CUMUL"   ) == false ){ return clean_exit( -1 ); }
+      if ( find_boolean( &caspt2_ooc,     line, "CASPT2_OOC"     ) == false ){ return clean_exit( -1 ); }
       if ( find_boolean( &print_corr,     line, "PRINT_CORR"     ) == false ){ return clean_exit( -1 ); }
 
       if ( line.find( "SWEEP_STATES" ) != string::npos ){
@@ -584,6 +626,26 @@ int main( int argc, char ** argv ){
          sweep_rtol = line.substr( pos, line.length() - pos );
       }
 
+      if ( line.find( "SWEEP_SITES" ) != string::npos ){
+         const int pos = line.find( "=" ) + 1;
+         sweep_sites = line.substr( pos, line.length() - pos );
+      }
+
+      if ( line.find( "SWEEP_EXPANSION" ) != string::npos ){
+         const int pos = line.find( "=" ) + 1;
+         sweep_expan = line.substr( pos, line.length() - pos );
+      }
+
+      if ( line.find( "CASPT2_SCAN_IMAG" ) != string::npos ){
+         const int pos = line.find( "=" ) + 1;
+         caspt2_scan_imag = line.substr( pos, line.length() - pos );
+      }
+
+      if ( line.find( "CASPT2_SCAN_REAL" ) != string::npos ){
+         const int pos = line.find( "=" ) + 1;
+         caspt2_scan_real = line.substr( pos, line.length() - pos );
+      }
+
       if ( line.find( "NOCC" ) != string::npos ){
          const int pos = line.find( "=" ) + 1;
          nocc = line.substr( pos, line.length() - pos );
@@ -666,7 +728,9 @@ int main( int argc, char ** argv ){
    const int ni_maxit = count( sweep_maxit.begin(),  sweep_maxit.end(),  ',' ) + 1;
    const int ni_noise = count( sweep_noise.begin(),  sweep_noise.end(),  ',' ) + 1;
    const int ni_rtol  = count( sweep_rtol.begin(),   sweep_rtol.end(),   ',' ) + 1;
-   const bool num_eq  = (( ni_d == ni_econv ) && ( ni_d == ni_maxit ) && ( ni_d == ni_noise ) && ( ni_d == ni_rtol ));
+   const int ni_sites = (( sweep_sites.length() == 0 ) ? ni_d : count( sweep_sites.begin(), sweep_sites.end(), ',' ) + 1 );
+   const int ni_expan = (( sweep_expan.length() == 0 ) ? ni_d : count( sweep_expan.begin(), sweep_expan.end(), ',' ) + 1 );
+   const bool num_eq  = (( ni_d == ni_econv ) && ( ni_d == ni_maxit ) && ( ni_d == ni_noise ) && ( ni_d == ni_rtol ) && ( ni_d == ni_sites ) && ( ni_d == ni_expan ));
 
    if ( num_eq == false ){
       if ( am_i_master ){ cerr << "The number of instructions in SWEEP_* should be equal!" << endl; }
@@ -678,6 +742,41 @@ int main( int argc, char ** argv ){
    int    * value_maxit  = new int   [ ni_d ];    fetch_ints( sweep_maxit,  value_maxit,  ni_d );
    double * value_noise  = new double[ ni_d ]; fetch_doubles( sweep_noise,  value_noise,  ni_d );
    double * value_rtol   = new double[ ni_d ]; fetch_doubles( sweep_rtol,   value_rtol,   ni_d );
+   int    * value_sites  = new int   [ ni_d ];
+   double * value_expan  = new double[ ni_d ];
+   for ( int cnt = 0; cnt < ni_d; cnt++ ){
+      value_sites[ cnt ] = 2;
+      value_expan[ cnt ] = CheMPS2::DMRG_expansion_prefactor;
+   }
+   if ( sweep_sites.length() > 0 ){ fetch_ints( sweep_sites, value_sites, ni_d ); }
+   if ( sweep_expan.length() > 0 ){ fetch_doubles( sweep_expan, value_expan, ni_d ); }
+   for ( int cnt = 0; cnt < ni_d; cnt++ ){
+      if ((( value_sites[ cnt ] != 1 ) && ( value_sites[ cnt ] != 2 )) || ( value_expan[ cnt ] < 0.0 )){
+         if ( am_i_master ){ cerr << "SWEEP_SITES should be 1 or 2 and SWEEP_EXPANSION should be non-negative!" << endl; }
+         return clean_exit( -1 );
+      }
+   }
+
+   /*************************************
+   *  Check the CASPT2 level shift scan  *
+   **************************************/
+
+   const int ni_scan_imag = (( caspt2_scan_imag.length() == 0 ) ? 0 : count( caspt2_scan_imag.begin(), caspt2_scan_imag.end(), ',' ) + 1 );
+   const int ni_scan_real = (( caspt2_scan_real.length() == 0 ) ? 0 : count( caspt2_scan_real.begin(), caspt2_scan_real.end(), ',' ) + 1 );
+   if (( ni_scan_imag > 0 ) && ( ni_scan_real > 0 ) && ( ni_scan_imag != ni_scan_real )){
+      if ( am_i_master ){ cerr << "The number of values in CASPT2_SCAN_IMAG and CASPT2_SCAN_REAL should be equal!" << endl; }
+      return clean_exit( -1 );
+   }
+   const int ni_scan = max( ni_scan_imag, ni_scan_real );
+   double * value_scan_imag = new double[ ni_scan + 1 ];
+   double * value_scan_real = new double[ ni_scan + 1 ];
+   double * value_scan_e2   = new double[ ni_scan + 1 ];
+   for ( int cnt = 0; cnt < ni_scan; cnt++ ){
+      value_scan_imag[ cnt ] = 0.0;
+      value_scan_real[ cnt ] = 0.0;
+   }
+   if ( ni_scan_imag > 0 ){ fetch_doubles( caspt2_scan_imag, value_scan_imag, ni_scan ); }
+   if ( ni_scan_real > 0 ){ fetch_doubles( caspt2_scan_real, value_scan_real, ni_scan ); }
 
    /*****************************************
    *  Check the active space specification  *
@@ -741,6 +840,8 @@ int main( int argc, char ** argv ){
       cout << "   SWEEP_MAX_SWEEPS   = [ " << value_maxit [ 0 ]; for ( int cnt = 1; cnt < ni_d; cnt++ ){ cout << " ; " << value_maxit [ cnt ]; } cout << " ]" << endl;
       cout << "   SWEEP_NOISE_PREFAC = [ " << value_noise [ 0 ]; for ( int cnt = 1; cnt < ni_d; cnt++ ){ cout << " ; " << value_noise [ cnt ]; } cout << " ]" << endl;
       cout << "   SWEEP_DVDSON_RTOL  = [ " << value_rtol  [ 0 ]; for ( int cnt = 1; cnt < ni_d; cnt++ ){ cout << " ; " << value_rtol  [ cnt ]; } cout << " ]" << endl;
+      cout << "   SWEEP_SITES        = [ " << value_sites [ 0 ]; for ( int cnt = 1; cnt < ni_d; cnt++ ){ cout << " ; " << value_sites [ cnt ]; } cout << " ]" << endl;
+      cout << "   SWEEP_EXPANSION    = [ " << value_expan [ 0 ]; for ( int cnt = 1; cnt < ni_d; cnt++ ){ cout << " ; " << value_expan [ cnt ]; } cout << " ]" << endl;
       cout << "   NOCC               = [ " << nocc_parsed[ 0 ]; for ( int cnt = 1; cnt < num_irreps; cnt++ ){ cout << " ; " << nocc_parsed[ cnt ]; } cout << " ]" << endl;
       cout << "   NACT               = [ " << nact_parsed[ 0 ]; for ( int cnt = 1; cnt < num_irreps; cnt++ ){ cout << " ; " << nact_parsed[ cnt ]; } cout << " ]" << endl;
       cout << "   NVIR               = [ " << nvir_parsed[ 0 ]; for ( int cnt = 1; cnt < num_irreps; cnt++ ){ cout << " ; " << nvir_parsed[ cnt ]; } cout << " ]" << endl;
@@ -766,9 +867,18 @@ int main( int argc, char ** argv ){
       cout << "   CASPT2_IMAG        = " << caspt2_imag << endl;
       cout << "   CASPT2_CHECKPT     = " << (( caspt2_checkpt ) ? "TRUE" : "FALSE" ) << endl;
       cout << "   CASPT2_CUMUL       = " << (( caspt2_cumul   ) ? "TRUE" : "FALSE" ) << endl;
+      cout << "   CASPT2_OOC         = " << (( caspt2_ooc     ) ? "TRUE" : "FALSE" ) << endl;
+      if ( ni_scan > 0 ){
+      cout << "   CASPT2_SCAN_IMAG   = [ " << value_scan_imag[ 0 ]; for ( int cnt = 1; cnt < ni_scan; cnt++ ){ cout << " ; " << value_scan_imag[ cnt ]; } cout << " ]" << endl;
+      cout << "   CASPT2_SCAN_REAL   = [ " << value_scan_real[ 0 ]; for ( int cnt = 1; cnt < ni_scan; cnt++ ){ cout << " ; " << value_scan_real[ cnt ]; } cout << " ]" << endl;
+      }
    }
       cout << "   PRINT_CORR         = " << (( print_corr     ) ? "TRUE" : "FALSE" ) << endl;
       cout << "   TMP_FOLDER         = " << tmp_folder << endl;
+      cout << "   MEM_BUDGET         = " << mem_budget << endl;
+      cout << "   TMP_FORMAT         = " << (( tmp_format == 'H' ) ? "H : HDF5" : "M : memory-mapped flat files" ) << endl;
+      cout << "   TMP_DEFLATE        = " << tmp_deflate << endl;
+      cout << "   TMP_LOSSY          = " << tmp_lossy << endl;
       cout << " " << endl;
    }
 
@@ -785,12 +895,15 @@ int main( int argc, char ** argv ){
                                           value_maxit [ count ],
                                           value_noise [ count ],
                                           value_rtol  [ count ] );
+      opt_scheme->set_one_site( count, ( value_sites[ count ] == 1 ), value_expan[ count ] );
    }
    delete [] value_states;
    delete [] value_econv;
    delete [] value_maxit;
    delete [] value_noise;
    delete [] value_rtol;
+   delete [] value_sites;
+   delete [] value_expan;
 
    if ( full_active_space_calculation ){
 
@@ -816,7 +929,7 @@ int main( int argc, char ** argv ){
          delete [] dmrg2ham;
       }
 
-      CheMPS2::DMRG * dmrgsolver = new CheMPS2::DMRG( prob, opt_scheme, molcas_mps, tmp_folder );
+      CheMPS2::DMRG * dmrgsolver = new CheMPS2::DMRG( prob, opt_scheme, molcas_mps, tmp_folder, mem_budget, tmp_format, tmp_deflate, tmp_lossy );
 
       // Solve for the correct root
       double DMRG_ENERGY;
@@ -834,30 +947,31 @@ int main( int argc, char ** argv ){
          if ( molcas_2rdm.length() != 0 ){ dmrgsolver->get2DM()->save_HAM( molcas_2rdm ); }
          if ( molcas_3rdm.length() != 0 ){ dmrgsolver->get3DM()->save_HAM( molcas_3rdm ); }
          if ( molcas_f4rdm.length() != 0 ){
-            const int LAS      = ham->getL();
-            const int LAS_pow6 = LAS * LAS * LAS * LAS * LAS * LAS;
+            const int LAS = ham->getL();
+            int * irreps  = new int[ LAS ];
+            for ( int orb = 0; orb < LAS; orb++ ){ irreps[ orb ] = ham->getOrbitalIrrep( orb ); }
             double * fockmx = new double[ LAS * LAS ];
-            double * work   = new double[ LAS_pow6  ];
-            double * result = new double[ LAS_pow6  ];
-            for ( int cnt = 0; cnt < LAS_pow6; cnt++ ){ result[ cnt ] = 0.0; }
+            CheMPS2::SixIndex * work   = new CheMPS2::SixIndex( LAS, irreps );
+            CheMPS2::SixIndex * result = new CheMPS2::SixIndex( LAS, irreps );
             ham->readfock( molcas_fock, fockmx, true );
-            CheMPS2::CASSCF::fock_dot_4rdm( fockmx, dmrgsolver, ham, 0, 0, work, result, false, false );
-            CheMPS2::ThreeDM::save_HAM_generic( molcas_f4rdm, LAS, "F.4-RDM", result );
+            CheMPS2::CASSCF::fock_dot_4rdm( fockmx, dmrgsolver, ham, NULL, work, result, false, false );
+            CheMPS2::ThreeDM::save_HAM_generic( molcas_f4rdm, "F.4-RDM", result );
+            delete [] irreps;
             delete [] fockmx;
-            delete [] work;
-            delete [] result;
+            delete work;
+            delete result;
          }
          if ( print_corr ){ dmrgsolver->getCorrelations()->Print(); }
       }
 
       // Clean up
-      if ( CheMPS2::DMRG_storeRenormOptrOnDisk ){ dmrgsolver->deleteStoredOperators(); }
+      dmrgsolver->deleteStoredOperators();
       delete dmrgsolver;
       delete prob;
 
    } else {
 
-      CheMPS2::CASSCF koekoek( ham, NULL, NULL, nocc_parsed, nact_parsed, nvir_parsed, tmp_folder );
+      CheMPS2::CASSCF koekoek( ham, NULL, NULL, nocc_parsed, nact_parsed, nvir_parsed, tmp_folder, mem_budget, tmp_format, tmp_deflate, tmp_lossy );
 
       const int root_num = excitation + 1;
       CheMPS2::DMRGSCFoptions * scf_options = new CheMPS2::DMRGSCFoptions();
@@ -874,13 +988,17 @@ int main( int argc, char ** argv ){
       if ( scf_active_space == 'F' ){ scf_options->setWhichActiveSpace( 3 ); }
       scf_options->setDumpCorrelations( print_corr );
       scf_options->setStartLocRandom( true );
+      scf_options->setCASPT2OutOfCore( caspt2_ooc );
 
       const double E_CASSCF = koekoek.solve( nelectrons, multiplicity - 1, irrep, opt_scheme, root_num, scf_options );
       double E_CASPT2 = 0.0;
       if ( caspt2_calc ){
-         E_CASPT2 = koekoek.caspt2( nelectrons, multiplicity - 1, irrep, opt_scheme, root_num, scf_options, caspt2_ipea, caspt2_imag, ( caspt2_orbs == 'P' ), caspt2_checkpt, caspt2_cumul );
+         E_CASPT2 = koekoek.caspt2( nelectrons, multiplicity - 1, irrep, opt_scheme, root_num, scf_options, caspt2_ipea, caspt2_imag, ( caspt2_orbs == 'P' ), caspt2_checkpt, caspt2_cumul, ni_scan, value_scan_imag, value_scan_real, value_scan_e2 );
          if ( am_i_master ){
             cout << "E_CASSCF + E_CASPT2 = E_0 + E_1 + E_2 = " << E_CASSCF + E_CASPT2 << endl;
+            for ( int cnt = 0; cnt < ni_scan; cnt++ ){
+               cout << "CASPT2 scan : Imaginary shift = " << value_scan_imag[ cnt ] << " ; Real shift = " << value_scan_real[ cnt ] << " ; E_CASSCF + E_CASPT2 = " << E_CASSCF + value_scan_e2[ cnt ] << endl;
+            }
          }
       }
 
@@ -905,6 +1023,9 @@ int main( int argc, char ** argv ){
    delete [] nocc_parsed;
    delete [] nact_parsed;
    delete [] nvir_parsed;
+   delete [] value_scan_imag;
+   delete [] value_scan_real;
+   delete [] value_scan_e2;
    delete opt_scheme;
    delete ham;
 
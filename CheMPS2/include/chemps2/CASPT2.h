@@ -20,9 +20,13 @@
 #ifndef CASPT2_CHEMPS2_H
 #define CASPT2_CHEMPS2_H
 
+#include <string>
+
 #include "DMRGSCFindices.h"
 #include "DMRGSCFintegrals.h"
 #include "DMRGSCFmatrix.h"
+#include "SixIndex.h"
+#include "Options.h"
 
 #define CHEMPS2_CASPT2_A         0
 #define CHEMPS2_CASPT2_B_SINGLET 1
@@ -70,20 +74,29 @@ namespace CheMPS2{
              \param fock     The fock matrix of CASPT2, in pseudocanonical orbitals
              \param one_dm   The spin-summed one-particle density matrix one_dm[i+L*j] = sum_sigma < a^+_i,sigma a_j,sigma > (with L the number DMRG orbitals), in pseudocanonical orbitals
              \param two_dm   The spin-summed two-particle density matrix two_dm[i+L*(j+L*(k+L*l))] = sum_sigma,tau < a^+_i,sigma a^+_j,tau a_l,tau a_k,sigma > (with L the number DMRG orbitals), in pseudocanonical orbitals
-             \param three_dm The spin-summed three-particle density matrix three_dm[i+L*(j+L*(k+L*(l+L*(m+L*n))))] = sum_z,tau,s < a^+_{i,z} a^+_{j,tau} a^+_{k,s} a_{n,s} a_{m,tau} a_{l,z} > (with L the number DMRG orbitals), in pseudocanonical orbitals
-             \param contract The spin-summed four-particle density matrix contracted with the fock operator contract[i+L*(j+L*(k+L*(p+L*(q+L*r))))] = sum_{t,sigma,tau,s} fock(t,t) < a^+_{i,sigma} a^+_{j,tau} a^+_{k,s} E_{tt} a_{r,s} a_{q,tau} a_{p,sigma} > (with L the number DMRG orbitals), in pseudocanonical orbitals
-             \param IPEA     The CASPT2 IPEA shift from Ghigo, Roos and Malmqvist, Chemical Physics Letters 396, 142-149 (2004) */
-         CASPT2(DMRGSCFindices * idx, DMRGSCFintegrals * ints, DMRGSCFmatrix * oei, DMRGSCFmatrix * fock, double * one_dm, double * two_dm, double * three_dm, double * contract, const double IPEA);
+             \param three_dm The spin-summed three-particle density matrix three_dm->get(i,j,k,l,m,n) = sum_z,tau,s < a^+_{i,z} a^+_{j,tau} a^+_{k,s} a_{n,s} a_{m,tau} a_{l,z} > (with L the number DMRG orbitals), in pseudocanonical orbitals
+             \param contract The spin-summed four-particle density matrix contracted with the fock operator contract->get(i,j,k,p,q,r) = sum_{t,sigma,tau,s} fock(t,t) < a^+_{i,sigma} a^+_{j,tau} a^+_{k,s} E_{tt} a_{r,s} a_{q,tau} a_{p,sigma} > (with L the number DMRG orbitals), in pseudocanonical orbitals
+             \param IPEA     The CASPT2 IPEA shift from Ghigo, Roos and Malmqvist, Chemical Physics Letters 396, 142-149 (2004)
+             \param scratch  If empty, the CASPT2 vectors are kept in memory. Otherwise, the folder in which the CASPT2 vectors are stored out-of-core as memory-mapped files (see MmapVector.h) */
+         CASPT2(DMRGSCFindices * idx, DMRGSCFintegrals * ints, DMRGSCFmatrix * oei, DMRGSCFmatrix * fock, double * one_dm, double * two_dm, SixIndex * three_dm, SixIndex * contract, const double IPEA, const string scratch = "");
 
          //! Destructor
          virtual ~CASPT2();
 
          //! Solve for the CASPT2 energy (note that the IPEA shift has been set in the constructor)
          /** \param imag_shift The CASPT2 imaginary shift from Forsberg and Malmqvist, Chemical Physics Letters 274, 196-204 (1997)
-             \param CONJUGATE_GRADIENT If true (false), the conjugate gradient (Davidson) algorithm is used to solve the CASPT2 equation
+             \param CONJUGATE_GRADIENT If true (false), the conjugate gradient (Davidson) algorithm is used to solve the CASPT2 equation; out-of-core, the conjugate gradient algorithm is always used
              \return The CASPT2 variational correction energy */
          double solve( const double imag_shift, const bool CONJUGATE_GRADIENT = false ) const;
 
+         //! Solve for the CASPT2 energies of several level shifts at once, with one matrix-vector multiplication per iteration for all shifts (see MultiShiftSolver.h)
+         /** \param num_shifts      The number of shifts
+             \param imag_shifts     Array of length num_shifts with the imaginary shifts from Forsberg and Malmqvist, Chemical Physics Letters 274, 196-204 (1997)
+             \param real_shifts     Array of length num_shifts with the real level shifts from Roos and Andersson, Chemical Physics Letters 245, 215-223 (1995)
+             \param energies        Array of length num_shifts, in which the CASPT2 variational correction energies are stored
+             \param sector_energies If not NULL, array of length CHEMPS2_CASPT2_NUM_CASES * num_shifts, in which the non-variational energy of sector c for shift s is stored at sector_energies[ c + CHEMPS2_CASPT2_NUM_CASES * s ] */
+         void solve_shifts( const int num_shifts, const double * imag_shifts, const double * real_shifts, double * energies, double * sector_energies = NULL ) const;
+
          //! Return the vector length for the CASPT2 first order wavefunction (before diagonalization of the overlap matrix)
          /** \param idx The number of core, active, and virtual orbitals per irrep
              \return The vector length for the CASPT2 first order wavefunction (before diagonalization of the overlap matrix) */
@@ -104,10 +117,10 @@ namespace CheMPS2{
          double * two_rdm;
 
          // The active space 3-RDM (externally allocated and deleted)
-         double * three_rdm;
+         SixIndex * three_rdm;
 
          // The active space 4-RDM contracted with the Fock operator (externally allocated and deleted)
-         double * f_dot_4dm;
+         SixIndex * f_dot_4dm;
 
          // The active space 3-RDM contracted with the Fock operator (allocated and deleted in this class)
          double * f_dot_3dm;
@@ -125,7 +138,7 @@ namespace CheMPS2{
          void create_f_dots();
 
          // Calculate the total vector length and the partitioning of the vector in blocks
-         int vector_helper();
+         long long vector_helper();
 
          // Once make_S**() has been calles, these overlap matrices can be used to contruct the RHS of the linear problem
          void construct_rhs( const DMRGSCFmatrix * oei, const DMRGSCFintegrals * integrals );
@@ -140,10 +153,11 @@ namespace CheMPS2{
          // Helper functions for solve
          void add_shift( double * vector, double * result, double * diag_fock, const double shift, const int * normalizations ) const;
          double inproduct_vectors( double * first, double * second, const int * normalizations ) const;
-         void energy_per_sector( double * solution ) const;
+         void energy_per_sector( double * solution, double * energies ) const;
+         static void print_energy_per_sector( const double * energies );
 
-         // Variables for the partitioning of the vector in blocks
-         int * jump;
+         // Variables for the partitioning of the vector in blocks: block ( irrep, case ) starts at jump[ irrep + num_irreps * case ]
+         long long * jump;
          int * size_A;
          int * size_C;
          int * size_D;
@@ -158,16 +172,22 @@ namespace CheMPS2{
          int get_maxsize() const;
          static int jump_AC_active( const DMRGSCFindices * idx, const int irrep_t, const int irrep_u, const int irrep_v );
          static int jump_BF_active( const DMRGSCFindices * idx, const int irrep_t, const int irrep_u, const int ST );
-         static int shift_D_nonactive( const DMRGSCFindices * idx, const int irrep_i, const int irrep_a );
-         static int shift_B_nonactive( const DMRGSCFindices * idx, const int irrep_i, const int irrep_j, const int ST );
-         static int shift_F_nonactive( const DMRGSCFindices * idx, const int irrep_a, const int irrep_b, const int ST );
-         static int shift_E_nonactive( const DMRGSCFindices * idx, const int irrep_a, const int irrep_i, const int irrep_j, const int ST );
-         static int shift_G_nonactive( const DMRGSCFindices * idx, const int irrep_i, const int irrep_a, const int irrep_b, const int ST );
-         static int shift_H_nonactive( const DMRGSCFindices * idx, const int irrep_i, const int irrep_j, const int irrep_a, const int irrep_b, const int ST );
+         static long long shift_D_nonactive( const DMRGSCFindices * idx, const int irrep_i, const int irrep_a );
+         static long long shift_B_nonactive( const DMRGSCFindices * idx, const int irrep_i, const int irrep_j, const int ST );
+         static long long shift_F_nonactive( const DMRGSCFindices * idx, const int irrep_a, const int irrep_b, const int ST );
+         static long long shift_E_nonactive( const DMRGSCFindices * idx, const int irrep_a, const int irrep_i, const int irrep_j, const int ST );
+         static long long shift_G_nonactive( const DMRGSCFindices * idx, const int irrep_i, const int irrep_a, const int irrep_b, const int ST );
+         static long long shift_H_nonactive( const DMRGSCFindices * idx, const int irrep_i, const int irrep_j, const int irrep_a, const int irrep_b, const int ST );
+
+         // The scratch folder for out-of-core CASPT2 vectors; empty if the vectors are kept in memory
+         string scratch;
 
          // The RHS of the linear problem
          double * vector_rhs;
 
+         // Out-of-core, ask the kernel to read block ( irrep, case ) of two CASPT2 vectors ahead of its use; nothing happens in memory or for irrep >= num_irreps
+         void prefetch_block( const double * vector, const double * result, const int irrep, const int sector ) const;
+
          // Variables for the overlap (only allocated during creation of the CASPT2 object)
          double ** SAA;
          double ** SCC;
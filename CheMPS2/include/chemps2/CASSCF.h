@@ -172,8 +172,12 @@ namespace CheMPS2{
              \param nocc  Array containing the number of doubly occupied (inactive) orbitals per irrep
              \param ndmrg Array containing the number of active orbitals per irrep
              \param nvirt Array containing the number of virtual (secondary) orbitals per irrep
-             \param tmp_folder Temporary work folder for the DMRG renormalized operators and the ERI rotations */
-         CASSCF( Hamiltonian * ham_in, int * docc, int * socc, int * nocc, int * ndmrg, int * nvirt, const string tmp_folder=CheMPS2::defaultTMPpath );
+             \param tmp_folder Temporary work folder for the DMRG renormalized operators and the ERI rotations
+             \param mem_budget Memory budget in MB for the DMRG renormalized operators (see DMRG::DMRG)
+             \param storage File format for the DMRG renormalized operators: HDF5 ('H') or memory-mapped flat files ('M')
+             \param deflate_level Shuffle + deflate level for the DMRG renormalized operators in HDF5 files (see DMRG::DMRG)
+             \param lossy_digits Number of decimals for the lossy compression of the DMRG renormalized operators in HDF5 files (see DMRG::DMRG) */
+         CASSCF( Hamiltonian * ham_in, int * docc, int * socc, int * nocc, int * ndmrg, int * nvirt, const string tmp_folder=CheMPS2::defaultTMPpath, const double mem_budget=CheMPS2::DMRG_OPERATOR_memory_budget, const char storage=CheMPS2::DMRG_OPERATOR_storage, const int deflate_level=CheMPS2::DMRG_OPERATOR_deflate_level, const int lossy_digits=CheMPS2::DMRG_OPERATOR_lossy_digits );
          
          //! Destructor
          virtual ~CASSCF();
@@ -204,8 +208,12 @@ namespace CheMPS2{
              \param PSEUDOCANONICAL If true, use the exact DMRG 4-RDM in the pseudocanonical basis. If false, use the cumulant approximated DMRG 4-RDM in the unrotated basis.
              \param CHECKPOINT If true, write checkpoints to disk and read them back in again in order to perform the contraction of the generalized Fock operator with the 4-RDM in multiple runs.
              \param CUMULANT If true, a cumulant approximation is used for the 4-RDM and CHECKPOINT is overwritten to false. If false, the full 4-RDM is used.
-             \return The CASPT2 variational correction energy */
-         double caspt2( const int Nelectrons, const int TwoS, const int Irrep, ConvergenceScheme * OptScheme, const int rootNum, DMRGSCFoptions * scf_options, const double IPEA, const double IMAG, const bool PSEUDOCANONICAL, const bool CHECKPOINT = false, const bool CUMULANT = false );
+             \param NUM_SCAN The number of additional level shifts to scan. If larger than zero, IMAG and the scanned shifts are solved together with CASPT2::solve_shifts.
+             \param SCAN_IMAG Array of length NUM_SCAN with the imaginary shifts to scan
+             \param SCAN_REAL Array of length NUM_SCAN with the real level shifts to scan
+             \param SCAN_E2 Array of length NUM_SCAN, in which the CASPT2 variational correction energies of the scanned shifts are stored
+             \return The CASPT2 variational correction energy for the imaginary shift IMAG */
+         double caspt2( const int Nelectrons, const int TwoS, const int Irrep, ConvergenceScheme * OptScheme, const int rootNum, DMRGSCFoptions * scf_options, const double IPEA, const double IMAG, const bool PSEUDOCANONICAL, const bool CHECKPOINT = false, const bool CUMULANT = false, const int NUM_SCAN = 0, const double * SCAN_IMAG = NULL, const double * SCAN_REAL = NULL, double * SCAN_E2 = NULL );
 
          //! CASSCF unitary rotation remove call
          /* \param filename File to delete */
@@ -288,9 +296,9 @@ namespace CheMPS2{
              \param idx Object which handles the index conventions for CASSCF
              \param invert If true, the eigenvectors are sorted from large to small instead of the other way around
              \param two_dm   If not NULL, this 4-index array will be rotated to the new eigenvecs if space == 'A'
-             \param three_dm If not NULL, this 6-index array will be rotated to the new eigenvecs if space == 'A'
-             \param contract If not NULL, this 6-index array will be rotated to the new eigenvecs if space == 'A' */
-         static void block_diagonalize( const char space, const DMRGSCFmatrix * Mat, DMRGSCFunitary * Umat, double * work1, double * work2, const DMRGSCFindices * idx, const bool invert, double * two_dm, double * three_dm, double * contract );
+             \param three_dm If not NULL, this 6-index object will be rotated to the new eigenvecs if space == 'A'
+             \param contract If not NULL, this 6-index object will be rotated to the new eigenvecs if space == 'A' */
+         static void block_diagonalize( const char space, const DMRGSCFmatrix * Mat, DMRGSCFunitary * Umat, double * work1, double * work2, const DMRGSCFindices * idx, const bool invert, double * two_dm, SixIndex * three_dm, SixIndex * contract );
 
          //! Construct the Fock matrix
          /** \param Fock Matrix to store the Fock operator in
@@ -308,37 +316,41 @@ namespace CheMPS2{
 
          //! Write the checkpoint file for the contraction of the generalized Fock operator with the 4-RDM to disk
          /** \param f4rdm_file The filename
-             \param hamorb1 The next hamiltonian orbital 1
-             \param hamorb2 The next hamiltonian orbital 2
-             \param tot_dmrg_power6 The size of the array contract
-             \param contract The current partial contraction */
-         static void write_f4rdm_checkpoint( const string f4rdm_file, int * hamorb1, int * hamorb2, const int tot_dmrg_power6, double * contract );
+             \param LAS The number of active space orbitals
+             \param done Array of size LAS x LAS, with done[ orb1 + LAS * orb2 ] = 1 when the orbital pair ( orb1 <= orb2 ) is contained in contract, and 0 otherwise
+             \param contract The current partial contraction, which is stored symmetry-packed */
+         static void write_f4rdm_checkpoint( const string f4rdm_file, const int LAS, int * done, SixIndex * contract );
 
          //! Read the checkpoint file for the contraction of the generalized Fock operator with the 4-RDM from disk
          /** \param f4rdm_file The filename
-             \param hamorb1 The next hamiltonian orbital 1
-             \param hamorb2 The next hamiltonian orbital 2
-             \param tot_dmrg_power6 The size of the array contract
-             \param contract The current partial contraction
+             \param LAS The number of active space orbitals
+             \param done Array of size LAS x LAS, with done[ orb1 + LAS * orb2 ] = 1 when the orbital pair ( orb1 <= orb2 ) is contained in contract, and 0 otherwise. Checkpoints which contain the next orbital pair instead are converted.
+             \param contract The current partial contraction. Checkpoints with the dense contraction of size LAS^6 are converted.
              \return Whether the file was found and read */
-         static bool read_f4rdm_checkpoint( const string f4rdm_file, int * hamorb1, int * hamorb2, const int tot_dmrg_power6, double * contract );
+         static bool read_f4rdm_checkpoint( const string f4rdm_file, const int LAS, int * done, SixIndex * contract );
 
          //! Build the contraction of the fock matrix with the 4-RDM
-         /** \param fockmx Array of size ham->getL() x ham->getL() containing the Fock matrix elements
+         /** With MPI, the orbital pairs are distributed over the processes, which each work on their own copy of the MPS with all renormalized operators in their own memory ( see DMRG::setProcessLocal ). The partial contractions are added after the last pair, or after each round of pairs when a checkpoint is made.
+             \param fockmx Array of size ham->getL() x ham->getL() containing the Fock matrix elements
              \param dmrgsolver DMRG object which is solved, and for which the 2-RDM and 3-RDM have been calculated as well
              \param ham Active space Hamiltonian, which is needed for the size of the active space and the orbital irreps
-             \param next_orb1 The next first  orbital for which the contraction should be continued
-             \param next_orb2 The next second orbital for which the contraction should be continued
-             \param work Work array of size ham->getL()**6
-             \param result On entry, contains the partial contraction corresponding to (next_orb1, next_orb2). On exit, contains the full contraction.
+             \param done Array of size ham->getL() x ham->getL(), with done[ orb1 + ham->getL() * orb2 ] = 1 when the orbital pair ( orb1 <= orb2 ) is already contained in result, and 0 otherwise. NULL when no pairs are done.
+             \param work Work object with the orbital irreps of ham
+             \param result Object with the orbital irreps of ham. On entry, contains the partial contraction corresponding to done. On exit, contains the full contraction.
              \param CHECKPOINT Whether or not the standard CheMPS2 F.4-RDM checkpoint should be created/updated to continue the contraction at later times 
              \param PSEUDOCANONICAL Whether or not pseudocanonical orbitals are used in the active space */
-         static void fock_dot_4rdm( double * fockmx, CheMPS2::DMRG * dmrgsolver, CheMPS2::Hamiltonian * ham, int next_orb1, int next_orb2, double * work, double * result, const bool CHECKPOINT, const bool PSEUDOCANONICAL );
+         static void fock_dot_4rdm( double * fockmx, CheMPS2::DMRG * dmrgsolver, CheMPS2::Hamiltonian * ham, const int * done, SixIndex * work, SixIndex * result, const bool CHECKPOINT, const bool PSEUDOCANONICAL );
 
       private:
 
          // CASSCF tmp folder
          string tmp_folder;
+         
+         // Memory budget, file format, and compression for the DMRG renormalized operators
+         double mem_budget;
+         char storage;
+         int deflate_level;
+         int lossy_digits;
 
          // Index convention handler
          DMRGSCFindices * iHandler;
@@ -393,7 +405,10 @@ namespace CheMPS2{
          static void augmented_hessian( DMRGSCFmatrix * Fmatrix, DMRGSCFwtilde * Wtilde, const DMRGSCFindices * idx, double * origin, double * target, double * gradient, const int linsize );
 
          // Rotate an active space object
-         static void rotate_active_space_object( const int num_indices, double * object, double * work, double * rotation, const int LAS, const int NJUMP, const int NROTATE );
+         static void rotate_active_space_object( const int num_indices, double * object, double * work, const long long work_size, double * rotation, const int LAS, const int NJUMP, const int NROTATE );
+
+         // Rotate a 6-index object slice per slice, with packed of size object->get_array_size(), and slice and work of size LAS^5
+         static void rotate_six_index_object( SixIndex * object, double * packed, double * slice, double * work, double * rotation, const int NJUMP, const int NROTATE );
 
          // Fmat function as defined by Eq. (11) in the Siegbahn paper.
          DMRGSCFmatrix * theFmatrix;
@@ -20,6 +20,8 @@
 #ifndef CONJUGATEGRADIENT_CHEMPS2_H
 #define CONJUGATEGRADIENT_CHEMPS2_H
 
+#include <string>
+
 namespace CheMPS2{
 /** Conjugate gradient class.
     \author Sebastian Wouters <sebastianwouters@gmail.com>
@@ -42,8 +44,9 @@ namespace CheMPS2{
          /** \param veclength_in Linear dimension of the symmetric matrix
              \param RTOL_in The tolerance for the two-norm of the residual
              \param DIAG_CUTOFF_in The cutoff to truncate the diagonal elements of operator
-             \param print_in Whether or not to print */
-         ConjugateGradient(const int veclength_in, const double RTOL_in, const double DIAG_CUTOFF_in, const bool print_in);
+             \param print_in Whether or not to print
+             \param scratch_in If empty, the helper vectors are kept in memory. Otherwise, the folder in which the helper vectors are stored out-of-core as memory-mapped files (see MmapVector.h) */
+         ConjugateGradient(const long long veclength_in, const double RTOL_in, const double DIAG_CUTOFF_in, const bool print_in, const std::string scratch_in = "");
 
          //! Destructor
          virtual ~ConjugateGradient();
@@ -59,7 +62,8 @@ namespace CheMPS2{
 
       private:
 
-         int veclength;
+         long long veclength;
+         std::string scratch;
          double RTOL;
          double DIAG_CUTOFF;
          bool print;
@@ -37,7 +37,11 @@ namespace CheMPS2{
     The noise level which is added to the Sobject is the product of\n
     (1) f\n
     (2) the maximum discarded weight during the last sweep\n
-    (3) a random number in the interval [-0.5,0.5]*/
+    (3) a random number in the interval [-0.5,0.5]\n
+    \n
+    By default an instruction performs two-site sweeps. With set_one_site() an instruction can be switched to one-site sweeps, which keep the Davidson vectors a factor of 4 smaller. The one-site effective Hamiltonian acts on a single MPS tensor, and its matrix-vector product is cheaper than a two-site one by about a factor d = 4. The bond dimension then grows by subspace expansion: before the bond in the sweep direction is truncated, the reduced density matrix of the site is enlarged with alpha^2 times the terms of the Hamiltonian which act with a single 2nd quantized operator across that bond, with alpha the expansion prefactor. Instructions fall back to two-site sweeps when excited states are calculated.\n
+    \n
+    With set_truncation() an instruction keeps, at each bond, the smallest number of states for which the discarded weight does not exceed a threshold, bounded from below by a minimum D and from above by the D of the instruction. Bonds near the ends of the chain and in weakly correlated regions then stay small, while the strongly entangled bonds get the largest D.*/
    class ConvergenceScheme{
 
       public:
@@ -72,6 +76,18 @@ namespace CheMPS2{
             set_instruction( instruction, D, energy_conv, max_sweeps, noise_prefactor, CheMPS2::DAVIDSON_DMRG_RTOL );
          }
 
+         //! Choose between one-site and two-site sweeps for an instruction
+         /** \param instruction the number of the instruction
+             \param one_site whether one-site (true) or two-site (false) sweeps are performed for that instruction
+             \param expansion_prefactor the prefactor alpha of the subspace expansion for that instruction; 0.0 means the bond dimensions are not adapted */
+         void set_one_site(const int instruction, const bool one_site, const double expansion_prefactor = CheMPS2::DMRG_expansion_prefactor);
+
+         //! Let the bond dimensions of an instruction adapt to a discarded weight threshold
+         /** \param instruction the number of the instruction
+             \param max_discarded_weight the maximum discarded weight per bond for that instruction; 0.0 means that the D of the instruction is kept
+             \param D_min the minimum number of renormalized states per bond for that instruction; the D of the instruction is the maximum */
+         void set_truncation(const int instruction, const double max_discarded_weight, const int D_min = 1);
+
          //! Get the number of renormalized states for a particular instruction
          /** \param instruction the number of the instruction
              \return the number of renormalized states for this instruction */
@@ -97,6 +113,26 @@ namespace CheMPS2{
              \return the Davidson residual tolerance for this instruction */
          double get_dvdson_rtol(const int instruction) const;
 
+         //! Get whether one-site sweeps are performed for a particular instruction
+         /** \param instruction the number of the instruction
+             \return whether one-site sweeps are performed for this instruction */
+         bool get_one_site(const int instruction) const;
+
+         //! Get the prefactor of the subspace expansion for a particular instruction
+         /** \param instruction the number of the instruction
+             \return the prefactor of the subspace expansion for this instruction */
+         double get_expansion_prefactor(const int instruction) const;
+
+         //! Get the maximum discarded weight per bond for a particular instruction
+         /** \param instruction the number of the instruction
+             \return the maximum discarded weight per bond for this instruction; 0.0 if the bond dimensions do not adapt */
+         double get_max_discarded_weight(const int instruction) const;
+
+         //! Get the minimum number of renormalized states per bond for a particular instruction
+         /** \param instruction the number of the instruction
+             \return the minimum number of renormalized states per bond for this instruction */
+         int get_D_min(const int instruction) const;
+
       private:
 
          //The number of instructions
@@ -117,6 +153,18 @@ namespace CheMPS2{
          //The Davidson residual tolerance for each instruction
          double * dvdson_rtol;
 
+         //Whether one-site sweeps are performed for each instruction
+         bool * one_site_sweeps;
+
+         //The prefactor of the subspace expansion for each instruction
+         double * expansion_prefac;
+
+         //The maximum discarded weight per bond for each instruction
+         double * max_disc_weight;
+
+         //The minimum number of renormalized states per bond for each instruction
+         int * num_D_min;
+
    };
 }
 
@@ -141,8 +141,8 @@ namespace CheMPS2{
              \param the3DM Pointer to the DMRG 3-RDM
              \param the2DM Pointer to the DMRG 2-RDM
              \param fock Contains the SYMMETRIC fock operator \f$ F_{ls} \f$ = fock[l+L*s] = fock[s+L*l]
-             \param result Contains the contraction: result[i+L*(j+L*(k+L*(p+L*(q+L*r))))] = \f$ \sum\limits_{ls} F_{ls} \Gamma^4_{ijklpqrs} \f$ */
-         static void gamma4_fock_contract_ham(const Problem * prob, const ThreeDM * the3DM, const TwoDM * the2DM, double * fock, double * result);
+             \param result SixIndex object with the orbital irreps of the problem, which contains the contraction: result->get(i,j,k,p,q,r) = \f$ \sum\limits_{ls} F_{ls} \Gamma^4_{ijklpqrs} \f$ */
+         static void gamma4_fock_contract_ham(const Problem * prob, const ThreeDM * the3DM, const TwoDM * the2DM, double * fock, SixIndex * result);
          
       private:
       
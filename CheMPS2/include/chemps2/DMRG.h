@@ -21,6 +21,7 @@
 #define DMRG_CHEMPS2_H
 
 #include <string>
+#include <pthread.h>
 
 #include "Options.h"
 #include "Problem.h"
@@ -42,9 +43,13 @@
 #include "ThreeDM.h"
 #include "Correlations.h"
 #include "Heff.h"
+#include "HeffOneSite.h"
 #include "Sobject.h"
 #include "ConvergenceScheme.h"
 #include "MyHDF5.h"
+#include "OperatorStorage.h"
+#include "Workspace.h"
+#include "MPIbalance.h"
 
 //For the timings of the different parts of DMRG
 #define CHEMPS2_TIME_S_JOIN      0
@@ -56,7 +61,9 @@
 #define CHEMPS2_TIME_DISK_WRITE  6
 #define CHEMPS2_TIME_DISK_READ   7
 #define CHEMPS2_TIME_TENS_CALC   8
-#define CHEMPS2_TIME_VECLENGTH   9
+#define CHEMPS2_TIME_DISK_WAIT   9
+#define CHEMPS2_TIME_MPI_WORK    10
+#define CHEMPS2_TIME_VECLENGTH   11
 
 namespace CheMPS2{
 /** DMRG class.
@@ -86,9 +93,13 @@ namespace CheMPS2{
          //! Constructor
          /** \param Probin The problem to be solved
              \param OptSchemeIn The optimization scheme for the DMRG sweeps
-             \param makechkpt Whether or not to save MPS checkpoints in the working directory
-             \param tmpfolder Temporary folder on a large partition to store the renormalized operators on disk (by default "/tmp") */
-         DMRG(Problem * Probin, ConvergenceScheme * OptSchemeIn, const bool makechkpt=CheMPS2::DMRG_storeMpsOnDisk, const string tmpfolder=CheMPS2::defaultTMPpath);
+             \param makechkpt Whether or not to save MPS checkpoints in the working directory. The checkpoint also contains the position in the ConvergenceScheme, and at most every CheMPS2::DMRG_RESTART_interval seconds a mid-sweep checkpoint is made, for which the renormalized operators are copied to tmpfolder. An interrupted Solve() then resumes at the checkpointed site without recomputing the renormalized operators, when the DMRG object is constructed with the same Problem, ConvergenceScheme, tmpfolder, and storage.
+             \param tmpfolder Temporary folder on a large partition to store the renormalized operators on disk (by default "/tmp")
+             \param mem_budget Memory budget in MB for the renormalized operators. The least recently used boundaries which do not fit are spilled to tmpfolder. With 0.0 only the boundaries required for the current site are kept in memory, and with a negative value all boundaries are kept in memory.
+             \param storage File format for the renormalized operators in tmpfolder: HDF5 ('H') or memory-mapped flat files ('M')
+             \param deflate_level Shuffle + deflate level (1-9) for the renormalized operators in HDF5 files; 0 stores them uncompressed
+             \param lossy_digits If > 0, the A, B, C, D, and Q operators in HDF5 files are rounded to this number of decimals (needs deflate_level > 0) */
+         DMRG(Problem * Probin, ConvergenceScheme * OptSchemeIn, const bool makechkpt=CheMPS2::DMRG_storeMpsOnDisk, const string tmpfolder=CheMPS2::defaultTMPpath, const double mem_budget=CheMPS2::DMRG_OPERATOR_memory_budget, const char storage=CheMPS2::DMRG_OPERATOR_storage, const int deflate_level=CheMPS2::DMRG_OPERATOR_deflate_level, const int lossy_digits=CheMPS2::DMRG_OPERATOR_lossy_digits);
          
          //! Destructor
          virtual ~DMRG();
@@ -100,6 +111,10 @@ namespace CheMPS2{
          //! Reconstruct the renormalized operators when you overwrite the matrix elements with Prob->setMxElement()
          void PreSolve();
          
+         //! Continue from the current MPS with another ConvergenceScheme, when the matrix elements of the Problem have been overwritten without changing the orbital ordering. Should be called after Solve() and before the next Solve(), which then starts with one sweep at the current virtual dimensions. The RDMs and correlations are cleared, and in a state-averaged calculation root 0 is put back in the MPS.
+         /** \param OptSchemeIn The ConvergenceScheme for the next Solve() */
+         void warmStart(ConvergenceScheme * OptSchemeIn);
+         
          //! Calculate the 2-RDM and correlations. Afterwards the MPS is again in LLLLLLLC gauge.
          void calc2DMandCorrelations(){ calc_rdms_and_correlations(false); }
          
@@ -123,6 +138,18 @@ namespace CheMPS2{
              \param last_case If true, everything will be set up to allow to continue sweeping. */
          void Symm4RDM( double * output, const int ham_orb1, const int ham_orb2, const bool last_case );
 
+         //! Obtain the symmetrized 4-RDM terms 0.5 * ( Gamma4_ijkl,pqrt + Gamma4_ijkt,pqrl ) with l and t fixed, after the 3-RDM has been calculated, in symmetry-packed storage.
+         /** \param output    SixIndex object with the orbital irreps of the problem, to store the symmetrized 4-RDM terms in Hamiltonian index notation: output->get( i, j, k, p, q, r ) = 0.5 * ( Gamma4_ijkl,pqrt + Gamma4_ijkt,pqrl ).
+             \param ham_orb1  The Hamiltonian index of the first  fixed orbital.
+             \param ham_orb2  The Hamiltonian index of the second fixed orbital.
+             \param last_case If true, everything will be set up to allow to continue sweeping. */
+         void Symm4RDM( SixIndex * output, const int ham_orb1, const int ham_orb2, const bool last_case );
+
+         //! With MPI, let each process continue on its own copy of the MPS, or let the processes share the renormalized operators again. All processes should call this function with the same argument.
+         /** While the processes work on their own, they can call Symm4RDM() for different orbitals, each with all renormalized operators in their own memory. The renormalized operators are deleted, hence PreSolve() is needed to continue sweeping. Without MPI, nothing happens.
+             \param local Whether each process should work on its own */
+         void setProcessLocal( const bool local );
+
          //! Get the pointer to the Correlations
          /** \return The Correlations. Returns a NULL pointer if not yet calculated. */
          Correlations * getCorrelations(){ return theCorr; }
@@ -139,10 +166,18 @@ namespace CheMPS2{
              \return The desired FCI coefficient */
          double getFCIcoefficient(int * alpha, int * beta, const bool mpi_chemps2_master_only=true) const;
          
-         //! Call "rm " + CheMPS2::DMRG_MPS_storage_prefix + "*.h5"
+         //! Call "rm " + CheMPS2::DMRG_MPS_storage_prefix + "*.h5", and remove the renormalized operators of the mid-sweep checkpoints
          void deleteStoredMPS();
          
-         //! Call "rm " + tempfolder + "/" + CheMPS2::DMRG_OPERATOR_storage_prefix + string(thePID) + "*.h5";
+         //! Set the minimum wall time between two mid-sweep checkpoints when MPS checkpoints are made
+         /** \param seconds The minimum wall time in seconds; 0.0 makes a checkpoint after every site, and a negative value disables mid-sweep checkpoints (by default CheMPS2::DMRG_RESTART_interval) */
+         void setCheckpointInterval(const double seconds);
+         
+         //! Set the vector length from which the Davidson vectors of the two-site effective Hamiltonian are distributed over the MPI processes; without MPI, nothing happens
+         /** \param size The minimum vector length (by default CheMPS2::DAVIDSON_MPI_DISTRIBUTE_size); 0 always distributes them when there are at least as many symmetry sectors as processes */
+         void setDavidsonDistributeSize(const long long size);
+         
+         //! Call "rm " + tempfolder + "/" + CheMPS2::DMRG_OPERATOR_storage_prefix + string(thePID) + "_index_*";
          void deleteStoredOperators();
          
          //! Activate the necessary storage and machinery to handle excitations
@@ -153,6 +188,20 @@ namespace CheMPS2{
          /** \param EshiftIn To the Hamiltonian, a level shift is introduced to exclude the previously calculated MPS: Hnew = Hold + EshiftIn * | prev> <prev| */
          void newExcitation(const double EshiftIn);
          
+         //! Activate the state-averaged optimization of the lowest roots in a single set of sweeps
+         /** All roots share the MPS site tensors and the renormalized operators, and only differ in the center tensor. The lowest roots of the two-site effective Hamiltonian are obtained in one Davidson run, and the virtual dimensions are determined by the state-averaged reduced density matrix with equal weights. Should be called before Solve(), which then returns the minimum state-averaged energy. Cannot be combined with activateExcitations(). As the roots share the virtual bases, the first instructions of the ConvergenceScheme should allow a virtual dimension which is sufficiently large for all roots: symmetry sectors which are truncated away for all roots are hard to recover in later sweeps.
+             \param num_roots The number of roots ( at least 2 ) */
+         void activateStateAveraging(const int num_roots);
+         
+         //! Get the energy of a root in a state-averaged calculation
+         /** \param root The root ( 0 is the lowest )
+             \return The energy of the root at the last optimized sites */
+         double getRootEnergy(const int root) const;
+         
+         //! Put a root of a state-averaged calculation in the MPS, so that calc_rdms_and_correlations(), Symm4RDM(), and getFCIcoefficient() refer to that root. Should be called after Solve().
+         /** \param root The root ( 0 is the lowest ) */
+         void selectRoot(const int root);
+         
          //! Print the license
          static void PrintLicense();
          
@@ -188,6 +237,19 @@ namespace CheMPS2{
          //Max. discarded weight of last sweep
          double MaxDiscWeightLastSweep;
          
+         //Discarded weight at each virtual bond during its last decomposition: DiscWeightBonds[ index ] for the bond between sites index - 1 and index
+         double * DiscWeightBonds;
+         
+         //Energy at each site during its last optimization, and the change of that energy with respect to the optimization before
+         double * SiteEnergies;
+         double * SiteEnergyChanges;
+         
+         //Number of Davidson matrix-vector multiplications during the last sweep and during the current instruction, and the range of the adaptive Davidson tolerances of the last sweep
+         long long NumMatvecLastSweep;
+         long long NumMatvecInstruction;
+         double MinRtolLastSweep;
+         double MaxRtolLastSweep;
+         
          //Symmetry information object
          SyBookkeeper * denBK;
          
@@ -203,6 +265,9 @@ namespace CheMPS2{
          //The Correlations
          Correlations * theCorr;
          
+         //The persistent per-thread work arrays of the effective Hamiltonian, the SVDs, the operator updates, and the 2-RDM and 3-RDM diagrams
+         Workspace * workspace;
+         
          //Whether or not allocated
          int * isAllocated;
          
@@ -257,31 +322,104 @@ namespace CheMPS2{
          // Sweeps
          double sweepleft(  const bool change, const int instruction, const bool am_i_master );
          double sweepright( const bool change, const int instruction, const bool am_i_master );
-         double solve_site( const int index, const double dvdson_rtol, const double noise_level, const int virtual_dimension, const bool am_i_master, const bool moving_right, const bool change );
+         double solve_site( const int index, const double dvdson_rtol, const double noise_level, const int virtual_dimension, const double max_disc_weight, const int min_dimension, const bool am_i_master, const bool moving_right, const bool change );
+         double sweepleft_onesite(  const bool change, const int instruction, const bool am_i_master );
+         double sweepright_onesite( const bool change, const int instruction, const bool am_i_master );
+         double solve_site_onesite( const int site, const double dvdson_rtol, const double noise_level, const int virtual_dimension, const double max_disc_weight, const int min_dimension, const double expansion_prefactor, const bool am_i_master, const bool moving_right, const bool change );
+         double solve_site_averaged( const int index, const double dvdson_rtol, const double noise_level, const int virtual_dimension, const double max_disc_weight, const int min_dimension, const bool am_i_master, const bool moving_right, const bool change );
+         void print_sweep_summary() const;
+         void start_sweep();
+         double adapt_rtol( const int site, const int bound, const double dvdson_rtol );
+         void track_site( const int site, const double energy );
 
          //Load and save functions
-         void MY_HDF5_WRITE_BATCH(const hid_t file_id, const int number, Tensor ** batch, const long long totalsize, const std::string tag);
-         void MY_HDF5_READ_BATCH( const hid_t file_id, const int number, Tensor ** batch, const long long totalsize, const std::string tag);
-         void OperatorsOnDisk(const int index, const bool movingRight, const bool store);
+         void OperatorsOnDisk(const int index, const bool movingRight, const bool store, const string filename);
+         string operator_filename(const int index) const;
+         OperatorStorage * op_storage;
          string tempfolder;
          
+         //Background I/O stage for the renormalized operators: the spilled boundaries are written and one boundary is prefetched while the next site is solved
+         void io_launch( const int load_index, const bool load_right );
+         void io_sync();
+         void io_run();
+         static void * io_thread_entry( void * dmrg );
+         pthread_t io_thread;
+         bool io_busy;
+         bool io_threaded;
+         int * io_store;
+         int  io_num_store;
+         int  io_load_index;
+         bool io_load_right;
+         
+         //Memory-budgeted cache of the renormalized operators: the least recently used boundaries are spilled to tempfolder
+         void boundary_allocate( const int index, const bool movingRight );
+         void boundary_delete( const int index );
+         void boundary_updated( const int index );
+         void boundary_load( const int index, const bool movingRight );
+         bool boundary_prefetch( const int index, const bool movingRight );
+         void boundary_spill( const int keep1, const int keep2, const int keep3 );
+         long long op_budget;   // Number of doubles; negative means no limit
+         long long op_resident; // Number of doubles of the boundaries in memory
+         long long * op_size;   // Number of doubles per boundary in memory
+         int * op_on_disk;      // 0 no valid copy on disk; 1 moving right; 2 moving left
+         int * op_last_use;
+         int op_clock;
+         bool op_files;
+         
          void saveMPS(const std::string name, TensorT ** MPSlocation, SyBookkeeper * BKlocation, bool isConverged) const;
          void loadDIM(const std::string name, SyBookkeeper * BKlocation);
          void loadMPS(const std::string name, TensorT ** MPSlocation, bool * isConverged);
          bool makecheckpoints;
          
+         //Restart checkpoints: the position of the current sweep, which is stored with the MPS, and whether Solve() should resume at a loaded position
+         int    pos_instruction; // -1 when Solve() has finished
+         int    pos_sweep;
+         bool   pos_right;
+         bool   pos_started;     // Whether the renormalized operators of the mid-sweep position are stored; if not, the position is the start of a left-right sweep
+         int    pos_index;       // The next two-site index or one-site site to be optimized
+         bool   pos_change;
+         double pos_noise;
+         double pos_energy;
+         double pos_energy_prev;
+         bool   resume_pending;
+         double ckpt_interval;
+         long long dvdson_distribute; // With MPI, the two-site Davidson vectors are distributed from this vector length on
+         int    ckpt_generation; // The operators of generation g are stored in the files of parity g % 2, so that an interrupted checkpoint leaves the previous one intact
+         bool   ckpt_files;
+         double ckpt_last;
+         unsigned long long ham_fingerprint;
+         void checkpoint_sweep( const int index, const bool moving_right, const double noise_level );
+         void write_checkpoint( const bool operators );
+         void save_restart_state( const std::string name, const bool operators ) const;
+         bool resume_checkpoint();
+         void discard_checkpoint();
+         void delete_restart_operators();
+         unsigned long long hamiltonian_fingerprint() const;
+         static void fnv1a( unsigned long long & hash, const void * data, const int num_bytes );
+         string restart_prefix() const;
+         string restart_filename( const int generation, const int index ) const;
+         static void checkpoint_fail( const std::string message, const std::string filename, const int error );
+         
          //Helper functions for making the boundary operators
          void updateMovingRight(const int index);
          void updateMovingLeft(const int index);
          void deleteTensors(const int index, const bool movingRight);
          void allocateTensors(const int index, const bool movingRight);
+         long long sizeTensors(const int index) const;
          void updateMovingRightSafe(const int cnt);
          void updateMovingRightSafeFirstTime(const int cnt);
          void updateMovingRightSafe2DM(const int cnt);
          void updateMovingLeftSafe(const int cnt);
          void updateMovingLeftSafeFirstTime(const int cnt);
          void updateMovingLeftSafe2DM(const int cnt);
+         void updateSafeOneSite(const int cnt, const bool movingRight, const bool sweepRight);
          void deleteAllBoundaryOperators();
+         
+         //The assignment of the renormalized operators to the MPI processes, and the measured load imbalance of the last sweep (maximum over average wall time of CHEMPS2_TIME_MPI_WORK)
+         MPIbalance * balance;
+         double ImbalanceLastSweep;
+         void rebalance_operators( const bool am_i_master );
+         void measure_imbalance();
 
          // Helper functions for making the 3-RDM boundary operators
          void update_safe_3rdm_operators( const int boundary );
@@ -294,7 +432,7 @@ namespace CheMPS2{
          static void solve_fock_update_helper( const int index, const int dmrg_orb1, const int dmrg_orb2, const bool moving_right, TensorT ** new_mps, TensorT ** old_mps, SyBookkeeper * new_bk, SyBookkeeper * old_bk, TensorO ** overlaps, TensorL ** regular, TensorL ** trans );
          static void  left_normalize( TensorT * left_mps, TensorT * right_mps );
          static void right_normalize( TensorT * left_mps, TensorT * right_mps );
-         void symm_4rdm_helper( double * output, const int ham_orb1, const int ham_orb2, const double alpha, const double beta, const bool add, const double factor );
+         void symm_4rdm_helper( SixIndex * output, const int ham_orb1, const int ham_orb2, const double alpha, const double beta, const bool add, const double factor );
 
          //Helper functions for making the Correlations boundary operators
          void update_correlations_tensors(const int siteindex);
@@ -312,10 +450,19 @@ namespace CheMPS2{
          void calcVeffTilde(double * result, Sobject * currentS, int state_number);
          void calc_overlaps( const bool moving_right );
          
+         //The storage to handle state-averaged roots: root 0 lives in the MPS, the center tensors of the other roots in SA_centers[ root ] at site SA_center_site
+         int SA_num_roots;
+         int SA_center_site;
+         double * SA_energies;
+         TensorT ** SA_centers;
+         TensorT ** SA_backup; // Copy of the MPS of root 0 after Solve(), to restore it in selectRoot()
+         void delete_sa_backup();
+         
          // Performance counters
          double timings[ CHEMPS2_TIME_VECLENGTH ];
          long long num_double_write_disk;
          long long num_double_read_disk;
+         long long num_byte_write_file;
          void print_tensor_update_performance() const;
          
    };
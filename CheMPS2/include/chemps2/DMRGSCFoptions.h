@@ -46,7 +46,11 @@ namespace CheMPS2{
     DMRG active space options: \n
     (11) WhichActiveSpace (int) : Determines which active space is used for the DMRG (FCI replacement) calculations. If 1: NO, sorted within each irrep by NOON. If 2: Localized Orbitals (Edmiston-Ruedenberg), sorted within each irrep by the exchange matrix (Fiedler vector). If 3: Not localized, but only sorted within each irrep by the Fiedler vector of the exchange matrix. If other value: No additional active space rotations (the ones from DMRGSCF are of course performed). \n
     (12) DumpCorrelations (bool) : Whether or not to print the correlation functions and two-orbital mutual information of the active space \n
-    (13) StartLocRandom (bool) : When localized orbitals are used, it is sometimes beneficial to start the localization procedure from a random unitary. A specific example is the reduction of the d2h point group of graphene nanoribbons to the cs point group, in order to make use of locality in the DMRG calculations. Since molecular orbitals will still belong to the full point group d2h, a random unitary helps in constructing localized orbitals which belong to the cs point group.
+    (13) StartLocRandom (bool) : When localized orbitals are used, it is sometimes beneficial to start the localization procedure from a random unitary. A specific example is the reduction of the d2h point group of graphene nanoribbons to the cs point group, in order to make use of locality in the DMRG calculations. Since molecular orbitals will still belong to the full point group d2h, a random unitary helps in constructing localized orbitals which belong to the cs point group. \n
+    (14) WarmStartBranch (double) : Continue the DMRG sweeps from the MPS of the previous DMRGSCF iteration, with only the last instruction of the ConvergenceScheme, when the 2-norm of the previous update vector is smaller than this value. The DMRG calculation is started anew when the active space has been rotated or reordered, and for state-specific excited states. With warm starts, the DMRG object and its renormalized operators stay in memory during the orbital optimization. A negative value disables the warm starts, which is the default. \n
+
+    CASPT2 options: \n
+    (15) CASPT2OutOfCore (bool) : Whether or not to store the CASPT2 first-order wavefunction, right-hand side, and conjugate gradient vectors as memory-mapped files in the temporary work folder of CASSCF, instead of in memory. The conjugate gradient algorithm is then always used to solve the CASPT2 equation.
 */
    class DMRGSCFoptions{
 
@@ -109,6 +113,14 @@ namespace CheMPS2{
          //! Get whether the localization procedure should start from a random unitary
          /** \return Whether the localization procedure should start from a random unitary */
          bool getStartLocRandom() const;
+         
+         //! Get the threshold for when the DMRG sweeps should continue from the MPS of the previous DMRGSCF iteration
+         /** \return The threshold for the 2-norm of the update vector (NOT the gradient vector) for warm-starting the DMRG sweeps */
+         double getWarmStartBranch() const;
+
+         //! Get whether the CASPT2 vectors should be stored out-of-core
+         /** \return Whether the CASPT2 vectors should be stored as memory-mapped files */
+         bool getCASPT2OutOfCore() const;
 
          //! Set whether DIIS should be performed
          /** \param DoDIIS_in Whether DIIS should be performed */
@@ -162,6 +174,14 @@ namespace CheMPS2{
          /** \param StartLocRandom_in Whether the localization procedure should start from a random unitary */
          void setStartLocRandom(const bool StartLocRandom_in);
          
+         //! Set the threshold for when the DMRG sweeps should continue from the MPS of the previous DMRGSCF iteration
+         /** \param WarmStartBranch_in The threshold for the 2-norm of the update vector (NOT the gradient vector) for warm-starting the DMRG sweeps; negative disables warm starts */
+         void setWarmStartBranch(const double WarmStartBranch_in);
+
+         //! Set whether the CASPT2 vectors should be stored out-of-core
+         /** \param CASPT2OutOfCore_in Whether the CASPT2 vectors should be stored as memory-mapped files */
+         void setCASPT2OutOfCore(const bool CASPT2OutOfCore_in);
+         
       private:
       
          //See class information
@@ -180,6 +200,9 @@ namespace CheMPS2{
          int    WhichActiveSpace;
          bool   DumpCorrelations;
          bool   StartLocRandom;
+         double WarmStartBranch;
+
+         bool   CASPT2OutOfCore;
          
    };
 }
@@ -26,6 +26,8 @@ namespace CheMPS2{
     \date January 29, 2015
     
     The Davidson class implements Davidson's algorithm to find the lowest eigenvalue and corresponding eigenvector of a symmetric operator.
+    For eigenvalue problems, the lowest num_roots eigenpairs can be obtained at once. Per iteration, correction vectors are added to the subspace for the block_size lowest unconverged roots, and their matrix-vector products are requested in a single instruction, so that the caller can reuse its data for all vectors of the block.
+    With MPI, the vectors can be distributed over the processes: each process then stores only its slice of the Krylov space, the inner products are summed over the processes, and all processes should call FetchInstruction in lockstep.
     Information can be found in \n
      
      [1] E.R. Davidson, J. Comput. Phys. 17 (1), 87-94 (1975). http://dx.doi.org/10.1016/0021-9991(75)90065-0 \n
@@ -42,28 +44,42 @@ namespace CheMPS2{
              \param RTOL         The tolerance for the two-norm of the residual ( for convergence )
              \param DIAG_CUTOFF  Cutoff value for the diagonal preconditioner
              \param debug_print  Whether or not to debug print
-             \param problem_type 'E' for eigenvalue or 'L' for linear problem. */
-         Davidson( const int veclength, const int MAX_NUM_VEC, const int NUM_VEC_KEEP, const double RTOL, const double DIAG_CUTOFF, const bool debug_print, const char problem_type = 'E' );
+             \param problem_type 'E' for eigenvalue or 'L' for linear problem.
+             \param num_roots    The number of lowest eigenpairs to converge; only for problem_type=='E'. NUM_VEC_KEEP should be at least num_roots.
+             \param block_size   The maximum number of vectors per matrix-vector multiplication instruction; only for problem_type=='E'. NUM_VEC_KEEP + block_size should not exceed MAX_NUM_VEC.
+             \param distributed  Whether the vectors are distributed over the MPI processes; veclength is then the length of the slice of this process, and all vectors passed through FetchInstruction are slices. */
+         Davidson( const long long veclength, const int MAX_NUM_VEC, const int NUM_VEC_KEEP, const double RTOL, const double DIAG_CUTOFF, const bool debug_print, const char problem_type = 'E', const int num_roots = 1, const int block_size = 1, const bool distributed = false );
 
          //! Destructor
          virtual ~Davidson();
 
          //! The iterator to converge the ground state vector
          /** \param pointers Array of double* of length 2 when problem_type=='E' or length 3 when problem_type=='L'.
-             \return Instruction character. 'A' means copy the initial guess to pointers[0] and the diagonal of the symmetric matrix to pointers[1]. If 'A' and problem_type=='E', the right-hand side of the problem should be copied to pointers[2]. 'B' means calculate pointers[1] as the result of multiplying the symmetric matrix with pointers[0]. 'C' means that the converged solution can be copied back from pointers[0], and pointers[1][0] contains the ground-state energy if problem_type=='E' or the residual norm if problem_type=='L'. 'D' means that an error has occurred. */
+             \return Instruction character. 'A' means copy the initial guess to pointers[0] and the diagonal of the symmetric matrix to pointers[1]. If 'A' and problem_type=='E', the right-hand side of the problem should be copied to pointers[2]. 'B' means calculate pointers[1] as the result of multiplying the symmetric matrix with pointers[0]. 'C' means that the converged solution can be copied back from pointers[0], and pointers[1][0] contains the ground-state energy if problem_type=='E' or the residual norm if problem_type=='L'. 'D' means that an error has occurred. When num_roots > 1, pointers[0] contains num_roots consecutive vectors of length veclength for instructions 'A' and 'C', and pointers[1] the num_roots lowest eigenvalues for instruction 'C'. When block_size > 1, pointers[0] and pointers[1] contain GetBlockSize() consecutive vectors of length veclength for instruction 'B'. */
          char FetchInstruction( double ** pointers );
 
          //! Get the number of matrix vector multiplications which have been performed
          /** \return The number of matrix vector multiplications which have been performed */
          int GetNumMultiplications() const;
 
+         //! Get the number of vectors in the last 'B' instruction
+         /** \return The number of consecutive vectors in pointers[0] and pointers[1] which should be multiplied with the symmetric matrix */
+         int GetBlockSize() const;
+
       private:
 
-         int veclength; // The vector length
+         long long veclength; // The vector length
          int nMultiplications; // Current number of requested matrix-vector multiplications
          char state; // Current state of the algorithm --> based on this parameter the next instruction is given
          bool debug_print;
          char problem_type;
+         int num_roots;
+         int num_guess; // Number of initial guesses which have been added to the subspace
+         int block_size;
+         int num_new; // Number of vectors beyond num_vec which have been added to vecs, but not yet to mxM
+         int num_block; // Number of vectors in the last 'B' instruction
+         int num_corr; // Number of correction vectors which wait to be added to vecs
+         bool distributed; // Whether the vectors are slices of vectors which are distributed over the MPI processes
 
          // Davidson parameters
          int MAX_NUM_VEC;
@@ -91,6 +107,11 @@ namespace CheMPS2{
          double * work_vec;
          double * diag;
          double * RHS;
+         double * roots_vecs; // For num_roots > 1: the initial guesses and the converged eigenvectors
+         double * roots_eigs; // For num_roots > 1: the converged eigenvalues
+         double * block_vecs; // For block_size > 1: the vectors of a 'B' instruction
+         double * block_Hvecs; // For block_size > 1: the matrix x vectors of a 'B' instruction
+         double * block_corr; // For block_size > 1: the correction vectors
 
          // For the deflation
          double * Reortho_Lowdin;
@@ -99,11 +120,18 @@ namespace CheMPS2{
          double * Reortho_Eigenvecs;
 
          // Control script functions
+         double Inprod( double * vector1, double * vector2 ); // Summed over the MPI processes if distributed
          double FrobeniusNorm( double * current_vector );
          void SafetyCheckGuess();
-         void AddNewVec();
+         bool AddNewVec();
+         void AddGuesses();
+         void AddCorrections();
+         char RequestMultiplication( double ** pointers );
+         void StoreMultiplication();
          double DiagonalizeSmallMatrixAndCalcResidual(); // Returns the residual norm
-         void CalculateNewVec();
+         double CalcResidual( const int root ); // Returns the residual norm
+         void AddNewGuess();
+         void CalculateNewVec( const int root );
          void Deflation();
          void MxMafterDeflation();
          void SolveLinearSystemDeflation( const int NUM_SOLUTIONS );
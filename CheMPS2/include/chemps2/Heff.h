@@ -31,6 +31,8 @@
 #include "Problem.h"
 #include "SyBookkeeper.h"
 #include "Sobject.h"
+#include "HeffPlan.h"
+#include "Workspace.h"
 #include "Options.h"
 
 namespace CheMPS2{
@@ -46,8 +48,10 @@ namespace CheMPS2{
          //! Constructor
          /** \param denBKIn The SyBookkeeper to get the dimensions
              \param ProbIn The Problem that contains the Hamiltonian
-             \param dvdson_rtol_in The residual tolerance for the DMRG Davidson iterations */
-         Heff(const SyBookkeeper * denBKIn, const Problem * ProbIn, const double dvdson_rtol_in);
+             \param dvdson_rtol_in The residual tolerance for the DMRG Davidson iterations
+             \param work_in The persistent work arrays (if NULL, Heff allocates its own)
+             \param distribute_size_in With MPI, the Davidson vectors are distributed over the processes from this vector length on */
+         Heff(const SyBookkeeper * denBKIn, const Problem * ProbIn, const double dvdson_rtol_in, Workspace * work_in = NULL, const long long distribute_size_in = CheMPS2::DAVIDSON_MPI_DISTRIBUTE_size);
          
          //! Destructor
          virtual ~Heff();
@@ -69,6 +73,31 @@ namespace CheMPS2{
              \param VeffTilde The projection operators to project the nLower lower-lying states out */
          double SolveDAVIDSON(Sobject * denS, TensorL *** Ltensors, TensorOperator **** Atensors, TensorOperator **** Btensors, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorS0 **** S0tensors, TensorS1 **** S1tensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorQ *** Qtensors, TensorX ** Xtensors, int nLower = 0, double ** VeffTilde = NULL) const;
          
+         //! Davidson Solver for the lowest num_roots eigenpairs, which share the renormalized operators
+         /** \param denS Array of num_roots initial guess S-objects; on exit they contain the eigenvectors (only on MPI_CHEMPS2_MASTER)
+             \param energies Array of length num_roots; on exit it contains the eigenvalues in ascending order (on each MPI process)
+             \param num_roots The number of eigenpairs
+             \param Ltensors Pointer to the single contracted 2nd quantized operators
+             \param Atensors Spin-0 complementary operators of two creators
+             \param Btensors Spin-1 complementary operators of two creators
+             \param Ctensors Spin-0 complementary operators of a creator and an annihilator
+             \param Dtensors Spin-1 complementary operators of a creator and an annihilator
+             \param S0tensors Spin-0 reduction of two creators
+             \param S1tensors Spin-1 reduction of two creators
+             \param F0tensors Spin-0 reduction of a creator and an annihilator
+             \param F1tensors Spin-1 reduction of a creator and an annihilator
+             \param Qtensors Complementary operators of three sandwiched 2nd quantized operators
+             \param Xtensors Pointer to the completely contracted terms */
+         void SolveDAVIDSON(Sobject ** denS, double * energies, const int num_roots, TensorL *** Ltensors, TensorOperator **** Atensors, TensorOperator **** Btensors, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorS0 **** S0tensors, TensorS1 **** S1tensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorQ *** Qtensors, TensorX ** Xtensors) const;
+         
+         //! Get the number of matrix-vector multiplications of the last SolveDAVIDSON call
+         /** \return The number of matrix-vector multiplications of the last SolveDAVIDSON call (only on MPI_CHEMPS2_MASTER) */
+         int gNumMultiplications() const;
+         
+         //! Get the wall time spent in the effective Hamiltonian multiplications of this process
+         /** \return The wall time (seconds) of the multiplications since construction, without MPI communication */
+         double gMultiplicationTime() const;
+         
          //! Phase function
          /** \param TwoTimesPower Twice the power of the phase (-1)^{power}
              \return The phase (-1)^{TwoTimesPower/2} */
@@ -84,18 +113,52 @@ namespace CheMPS2{
          
          //The Davidson residual tolerance
          double dvdson_rtol;
+         
+         //With MPI, the Davidson vectors are distributed over the processes from this vector length on
+         long long distribute_size;
+         
+         //The number of matrix-vector multiplications of the last SolveDAVIDSON call
+         mutable int num_matvec;
+         
+         //The wall time of the effective Hamiltonian multiplications since construction
+         mutable double mult_time;
+         
+         //The persistent work arrays, and whether they are owned by Heff
+         Workspace * work;
+         bool own_work;
+         
+         //The contraction plan of the current site, recorded during the first effective Hamiltonian multiplication
+         mutable HeffPlan * plan;
+         
+         //BLAS calls of the diagrams, which are recorded in the contraction plan (same arguments as dgemm_, daxpy_, and dcopy_)
+         void planDgemm(char * transA, char * transB, int * m, int * n, int * k, double * alpha, double * A, int * lda, double * B, int * ldb, double * beta, double * C, int * ldc) const;
+         void planDaxpy(int * n, double * alpha, double * x, int * incx, double * y, int * incy) const;
+         void planDcopy(int * n, double * x, int * incx, double * y, int * incy) const;
+         void planClear(double * x, int n) const;
       
          //Do Heff * memS -> memHeff
          void makeHeff(double * memS, double * memHeff, const Sobject * denS, TensorL *** Ltensors, TensorOperator **** Atensors, TensorOperator **** Btensors, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorS0 **** S0tensors, TensorS1 **** S1tensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorQ *** Qtensors, TensorX ** Xtensors, int nLower, double ** VeffTilde) const;
          
+         //Do Heff * memS -> memHeff for num_vectors consecutive vectors in memS and memHeff; the recorded plan multiplies all vectors of a sector with one widened dgemm_ where possible
+         void makeHeff(double * memS, double * memHeff, const int num_vectors, const Sobject * denS, TensorL *** Ltensors, TensorOperator **** Atensors, TensorOperator **** Btensors, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorS0 **** S0tensors, TensorS1 **** S1tensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorQ *** Qtensors, TensorX ** Xtensors, int nLower, double ** VeffTilde) const;
+         
          //Fill the diagonal elements
          void fillHeffDiag(double * memHeffDiag, const Sobject * denS, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorX ** Xtensors, int nLower, double ** VeffTilde) const;
          
          //Solve Davidson for the MPI_CHEMPS2_MASTER process
-         double SolveDAVIDSON_main(Sobject * denS, TensorL *** Ltensors, TensorOperator **** Atensors, TensorOperator **** Btensors, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorS0 **** S0tensors, TensorS1 **** S1tensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorQ *** Qtensors, TensorX ** Xtensors, int nLower, double ** VeffTilde) const;
+         void SolveDAVIDSON_main(Sobject ** denS, double * energies, const int num_roots, TensorL *** Ltensors, TensorOperator **** Atensors, TensorOperator **** Btensors, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorS0 **** S0tensors, TensorS1 **** S1tensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorQ *** Qtensors, TensorX ** Xtensors, int nLower, double ** VeffTilde) const;
          
          //Solve Davidson for the helper processes
-         double SolveDAVIDSON_help(Sobject * denS, TensorL *** Ltensors, TensorOperator **** Atensors, TensorOperator **** Btensors, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorS0 **** S0tensors, TensorS1 **** S1tensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorQ *** Qtensors, TensorX ** Xtensors, int nLower, double ** VeffTilde) const;
+         void SolveDAVIDSON_help(Sobject ** denS, double * energies, const int num_roots, TensorL *** Ltensors, TensorOperator **** Atensors, TensorOperator **** Btensors, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorS0 **** S0tensors, TensorS1 **** S1tensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorQ *** Qtensors, TensorX ** Xtensors, int nLower, double ** VeffTilde) const;
+         
+         //Solve Davidson on all processes, with the Davidson vectors distributed over the processes
+         void SolveDAVIDSON_distributed(Sobject ** denS, double * energies, const int num_roots, TensorL *** Ltensors, TensorOperator **** Atensors, TensorOperator **** Btensors, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorS0 **** S0tensors, TensorS1 **** S1tensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorQ *** Qtensors, TensorX ** Xtensors, int nLower, double ** VeffTilde) const;
+         
+         //Whether the Davidson vectors of denS are distributed over the processes
+         bool distribute(const Sobject * denS) const;
+         
+         //Assign contiguous ranges of symmetry sectors of denS with about equal total size to the processes: the slice of process proc is [ slices[ proc ], slices[ proc + 1 ] )
+         static void partition_sectors(const Sobject * denS, long long * slices);
          
          //The diagrams: Type 1/5
          void addDiagram1A(const int ikappa, double * memS, double * memHeff, const Sobject * denS, TensorX * Xleft) const;
@@ -0,0 +1,163 @@
+/*
+   CheMPS2: a spin-adapted implementation of DMRG for ab initio quantum chemistry
+   Copyright (C) 2013-2016 Sebastian Wouters
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#ifndef HEFFONESITE_CHEMPS2_H
+#define HEFFONESITE_CHEMPS2_H
+
+#include "TensorL.h"
+#include "TensorOperator.h"
+#include "TensorS0.h"
+#include "TensorS1.h"
+#include "TensorF0.h"
+#include "TensorF1.h"
+#include "TensorQ.h"
+#include "TensorX.h"
+#include "Problem.h"
+#include "SyBookkeeper.h"
+#include "TensorT.h"
+#include "Workspace.h"
+#include "Options.h"
+
+namespace CheMPS2{
+/** HeffOneSite class.
+    \author Sebastian Wouters <sebastianwouters@gmail.com>
+    \date October 16, 2026
+
+    The HeffOneSite class contains the sparse eigensolver routines for the one-site DMRG update. The effective Hamiltonian acts on a single TensorT, with the renormalized operators of the boundaries to its left and right. Its diagrams are those of the Heff class for a two-site object with an empty second site. As the bond in the sweep direction cannot grow in a one-site update, HeffOneSite::Expand enlarges it with the single-operator terms of the Hamiltonian which cross it (subspace expansion), and truncates it again to the requested virtual dimension. */
+   class HeffOneSite{
+
+      public:
+
+         //! Constructor
+         /** \param denBKIn The SyBookkeeper to get the dimensions. Not constant as HeffOneSite::Expand sets the virtual dimensions of the bond in the sweep direction.
+             \param ProbIn The Problem that contains the Hamiltonian
+             \param dvdson_rtol_in The residual tolerance for the DMRG Davidson iterations
+             \param work_in The persistent work arrays (if NULL, HeffOneSite allocates its own) */
+         HeffOneSite(SyBookkeeper * denBKIn, const Problem * ProbIn, const double dvdson_rtol_in, Workspace * work_in = NULL);
+
+         //! Destructor
+         virtual ~HeffOneSite();
+
+         //! Davidson Solver
+         /** \param denT Initial guess MPS tensor; on exit it contains the solution (only on MPI_CHEMPS2_MASTER)
+             \param Ltensors Pointer to the single contracted 2nd quantized operators
+             \param Atensors Spin-0 complementary operators of two creators
+             \param Btensors Spin-1 complementary operators of two creators
+             \param Ctensors Spin-0 complementary operators of a creator and an annihilator
+             \param Dtensors Spin-1 complementary operators of a creator and an annihilator
+             \param S0tensors Spin-0 reduction of two creators
+             \param S1tensors Spin-1 reduction of two creators
+             \param F0tensors Spin-0 reduction of a creator and an annihilator
+             \param F1tensors Spin-1 reduction of a creator and an annihilator
+             \param Qtensors Complementary operators of three sandwiched 2nd quantized operators
+             \param Xtensors Pointer to the completely contracted terms
+             \return The lowest eigenvalue of the one-site effective Hamiltonian */
+         double SolveDAVIDSON(TensorT * denT, TensorL *** Ltensors, TensorOperator **** Atensors, TensorOperator **** Btensors, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorS0 **** S0tensors, TensorS1 **** S1tensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorQ *** Qtensors, TensorX ** Xtensors) const;
+
+         //! Expand and truncate the bond between denT and its neighbour in the sweep direction
+         /** For each symmetry sector of the bond, the reduced density matrix of denT is enlarged with alpha^2 times the squares of the terms L_l T, with L_l the single 2nd quantized operators of the boundary opposite to the bond and of the site of denT. Its leading eigenvectors become the new denT, which is then left- (moving right) or right-normalized (moving left), and the remaining weight is moved into neighbour.
+             \param denT The MPS tensor which was just optimized; on exit it is normalized towards neighbour
+             \param neighbour The MPS tensor next to denT in the sweep direction; on exit it contains the center of the MPS
+             \param alpha The prefactor of the expansion terms (0.0 truncates without expansion)
+             \param virtualdimensionD The virtual dimension of the bond
+             \param change Whether the virtual dimensions of the symmetry sectors of the bond may change
+             \param max_discarded_weight If positive, keep only as many states as needed to stay below this discarded weight
+             \param min_dimension The minimum virtual dimension of the bond when max_discarded_weight is positive
+             \param Ltensors Pointer to the single contracted 2nd quantized operators
+             \return The discarded weight if change == true; else 0.0 */
+         double Expand(TensorT * denT, TensorT * neighbour, const double alpha, const int virtualdimensionD, const bool change, const double max_discarded_weight, const int min_dimension, TensorL *** Ltensors) const;
+
+         //! Get the number of matrix-vector multiplications of the last SolveDAVIDSON call
+         /** \return The number of matrix-vector multiplications of the last SolveDAVIDSON call (only on MPI_CHEMPS2_MASTER) */
+         int gNumMultiplications() const;
+
+         //! Get the wall time spent in the effective Hamiltonian multiplications of this process
+         /** \return The wall time (seconds) of the multiplications since construction, without MPI communication */
+         double gMultiplicationTime() const;
+
+      private:
+
+         //The SyBookkeeper
+         SyBookkeeper * denBK;
+
+         //The Problem (and hence Hamiltonian)
+         const Problem * Prob;
+
+         //The Davidson residual tolerance
+         double dvdson_rtol;
+
+         //The number of matrix-vector multiplications of the last SolveDAVIDSON call
+         mutable int num_matvec;
+
+         //The wall time of the effective Hamiltonian multiplications since construction
+         mutable double mult_time;
+
+         //The persistent work arrays, and whether they are owned by HeffOneSite
+         Workspace * work;
+         bool own_work;
+
+         //Scale the blocks of denT with sqrt(TwoSR+1) (prog2symm == true) or with its inverse (prog2symm == false)
+         static void convention(TensorT * denT, const bool prog2symm);
+
+         //Do Heff * memT -> memHeff, with memT and memHeff in symmetric conventions
+         void makeHeff(double * memT, double * memHeff, const TensorT * denT, TensorL *** Ltensors, TensorOperator **** Atensors, TensorOperator **** Btensors, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorS0 **** S0tensors, TensorS1 **** S1tensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorQ *** Qtensors, TensorX ** Xtensors) const;
+
+         //Fill the diagonal elements of Heff
+         void fillHeffDiag(double * memHeffDiag, const TensorT * denT, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorX ** Xtensors) const;
+
+         //Solve Davidson for the MPI_CHEMPS2_MASTER process
+         double SolveDAVIDSON_main(TensorT * denT, TensorL *** Ltensors, TensorOperator **** Atensors, TensorOperator **** Btensors, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorS0 **** S0tensors, TensorS1 **** S1tensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorQ *** Qtensors, TensorX ** Xtensors) const;
+
+         //Solve Davidson for the helper processes
+         double SolveDAVIDSON_help(TensorT * denT, TensorL *** Ltensors, TensorOperator **** Atensors, TensorOperator **** Btensors, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorS0 **** S0tensors, TensorS1 **** S1tensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, TensorQ *** Qtensors, TensorX ** Xtensors) const;
+
+         //For the bond sector ( NM, TwoSM, IM ) of Expand: stack the num_blocks blocks of denT with the labels blockN, blockTwoS and blockI of the other boundary at the row offsets offset into stacked, and build its enlarged reduced density matrix rho (upper triangle)
+         void expansion_sector(TensorT * denT, const bool moving_right, const int NM, const int TwoSM, const int IM, const int num_blocks, const int * blockN, const int * blockTwoS, const int * blockI, const int * offset, double * stacked, double * rho, const double alpha, TensorL *** Ltensors) const;
+
+         //Add alpha * left * T( down ) * right to the upper sector ikappa of memHeff, with NULL for an identity operator
+         void sandwich(const int ikappa, const int NLdown, const int TwoSLdown, const int ILdown, const int NRdown, const int TwoSRdown, const int IRdown, double alpha, double * left, const bool trans_left, double * right, const bool trans_right, double * memT, double * memHeff, const TensorT * denT, double * temp) const;
+
+         //Diagrams of group 1: the completely contracted terms and the local term
+         void addDiagram1A(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorX * Xleft, double * temp) const;
+         void addDiagram1B(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorX * Xright, double * temp) const;
+         void addDiagram1C(const int ikappa, double * memT, double * memHeff, const TensorT * denT, const double Helem, double * temp) const;
+
+         //Diagrams of group 2: two 2nd quantized operators on one side, and two on the site or on the other side
+         void addDiagram2b(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorOperator * Atens, TensorOperator * Ctens, TensorOperator * Dtens, double * temp) const;
+         void addDiagram2e(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorOperator * Atens, TensorOperator * Ctens, TensorOperator * Dtens, double * temp) const;
+         void addDiagram2a1and2a2spin0(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorOperator **** Atensors, TensorS0 **** S0tensors, double * temp) const;
+         void addDiagram2a1and2a2spin1(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorOperator **** Btensors, TensorS1 **** S1tensors, double * temp) const;
+         void addDiagram2a3(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorOperator **** Ctensors, TensorOperator **** Dtensors, TensorF0 **** F0tensors, TensorF1 **** F1tensors, double * temp) const;
+
+         //Diagrams of group 3: three 2nd quantized operators on one side, and one on the site or the other side
+         void fill_qtilde(double * result, TensorQ * Qtens, TensorL ** Ltens, const bool left_side, const int theindex, const int N1, const int TwoS1, const int I1, const int N2, const int TwoS2, const int I2) const;
+         void addDiagram3Aand3D(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorQ * Qleft, TensorL ** Lleft, double * temp, double * temp2) const;
+         void addDiagram3Kand3F(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorQ * Qright, TensorL ** Lright, double * temp, double * temp2) const;
+         void addDiagram3C(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorQ ** Qleft, TensorL ** Lright, double * temp) const;
+         void addDiagram3J(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorQ ** Qright, TensorL ** Lleft, double * temp) const;
+
+         //Diagrams of group 4: 2nd quantized operators on the site and on both sides
+         void addDiagram4B(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorOperator *** Aleft, TensorOperator *** Bleft, TensorOperator *** Cleft, TensorOperator *** Dleft, TensorL ** Lright, double * temp) const;
+         void addDiagram4E(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorL ** Lleft, TensorL ** Lright, double * temp, double * temp2) const;
+         void addDiagram4L(const int ikappa, double * memT, double * memHeff, const TensorT * denT, TensorL ** Lleft, TensorOperator *** Aright, TensorOperator *** Bright, TensorOperator *** Cright, TensorOperator *** Dright, double * temp) const;
+
+   };
+}
+
+#endif
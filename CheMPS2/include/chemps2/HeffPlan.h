@@ -0,0 +1,227 @@
+/*
+   CheMPS2: a spin-adapted implementation of DMRG for ab initio quantum chemistry
+   Copyright (C) 2013-2016 Sebastian Wouters
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#ifndef HEFFPLAN_CHEMPS2_H
+#define HEFFPLAN_CHEMPS2_H
+
+#include "Sobject.h"
+
+namespace CheMPS2{
+/** HeffPlan class.
+    \author Sebastian Wouters <sebastianwouters@gmail.com>
+    \date October 16, 2026
+
+    The HeffPlan class contains the contraction plan of the effective Hamiltonian at a fixed site. During the first effective Hamiltonian multiplication, the BLAS calls of the diagrams are recorded per symmetry sector ikappa of the S-object: the dgemm shapes, the Wigner prefactors, and the operands. Operands in the S-object, the result block of ikappa, and the two work arrays are stored as offsets with respect to their base, and operands in the renormalized operators as absolute pointers. The subsequent multiplications at the same site then only execute the recorded calls, which avoids the bookkeeping lookups and the prefactor evaluations of the diagrams. The recording of a sector is done by one thread, so that the sectors can be recorded concurrently.
+
+    The recorded calls of a sector are separated into diagram groups, between which the work arrays are not reused. After the recording, consecutive diagram groups are merged into tasks based on their flop count, so that a few large sectors are distributed over many threads. A sector with several tasks accumulates each task in a separate partial result block, and the partial blocks are summed in a fixed order afterwards. The result is hence independent of the scheduling. The projection onto the lower-lying states depends on the full vector and is not recorded.
+
+    Several vectors are multiplied in a block layout: the b vectors of a symmetry sector are stored consecutively, so that a sector block of dimension dimL x dimR becomes a dimL x ( b * dimR ) matrix. After the recording, each call is classified per diagram group: calls which only involve the renormalized operators (and work arrays filled with them) are executed once, calls which multiply vector blocks from the left by an operator are executed once with the number of columns widened to b times n, and the other calls are executed once per vector. The work arrays contain b copies of the area used by the diagram group. Multiplications from the right could be widened in the rows by stacking the vector blocks on top of each other, but the copies cost more than the larger dgemm_ calls gain. */
+   class HeffPlan{
+
+      public:
+
+         //! Constructor
+         /** \param denS The S-object for which the plan is recorded (its symmetry sectors and vector length)
+             \param max_megabytes The maximum memory of the plan in MB; when exceeded, the plan is discarded */
+         HeffPlan( const Sobject * denS, const int max_megabytes );
+
+         //! Destructor
+         virtual ~HeffPlan();
+
+         //! Get the S-object for which the plan is recorded
+         /** \return The S-object for which the plan is recorded */
+         const Sobject * gSobject() const;
+
+         //! Get whether the plan is recorded and can be executed
+         /** \return Whether the plan is recorded and can be executed */
+         bool gComplete() const;
+
+         //! Get whether the plan still has to be recorded
+         /** \return Whether the plan still has to be recorded */
+         bool gEmpty() const;
+
+         //! Start the recording of sector ikappa by the calling thread
+         /** \param ikappa The symmetry sector
+             \param memS The S-object vector
+             \param memHeff The result vector
+             \param temp The first work array
+             \param temp2 The second work array
+             \param tempsize The size of each work array */
+         void start( const int ikappa, double * memS, double * memHeff, double * temp, double * temp2, const int tempsize );
+
+         //! Mark the end of a diagram group of the calling thread, if it is recording: the work arrays are not reused across this mark
+         void cut();
+
+         //! Stop the recording of the calling thread
+         void stop();
+
+         //! Finish the recording: the plan is divided into tasks and becomes complete, or is discarded when it exceeds the memory limit
+         void finish();
+
+         //! Get the number of tasks per vector
+         /** \return The number of tasks per vector, in order of decreasing cost */
+         int gNumTasks() const;
+
+         //! Allocate the partial result blocks and the block layout for a number of vectors
+         /** \param num_vectors The number of vectors which are multiplied simultaneously */
+         void prepare( const int num_vectors );
+
+         //! Copy sector ikappa of the vectors into the block layout; nothing happens for a single vector
+         /** \param ikappa The symmetry sector
+             \param memS The num_vectors S-object vectors of the last prepare call, stored consecutively */
+         void load( const int ikappa, double * memS ) const;
+
+         //! Record a dgemm_ call of the calling thread, if it is recording (same arguments as dgemm_)
+         void dgemm( char * transA, char * transB, int * m, int * n, int * k, double * alpha, double * A, int * lda, double * B, int * ldb, double * beta, double * C, int * ldc );
+
+         //! Record a daxpy_ call of the calling thread, if it is recording (same arguments as daxpy_)
+         void daxpy( int * n, double * alpha, double * x, int * incx, double * y, int * incy );
+
+         //! Record a dcopy_ call of the calling thread, if it is recording (same arguments as dcopy_)
+         void dcopy( int * n, double * x, int * incx, double * y, int * incy );
+
+         //! Record the zeroing of an array by the calling thread, if it is recording
+         /** \param x The array
+             \param n The number of elements */
+         void clear( double * x, const int n );
+
+         //! Execute a task for all vectors of the last prepare call: its result block is overwritten
+         /** \param task The task number, in [ 0, gNumTasks() )
+             \param memS The S-object vector (for several vectors, the block layout filled by load() is used)
+             \param memHeff The result vector (for several vectors, the block layout is used)
+             \param temp The first work array, of size num_vectors times the size passed to start()
+             \param temp2 The second work array, of size num_vectors times the size passed to start() */
+         void execute( const int task, double * memS, double * memHeff, double * temp, double * temp2 ) const;
+
+         //! Sum the partial result blocks of sector ikappa, after all tasks have been executed, and copy the sector of the block layout to the result vectors
+         /** \param ikappa The symmetry sector
+             \param memHeff The num_vectors result vectors of the last prepare call, stored consecutively */
+         void reduce( const int ikappa, double * memHeff ) const;
+
+      private:
+
+         //The bases of the operands
+         enum { base_abs = 0, base_S = 1, base_H = 2, base_T1 = 3, base_T2 = 4 };
+
+         //A recorded call: 'G' dgemm_, 'A' daxpy_, 'C' dcopy_, 'Z' zeroing, 'X' end of a diagram group; the operands are x/A, y/B and C
+         //In the block layout, operand number of vector vec is at base + offset + ( num_vectors - 1 ) * start + vec * stride
+         struct HeffPlanOp{
+            char type;
+            char trans[2];
+            char multi; // 0: executed once, 1: executed per vector, 2: executed once with the columns (or the length) widened to all vectors
+            int dim[3];
+            int ld[3];
+            double alpha;
+            double beta;
+            char base[3];
+            long long offset[3];
+            long long start[3];
+            long long stride[3];
+            double * ptr[3];
+         };
+
+         //The S-object for which the plan is recorded
+         const Sobject * denS;
+
+         //The number of symmetry sectors of denS
+         int num_kappa;
+
+         //The length of the S-object vector
+         long long veclength;
+
+         //0: empty, 1: complete, 2: discarded
+         int status;
+
+         //The maximum memory of the plan in bytes
+         long long max_bytes;
+
+         //The recorded calls per sector: ops[ikappa][0:num_ops[ikappa]] with allocated size cap_ops[ikappa]
+         HeffPlanOp ** ops;
+         int * num_ops;
+         int * cap_ops;
+
+         //The tasks: sector, first and last recorded call, and offset of the partial result block (-1 if the task is the only one of its sector)
+         int num_units;
+         int * unit_kappa;
+         int * unit_first;
+         int * unit_last;
+         long long * unit_offset;
+
+         //The tasks of sector ikappa are kappa_unit[ ikappa ] to kappa_unit[ ikappa + 1 ] - 1
+         int * kappa_unit;
+
+         //The order in which the tasks are executed (decreasing cost)
+         int * unit_order;
+
+         //The number of vectors of the last prepare call
+         int num_vectors;
+
+         //The partial result blocks: partial_size per vector, allocated for partial_vectors vectors
+         long long partial_size;
+         int partial_vectors;
+         double * partial;
+
+         //The block layout of the S-object and result vectors, allocated for block_vectors vectors
+         int block_vectors;
+         double * block_S;
+         double * block_H;
+
+         //The recording state per thread: the sector (-1 when not recording), and the bases
+         int num_threads;
+         int * rec_ikappa;
+         double ** rec_base;
+         long long * rec_size;
+
+         //Get the calling thread
+         int thread() const;
+
+         //Append a new call to the sector recorded by thread th
+         HeffPlanOp * append( const int th );
+
+         //Set operand number of op to pointer
+         void classify( const int th, HeffPlanOp * op, const int number, double * pointer ) const;
+
+         //Clear the recorded calls
+         void clear_ops();
+
+         //Get the number of flops of a recorded call
+         static double cost( const HeffPlanOp & op );
+
+         //Divide the recorded calls into tasks
+         void divide();
+
+         //Classify the recorded calls for the block layout
+         void layout();
+
+         //Classify the num calls of one diagram group of sector ikappa for the block layout
+         void layout_group( const int ikappa, HeffPlanOp * group, const int num );
+
+         //Get the number of rows (rc=0) or columns (rc=1) of operand number of a recorded dgemm_ call
+         static int shape( const HeffPlanOp & op, const int number, const int rc );
+
+         //Get the number of array elements spanned by operand number of a recorded call
+         static long long extent( const HeffPlanOp & op, const int number );
+
+         //Get whether operand number of a recorded call covers its full area, so that the areas of the vectors form one array in the block layout
+         static bool contiguous( const HeffPlanOp & op, const int number );
+
+   };
+}
+
+#endif
@@ -31,8 +31,10 @@ extern "C" {
    void dscal_(int *n,double *alpha,double *x,int *incx);
    void dgemm_(char *transA,char *transB,int *m,int *n,int *k,double *alpha,double *A,int *lda,double *B,int *ldb,double *beta,double *C,int *ldc);
    void dgemv_(char *trans, int *m, int *n, double *alpha, double *A, int *lda, double *X, int *incx, double *beta, double *Y, int *incy);
+   void dsyrk_(char *uplo,char *trans,int *n,int *k,double *alpha,double *A,int *lda,double *beta,double *C,int *ldc);
    double ddot_(int *n,double *x,int *incx,double *y,int *incy);
    void dsyev_(char *jobz,char *uplo,int *n,double *A,int *lda,double *W,double *work,int *lwork,int *info);
+   void dsyevr_(char *jobz,char *range,char *uplo,int *n,double *A,int *lda,double *vl,double *vu,int *il,int *iu,double *abstol,int *m,double *W,double *Z,int *ldz,int *isuppz,double *work,int *lwork,int *iwork,int *liwork,int *info);
    void dgesdd_(char* JOBZ, int* M, int* N, double* A, int* LDA, double* S, double* U, int* LDU, double* VT, int* LDVT, double* WORK, int* LWORK, int* IWORK, int* INFO);
    void dlasrt_(char* id, int* n, double* vec, int* info);
    double dlansy_(char * norm, char * uplo, int * dimR, double * mx, int * lda, double * work);
@@ -0,0 +1,137 @@
+/*
+   CheMPS2: a spin-adapted implementation of DMRG for ab initio quantum chemistry
+   Copyright (C) 2013-2016 Sebastian Wouters
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#ifndef MPIBALANCE_CHEMPS2_H
+#define MPIBALANCE_CHEMPS2_H
+
+#include "SyBookkeeper.h"
+
+namespace CheMPS2{
+/** MPIbalance class.
+    \author Sebastian Wouters <sebastianwouters@gmail.com>
+    \date October 16, 2026
+
+    The MPIbalance class assigns the renormalized operators to the MPI processes. The {A,B,Sigma0,Sigma1}-tensors and the {C,D,F0,F1}-tensors of an orbital pair, the Q-tensors of an orbital, and the 3-index tensors of the 3-RDM of an orbital triple have the same owner at all boundaries, because each of them is renormalized from the tensor with the same orbitals at the neighbouring boundary.
+
+    The cost of such a group of tensors is estimated from the virtual dimensions in the SyBookkeeper: at each boundary where the group exists, a symmetry block of dimensions dim_up x dim_down contributes dim_up * dim_down * ( dim_up + dim_down ), which is proportional to the flops of its renormalization and of the effective Hamiltonian diagrams in which it occurs. The groups are assigned in order of decreasing cost to the process with the lowest total cost so far, the 3-RDM triples separately from the pairs and orbitals. The master process starts with the cost of the X-tensors. Before the first assignment, the owners are given by the round-robin formulas of MPIchemps2.
+
+    The owners of the active MPIbalance object are returned by MPIchemps2::owner_absigma, owner_cdf, owner_q, and owner_3rdm_diagram. The assignment may only change when no renormalized operators are allocated. */
+   class MPIbalance{
+
+      public:
+
+         //! Constructor
+         /** \param L The number of active space orbitals
+             \param num_procs The number of MPI processes */
+         MPIbalance( const int L, const int num_procs );
+
+         //! Destructor
+         virtual ~MPIbalance();
+
+         //! Assign the tensors to the processes based on the current virtual dimensions; all processes should call this function, and obtain the assignment of MPI_CHEMPS2_MASTER
+         /** \param denBK The SyBookkeeper with the virtual dimensions */
+         void assign( const SyBookkeeper * denBK );
+
+         //! Get the estimated load imbalance of the current assignment
+         /** \param denBK The SyBookkeeper with the virtual dimensions
+             \return The maximum over the average estimated cost of the renormalized operators of the sweeps per process */
+         double imbalance( const SyBookkeeper * denBK ) const;
+
+         //! Check whether the virtual dimensions have changed since the previous call to changed() or assign()
+         /** \param denBK The SyBookkeeper with the virtual dimensions
+             \return Whether the virtual dimensions have changed */
+         bool changed( const SyBookkeeper * denBK );
+
+         //! Get the owner of a certain {A,B,Sigma0,Sigma1}-tensor
+         /** \param index1 The first  DMRG lattice index of the tensor
+             \param index2 The second DMRG lattice index of the tensor
+             \return The owner rank */
+         int gOwnerABSigma( const int index1, const int index2 ) const;
+
+         //! Get the owner of a certain {C,D,F0,F1}-tensor
+         /** \param index1 The first  DMRG lattice index of the tensor
+             \param index2 The second DMRG lattice index of the tensor
+             \return The owner rank */
+         int gOwnerCDF( const int index1, const int index2 ) const;
+
+         //! Get the owner of a certain Q-tensor
+         /** \param index The DMRG lattice index of the tensor
+             \return The owner rank */
+         int gOwnerQ( const int index ) const;
+
+         //! Get the owner of a certain 3-index tensor for the 3-RDM
+         /** \param index1 The first  DMRG lattice index of the tensor
+             \param index2 The second DMRG lattice index of the tensor
+             \param index3 The third  DMRG lattice index of the tensor
+             \return The owner rank */
+         int gOwner3RDM( const int index1, const int index2, const int index3 ) const;
+
+         //! Get the number of entries of the assignment table
+         /** \return The number of entries of the assignment table */
+         int gTableSize() const;
+
+         //! Get the assignment table, to store it in or restore it from a checkpoint
+         /** \return Pointer to the assignment table */
+         int * gTable();
+
+         //! Make an MPIbalance object the one which is used by MPIchemps2
+         /** \param balance The MPIbalance object (NULL restores the round-robin formulas) */
+         static void activate( const MPIbalance * balance );
+
+         //! Get the MPIbalance object which is used by MPIchemps2
+         /** \return The active MPIbalance object (NULL if there is none) */
+         static const MPIbalance * gActive();
+
+      private:
+
+         //The number of active space orbitals
+         int L;
+
+         //The number of MPI processes
+         int num_procs;
+
+         //The number of orbital pairs and orbital triples
+         int num_pairs;
+         int num_triples;
+
+         //The owners: table[ pair ] for {A,B,Sigma0,Sigma1}, table[ num_pairs + pair ] for {C,D,F0,F1}, table[ 2 * num_pairs + orbital ] for Q, and table[ 2 * num_pairs + L + triple ] for the 3-RDM
+         int * table;
+
+         //The total virtual dimensions at the boundaries during the last call to changed() or assign()
+         int * bond_dims;
+
+         //The MPIbalance object which is used by MPIchemps2
+         static const MPIbalance * active;
+
+         //Estimate the costs of the pairs, orbitals, and triples (in the order of table), and the initial cost of the master process
+         void costs( const SyBookkeeper * denBK, double * cost, double * cost_master ) const;
+
+         //Get the cost dim_up * dim_down * ( dim_up + dim_down ) summed over the symmetry blocks of a tensor
+         static double block_cost( const SyBookkeeper * denBK, const int boundary, const int two_j, const int n_elec, const int n_irrep );
+
+         //Get the summed cost at the DMRG boundaries [ first, last ] from the partial sums of a tensor type and irrep
+         double range( const double * partial, const int first, const int last ) const;
+
+         //Assign items [ start, stop ) of the table in order of decreasing cost to the process with the lowest load
+         void longest_first( const double * cost, double * load, const int start, const int stop );
+
+   };
+}
+
+#endif
@@ -26,10 +26,15 @@
 
    #include <mpi.h>
    #include <assert.h>
+   #include <vector>
    #include "Tensor.h"
+   #include "MPIbalance.h"
 
    #define MPI_CHEMPS2_MASTER   0
 
+   //Maximum number of doubles per message (1 GB), so that arrays of 2^31 doubles or more are transferred in pieces below the 2 GB message limit
+   #define MPI_CHEMPS2_CHUNK    134217728
+
    //Assign diagrams which are not specifically owned round-robin
 
    #define MPI_CHEMPS2_4D1AB    1
@@ -119,7 +124,7 @@ namespace CheMPS2{
          static int mpi_size(){
             #ifdef CHEMPS2_MPI_COMPILATION
                int size;
-               MPI_Comm_size( MPI_COMM_WORLD, &size );
+               MPI_Comm_size( communicator(), &size );
                return size;
             #else
                return 1;
@@ -131,13 +136,38 @@ namespace CheMPS2{
          static int mpi_rank(){
             #ifdef CHEMPS2_MPI_COMPILATION
                int rank;
-               MPI_Comm_rank( MPI_COMM_WORLD, &rank );
+               MPI_Comm_rank( communicator(), &rank );
                return rank;
             #else
                return 0;
             #endif
          }
          
+         #ifdef CHEMPS2_MPI_COMPILATION
+         //! Get the communicator of the CheMPS2 calculations
+         /** \return MPI_COMM_SELF when the processes work on their own ( see set_process_local ), and MPI_COMM_WORLD otherwise */
+         static MPI_Comm communicator(){
+            return (( local_flag() ) ? MPI_COMM_SELF : MPI_COMM_WORLD );
+         }
+         #endif
+         
+         #ifdef CHEMPS2_MPI_COMPILATION
+         //! Let each process work on its own, or let the processes work together again
+         /** While the processes work on their own, mpi_size() is 1, each process is MPI_CHEMPS2_MASTER, and the owner functions ignore the active MPIbalance object. It may only be changed when no renormalized operators are allocated.
+             \param local Whether each process should work on its own */
+         static void set_process_local(const bool local){
+            local_flag() = local;
+         }
+         #endif
+         
+         #ifdef CHEMPS2_MPI_COMPILATION
+         //! Get whether each process works on its own
+         /** \return Whether each process works on its own */
+         static bool process_local(){
+            return local_flag();
+         }
+         #endif
+         
          #ifdef CHEMPS2_MPI_COMPILATION
          //! Initialize MPI
          static void mpi_init(){
@@ -159,40 +189,43 @@ namespace CheMPS2{
          #endif
          
          #ifdef CHEMPS2_MPI_COMPILATION
-         //! Get the owner of a certain {A,B,Sigma0,Sigma1}-tensor
+         //! Get the owner of a certain {A,B,Sigma0,Sigma1}-tensor (assigned by the active MPIbalance object, if any)
          /** \param index1 The first  DMRG lattice index of the tensor
              \param index2 The second DMRG lattice index of the tensor
              \return The owner rank */
          static int owner_absigma(const int index1, const int index2){ // 1 <= proc < 1 + L*(L+1)/2
             assert( index1 <= index2 );
+            if (( MPIbalance::gActive() != NULL ) && ( process_local() == false )){ return MPIbalance::gActive()->gOwnerABSigma( index1, index2 ); }
             return ( 1 + index1 + (index2*(index2+1))/2 ) % mpi_size();
          }
          #endif
          
          #ifdef CHEMPS2_MPI_COMPILATION
-         //! Get the owner of a certain {C,D,F0,F1}-tensor
+         //! Get the owner of a certain {C,D,F0,F1}-tensor (assigned by the active MPIbalance object, if any)
          /** \param L The number of active space orbitals
              \param index1 The first  DMRG lattice index of the tensor
              \param index2 The second DMRG lattice index of the tensor
              \return The owner rank */
          static int owner_cdf(const int L, const int index1, const int index2){ // 1 + L*(L+1)/2 <= proc < 1 + L*(L+1)
             assert( index1 <= index2 );
+            if (( MPIbalance::gActive() != NULL ) && ( process_local() == false )){ return MPIbalance::gActive()->gOwnerCDF( index1, index2 ); }
             return ( 1 + (L*(L+1))/2 + index1 + (index2*(index2+1))/2 ) % mpi_size();
          }
          #endif
          
          #ifdef CHEMPS2_MPI_COMPILATION
-         //! Get the owner of a certain Q-tensor
+         //! Get the owner of a certain Q-tensor (assigned by the active MPIbalance object, if any)
          /** \param L The number of active space orbitals
              \param index The DMRG lattice index of the tensor
              \return The owner rank */
          static int owner_q(const int L, const int index){ // 1 + L*(L+1) <= proc < 1 + L*(L+2)
+            if (( MPIbalance::gActive() != NULL ) && ( process_local() == false )){ return MPIbalance::gActive()->gOwnerQ( index ); }
             return ( 1 + L*(L+1) + index ) % mpi_size();
          }
          #endif
          
          #ifdef CHEMPS2_MPI_COMPILATION
-         //! Get the owner of a certain 3-index tensor for the 3-RDM
+         //! Get the owner of a certain 3-index tensor for the 3-RDM (assigned by the active MPIbalance object, if any)
          /** \param L The number of active space orbitals
              \param index1 The first  DMRG lattice index of the tensor
              \param index2 The second DMRG lattice index of the tensor
@@ -201,6 +234,7 @@ namespace CheMPS2{
          static int owner_3rdm_diagram(const int L, const int index1, const int index2, const int index3){ // 1 + L*(L+1) <= proc < 1 + L*(L+1) + L*(L+1)*(L+2)/6
             assert( index1 <= index2 );
             assert( index2 <= index3 );
+            if (( MPIbalance::gActive() != NULL ) && ( process_local() == false )){ return MPIbalance::gActive()->gOwner3RDM( index1, index2, index3 ); }
             return ( 1 + L*(L+1) + index1 + (index2*(index2+1))/2 + (index3*(index3+1)*(index3+2))/6 ) % mpi_size();
          }
          #endif
@@ -236,8 +270,8 @@ namespace CheMPS2{
          /** \param object The tensor to be broadcasted
              \param ROOT The MPI process which should broadcast */
          static void broadcast_tensor(Tensor * object, int ROOT){
-            int arraysize = object->gKappa2index(object->gNKappa());
-            MPI_Bcast(object->gStorage(), arraysize, MPI_DOUBLE, ROOT, MPI_COMM_WORLD);
+            const long long arraysize = object->gKappa2index(object->gNKappa());
+            broadcast_array_double(object->gStorage(), arraysize, ROOT);
          }
          #endif
          
@@ -246,8 +280,11 @@ namespace CheMPS2{
          /** \param array The array to be broadcasted
              \param length The length of the array
              \param ROOT The MPI process which should broadcast */
-         static void broadcast_array_double(double * array, int length, int ROOT){
-            MPI_Bcast(array, length, MPI_DOUBLE, ROOT, MPI_COMM_WORLD);
+         static void broadcast_array_double(double * array, const long long length, int ROOT){
+            for ( long long start = 0; start < length; start += MPI_CHEMPS2_CHUNK ){
+               const int piece = (( length - start < MPI_CHEMPS2_CHUNK ) ? ( int )( length - start ) : MPI_CHEMPS2_CHUNK );
+               MPI_Bcast(array + start, piece, MPI_DOUBLE, ROOT, communicator());
+            }
          }
          #endif
          
@@ -257,7 +294,7 @@ namespace CheMPS2{
              \param length The length of the array
              \param ROOT The MPI process which should broadcast */
          static void broadcast_array_int(int * array, int length, int ROOT){
-            MPI_Bcast(array, length, MPI_INT, ROOT, MPI_COMM_WORLD);
+            MPI_Bcast(array, length, MPI_INT, ROOT, communicator());
          }
          #endif
          
@@ -268,7 +305,7 @@ namespace CheMPS2{
          static bool all_booleans_equal(const bool mybool){
             int my_value = ( mybool ) ? 1 : 0 ;
             int tot_value;
-            MPI_Allreduce(&my_value, &tot_value, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+            MPI_Allreduce(&my_value, &tot_value, 1, MPI_INT, MPI_SUM, communicator());
             return ( my_value * MPIchemps2::mpi_size() == tot_value ); // Only true if mybool is the same for all processes
          }
          #endif
@@ -282,26 +319,115 @@ namespace CheMPS2{
          static void sendreceive_tensor(Tensor * object, int SENDER, int RECEIVER, int tag){
             if ( SENDER != RECEIVER ){
                const int MPIRANK = mpi_rank();
-               if ( SENDER == MPIRANK ){
-                  int arraysize = object->gKappa2index(object->gNKappa());
-                  MPI_Send(object->gStorage(), arraysize, MPI_DOUBLE, RECEIVER, tag, MPI_COMM_WORLD);
-               }
-               if ( RECEIVER == MPIRANK ){
-                  int arraysize = object->gKappa2index(object->gNKappa());
-                  MPI_Recv(object->gStorage(), arraysize, MPI_DOUBLE, SENDER, tag, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+               const long long arraysize = object->gKappa2index(object->gNKappa());
+               for ( long long start = 0; start < arraysize; start += MPI_CHEMPS2_CHUNK ){
+                  const int piece = (( arraysize - start < MPI_CHEMPS2_CHUNK ) ? ( int )( arraysize - start ) : MPI_CHEMPS2_CHUNK );
+                  if ( SENDER == MPIRANK ){
+                     MPI_Send(object->gStorage() + start, piece, MPI_DOUBLE, RECEIVER, tag, communicator());
+                  }
+                  if ( RECEIVER == MPIRANK ){
+                     MPI_Recv(object->gStorage() + start, piece, MPI_DOUBLE, SENDER, tag, communicator(), MPI_STATUS_IGNORE);
+                  }
                }
             }
          }
          #endif
          
+         #ifdef CHEMPS2_MPI_COMPILATION
+         //! Post the nonblocking send of a tensor to another process; the tensor should not change until the requests are completed
+         /** \param object The tensor to be sent
+             \param RECEIVER The MPI process which should receive the tensor
+             \param tag A tag which should be the same for the sender and receiver to make sure that the communication is desired
+             \param requests The outstanding requests, to which the requests of the send are added */
+         static void isend_tensor(Tensor * object, int RECEIVER, int tag, std::vector<MPI_Request> & requests){
+            const long long arraysize = object->gKappa2index(object->gNKappa());
+            for ( long long start = 0; start < arraysize; start += MPI_CHEMPS2_CHUNK ){
+               const int piece = (( arraysize - start < MPI_CHEMPS2_CHUNK ) ? ( int )( arraysize - start ) : MPI_CHEMPS2_CHUNK );
+               requests.push_back( MPI_REQUEST_NULL );
+               MPI_Isend(object->gStorage() + start, piece, MPI_DOUBLE, RECEIVER, tag, communicator(), &requests.back());
+            }
+         }
+         #endif
+         
+         #ifdef CHEMPS2_MPI_COMPILATION
+         //! Post the nonblocking receive of a tensor from another process; the tensor is only valid after the requests are completed
+         /** \param object The tensor to be received
+             \param SENDER The MPI process which should send the tensor
+             \param tag A tag which should be the same for the sender and receiver to make sure that the communication is desired
+             \param requests The outstanding requests, to which the requests of the receive are added */
+         static void irecv_tensor(Tensor * object, int SENDER, int tag, std::vector<MPI_Request> & requests){
+            const long long arraysize = object->gKappa2index(object->gNKappa());
+            for ( long long start = 0; start < arraysize; start += MPI_CHEMPS2_CHUNK ){
+               const int piece = (( arraysize - start < MPI_CHEMPS2_CHUNK ) ? ( int )( arraysize - start ) : MPI_CHEMPS2_CHUNK );
+               requests.push_back( MPI_REQUEST_NULL );
+               MPI_Irecv(object->gStorage() + start, piece, MPI_DOUBLE, SENDER, tag, communicator(), &requests.back());
+            }
+         }
+         #endif
+         
+         #ifdef CHEMPS2_MPI_COMPILATION
+         //! Post the nonblocking broadcast of a tensor; all processes should post their broadcasts in the same order
+         /** \param object The tensor to be broadcasted
+             \param ROOT The MPI process which should broadcast
+             \param requests The outstanding requests, to which the requests of the broadcast are added */
+         static void ibroadcast_tensor(Tensor * object, int ROOT, std::vector<MPI_Request> & requests){
+            const long long arraysize = object->gKappa2index(object->gNKappa());
+            for ( long long start = 0; start < arraysize; start += MPI_CHEMPS2_CHUNK ){
+               const int piece = (( arraysize - start < MPI_CHEMPS2_CHUNK ) ? ( int )( arraysize - start ) : MPI_CHEMPS2_CHUNK );
+               requests.push_back( MPI_REQUEST_NULL );
+               MPI_Ibcast(object->gStorage() + start, piece, MPI_DOUBLE, ROOT, communicator(), &requests.back());
+            }
+         }
+         #endif
+         
+         #ifdef CHEMPS2_MPI_COMPILATION
+         //! Post the nonblocking sum of arrays of all processes with the result for ROOT; all processes should post their reductions in the same order
+         /** \param vec_in The array which should be added
+             \param vec_out The array where the result should be stored
+             \param size The size of the array
+             \param ROOT The MPI process which should have the result vector
+             \param requests The outstanding requests, to which the requests of the reduction are added */
+         static void ireduce_array_double(double * vec_in, double * vec_out, const long long size, int ROOT, std::vector<MPI_Request> & requests){
+            for ( long long start = 0; start < size; start += MPI_CHEMPS2_CHUNK ){
+               const int piece = (( size - start < MPI_CHEMPS2_CHUNK ) ? ( int )( size - start ) : MPI_CHEMPS2_CHUNK );
+               requests.push_back( MPI_REQUEST_NULL );
+               MPI_Ireduce(vec_in + start, vec_out + start, piece, MPI_DOUBLE, MPI_SUM, ROOT, communicator(), &requests.back());
+            }
+         }
+         #endif
+         
+         #ifdef CHEMPS2_MPI_COMPILATION
+         //! Make progress on the outstanding requests without blocking; to be called between two computations
+         /** \param requests The outstanding requests
+             \return Whether all requests are completed */
+         static bool test_requests(std::vector<MPI_Request> & requests){
+            if ( requests.empty() ){ return true; }
+            int flag = 0;
+            MPI_Testall(( int ) requests.size(), &requests[ 0 ], &flag, MPI_STATUSES_IGNORE);
+            return ( flag != 0 );
+         }
+         #endif
+         
+         #ifdef CHEMPS2_MPI_COMPILATION
+         //! Wait until the outstanding requests are completed, and clear them
+         /** \param requests The outstanding requests */
+         static void wait_requests(std::vector<MPI_Request> & requests){
+            if ( requests.empty() ){ return; }
+            MPI_Waitall(( int ) requests.size(), &requests[ 0 ], MPI_STATUSES_IGNORE);
+            requests.clear();
+         }
+         #endif
+         
          #ifdef CHEMPS2_MPI_COMPILATION
          //! Add arrays of all processes and give result to ROOT
          /** \param vec_in The array which should be added
              \param vec_out The array where the result should be stored
              \param size The size of the array
              \param ROOT The MPI process which should have the result vector */
-         static void reduce_array_double(double * vec_in, double * vec_out, int size, int ROOT){
-            MPI_Reduce(vec_in, vec_out, size, MPI_DOUBLE, MPI_SUM, ROOT, MPI_COMM_WORLD);
+         static void reduce_array_double(double * vec_in, double * vec_out, const long long size, int ROOT){
+            std::vector<MPI_Request> requests; // The pieces are in flight together
+            ireduce_array_double(vec_in, vec_out, size, ROOT, requests);
+            wait_requests(requests);
          }
          #endif
          
@@ -310,8 +436,98 @@ namespace CheMPS2{
          /** \param vec_in The array which should be added
              \param vec_out The array where the result should be stored
              \param size The size of the array */
-         static void allreduce_array_double(double * vec_in, double * vec_out, int size){
-            MPI_Allreduce(vec_in, vec_out, size, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+         static void allreduce_array_double(double * vec_in, double * vec_out, const long long size){
+            for ( long long start = 0; start < size; start += MPI_CHEMPS2_CHUNK ){
+               const int piece = (( size - start < MPI_CHEMPS2_CHUNK ) ? ( int )( size - start ) : MPI_CHEMPS2_CHUNK );
+               MPI_Allreduce(vec_in + start, vec_out + start, piece, MPI_DOUBLE, MPI_SUM, communicator());
+            }
+         }
+         #endif
+
+         #ifdef CHEMPS2_MPI_COMPILATION
+         //! Get the maximum of a double over all processes
+         /** \param value The double of this process
+             \return The maximum over all processes */
+         static double allreduce_max_double(double value){
+            double result;
+            MPI_Allreduce(&value, &result, 1, MPI_DOUBLE, MPI_MAX, communicator());
+            return result;
+         }
+         #endif
+
+         #ifdef CHEMPS2_MPI_COMPILATION
+         //! Distribute the slices of a vector of ROOT over the processes
+         /** \param vector The full vector (only used on ROOT)
+             \param slice The slice of this process
+             \param slices Array of length mpi_size() + 1; the slice of process proc is [ slices[ proc ], slices[ proc + 1 ] ) of the full vector
+             \param ROOT The MPI process which has the full vector */
+         static void scatter_slices(double * vector, double * slice, const long long * slices, int ROOT){
+            std::vector<int> counts, displs;
+            slice_counts(slices, counts, displs);
+            MPI_Scatterv(vector, &counts[ 0 ], &displs[ 0 ], MPI_DOUBLE, slice, counts[ mpi_rank() ], MPI_DOUBLE, ROOT, communicator());
+         }
+         #endif
+
+         #ifdef CHEMPS2_MPI_COMPILATION
+         //! Collect the slices of all processes in a vector of ROOT
+         /** \param slice The slice of this process
+             \param vector The full vector (only used on ROOT)
+             \param slices Array of length mpi_size() + 1; the slice of process proc is [ slices[ proc ], slices[ proc + 1 ] ) of the full vector
+             \param ROOT The MPI process which should have the full vector */
+         static void gather_slices(double * slice, double * vector, const long long * slices, int ROOT){
+            std::vector<int> counts, displs;
+            slice_counts(slices, counts, displs);
+            MPI_Gatherv(slice, counts[ mpi_rank() ], MPI_DOUBLE, vector, &counts[ 0 ], &displs[ 0 ], MPI_DOUBLE, ROOT, communicator());
+         }
+         #endif
+
+         #ifdef CHEMPS2_MPI_COMPILATION
+         //! Give everyone the full vector, when each process has only set its own slice
+         /** \param vector The full vector, of which each process has set its own slice on entry
+             \param slices Array of length mpi_size() + 1; the slice of process proc is [ slices[ proc ], slices[ proc + 1 ] ) of the full vector */
+         static void allgather_slices(double * vector, const long long * slices){
+            std::vector<int> counts, displs;
+            slice_counts(slices, counts, displs);
+            MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, vector, &counts[ 0 ], &displs[ 0 ], MPI_DOUBLE, communicator());
+         }
+         #endif
+
+         #ifdef CHEMPS2_MPI_COMPILATION
+         //! Add full vectors of all processes and give each process its slice of the result
+         /** \param vec_in The full vector which should be added
+             \param slice The slice of the sum for this process
+             \param slices Array of length mpi_size() + 1; the slice of process proc is [ slices[ proc ], slices[ proc + 1 ] ) of the full vector */
+         static void reduce_scatter_slices(double * vec_in, double * slice, const long long * slices){
+            std::vector<int> counts, displs;
+            slice_counts(slices, counts, displs);
+            MPI_Reduce_scatter(vec_in, slice, &counts[ 0 ], MPI_DOUBLE, MPI_SUM, communicator());
+         }
+         #endif
+
+         #ifdef CHEMPS2_MPI_COMPILATION
+         //! Convert the slice boundaries to MPI counts and displacements
+         /** \param slices Array of length mpi_size() + 1 with the slice boundaries
+             \param counts On exit, the slice lengths
+             \param displs On exit, the slice offsets */
+         static void slice_counts(const long long * slices, std::vector<int> & counts, std::vector<int> & displs){
+            const int num_procs = mpi_size();
+            assert( slices[ num_procs ] <= 2147483647 ); // MPI counts and displacements are int
+            counts.resize( num_procs );
+            displs.resize( num_procs );
+            for ( int proc = 0; proc < num_procs; proc++ ){
+               counts[ proc ] = ( int )( slices[ proc + 1 ] - slices[ proc ] );
+               displs[ proc ] = ( int )( slices[ proc ] );
+            }
+         }
+         #endif
+
+      private:
+
+         #ifdef CHEMPS2_MPI_COMPILATION
+         //Whether each process works on its own (a function-local static, as MPIchemps2 is header-only)
+         static bool & local_flag(){
+            static bool local = false;
+            return local;
          }
          #endif
 
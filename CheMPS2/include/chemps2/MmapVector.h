@@ -0,0 +1,60 @@
+/*
+   CheMPS2: a spin-adapted implementation of DMRG for ab initio quantum chemistry
+   Copyright (C) 2013-2016 Sebastian Wouters
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#ifndef MMAPVECTOR_CHEMPS2_H
+#define MMAPVECTOR_CHEMPS2_H
+
+#include <string>
+
+namespace CheMPS2{
+/** MmapVector class.
+    \author Sebastian Wouters <sebastianwouters@gmail.com>
+    \date October 16, 2026
+
+    The MmapVector class allocates long vectors of doubles either in memory, or out-of-core in a scratch file. A scratch file is created in the given folder, mapped with mmap( MAP_SHARED ), and unlinked immediately, so that it disappears when the vector is released or the program stops. The pages of such a vector are backed by the file instead of by swap, so that the kernel can write them back and drop them when memory runs low. The disk space of a scratch file is reserved at allocation, so that a full disk stops the program with an error message instead of a SIGBUS during the calculation. The caller can ask the kernel to read a tile of the vector ahead of its use with prefetch(). */
+   class MmapVector{
+
+      public:
+
+         //! Allocate a vector
+         /** \param size The number of doubles
+             \param tmp_folder If empty, the vector is allocated in memory. Otherwise, the folder for the scratch file.
+             \return The vector; its contents are undefined */
+         static double * allocate( const long long size, const std::string tmp_folder );
+
+         //! Release a vector which was obtained with allocate()
+         /** \param vector The vector
+             \param size The number of doubles, as passed to allocate()
+             \param tmp_folder The folder, as passed to allocate() */
+         static void release( double * vector, const long long size, const std::string tmp_folder );
+
+         //! Ask the kernel to read a tile of an out-of-core vector ahead of its use; the call returns immediately
+         /** \param start Pointer to the first double of the tile
+             \param size The number of doubles in the tile */
+         static void prefetch( const double * start, const long long size );
+
+      private:
+
+         //Print the error message for the scratch file, with the error number if nonzero, and stop the program
+         static void fail( const std::string message, const std::string filename, const int error );
+
+   };
+}
+
+#endif
@@ -0,0 +1,137 @@
+/*
+   CheMPS2: a spin-adapted implementation of DMRG for ab initio quantum chemistry
+   Copyright (C) 2013-2016 Sebastian Wouters
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#ifndef MULTISHIFTSOLVER_CHEMPS2_H
+#define MULTISHIFTSOLVER_CHEMPS2_H
+
+#include <string>
+
+namespace CheMPS2{
+/** MultiShiftSolver class.
+    \author Sebastian Wouters <sebastianwouters@gmail.com>
+    \date October 16, 2026
+
+    The MultiShiftSolver class solves a family of shifted symmetric linear problems \n
+
+        \f$ ( operator + shift1_s * diag1 + shift2_s * diag2 ) * x_s = b \f$ \n
+
+    with diag1 and diag2 diagonal matrices, in one shared subspace. Only the unshifted operator is applied to the subspace vectors, so that one matrix-vector multiplication serves all shifts. The diagonal shifts are projected onto the subspace without additional multiplications. Per iteration, the projected problem of each shift is solved, and the subspace is extended with the diagonally preconditioned residual of the shift with the largest residual. When the subspace is full, it is collapsed onto the current solutions of all shifts. \n
+
+    As the shifts are not multiples of the identity, the Krylov spaces of the shifted problems differ, and the subspace is a Galerkin subspace rather than a Krylov space. For 5 to 10 nearby shifts, the number of matrix-vector multiplications is close to that of a single conjugate gradient solution.
+*/
+   class MultiShiftSolver{
+
+      public:
+
+         //! Constructor
+         /** \param veclength_in Linear dimension of the symmetric matrix
+             \param num_shifts_in The number of shifts
+             \param shift1_in Array of length num_shifts_in with the prefactors of diag1
+             \param shift2_in Array of length num_shifts_in with the prefactors of diag2
+             \param MAX_NUM_VEC_in The maximum number of subspace vectors; should be larger than num_shifts_in
+             \param RTOL_in The tolerance for the two-norm of the preconditioned residual of each shift
+             \param DIAG_CUTOFF_in The cutoff to truncate the diagonal elements of the shifted operators
+             \param print_in Whether or not to print
+             \param scratch_in If empty, the vectors are kept in memory. Otherwise, the folder in which the vectors are stored out-of-core as memory-mapped files (see MmapVector.h) */
+         MultiShiftSolver(const long long veclength_in, const int num_shifts_in, const double * shift1_in, const double * shift2_in, const int MAX_NUM_VEC_in, const double RTOL_in, const double DIAG_CUTOFF_in, const bool print_in, const std::string scratch_in = "");
+
+         //! Destructor
+         virtual ~MultiShiftSolver();
+
+         //! The iterator to converge the solutions of all shifts
+         /** \param pointers Array of double* of length 4 to return pointers to vectors to the caller
+             \return Instruction character. 'A' means copy the diagonal of the unshifted operator to pointers[0], the right-hand side of the problem to pointers[1], diag1 to pointers[2], and diag2 to pointers[3]. 'B' means calculate pointers[1] = unshifted operator times pointers[0]. 'C' means that the solutions of all shifts have converged, and can be obtained with get_solution(). 'D' means that an error has occurred. */
+         char step( double ** pointers );
+
+         //! Get the number of matrix vector multiplications which have been performed
+         /** \return The number of matrix vector multiplications which have been performed */
+         int get_num_matvec() const;
+
+         //! Get the residual norm of a shift, after convergence
+         /** \param shift The shift index
+             \return The two-norm of ( operator + shift1 * diag1 + shift2 * diag2 ) * x - b */
+         double get_residual_norm( const int shift ) const;
+
+         //! Get the solution of a shift, after convergence
+         /** \param shift The shift index
+             \param solution Array of length veclength, in which x is stored
+             \param op_solution Array of length veclength, in which the unshifted operator times x is stored */
+         void get_solution( const int shift, double * solution, double * op_solution ) const;
+
+      private:
+
+         long long veclength;
+         int num_shifts;
+         int MAX_NUM_VEC;
+         double RTOL;
+         double DIAG_CUTOFF;
+         bool print;
+         std::string scratch;
+
+         char state;     // Current state of the algorithm
+         int num_matvec; // Current number of matvec multiplications
+
+         // The shifts
+         double * shift1;
+         double * shift2;
+
+         // Vectors of length veclength
+         double * DIAG;
+         double * RHS;
+         double * DIAG1;
+         double * DIAG2;
+         double * u_vec;
+         double * r_vec;
+         double * t_vec;
+
+         // The orthonormal subspace vectors and the unshifted operator times these vectors
+         int num_vec;
+         int num_allocated;
+         double ** vecs;
+         double ** op_vecs;
+
+         // The projected operator, diag1, diag2, and right-hand side, with leading dimension MAX_NUM_VEC
+         double * proj_op;
+         double * proj_diag1;
+         double * proj_diag2;
+         double * proj_rhs;
+
+         // The projected solutions proj_sol[ i + MAX_NUM_VEC * shift ], and the residual norms of the shifts
+         double * proj_sol;
+         double * rnorms;
+
+         // Work arrays for the projected problems
+         double * mx_matrix;
+         double * mx_eigs;
+         double * mx_work;
+         int mx_lwork;
+
+         // Internal functions
+         double shifted_diagonal( const int shift, const long long elem ) const; // Truncated at DIAG_CUTOFF
+         bool add_vector(); // Orthonormalize t_vec against the subspace, and add it if it is linearly independent
+         void extend_projection(); // Project onto the last added vector
+         void solve_projected(); // Solve the projected problems of all shifts
+         void collapse(); // Collapse the subspace onto the current solutions of all shifts
+         void combine( double ** basis, const double * coeff, double * result ) const;
+         void transform_projection( double * matrix, const double * coeff, const int num_keep ) const;
+
+   };
+}
+
+#endif
@@ -0,0 +1,71 @@
+/*
+   CheMPS2: a spin-adapted implementation of DMRG for ab initio quantum chemistry
+   Copyright (C) 2013-2016 Sebastian Wouters
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#ifndef OPERATORSTORAGE_CHEMPS2_H
+#define OPERATORSTORAGE_CHEMPS2_H
+
+#include <string>
+
+#include "Tensor.h"
+
+namespace CheMPS2{
+/** Pure virtual OperatorStorage class.
+    \author Sebastian Wouters <sebastianwouters@gmail.com>
+    \date October 15, 2026
+
+    The OperatorStorage class defines the backend which DMRG::OperatorsOnDisk uses to write and read the renormalized operators of one boundary. Per boundary one file is opened, the batches of tensors are written or read in the same order, and the file is closed again. */
+   class OperatorStorage{
+
+      public:
+
+         //! Destructor
+         virtual ~OperatorStorage(){}
+
+         //! Open a file
+         /** \param filename The name of the file, without extension
+             \param store Whether the file is created for writing (true) or opened for reading (false) */
+         virtual void open( const std::string filename, const bool store ) = 0;
+
+         //! Get the extension which is appended to the file names
+         /** \return The extension of the files, including the dot */
+         virtual std::string extension() const = 0;
+
+         //! Close the file
+         /** \return The size of the file in bytes after writing; 0 after reading */
+         virtual long long close() = 0;
+
+         //! Write a batch of tensors
+         /** \param number The number of tensors in the batch
+             \param batch The tensors
+             \param totalsize The total number of doubles in the batch
+             \param tag The name of the batch
+             \param lossy Whether the batch may be stored with a bounded error, if the backend supports it */
+         virtual void write_batch( const int number, Tensor ** batch, const long long totalsize, const std::string tag, const bool lossy ) = 0;
+
+         //! Read a batch of tensors
+         /** \param number The number of tensors in the batch
+             \param batch The tensors
+             \param totalsize The total number of doubles in the batch
+             \param tag The name of the batch */
+         virtual void read_batch( const int number, Tensor ** batch, const long long totalsize, const std::string tag ) = 0;
+
+   };
+}
+
+#endif
@@ -0,0 +1,93 @@
+/*
+   CheMPS2: a spin-adapted implementation of DMRG for ab initio quantum chemistry
+   Copyright (C) 2013-2016 Sebastian Wouters
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#ifndef OPERATORSTORAGEHDF5_CHEMPS2_H
+#define OPERATORSTORAGEHDF5_CHEMPS2_H
+
+#include "OperatorStorage.h"
+#include "MyHDF5.h"
+#include "Options.h"
+
+namespace CheMPS2{
+/** OperatorStorageHDF5 class.
+    \author Sebastian Wouters <sebastianwouters@gmail.com>
+    \date October 15, 2026
+
+    The OperatorStorageHDF5 class writes the renormalized operators of one boundary to an HDF5 file, with one group per batch of tensors. The tensors of a batch are written with hyperslabs into a single dataset, which can optionally be compressed (see the constructor). */
+   class OperatorStorageHDF5 : public OperatorStorage{
+
+      public:
+
+         //! Constructor
+         /** \param deflate_level_in Shuffle + deflate level (1-9) of the datasets; 0 stores them uncompressed
+             \param lossy_digits_in If > 0, the batches written with lossy == true are rounded to this number of decimals (needs deflate_level_in > 0) */
+         OperatorStorageHDF5( const int deflate_level_in=CheMPS2::DMRG_OPERATOR_deflate_level, const int lossy_digits_in=CheMPS2::DMRG_OPERATOR_lossy_digits );
+
+         //! Destructor
+         virtual ~OperatorStorageHDF5();
+
+         //! Open the file filename.h5
+         /** \param filename The name of the file, without extension
+             \param store Whether the file is created for writing (true) or opened for reading (false) */
+         void open( const std::string filename, const bool store );
+
+         //! Get the extension which is appended to the file names
+         /** \return The extension of the files, including the dot */
+         std::string extension() const;
+
+         //! Close the file
+         /** \return The size of the file in bytes after writing; 0 after reading */
+         long long close();
+
+         //! Write a batch of tensors to the group tag
+         /** \param number The number of tensors in the batch
+             \param batch The tensors
+             \param totalsize The total number of doubles in the batch
+             \param tag The name of the batch
+             \param lossy Whether the scale-offset filter may be used (see the constructor) */
+         void write_batch( const int number, Tensor ** batch, const long long totalsize, const std::string tag, const bool lossy );
+
+         //! Read a batch of tensors from the group tag
+         /** \param number The number of tensors in the batch
+             \param batch The tensors
+             \param totalsize The total number of doubles in the batch
+             \param tag The name of the batch */
+         void read_batch( const int number, Tensor ** batch, const long long totalsize, const std::string tag );
+
+      private:
+
+         //The name of the open file
+         std::string name;
+
+         //The open file
+         hid_t file_id;
+
+         //Whether the open file is written
+         bool storing;
+
+         //The shuffle + deflate level; 0 means uncompressed
+         int deflate_level;
+
+         //The number of decimals for the scale-offset filter; 0 means lossless
+         int lossy_digits;
+
+   };
+}
+
+#endif
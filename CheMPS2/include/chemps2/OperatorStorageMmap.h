@@ -0,0 +1,95 @@
+/*
+   CheMPS2: a spin-adapted implementation of DMRG for ab initio quantum chemistry
+   Copyright (C) 2013-2016 Sebastian Wouters
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#ifndef OPERATORSTORAGEMMAP_CHEMPS2_H
+#define OPERATORSTORAGEMMAP_CHEMPS2_H
+
+#include "OperatorStorage.h"
+
+namespace CheMPS2{
+/** OperatorStorageMmap class.
+    \author Sebastian Wouters <sebastianwouters@gmail.com>
+    \date October 15, 2026
+
+    The OperatorStorageMmap class writes the renormalized operators of one boundary to a flat binary file. Each batch of tensors starts on a page boundary with a small header (tag and size), followed by the raw doubles. The batches are accessed with mmap, so that the kernel page cache handles the data transfer without the library overhead of HDF5. The files are not portable between machines, and the lossy option is ignored. A full disk, an I/O error, or a truncated or mismatched file stops the program with an error message. */
+   class OperatorStorageMmap : public OperatorStorage{
+
+      public:
+
+         //! Constructor
+         OperatorStorageMmap();
+
+         //! Destructor
+         virtual ~OperatorStorageMmap();
+
+         //! Open the file filename.bin
+         /** \param filename The name of the file, without extension
+             \param store Whether the file is created for writing (true) or opened for reading (false) */
+         void open( const std::string filename, const bool store );
+
+         //! Get the extension which is appended to the file names
+         /** \return The extension of the files, including the dot */
+         std::string extension() const;
+
+         //! Close the file
+         /** \return The size of the file in bytes after writing; 0 after reading */
+         long long close();
+
+         //! Write a batch of tensors at the next page boundary
+         /** \param number The number of tensors in the batch
+             \param batch The tensors
+             \param totalsize The total number of doubles in the batch
+             \param tag The name of the batch
+             \param lossy Ignored */
+         void write_batch( const int number, Tensor ** batch, const long long totalsize, const std::string tag, const bool lossy );
+
+         //! Read a batch of tensors from the next page boundary
+         /** \param number The number of tensors in the batch
+             \param batch The tensors
+             \param totalsize The total number of doubles in the batch
+             \param tag The name of the batch */
+         void read_batch( const int number, Tensor ** batch, const long long totalsize, const std::string tag );
+
+      private:
+
+         //The name of the open file
+         std::string name;
+
+         //The file descriptor of the open file
+         int fd;
+
+         //Whether the open file is written
+         bool storing;
+
+         //The offset of the next batch in the file (a multiple of the page size)
+         long long offset;
+
+         //The page size
+         long long page_size;
+
+         //Map the next batch into memory
+         char * map_batch( const long long num_bytes, const bool writable );
+
+         //Print the error message for the open file, with the error number if nonzero, and stop the program
+         void fail( const std::string message, const int error ) const;
+
+   };
+}
+
+#endif
@@ -40,6 +40,8 @@ namespace CheMPS2{
    const int    DMRGSCF_whichActiveSpace      = 0;
    const bool   DMRGSCF_dumpCorrelations      = false;
    const bool   DMRGSCF_startLocRandom        = false;
+   const double DMRGSCF_warmStartBranch       = -1.0; // Continue from the MPS of the previous iteration when the 2-norm of the orbital update is smaller (e.g. 1e-1); negative disables the warm starts
+   const bool   DMRGSCF_CASPT2outOfCore       = false; // Store the CASPT2 vectors as memory-mapped files in the tmp_folder of CASSCF
 
    const bool   DMRGSCF_doDIIS                = false;
    const double DMRGSCF_DIISgradientBranch    = 1e-2;
@@ -54,9 +56,19 @@ namespace CheMPS2{
 
    const string defaultTMPpath                = "/tmp";
    const bool   DMRG_storeRenormOptrOnDisk    = true;
+   const bool   DMRG_asyncOperatorIO          = true;   // Write and prefetch the renormalized operators in a background thread during the sweeps
+   const double DMRG_OPERATOR_memory_budget   = ( DMRG_storeRenormOptrOnDisk ? 0.0 : -1.0 ); // Default memory budget (MB) for the renormalized operators; 0.0 keeps only the current boundaries in memory, negative keeps all
+   const char   DMRG_OPERATOR_storage         = 'H';    // File format of the renormalized operators on disk: HDF5 ( 'H' ) or memory-mapped flat files ( 'M' )
+   const int    DMRG_OPERATOR_deflate_level   = 0;      // Default shuffle + deflate level (1-9) for the renormalized operators in HDF5 files; 0 stores them uncompressed
+   const int    DMRG_OPERATOR_lossy_digits    = 0;      // Default: if > 0, the A, B, C, D, and Q operators in HDF5 files are rounded to this number of decimals (needs a deflate level > 0)
+   const int    DMRG_OPERATOR_chunk_size      = 65536;  // Number of doubles per compressed chunk of renormalized operators
    const bool   DMRG_storeMpsOnDisk           = false;
    const string DMRG_MPS_storage_prefix       = "CheMPS2_MPS";
    const string DMRG_OPERATOR_storage_prefix  = "CheMPS2_Operators_";
+   const double DMRG_RESTART_interval         = 3600.0; // Minimum wall time (seconds) between two mid-sweep checkpoints of the MPS and the renormalized operators when MPS checkpoints are made; negative disables them
+   const string DMRG_RESTART_storage_prefix   = "CheMPS2_Restart_";
+   const double DMRG_MPI_REBALANCE_threshold  = 1.1;    // With MPI, the renormalized operators are reassigned to the processes when the bond dimensions have changed and the estimated load imbalance ( maximum / average ) of the current assignment exceeds this threshold
+   const double DMRG_expansion_prefactor      = 1e-4;   // Default prefactor alpha of the subspace expansion in the one-site sweeps: the terms of H across the truncated bond enter its reduced density matrix with weight alpha^2
 
    const bool   HAMILTONIAN_debugPrint        = false;
    const string HAMILTONIAN_TmatStorageName   = "CheMPS2_Ham_Tmat.h5";
@@ -67,13 +79,27 @@ namespace CheMPS2{
    const string THREE_RDM_storage_prefix      = "CheMPS2_3DM_";
 
    const bool   HEFF_debugPrint               = true;
+   const int    HEFF_PLAN_MAX_MB              = 1024;   // Above this size, the contraction plan of a site is discarded
    const int    DAVIDSON_NUM_VEC              = 32;
    const int    DAVIDSON_NUM_VEC_KEEP         = 3;
    const double DAVIDSON_PRECOND_CUTOFF       = 1e-12;
    const double DAVIDSON_FCI_RTOL             = 1e-10;  // Base value for FCI and augmented Hessian diagonalization
    const double DAVIDSON_DMRG_RTOL            = 1e-5;   // Block's Davidson tolerance would correspond to HEFF_DAVIDSON_DMRG_RTOL^2
+   const bool   DAVIDSON_DMRG_ADAPTIVE        = true;   // Loosen the Davidson tolerance of a site based on its energy change over the last sweep and the discarded weight of its bond; the user tolerance is the lower bound
+   const double DAVIDSON_DMRG_ADAPTIVE_MAX    = 1e-3;   // Upper bound for the adaptive Davidson tolerance
+   const double DAVIDSON_DMRG_ADAPTIVE_FACTOR = 0.1;    // The adaptive Davidson tolerance is this factor times the square root of the energy change or discarded weight
+   const int    DAVIDSON_MPI_DISTRIBUTE_size  = 1000000; // With MPI, the Davidson vectors of the two-site effective Hamiltonian are distributed over the processes from this vector length on (default of DMRG::setDavidsonDistributeSize)
 
    const int    SYBK_dimensionCutoff          = 262144;
+   const int    WIGNER_TABLE_MAX_MB           = 64;     // Maximum size of the table of Wigner-6j symbols
+
+   #ifdef CHEMPS2_LAPACK_THREADSAFE
+   const bool   SPLIT_LAPACK_threadsafe       = true;   // Whether LAPACK may be called by several OpenMP threads at once: set by CMake for MKL and with -DLAPACK_THREADSAFE=ON
+   #else
+   const bool   SPLIT_LAPACK_threadsafe       = false;  // Whether LAPACK may be called by several OpenMP threads at once: set by CMake for MKL and with -DLAPACK_THREADSAFE=ON
+   #endif
+   const bool   SPLIT_LAPACK_threaded         = true;   // Decompose the center sectors which dominate the cost of Sobject::Split one after another, with the threads of the LAPACK library
+   const int    SPLIT_EIGEN_factor            = 4;      // Use the reduced density matrix of a center sector if ( D + 1 ) * SPLIT_EIGEN_factor <= its rank; 0 always uses dgesdd
 
    const double TENSORT_orthoComparison       = 1e-13;
 
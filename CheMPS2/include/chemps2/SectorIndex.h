@@ -0,0 +1,75 @@
+/*
+   CheMPS2: a spin-adapted implementation of DMRG for ab initio quantum chemistry
+   Copyright (C) 2013-2016 Sebastian Wouters
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#ifndef SECTORINDEX_CHEMPS2_H
+#define SECTORINDEX_CHEMPS2_H
+
+namespace CheMPS2{
+/** SectorIndex class.
+    \author Sebastian Wouters <sebastianwouters@gmail.com>
+    \date October 16, 2026
+
+    The SectorIndex class is a dense index from the left or up quantum numbers ( N, 2S, I ) of a symmetry sector to the sectors of a tensor. The sectors of TensorT, TensorOperator, and Sobject are constructed in loops over N, 2S, and I (in that order) of the left or up boundary, so that all sectors with the same ( N, 2S, I ) are consecutive. For each ( N, 2S, I ), SectorIndex stores the first sector, in the same way as kappa2index stores the first element of each block. The gKappa functions then only compare the remaining quantum numbers of the few sectors in this range, instead of scanning all sectors. */
+   class SectorIndex{
+
+      public:
+
+         //! Constructor
+         /** \param num_sectors The number of sectors
+             \param sector_n The left or up particle number of each sector
+             \param sector_two_s Two times the left or up spin of each sector
+             \param sector_irrep The left or up irrep of each sector
+             \param num_irreps The number of irreps */
+         SectorIndex( const int num_sectors, const int * sector_n, const int * sector_two_s, const int * sector_irrep, const int num_irreps );
+
+         //! Destructor
+         virtual ~SectorIndex();
+
+         //! Get the key of the left or up quantum numbers
+         /** \param N The left or up particle number
+             \param TwoS Two times the left or up spin
+             \param I The left or up irrep
+             \return The key; -1 means that no sector has these quantum numbers */
+         int gKey( const int N, const int TwoS, const int I ) const;
+
+         //! Get the first sector of a key
+         /** \param key The key
+             \return The first sector with the quantum numbers of key */
+         int gBegin( const int key ) const{ return first[ key ]; }
+
+         //! Get one past the last sector of a key
+         /** \param key The key
+             \return One past the last sector with the quantum numbers of key */
+         int gEnd( const int key ) const{ return first[ key + 1 ]; }
+
+      private:
+
+         //The range of the quantum numbers
+         int n_min;
+         int num_n;
+         int num_s;
+         int num_irreps;
+
+         //The sectors with key are first[ key ] to first[ key + 1 ] - 1
+         int * first;
+
+   };
+}
+
+#endif
@@ -0,0 +1,196 @@
+/*
+   CheMPS2: a spin-adapted implementation of DMRG for ab initio quantum chemistry
+   Copyright (C) 2013-2016 Sebastian Wouters
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#ifndef SIXINDEX_CHEMPS2_H
+#define SIXINDEX_CHEMPS2_H
+
+namespace CheMPS2{
+/** SixIndex class.
+    \author Sebastian Wouters <sebastianwouters@gmail.com>
+    \date October 16, 2026
+
+    Container class for six-index tensors with the symmetry of the spin-summed 3-RDM \f$ \Gamma_{ijk;lmn} = \sum_{\sigma \tau s} \braket{ a^{\dagger}_{i \sigma} a^{\dagger}_{j \tau} a^{\dagger}_{k s} a_{n s} a_{m \tau} a_{l \sigma}} \f$, and of its contraction with the Fock operator for CASPT2. The element \f$ T_{ijk;lmn} \f$ only depends on the set of orbital pairs \f$ \{ (i,l), (j,m), (k,n) \} \f$ (6-fold permutation symmetry), and is only nonzero when \f$ I_{i} \otimes I_{j} \otimes I_{k} = I_{l} \otimes I_{m} \otimes I_{n} \f$. All L*L orbital pairs ( creator, annihilator ) get a key, so that the pairs with the same irrep \f$ I_{pair} = I_{creator} \otimes I_{annihilator} \f$ have consecutive keys. Only the elements with key1 <= key2 <= key3 are stored, and with the irrep selection rule, \f$ I_{pair1} \otimes I_{pair2} = I_{pair3} \f$. The storage is therefore about 6 times the number of irreps smaller than L^6, and uses 64-bit offsets.
+
+    The unique elements are visited with:\n
+    for ( key3 = 0; key3 < get_num_pairs(); key3++ ){ for ( key2 = 0; key2 <= key3; key2++ ){ irrep1 = get_pair_irrep( key2 ) ^ get_pair_irrep( key3 ); for ( key1 = get_pair_begin( irrep1 ); key1 < min( key2 + 1, get_pair_end( irrep1 ) ); key1++ ){ ... }}} */
+   class SixIndex{
+
+      public:
+
+         //! Constructor
+         /** \param L_in The number of orbitals
+             \param irreps_in Array of size L_in with the irrep of each orbital (see Irreps.h) */
+         SixIndex( const int L_in, const int * irreps_in );
+
+         //! Destructor
+         virtual ~SixIndex();
+
+         //! Set all elements to zero
+         void clear();
+
+         //! Get the number of orbitals
+         /** \return The number of orbitals */
+         int get_L() const{ return L; }
+
+         //! Get the number of stored elements
+         /** \return The number of stored elements */
+         long long get_array_size() const{ return array_size; }
+
+         //! Get the stored elements, e.g. for BLAS or MPI operations on SixIndex objects with the same orbital irreps
+         /** \return Pointer to the stored elements */
+         double * get_storage(){ return elements; }
+
+         //! Get an element
+         /** \param i The first creator
+             \param j The second creator
+             \param k The third creator
+             \param l The first annihilator
+             \param m The second annihilator
+             \param n The third annihilator
+             \return The element, or zero if it is forbidden by symmetry */
+         double get( const int i, const int j, const int k, const int l, const int m, const int n ) const;
+
+         //! Set an element (and all its permutations)
+         /** \param i The first creator
+             \param j The second creator
+             \param k The third creator
+             \param l The first annihilator
+             \param m The second annihilator
+             \param n The third annihilator
+             \param value The value to which the element should be set */
+         void set( const int i, const int j, const int k, const int l, const int m, const int n, const double value );
+
+         //! Add a double to an element (and all its permutations)
+         /** \param i The first creator
+             \param j The second creator
+             \param k The third creator
+             \param l The first annihilator
+             \param m The second annihilator
+             \param n The third annihilator
+             \param value The value which should be added to the element */
+         void add( const int i, const int j, const int k, const int l, const int m, const int n, const double value );
+
+         //! Whether an index combination is the stored representative of its permutations, and allowed by symmetry
+         /** \param i The first creator
+             \param j The second creator
+             \param k The third creator
+             \param l The first annihilator
+             \param m The second annihilator
+             \param n The third annihilator
+             \return Whether the orbital pairs ( i, l ), ( j, m ), and ( k, n ) have increasing keys, and the element is allowed by symmetry */
+         bool canonical( const int i, const int j, const int k, const int l, const int m, const int n ) const;
+
+         //! Get the number of orbital pairs
+         /** \return L * L */
+         int get_num_pairs() const{ return L * L; }
+
+         //! Get the creator of an orbital pair
+         /** \param key The key of the orbital pair
+             \return The creator orbital */
+         int get_pair_creator( const int key ) const{ return pair_creator[ key ]; }
+
+         //! Get the annihilator of an orbital pair
+         /** \param key The key of the orbital pair
+             \return The annihilator orbital */
+         int get_pair_annihilator( const int key ) const{ return pair_annihilator[ key ]; }
+
+         //! Get the irrep of an orbital pair
+         /** \param key The key of the orbital pair
+             \return The direct product of the irreps of the creator and the annihilator */
+         int get_pair_irrep( const int key ) const{ return pair_irrep[ key ]; }
+
+         //! Get the first key of the orbital pairs with a given irrep
+         /** \param irrep The irrep of the orbital pairs
+             \return The first key */
+         int get_pair_begin( const int irrep ) const{ return pair_begin[ irrep ]; }
+
+         //! Get one past the last key of the orbital pairs with a given irrep
+         /** \param irrep The irrep of the orbital pairs
+             \return One past the last key */
+         int get_pair_end( const int irrep ) const{ return pair_begin[ irrep + 1 ]; }
+
+         //! Get the position of a unique element in get_storage()
+         /** \param key1 The key of the first orbital pair
+             \param key2 The key of the second orbital pair, key1 <= key2
+             \param key3 The key of the third orbital pair, key2 <= key3 and with irrep get_pair_irrep( key1 ) ^ get_pair_irrep( key2 )
+             \return The position of the element */
+         long long get_pointer_keys( const int key1, const int key2, const int key3 ) const;
+
+         //! Fill a dense slice with fixed third annihilator: slice[ i + L * ( j + L * ( k + L * ( l + L * m ))) ] = T_{ijk;lm(last_orb)}
+         /** \param slice Array of size L^5
+             \param last_orb The third annihilator */
+         void fill_dense_slice( double * slice, const int last_orb ) const;
+
+         //! Add a dense slice with fixed third annihilator to a packed array: packed[ get_pointer_keys( key1, key2, key3 ) ] += alpha * slice[ i + L * ( j + L * ( k + L * ( l + L * m ))) ] for the unique elements whose third orbital pair key3 = ( k, last_orb )
+         /** Each unique element has exactly one such last_orb, hence adding the slices of all last_orb visits every element once.
+             \param slice Array of size L^5 with the layout of fill_dense_slice()
+             \param last_orb The third annihilator
+             \param alpha The prefactor of the slice
+             \param packed Array of size get_array_size() with the layout of get_storage() */
+         void add_dense_slice( const double * slice, const int last_orb, const double alpha, double * packed ) const;
+
+         //! Fill a dense array: dense[ i + L * ( j + L * ( k + L * ( l + L * ( m + L * n )))) ] = T_{ijk;lmn}
+         /** \param dense Array of size L^6 */
+         void fill_dense( double * dense ) const;
+
+         //! Set all elements from a dense array with the layout of fill_dense()
+         /** \param dense Array of size L^6, which should have the symmetry of the SixIndex class */
+         void read_dense( const double * dense );
+
+         #ifdef CHEMPS2_MPI_COMPILATION
+         //! Broadcast the elements to all processes
+         /** \param ROOT The process which should broadcast */
+         void broadcast( const int ROOT );
+         #endif
+
+      private:
+
+         //The number of orbitals
+         int L;
+
+         //The number of irreps, a power of 2 which is larger than all orbital irreps
+         int num_irreps;
+
+         //The key of the orbital pair ( creator, annihilator ) is pair_key[ creator + L * annihilator ]
+         int * pair_key;
+
+         //The creator, annihilator, and irrep of each key
+         int * pair_creator;
+         int * pair_annihilator;
+         int * pair_irrep;
+
+         //The keys of the orbital pairs with irrep I are pair_begin[ I ] to pair_begin[ I + 1 ] - 1
+         int * pair_begin;
+
+         //The position of the first element of the block with ordered pair irreps I1 <= I2 <= I3 = I1 ^ I2 is block_start[ I1 + num_irreps * I2 ]
+         long long * block_start;
+
+         //The number of stored elements
+         long long array_size;
+
+         //The stored elements
+         double * elements;
+
+         //Get the position of an element; -1 if it is forbidden by symmetry
+         long long get_pointer( const int i, const int j, const int k, const int l, const int m, const int n ) const;
+
+   };
+}
+
+#endif
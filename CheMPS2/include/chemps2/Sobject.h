@@ -22,6 +22,8 @@
 
 #include "TensorT.h"
 #include "SyBookkeeper.h"
+#include "Workspace.h"
+#include "SectorIndex.h"
 
 namespace CheMPS2{
 /** Sobject class.
@@ -67,7 +69,7 @@ namespace CheMPS2{
          //! Get the storage jump corresponding to a certain symmetry block
          /** \param kappa The symmetry block
              \return kappa2index[kappa], the memory jumper to a certain block */
-         int gKappa2index( const int kappa ) const;
+         long long gKappa2index( const int kappa ) const;
 
          //! Get the pointer to the storage of a certain symmetry block
          /** \param NL The left particle number sector
@@ -97,8 +99,14 @@ namespace CheMPS2{
              \param virtualdimensionD The virtual dimension which is partitioned over the different symmetry blocks based on the Schmidt spectrum
              \param movingright When true, the singular values are multiplied into V^T, when false, into U.
              \param change Whether or not the symmetry virtual dimensions are allowed to change (when false: D doesn't matter)
-             \return the discarded weight if change==true ; else 0.0 */
-         double Split( TensorT * Tleft, TensorT * Tright, const int virtualdimensionD, const bool movingright, const bool change );
+             \param num_extra The number of additional roots which share the renormalized basis (state averaging with equal weights)
+             \param extra_S The S-objects of the additional roots, at the same index
+             \param extra_T TensorT storage space for the additional roots. At output they contain the projection of extra_S on the shared basis, at site index + 1 when movingright and at site index otherwise.
+             \param work The persistent work arrays for the SVDs (if NULL, they are allocated locally)
+             \param max_discarded_weight If larger than 0.0, the smallest number of states for which the discarded weight does not exceed max_discarded_weight is kept, with virtualdimensionD as upper bound
+             \param min_dimension The lower bound for the number of states if max_discarded_weight > 0.0
+             \return the discarded weight of the ( state-averaged ) reduced density matrix if change==true ; else 0.0 */
+         double Split( TensorT * Tleft, TensorT * Tright, const int virtualdimensionD, const bool movingright, const bool change, const int num_extra = 0, Sobject ** extra_S = NULL, TensorT ** extra_T = NULL, Workspace * work = NULL, const double max_discarded_weight = 0.0, const int min_dimension = 1 );
 
          //! Add noise to the current S-object
          /** \param NoiseLevel The noise added to the S-object is of size (-0.5 < random number < 0.5) * NoiseLevel / infinity-norm(gStorage()) */
@@ -189,7 +197,10 @@ namespace CheMPS2{
          int * sectorIR;
 
          //! kappa2index[ kappa ] indicates the start of tensor block kappa in storage. kappa2index[ nKappa ] gives the size of storage.
-         int * kappa2index;
+         long long * kappa2index;
+
+         //! Index from the left quantum numbers ( NL, TwoSL, IL ) to the symmetry blocks, used by gKappa
+         SectorIndex * sector_index;
 
          //! The actual variables. Symmetry block kappa begins at storage + kappa2index[ kappa ] and ends at storage + kappa2index[ kappa + 1 ].
          double * storage;
@@ -197,6 +208,22 @@ namespace CheMPS2{
          //! The array reorder: blocksize( reorder[ i ] ) >= blocksize( reorder[ i + 1 ] ), with blocksize( k ) = kappa2index[ k + 1 ] - kappa2index[ k ]
          int * reorder;
 
+         //! Get the ( 2j + 1 )-weighted sum of the squared singular values of Split which are smaller than or equal to lower_bound, including the tails which are not computed
+         static double discarded_sum( const double lower_bound, const int num_center, const int * two_j, const int * dims, double ** lambdas, const double * tails, double * total_sum );
+
+         //! Decompose a center block mem = U * diag( lambda ) * VT of Split
+         /** \param mem The center block of size rows x cols; it is destroyed
+             \param rows The number of rows of mem
+             \param cols The number of columns of mem
+             \param rank The number of singular values to compute: min( rows, cols ) with dgesdd, or less with dsyevr on the reduced density matrix of the side which becomes left- ( movingright ) or right-normalized ( !movingright )
+             \param movingright Whether the sweep moves right
+             \param lambda The largest rank singular values in decreasing order
+             \param u The rows x rank left singular vectors
+             \param vt The rank x cols right singular vectors
+             \param arena The work arrays of the calling thread
+             \return The squared norm of mem which is not covered by the computed singular values */
+         static double decompose( double * mem, int rows, int cols, int rank, const bool movingright, double * lambda, double * u, double * vt, Workspace * arena );
+
    };
 }
 
@@ -20,6 +20,8 @@
 #ifndef SPECIAL_CHEMPS2_H
 #define SPECIAL_CHEMPS2_H
 
+#include "Lapack.h"
+
 namespace CheMPS2{
 /** Special class.
     \author Sebastian Wouters <sebastianwouters@gmail.com>
@@ -75,6 +77,69 @@ namespace CheMPS2{
 
          }
 
+         //! The maximum length of a single BLAS call in the 64-bit vector functions
+         static const int blas_chunk = 1073741824;
+
+         //! Vector copy y = x for vectors of length n which may exceed 2^31 - 1
+         /** \param n The vector length
+             \param x The vector to copy
+             \param y The vector to overwrite */
+         static void dcopy64( const long long n, double * x, double * y ){
+
+            int inc = 1;
+            for ( long long start = 0; start < n; start += blas_chunk ){
+               int length = (( n - start < blas_chunk ) ? ( int )( n - start ) : blas_chunk );
+               dcopy_( &length, x + start, &inc, y + start, &inc );
+            }
+
+         }
+
+         //! Vector update y = y + alpha * x for vectors of length n which may exceed 2^31 - 1
+         /** \param n The vector length
+             \param alpha The prefactor
+             \param x The vector to add
+             \param y The vector to update */
+         static void daxpy64( const long long n, double alpha, double * x, double * y ){
+
+            int inc = 1;
+            for ( long long start = 0; start < n; start += blas_chunk ){
+               int length = (( n - start < blas_chunk ) ? ( int )( n - start ) : blas_chunk );
+               daxpy_( &length, &alpha, x + start, &inc, y + start, &inc );
+            }
+
+         }
+
+         //! Vector scaling x = alpha * x for vectors of length n which may exceed 2^31 - 1
+         /** \param n The vector length
+             \param alpha The prefactor
+             \param x The vector to scale */
+         static void dscal64( const long long n, double alpha, double * x ){
+
+            int inc = 1;
+            for ( long long start = 0; start < n; start += blas_chunk ){
+               int length = (( n - start < blas_chunk ) ? ( int )( n - start ) : blas_chunk );
+               dscal_( &length, &alpha, x + start, &inc );
+            }
+
+         }
+
+         //! Inner product x^T y for vectors of length n which may exceed 2^31 - 1
+         /** \param n The vector length
+             \param x The first vector
+             \param y The second vector
+             \return The inner product */
+         static double ddot64( const long long n, double * x, double * y ){
+
+            int inc = 1;
+            double result = 0.0;
+            for ( long long start = 0; start < n; start += blas_chunk ){
+               int length = (( n - start < blas_chunk ) ? ( int )( n - start ) : blas_chunk );
+               result += ddot_( &length, x + start, &inc, y + start, &inc );
+            }
+            return result;
+
+         }
+
    };
 }
 
@@ -35,7 +35,7 @@ namespace CheMPS2{
 
       public:
 
-         //! Constructor
+         //! Constructor; it tabulates the Wigner-6j symbols with Wigner::prepare, and must hence not run while another thread uses them
          /** \param Prob The problem to be solved
              \param D    The initial number of reduced renormalized DMRG basis states */
          SyBookkeeper( const Problem * Prob, const int D );
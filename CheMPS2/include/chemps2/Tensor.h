@@ -21,6 +21,7 @@
 #define TENSOR_CHEMPS2_H
 
 #include "SyBookkeeper.h"
+#include "SectorIndex.h"
 
 namespace CheMPS2{
 /** Pure virtual Tensor class.
@@ -53,7 +54,7 @@ namespace CheMPS2{
          //! Get the storage jump corresponding to a certain tensor block
          /** \param kappa The symmetry block
              \return kappa2index[ kappa ], the memory jumper to a certain block */
-         virtual int gKappa2index( const int kappa ) const = 0;
+         virtual long long gKappa2index( const int kappa ) const = 0;
 
          //! Get the pointer to the storage of a certain tensor block
          /** \param N1 The left or up particle number sector
@@ -81,7 +82,10 @@ namespace CheMPS2{
          int nKappa;
 
          //! kappa2index[kappa] indicates the start of tensor block kappa in storage. kappa2index[nKappa] gives the size of storage.
-         int * kappa2index;
+         long long * kappa2index;
+
+         //! Index from the left or up quantum numbers ( N1, TwoS1, I1 ) to the tensor blocks, used by gKappa
+         SectorIndex * sector_index;
 
    };
 }
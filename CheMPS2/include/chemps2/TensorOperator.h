@@ -79,7 +79,7 @@ namespace CheMPS2{
          //! Get the storage jump corresponding to a certain tensor block
          /** \param kappa The symmetry block
              \return kappa2index[kappa], the memory jumper to a certain block */
-         int gKappa2index( const int kappa ) const;
+         long long gKappa2index( const int kappa ) const;
 
          //! Get the pointer to the storage of a certain tensor block
          /** \param N1 The up particle number sector
@@ -62,7 +62,37 @@ namespace CheMPS2{
          //! Get the storage jump corresponding to a certain tensor block
          /** \param kappa The symmetry block
              \return kappa2index[ kappa ], the memory jumper to a certain block */
-         int gKappa2index( const int kappa ) const;
+         long long gKappa2index( const int kappa ) const;
+
+         //! Get the left particle number symmetry of block ikappa
+         /** \param ikappa The tensor block number
+             \return the left particle number symmetry of block ikappa */
+         int gNL( const int ikappa ) const;
+
+         //! Get the left spin symmetry of block ikappa
+         /** \param ikappa The tensor block number
+             \return the left spin symmetry of block ikappa */
+         int gTwoSL( const int ikappa ) const;
+
+         //! Get the left irrep symmetry of block ikappa
+         /** \param ikappa The tensor block number
+             \return the left irrep symmetry of block ikappa */
+         int gIL( const int ikappa ) const;
+
+         //! Get the right particle number symmetry of block ikappa
+         /** \param ikappa The tensor block number
+             \return the right particle number symmetry of block ikappa */
+         int gNR( const int ikappa ) const;
+
+         //! Get the right spin symmetry of block ikappa
+         /** \param ikappa The tensor block number
+             \return the right spin symmetry of block ikappa */
+         int gTwoSR( const int ikappa ) const;
+
+         //! Get the right irrep symmetry of block ikappa
+         /** \param ikappa The tensor block number
+             \return the right irrep symmetry of block ikappa */
+         int gIR( const int ikappa ) const;
 
          //! Get the pointer to the storage of a certain tensor block
          /** \param N1 The left particle number sector
@@ -28,6 +28,8 @@
 #include "TensorS1.h"
 #include "Tensor3RDM.h"
 #include "SyBookkeeper.h"
+#include "Workspace.h"
+#include "SixIndex.h"
 
 namespace CheMPS2{
 /** ThreeDM class.
@@ -36,7 +38,7 @@ namespace CheMPS2{
     
     The ThreeDM class stores the spin-summed three-particle reduced density matrix (3-RDM) of a converged DMRG calculation: \n
     \f$ \Gamma_{ijk;lmn} = \sum_{\sigma \tau s} \braket{ a^{\dagger}_{i \sigma} a^{\dagger}_{j \tau} a^{\dagger}_{k s} a_{n s} a_{m \tau} a_{l \sigma}} \f$\n
-    Because the wave-function belongs to a certain Abelian irrep, \f$ I_{i} \otimes I_{j} \otimes I_{k} = I_{l} \otimes I_{m} \otimes I_{n} \f$ must be valid before the corresponding element \f$ \Gamma_{ijk;lmn} \f$ is non-zero.
+    Because the wave-function belongs to a certain Abelian irrep, \f$ I_{i} \otimes I_{j} \otimes I_{k} = I_{l} \otimes I_{m} \otimes I_{n} \f$ must be valid before the corresponding element \f$ \Gamma_{ijk;lmn} \f$ is non-zero. In memory, the 3-RDM is stored in a SixIndex object, and on disk, it is stored per sixth orbital.
 */
    class ThreeDM{
 
@@ -45,8 +47,9 @@ namespace CheMPS2{
          //! Constructor
          /** \param book_in Symmetry sector bookkeeper
              \param prob_in The problem to be solved
-             \param disk_in Whether or not to use disk in order to avoid storing the full 3-RDM of size L^6 */
-         ThreeDM( const SyBookkeeper * book_in, const Problem * prob_in , const bool disk_in );
+             \param disk_in Whether or not to use disk in order to avoid storing the full 3-RDM of size L^6
+             \param work_in The persistent work arrays (if NULL, ThreeDM allocates its own) */
+         ThreeDM( const SyBookkeeper * book_in, const Problem * prob_in , const bool disk_in, Workspace * work_in = NULL );
 
          //! Destructor
          virtual ~ThreeDM();
@@ -69,6 +72,12 @@ namespace CheMPS2{
              \param last_orb_num   Number of consecutive sixth orbitals to copy */
          void fill_ham_index( const double alpha, const bool add, double * storage, const int last_orb_start, const int last_orb_num );
 
+         //! Perform storage { = or += } alpha * 3-RDM
+         /** \param alpha   The prefactor
+             \param add     Whether to add to, or to set the storage
+             \param storage SixIndex object with the orbital irreps of the problem, in Hamiltonian indices */
+         void fill_ham_index( const double alpha, const bool add, SixIndex * storage );
+
          //! Fill the 3-RDM terms corresponding to site denT->gIndex()
          /** \param denT DMRG site-matrices
              \param Ltens Ltensors
@@ -115,6 +124,12 @@ namespace CheMPS2{
              \param array Pointer to the object */
          static void save_HAM_generic( const string filename, const int LAS, const string tag, double * array );
 
+         //! Generic save routine for SixIndex objects, which are written in the same dense layout as save_HAM_generic, one sixth orbital at a time
+         /** \param filename The filename to store the object at
+             \param tag The name of the object
+             \param array Pointer to the object */
+         static void save_HAM_generic( const string filename, const string tag, const SixIndex * array );
+
       private:
 
          //The BK containing all the irrep information
@@ -129,12 +144,19 @@ namespace CheMPS2{
          //The DMRG chain length
          int L;
 
-         //The array length of elements and (when allocated) temp_disk_vals and temp_disk_orbs = ( disk ) ? L*L*L*L*L : L*L*L*L*L*L
+         //The persistent work arrays, and whether they are owned by ThreeDM
+         Workspace * work;
+         bool own_work;
+
+         //The array length of elements and (when allocated) temp_disk_vals and temp_disk_orbs = L*L*L*L*L, when disk == true
          int array_size;
 
-         //The 3-RDM elements are stored in the HAMILTONIAN indices
+         //The 3-RDM elements for one sixth orbital, when disk == true, in the HAMILTONIAN indices
          double * elements;
 
+         //The 3-RDM elements, when disk == false, in the HAMILTONIAN indices
+         SixIndex * packed;
+
          //The temporary orbitals when disk == true
          int * temp_disk_orbs;
 
@@ -27,6 +27,7 @@
 #include "TensorS0.h"
 #include "TensorS1.h"
 #include "SyBookkeeper.h"
+#include "Workspace.h"
 
 namespace CheMPS2{
 /** TwoDM class.
@@ -53,8 +54,9 @@ namespace CheMPS2{
       
          //! Constructor
          /** \param denBKIn Symmetry sector bookkeeper
-             \param ProbIn The problem to be solved */
-         TwoDM(const SyBookkeeper * denBKIn, const Problem * ProbIn);
+             \param ProbIn The problem to be solved
+             \param work_in The persistent work arrays (if NULL, TwoDM allocates its own) */
+         TwoDM(const SyBookkeeper * denBKIn, const Problem * ProbIn, Workspace * work_in = NULL);
          
          //! Destructor
          virtual ~TwoDM();
@@ -166,6 +168,10 @@ namespace CheMPS2{
          //The chain length
          int L;
          
+         //The persistent work arrays, and whether they are owned by TwoDM
+         Workspace * work;
+         bool own_work;
+         
          //Two 2DM^{A,B} objects
          double * two_rdm_A;
          double * two_rdm_B;
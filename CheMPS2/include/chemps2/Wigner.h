@@ -22,6 +22,7 @@
 
 #define CHEMPS2_WIGNER_FACTORIAL_MAX 191
 #define CHEMPS2_WIGNER_MAX_2J        95   // Maximum factorial = (4j+1)!   <=>   2j = 95
+#define CHEMPS2_WIGNER_TABLE_SMALL_2J 3    // The tabulated Wigner-6j symbols have at least one spin 2j <= 3
 
 namespace CheMPS2{
 /** Wigner class.
@@ -29,6 +30,8 @@ namespace CheMPS2{
     \date May 23, 2016
 
     The Wigner class allows to calculate Wigner-nj symbols.
+
+    The Wigner-6j symbols which occur in the DMRG diagrams contain at least one small spin (a single electron, a local orbital, or a two-index operator), and further only the virtual spins, which are bounded by SyBookkeeper::gTwoSmax. After a call to prepare( two_j_max ), these 6j-symbols are looked up in a table: the tetrahedral symmetry moves the smallest spin to the third position, and the table is indexed by the (two_j) tuple. The 9j-symbols are evaluated as sums of 6j-symbols, and hence use the table as well. The symbols outside the table are evaluated directly. The table is only written by prepare, so the lookups are thread-safe as long as no prepare call runs concurrently. The table lives until the program ends.
 */
    class Wigner{
 
@@ -70,8 +73,26 @@ namespace CheMPS2{
              \return The corresponding wigner-9j value */
          static double wigner9j( const int two_ja, const int two_jb, const int two_jc, const int two_jd, const int two_je, const int two_jf, const int two_jg, const int two_jh, const int two_ji );
 
+         //! Tabulate the Wigner-6j symbols with one spin 2j <= CHEMPS2_WIGNER_TABLE_SMALL_2J and the other spins up to two_j_max; the table only grows, within WIGNER_TABLE_MAX_MB
+         /** When the table grows, the old table is replaced and deleted without synchronization. Hence prepare must not run while another thread reads the table: not inside a parallel region, and not while another thread works with a SyBookkeeper, whose constructor calls prepare, or with the objects built on it (DMRG, Heff, TensorT, ...).
+             \param two_j_max Two times the maximum spin, typically the maximum of SyBookkeeper::gTwoSmax */
+         static void prepare( const int two_j_max );
+
       private:
 
+         // The table of Wigner-6j symbols ( NULL if not prepared ) and two times the maximum tabulated spin
+         static double * table_6j;
+         static int table_2j;
+
+         // Index in table_6j of a 6j-symbol with two_jc its smallest spin
+         static long long index_6j( const int two_ja, const int two_jb, const int two_jc, const int two_jd, const int two_je, const int two_jf );
+
+         // Size of table_6j for a maximum tabulated spin two_j_max
+         static long long size_6j( const int two_j_max );
+
+         // Direct evaluation of the Wigner-6j symbol, after the triangle conditions have been checked
+         static double wigner6j_direct( const int two_ja, const int two_jb, const int two_jc, const int two_jd, const int two_je, const int two_jf );
+
          // List of square roots of factorials
          static const long double sqrt_fact[ CHEMPS2_WIGNER_FACTORIAL_MAX + 1 ];
 
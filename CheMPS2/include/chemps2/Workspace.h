@@ -0,0 +1,79 @@
+/*
+   CheMPS2: a spin-adapted implementation of DMRG for ab initio quantum chemistry
+   Copyright (C) 2013-2016 Sebastian Wouters
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#ifndef WORKSPACE_CHEMPS2_H
+#define WORKSPACE_CHEMPS2_H
+
+namespace CheMPS2{
+/** Workspace class.
+    \author Sebastian Wouters <sebastianwouters@gmail.com>
+    \date October 16, 2026
+
+    The Workspace class contains persistent work arrays for each OpenMP thread. The kernels which need a work array inside a parallel region (effective Hamiltonian, SVD of the S-object, renormalized operator updates, and the 2-RDM and 3-RDM diagrams) ask the arena of the calling thread for an array of at least a given size, typically based on SyBookkeeper::gMaxDimAtBound. An array is only reallocated when a larger size is requested, so that the repeated allocation and release of large work arrays in the DMRG sweeps is avoided. The contents of an array are not preserved between requests. Each thread has a few independent slots; a kernel which needs several arrays at the same time uses different slots. The arena is sized for omp_get_max_threads() at construction. */
+   class Workspace{
+
+      public:
+
+         //! Constructor
+         Workspace();
+
+         //! Destructor
+         virtual ~Workspace();
+
+         //! The number of double slots per thread
+         static const int num_double_slots = 3;
+
+         //! The number of int slots per thread
+         static const int num_int_slots = 1;
+
+         //! Get a double array of the calling thread
+         /** \param slot The slot, in [ 0, num_double_slots )
+             \param size The minimum size of the array
+             \return The array */
+         double * get_double( const int slot, const long long size );
+
+         //! Get an int array of the calling thread
+         /** \param slot The slot, in [ 0, num_int_slots )
+             \param size The minimum size of the array
+             \return The array */
+         int * get_int( const int slot, const long long size );
+
+         //! Release the memory of all threads; must be called outside of a parallel region
+         void release();
+
+      private:
+
+         //The number of threads
+         int num_threads;
+
+         //The double arrays and their sizes: [ slot + num_double_slots * thread ]
+         double ** doubles;
+         long long * double_sizes;
+
+         //The int arrays and their sizes: [ slot + num_int_slots * thread ]
+         int ** ints;
+         long long * int_sizes;
+
+         //Get the calling thread
+         int thread() const;
+
+   };
+}
+
+#endif
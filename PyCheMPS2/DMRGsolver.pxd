@@ -38,7 +38,11 @@ cdef extern from "chemps2/DMRG.h" namespace "CheMPS2":
         Corr.Correlations * getCorrelations()
         void deleteStoredMPS()
         void deleteStoredOperators()
+        void setCheckpointInterval(const double)
         void activateExcitations(const int)
         void newExcitation(const double)
+        void activateStateAveraging(const int)
+        double getRootEnergy(const int)
+        void selectRoot(const int)
         double getFCIcoefficient(int *, int *)
 
@@ -54,6 +54,8 @@ cdef class PyConvergenceScheme:
         self.thisptr.setInstruction(instruction, D, Econv, nMax, noisePrefactor)
     def set_instruction(self, int instruction, int D, double Econv, int nMax, double noisePrefactor, double dvdson_rtol):
         self.thisptr.set_instruction(instruction, D, Econv, nMax, noisePrefactor, dvdson_rtol)
+    def set_truncation(self, int instruction, double max_discarded_weight, int D_min):
+        self.thisptr.set_truncation(instruction, max_discarded_weight, D_min)
     def getD(self, int instruction):
         return self.thisptr.get_D(instruction)
     def getEconv(self, int instruction):
@@ -146,10 +148,18 @@ cdef class PyDMRG:
         self.thisptr.deleteStoredMPS()
     def deleteStoredOperators(self):
         self.thisptr.deleteStoredOperators()
+    def setCheckpointInterval(self, double seconds):
+        self.thisptr.setCheckpointInterval(seconds)
     def activateExcitations(self, int nExcitations):
         self.thisptr.activateExcitations(nExcitations)
     def newExcitation(self, const double Eshift):
         self.thisptr.newExcitation(Eshift)
+    def activateStateAveraging(self, int num_roots):
+        self.thisptr.activateStateAveraging(num_roots)
+    def getRootEnergy(self, int root):
+        return self.thisptr.getRootEnergy(root)
+    def selectRoot(self, int root):
+        self.thisptr.selectRoot(root)
     #Access functions of the Corr.Correlations class
     def getCspin(self, int row, int col):
         return self.thisptr.getCorrelations().getCspin_HAM(row, col)